@@ -1,6 +1,14 @@
 #include <Urho3D/Urho3D.h>
 
+#include <Urho3D/Core/Timer.h>
 #include <Urho3D/IO/Log.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "GameAttributes.h"
+#include "GOABlock.h"
+
+#include "GOC_Life.h"
+#include "GOC_ControllerAI.h"
 
 #include "Behavior.h"
 
@@ -9,6 +17,47 @@
 
 
 
+void BehaviorSnapshot::Set(GOC_AIController& controller, unsigned time)
+{
+    Node* node = controller.GetNode();
+
+    time_ = time;
+    state_ = controller.control_.animation_;
+    direction_ = controller.control_.direction_;
+    moveState_ = (int)GOABlock::GetMoveState(node);
+    position_ = node->GetWorldPosition2D();
+
+    GOC_Life* life = node->GetComponent<GOC_Life>();
+    Node* attacker = life ? life->GetLastAttacker() : 0;
+    attackerID_ = attacker ? attacker->GetID() : 0;
+    attackerPosition_ = attacker ? attacker->GetWorldPosition2D() : Vector2::ZERO;
+}
+
+void BehaviorCommands::Apply(GOC_AIController& controller, Behavior& behavior)
+{
+    for (unsigned i = 0; i < commands_.Size(); i++)
+    {
+        const BehaviorCommand& command = commands_[i];
+        if (command.type_ == BCMD_SetTarget)
+            controller.GetaiInfos().target = controller.GetScene()->GetNode(command.value_);
+        else
+            behavior.ApplyCommand(controller, command);
+    }
+
+    commands_.Clear();
+}
+
+void Behavior::ThinkAndApply(GOC_AIController& controller)
+{
+    BehaviorSnapshot snapshot;
+    snapshot.Set(controller, Time::GetSystemTime());
+
+    BehaviorCommands commands;
+    Think(controller, snapshot, commands);
+    commands.Apply(controller, *this);
+}
+
+
 Vector<unsigned> Behaviors::behaviorIndexes;
 Vector<Behavior*> Behaviors::behaviors;
 
@@ -15,7 +15,53 @@ enum TypeForOrder
 
 
 class GOC_AIController;
+struct Behavior;
 
+/// Snapshot of an agent for the think phase, taken on the main thread
+struct BehaviorSnapshot
+{
+    void Set(GOC_AIController& controller, unsigned time);
+
+    unsigned time_;
+    unsigned state_;
+    float direction_;
+    int moveState_;
+    Vector2 position_;
+    // the last attacker
+    unsigned attackerID_;
+    Vector2 attackerPosition_;
+};
+
+enum BehaviorCommandType
+{
+    BCMD_SetTarget = 0,     // value = the node id of the target
+    BCMD_Behavior           // played back by the behavior (see Behavior::ApplyCommand)
+};
+
+struct BehaviorCommand
+{
+    int type_;
+    unsigned value_;
+};
+
+/// Effects of the think phase out of the ai infos of the agent, played back on the main thread
+struct BehaviorCommands
+{
+    void Push(int type, unsigned value)
+    {
+        BehaviorCommand command;
+        command.type_ = type;
+        command.value_ = value;
+        commands_.Push(command);
+    }
+    void Clear()
+    {
+        commands_.Clear();
+    }
+    void Apply(GOC_AIController& controller, Behavior& behavior);
+
+    PODVector<BehaviorCommand> commands_;
+};
 
 struct Behavior : public Object
 {
@@ -28,6 +74,15 @@ public :
     virtual void Start(GOC_AIController& controller) { }
     virtual void Stop(GOC_AIController& controller) { }
     virtual void Update(GOC_AIController& controller) = 0;
+
+    /// Think phase (see AIManager) : the decision of the behavior on a worker thread, from the snapshot of the agent.
+    /// Think only writes the ai infos of the agent, the other effects are recorded in the commands.
+    virtual bool CanThink() const { return false; }
+    virtual void Think(GOC_AIController& controller, const BehaviorSnapshot& snapshot, BehaviorCommands& commands) { }
+    virtual void ApplyCommand(GOC_AIController& controller, const BehaviorCommand& command) { }
+
+    /// Think and apply the commands on the main thread
+    void ThinkAndApply(GOC_AIController& controller);
 };
 
 
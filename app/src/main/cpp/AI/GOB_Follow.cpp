@@ -4,12 +4,18 @@
 
 #include <Urho3D/Scene/Scene.h>
 
+#include "GameOptions.h"
 #include "GameAttributes.h"
+#include "GOABlock.h"
 #include "GameEvents.h"
 
 #include "CommonComponents.h"
 #include "GOC_Abilities.h"
 
+#ifdef ACTIVE_PATHFINDER_FLOWFIELD
+#include "PathFinder2D.h"
+#endif
+
 #include "GOB_Follow.h"
 
 
@@ -122,7 +128,7 @@ void GOB_Follow::Update(GOC_AIController& controller)
 
         if (state == STATE_DEFAULT_CLIMB || state == STATE_CLIMB)
         {
-            int movestate = node->GetVar(GOA::MOVESTATE).GetInt();
+            int movestate = (int)GOABlock::GetMoveState(node);
 
             if (movestate & MV_TOUCHWALL)
             {
@@ -192,8 +198,8 @@ void GOB_Follow::Update(GOC_AIController& controller)
                 buttons = buttons & ~(CTRL_RIGHT | CTRL_LEFT | CTRL_JUMP);
 
                 // target is above : Jump
-                const Vector2& vel = node->GetVar(GOA::VELOCITY).GetVector2();
-                int movestate = node->GetVar(GOA::MOVESTATE).GetInt();
+                const Vector2& vel = GOABlock::GetVelocity(node);
+                int movestate = (int)GOABlock::GetMoveState(node);
 
                 if (deltaPosition.y_ > 0.f &&
                         ((vel.y_ < GOC_Move2D::velJumpMax && !(movestate & MV_TOUCHOBJECT)) ||
@@ -216,7 +222,7 @@ void GOB_Follow::Update(GOC_AIController& controller)
                     aiInfos.waitCallBackOrderOfType = 0;
                 }
 
-                if (Abs(deltaPosition.x_) > aiInfos.minRangeTarget.x_)
+                if (Abs(deltaPosition.x_) > aiInfos.minRangeTarget.x_ || (followField && deltaPosition.x_ != 0.f))
                     buttons = buttons | (deltaPosition.x_ > 0.f ? CTRL_RIGHT : CTRL_LEFT);
             }
             // no big gap in y_
@@ -432,7 +438,7 @@ void GOB_FollowAttack::Update(GOC_AIController& controller)
 
         if (state == STATE_DEFAULT_CLIMB || state == STATE_CLIMB)
         {
-            int movestate = node->GetVar(GOA::MOVESTATE).GetInt();
+            int movestate = (int)GOABlock::GetMoveState(node);
 
             if (movestate & MV_TOUCHWALL)
             {
@@ -496,11 +502,25 @@ void GOB_FollowAttack::Update(GOC_AIController& controller)
         }
         else
         {
+            bool followField = false;
+#ifdef ACTIVE_PATHFINDER_FLOWFIELD
+            // target out of the attack ranges : go to the next tile of the flow field shared by the chasers of the target
+            // (not for the mid-range agents, see AILodTier)
+            if (aiInfos.lodTier == AILOD_Near && (Abs(deltaPosition.y_) >= aiInfos.minRangeTarget.y_ || Abs(deltaPosition.x_) >= defaultMaxRangedAttRange.x_))
+            {
+                Vector2 direction;
+                if (PathFinder2D::GetFlowDirection(target, MV_WALK, node->GetWorldPosition2D(), direction))
+                {
+                    deltaPosition = direction;
+                    followField = true;
+                }
+            }
+#endif
             // no big gap in y_
-            if (!order && Abs(deltaPosition.y_) < aiInfos.minRangeTarget.y_)
+            if (!order && !followField && Abs(deltaPosition.y_) < aiInfos.minRangeTarget.y_)
             {
                 // TODO : check for Wall between entity and the target
-                int movestate = node->GetVar(GOA::MOVESTATE).GetInt();
+                int movestate = (int)GOABlock::GetMoveState(node);
                 if ((movestate & MV_TOUCHWALL) && node->GetComponent<GOC_Destroyer>()->HasWallInFront(deltaPosition.x_ > 0.f))
                 {
 //            		URHO3D_LOGINFOF("GOB_FollowAttack() - Update : node=%s(%u) can't Attack wall in front !", node->GetName().CString(), node->GetID());
@@ -560,8 +580,8 @@ void GOB_FollowAttack::Update(GOC_AIController& controller)
                 buttons = buttons & ~(CTRL_RIGHT | CTRL_LEFT | CTRL_JUMP);
 
                 // target is above : Jump
-                const Vector2& vel = node->GetVar(GOA::VELOCITY).GetVector2();
-                int movestate = node->GetVar(GOA::MOVESTATE).GetInt();
+                const Vector2& vel = GOABlock::GetVelocity(node);
+                int movestate = (int)GOABlock::GetMoveState(node);
 
                 if (deltaPosition.y_ > 0.f &&
                         ((vel.y_ < GOC_Move2D::velJumpMax && !(movestate & MV_TOUCHOBJECT)) ||
@@ -585,7 +605,7 @@ void GOB_FollowAttack::Update(GOC_AIController& controller)
                     aiInfos.waitCallBackOrderOfType = 0;
                 }
 
-                if (Abs(deltaPosition.x_) > aiInfos.minRangeTarget.x_)
+                if (Abs(deltaPosition.x_) > aiInfos.minRangeTarget.x_ || (followField && deltaPosition.x_ != 0.f))
                     buttons = buttons | (deltaPosition.x_ > 0.f ? CTRL_RIGHT : CTRL_LEFT);
 
                 if (movestate & MV_TOUCHGROUND)
@@ -17,18 +17,22 @@
 
 
 void GOB_Patrol::Update(GOC_AIController& controller)
+{
+    ThinkAndApply(controller);
+}
+
+void GOB_Patrol::Think(GOC_AIController& controller, const BehaviorSnapshot& snapshot, BehaviorCommands& commands)
 {
     Node* node = controller.GetNode();
     AInodeInfos& aiInfos = controller.GetaiInfos();
-    const ObjectControlLocal& control = controller.control_;
 
     unsigned& order = aiInfos.order;
     unsigned& callBackOrder = aiInfos.callBackOrder;
     unsigned& buttons = aiInfos.buttons;
-    const unsigned& state = control.animation_;
-    const float& dirx = control.direction_;
+    const unsigned& state = snapshot.state_;
+    const float& dirx = snapshot.direction_;
 
-    unsigned delay = Time::GetSystemTime() - aiInfos.lastUpdate;
+    unsigned delay = snapshot.time_ - aiInfos.lastUpdate;
 
 #ifdef APPLY_RANDSKIP
     unsigned randomskip = Random(500);
@@ -92,7 +96,7 @@ void GOB_Patrol::Update(GOC_AIController& controller)
         {
             if (delay > 2000)
             {
-                int movestate = node->GetVar(GOA::MOVESTATE).GetInt();
+                const int& movestate = snapshot.moveState_;
 
                 if (movestate & MV_TOUCHWALL)
                 {
@@ -171,18 +175,15 @@ void GOB_Patrol::Update(GOC_AIController& controller)
         }
         else if (state == STATE_JUMP)
         {
-            int movestate = node->GetVar(GOA::MOVESTATE).GetInt();
-            if (movestate & MV_TOUCHOBJECT)
+            if (snapshot.moveState_ & MV_TOUCHOBJECT)
                 buttons = (buttons & ~CTRL_JUMP);
         }
         else if (state == STATE_HURT)
         {
             // Find Ennemie and hit
-            Node* attacker = node->GetComponent<GOC_Life>()->GetLastAttacker();
-
-            if (attacker)
+            if (snapshot.attackerID_)
             {
-                float inrange = node->GetWorldPosition2D().x_ - attacker->GetWorldPosition2D().x_;
+                float inrange = snapshot.position_.x_ - snapshot.attackerPosition_.x_;
 
 //                if (Abs(inrange) < 1.f)
                 {
@@ -205,27 +206,16 @@ void GOB_Patrol::Update(GOC_AIController& controller)
 //                    URHO3D_LOGINFOF("GOB_Patrol() - Update : STATE_HURT => attacker %s(%u) not in the range !", attacker->GetName().CString(), attacker->GetID());
 //                }
 
-                aiInfos.target = attacker;
+                commands.Push(BCMD_SetTarget, snapshot.attackerID_);
             }
 //            else
 //            {
 //                URHO3D_LOGINFOF("GOB_Patrol() - Update : Hurt ! but no attacker");
 //            }
 
-            GOC_Abilities* gocabilities = node->GetComponent<GOC_Abilities>();
-            if (gocabilities)
-            {
-                Ability* ability = gocabilities->GetAbility(ABI_AnimShooter::GetTypeStatic());
-
-                if (!ability)
-                    URHO3D_LOGINFOF("GOB_Patrol() - Update : %s(%u) STATE_HURT => No Ability ABI_AnimShooter !", node->GetName().CString(), node->GetID());
-
-                if (ability && gocabilities->SetActiveAbility(ability))
-                {
-                    order = STATE_SHOOT;
-                    URHO3D_LOGINFOF("GOB_Patrol() - Update : %s(%u) STATE_HURT => Has Ability ABI_AnimShooter => SHOOT !", node->GetName().CString(), node->GetID());
-                }
-            }
+            // shoot if possible (see ApplyCommand)
+            if (node->GetComponent<GOC_Abilities>())
+                commands.Push(BCMD_Behavior, STATE_SHOOT);
 
         }
 //        else if (state == STATE_ATTACK && (buttons & CTRL_FIRE1))
@@ -269,23 +259,51 @@ void GOB_Patrol::Update(GOC_AIController& controller)
 //    URHO3D_LOGINFOF("GOB_Patrol() - Update : buttons=%u order=%u state=%s(%u) ... OK !", buttons, order, GOS::GetStateName(state).CString(), state);
 }
 
+void GOB_Patrol::ApplyCommand(GOC_AIController& controller, const BehaviorCommand& command)
+{
+    if (command.value_ != STATE_SHOOT)
+        return;
+
+    Node* node = controller.GetNode();
+    GOC_Abilities* gocabilities = node->GetComponent<GOC_Abilities>();
+    if (!gocabilities)
+        return;
+
+    Ability* ability = gocabilities->GetAbility(ABI_AnimShooter::GetTypeStatic());
+
+    if (!ability)
+        URHO3D_LOGINFOF("GOB_Patrol() - Update : %s(%u) STATE_HURT => No Ability ABI_AnimShooter !", node->GetName().CString(), node->GetID());
+
+    if (ability && gocabilities->SetActiveAbility(ability))
+    {
+        AInodeInfos& aiInfos = controller.GetaiInfos();
+        aiInfos.order = STATE_SHOOT;
+        aiInfos.buttons = CTRL_FIRE2;
+        aiInfos.waitCallBackOrderOfType = StateTypeForOrder;
+        URHO3D_LOGINFOF("GOB_Patrol() - Update : %s(%u) STATE_HURT => Has Ability ABI_AnimShooter => SHOOT !", node->GetName().CString(), node->GetID());
+    }
+}
+
 
 // WAIT AND REPLAY TO ATTACK
 
 
 void GOB_WaitAndDefend::Update(GOC_AIController& controller)
 {
-    Node* node = controller.GetNode();
+    ThinkAndApply(controller);
+}
+
+void GOB_WaitAndDefend::Think(GOC_AIController& controller, const BehaviorSnapshot& snapshot, BehaviorCommands& commands)
+{
     AInodeInfos& aiInfos = controller.GetaiInfos();
-    const ObjectControlLocal& control = controller.control_;
 
     unsigned& order = aiInfos.order;
     unsigned& callBackOrder = aiInfos.callBackOrder;
     unsigned& buttons = aiInfos.buttons;
-    const unsigned& state = control.animation_;
-    const float& dirx = control.direction_;
+    const unsigned& state = snapshot.state_;
+    const float& dirx = snapshot.direction_;
 
-    unsigned delay = Time::GetSystemTime() - aiInfos.lastUpdate;
+    unsigned delay = snapshot.time_ - aiInfos.lastUpdate;
 
 #ifdef APPLY_RANDSKIP
     unsigned randomskip = Random(500);
@@ -352,11 +370,10 @@ void GOB_WaitAndDefend::Update(GOC_AIController& controller)
         else if (state == STATE_HURT)
         {
             // Find Ennemie and hit
-            Node* attacker = node->GetComponent<GOC_Life>()->GetLastAttacker();
-            if (attacker)
+            if (snapshot.attackerID_)
             {
                 order = STATE_ATTACK;
-                if (dirx * (node->GetWorldPosition2D().x_ - attacker->GetWorldPosition2D().x_) > 0.f)
+                if (dirx * (snapshot.position_.x_ - snapshot.attackerPosition_.x_) > 0.f)
                 {
                     aiInfos.nextOrder = order;
                     order = GO_CHANGEDIRECTION.Value();
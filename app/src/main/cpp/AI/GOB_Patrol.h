@@ -13,6 +13,10 @@ public :
     virtual ~GOB_Patrol() { }
 
     virtual void Update(GOC_AIController& controller);
+
+    virtual bool CanThink() const { return true; }
+    virtual void Think(GOC_AIController& controller, const BehaviorSnapshot& snapshot, BehaviorCommands& commands);
+    virtual void ApplyCommand(GOC_AIController& controller, const BehaviorCommand& command);
 };
 
 struct GOB_WaitAndDefend : public Behavior
@@ -24,4 +28,7 @@ public :
     virtual ~GOB_WaitAndDefend() { }
 
     virtual void Update(GOC_AIController& controller);
+
+    virtual bool CanThink() const { return true; }
+    virtual void Think(GOC_AIController& controller, const BehaviorSnapshot& snapshot, BehaviorCommands& commands);
 };
@@ -5,6 +5,7 @@
 #include <Urho3D/Scene/Scene.h>
 
 #include "GameAttributes.h"
+#include "GOABlock.h"
 #include "GameEvents.h"
 
 #include "CommonComponents.h"
@@ -157,7 +158,7 @@ void GOB_PlayerCPU::Update(GOC_AIController& controller)
 
         if (state == STATE_DEFAULT_CLIMB || state == STATE_CLIMB)
         {
-            int movestate = node->GetVar(GOA::MOVESTATE).GetInt();
+            int movestate = (int)GOABlock::GetMoveState(node);
 
             if (movestate & MV_TOUCHWALL)
             {
@@ -276,8 +277,8 @@ void GOB_PlayerCPU::Update(GOC_AIController& controller)
                 buttons = buttons & ~(CTRL_RIGHT | CTRL_LEFT | CTRL_JUMP);
 
                 // target is above : Jump
-                const Vector2& vel = node->GetVar(GOA::VELOCITY).GetVector2();
-                int movestate = node->GetVar(GOA::MOVESTATE).GetInt();
+                const Vector2& vel = GOABlock::GetVelocity(node);
+                int movestate = (int)GOABlock::GetMoveState(node);
 
                 if (deltaPosition.y_ > 0.f &&
                         ((vel.y_ < GOC_Move2D::velJumpMax && !(movestate & MV_TOUCHOBJECT)) ||
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <Urho3D/Math/MathDefs.h>
+
+#include "MapAreaFlags.h"
+
+#include "PathHierarchy.h"
+
+using namespace Urho3D;
+
+
+/// The neighbor costs and the heuristics of the path searches by move type.
+
+#define COST_NOWAY          65535
+#define COST_X	            10
+#define COST_XY	            14
+#define COST_DXY            4
+
+static inline unsigned Heuristic_fly(int ax, int ay, int bx, int by)
+{
+//    // Manhattan : num block horizontal and vertical between a and b
+//    return 10 * (Abs(a.x_ - b.x_) + Abs(a.y_ - b.y_));
+
+    // Octile
+    unsigned dx = (ax > bx)?(ax - bx):(bx - ax);
+    unsigned dy = (ay > by)?(ay - by):(by - ay);
+    return (dx > dy) ? (dx*COST_X + dy*COST_DXY) : (dy*COST_X + dx*COST_DXY);
+}
+
+static inline unsigned NghbDist_fly(int ax, int ay, int bx, int by)
+{
+    int dx = Abs(ax - bx);
+    int dy = Abs(ay - by);
+
+    if (dx + dy == 1)
+    {
+        return COST_X;
+    }
+    else if (dx + dy == 2)
+    {
+        return COST_XY;
+    }
+
+    return 0;
+}
+
+#define COST_WALK_YMID	45
+#define COST_WALK_DXMID	35
+#define COST_WALK_YUP	60
+#define COST_WALK_YDOWN	9
+#define COST_WALK_XYUP	80
+#define COST_WALK_XYDOWN	13
+
+//#define COST_WALK_YMID	    26
+//#define COST_WALK_DXMID	    16
+//#define COST_WALK_YUP	    40
+//#define COST_WALK_YDOWN	    8
+//#define COST_WALK_XYUP	    50
+//#define COST_WALK_XYDOWN	12
+
+static inline unsigned Heuristic_walker(int ax, int ay, int bx, int by)
+{
+//    // Manhattan : num block horizontal and vertical between a and b
+//    return 10 * Abs(a.x_ - b.x_) + (a.y_ - b.y_ > 0 ? 20 : 10) * Abs(a.y_ - b.y_);
+
+    // Octile
+    unsigned dx = (ax > bx)?(ax - bx):(bx - ax);
+    unsigned dy;
+    unsigned jCost = 0;
+    if (ay > by)
+    {
+        // mainly jumping
+        dy = (ay - by);
+        jCost = dy * COST_WALK_YUP;
+    }
+    else
+    {
+        // mainly falling
+        dy = (by - ay);
+        jCost = dy * COST_WALK_YDOWN;
+    }
+
+    return (dx > dy) ? (dx*COST_X + dy*COST_WALK_DXMID + jCost) : (dy*COST_WALK_YMID + dx*COST_WALK_DXMID + jCost);
+}
+
+// good behavior with jump and fall (area : the area props of b)
+static inline unsigned NghbDist_walker(int ax, int ay, int bx, int by, unsigned area)
+{
+    int dx = ax - bx;
+
+    // jump
+    if (ay > by)
+    {
+        if (area & (jumpableFlag | walkableFlag))
+        {
+            if (dx != 0)
+                return COST_WALK_XYUP;
+            else
+                return COST_WALK_YUP;
+        }
+
+        return COST_NOWAY;
+    }
+
+    // fall
+    if (ay < by)
+    {
+        if (dx != 0)
+            return COST_WALK_XYDOWN;
+        else
+            return COST_WALK_YDOWN;
+    }
+
+    // horizontal move
+    if (area & jumpableFlag)
+        return COST_WALK_YMID;
+
+    if (area & walkableFlag)
+        return COST_X;
+
+    return COST_NOWAY;
+}
+
+// the areas crossed by a move type (PathMoveType) : MV_WALK needs flyableFlag for falling
+static inline unsigned GetPathMoveAreaFlags(int movetype)
+{
+    static const unsigned areaflags[PMT_NumMoveTypes] = { walkableFlag | jumpableFlag | flyableFlag, flyableFlag, swimmableFlag };
+    return areaflags[movetype];
+}
@@ -4,11 +4,10 @@
 
 #include <Urho3D/Core/StringUtils.h>
 #include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/CoreEvents.h>
 #include <Urho3D/Core/Profiler.h>
 #include <Urho3D/Core/Timer.h>
 
-#include <Urho3D/Container/Sort.h>
-
 #include <Urho3D/IO/Log.h>
 
 #include <Urho3D/Scene/Node.h>
@@ -21,10 +20,13 @@
 #include "MapWorld.h"
 #endif
 
+#include "ViewManager.h"
+
 #include "PathFinder2D.h"
 
 #define MAX_SEARCHTIME 10       // if elapsedTime > MAX_SEARCHTIME => Stop
 #define MAX_SEARCHCOSTFACTOR 5 // if cost > MAX_SEARCHCOSTFACTOR x heuristic => stop
+#define FLOWFIELD_KEEPTIME 3000 // a flow field not used for FLOWFIELD_KEEPTIME msec is removed
 
 const float CHANGENODE_THRESHOLD = 0.5f;
 
@@ -35,6 +37,12 @@ World2DInfo* PathFinder2D::info_ = 0;
 PathFinder2D* PathFinder2D::pathfinder_ = 0;
 
 
+static int GetPathMoveType(unsigned moveTypeFlags)
+{
+    return (moveTypeFlags & MV_FLY) ? PMT_Flyer : (moveTypeFlags & MV_SWIM) ? PMT_Swimmer : (moveTypeFlags & MV_WALK) ? PMT_Walker : -1;
+}
+
+
 /// Static Functions
 
 void PathFinder2D::Init(Context* context, World2DInfo* info)
@@ -119,6 +127,62 @@ bool PathFinder2D::IsOnLastPathSegment(Path2D* path, int index)
     return (index == path->numNodes_-1);
 }
 
+void PathFinder2D::MarkTileChanged(const ShortIntVector2& mpoint, unsigned tileindex)
+{
+    if (!pathfinder_ || !pathfinder_->layerWidth_)
+        return;
+
+    const int width = pathfinder_->layerWidth_;
+    const int height = pathfinder_->layerHeight_;
+    const int x = mpoint.x_ * width + tileindex % width;
+    const int y = tileindex / width - mpoint.y_ * height;
+    pathfinder_->walkGraphs_->MarkTileChanged(mpoint, tileindex);
+    pathfinder_->hierarchy_.MarkTileChanged(x, y);
+    pathfinder_->requests_->MarkTileChanged(x, y);
+
+    for (HashMap<unsigned, PathFlowFieldEntry>::Iterator it = pathfinder_->flowFields_.Begin(); it != pathfinder_->flowFields_.End(); ++it)
+        it->second_.field_->MarkTileChanged(x, y);
+}
+
+unsigned PathFinder2D::RequestPath(const Vector2& startpos, int v1, const Vector2& endpos, int v2, unsigned moveTypeFlags, Node* requester, int priority)
+{
+    if (!pathfinder_)
+        return 0;
+
+    const int movetype = GetPathMoveType(moveTypeFlags);
+    if (movetype == -1)
+        return 0;
+
+    // the requests are solved in the front view (see PathRequestQueue::Set)
+    IntVector2 start, end;
+    pathfinder_->GetWorldTile(startpos, start);
+    pathfinder_->GetWorldTile(endpos, end);
+
+    return pathfinder_->requests_->Request(start, end, movetype, requester, priority);
+}
+
+bool PathFinder2D::GetFlowDirection(Node* target, unsigned moveTypeFlags, const Vector2& position, Vector2& direction)
+{
+    if (!pathfinder_ || !target)
+        return false;
+
+    const int movetype = GetPathMoveType(moveTypeFlags);
+    if (movetype == -1)
+        return false;
+
+    PathFlowField2D* field = pathfinder_->GetFlowField(target, movetype);
+
+    IntVector2 tile, next;
+    pathfinder_->GetWorldTile(position, tile);
+    if (!field->GetNextTile(tile.x_, tile.y_, next))
+        return false;
+
+    // the tile y goes down
+    direction.x_ = (float)(next.x_ - tile.x_) * info_->mTileWidth_;
+    direction.y_ = (float)(tile.y_ - next.y_) * info_->mTileHeight_;
+    return true;
+}
+
 bool PathFinder2D::IsPathFinished(int idpath)
 {
     Path2D* path = pathfinder_->GetPath(idpath);
@@ -132,15 +196,27 @@ bool PathFinder2D::IsPathFinished(int idpath)
 /// Instantiate Functions
 
 PathFinder2D::PathFinder2D(Context* context, World2DInfo* info)
-    : Object(context)
+    : Object(context), lastPathKey_(PATHSEARCH_NONE), hierarchy_(hierarchyWorld_)
 {
+    lastPathNode_.map_ = 0;
+
     info_ = info;
 
+    requests_ = new PathRequestQueue(context, this);
+    walkGraphs_ = new PathWalkGraphs(context);
+
+    SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(PathFinder2D, HandleUpdate));
+
     Init();
 }
 
 PathFinder2D::~PathFinder2D()
 {
+    requests_.Reset();
+    walkGraphs_.Reset();
+
+    ClearFlowFields();
+
     Free();
 
     URHO3D_LOGDEBUG("~PathFinder2D()");
@@ -157,6 +233,16 @@ void PathFinder2D::Init()
 
     tileCenter_ = Vector2(info_->mWidth_/info_->mapWidth_/2, info_->mHeight_/info_->mapHeight_/2);
 
+    walkGraphs_->Set(layerWidth_, layerHeight_, ViewManager::FRONTVIEW_Index);
+
+    hierarchyWorld_.Set(layerWidth_, layerHeight_, ViewManager::FRONTVIEW_Index, walkGraphs_);
+    hierarchy_.Clear();
+
+    requests_->Set(layerWidth_, layerHeight_, ViewManager::FRONTVIEW_Index);
+
+    ClearFlowFields();
+    flowWorld_.Set(layerWidth_, layerHeight_, ViewManager::FRONTVIEW_Index, walkGraphs_);
+
     URHO3D_LOGINFOF("PathFinder() - Init : width=%u height=%u", layerWidth_, layerHeight_);
 }
 
@@ -167,10 +253,88 @@ void PathFinder2D::Free()
     for (int i=0; i<storedPaths_.Size(); i++)
         delete storedPaths_[i];
     storedPaths_.Clear();
+    freePaths_.Clear();
+    nodeUsingPath_.Clear();
+
+    if (requests_)
+        requests_->ClearCache();
 
     URHO3D_LOGINFO("PathFinder2D() - Free ... OK !");
 }
 
+void PathFinder2D::HandleUpdate(StringHash eventType, VariantMap& eventData)
+{
+    if (!flowFields_.Size())
+        return;
+
+    URHO3D_PROFILE(UpdateFlowFields);
+
+    // the maps can change between the frames
+    flowWorld_.ClearCache();
+
+    const unsigned time = flowTimer_.GetMSec(false);
+
+    for (HashMap<unsigned, PathFlowFieldEntry>::Iterator it = flowFields_.Begin(); it != flowFields_.End();)
+    {
+        PathFlowFieldEntry& entry = it->second_;
+        Node* target = entry.target_.Get();
+        if (!target || time - entry.lastUse_ > FLOWFIELD_KEEPTIME)
+        {
+            delete entry.field_;
+            it = flowFields_.Erase(it);
+            continue;
+        }
+
+        // a new field when the target changes of tile, computed by steps
+        IntVector2 tile;
+        GetWorldTile(target->GetWorldPosition2D(), tile);
+        entry.field_->SetTarget(tile.x_, tile.y_);
+        entry.field_->Update();
+        ++it;
+    }
+}
+
+PathFlowField2D* PathFinder2D::GetFlowField(Node* target, int movetype)
+{
+    PathFlowFieldEntry& entry = flowFields_[target->GetID() * PMT_NumMoveTypes + movetype];
+
+    // new entry or the id of a removed node
+    if (entry.target_.Get() != target)
+    {
+        delete entry.field_;
+
+        entry.target_ = target;
+        entry.field_ = new PathFlowField2D(flowWorld_, movetype);
+    }
+
+    entry.lastUse_ = flowTimer_.GetMSec(false);
+    return entry.field_;
+}
+
+void PathFinder2D::ClearFlowFields()
+{
+    for (HashMap<unsigned, PathFlowFieldEntry>::Iterator it = flowFields_.Begin(); it != flowFields_.End(); ++it)
+        delete it->second_.field_;
+    flowFields_.Clear();
+}
+
+void PathFinder2D::GetWorldTile(const Vector2& position, IntVector2& tile) const
+{
+    ShortIntVector2 mpoint;
+    IntVector2 maptile;
+    info_->Convert2WorldMapPoint(position, mpoint);
+    info_->Convert2WorldMapPosition(mpoint, position, maptile);
+
+    tile.x_ = mpoint.x_ * layerWidth_ + maptile.x_;
+    tile.y_ = maptile.y_ - mpoint.y_ * layerHeight_;
+}
+
+void PathFinder2D::GetTilePosition(const IntVector2& tile, Vector2& position) const
+{
+    const ShortIntVector2 mpoint(GetPathClusterCoord(tile.x_, layerWidth_), -GetPathClusterCoord(tile.y_, layerHeight_));
+    info_->Convert2WorldPosition(mpoint, IntVector2(tile.x_ - mpoint.x_ * layerWidth_, tile.y_ + mpoint.y_ * layerHeight_), position);
+}
+
 int PathFinder2D::SearchPath(const Vector2& startpos, int v1, const Vector2& endpos, int v2, unsigned moveTypeFlags, bool partially, Map* map)
 {
     IntVector2 pStart, pEnd;
@@ -230,11 +394,25 @@ int PathFinder2D::SearchPath(const Vector2& startpos, int v1, const Vector2& end
     Timer* timerMsec_ = new Timer();
 
     int idpath = -1;
+    int result;
 
-    int result = Search_Astar(sStart, sEnd, moveTypeFlags, partially);
+#ifdef USE_WORLD2D
+    // far maps : the tile search would reach its limits, use the abstract graphs of the maps
+    if (Abs(mpointstart.x_ - mpointend.x_) > 1 || Abs(mpointstart.y_ - mpointend.y_) > 1)
+    {
+        result = Search_Hierarchical(sStart, sEnd, moveTypeFlags);
+
+        if (result == PathFound)
+            idpath = ConstructPath(hierarchyTiles_);
+    }
+    else
+#endif
+    {
+        result = Search_Astar(sStart, sEnd, moveTypeFlags, partially);
 
-    if (result == PathFound || result == PathPartiallyFound)
-        idpath = ConstructPath();
+        if (result == PathFound || result == PathPartiallyFound)
+            idpath = ConstructPath();
+    }
 
     if (idpath == -1)
         URHO3D_LOGINFOF("PathFinder() - FindPath : ... moveType=%s - PathNoFound heuristic=%u !",
@@ -246,7 +424,9 @@ int PathFinder2D::SearchPath(const Vector2& startpos, int v1, const Vector2& end
 
     if (HiresTimer::IsSupported())
     {
-        URHO3D_LOGINFOF("PathFinder() - FindPath : ... (elapsedTime=%d Msec (%d Usec) )", timerMsec_->GetMSec(false), timerUsec_->GetUSec(false));
+        const long long usec = timerUsec_->GetUSec(false);
+        URHO3D_LOGINFOF("PathFinder() - FindPath : ... (elapsedTime=%d Msec (%d Usec) expanded=%u nodes/ms=%.1f)", timerMsec_->GetMSec(false), (int)usec,
+                        GetNumExpanded(), usec > 0 ? GetNumExpanded() * 1000.f / usec : 0.f);
         delete timerUsec_;
     }
     else
@@ -259,8 +439,8 @@ int PathFinder2D::SearchPath(const Vector2& startpos, int v1, const Vector2& end
 
 short unsigned PathFinder2D::GetHeuristic(const PathNode& sStart, const PathNode& sEnd, unsigned moveTypeFlags)
 {
-    return (moveTypeFlags & MV_FLY) ? Heuristic_fly(sStart, sEnd)
-           : (moveTypeFlags & MV_WALK) ? Heuristic_walker(sStart, sEnd)
+    return (moveTypeFlags & MV_FLY) ? Heuristic_fly(sStart.x_, sStart.y_, sEnd.x_, sEnd.y_)
+           : (moveTypeFlags & MV_WALK) ? Heuristic_walker(sStart.x_, sStart.y_, sEnd.x_, sEnd.y_)
            : 0;
 }
 
@@ -269,10 +449,6 @@ int PathFinder2D::Search_Astar(PathNode& sStart, PathNode& sEnd, unsigned moveTy
     if ((moveTypeFlags & (MV_FLY|MV_WALK)) == 0)
         return NoPathFound;
 
-    PathFunc heuristic;
-    PathFunc nghbDistance;
-    int status;
-
     unsigned areaflag = (moveTypeFlags & MV_FLY) ? flyableFlag : (walkableFlag | jumpableRightFlag | jumpableLeftFlag);
 
     /// INIT : Set Heuristic functions and permission on areas (areaflag)
@@ -280,184 +456,317 @@ int PathFinder2D::Search_Astar(PathNode& sStart, PathNode& sEnd, unsigned moveTy
     if (!(sEnd.map_->GetAreaProps(sEnd.map_->GetTileIndex(sEnd.x_, sEnd.y_), sEnd.v_, 3) & areaflag))
         return NoPathFound;
 
-    heuristic = (moveTypeFlags & MV_FLY) ? &Heuristic_fly : &Heuristic_walker;
-    nghbDistance = (moveTypeFlags & MV_FLY) ? &NghbDist_fly : &NghbDist_walker;
     areaflag_ = (moveTypeFlags & MV_FLY) ? areaflag : areaflag | flyableFlag; // MV_WALK : flyableFlag for falling
 
-    /// SEARCH
-//    LOGINFOF("PathFinder() - Search_Astar : ...");
-    open_.Clear();
-    closed_.Clear();
+    nav_.Set(layerWidth_, layerHeight_, sStart.v_, moveTypeFlags, areaflag_, MAX_SEARCHTIME, walkGraphs_);
 
-    sStart.f_ = sStart.g_ + (*heuristic)(sStart, sEnd);
-    open_.Push(sStart);
+    const unsigned startkey = nav_.GetKey(sStart.map_, sStart.x_, sStart.y_);
+    const unsigned endkey = nav_.GetKey(sEnd.map_, sEnd.x_, sEnd.y_);
+    nav_.SetGoal(endkey);
 
-    Timer* timerMsec_ = new Timer();
+    /// SEARCH
+    int status = search_.Search(nav_, startkey, endkey, MAX_SEARCHCOSTFACTOR * nav_.GetHeuristic(startkey)) == PSS_Found ? PathFound : NoPathFound;
 
-    PathNode a;
+    const unsigned lastkey = search_.GetLastKey();
+    const unsigned lastg = search_.GetCost(lastkey);
 
-    while (open_.Size())
+    if (status == NoPathFound && partially && lastg < search_.GetStartF())
+        status = PathPartiallyFound;
+
+    if (status == PathFound || status == PathPartiallyFound)
     {
-        a = open_.Back();
+        lastPathKey_ = lastkey;
+        lastPathNode_ = PathNode(nav_.GetX(lastkey), nav_.GetY(lastkey), sStart.v_, nav_.GetMap(lastkey));
+        lastPathNode_.g_ = lastg;
+        lastPathNode_.f_ = lastg + nav_.GetHeuristic(lastkey);
+    }
 
-        open_.Pop();
+    return status;
+}
 
-        closed_.Push(a);
 
-        if (a == sEnd)
-        {
-            status = PathFound;
-            break;
-        }
+int PathFinder2D::Search_Hierarchical(PathNode& sStart, PathNode& sEnd, unsigned moveTypeFlags)
+{
+    const int movetype = GetPathMoveType(moveTypeFlags);
+    if (movetype == -1)
+        return NoPathFound;
 
-        if (a.f_ > MAX_SEARCHCOSTFACTOR * sStart.f_ || timerMsec_->GetMSec(false) > MAX_SEARCHTIME)
-        {
-            status = NoPathFound;
-            break;
-        }
+    hierarchyWorld_.ClearCache();
 
-        GetNeighbors(a);
+    const ShortIntVector2& mstart = sStart.map_->GetMapPoint();
+    const ShortIntVector2& mend = sEnd.map_->GetMapPoint();
+    const IntVector2 start(mstart.x_ * layerWidth_ + sStart.x_, sStart.y_ - mstart.y_ * layerHeight_);
+    const IntVector2 end(mend.x_ * layerWidth_ + sEnd.x_, sEnd.y_ - mend.y_ * layerHeight_);
 
-        for (int i=0; i < numNeighbors_; ++i)
-        {
-            // Get Neighbor mooreIndex i verify the props
-            PathNode& b = neighbors_[i];
+    const int status = hierarchy_.FindPath(movetype, start, end);
 
-            if (!closed_.Contains(b))
-            {
-//                URHO3D_LOGINFOF("PathFinder() - Search_Astar : GetNeighbor(%u(x%u,y%u),m%d) = %u(x%u,y%u)",
-//                         a, a->x_, a->y_, i, b, b->x_, b->y_);
-                if (!open_.Contains(b))
-                    b.g_= USHRT_MAX;
+    URHO3D_LOGINFOF("PathFinder() - Search_Hierarchical : ... maps=%u expanded=%u waypoints=%u", hierarchy_.GetNumClusters(),
+                    hierarchy_.GetNumExpanded(), hierarchy_.GetNumWaypoints());
 
-                ComputeCost_Astar(&a, &b, &sEnd, heuristic, nghbDistance);
-            }
-//            else
-//                URHO3D_LOGINFOF("PathFinder() - Search_Astar : GetNeighbor(%u(x%u,y%u),m%d) = %u(x%u,y%u) in closed_", a, a->x_,a->y_, i, b, b->x_, b->y_);
-        }
-    }
+    if (status != PSS_Found || !hierarchy_.RefinePath(hierarchyTiles_))
+        return NoPathFound;
 
-    if (status == NoPathFound && partially && a.g_ < sStart.f_)
-        status = PathPartiallyFound;
+    lastPathKey_ = PATHSEARCH_NONE;
+    lastPathNode_ = sEnd;
+    lastPathNode_.g_ = lastPathNode_.f_ = Min(hierarchy_.GetCost(), (unsigned)USHRT_MAX);
 
-    if (status == PathFound || status == PathPartiallyFound)
-        lastPathNode_ = a;
+    return PathFound;
+}
 
-    delete timerMsec_;
-    return status;
+
+/// Search Navigation
+
+void PathFinderNav::Set(short unsigned width, short unsigned height, int v, unsigned moveTypeFlags, unsigned areaflag, unsigned maxtime, PathWalkGraphs* walkgraphs)
+{
+    width_ = width;
+    height_ = height;
+    v_ = v;
+    moveTypeFlags_ = moveTypeFlags;
+    areaflag_ = areaflag;
+    maxTime_ = maxtime;
+
+    // the walker graphs are built for one view
+    walkGraphs_ = walkgraphs && !(moveTypeFlags & MV_FLY) && v == walkgraphs->GetViewIndex() ? walkgraphs : 0;
+    linkFrom_ = PATHSEARCH_NONE;
+
+    maps_.Clear();
+    graphs_.Clear();
+    timer_.Reset();
+}
+
+void PathFinderNav::SetGoal(unsigned key)
+{
+    goalx_ = GetWorldX(key);
+    goaly_ = GetWorldY(key);
 }
 
-void PathFinder2D::ComputeCost_Astar(PathNode* a, PathNode* b, PathNode* sEnd, PathFunc heuristic, PathFunc nghbDistance)
+unsigned PathFinderNav::GetKey(Map* map, int x, int y)
 {
-//    URHO3D_LOGINFOF("PathFinder() - Search_Astar : ComputeCost_Astar(%u,%u) ...", a, b);
-    short unsigned gtemp = b->g_;
-    short unsigned nghbCost = (*nghbDistance)(*a, *b);
+    unsigned slot = 0;
+    while (slot < maps_.Size() && maps_[slot] != map)
+        slot++;
 
-    if (a->g_ + nghbCost < b->g_)
+    if (slot == maps_.Size())
     {
-        b->parentx_ = a->x_;
-        b->parenty_ = a->y_;
-        b->parentv_ = a->v_;
-        b->parentmap_ = a->map_;
-        b->g_ = a->g_ + nghbCost;
+        maps_.Push(map);
+        graphs_.Push(walkGraphs_ ? walkGraphs_->GetGraph(map) : 0);
     }
 
-    if (b->g_ < gtemp)
-    {
-        b->f_ = b->g_ + (*heuristic)(*b, *sEnd);
+    return GetPathSearchKey(slot, map->GetTileIndex(x, y));
+}
 
-        if (!open_.Contains(*b))
-            open_.Push(*b);
+// world tile coordinates : the y of the map points goes up, the y of the tiles goes down
+int PathFinderNav::GetWorldX(unsigned key) const
+{
+    return GetMap(key)->GetMapPoint().x_ * width_ + GetX(key);
+}
 
-//        URHO3D_LOGINFOF("PathFinder() - Search_Astar : ComputeCost_Astar(%u,%u) lower cost %u(%u) => Sort open_(%u)", a, b, b->g_, gtemp, open_.Size());
+int PathFinderNav::GetWorldY(unsigned key) const
+{
+    return GetY(key) - GetMap(key)->GetMapPoint().y_ * height_;
+}
+
+Map* PathFinderNav::GetNeighborMap(Map* map, int& x, int& y) const
+{
+    // bound Test
+    short int mapdx = 0;
+    short int mapdy = 0;
+    if      (x < 0)
+    {
+        mapdx = -1;
+        x = width_-1;
+    }
+    else if (x >= width_)
+    {
+        mapdx = 1;
+        x = 0;
+    }
+    if      (y < 0)
+    {
+        mapdy = 1;
+        y = height_-1;
+    }
+    else if (y >= height_)
+    {
+        mapdy = -1;
+        y = 0;
+    }
 
-        Sort(open_.Begin(), open_.End(), ComparePathNode);
+    // get map if out of bound map
+    if (mapdx != 0 || mapdy != 0)
+    {
+#ifdef USE_WORLD2D
+        return World2D::GetMapAt(map->GetMapPoint() + ShortIntVector2(mapdx, mapdy));
+#else
+        return 0;
+#endif
     }
+
+    return map;
 }
 
-void PathFinder2D::GetNeighbors(const PathNode& a)
+unsigned PathFinderNav::GetNeighbors(unsigned key, unsigned* keys)
 {
-    short int x;
-    short int y;
-    short int v;
-    short int mapdx;
-    short int mapdy;
+    const PathWalkGraph* graph = graphs_[GetPathSearchSlot(key)];
+    if (graph)
+        return GetWalkNeighbors(key, graph, keys);
+
+    const int ax = GetX(key);
+    const int ay = GetY(key);
+    Map* amap = GetMap(key);
+
+    int x, y;
     Map* map;
-    numNeighbors_ = 0;
+    unsigned numneighbors = 0;
 
     for (int imoore=0; imoore<8; imoore++)
     {
-        // init position
-        x = a.x_ + MapInfo::neighborOffX[imoore];
-        y = a.y_ + MapInfo::neighborOffY[imoore];
-        v = a.v_;
-        map = a.map_;
+        x = ax + MapInfo::neighborOffX[imoore];
+        y = ay + MapInfo::neighborOffY[imoore];
 
-        // bound Test
-        mapdx = 0;
-        mapdy = 0;
-        if      (x < 0)
-        {
-            mapdx = -1;
-            x = layerWidth_-1;
-        }
-        else if (x >= layerWidth_)
-        {
-            mapdx = 1;
-            x = 0;
-        }
-        if      (y < 0)
-        {
-            mapdy = 1;
-            y = layerHeight_-1;
-        }
-        else if (y >= layerHeight_)
-        {
-            mapdy = -1;
-            y = 0;
-        }
+        map = GetNeighborMap(amap, x, y);
+        if (!map)
+            continue;
 
-        // get map if out of bound map
+        if (map->GetAreaProps(map->GetTileIndex(x, y), v_, 3) & areaflag_)
+            keys[numneighbors++] = GetKey(map, x, y);
+    }
 
-        if (mapdx != 0 || mapdy != 0)
-        {
-#ifdef USE_WORLD2D
-            map = World2D::GetMapAt(map->GetMapPoint() + ShortIntVector2(mapdx, mapdy));
-#else
-            map = 0;
-#endif
-        }
+    return numneighbors;
+}
+
+// the links of the walker graph : the passable neighbors with their costs
+unsigned PathFinderNav::GetWalkNeighbors(unsigned key, const PathWalkGraph* graph, unsigned* keys)
+{
+    const int ax = GetX(key);
+    const int ay = GetY(key);
+    Map* amap = GetMap(key);
+
+    const PathWalkLink* links;
+    const unsigned numlinks = graph->GetLinks(ax, ay, links);
 
+    int x, y;
+    Map* map;
+    unsigned numneighbors = 0;
+
+    for (unsigned i = 0; i < numlinks; i++)
+    {
+        x = ax + links[i].dx_;
+        y = ay + links[i].dy_;
+
+        map = GetNeighborMap(amap, x, y);
         if (!map)
             continue;
 
-        if (map->GetAreaProps(map->GetTileIndex(x, y), v, 3) & areaflag_)
-        {
-//            URHO3D_LOGINFOF("PathFinder2D() - GetNeighbor(%u,%d) : PathNode x=%d y=%d", a, imoore, x, y);
-            neighbors_[numNeighbors_].x_ = x;
-            neighbors_[numNeighbors_].y_ = y;
-            neighbors_[numNeighbors_].v_ = v;
-            neighbors_[numNeighbors_].f_ = USHRT_MAX;
-            neighbors_[numNeighbors_].map_ = map;
-            neighbors_[numNeighbors_].parentx_ = a.x_;
-            neighbors_[numNeighbors_].parenty_ = a.y_;
-            neighbors_[numNeighbors_].parentmap_ = a.map_;
-
-            numNeighbors_++;
-        }
+        keys[numneighbors] = linkKeys_[numneighbors] = GetKey(map, x, y);
+        linkCosts_[numneighbors] = links[i].cost_;
+        numneighbors++;
+    }
+
+    linkFrom_ = key;
+    numLinkKeys_ = numneighbors;
+
+    return numneighbors;
+}
+
+unsigned PathFinderNav::GetCost(unsigned from, unsigned to) const
+{
+    // walker graph : the cost of the link
+    if (from == linkFrom_)
+    {
+        for (unsigned i = 0; i < numLinkKeys_; i++)
+            if (linkKeys_[i] == to)
+                return linkCosts_[i];
     }
+
+    const int ax = GetWorldX(from);
+    const int ay = GetWorldY(from);
+    const int bx = GetWorldX(to);
+    const int by = GetWorldY(to);
+
+    if (moveTypeFlags_ & MV_FLY)
+        return NghbDist_fly(ax, ay, bx, by);
+
+    Map* map = GetMap(to);
+    return NghbDist_walker(ax, ay, bx, by, map->GetAreaProps(GetPathSearchTile(to), v_, 3));
 }
 
+unsigned PathFinderNav::GetHeuristic(unsigned key) const
+{
+    return (moveTypeFlags_ & MV_FLY) ? Heuristic_fly(GetWorldX(key), GetWorldY(key), goalx_, goaly_)
+           : Heuristic_walker(GetWorldX(key), GetWorldY(key), goalx_, goaly_);
+}
+
+
+/// Hierarchical Search World
+
+void PathWorld2D::Set(short unsigned width, short unsigned height, int v, PathWalkGraphs* walkgraphs)
+{
+    width_ = width;
+    height_ = height;
+    v_ = v;
+    walkGraphs_ = walkgraphs && v == walkgraphs->GetViewIndex() ? walkgraphs : 0;
+    lastMap_ = 0;
+    lastGraph_ = 0;
+}
+
+const void* PathWorld2D::GetMapStamp(int mx, int my) const
+{
+#ifdef USE_WORLD2D
+    return World2D::GetAvailableMapAt(ShortIntVector2(mx, my));
+#else
+    return 0;
+#endif
+}
+
+unsigned PathWorld2D::GetAreaProps(int movetype, int x, int y) const
+{
+    const ShortIntVector2 mpoint(GetPathClusterCoord(x, width_), -GetPathClusterCoord(y, height_));
+    if (!lastMap_ || mpoint != lastMapPoint_)
+    {
+        lastMap_ = (Map*)GetMapStamp(mpoint.x_, mpoint.y_);
+        lastMapPoint_ = mpoint;
+        lastGraph_ = lastMap_ && walkGraphs_ ? walkGraphs_->GetGraph(mpoint.x_, mpoint.y_) : 0;
+    }
+
+    if (!lastMap_)
+        return nomoveFlag;
+
+    if (movetype == PMT_Walker && lastGraph_)
+        return lastGraph_->GetNode(x - mpoint.x_ * width_, y + mpoint.y_ * height_).props_;
+
+    return lastMap_->GetAreaProps(lastMap_->GetTileIndex(x - mpoint.x_ * width_, y + mpoint.y_ * height_), v_, 3);
+}
+
+bool PathWorld2D::IsPassable(int movetype, int x, int y) const
+{
+    return (GetAreaProps(movetype, x, y) & GetPathMoveAreaFlags(movetype)) != 0;
+}
+
+unsigned PathWorld2D::GetCost(int movetype, int ax, int ay, int bx, int by) const
+{
+    if (movetype != PMT_Walker)
+        return NghbDist_fly(ax, ay, bx, by);
+
+    return NghbDist_walker(ax, ay, bx, by, GetAreaProps(movetype, bx, by));
+}
+
+unsigned PathWorld2D::GetHeuristic(int movetype, int ax, int ay, int bx, int by) const
+{
+    return movetype == PMT_Walker ? Heuristic_walker(ax, ay, bx, by) : Heuristic_fly(ax, ay, bx, by);
+}
+
+
+/// Path Construction
+
 inline bool PathFinder2D::isPointOnSameLine(int px, int py, int startx, int starty, int endx, int endy)
 {
     return (startx == endx && startx == px) || (starty == endy && starty == py);
 }
 
-int PathFinder2D::ConstructPath()
+Path2D* PathFinder2D::GetFreePath()
 {
-    Vector<PathNode>::ConstIterator it = closed_.Find(lastPathNode_);
-    if (it == closed_.End())
-        return -1;
+    static unsigned serial = 0;
 
     Path2D* path;
 
@@ -477,36 +786,52 @@ int PathFinder2D::ConstructPath()
 //        URHO3D_LOGINFOF("PathFinder2D() - ConstructPath : Add new Path %u !", path->id_);
     }
 
+    // the cached path requests check the serial (see PathRequestQueue)
+    path->serial_ = ++serial;
+
     URHO3D_LOGINFOF("PathFinder2D() - ConstructPath : ... id=%u", path->id_);
 
+    return path;
+}
+
+int PathFinder2D::ConstructPath()
+{
+    if (!lastPathNode_.map_ || !search_.IsReached(lastPathKey_))
+        return -1;
+
+    Path2D* path = GetFreePath();
+
     // Calculate num nodes
     // init with last point
-    ibuff_[0] = it - closed_.Begin();
-    short unsigned childx = (*it).x_;
-    short unsigned childy = (*it).y_;
+    unsigned key = lastPathKey_;
+    ibuff_[0] = key;
+    int childx = nav_.GetWorldX(key);
+    int childy = nav_.GetWorldY(key);
     unsigned index = 1;
-    for (;;)
+    while (search_.GetParent(key) != PATHSEARCH_NONE)
     {
-        it = closed_.Find(PathNode((*it).parentx_, (*it).parenty_, (*it).parentv_, (*it).parentmap_));
-        const PathNode& p = (*it);
+        key = search_.GetParent(key);
+        const unsigned parent = search_.GetParent(key);
         // if no parent, it's the first point, add its index and stop
-        if (!p.parentmap_)
+        if (parent == PATHSEARCH_NONE)
         {
-            ibuff_[index] = it - closed_.Begin();
+            ibuff_[index] = key;
             index++;
             break;
         }
 #ifdef REDUCE_PATHPOINTS
         // if p is not on the line compound by child and parent vectors, add its index
-        if (!isPointOnSameLine(p.x_, p.y_, childx, childy, p.parentx_, p.parenty_))
+        const int px = nav_.GetWorldX(key);
+        const int py = nav_.GetWorldY(key);
+        if (!isPointOnSameLine(px, py, childx, childy, nav_.GetWorldX(parent), nav_.GetWorldY(parent)))
         {
-            ibuff_[index] = it - closed_.Begin();
-            childx = p.x_;
-            childy = p.y_;
+            ibuff_[index] = key;
+            childx = px;
+            childy = py;
             index++;
         }
 #else
-        ibuff_[index] = it - closed_.Begin();
+        ibuff_[index] = key;
         index++;
 #endif
         if (index > 1023)
@@ -519,17 +844,15 @@ int PathFinder2D::ConstructPath()
     path->numNodes_ = index;
     path->points_.Resize(path->numNodes_);
 
-    URHO3D_LOGINFOF("PathFinder2D() - ConstructPath : ... Resize Points %u closed_ = %u!", path->points_.Size(), closed_.Size());
+    URHO3D_LOGINFOF("PathFinder2D() - ConstructPath : ... Resize Points %u expanded = %u!", path->points_.Size(), search_.GetNumExpanded());
 
     // store each node in points_
     while (index > 0)
     {
 //        URHO3D_LOGINFOF("ibuff_[%u]=%u", index-1, ibuff_[index-1]);
-        const PathNode& p = closed_[ibuff_[index-1]];
+        key = ibuff_[index-1];
         // last point in ibuff is the first point
-        info_->Convert2WorldPosition(p.map_->GetMapPoint(), IntVector2(p.x_, p.y_), path->points_[path->numNodes_-index]);
-//        path->points_[path->numNodes_-index] = p.map_->GetGroundLayer()->GetTileNode(p.x_, p.y_)->GetWorldPosition2D() + tileCenter_;
-//        path->points_[path->numNodes_-index] += tileCenter_;
+        info_->Convert2WorldPosition(nav_.GetMap(key)->GetMapPoint(), IntVector2(nav_.GetX(key), nav_.GetY(key)), path->points_[path->numNodes_-index]);
         index--;
     }
 
@@ -550,6 +873,53 @@ int PathFinder2D::ConstructPath()
 }
 
 
+int PathFinder2D::ConstructPath(const PODVector<IntVector2>& tiles)
+{
+    if (tiles.Size() < 2)
+        return -1;
+
+    Path2D* path = GetFreePath();
+
+    // Calculate num nodes
+    unsigned index = 0;
+    ibuff_[index++] = 0;
+    for (unsigned i = 1; i + 1 < tiles.Size() && index < 1023; i++)
+    {
+#ifdef REDUCE_PATHPOINTS
+        // if the tile is not on the line compound by the last point and the next tile, add its index
+        const IntVector2& last = tiles[ibuff_[index-1]];
+        if (isPointOnSameLine(tiles[i].x_, tiles[i].y_, last.x_, last.y_, tiles[i+1].x_, tiles[i+1].y_))
+            continue;
+#endif
+        ibuff_[index++] = i;
+    }
+    ibuff_[index++] = tiles.Size()-1;
+
+    path->numNodes_ = index;
+    path->points_.Resize(path->numNodes_);
+
+    URHO3D_LOGINFOF("PathFinder2D() - ConstructPath : ... Resize Points %u tiles = %u!", path->points_.Size(), tiles.Size());
+
+    // store each node in points_
+    for (unsigned i = 0; i < index; i++)
+        GetTilePosition(tiles[ibuff_[i]], path->points_[i]);
+
+    path->status_ = PathReady;
+    path->numActiveUsers_ = 0;
+
+    // add segments
+    path->segments_.Resize(path->numNodes_);
+    for (int i=1; i<path->numNodes_; i++)
+    {
+        path->segments_[i] = path->points_[i] - path->points_[i-1];
+    }
+
+    URHO3D_LOGINFO("PathFinder2D() - ConstructPath : ... OK !");
+
+    return path->id_;
+}
+
+
 /// Handle Path Functions
 
 void PathFinder2D::FreeUserSlotInPath(Path2D* path, int iuser)
@@ -1,8 +1,17 @@
 #pragma once
 
+#include <Urho3D/Core/Timer.h>
+
 #include "DefsMove.h"
 #include "Map.h"
 
+#include "PathCosts.h"
+#include "PathSearch.h"
+#include "PathHierarchy.h"
+#include "PathRequests.h"
+#include "PathFlowField.h"
+#include "PathWalkGraph.h"
+
 #define DEBUG_PATH
 
 
@@ -74,6 +83,8 @@ public :
 
 struct Path2D
 {
+    // incremented each time the path is reused
+    unsigned serial_;
     short unsigned id_;
     short unsigned numNodes_;
     short unsigned numActiveUsers_;
@@ -86,9 +97,127 @@ struct Path2D
     PODVector<Vector2> segments_;
 };
 
-typedef short unsigned (*PathFunc)(const PathNode& a, const PathNode& b);
+/// PathFinderNav : the tiles of the maps crossed by a search as the graph of PathSearch.
+/// The maps get a slot when the search reaches them, the costs are computed on the world tile coordinates.
+/// The walkers move on the walker graphs of the maps when they are built (see PathWalkGraph.h).
+class PathFinderNav
+{
+public:
+    PathFinderNav() : width_(0), height_(0), v_(0), moveTypeFlags_(0), areaflag_(0), goalx_(0), goaly_(0), maxTime_(0),
+        walkGraphs_(0), linkFrom_(PATHSEARCH_NONE), numLinkKeys_(0) { }
+
+    void Set(short unsigned width, short unsigned height, int v, unsigned moveTypeFlags, unsigned areaflag, unsigned maxtime, PathWalkGraphs* walkgraphs=0);
+    void SetGoal(unsigned key);
+
+    unsigned GetKey(Map* map, int x, int y);
+    Map* GetMap(unsigned key) const
+    {
+        return maps_[GetPathSearchSlot(key)];
+    }
+    int GetX(unsigned key) const
+    {
+        return GetPathSearchTile(key) % width_;
+    }
+    int GetY(unsigned key) const
+    {
+        return GetPathSearchTile(key) / width_;
+    }
+    int GetWorldX(unsigned key) const;
+    int GetWorldY(unsigned key) const;
+
+    /// PathSearch navigation
+    unsigned GetNumSlots() const
+    {
+        return maps_.Size();
+    }
+    unsigned GetNumTiles() const
+    {
+        return width_ * height_;
+    }
+    unsigned GetNeighbors(unsigned key, unsigned* keys);
+    unsigned GetCost(unsigned from, unsigned to) const;
+    unsigned GetHeuristic(unsigned key) const;
+    bool IsTimeOut(unsigned numExpanded) const
+    {
+        return maxTime_ && (numExpanded & 15) == 0 && timer_.GetMSec(false) > maxTime_;
+    }
 
+private:
+    Map* GetNeighborMap(Map* map, int& x, int& y) const;
+    unsigned GetWalkNeighbors(unsigned key, const PathWalkGraph* graph, unsigned* keys);
 
+    short unsigned width_, height_;
+    int v_;
+    unsigned moveTypeFlags_;
+    unsigned areaflag_;
+    int goalx_, goaly_;
+    unsigned maxTime_;
+    Timer timer_;
+
+    // maps and walker graphs by slot
+    PODVector<Map*> maps_;
+    PathWalkGraphs* walkGraphs_;
+    PODVector<const PathWalkGraph*> graphs_;
+
+    // the costs of the links of the last expanded node
+    unsigned linkFrom_;
+    unsigned numLinkKeys_;
+    unsigned linkKeys_[PATHSEARCH_MAXNEIGHBORS];
+    unsigned linkCosts_[PATHSEARCH_MAXNEIGHBORS];
+};
+
+/// PathWorld2D : the available maps of World2D for PathHierarchy, in world tile coordinates.
+/// The walkers use the area props of the walker graphs when they are built.
+class PathWorld2D
+{
+public:
+    PathWorld2D() : width_(0), height_(0), v_(0), walkGraphs_(0), lastMap_(0), lastGraph_(0) { }
+
+    void Set(short unsigned width, short unsigned height, int v, PathWalkGraphs* walkgraphs=0);
+    /// the maps and the graphs can change between the searches
+    void ClearCache()
+    {
+        lastMap_ = 0;
+        lastGraph_ = 0;
+    }
+
+    int GetMapWidth() const
+    {
+        return width_;
+    }
+    int GetMapHeight() const
+    {
+        return height_;
+    }
+    const void* GetMapStamp(int mx, int my) const;
+    bool IsPassable(int movetype, int x, int y) const;
+    unsigned GetCost(int movetype, int ax, int ay, int bx, int by) const;
+    unsigned GetHeuristic(int movetype, int ax, int ay, int bx, int by) const;
+
+private:
+    unsigned GetAreaProps(int movetype, int x, int y) const;
+
+    short unsigned width_, height_;
+    int v_;
+    PathWalkGraphs* walkGraphs_;
+
+    mutable ShortIntVector2 lastMapPoint_;
+    mutable Map* lastMap_;
+    mutable const PathWalkGraph* lastGraph_;
+};
+
+
+
+typedef PathFlowField<PathWorld2D> PathFlowField2D;
+
+struct PathFlowFieldEntry
+{
+    PathFlowFieldEntry() : field_(0), lastUse_(0) { }
+
+    WeakPtr<Node> target_;
+    PathFlowField2D* field_;
+    unsigned lastUse_;
+};
 
 class PathFinder2D : public Object
 {
@@ -113,6 +242,17 @@ public :
     {
         if (pathfinder_) pathfinder_->Free();
     }
+    /// A tile has changed : patch the walker graphs and rebuild the abstract graph of its maps at the next hierarchical search
+    static void MarkTileChanged(const ShortIntVector2& mpoint, unsigned tileindex);
+    /// Queue a path request : the requester node receives GO_PATHREQUESTDONE with the returned id on the main thread. 0 if the request is not valid.
+    static unsigned RequestPath(const Vector2& startpos, int v1, const Vector2& endpos, int v2, unsigned moveTypeFlags, Node* requester, int priority=0);
+    static const PathRequestMetrics* GetRequestMetrics()
+    {
+        return pathfinder_ ? &pathfinder_->requests_->GetMetrics() : 0;
+    }
+    /// Flow field to a target, shared by all its chasers : the direction of the next tile from the position (the tile step scaled by the tile size).
+    /// false if the field isn't ready or doesn't reach the position.
+    static bool GetFlowDirection(Node* target, unsigned moveTypeFlags, const Vector2& position, Vector2& direction);
 
     PathFinder2D(Context* context, World2DInfo* info);
     virtual ~PathFinder2D();
@@ -137,6 +277,11 @@ public :
         return lastPathNode_.map_ ? lastPathNode_.f_ : 0;
     }
     short unsigned GetHeuristic(const PathNode& sStart, const PathNode& sEnd, unsigned moveTypeFlags);
+    /// Nodes expanded by the last search
+    unsigned GetNumExpanded() const
+    {
+        return search_.GetNumExpanded();
+    }
 
     void DumpPath(int idpath) const;
 
@@ -146,15 +291,26 @@ public :
 #endif // DEBUG_PATH
 
 private :
+    friend class PathRequestQueue;
+
     void Init();
     void Free();
+    void HandleUpdate(StringHash eventType, VariantMap& eventData);
+
+    void GetWorldTile(const Vector2& position, IntVector2& tile) const;
+    void GetTilePosition(const IntVector2& tile, Vector2& position) const;
+
+    PathFlowField2D* GetFlowField(Node* target, int movetype);
+    void ClearFlowFields();
 
     // a* functions for FindPath
     int Search_Astar(PathNode& sStart, PathNode& sEnd, unsigned moveTypeFlags, bool partially);
-    void ComputeCost_Astar(PathNode* a, PathNode* b, PathNode* sEnd, PathFunc heuristic, PathFunc nghbDistance);
-    void GetNeighbors(const PathNode& a);
+    // hierarchical search for the far maps
+    int Search_Hierarchical(PathNode& sStart, PathNode& sEnd, unsigned moveTypeFlags);
     inline bool isPointOnSameLine(int px, int py, int startx, int starty, int endx, int endy);
-    int ConstructPath();   // use lastPathNode_ and closed_ table
+    Path2D* GetFreePath();
+    int ConstructPath();   // use lastPathNode_ and the parents of the search
+    int ConstructPath(const PODVector<IntVector2>& tiles);   // world tiles
 
     short unsigned layerWidth_;
     short unsigned layerHeight_;
@@ -162,17 +318,30 @@ private :
     Vector2 tileCenter_;
     unsigned areaflag_;
 
-    // table for a* search
-    Vector<PathNode> open_;      // sorted via QuickSort (with compare PathNode function)
-    Vector<PathNode> closed_;
+    // a* search : binary heap and dense node states (see PathSearch.h)
+    PathFinderNav nav_;
+    PathSearch<PathFinderNav> search_;
     PathNode lastPathNode_;
+    unsigned lastPathKey_;
+
+    // hierarchical search : the abstract graphs of the maps (see PathHierarchy.h)
+    PathWorld2D hierarchyWorld_;
+    PathHierarchy<PathWorld2D> hierarchy_;
+    PODVector<IntVector2> hierarchyTiles_;
 
-    // local data for GetNeighbors
-    short unsigned numNeighbors_;
-    PathNode neighbors_[8];
+    // asynchronous path requests
+    SharedPtr<PathRequestQueue> requests_;
+
+    // the walker graphs of the maps
+    SharedPtr<PathWalkGraphs> walkGraphs_;
+
+    // flow fields by target node and move type (see PathFlowField.h)
+    PathWorld2D flowWorld_;
+    HashMap<unsigned, PathFlowFieldEntry> flowFields_;
+    Timer flowTimer_;
 
     // handle path var
-    unsigned ibuff_[1024];       // buffer for ConstructPath
+    unsigned ibuff_[1024];       // buffer for ConstructPath (node keys)
     HashMap<Node*, int> nodeUsingPath_;
     Vector<Path2D*> storedPaths_;
     List<Path2D*> freePaths_;
@@ -180,123 +349,3 @@ private :
     static World2DInfo* info_;
     static PathFinder2D* pathfinder_;
 };
-
-// Compare for Descending Sort higher cost to lower cost
-// see Sort.h (QuickSort)
-// get the last element for lower cost : Back then Pop the table
-static inline bool ComparePathNode(const PathNode& i, const PathNode& j)
-{
-    return (i.f_ > j.f_);
-}
-
-
-#define COST_NOWAY          65535
-#define COST_X	            10
-#define COST_XY	            14
-#define COST_DXY            4
-
-static inline short unsigned Heuristic_fly(const PathNode& a, const PathNode& b)
-{
-//    // Manhattan : num block horizontal and vertical between a and b
-//    return 10 * (Abs(a.x_ - b.x_) + Abs(a.y_ - b.y_));
-
-    // Octile
-    short unsigned dx = (a.x_ > b.x_)?(a.x_ - b.x_):(b.x_ - a.x_);
-    short unsigned dy = (a.y_ > b.y_)?(a.y_ - b.y_):(b.y_ - a.y_);
-    return (dx > dy) ? (dx*COST_X + dy*COST_DXY) : (dy*COST_X + dx*COST_DXY);
-}
-
-static inline short unsigned NghbDist_fly(const PathNode& a, const PathNode& b)
-{
-    int dx = Abs(a.x_ - b.x_);
-    int dy = Abs(a.y_ - b.y_);
-
-    if (dx + dy == 1)
-    {
-        return COST_X;
-    }
-    else if (dx + dy == 2)
-    {
-        return COST_XY;
-    }
-
-    return 0;
-}
-
-#define COST_WALK_YMID	45
-#define COST_WALK_DXMID	35
-#define COST_WALK_YUP	60
-#define COST_WALK_YDOWN	9
-#define COST_WALK_XYUP	80
-#define COST_WALK_XYDOWN	13
-
-//#define COST_WALK_YMID	    26
-//#define COST_WALK_DXMID	    16
-//#define COST_WALK_YUP	    40
-//#define COST_WALK_YDOWN	    8
-//#define COST_WALK_XYUP	    50
-//#define COST_WALK_XYDOWN	12
-
-static inline short unsigned Heuristic_walker(const PathNode& a, const PathNode& b)
-{
-//    // Manhattan : num block horizontal and vertical between a and b
-//    return 10 * Abs(a.x_ - b.x_) + (a.y_ - b.y_ > 0 ? 20 : 10) * Abs(a.y_ - b.y_);
-
-    // Octile
-    short unsigned dx = (a.x_ > b.x_)?(a.x_ - b.x_):(b.x_ - a.x_);
-    short unsigned dy;
-    short unsigned jCost = 0;
-    if (a.y_ > b.y_)
-    {
-        // mainly jumping
-        dy = (a.y_ - b.y_);
-        jCost = dy * COST_WALK_YUP;
-    }
-    else
-    {
-        // mainly falling
-        dy = (b.y_ - a.y_);
-        jCost = dy * COST_WALK_YDOWN;
-    }
-
-    return (dx > dy) ? (dx*COST_X + dy*COST_WALK_DXMID + jCost) : (dy*COST_WALK_YMID + dx*COST_WALK_DXMID + jCost);
-}
-
-// good behavior with jump and fall
-static inline short unsigned NghbDist_walker(const PathNode& a, const PathNode& b)
-{
-    int dx = a.x_ - b.x_;
-    unsigned area = b.map_->GetAreaProps(b.map_->GetTileIndex(b.x_, b.y_), b.v_, 3);
-
-    // jump
-    if (a.y_ > b.y_)
-    {
-        if (area & (jumpableFlag | walkableFlag))
-        {
-            if (dx != 0)
-                return COST_WALK_XYUP;
-            else
-                return COST_WALK_YUP;
-        }
-
-        return COST_NOWAY;
-    }
-
-    // fall
-    if (a.y_ < b.y_)
-    {
-        if (dx != 0)
-            return COST_WALK_XYDOWN;
-        else
-            return COST_WALK_YDOWN;
-    }
-
-    // horizontal move
-    if (area & jumpableFlag)
-        return COST_WALK_YMID;
-
-    if (area & walkableFlag)
-        return COST_X;
-
-    return COST_NOWAY;
-}
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <Urho3D/Math/Vector2.h>
+
+#include "PathSearch.h"
+#include "PathHierarchy.h"
+
+using namespace Urho3D;
+
+
+/// Flow field (Dijkstra map) : the costs to a target tile from all the tiles of the maps around the target, for a move type.
+/// The field is a reverse search from the target : the parent of a tile is the next tile of its path to the target,
+/// so all the agents chasing the same target share one search instead of one path each.
+/// When the target moves to another tile, the new field is computed by steps in a back search,
+/// the agents follow the previous field until the new one is complete.
+
+// maps around the map of the target
+const int PATHFLOWFIELD_RADIUS = 1;
+// nodes expanded by Update
+const unsigned PATHFLOWFIELD_STEPNODES = 4096;
+
+/// Navigation in the window of maps centered on the map of the target, reversed : the costs are the costs to move from the neighbor.
+/// The slots are the maps of the window.
+template <class World>
+class PathFlowFieldNav
+{
+public:
+    PathFlowFieldNav(const World& world) :
+        world_(world), movetype_(0), width_(0), height_(0), size_(0), mx0_(0), my0_(0), x0_(0), y1_(0) { }
+
+    void Set(int movetype, int mx, int my, int radius)
+    {
+        movetype_ = movetype;
+        width_ = world_.GetMapWidth();
+        height_ = world_.GetMapHeight();
+        size_ = 2 * radius + 1;
+        mx0_ = mx - radius;
+        my0_ = my - radius;
+        x0_ = mx0_ * width_;
+        y1_ = (1 - my0_) * height_;
+    }
+
+    bool IsInside(int x, int y) const
+    {
+        return size_ && x >= x0_ && x < x0_ + size_ * width_ && y < y1_ && y >= y1_ - size_ * height_;
+    }
+    unsigned GetKey(int x, int y) const
+    {
+        const int mx = GetPathClusterCoord(x, width_);
+        const int my = -GetPathClusterCoord(y, height_);
+        return GetPathSearchKey((my - my0_) * size_ + mx - mx0_, (y + my * height_) * width_ + x - mx * width_);
+    }
+    int GetX(unsigned key) const
+    {
+        return (mx0_ + (int)GetPathSearchSlot(key) % size_) * width_ + GetPathSearchTile(key) % width_;
+    }
+    int GetY(unsigned key) const
+    {
+        return (int)(GetPathSearchTile(key) / width_) - (my0_ + (int)GetPathSearchSlot(key) / size_) * height_;
+    }
+
+    /// PathSearch navigation
+    unsigned GetNumSlots() const
+    {
+        return size_ * size_;
+    }
+    unsigned GetNumTiles() const
+    {
+        return width_ * height_;
+    }
+    unsigned GetNeighbors(unsigned key, unsigned* keys) const
+    {
+        const int tile = GetPathSearchTile(key);
+        const int tx = tile % width_;
+        const int ty = tile / width_;
+        const int bx = GetX(key);
+        const int by = GetY(key);
+        // inside the map : the neighbors are in the same slot
+        const bool inner = tx > 0 && tx < width_ - 1 && ty > 0 && ty < height_ - 1;
+        unsigned numneighbors = 0;
+        for (int dy = -1; dy <= 1; dy++)
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                if ((dx || dy) && (inner || IsInside(bx + dx, by + dy)) && world_.IsPassable(movetype_, bx + dx, by + dy))
+                    keys[numneighbors++] = inner ? key + dy * width_ + dx : GetKey(bx + dx, by + dy);
+            }
+        return numneighbors;
+    }
+    unsigned GetCost(unsigned from, unsigned to) const
+    {
+        return world_.GetCost(movetype_, GetX(to), GetY(to), GetX(from), GetY(from));
+    }
+    unsigned GetHeuristic(unsigned key) const
+    {
+        return 0;
+    }
+    bool IsTimeOut(unsigned numExpanded) const
+    {
+        return false;
+    }
+
+private:
+    const World& world_;
+    int movetype_;
+    int width_, height_;
+    int size_;
+    int mx0_, my0_;
+    // the world tiles of the window : x0_ <= x < x0_ + size_ * width_, y1_ - size_ * height_ <= y < y1_
+    int x0_, y1_;
+};
+
+/// PathFlowField : World is the world of PathHierarchy (see PathHierarchy.h)
+template <class World>
+class PathFlowField
+{
+public:
+    PathFlowField(const World& world, int movetype, unsigned maxcost=0, int radius=PATHFLOWFIELD_RADIUS) :
+        world_(world), movetype_(movetype), maxCost_(maxcost), radius_(radius), front_(0), ready_(false), computing_(false), numComputed_(0)
+    {
+        layers_[0] = new Layer(world);
+        layers_[1] = new Layer(world);
+    }
+    ~PathFlowField()
+    {
+        delete layers_[0];
+        delete layers_[1];
+    }
+
+    /// Start a new field if the target has changed of tile
+    void SetTarget(int x, int y)
+    {
+        const IntVector2 target(x, y);
+        if (computing_ ? layers_[1-front_]->target_ == target : ready_ && layers_[front_]->target_ == target)
+            return;
+
+        Start(target);
+    }
+    /// A tile has changed : restart the field if the tile is in its maps
+    void MarkTileChanged(int x, int y)
+    {
+        if (computing_)
+        {
+            if (layers_[1-front_]->nav_.IsInside(x, y))
+                Start(layers_[1-front_]->target_);
+        }
+        else if (ready_ && layers_[front_]->nav_.IsInside(x, y))
+        {
+            Start(layers_[front_]->target_);
+        }
+    }
+    /// Continue the back field, return true if the front field has changed
+    bool Update(unsigned maxexpanded=PATHFLOWFIELD_STEPNODES)
+    {
+        if (!computing_)
+            return false;
+
+        Layer& back = *layers_[1-front_];
+        if (back.search_.Continue(back.nav_, maxexpanded) == PSS_Running)
+            return false;
+
+        front_ = 1 - front_;
+        computing_ = false;
+        ready_ = true;
+        numComputed_++;
+        return true;
+    }
+
+    /// Cost from the tile to the target, PATHSEARCH_NOWAY if not reached
+    unsigned GetDistance(int x, int y) const
+    {
+        const Layer& front = *layers_[front_];
+        if (!ready_ || !front.nav_.IsInside(x, y))
+            return PATHSEARCH_NOWAY;
+
+        const unsigned key = front.nav_.GetKey(x, y);
+        return front.search_.IsReached(key) ? front.search_.GetCost(key) : PATHSEARCH_NOWAY;
+    }
+    /// The next tile to the target, false if the tile isn't reached or is the target
+    bool GetNextTile(int x, int y, IntVector2& next) const
+    {
+        const Layer& front = *layers_[front_];
+        if (!ready_ || !front.nav_.IsInside(x, y))
+            return false;
+
+        const unsigned key = front.nav_.GetKey(x, y);
+        if (!front.search_.IsReached(key))
+            return false;
+
+        const unsigned parent = front.search_.GetParent(key);
+        if (parent == PATHSEARCH_NONE)
+            return false;
+
+        next.x_ = front.nav_.GetX(parent);
+        next.y_ = front.nav_.GetY(parent);
+        return true;
+    }
+
+    bool IsReady() const
+    {
+        return ready_;
+    }
+    bool IsComputing() const
+    {
+        return computing_;
+    }
+    /// Target of the front field
+    const IntVector2& GetTarget() const
+    {
+        return layers_[front_]->target_;
+    }
+    int GetMoveType() const
+    {
+        return movetype_;
+    }
+    unsigned GetNumExpanded() const
+    {
+        return layers_[front_]->search_.GetNumExpanded();
+    }
+    unsigned GetNumComputed() const
+    {
+        return numComputed_;
+    }
+
+private:
+    struct Layer
+    {
+        Layer(const World& world) : nav_(world) { }
+
+        IntVector2 target_;
+        PathFlowFieldNav<World> nav_;
+        PathSearch<PathFlowFieldNav<World> > search_;
+    };
+
+    void Start(const IntVector2& target)
+    {
+        Layer& back = *layers_[1-front_];
+        back.target_ = target;
+        back.nav_.Set(movetype_, GetPathClusterCoord(target.x_, world_.GetMapWidth()), -GetPathClusterCoord(target.y_, world_.GetMapHeight()), radius_);
+        back.search_.Begin(back.nav_, back.nav_.GetKey(target.x_, target.y_), PATHSEARCH_NONE, maxCost_);
+        computing_ = true;
+    }
+
+    const World& world_;
+    int movetype_;
+    unsigned maxCost_;
+    int radius_;
+
+    // the front layer is used by the agents, the back layer is computed
+    Layer* layers_[2];
+    int front_;
+    bool ready_;
+    bool computing_;
+    unsigned numComputed_;
+};
@@ -0,0 +1,668 @@
+#pragma once
+
+#include <Urho3D/Container/HashMap.h>
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Math/Vector2.h>
+
+#include "PathSearch.h"
+
+using namespace Urho3D;
+
+
+/// Hierarchical path search (HPA*) : the maps are the clusters of an abstract graph.
+/// The portals are the middles of the open runs along the borders of a map, linked to the portal of the neighbor map.
+/// The distances between the portals of a map are precomputed for each move type.
+/// A search links the start and the goal to the portals of their maps, searches the abstract graph,
+/// then each segment of the abstract path is refined into tiles on demand.
+
+enum PathMoveType
+{
+    PMT_Walker = 0,
+    PMT_Flyer,
+    PMT_Swimmer,
+    PMT_NumMoveTypes
+};
+
+const unsigned PATHHIERARCHY_MAXPORTALS = 62;
+// the start and the goal of a search are the two last nodes of their clusters
+const unsigned PATHHIERARCHY_START = PATHHIERARCHY_MAXPORTALS;
+const unsigned PATHHIERARCHY_GOAL = PATHHIERARCHY_MAXPORTALS + 1;
+const unsigned PATHHIERARCHY_NUMNODES = PATHHIERARCHY_MAXPORTALS + 2;
+// a tile change dirties the neighbor maps in this margin (the area props of a tile depend on the tiles below it)
+const int PATHHIERARCHY_EDITMARGIN = 4;
+
+inline int GetPathClusterCoord(int w, int size)
+{
+    return w >= 0 ? w / size : -((size - 1 - w) / size);
+}
+
+inline unsigned GetPathClusterKey(int mx, int my)
+{
+    return ((unsigned)(mx & 0xFFFF) << 16) | (unsigned)(my & 0xFFFF);
+}
+
+/// Portal : a tile on the border of a map and the tile across the border
+struct PathPortal
+{
+    bool operator == (const PathPortal& rhs) const
+    {
+        return x_ == rhs.x_ && y_ == rhs.y_ && nx_ == rhs.nx_ && ny_ == rhs.ny_;
+    }
+
+    int x_, y_;
+    int nx_, ny_;
+};
+
+struct PathCluster
+{
+    PathCluster() : mx_(0), my_(0), stamp_(0), dirty_(false) { }
+
+    int mx_, my_;
+    const void* stamp_;
+    bool dirty_;
+
+    PODVector<PathPortal> portals_[PMT_NumMoveTypes];
+    // numportals x numportals, distance from the portal row to the portal column, PATHSEARCH_NOWAY if unreachable
+    PODVector<unsigned> distances_[PMT_NumMoveTypes];
+};
+
+template <class World> class PathHierarchy;
+
+/// Navigation in the tiles of one map, for the portal distances and the refinement.
+/// The reverse navigation gives the distances to a tile (the walker costs aren't symmetric).
+template <class World>
+class PathClusterNav
+{
+public:
+    PathClusterNav(const World& world, int movetype, int mx, int my, bool reverse) :
+        world_(world), movetype_(movetype), reverse_(reverse), hasGoal_(false), goalx_(0), goaly_(0)
+    {
+        width_ = world.GetMapWidth();
+        height_ = world.GetMapHeight();
+        x0_ = mx * width_;
+        y0_ = -my * height_;
+    }
+
+    void SetGoal(int x, int y)
+    {
+        hasGoal_ = true;
+        goalx_ = x;
+        goaly_ = y;
+    }
+
+    bool IsInside(int x, int y) const
+    {
+        return x >= x0_ && x < x0_ + width_ && y >= y0_ && y < y0_ + height_;
+    }
+    unsigned GetKey(int x, int y) const
+    {
+        return GetPathSearchKey(0, (y - y0_) * width_ + x - x0_);
+    }
+    int GetX(unsigned key) const
+    {
+        return x0_ + GetPathSearchTile(key) % width_;
+    }
+    int GetY(unsigned key) const
+    {
+        return y0_ + GetPathSearchTile(key) / width_;
+    }
+
+    /// PathSearch navigation
+    unsigned GetNumSlots() const
+    {
+        return 1;
+    }
+    unsigned GetNumTiles() const
+    {
+        return width_ * height_;
+    }
+    unsigned GetNeighbors(unsigned key, unsigned* keys) const
+    {
+        const int ax = GetX(key);
+        const int ay = GetY(key);
+        unsigned numneighbors = 0;
+        for (int dy = -1; dy <= 1; dy++)
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                if ((dx || dy) && IsInside(ax + dx, ay + dy) && world_.IsPassable(movetype_, ax + dx, ay + dy))
+                    keys[numneighbors++] = GetKey(ax + dx, ay + dy);
+            }
+        return numneighbors;
+    }
+    unsigned GetCost(unsigned from, unsigned to) const
+    {
+        return reverse_ ? world_.GetCost(movetype_, GetX(to), GetY(to), GetX(from), GetY(from))
+               : world_.GetCost(movetype_, GetX(from), GetY(from), GetX(to), GetY(to));
+    }
+    unsigned GetHeuristic(unsigned key) const
+    {
+        return hasGoal_ ? world_.GetHeuristic(movetype_, GetX(key), GetY(key), goalx_, goaly_) : 0;
+    }
+    bool IsTimeOut(unsigned numExpanded) const
+    {
+        return false;
+    }
+
+private:
+    const World& world_;
+    int movetype_;
+    bool reverse_;
+    bool hasGoal_;
+    int goalx_, goaly_;
+    int width_, height_;
+    int x0_, y0_;
+};
+
+/// Navigation in the abstract graph : the node keys are the slots of the clusters and the portal indexes (or the start and the goal)
+template <class World>
+class PathAbstractNav
+{
+public:
+    PathAbstractNav(PathHierarchy<World>& hierarchy, int movetype) :
+        hierarchy_(hierarchy), movetype_(movetype), startCluster_(0), goalCluster_(0), startToGoal_(PATHSEARCH_NOWAY) { }
+
+    unsigned GetSlot(PathCluster* cluster)
+    {
+        unsigned slot = 0;
+        while (slot < clusters_.Size() && clusters_[slot] != cluster)
+            slot++;
+        if (slot == clusters_.Size())
+            clusters_.Push(cluster);
+        return slot;
+    }
+    PathCluster* GetCluster(unsigned key) const
+    {
+        return clusters_[GetPathSearchSlot(key)];
+    }
+    IntVector2 GetTile(unsigned key) const
+    {
+        const unsigned index = GetPathSearchTile(key);
+        if (index == PATHHIERARCHY_START)
+            return start_;
+        if (index == PATHHIERARCHY_GOAL)
+            return goal_;
+        const PathPortal& portal = GetCluster(key)->portals_[movetype_][index];
+        return IntVector2(portal.x_, portal.y_);
+    }
+
+    /// PathSearch navigation
+    unsigned GetNumSlots() const
+    {
+        return clusters_.Size();
+    }
+    unsigned GetNumTiles() const
+    {
+        return PATHHIERARCHY_NUMNODES;
+    }
+    unsigned GetNeighbors(unsigned key, unsigned* keys)
+    {
+        PathCluster* cluster = GetCluster(key);
+        const unsigned slot = GetPathSearchSlot(key);
+        const unsigned index = GetPathSearchTile(key);
+        const PODVector<PathPortal>& portals = cluster->portals_[movetype_];
+        const unsigned numportals = portals.Size();
+        unsigned numneighbors = 0;
+
+        if (index == PATHHIERARCHY_GOAL)
+            return 0;
+
+        if (index == PATHHIERARCHY_START)
+        {
+            for (unsigned j = 0; j < numportals && j < startDistances_.Size(); j++)
+                if (startDistances_[j] < PATHSEARCH_NOWAY)
+                    keys[numneighbors++] = GetPathSearchKey(slot, j);
+            if (startToGoal_ < PATHSEARCH_NOWAY)
+                keys[numneighbors++] = GetPathSearchKey(GetSlot(goalCluster_), PATHHIERARCHY_GOAL);
+            return numneighbors;
+        }
+
+        if (index >= numportals)
+            return 0;
+
+        const unsigned* distances = &cluster->distances_[movetype_][index * numportals];
+        for (unsigned j = 0; j < numportals; j++)
+            if (j != index && distances[j] < PATHSEARCH_NOWAY)
+                keys[numneighbors++] = GetPathSearchKey(slot, j);
+
+        if (cluster == goalCluster_ && index < goalDistances_.Size() && goalDistances_[index] < PATHSEARCH_NOWAY)
+            keys[numneighbors++] = GetPathSearchKey(slot, PATHHIERARCHY_GOAL);
+
+        // the portal across the border (copied : getting the neighbor may build it and update the border portals of this cluster)
+        const PathPortal portal = portals[index];
+        PathCluster* neighbor = hierarchy_.GetClusterAt(portal.nx_, portal.ny_);
+        if (neighbor)
+        {
+            const PODVector<PathPortal>& nportals = neighbor->portals_[movetype_];
+            for (unsigned j = 0; j < nportals.Size(); j++)
+            {
+                if (nportals[j].x_ == portal.nx_ && nportals[j].y_ == portal.ny_ && nportals[j].nx_ == portal.x_ && nportals[j].ny_ == portal.y_)
+                {
+                    keys[numneighbors++] = GetPathSearchKey(GetSlot(neighbor), j);
+                    break;
+                }
+            }
+        }
+
+        return numneighbors;
+    }
+    unsigned GetCost(unsigned from, unsigned to) const
+    {
+        const unsigned i = GetPathSearchTile(from);
+        const unsigned j = GetPathSearchTile(to);
+
+        if (i == PATHHIERARCHY_START)
+            return j == PATHHIERARCHY_GOAL ? startToGoal_ : startDistances_[j];
+        if (j == PATHHIERARCHY_GOAL)
+            return i < goalDistances_.Size() ? goalDistances_[i] : PATHSEARCH_NOWAY;
+
+        if (GetPathSearchSlot(from) == GetPathSearchSlot(to))
+        {
+            const PathCluster* cluster = GetCluster(from);
+            return cluster->distances_[movetype_][i * cluster->portals_[movetype_].Size() + j];
+        }
+
+        const IntVector2 a = GetTile(from);
+        const IntVector2 b = GetTile(to);
+        return hierarchy_.GetWorld().GetCost(movetype_, a.x_, a.y_, b.x_, b.y_);
+    }
+    unsigned GetHeuristic(unsigned key) const
+    {
+        const IntVector2 a = GetTile(key);
+        return hierarchy_.GetWorld().GetHeuristic(movetype_, a.x_, a.y_, goal_.x_, goal_.y_);
+    }
+    bool IsTimeOut(unsigned numExpanded) const
+    {
+        return false;
+    }
+
+    PathHierarchy<World>& hierarchy_;
+    int movetype_;
+    PODVector<PathCluster*> clusters_;
+
+    // the links of the start and the goal to the portals of their maps
+    PathCluster* startCluster_;
+    PathCluster* goalCluster_;
+    IntVector2 start_, goal_;
+    PODVector<unsigned> startDistances_;
+    PODVector<unsigned> goalDistances_;
+    unsigned startToGoal_;
+};
+
+/// PathHierarchy : the abstract graphs of the maps given by World.
+/// World gives the maps and the tiles in world tile coordinates (x = mx * mapwidth + tilex, y = tiley - my * mapheight) :
+///     int GetMapWidth() const, int GetMapHeight() const
+///     const void* GetMapStamp(int mx, int my) const                                  the identity of the map at a map point, 0 if no map
+///     bool IsPassable(int movetype, int x, int y) const
+///     unsigned GetCost(int movetype, int ax, int ay, int bx, int by) const           cost to move to a neighbor tile, PATHSEARCH_NOWAY if not possible
+///     unsigned GetHeuristic(int movetype, int ax, int ay, int bx, int by) const
+/// The clusters are built the first time a search reaches their map, and rebuilt at the next Update after a tile change.
+template <class World>
+class PathHierarchy
+{
+public:
+    PathHierarchy(const World& world) :
+        world_(world), numBuilds_(0) { }
+    ~PathHierarchy()
+    {
+        Clear();
+    }
+
+    void Clear()
+    {
+        for (typename HashMap<unsigned, PathCluster*>::Iterator it = clusters_.Begin(); it != clusters_.End(); ++it)
+            delete it->second_;
+        clusters_.Clear();
+        dirtyClusters_.Clear();
+    }
+
+    /// Mark the maps impacted by a tile change
+    void MarkTileChanged(int x, int y)
+    {
+        const int width = world_.GetMapWidth();
+        const int height = world_.GetMapHeight();
+        const int mx0 = GetPathClusterCoord(x - PATHHIERARCHY_EDITMARGIN, width);
+        const int mx1 = GetPathClusterCoord(x + PATHHIERARCHY_EDITMARGIN, width);
+        const int my0 = -GetPathClusterCoord(y + PATHHIERARCHY_EDITMARGIN, height);
+        const int my1 = -GetPathClusterCoord(y - PATHHIERARCHY_EDITMARGIN, height);
+        for (int my = my0; my <= my1; my++)
+            for (int mx = mx0; mx <= mx1; mx++)
+                MarkDirty(mx, my);
+    }
+    void MarkDirty(int mx, int my)
+    {
+        typename HashMap<unsigned, PathCluster*>::Iterator it = clusters_.Find(GetPathClusterKey(mx, my));
+        if (it != clusters_.End() && !it->second_->dirty_)
+        {
+            it->second_->dirty_ = true;
+            dirtyClusters_.Push(it->second_);
+        }
+    }
+
+    /// Rebuild the dirty maps. The portals of the neighbor maps are rebuilt too, and their distances if their portals have changed.
+    void Update()
+    {
+        for (unsigned i = 0; i < dirtyClusters_.Size(); i++)
+        {
+            PathCluster* cluster = dirtyClusters_[i];
+            if (!cluster->dirty_)
+                continue;
+            cluster->stamp_ = world_.GetMapStamp(cluster->mx_, cluster->my_);
+            Build(*cluster);
+        }
+        dirtyClusters_.Clear();
+    }
+
+    /// Search an abstract path, the start and the goal are world tiles
+    int FindPath(int movetype, const IntVector2& start, const IntVector2& goal, unsigned maxcost=0)
+    {
+        Update();
+
+        waypoints_.Clear();
+        moveType_ = movetype;
+
+        PathCluster* startcluster = GetClusterAt(start.x_, start.y_);
+        PathCluster* goalcluster = GetClusterAt(goal.x_, goal.y_);
+        if (!startcluster || !goalcluster || !world_.IsPassable(movetype, goal.x_, goal.y_))
+            return PSS_NotFound;
+
+        PathAbstractNav<World> nav(*this, movetype);
+        nav.start_ = start;
+        nav.goal_ = goal;
+        nav.startCluster_ = startcluster;
+        nav.goalCluster_ = goalcluster;
+
+        // link the start and the goal to the portals of their maps
+        const PODVector<PathPortal>& startportals = startcluster->portals_[movetype];
+        nav.startDistances_.Resize(startportals.Size());
+        {
+            PathClusterNav<World> localnav(world_, movetype, startcluster->mx_, startcluster->my_, false);
+            localSearch_.Search(localnav, localnav.GetKey(start.x_, start.y_), PATHSEARCH_NONE);
+            for (unsigned j = 0; j < startportals.Size(); j++)
+                nav.startDistances_[j] = GetLocalCost(localnav.GetKey(startportals[j].x_, startportals[j].y_));
+            if (startcluster == goalcluster)
+                nav.startToGoal_ = GetLocalCost(localnav.GetKey(goal.x_, goal.y_));
+        }
+        const PODVector<PathPortal>& goalportals = goalcluster->portals_[movetype];
+        nav.goalDistances_.Resize(goalportals.Size());
+        {
+            PathClusterNav<World> localnav(world_, movetype, goalcluster->mx_, goalcluster->my_, true);
+            localSearch_.Search(localnav, localnav.GetKey(goal.x_, goal.y_), PATHSEARCH_NONE);
+            for (unsigned j = 0; j < goalportals.Size(); j++)
+                nav.goalDistances_[j] = GetLocalCost(localnav.GetKey(goalportals[j].x_, goalportals[j].y_));
+        }
+
+        const unsigned startkey = GetPathSearchKey(nav.GetSlot(startcluster), PATHHIERARCHY_START);
+        const unsigned goalkey = GetPathSearchKey(nav.GetSlot(goalcluster), PATHHIERARCHY_GOAL);
+
+        const int status = abstractSearch_.Search(nav, startkey, goalkey, maxcost);
+        numExpanded_ = abstractSearch_.GetNumExpanded();
+        if (status != PSS_Found)
+            return status;
+
+        cost_ = abstractSearch_.GetCost(goalkey);
+        for (unsigned key = goalkey; key != PATHSEARCH_NONE; key = abstractSearch_.GetParent(key))
+            waypoints_.Push(nav.GetTile(key));
+        // from the start to the goal
+        Reverse(waypoints_, 0);
+
+        return PSS_Found;
+    }
+
+    /// The abstract path of the last search : the start, the portals and the goal
+    unsigned GetNumWaypoints() const
+    {
+        return waypoints_.Size();
+    }
+    const IntVector2& GetWaypoint(unsigned index) const
+    {
+        return waypoints_[index];
+    }
+    /// Cost of the abstract path of the last search
+    unsigned GetCost() const
+    {
+        return cost_;
+    }
+    unsigned GetNumExpanded() const
+    {
+        return numExpanded_;
+    }
+
+    /// Refine the segment from the waypoint index to the next waypoint : add the tiles after the waypoint until the next waypoint
+    bool RefineSegment(unsigned index, PODVector<IntVector2>& tiles)
+    {
+        if (index + 1 >= waypoints_.Size())
+            return false;
+
+        const IntVector2& a = waypoints_[index];
+        const IntVector2& b = waypoints_[index+1];
+
+        // the start or the goal on a portal
+        if (a == b)
+            return true;
+
+        // across a border
+        if (Abs(b.x_ - a.x_) <= 1 && Abs(b.y_ - a.y_) <= 1)
+        {
+            if (world_.GetCost(moveType_, a.x_, a.y_, b.x_, b.y_) >= PATHSEARCH_NOWAY)
+                return false;
+            tiles.Push(b);
+            return true;
+        }
+
+        // inside a map
+        const int mx = GetPathClusterCoord(a.x_, world_.GetMapWidth());
+        const int my = -GetPathClusterCoord(a.y_, world_.GetMapHeight());
+        PathClusterNav<World> localnav(world_, moveType_, mx, my, false);
+        if (!localnav.IsInside(b.x_, b.y_))
+            return false;
+
+        localnav.SetGoal(b.x_, b.y_);
+        const unsigned goalkey = localnav.GetKey(b.x_, b.y_);
+        if (localSearch_.Search(localnav, localnav.GetKey(a.x_, a.y_), goalkey) != PSS_Found)
+            return false;
+
+        const unsigned size = tiles.Size();
+        for (unsigned key = goalkey; localSearch_.GetParent(key) != PATHSEARCH_NONE; key = localSearch_.GetParent(key))
+            tiles.Push(IntVector2(localnav.GetX(key), localnav.GetY(key)));
+        Reverse(tiles, size);
+
+        return true;
+    }
+    /// Refine all the abstract path, begins with the start
+    bool RefinePath(PODVector<IntVector2>& tiles)
+    {
+        tiles.Clear();
+        if (!waypoints_.Size())
+            return false;
+
+        tiles.Push(waypoints_[0]);
+        for (unsigned i = 0; i + 1 < waypoints_.Size(); i++)
+            if (!RefineSegment(i, tiles))
+                return false;
+
+        return true;
+    }
+
+    /// The cluster of a world tile, built or rebuilt if its map has changed. 0 if no map.
+    PathCluster* GetClusterAt(int x, int y)
+    {
+        const int mx = GetPathClusterCoord(x, world_.GetMapWidth());
+        const int my = -GetPathClusterCoord(y, world_.GetMapHeight());
+        const void* stamp = world_.GetMapStamp(mx, my);
+        const unsigned key = GetPathClusterKey(mx, my);
+
+        typename HashMap<unsigned, PathCluster*>::Iterator it = clusters_.Find(key);
+        PathCluster* cluster = it != clusters_.End() ? it->second_ : 0;
+
+        if (cluster && cluster->stamp_ == stamp)
+            return stamp ? cluster : 0;
+
+        if (!cluster)
+        {
+            if (!stamp)
+                return 0;
+            cluster = new PathCluster();
+            cluster->mx_ = mx;
+            cluster->my_ = my;
+            clusters_[key] = cluster;
+        }
+
+        // new map or map changed : Build updates the border portals of the neighbors too
+        cluster->stamp_ = stamp;
+        cluster->dirty_ = false;
+        if (stamp)
+            Build(*cluster);
+
+        return stamp ? cluster : 0;
+    }
+
+    const World& GetWorld() const
+    {
+        return world_;
+    }
+    unsigned GetNumClusters() const
+    {
+        return clusters_.Size();
+    }
+    /// Number of clusters (re)built, with the distances computed
+    unsigned GetNumBuilds() const
+    {
+        return numBuilds_;
+    }
+
+private:
+    static void Reverse(PODVector<IntVector2>& tiles, unsigned start)
+    {
+        for (unsigned i = start, j = tiles.Size() - 1; i < j; i++, j--)
+        {
+            const IntVector2 tile = tiles[i];
+            tiles[i] = tiles[j];
+            tiles[j] = tile;
+        }
+    }
+
+    unsigned GetLocalCost(unsigned key) const
+    {
+        return localSearch_.IsReached(key) ? localSearch_.GetCost(key) : PATHSEARCH_NOWAY;
+    }
+
+    void Build(PathCluster& cluster)
+    {
+        cluster.dirty_ = false;
+        numBuilds_++;
+
+        for (int movetype = 0; movetype < PMT_NumMoveTypes; movetype++)
+        {
+            BuildPortals(cluster, movetype, cluster.portals_[movetype]);
+            BuildDistances(cluster, movetype);
+        }
+
+        // the neighbors share the borders
+        const int nmx[4] = { cluster.mx_-1, cluster.mx_+1, cluster.mx_, cluster.mx_ };
+        const int nmy[4] = { cluster.my_, cluster.my_, cluster.my_-1, cluster.my_+1 };
+        PODVector<PathPortal> portals;
+        for (unsigned i = 0; i < 4; i++)
+        {
+            typename HashMap<unsigned, PathCluster*>::Iterator it = clusters_.Find(GetPathClusterKey(nmx[i], nmy[i]));
+            if (it == clusters_.End() || !it->second_->stamp_ || it->second_->dirty_)
+                continue;
+
+            PathCluster& neighbor = *it->second_;
+            for (int movetype = 0; movetype < PMT_NumMoveTypes; movetype++)
+            {
+                BuildPortals(neighbor, movetype, portals);
+                if (portals != neighbor.portals_[movetype])
+                {
+                    neighbor.portals_[movetype] = portals;
+                    BuildDistances(neighbor, movetype);
+                }
+            }
+        }
+    }
+
+    void BuildPortals(const PathCluster& cluster, int movetype, PODVector<PathPortal>& portals) const
+    {
+        const int width = world_.GetMapWidth();
+        const int height = world_.GetMapHeight();
+        const int x0 = cluster.mx_ * width;
+        const int y0 = -cluster.my_ * height;
+
+        portals.Clear();
+
+        // left, right, top, bottom borders : the inside tile, the outside tile and the step along the border
+        const int ax[4] = { x0, x0 + width - 1, x0, x0 };
+        const int ay[4] = { y0, y0, y0, y0 + height - 1 };
+        const int ox[4] = { -1, 1, 0, 0 };
+        const int oy[4] = { 0, 0, -1, 1 };
+        const int length[4] = { height, height, width, width };
+
+        for (int side = 0; side < 4; side++)
+        {
+            const int sx = oy[side] ? 1 : 0;
+            const int sy = ox[side] ? 1 : 0;
+            int runstart = -1;
+            for (int t = 0; t <= length[side]; t++)
+            {
+                bool open = false;
+                if (t < length[side])
+                {
+                    const int x = ax[side] + t * sx;
+                    const int y = ay[side] + t * sy;
+                    const int nx = x + ox[side];
+                    const int ny = y + oy[side];
+                    open = world_.IsPassable(movetype, x, y) && world_.IsPassable(movetype, nx, ny) &&
+                           (world_.GetCost(movetype, x, y, nx, ny) < PATHSEARCH_NOWAY || world_.GetCost(movetype, nx, ny, x, y) < PATHSEARCH_NOWAY);
+                }
+
+                if (open && runstart == -1)
+                    runstart = t;
+                else if (!open && runstart != -1)
+                {
+                    // the portal at the middle of the run
+                    if (portals.Size() < PATHHIERARCHY_MAXPORTALS)
+                    {
+                        const int m = (runstart + t - 1) / 2;
+                        PathPortal portal;
+                        portal.x_ = ax[side] + m * sx;
+                        portal.y_ = ay[side] + m * sy;
+                        portal.nx_ = portal.x_ + ox[side];
+                        portal.ny_ = portal.y_ + oy[side];
+                        portals.Push(portal);
+                    }
+                    runstart = -1;
+                }
+            }
+        }
+    }
+
+    void BuildDistances(PathCluster& cluster, int movetype)
+    {
+        const PODVector<PathPortal>& portals = cluster.portals_[movetype];
+        PODVector<unsigned>& distances = cluster.distances_[movetype];
+        const unsigned numportals = portals.Size();
+        distances.Resize(numportals * numportals);
+
+        PathClusterNav<World> localnav(world_, movetype, cluster.mx_, cluster.my_, false);
+        for (unsigned i = 0; i < numportals; i++)
+        {
+            localSearch_.Search(localnav, localnav.GetKey(portals[i].x_, portals[i].y_), PATHSEARCH_NONE);
+            for (unsigned j = 0; j < numportals; j++)
+                distances[i * numportals + j] = GetLocalCost(localnav.GetKey(portals[j].x_, portals[j].y_));
+        }
+    }
+
+    const World& world_;
+
+    HashMap<unsigned, PathCluster*> clusters_;
+    PODVector<PathCluster*> dirtyClusters_;
+    unsigned numBuilds_;
+
+    PathSearch<PathClusterNav<World> > localSearch_;
+    PathSearch<PathAbstractNav<World>, PATHHIERARCHY_NUMNODES> abstractSearch_;
+
+    // last search
+    int moveType_;
+    unsigned cost_;
+    unsigned numExpanded_;
+    PODVector<IntVector2> waypoints_;
+};
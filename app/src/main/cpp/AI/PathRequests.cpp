@@ -0,0 +1,633 @@
+#include <Urho3D/Urho3D.h>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Core/Profiler.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/IO/Log.h>
+
+#include "GameContext.h"
+#include "GameEvents.h"
+
+#include "MapWorld.h"
+
+#include "PathFinder2D.h"
+
+#include "PathRequests.h"
+
+#define MAX_SEARCHCOSTFACTOR 5 // if cost > MAX_SEARCHCOSTFACTOR x heuristic => stop
+
+
+/// Navigation Snapshot
+
+PathNavSnapshot::~PathNavSnapshot()
+{
+    Clear();
+}
+
+void PathNavSnapshot::Set(short unsigned width, short unsigned height, int v)
+{
+    Clear();
+
+    width_ = width;
+    height_ = height;
+    v_ = v;
+}
+
+void PathNavSnapshot::Clear()
+{
+    for (HashMap<unsigned, PathSnapshotMap*>::Iterator it = mapsByKey_.Begin(); it != mapsByKey_.End(); ++it)
+        delete it->second_;
+    mapsByKey_.Clear();
+}
+
+void PathNavSnapshot::CaptureMaps(int mx0, int my0, int mx1, int my1)
+{
+    for (int my = my0; my <= my1; my++)
+    {
+        for (int mx = mx0; mx <= mx1; mx++)
+        {
+            const unsigned key = GetPathClusterKey(mx, my);
+            if (mapsByKey_.Find(key) != mapsByKey_.End())
+                continue;
+
+            PathSnapshotMap* map = new PathSnapshotMap();
+            map->mx_ = mx;
+            map->my_ = my;
+            map->map_ = 0;
+            map->available_ = false;
+            // captured at the next Update
+            map->dirty_ = true;
+            mapsByKey_[key] = map;
+        }
+    }
+}
+
+void PathNavSnapshot::MarkTileChanged(int x, int y)
+{
+    if (!width_)
+        return;
+
+    const int mx0 = GetPathClusterCoord(x - PATHHIERARCHY_EDITMARGIN, width_);
+    const int mx1 = GetPathClusterCoord(x + PATHHIERARCHY_EDITMARGIN, width_);
+    const int my0 = -GetPathClusterCoord(y + PATHHIERARCHY_EDITMARGIN, height_);
+    const int my1 = -GetPathClusterCoord(y - PATHHIERARCHY_EDITMARGIN, height_);
+    for (int my = my0; my <= my1; my++)
+    {
+        for (int mx = mx0; mx <= mx1; mx++)
+        {
+            HashMap<unsigned, PathSnapshotMap*>::Iterator it = mapsByKey_.Find(GetPathClusterKey(mx, my));
+            if (it != mapsByKey_.End())
+                it->second_->dirty_ = true;
+        }
+    }
+}
+
+unsigned PathNavSnapshot::Update(PODVector<PathSnapshotMap*>& updatedMaps)
+{
+    updatedMaps.Clear();
+
+    for (HashMap<unsigned, PathSnapshotMap*>::Iterator it = mapsByKey_.Begin(); it != mapsByKey_.End(); ++it)
+    {
+        PathSnapshotMap& map = *it->second_;
+        if (!map.dirty_ && World2D::GetAvailableMapAt(ShortIntVector2(map.mx_, map.my_)) == map.map_)
+            continue;
+        Capture(map);
+        updatedMaps.Push(&map);
+    }
+
+    return updatedMaps.Size();
+}
+
+void PathNavSnapshot::Capture(PathSnapshotMap& map)
+{
+    Map* m = World2D::GetAvailableMapAt(ShortIntVector2(map.mx_, map.my_));
+
+    map.map_ = m;
+    map.available_ = m != 0;
+    map.dirty_ = false;
+
+    if (!m)
+        return;
+
+    const unsigned size = width_ * height_;
+    map.areaProps_.Resize(size);
+    for (unsigned i = 0; i < size; i++)
+        map.areaProps_[i] = (unsigned char)m->GetAreaProps(i, v_, 3);
+}
+
+bool PathNavSnapshot::IsPassable(int movetype, int x, int y) const
+{
+    return (GetAreaProps(x, y) & GetPathMoveAreaFlags(movetype)) != 0;
+}
+
+unsigned PathNavSnapshot::GetCost(int movetype, int ax, int ay, int bx, int by) const
+{
+    if (movetype != PMT_Walker)
+        return NghbDist_fly(ax, ay, bx, by);
+
+    return NghbDist_walker(ax, ay, bx, by, GetAreaProps(bx, by));
+}
+
+unsigned PathNavSnapshot::GetHeuristic(int movetype, int ax, int ay, int bx, int by) const
+{
+    return movetype == PMT_Walker ? Heuristic_walker(ax, ay, bx, by) : Heuristic_fly(ax, ay, bx, by);
+}
+
+
+/// Snapshot Navigation
+
+void PathSnapshotNav::Set(const PathNavSnapshot* snapshot, int movetype, int goalx, int goaly)
+{
+    snapshot_ = snapshot;
+    movetype_ = movetype;
+    goalx_ = goalx;
+    goaly_ = goaly;
+
+    maps_.Clear();
+}
+
+unsigned PathSnapshotNav::GetKey(int x, int y)
+{
+    const PathSnapshotMap* map = snapshot_->GetMapAt(x, y);
+
+    unsigned slot = 0;
+    while (slot < maps_.Size() && maps_[slot] != map)
+        slot++;
+
+    if (slot == maps_.Size())
+        maps_.Push(map);
+
+    const int width = snapshot_->GetMapWidth();
+    return GetPathSearchKey(slot, (y + map->my_ * snapshot_->GetMapHeight()) * width + x - map->mx_ * width);
+}
+
+unsigned PathSnapshotNav::GetNeighbors(unsigned key, unsigned* keys)
+{
+    const int ax = GetX(key);
+    const int ay = GetY(key);
+
+    unsigned numneighbors = 0;
+
+    for (int imoore=0; imoore<8; imoore++)
+    {
+        const int x = ax + MapInfo::neighborOffX[imoore];
+        const int y = ay + MapInfo::neighborOffY[imoore];
+
+        if (snapshot_->IsPassable(movetype_, x, y))
+            keys[numneighbors++] = GetKey(x, y);
+    }
+
+    return numneighbors;
+}
+
+
+/// Path Request Queue
+
+static void PathRequestThread(const WorkItem* item, unsigned threadIndex)
+{
+    PathRequest& request = *static_cast<PathRequest*>(item->aux_);
+
+    PathRequestQueue::Solve(request, *request.owner_->GetSolver(threadIndex), request.owner_->GetSnapshot());
+
+    request.finished_.store(true, std::memory_order_release);
+}
+
+PathRequestQueue::PathRequestQueue(Context* context, PathFinder2D* pathfinder) :
+    Object(context),
+    pathfinder_(pathfinder),
+    nextId_(0),
+    batchSerial_(0)
+{
+    SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(PathRequestQueue, HandleUpdate));
+
+    if (GameContext::Get().gameWorkQueue_)
+        SubscribeToEvent(GameContext::Get().gameWorkQueue_, E_WORKITEMCOMPLETED, URHO3D_HANDLER(PathRequestQueue, HandleWorkItemComplete));
+}
+
+PathRequestQueue::~PathRequestQueue()
+{
+    Clear();
+
+    for (unsigned i = 0; i < freeRequests_.Size(); i++)
+        delete freeRequests_[i];
+    freeRequests_.Clear();
+
+    for (unsigned i = 0; i < solvers_.Size(); i++)
+        delete solvers_[i];
+    solvers_.Clear();
+}
+
+void PathRequestQueue::Set(short unsigned width, short unsigned height, int v)
+{
+    Clear();
+
+    snapshot_.Set(width, height, v);
+}
+
+void PathRequestQueue::Clear()
+{
+    // the workers must end the running batch before the snapshot changes
+    if (running_.Size())
+    {
+        // take back the requests not yet taken by the workers : the other items of the queue are not run by this wait
+        WorkQueue* queue = GameContext::Get().gameWorkQueue_;
+        for (unsigned i = 0; i < running_.Size(); i++)
+        {
+            PathRequest* request = running_[i];
+            if (queue && request->item_ && request->item_->aux_ == request && queue->RemoveWorkItem(request->item_))
+                request->finished_.store(true, std::memory_order_relaxed);
+        }
+
+        // only the requests in progress in the workers remain
+        for (unsigned i = 0; i < running_.Size(); i++)
+        {
+            while (!running_[i]->finished_.load(std::memory_order_acquire))
+                Time::Sleep(0);
+            running_[i]->item_.Reset();
+        }
+    }
+
+    // the completions of the cancelled batch are dropped
+    batchSerial_++;
+
+    for (unsigned i = 0; i < running_.Size(); i++)
+        freeRequests_.Push(running_[i]);
+    running_.Clear();
+
+    for (List<PathRequest*>::Iterator it = queued_.Begin(); it != queued_.End(); ++it)
+        freeRequests_.Push(*it);
+    queued_.Clear();
+
+    hits_.Clear();
+    cache_.Clear();
+
+    for (unsigned i = 0; i < solvers_.Size(); i++)
+        solvers_[i]->hierarchy_.Clear();
+
+    snapshot_.Clear();
+}
+
+unsigned PathRequestQueue::Request(const IntVector2& start, const IntVector2& goal, int movetype, Node* requester, int priority)
+{
+    if (!requester || start == goal)
+        return 0;
+
+    metrics_.numRequests_++;
+
+    if (!++nextId_)
+        nextId_ = 1;
+
+    PathRequester pathRequester;
+    pathRequester.node_ = requester;
+    pathRequester.id_ = nextId_;
+
+    PathRequestKey key;
+    key.cellx_ = GetPathClusterCoord(start.x_, PATHREQUEST_CELLSIZE);
+    key.celly_ = GetPathClusterCoord(start.y_, PATHREQUEST_CELLSIZE);
+    key.goalx_ = goal.x_;
+    key.goaly_ = goal.y_;
+    key.movetype_ = movetype;
+
+    const unsigned time = timer_.GetMSec(false);
+
+    // a valid path in the cache : share it
+    HashMap<PathRequestKey, PathCacheEntry>::Iterator it = cache_.Find(key);
+    if (it != cache_.End())
+    {
+        Path2D* path = pathfinder_->GetStoredPath(it->second_.idpath_);
+        if (path->serial_ == it->second_.serial_ && path->status_ != PathFinished)
+        {
+            metrics_.numCacheHits_++;
+
+            PathRequestHit hit;
+            hit.requester_ = pathRequester;
+            hit.idpath_ = it->second_.idpath_;
+            hit.submitTime_ = time;
+            hits_.Push(hit);
+
+            return nextId_;
+        }
+
+        cache_.Erase(it);
+    }
+
+    // the same request is waiting or running : add the requester
+    for (List<PathRequest*>::Iterator jt = queued_.Begin(); jt != queued_.End(); ++jt)
+    {
+        if ((*jt)->key_ == key)
+        {
+            metrics_.numShared_++;
+            (*jt)->requesters_.Push(pathRequester);
+            return nextId_;
+        }
+    }
+    for (unsigned i = 0; i < running_.Size(); i++)
+    {
+        if (running_[i]->key_ == key)
+        {
+            metrics_.numShared_++;
+            running_[i]->requesters_.Push(pathRequester);
+            return nextId_;
+        }
+    }
+
+    PathRequest* request;
+    if (freeRequests_.Size())
+    {
+        request = freeRequests_.Back();
+        freeRequests_.Pop();
+    }
+    else
+        request = new PathRequest();
+
+    request->owner_ = this;
+    request->key_ = key;
+    request->start_ = start;
+    request->goal_ = goal;
+    request->priority_ = priority;
+    request->submitTime_ = time;
+    request->requesters_.Clear();
+    request->requesters_.Push(pathRequester);
+    request->status_ = PSS_NotFound;
+    request->tiles_.Clear();
+    request->finished_.store(true, std::memory_order_relaxed);
+
+    // insert by priority, after the requests of same priority
+    List<PathRequest*>::Iterator jt = queued_.Begin();
+    while (jt != queued_.End() && (*jt)->priority_ >= priority)
+        ++jt;
+    queued_.Insert(jt, request);
+
+    return nextId_;
+}
+
+void PathRequestQueue::MarkTileChanged(int x, int y)
+{
+    const int width = snapshot_.GetMapWidth();
+    const int height = snapshot_.GetMapHeight();
+    if (!width)
+        return;
+
+    // remove the cached paths that cross the impacted maps
+    const int mx0 = GetPathClusterCoord(x - PATHHIERARCHY_EDITMARGIN, width);
+    const int mx1 = GetPathClusterCoord(x + PATHHIERARCHY_EDITMARGIN, width);
+    const int my0 = -GetPathClusterCoord(y + PATHHIERARCHY_EDITMARGIN, height);
+    const int my1 = -GetPathClusterCoord(y - PATHHIERARCHY_EDITMARGIN, height);
+
+    for (HashMap<PathRequestKey, PathCacheEntry>::Iterator it = cache_.Begin(); it != cache_.End();)
+    {
+        bool impacted = false;
+        for (int my = my0; my <= my1 && !impacted; my++)
+            for (int mx = mx0; mx <= mx1 && !impacted; mx++)
+                impacted = it->second_.maps_.Contains(GetPathClusterKey(mx, my));
+
+        if (impacted)
+            it = cache_.Erase(it);
+        else
+            ++it;
+    }
+
+    snapshot_.MarkTileChanged(x, y);
+}
+
+void PathRequestQueue::ClearCache()
+{
+    cache_.Clear();
+
+    // the paths of the waiting hits are freed
+    for (unsigned i = 0; i < hits_.Size(); i++)
+        hits_[i].idpath_ = NoPathFound;
+}
+
+void PathRequestQueue::DumpMetrics() const
+{
+    URHO3D_LOGINFOF("PathRequestQueue() - DumpMetrics : requests=%u cachehits=%u(%.1f%%) shared=%u solved=%u failed=%u queued=%u running=%u cached=%u latency mean=%.1fms max=%ums",
+                    metrics_.numRequests_, metrics_.numCacheHits_, metrics_.GetCacheHitRate() * 100.f, metrics_.numShared_,
+                    metrics_.numSolved_, metrics_.numFailed_, queued_.Size(), running_.Size(), cache_.Size(),
+                    metrics_.GetMeanLatency(), metrics_.maxLatency_);
+}
+
+void PathRequestQueue::Solve(PathRequest& request, PathRequestSolver& solver, const PathNavSnapshot& snapshot)
+{
+    request.status_ = PSS_NotFound;
+    request.tiles_.Clear();
+
+    const int movetype = request.key_.movetype_;
+    if (!snapshot.GetMapAt(request.start_.x_, request.start_.y_) || !snapshot.IsPassable(movetype, request.goal_.x_, request.goal_.y_))
+        return;
+
+    const int width = snapshot.GetMapWidth();
+    const int height = snapshot.GetMapHeight();
+    const int dmx = GetPathClusterCoord(request.start_.x_, width) - GetPathClusterCoord(request.goal_.x_, width);
+    const int dmy = GetPathClusterCoord(request.start_.y_, height) - GetPathClusterCoord(request.goal_.y_, height);
+
+    // far maps : use the abstract graphs of the maps
+    if (Abs(dmx) > 1 || Abs(dmy) > 1)
+    {
+        request.status_ = solver.hierarchy_.FindPath(movetype, request.start_, request.goal_);
+        if (request.status_ == PSS_Found && !solver.hierarchy_.RefinePath(request.tiles_))
+            request.status_ = PSS_NotFound;
+        return;
+    }
+
+    solver.nav_.Set(&snapshot, movetype, request.goal_.x_, request.goal_.y_);
+    const unsigned startkey = solver.nav_.GetKey(request.start_.x_, request.start_.y_);
+    const unsigned goalkey = solver.nav_.GetKey(request.goal_.x_, request.goal_.y_);
+
+    request.status_ = solver.search_.Search(solver.nav_, startkey, goalkey, MAX_SEARCHCOSTFACTOR * solver.nav_.GetHeuristic(startkey));
+    if (request.status_ != PSS_Found)
+        return;
+
+    // the tiles from the goal to the start, then reverse
+    unsigned key = goalkey;
+    for (;;)
+    {
+        request.tiles_.Push(IntVector2(solver.nav_.GetX(key), solver.nav_.GetY(key)));
+        key = solver.search_.GetParent(key);
+        if (key == PATHSEARCH_NONE)
+            break;
+    }
+    for (unsigned i = 0, j = request.tiles_.Size() - 1; i < j; i++, j--)
+        Swap(request.tiles_[i], request.tiles_[j]);
+}
+
+void PathRequestQueue::HandleUpdate(StringHash eventType, VariantMap& eventData)
+{
+    if (hits_.Size())
+    {
+        // the requesters can request again in the delivery
+        Vector<PathRequestHit> hits;
+        hits.Swap(hits_);
+        for (unsigned i = 0; i < hits.Size(); i++)
+            Deliver(hits[i].requester_, hits[i].idpath_, hits[i].submitTime_);
+    }
+
+    if (!running_.Size() && queued_.Size())
+        LaunchBatch();
+}
+
+void PathRequestQueue::HandleWorkItemComplete(StringHash eventType, VariantMap& eventData)
+{
+    using namespace WorkItemCompleted;
+
+    WorkItem* item = static_cast<WorkItem*>(eventData[P_ITEM].GetPtr());
+    if (item->workFunction_ != PathRequestThread)
+        return;
+
+    // the request of a batch cancelled by Clear may have been recycled
+    PathRequest* request = static_cast<PathRequest*>(item->aux_);
+    if ((size_t)item->start_ != batchSerial_ || request->batch_ != batchSerial_)
+        return;
+
+    PODVector<PathRequest*>::Iterator it = running_.Find(request);
+    if (it == running_.End())
+        return;
+
+    running_.Erase(it);
+    request->item_.Reset();
+    Deliver(request);
+
+    if (!running_.Size() && queued_.Size())
+        LaunchBatch();
+}
+
+void PathRequestQueue::LaunchBatch()
+{
+    URHO3D_PROFILE(PathRequestBatch);
+
+    const int width = snapshot_.GetMapWidth();
+    const int height = snapshot_.GetMapHeight();
+    if (!width)
+        return;
+
+    while (running_.Size() < PATHREQUEST_MAXBATCH && queued_.Size())
+    {
+        PathRequest* request = queued_.Front();
+        queued_.PopFront();
+        running_.Push(request);
+
+        // the maps around the start and the goal
+        const int mx0 = Min(GetPathClusterCoord(request->start_.x_, width), GetPathClusterCoord(request->goal_.x_, width)) - 1;
+        const int mx1 = Max(GetPathClusterCoord(request->start_.x_, width), GetPathClusterCoord(request->goal_.x_, width)) + 1;
+        const int my0 = Min(-GetPathClusterCoord(request->start_.y_, height), -GetPathClusterCoord(request->goal_.y_, height)) - 1;
+        const int my1 = Max(-GetPathClusterCoord(request->start_.y_, height), -GetPathClusterCoord(request->goal_.y_, height)) + 1;
+        snapshot_.CaptureMaps(mx0, my0, mx1, my1);
+    }
+
+    // no worker reads the snapshot between the batches
+    PODVector<PathSnapshotMap*> updatedMaps;
+    if (snapshot_.Update(updatedMaps))
+    {
+        for (unsigned i = 0; i < solvers_.Size(); i++)
+            for (unsigned j = 0; j < updatedMaps.Size(); j++)
+                solvers_[i]->hierarchy_.MarkDirty(updatedMaps[j]->mx_, updatedMaps[j]->my_);
+    }
+
+    WorkQueue* queue = GameContext::Get().gameWorkQueue_;
+    const unsigned numThreads = queue ? queue->GetNumThreads() : 0;
+
+    // a solver by thread, the main thread included
+    while (solvers_.Size() < numThreads + 1)
+        solvers_.Push(new PathRequestSolver(snapshot_));
+
+    if (!numThreads)
+    {
+        PODVector<PathRequest*> requests;
+        requests.Swap(running_);
+        for (unsigned i = 0; i < requests.Size(); i++)
+        {
+            Solve(*requests[i], *solvers_[0], snapshot_);
+            Deliver(requests[i]);
+        }
+        return;
+    }
+
+    queue->Pause();
+
+    batchSerial_++;
+    for (unsigned i = 0; i < running_.Size(); i++)
+    {
+        PathRequest* request = running_[i];
+        request->batch_ = batchSerial_;
+        request->finished_.store(false, std::memory_order_relaxed);
+
+        request->item_ = queue->GetFreeItem();
+        request->item_->sendEvent_ = true;
+        request->item_->priority_ = PATHREQUEST_WORKITEM_PRIORITY;
+        request->item_->workFunction_ = PathRequestThread;
+        request->item_->aux_ = request;
+        // the serial of the batch travels with the completion event
+        request->item_->start_ = (void*)(size_t)batchSerial_;
+        queue->AddWorkItem(request->item_);
+    }
+
+    queue->Resume();
+}
+
+void PathRequestQueue::Deliver(PathRequest* request)
+{
+    int idpath = NoPathFound;
+
+    if (request->status_ == PSS_Found)
+    {
+        idpath = pathfinder_->ConstructPath(request->tiles_);
+        if (idpath != NoPathFound)
+        {
+            // keep the path for the next requests
+            if (cache_.Size() >= PATHREQUEST_MAXCACHE)
+            {
+                HashMap<PathRequestKey, PathCacheEntry>::Iterator oldest = cache_.Begin();
+                for (HashMap<PathRequestKey, PathCacheEntry>::Iterator it = cache_.Begin(); it != cache_.End(); ++it)
+                    if (it->second_.time_ < oldest->second_.time_)
+                        oldest = it;
+                cache_.Erase(oldest);
+            }
+
+            PathCacheEntry& entry = cache_[request->key_];
+            entry.idpath_ = idpath;
+            entry.serial_ = pathfinder_->GetStoredPath(idpath)->serial_;
+            entry.time_ = timer_.GetMSec(false);
+            entry.maps_.Clear();
+
+            const int width = snapshot_.GetMapWidth();
+            const int height = snapshot_.GetMapHeight();
+            for (unsigned i = 0; i < request->tiles_.Size(); i++)
+            {
+                const unsigned mapkey = GetPathClusterKey(GetPathClusterCoord(request->tiles_[i].x_, width), -GetPathClusterCoord(request->tiles_[i].y_, height));
+                if (!entry.maps_.Contains(mapkey))
+                    entry.maps_.Push(mapkey);
+            }
+        }
+    }
+
+    if (idpath != NoPathFound)
+        metrics_.numSolved_++;
+    else
+        metrics_.numFailed_++;
+
+    for (unsigned i = 0; i < request->requesters_.Size(); i++)
+        Deliver(request->requesters_[i], idpath, request->submitTime_);
+
+    request->requesters_.Clear();
+    request->tiles_.Clear();
+    freeRequests_.Push(request);
+}
+
+void PathRequestQueue::Deliver(const PathRequester& requester, int idpath, unsigned submitTime)
+{
+    const unsigned latency = timer_.GetMSec(false) - submitTime;
+    metrics_.numDelivered_++;
+    metrics_.totalLatency_ += latency;
+    if (latency > metrics_.maxLatency_)
+        metrics_.maxLatency_ = latency;
+
+    Node* node = requester.node_.Get();
+    if (!node)
+        return;
+
+    VariantMap& eventData = context_->GetEventDataMap();
+    eventData[Go_PathRequestDone::GO_PATHREQUESTID] = requester.id_;
+    eventData[Go_PathRequestDone::GO_PATHID] = idpath;
+    node->SendEvent(GO_PATHREQUESTDONE, eventData);
+}
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <atomic>
+
+#include <Urho3D/Container/HashMap.h>
+#include <Urho3D/Container/List.h>
+#include <Urho3D/Core/Object.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/Scene/Node.h>
+
+#include "PathSearch.h"
+#include "PathHierarchy.h"
+
+using namespace Urho3D;
+
+
+class PathFinder2D;
+
+/// Asynchronous path requests : the requests are solved by batches on the game work queue against a snapshot of the area props of the maps.
+/// The snapshot is only updated between the batches, so the workers read it without lock.
+/// The results are delivered on the main thread with GO_PATHREQUESTDONE sent by the requester node.
+
+const unsigned PATHREQUEST_WORKITEM_PRIORITY = 100U;
+const unsigned PATHREQUEST_MAXBATCH = 16;
+// the requests from the same cell of PATHREQUEST_CELLSIZE x PATHREQUEST_CELLSIZE tiles to the same goal tile share their path
+const int PATHREQUEST_CELLSIZE = 8;
+const unsigned PATHREQUEST_MAXCACHE = 256;
+
+/// PathNavSnapshot : the area props of the maps in the front view, in world tile coordinates (World of PathHierarchy)
+struct PathSnapshotMap
+{
+    int mx_, my_;
+    const void* map_;
+    bool available_;
+    bool dirty_;
+    PODVector<unsigned char> areaProps_;
+};
+
+class PathNavSnapshot
+{
+public:
+    PathNavSnapshot() : width_(0), height_(0), v_(0) { }
+    ~PathNavSnapshot();
+
+    void Set(short unsigned width, short unsigned height, int v);
+    void Clear();
+
+    /// Main thread only, between the batches
+    void CaptureMaps(int mx0, int my0, int mx1, int my1);
+    void MarkTileChanged(int x, int y);
+    /// Update the dirty maps and the maps that have been unloaded or reloaded, return the number of maps captured
+    unsigned Update(PODVector<PathSnapshotMap*>& updatedMaps);
+
+    PathSnapshotMap* GetMap(int mx, int my) const
+    {
+        HashMap<unsigned, PathSnapshotMap*>::ConstIterator it = mapsByKey_.Find(GetPathClusterKey(mx, my));
+        return it != mapsByKey_.End() && it->second_->available_ ? it->second_ : 0;
+    }
+    PathSnapshotMap* GetMapAt(int x, int y) const
+    {
+        return GetMap(GetPathClusterCoord(x, width_), -GetPathClusterCoord(y, height_));
+    }
+    unsigned GetAreaProps(int x, int y) const
+    {
+        const PathSnapshotMap* map = GetMapAt(x, y);
+        return map ? map->areaProps_[(y + map->my_ * height_) * width_ + x - map->mx_ * width_] : 0U;
+    }
+
+    /// PathHierarchy world
+    int GetMapWidth() const
+    {
+        return width_;
+    }
+    int GetMapHeight() const
+    {
+        return height_;
+    }
+    const void* GetMapStamp(int mx, int my) const
+    {
+        return GetMap(mx, my);
+    }
+    bool IsPassable(int movetype, int x, int y) const;
+    unsigned GetCost(int movetype, int ax, int ay, int bx, int by) const;
+    unsigned GetHeuristic(int movetype, int ax, int ay, int bx, int by) const;
+
+private:
+    void Capture(PathSnapshotMap& map);
+
+    short unsigned width_, height_;
+    int v_;
+
+    // the maps are never deleted : their addresses are the stamps of the clusters
+    HashMap<unsigned, PathSnapshotMap*> mapsByKey_;
+};
+
+/// PathSnapshotNav : the tiles of the snapshot as the graph of PathSearch (the slots are the snapshot maps)
+class PathSnapshotNav
+{
+public:
+    PathSnapshotNav() : snapshot_(0), movetype_(0), goalx_(0), goaly_(0) { }
+
+    void Set(const PathNavSnapshot* snapshot, int movetype, int goalx, int goaly);
+
+    unsigned GetKey(int x, int y);
+    int GetX(unsigned key) const
+    {
+        const PathSnapshotMap* map = maps_[GetPathSearchSlot(key)];
+        return map->mx_ * snapshot_->GetMapWidth() + GetPathSearchTile(key) % snapshot_->GetMapWidth();
+    }
+    int GetY(unsigned key) const
+    {
+        const PathSnapshotMap* map = maps_[GetPathSearchSlot(key)];
+        return (int)(GetPathSearchTile(key) / snapshot_->GetMapWidth()) - map->my_ * snapshot_->GetMapHeight();
+    }
+
+    /// PathSearch navigation
+    unsigned GetNumSlots() const
+    {
+        return maps_.Size();
+    }
+    unsigned GetNumTiles() const
+    {
+        return snapshot_->GetMapWidth() * snapshot_->GetMapHeight();
+    }
+    unsigned GetNeighbors(unsigned key, unsigned* keys);
+    unsigned GetCost(unsigned from, unsigned to) const
+    {
+        return snapshot_->GetCost(movetype_, GetX(from), GetY(from), GetX(to), GetY(to));
+    }
+    unsigned GetHeuristic(unsigned key) const
+    {
+        return snapshot_->GetHeuristic(movetype_, GetX(key), GetY(key), goalx_, goaly_);
+    }
+    bool IsTimeOut(unsigned numExpanded) const
+    {
+        return false;
+    }
+
+private:
+    const PathNavSnapshot* snapshot_;
+    int movetype_;
+    int goalx_, goaly_;
+    PODVector<const PathSnapshotMap*> maps_;
+};
+
+/// Searches of a worker thread
+struct PathRequestSolver
+{
+    PathRequestSolver(const PathNavSnapshot& snapshot) : hierarchy_(snapshot) { }
+
+    PathSnapshotNav nav_;
+    PathSearch<PathSnapshotNav> search_;
+    PathHierarchy<PathNavSnapshot> hierarchy_;
+};
+
+/// Cache key : the cell of the start, the goal tile and the move type
+struct PathRequestKey
+{
+    PathRequestKey() : cellx_(0), celly_(0), goalx_(0), goaly_(0), movetype_(0) { }
+
+    bool operator == (const PathRequestKey& rhs) const
+    {
+        return cellx_ == rhs.cellx_ && celly_ == rhs.celly_ && goalx_ == rhs.goalx_ && goaly_ == rhs.goaly_ && movetype_ == rhs.movetype_;
+    }
+    bool operator != (const PathRequestKey& rhs) const
+    {
+        return !(*this == rhs);
+    }
+    unsigned ToHash() const
+    {
+        return (((unsigned)cellx_ * 31U + (unsigned)celly_) * 31U + (unsigned)goalx_) * 31U * 31U + (unsigned)goaly_ * 31U + (unsigned)movetype_;
+    }
+
+    int cellx_, celly_;
+    int goalx_, goaly_;
+    int movetype_;
+};
+
+struct PathRequester
+{
+    WeakPtr<Node> node_;
+    unsigned id_;
+};
+
+class PathRequestQueue;
+
+struct PathRequest
+{
+    PathRequest() : owner_(0), priority_(0), submitTime_(0), status_(PSS_NotFound), batch_(0), finished_(true) { }
+
+    PathRequestQueue* owner_;
+    PathRequestKey key_;
+    IntVector2 start_, goal_;
+    int priority_;
+    unsigned submitTime_;
+    Vector<PathRequester> requesters_;
+
+    // result
+    int status_;
+    PODVector<IntVector2> tiles_;
+
+    // the serial of the batch and the work item of the request in the running batch
+    unsigned batch_;
+    SharedPtr<WorkItem> item_;
+    // set by the worker at the end of the search
+    std::atomic<bool> finished_;
+};
+
+struct PathRequestHit
+{
+    PathRequester requester_;
+    int idpath_;
+    unsigned submitTime_;
+};
+
+struct PathCacheEntry
+{
+    int idpath_;
+    unsigned serial_;
+    unsigned time_;
+    // the maps crossed by the path
+    PODVector<unsigned> maps_;
+};
+
+struct PathRequestMetrics
+{
+    PathRequestMetrics() : numRequests_(0), numCacheHits_(0), numShared_(0), numSolved_(0), numFailed_(0), numDelivered_(0), totalLatency_(0), maxLatency_(0) { }
+
+    float GetCacheHitRate() const
+    {
+        return numRequests_ ? (float)numCacheHits_ / numRequests_ : 0.f;
+    }
+    float GetMeanLatency() const
+    {
+        return numDelivered_ ? (float)totalLatency_ / numDelivered_ : 0.f;
+    }
+
+    unsigned numRequests_;
+    unsigned numCacheHits_;
+    unsigned numShared_;
+    unsigned numSolved_;
+    unsigned numFailed_;
+    unsigned numDelivered_;
+    // queue latency in msec : from the request to the delivery
+    unsigned totalLatency_;
+    unsigned maxLatency_;
+};
+
+class PathRequestQueue : public Object
+{
+    URHO3D_OBJECT(PathRequestQueue, Object);
+
+public:
+    PathRequestQueue(Context* context, PathFinder2D* pathfinder);
+    virtual ~PathRequestQueue();
+
+    void Set(short unsigned width, short unsigned height, int v);
+    void Clear();
+
+    /// Queue a request, return the request id sent with GO_PATHREQUESTDONE
+    unsigned Request(const IntVector2& start, const IntVector2& goal, int movetype, Node* requester, int priority);
+    /// A tile has changed : invalidate the cached paths and the snapshot of its maps
+    void MarkTileChanged(int x, int y);
+    /// The paths have been freed
+    void ClearCache();
+
+    unsigned GetNumQueued() const
+    {
+        return queued_.Size();
+    }
+    const PathRequestMetrics& GetMetrics() const
+    {
+        return metrics_;
+    }
+    void DumpMetrics() const;
+
+    /// Worker threads : the solvers are allocated before the batch
+    PathRequestSolver* GetSolver(unsigned threadIndex) const
+    {
+        return solvers_[threadIndex < solvers_.Size() ? threadIndex : 0];
+    }
+    const PathNavSnapshot& GetSnapshot() const
+    {
+        return snapshot_;
+    }
+    static void Solve(PathRequest& request, PathRequestSolver& solver, const PathNavSnapshot& snapshot);
+
+private:
+    void HandleUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleWorkItemComplete(StringHash eventType, VariantMap& eventData);
+
+    void LaunchBatch();
+    void Deliver(PathRequest* request);
+    void Deliver(const PathRequester& requester, int idpath, unsigned submitTime);
+
+    PathFinder2D* pathfinder_;
+    PathNavSnapshot snapshot_;
+    Vector<PathRequestSolver*> solvers_;
+
+    // the requests waiting for a batch, by priority
+    List<PathRequest*> queued_;
+    // the requests of the running batch
+    PODVector<PathRequest*> running_;
+    PODVector<PathRequest*> freeRequests_;
+    // the cache hits delivered at the next update
+    Vector<PathRequestHit> hits_;
+
+    HashMap<PathRequestKey, PathCacheEntry> cache_;
+
+    unsigned nextId_;
+    // the serial of the running batch : the completions of a cancelled batch are dropped
+    unsigned batchSerial_;
+    Timer timer_;
+    PathRequestMetrics metrics_;
+};
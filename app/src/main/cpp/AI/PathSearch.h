@@ -0,0 +1,330 @@
+#pragma once
+
+#include <Urho3D/Container/Vector.h>
+
+using namespace Urho3D;
+
+
+/// Node key of a search : the slot of the map (the maps crossed by the search are numbered by the navigation) and the tile index in the map
+const unsigned PATHSEARCH_TILEBITS = 24;
+const unsigned PATHSEARCH_TILEMASK = (1U << PATHSEARCH_TILEBITS) - 1;
+
+const unsigned PATHSEARCH_NONE = 0xFFFFFFFF;
+const unsigned PATHSEARCH_CLOSED = 0xFFFFFFFE;
+const unsigned PATHSEARCH_NOWAY = 65535;
+const unsigned PATHSEARCH_MAXNEIGHBORS = 8;
+
+inline unsigned GetPathSearchKey(unsigned slot, unsigned tile)
+{
+    return (slot << PATHSEARCH_TILEBITS) | tile;
+}
+inline unsigned GetPathSearchSlot(unsigned key)
+{
+    return key >> PATHSEARCH_TILEBITS;
+}
+inline unsigned GetPathSearchTile(unsigned key)
+{
+    return key & PATHSEARCH_TILEMASK;
+}
+
+enum PathSearchStatus
+{
+    PSS_NotFound = 0,
+    PSS_Found,
+    PSS_Stopped,    // max cost or max time reached
+    PSS_Running     // Continue : the max number of expanded nodes is reached, the search can continue
+};
+
+/// State of a node, stamped by the generation of the search : the states of the previous searches are never cleared
+struct PathSearchNodeState
+{
+    unsigned stamp_;
+    unsigned g_;
+    unsigned parent_;
+    // position in the open heap, PATHSEARCH_NONE if not opened, PATHSEARCH_CLOSED if expanded
+    unsigned heap_;
+};
+
+struct PathSearchOpenNode
+{
+    unsigned f_;
+    unsigned g_;
+    unsigned key_;
+};
+
+/// Order of the open nodes : lower f first, then higher g (nearest of the goal), then lower key.
+/// The order is total, so the result of a search doesn't depend on the structure of the open set.
+inline bool IsPathSearchNodeBefore(const PathSearchOpenNode& a, const PathSearchOpenNode& b)
+{
+    if (a.f_ != b.f_)
+        return a.f_ < b.f_;
+    if (a.g_ != b.g_)
+        return a.g_ > b.g_;
+    return a.key_ < b.key_;
+}
+
+/// PathSearch : A* with an indexed binary heap for the open set and dense node states addressed by the node keys.
+/// The navigation Nav gives the graph :
+///     unsigned GetNumSlots() const                            number of maps crossed by the search (the slots grow during the search)
+///     unsigned GetNumTiles() const                            number of tiles by map
+///     unsigned GetNeighbors(unsigned key, unsigned* keys)     the reachable neighbors (MaxNeighbors max)
+///     unsigned GetCost(unsigned from, unsigned to)            cost to move to a neighbor, PATHSEARCH_NOWAY if not possible
+///     unsigned GetHeuristic(unsigned key)                     estimated cost to the goal
+///     bool IsTimeOut(unsigned numExpanded)                    stop the search
+template <class Nav, unsigned MaxNeighbors = PATHSEARCH_MAXNEIGHBORS>
+class PathSearch
+{
+public:
+    PathSearch() :
+        generation_(0), numTiles_(0), goal_(PATHSEARCH_NONE), maxCost_(0), startF_(0), lastKey_(PATHSEARCH_NONE), numExpanded_(0) { }
+
+    /// Search from start to goal. The search stops if the f cost of the expanded node exceeds maxcost (0 for no limit).
+    int Search(Nav& nav, unsigned start, unsigned goal, unsigned maxcost=0)
+    {
+        Begin(nav, start, goal, maxcost);
+        return Continue(nav);
+    }
+
+    /// Search by steps : Begin, then Continue until the status isn't PSS_Running.
+    /// The navigation must give the same graph between the steps.
+    void Begin(Nav& nav, unsigned start, unsigned goal, unsigned maxcost=0)
+    {
+        NewGeneration(nav);
+
+        heap_.Clear();
+        goal_ = goal;
+        maxCost_ = maxcost;
+        numExpanded_ = 0;
+        startF_ = nav.GetHeuristic(start);
+        lastKey_ = start;
+
+        Open(start, 0, startF_, PATHSEARCH_NONE);
+    }
+    /// Expand maxexpanded nodes at most (0 for no limit)
+    int Continue(Nav& nav, unsigned maxexpanded=0)
+    {
+        const unsigned goal = goal_;
+        const unsigned maxcost = maxCost_;
+        const unsigned lastexpanded = numExpanded_ + maxexpanded;
+
+        unsigned neighbors[MaxNeighbors];
+
+        while (heap_.Size())
+        {
+            if (maxexpanded && numExpanded_ == lastexpanded)
+                return PSS_Running;
+
+            const PathSearchOpenNode a = Pop();
+            lastKey_ = a.key_;
+            numExpanded_++;
+
+            if (a.key_ == goal)
+                return PSS_Found;
+
+            if ((maxcost && a.f_ > maxcost) || nav.IsTimeOut(numExpanded_))
+                return PSS_Stopped;
+
+            const unsigned numneighbors = nav.GetNeighbors(a.key_, neighbors);
+            Reserve(nav.GetNumSlots());
+
+            for (unsigned i = 0; i < numneighbors; i++)
+            {
+                const unsigned b = neighbors[i];
+                PathSearchNodeState& state = GetState(b);
+                if (state.heap_ == PATHSEARCH_CLOSED)
+                    continue;
+
+                const unsigned cost = nav.GetCost(a.key_, b);
+                if (cost >= PATHSEARCH_NOWAY)
+                    continue;
+
+                const unsigned g = a.g_ + cost;
+                if (g >= state.g_)
+                    continue;
+
+                state.g_ = g;
+                state.parent_ = a.key_;
+
+                if (state.heap_ == PATHSEARCH_NONE)
+                    Open(b, g, g + nav.GetHeuristic(b), a.key_);
+                else
+                    Decrease(state.heap_, g, g + nav.GetHeuristic(b));
+            }
+        }
+
+        return PSS_NotFound;
+    }
+
+    /// Parent of a node reached by the last search, PATHSEARCH_NONE for the start
+    unsigned GetParent(unsigned key) const
+    {
+        return nodes_[GetIndex(key)].parent_;
+    }
+    /// Cost from the start of a node reached by the last search
+    unsigned GetCost(unsigned key) const
+    {
+        return nodes_[GetIndex(key)].g_;
+    }
+    bool IsReached(unsigned key) const
+    {
+        const unsigned index = GetIndex(key);
+        return index < nodes_.Size() && nodes_[index].stamp_ == generation_;
+    }
+
+    unsigned GetStartF() const
+    {
+        return startF_;
+    }
+    /// Last expanded node (the goal if found)
+    unsigned GetLastKey() const
+    {
+        return lastKey_;
+    }
+    unsigned GetNumExpanded() const
+    {
+        return numExpanded_;
+    }
+
+private:
+    unsigned GetIndex(unsigned key) const
+    {
+        return GetPathSearchSlot(key) * numTiles_ + GetPathSearchTile(key);
+    }
+
+    PathSearchNodeState& GetState(unsigned key)
+    {
+        PathSearchNodeState& state = nodes_[GetIndex(key)];
+        if (state.stamp_ != generation_)
+        {
+            state.stamp_ = generation_;
+            state.g_ = PATHSEARCH_NONE;
+            state.parent_ = PATHSEARCH_NONE;
+            state.heap_ = PATHSEARCH_NONE;
+        }
+        return state;
+    }
+
+    void NewGeneration(const Nav& nav)
+    {
+        if (numTiles_ != nav.GetNumTiles())
+        {
+            numTiles_ = nav.GetNumTiles();
+            nodes_.Clear();
+            generation_ = 0;
+        }
+
+        generation_++;
+
+        // the stamps have wrapped : clear the states
+        if (!generation_)
+        {
+            for (unsigned i = 0; i < nodes_.Size(); i++)
+                nodes_[i].stamp_ = 0;
+            generation_ = 1;
+        }
+
+        Reserve(nav.GetNumSlots());
+    }
+
+    void Reserve(unsigned numslots)
+    {
+        const unsigned numnodes = numslots * numTiles_;
+        if (nodes_.Size() >= numnodes)
+            return;
+
+        const unsigned oldsize = nodes_.Size();
+        nodes_.Resize(numnodes);
+        for (unsigned i = oldsize; i < numnodes; i++)
+            nodes_[i].stamp_ = 0;
+    }
+
+    void Open(unsigned key, unsigned g, unsigned f, unsigned parent)
+    {
+        PathSearchNodeState& state = GetState(key);
+        state.g_ = g;
+        state.parent_ = parent;
+
+        PathSearchOpenNode node;
+        node.f_ = f;
+        node.g_ = g;
+        node.key_ = key;
+
+        heap_.Push(node);
+        state.heap_ = heap_.Size() - 1;
+        SiftUp(state.heap_);
+    }
+
+    void Decrease(unsigned position, unsigned g, unsigned f)
+    {
+        heap_[position].g_ = g;
+        heap_[position].f_ = f;
+        SiftUp(position);
+    }
+
+    PathSearchOpenNode Pop()
+    {
+        const PathSearchOpenNode top = heap_[0];
+        nodes_[GetIndex(top.key_)].heap_ = PATHSEARCH_CLOSED;
+
+        const PathSearchOpenNode last = heap_.Back();
+        heap_.Pop();
+        if (heap_.Size())
+        {
+            heap_[0] = last;
+            nodes_[GetIndex(last.key_)].heap_ = 0;
+            SiftDown(0);
+        }
+
+        return top;
+    }
+
+    void SiftUp(unsigned position)
+    {
+        const PathSearchOpenNode node = heap_[position];
+        while (position > 0)
+        {
+            const unsigned parent = (position - 1) >> 1;
+            if (!IsPathSearchNodeBefore(node, heap_[parent]))
+                break;
+            Place(position, heap_[parent]);
+            position = parent;
+        }
+        Place(position, node);
+    }
+
+    void SiftDown(unsigned position)
+    {
+        const unsigned size = heap_.Size();
+        const PathSearchOpenNode node = heap_[position];
+        for (;;)
+        {
+            unsigned child = 2 * position + 1;
+            if (child >= size)
+                break;
+            if (child + 1 < size && IsPathSearchNodeBefore(heap_[child+1], heap_[child]))
+                child++;
+            if (!IsPathSearchNodeBefore(heap_[child], node))
+                break;
+            Place(position, heap_[child]);
+            position = child;
+        }
+        Place(position, node);
+    }
+
+    void Place(unsigned position, const PathSearchOpenNode& node)
+    {
+        heap_[position] = node;
+        nodes_[GetIndex(node.key_)].heap_ = position;
+    }
+
+    unsigned generation_;
+    unsigned numTiles_;
+    unsigned goal_;
+    unsigned maxCost_;
+    unsigned startF_;
+    unsigned lastKey_;
+    unsigned numExpanded_;
+
+    PODVector<PathSearchNodeState> nodes_;
+    PODVector<PathSearchOpenNode> heap_;
+};
@@ -0,0 +1,154 @@
+#include <Urho3D/Urho3D.h>
+
+#include "PathCosts.h"
+
+#include "PathWalkGraph.h"
+
+
+// the moore neighbors in the order of MapInfo::neighborOffX/Y
+static const int sNeighborOffX[8] = { -1, 0,  1,  1,  1,  0, -1, -1 };
+static const int sNeighborOffY[8] = { -1, -1, -1,  0,  1,  1,  1, 0 };
+
+/// Walker Graph
+
+void PathWalkGraph::Set(int width, int height)
+{
+    width_ = width;
+    height_ = height;
+
+    cells_.Resize((width_ + 4) * (height_ + PATHWALK_MAXJUMP + 2));
+    for (unsigned i = 0; i < cells_.Size(); i++)
+        cells_[i] = PWC_None;
+
+    nodes_.Resize((width_ + 2) * (height_ + 2));
+    for (unsigned i = 0; i < nodes_.Size(); i++)
+    {
+        nodes_[i].props_ = nomoveFlag;
+        nodes_[i].height_ = PATHWALK_NOGROUND;
+        nodes_[i].numLinks_ = 0;
+        nodes_[i].firstLink_ = 0;
+    }
+
+    links_.Resize(height_);
+}
+
+void PathWalkGraph::Build()
+{
+    for (int y = -1; y <= height_; y++)
+        for (int x = -1; x <= width_; x++)
+            UpdateNode(x, y);
+
+    for (int y = 0; y < height_; y++)
+        UpdateLinks(y);
+}
+
+void PathWalkGraph::Patch(int x, int y, unsigned char cell)
+{
+    if (!IsCellInside(x, y))
+        return;
+
+    SetCell(x, y, cell);
+
+    // the nodes that see the cell : the sides and the tiles above in the jump height
+    const int x0 = Max(x - 1, -1);
+    const int x1 = Min(x + 1, width_);
+    const int y0 = Max(y - PATHWALK_MAXJUMP, -1);
+    const int y1 = Min(y, height_);
+    for (int ny = y0; ny <= y1; ny++)
+        for (int nx = x0; nx <= x1; nx++)
+            UpdateNode(nx, ny);
+
+    // the rows of the links to these nodes
+    const int ly1 = Min(y1 + 1, height_ - 1);
+    for (int ly = Max(y0 - 1, 0); ly <= ly1; ly++)
+        UpdateLinks(ly);
+}
+
+unsigned PathWalkGraph::GetNumLinks() const
+{
+    unsigned numlinks = 0;
+    for (unsigned i = 0; i < links_.Size(); i++)
+        numlinks += links_[i].Size();
+    return numlinks;
+}
+
+// same rules as MapBase::GetAreaProps on the captured cells
+void PathWalkGraph::UpdateNode(int x, int y)
+{
+    PathWalkNode& node = nodes_[(y + 1) * (width_ + 2) + x + 1];
+    node.props_ = nomoveFlag;
+    node.height_ = PATHWALK_NOGROUND;
+
+    if (GetCell(x, y) != PWC_Free)
+        return;
+
+    unsigned props = flyableFlag;
+
+    // Walk : check ground
+    if (GetCell(x, y + 1) == PWC_Block)
+        props |= walkableFlag;
+
+    // Jump : check sides
+    if (GetCell(x + 1, y) == PWC_Block)
+        props |= jumpableRightFlag;
+    if (GetCell(x - 1, y) == PWC_Block)
+        props |= jumpableLeftFlag;
+
+    // Jump : check ground max jump height
+    for (int k = 1; k <= PATHWALK_MAXJUMP; k++)
+    {
+        const unsigned char cell = GetCell(x, y + k);
+        if (cell != PWC_Free)
+        {
+            props |= jumpableFlag;
+            if (cell == PWC_Block)
+                node.height_ = k - 1;
+            break;
+        }
+    }
+
+    node.props_ = props;
+}
+
+void PathWalkGraph::UpdateLinks(int y)
+{
+    const unsigned areaflags = GetPathMoveAreaFlags(PMT_Walker);
+
+    PODVector<PathWalkLink>& links = links_[y];
+    links.Clear();
+
+    PathWalkLink link;
+    for (int x = 0; x < width_; x++)
+    {
+        PathWalkNode& node = nodes_[(y + 1) * (width_ + 2) + x + 1];
+        node.firstLink_ = links.Size();
+
+        for (int imoore = 0; imoore < 8; imoore++)
+        {
+            const int dx = sNeighborOffX[imoore];
+            const int dy = sNeighborOffY[imoore];
+            const PathWalkNode& target = GetNode(x + dx, y + dy);
+            if (!(target.props_ & areaflags))
+                continue;
+
+            const unsigned cost = NghbDist_walker(x, y, x + dx, y + dy, target.props_);
+            if (cost >= COST_NOWAY)
+                continue;
+
+            link.dx_ = dx;
+            link.dy_ = dy;
+            // the tile y goes down
+            if (dy < 0)
+                link.type_ = target.height_ == PATHWALK_NOGROUND ? PWL_Climb : PWL_Jump;
+            else if (dy > 0)
+                link.type_ = PWL_Fall;
+            else
+                link.type_ = target.height_ == 0 ? PWL_Walk : PWL_Jump;
+            link.height_ = target.height_;
+            link.cost_ = cost;
+            links.Push(link);
+        }
+
+        node.numLinks_ = links.Size() - node.firstLink_;
+    }
+}
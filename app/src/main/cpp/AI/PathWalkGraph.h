@@ -0,0 +1,189 @@
+#pragma once
+
+#include <atomic>
+
+#include <Urho3D/Container/HashMap.h>
+#include <Urho3D/Core/Object.h>
+#include <Urho3D/Core/WorkQueue.h>
+
+#include "ShortIntVector2.h"
+
+#include "PathHierarchy.h"
+
+using namespace Urho3D;
+
+
+class Map;
+
+/// Walker navigation graph : the walker moves of a map, precomputed from the solid cells of the map and of a band of its neighbors.
+/// The links are the moves of the walker search to the neighbor tiles (see NghbDist_walker) annotated with their type, their cost
+/// and the height to jump, so the walker searches don't walk the fluid cells at each expansion.
+/// The graphs are built on the game work queue when the maps become available and patched on the tile changes.
+
+// the jump height of MapBase::GetAreaProps
+const int PATHWALK_MAXJUMP = 3;
+const unsigned char PATHWALK_NOGROUND = 0xFF;
+const unsigned PATHWALK_WORKITEM_PRIORITY = 90U;
+// graphs captured by update
+const unsigned PATHWALK_MAXLAUNCH = 4;
+
+enum PathWalkCell
+{
+    PWC_None = 0,       // no fluid cell (not connected map)
+    PWC_Block,
+    PWC_Free
+};
+
+enum PathWalkLinkType
+{
+    PWL_Walk = 0,       // on the ground
+    PWL_Jump,           // up or along the air with the ground in the jump height
+    PWL_Fall,
+    PWL_Climb           // up along a wall, the ground is out of the jump height
+};
+
+struct PathWalkNode
+{
+    // area props (see MapBase::GetAreaProps) : the fluids are ignored, the walkers fall in the water
+    unsigned char props_;
+    // free tiles to the ground, PATHWALK_NOGROUND if the ground is out of the jump height
+    unsigned char height_;
+    // the links of the tile in the links of its row
+    unsigned char numLinks_;
+    unsigned short firstLink_;
+};
+
+struct PathWalkLink
+{
+    signed char dx_, dy_;
+    unsigned char type_;
+    // height of the target above the ground
+    unsigned char height_;
+    unsigned short cost_;
+};
+
+class PathWalkGraph
+{
+public:
+    PathWalkGraph() : width_(0), height_(0) { }
+
+    void Set(int width, int height);
+
+    /// The captured cells : -2 <= x <= width + 1, -1 <= y <= height + PATHWALK_MAXJUMP
+    bool IsCellInside(int x, int y) const
+    {
+        return x >= -2 && x <= width_ + 1 && y >= -1 && y <= height_ + PATHWALK_MAXJUMP;
+    }
+    void SetCell(int x, int y, unsigned char cell)
+    {
+        cells_[GetCellIndex(x, y)] = cell;
+    }
+    unsigned char GetCell(int x, int y) const
+    {
+        return cells_[GetCellIndex(x, y)];
+    }
+
+    /// Compute the nodes and the links from the captured cells
+    void Build();
+    /// A cell has changed : update the nodes and the links around it
+    void Patch(int x, int y, unsigned char cell);
+
+    /// The nodes : -1 <= x <= width, -1 <= y <= height (the border of the neighbor maps)
+    const PathWalkNode& GetNode(int x, int y) const
+    {
+        return nodes_[(y + 1) * (width_ + 2) + x + 1];
+    }
+    /// The links of a tile of the map
+    unsigned GetLinks(int x, int y, const PathWalkLink*& links) const
+    {
+        const PathWalkNode& node = GetNode(x, y);
+        links = node.numLinks_ ? &links_[y][node.firstLink_] : 0;
+        return node.numLinks_;
+    }
+    unsigned GetNumLinks() const;
+
+private:
+    unsigned GetCellIndex(int x, int y) const
+    {
+        return (y + 1) * (width_ + 4) + x + 2;
+    }
+    void UpdateNode(int x, int y);
+    void UpdateLinks(int y);
+
+    int width_, height_;
+    PODVector<unsigned char> cells_;
+    PODVector<PathWalkNode> nodes_;
+    // by row
+    Vector<PODVector<PathWalkLink> > links_;
+};
+
+enum PathWalkGraphState
+{
+    PWG_None = 0,       // to build
+    PWG_Building,
+    PWG_Ready
+};
+
+struct PathWalkMap
+{
+    PathWalkMap() : mx_(0), my_(0), map_(0), state_(PWG_None), dirty_(false), finished_(true) { }
+
+    int mx_, my_;
+    // the stamps of the map and of its neighbors at the capture (the available maps)
+    const void* map_;
+    const void* neighbors_[8];
+    PathWalkGraph graph_;
+    int state_;
+    // a tile has changed during the build
+    bool dirty_;
+    // the work item of the build
+    SharedPtr<WorkItem> item_;
+    // set by the worker at the end of the build
+    std::atomic<bool> finished_;
+};
+
+class PathWalkGraphs : public Object
+{
+    URHO3D_OBJECT(PathWalkGraphs, Object);
+
+public:
+    PathWalkGraphs(Context* context);
+    virtual ~PathWalkGraphs();
+
+    void Set(short unsigned width, short unsigned height, int v);
+    void Clear();
+
+    /// The graph of an available map, 0 if not ready (the build is launched at the next update)
+    const PathWalkGraph* GetGraph(Map* map);
+    const PathWalkGraph* GetGraph(int mx, int my);
+    /// A tile has changed : patch the graphs of its map and of the neighbors
+    void MarkTileChanged(const ShortIntVector2& mpoint, unsigned tileindex);
+
+    int GetViewIndex() const
+    {
+        return v_;
+    }
+    unsigned GetNumBuilt() const
+    {
+        return numBuilt_;
+    }
+
+private:
+    void HandleUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleMapAvailable(StringHash eventType, VariantMap& eventData);
+    void HandleWorkItemComplete(StringHash eventType, VariantMap& eventData);
+
+    PathWalkMap* GetWalkMap(int mx, int my);
+    bool IsStale(const PathWalkMap& wmap) const;
+    void Invalidate(int mx, int my);
+    void Capture(PathWalkMap& wmap, Map* map);
+
+    short unsigned width_, height_;
+    int v_;
+
+    HashMap<unsigned, PathWalkMap*> maps_;
+    // the maps to build, the maps in build
+    PODVector<PathWalkMap*> pending_;
+    PODVector<PathWalkMap*> building_;
+    unsigned numBuilt_;
+};
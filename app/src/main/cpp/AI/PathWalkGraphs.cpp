@@ -0,0 +1,336 @@
+#include <Urho3D/Urho3D.h>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Core/Profiler.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/IO/Log.h>
+
+#include "GameContext.h"
+
+#include "DefsFluids.h"
+#include "MapWorld.h"
+
+#include "PathFinder2D.h"
+
+#include "PathWalkGraph.h"
+
+
+/// Walker Graphs of the maps
+
+static void PathWalkGraphThread(const WorkItem* item, unsigned threadIndex)
+{
+    PathWalkMap& wmap = *static_cast<PathWalkMap*>(item->aux_);
+
+    wmap.graph_.Build();
+
+    wmap.finished_.store(true, std::memory_order_release);
+}
+
+static inline unsigned char GetPathWalkCell(const FluidCell* cell)
+{
+    return !cell ? PWC_None : cell->type_ == BLOCK ? PWC_Block : PWC_Free;
+}
+
+PathWalkGraphs::PathWalkGraphs(Context* context) :
+    Object(context),
+    width_(0),
+    height_(0),
+    v_(0),
+    numBuilt_(0)
+{
+    SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(PathWalkGraphs, HandleUpdate));
+    SubscribeToEvent(MAP_AVAILABLE, URHO3D_HANDLER(PathWalkGraphs, HandleMapAvailable));
+
+    if (GameContext::Get().gameWorkQueue_)
+        SubscribeToEvent(GameContext::Get().gameWorkQueue_, E_WORKITEMCOMPLETED, URHO3D_HANDLER(PathWalkGraphs, HandleWorkItemComplete));
+}
+
+PathWalkGraphs::~PathWalkGraphs()
+{
+    Clear();
+}
+
+void PathWalkGraphs::Set(short unsigned width, short unsigned height, int v)
+{
+    Clear();
+
+    width_ = width;
+    height_ = height;
+    v_ = v;
+}
+
+void PathWalkGraphs::Clear()
+{
+    // the workers must end the builds before the graphs are deleted
+    if (building_.Size())
+    {
+        // take back the builds not yet taken by the workers : the other items of the queue are not run by this wait
+        WorkQueue* queue = GameContext::Get().gameWorkQueue_;
+        for (unsigned i = 0; i < building_.Size(); i++)
+        {
+            PathWalkMap* wmap = building_[i];
+            if (queue && wmap->item_ && wmap->item_->aux_ == wmap && queue->RemoveWorkItem(wmap->item_))
+                wmap->finished_.store(true, std::memory_order_relaxed);
+        }
+
+        // only the builds in progress in the workers remain
+        for (unsigned i = 0; i < building_.Size(); i++)
+        {
+            while (!building_[i]->finished_.load(std::memory_order_acquire))
+                Time::Sleep(0);
+            building_[i]->item_.Reset();
+        }
+    }
+    building_.Clear();
+    pending_.Clear();
+
+    for (HashMap<unsigned, PathWalkMap*>::Iterator it = maps_.Begin(); it != maps_.End(); ++it)
+        delete it->second_;
+    maps_.Clear();
+}
+
+const PathWalkGraph* PathWalkGraphs::GetGraph(Map* map)
+{
+    const ShortIntVector2& mpoint = map->GetMapPoint();
+    return GetGraph(mpoint.x_, mpoint.y_);
+}
+
+const PathWalkGraph* PathWalkGraphs::GetGraph(int mx, int my)
+{
+    if (!width_)
+        return 0;
+
+    PathWalkMap* wmap = GetWalkMap(mx, my);
+
+    // a neighbor has been loaded or unloaded : the band of the neighbors has changed
+    if (wmap->state_ == PWG_Ready && IsStale(*wmap))
+        wmap->state_ = PWG_None;
+
+    if (wmap->state_ == PWG_Ready)
+        return &wmap->graph_;
+
+    if (wmap->state_ == PWG_None && !pending_.Contains(wmap))
+        pending_.Push(wmap);
+
+    return 0;
+}
+
+void PathWalkGraphs::MarkTileChanged(const ShortIntVector2& mpoint, unsigned tileindex)
+{
+    if (!width_ || !maps_.Size())
+        return;
+
+    Map* map = World2D::GetAvailableMapAt(mpoint);
+    if (!map)
+        return;
+
+    const unsigned char cell = GetPathWalkCell(map->GetFluidCellPtr(tileindex, v_));
+    const int x = mpoint.x_ * width_ + tileindex % width_;
+    const int y = tileindex / width_ - mpoint.y_ * height_;
+
+    // the graphs whose captured cells contain the tile
+    for (int my = mpoint.y_ - 1; my <= mpoint.y_ + 1; my++)
+        for (int mx = mpoint.x_ - 1; mx <= mpoint.x_ + 1; mx++)
+        {
+            HashMap<unsigned, PathWalkMap*>::Iterator it = maps_.Find(GetPathClusterKey(mx, my));
+            if (it == maps_.End())
+                continue;
+
+            PathWalkMap* wmap = it->second_;
+            if (wmap->state_ == PWG_Building)
+                wmap->dirty_ = true;
+            else if (wmap->state_ == PWG_Ready)
+                wmap->graph_.Patch(x - mx * width_, y + my * height_, cell);
+        }
+}
+
+PathWalkMap* PathWalkGraphs::GetWalkMap(int mx, int my)
+{
+    PathWalkMap*& wmap = maps_[GetPathClusterKey(mx, my)];
+    if (!wmap)
+    {
+        wmap = new PathWalkMap();
+        wmap->mx_ = mx;
+        wmap->my_ = my;
+    }
+    return wmap;
+}
+
+bool PathWalkGraphs::IsStale(const PathWalkMap& wmap) const
+{
+    if (World2D::GetAvailableMapAt(ShortIntVector2(wmap.mx_, wmap.my_)) != wmap.map_)
+        return true;
+
+    unsigned i = 0;
+    for (int my = wmap.my_ - 1; my <= wmap.my_ + 1; my++)
+        for (int mx = wmap.mx_ - 1; mx <= wmap.mx_ + 1; mx++)
+        {
+            if (mx == wmap.mx_ && my == wmap.my_)
+                continue;
+            if (World2D::GetAvailableMapAt(ShortIntVector2(mx, my)) != wmap.neighbors_[i++])
+                return true;
+        }
+
+    return false;
+}
+
+void PathWalkGraphs::Invalidate(int mx, int my)
+{
+    HashMap<unsigned, PathWalkMap*>::Iterator it = maps_.Find(GetPathClusterKey(mx, my));
+    if (it == maps_.End())
+        return;
+
+    PathWalkMap* wmap = it->second_;
+    if (wmap->state_ == PWG_Building)
+    {
+        wmap->dirty_ = true;
+        return;
+    }
+
+    wmap->state_ = PWG_None;
+    if (!pending_.Contains(wmap))
+        pending_.Push(wmap);
+}
+
+void PathWalkGraphs::Capture(PathWalkMap& wmap, Map* map)
+{
+    wmap.map_ = map;
+
+    unsigned i = 0;
+    for (int my = wmap.my_ - 1; my <= wmap.my_ + 1; my++)
+        for (int mx = wmap.mx_ - 1; mx <= wmap.mx_ + 1; mx++)
+        {
+            if (mx != wmap.mx_ || my != wmap.my_)
+                wmap.neighbors_[i++] = World2D::GetAvailableMapAt(ShortIntVector2(mx, my));
+        }
+
+    PathWalkGraph& graph = wmap.graph_;
+    graph.Set(width_, height_);
+
+    // the cells of the map, then the band of the neighbors by the links of the fluid cells (as MapBase::GetAreaProps)
+    const int w = width_;
+    const int h = height_;
+    const int cw = w + 4;
+    PODVector<FluidCell*> cells((h + PATHWALK_MAXJUMP + 2) * cw);
+    for (unsigned c = 0; c < cells.Size(); c++)
+        cells[c] = 0;
+
+#define CAPTURED_CELL(x, y) cells[((y) + 1) * cw + (x) + 2]
+
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+            CAPTURED_CELL(x, y) = map->GetFluidCellPtr(y * w + x, v_);
+
+        for (int x = -1; x >= -2; x--)
+            CAPTURED_CELL(x, y) = CAPTURED_CELL(x + 1, y) ? CAPTURED_CELL(x + 1, y)->Left : 0;
+        for (int x = w; x <= w + 1; x++)
+            CAPTURED_CELL(x, y) = CAPTURED_CELL(x - 1, y) ? CAPTURED_CELL(x - 1, y)->Right : 0;
+    }
+    for (int x = -2; x <= w + 1; x++)
+    {
+        CAPTURED_CELL(x, -1) = CAPTURED_CELL(x, 0) ? CAPTURED_CELL(x, 0)->Top : 0;
+
+        for (int y = h; y <= h + PATHWALK_MAXJUMP; y++)
+            CAPTURED_CELL(x, y) = CAPTURED_CELL(x, y - 1) ? CAPTURED_CELL(x, y - 1)->Bottom : 0;
+    }
+
+    for (int y = -1; y <= h + PATHWALK_MAXJUMP; y++)
+        for (int x = -2; x <= w + 1; x++)
+            graph.SetCell(x, y, GetPathWalkCell(CAPTURED_CELL(x, y)));
+
+#undef CAPTURED_CELL
+}
+
+void PathWalkGraphs::HandleUpdate(StringHash eventType, VariantMap& eventData)
+{
+    if (!pending_.Size())
+        return;
+
+    URHO3D_PROFILE(PathWalkGraphs);
+
+    WorkQueue* queue = GameContext::Get().gameWorkQueue_;
+
+    unsigned numlaunched = 0;
+    while (pending_.Size() && numlaunched < PATHWALK_MAXLAUNCH)
+    {
+        PathWalkMap* wmap = pending_.Back();
+        pending_.Pop();
+
+        // the graph is requested again when the map becomes available
+        Map* map = World2D::GetAvailableMapAt(ShortIntVector2(wmap->mx_, wmap->my_));
+        if (!map || wmap->state_ != PWG_None)
+            continue;
+
+        Capture(*wmap, map);
+        wmap->dirty_ = false;
+        numlaunched++;
+
+        if (!queue)
+        {
+            wmap->graph_.Build();
+            wmap->state_ = PWG_Ready;
+            numBuilt_++;
+            continue;
+        }
+
+        wmap->state_ = PWG_Building;
+        wmap->finished_.store(false, std::memory_order_relaxed);
+        building_.Push(wmap);
+
+        wmap->item_ = queue->GetFreeItem();
+        wmap->item_->sendEvent_ = true;
+        wmap->item_->priority_ = PATHWALK_WORKITEM_PRIORITY;
+        wmap->item_->workFunction_ = PathWalkGraphThread;
+        wmap->item_->aux_ = wmap;
+        queue->AddWorkItem(wmap->item_);
+    }
+}
+
+void PathWalkGraphs::HandleMapAvailable(StringHash eventType, VariantMap& eventData)
+{
+    Map* map = static_cast<Map*>(GetEventSender());
+    if (!width_ || !map)
+        return;
+
+    const ShortIntVector2& mpoint = map->GetMapPoint();
+
+    // the new map, and the neighbors for their band
+    GetWalkMap(mpoint.x_, mpoint.y_);
+    for (int my = mpoint.y_ - 1; my <= mpoint.y_ + 1; my++)
+        for (int mx = mpoint.x_ - 1; mx <= mpoint.x_ + 1; mx++)
+            Invalidate(mx, my);
+}
+
+void PathWalkGraphs::HandleWorkItemComplete(StringHash eventType, VariantMap& eventData)
+{
+    using namespace WorkItemCompleted;
+
+    WorkItem* item = static_cast<WorkItem*>(eventData[P_ITEM].GetPtr());
+    if (item->workFunction_ != PathWalkGraphThread)
+        return;
+
+    // the completion of a build cancelled by Clear : the map may have been deleted
+    PathWalkMap* wmap = static_cast<PathWalkMap*>(item->aux_);
+    PODVector<PathWalkMap*>::Iterator it = building_.Find(wmap);
+    if (it == building_.End() || wmap->item_.Get() != item)
+        return;
+
+    building_.Erase(it);
+    wmap->item_.Reset();
+
+    // a tile has changed during the build : capture again
+    if (wmap->dirty_)
+    {
+        wmap->state_ = PWG_None;
+        pending_.Push(wmap);
+        return;
+    }
+
+    wmap->state_ = PWG_Ready;
+    numBuilt_++;
+
+    URHO3D_LOGDEBUGF("PathWalkGraphs() - HandleWorkItemComplete : map=%d,%d links=%u", wmap->mx_, wmap->my_, wmap->graph_.GetNumLinks());
+}
@@ -507,6 +507,7 @@ Actor::~Actor()
 {
 //    Stop();
     URHO3D_LOGDEBUGF("~Actor() - actorID_=%d", info_.actorID_);
+    EventChannel<GoDestroyEvent>::Get().Unsubscribe(this);
     RemoveActor(info_.actorID_);
 }
 
@@ -1272,7 +1273,9 @@ void Actor::StartSubscribers()
     if (avatar_)
     {
         SubscribeToEvent(avatar_, GOC_LIFEDEAD, URHO3D_HANDLER(Actor, OnDead));
-        SubscribeToEvent(avatar_, GO_DESTROY, URHO3D_HANDLER(Actor, OnDead));
+        // one avatar : drop the listener of the previous avatar
+        EventChannel<GoDestroyEvent>::Get().Unsubscribe(this);
+        EventChannel<GoDestroyEvent>::Get().Subscribe<Actor, &Actor::OnAvatarDestroy>(this, avatar_);
 
         SubscribeToEvent(this, DIALOG_DETECTED, URHO3D_HANDLER(Actor, OnDialogueDetected));
         SubscribeToEvent(this, DIALOG_OPEN, URHO3D_HANDLER(Actor, OnTalkBegin));
@@ -1286,6 +1289,7 @@ void Actor::StartSubscribers()
 void Actor::StopSubscribers()
 {
     UnsubscribeFromAllEvents();
+    EventChannel<GoDestroyEvent>::Get().Unsubscribe(this);
 }
 
 void Actor::OnSceneSet(Scene* scene)
@@ -1442,11 +1446,11 @@ void Actor::OnDead(StringHash eventType, VariantMap& eventData)
 
 //        Actor::RemoveActor(GetID());
     }
+}
 
-    if (eventType == GO_DESTROY)
-    {
-        URHO3D_LOGINFOF("Actor() - OnDead : ... GO_DESTROY");
+void Actor::OnAvatarDestroy(Object* sender, const GoDestroyEvent& event)
+{
+    URHO3D_LOGINFOF("Actor() - OnAvatarDestroy : ... GO_DESTROY");
 
-        Actor::RemoveActor(GetID());
-    }
+    Actor::RemoveActor(GetID());
 }
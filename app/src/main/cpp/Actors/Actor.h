@@ -13,6 +13,8 @@ class Connection;
 
 using namespace Urho3D;
 
+struct GoDestroyEvent;
+
 enum ActorState
 {
     Desactivated = 0,
@@ -212,6 +214,7 @@ protected:
     virtual void OnTalkNext(StringHash eventType, VariantMap& eventData);
     virtual void OnTalkEnd(StringHash eventType, VariantMap& eventData);
     virtual void OnDead(StringHash eventType, VariantMap& eventData);
+    virtual void OnAvatarDestroy(Object* sender, const GoDestroyEvent& event);
 
     ActorInfo info_;
 
@@ -51,6 +51,7 @@
 #include "GameOptionsTest.h"
 
 #include "GameAttributes.h"
+#include "GOABlock.h"
 #include "GameEvents.h"
 #include "GameNetwork.h"
 #include "GameContext.h"
@@ -118,6 +119,8 @@ const char* PanelNames_[] =
 };
 
 
+ComponentUpdater<Player> Player::updater_(UPDATER_Player);
+
 Player::Player(unsigned id) :
     Actor(0, id),
     equipment_(0),
@@ -125,7 +128,8 @@ Player::Player(unsigned id) :
     findSafePlace_(false),
     faction_((unsigned)GO_Player),
     avatarIndex_(0),
-    avatarAccumulatorIndex_(0)
+    avatarAccumulatorIndex_(0),
+    updaterIndex_(M_MAX_UNSIGNED)
 { }
 
 Player::Player(Context* context, unsigned id) :
@@ -135,7 +139,8 @@ Player::Player(Context* context, unsigned id) :
     findSafePlace_(false),
     faction_((unsigned)GO_Player),
     avatarIndex_(0),
-    avatarAccumulatorIndex_(0)
+    avatarAccumulatorIndex_(0),
+    updaterIndex_(M_MAX_UNSIGNED)
 { }
 
 void Player::Reset(Context* context, unsigned id)
@@ -170,6 +175,8 @@ Player::~Player()
 {
     URHO3D_LOGDEBUGF("~Player() - ID=%u ...", GetID());
 
+    updater_.Remove(this);
+
     //Stop();
     if (avatar_)
     {
@@ -2207,7 +2214,9 @@ void Player::StartSubscribers()
 
     SubscribeToEvent(avatar_, GOC_LIFEDEAD, URHO3D_HANDLER(Player, OnDead));
     SubscribeToEvent(avatar_, GO_KILLER, URHO3D_HANDLER(Player, OnDead));
-    SubscribeToEvent(avatar_, GO_DESTROY, URHO3D_HANDLER(Player, OnAvatarDestroy));
+    // one avatar : drop the listener of the previous avatar
+    EventChannel<GoDestroyEvent>::Get().Unsubscribe(this);
+    EventChannel<GoDestroyEvent>::Get().Subscribe<Player, &Player::OnAvatarDestroy>(this, avatar_);
 
     SubscribeToEvent(avatar_, GO_INVENTORYEMPTY, URHO3D_HANDLER(Player, OnInventoryEmpty));
     SubscribeToEvent(avatar_, GO_COLLECTABLEDROP, URHO3D_HANDLER(Player, OnDropCollectable));
@@ -2256,7 +2265,7 @@ void Player::StartSubscribers()
         (!GameContext::Get().ServerMode_ && (gocController->GetControllerType() & GO_Player)))
         SubscribeToEvent(avatar_, GO_SELECTED, URHO3D_HANDLER(Player, OnEntitySelection));
 
-    SubscribeToEvent(E_SCENEPOSTUPDATE, URHO3D_HANDLER(Player, OnPostUpdate));
+    updater_.Add(this);
 }
 
 void Player::StopSubscribers()
@@ -2318,7 +2327,7 @@ void Player::StopSubscribers()
     if (avatar_ && gocController)
         UnsubscribeFromEvent(avatar_, GO_SELECTED);
 
-    UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+    updater_.Remove(this);
 
     URHO3D_LOGINFOF("Player() - StopSubscribers : player ID=%u nodeID=%u avatar=%u ... OK !", GetID(), nodeID_, avatar_.Get());
 }
@@ -2363,7 +2372,7 @@ void Player::OnFire2(StringHash eventType, VariantMap& eventData)
         }
 
         Vector2 wpoint = abi == ABI_WallBreaker::GetTypeStatic() || abi == ABI_AnimShooter::GetTypeStatic() ? Vector2::ZERO :
-                         avatar_->GetWorldPosition2D() + 1.1f * avatar_->GetVar(GOA::DIRECTION).GetVector2();
+                         avatar_->GetWorldPosition2D() + 1.1f * GOABlock::GetDirection(avatar_);
 
         if (abi == ABI_WallBreaker::GetTypeStatic())
         {
@@ -2571,7 +2580,7 @@ void Player::OnChangeEntityFocus(StringHash eventType, VariantMap& eventData)
     }
 }
 
-void Player::OnPostUpdate(StringHash eventType, VariantMap& eventData)
+void Player::Update(float timeStep)
 {
     // Update the Change of Avatar if dirtyPlayer_
     UpdateAvatar();
@@ -2600,7 +2609,7 @@ void Player::OnCollideWall(StringHash eventType, VariantMap& eventData)
         else if (walltype == Wall_Roof)
             ability->Use(avatar_->GetWorldPosition2D() + Vector2::UP);
         else
-            ability->Use(avatar_->GetWorldPosition2D() + avatar_->GetVar(GOA::DIRECTION).GetVector2());
+            ability->Use(avatar_->GetWorldPosition2D() + GOABlock::GetDirection(avatar_));
     }
 }
 
@@ -2661,7 +2670,7 @@ void Player::OnDead(StringHash eventType, VariantMap& eventData)
     }
 }
 
-void Player::OnAvatarDestroy(StringHash eventType, VariantMap& eventData)
+void Player::OnAvatarDestroy(Object* sender, const GoDestroyEvent& event)
 {
     URHO3D_LOGINFOF("Player() - OnAvatarDestroy  : Avatar Node=%u ... ", nodeID_);
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Actor.h"
+#include "ComponentUpdater.h"
 
 namespace Urho3D
 {
@@ -149,9 +150,10 @@ public :
 
     void DrawDebugGeometry(DebugRenderer* debugRenderer) const;
 
-protected :
+    /// Called each frame by the updater between StartSubscribers and StopSubscribers
+    void Update(float timeStep);
 
-    void OnPostUpdate(StringHash eventType, VariantMap& eventData);
+protected :
 
     void OnFire1(StringHash eventType, VariantMap& eventData);
     void OnFire2(StringHash eventType, VariantMap& eventData);
@@ -161,7 +163,7 @@ protected :
     void OnInteract(StringHash eventType, VariantMap& eventData);
     void OnChangeEntityFocus(StringHash eventType, VariantMap& eventData);
     void OnCollideWall(StringHash eventType, VariantMap& eventData);
-    void OnAvatarDestroy(StringHash eventType, VariantMap& eventData);
+    virtual void OnAvatarDestroy(Object* sender, const GoDestroyEvent& event);
     void OnInventoryEmpty(StringHash eventType, VariantMap& eventData);
     void OnGetCollectable(StringHash eventType, VariantMap& eventData);
     void OnStartTransferCollectable(StringHash eventlights_Type, VariantMap& eventData);
@@ -179,6 +181,8 @@ protected :
     virtual void OnDead(StringHash eventType, VariantMap& eventData);
 
 private :
+    friend class ComponentUpdater<Player>;
+
     void CreateUI(UIElement* root, bool multiLocalPlayerMode);
     void ResetUI();
 
@@ -216,4 +220,7 @@ private :
 
     Vector<int> avatars_;
     PODVector<Light*> lights_;
+
+    unsigned updaterIndex_;
+    static ComponentUpdater<Player> updater_;
 };
@@ -0,0 +1,36 @@
+#include "ComponentUpdater.h"
+
+
+unsigned ComponentUpdaterBase::numUpdated_ = 0;
+
+// not a static member : the updaters are static members of the components, constructed in any order
+PODVector<ComponentUpdaterBase*>& ComponentUpdaterBase::GetUpdaters()
+{
+    static PODVector<ComponentUpdaterBase*> updaters;
+    return updaters;
+}
+
+ComponentUpdaterBase::ComponentUpdaterBase(int order) :
+    order_(order)
+{
+    // keep the updaters sorted by order
+    PODVector<ComponentUpdaterBase*>& updaters = GetUpdaters();
+    unsigned i = 0;
+    while (i < updaters.Size() && updaters[i]->order_ <= order)
+        i++;
+    updaters.Insert(i, this);
+}
+
+ComponentUpdaterBase::~ComponentUpdaterBase()
+{
+    GetUpdaters().Remove(this);
+}
+
+void ComponentUpdaterBase::UpdateAll(float timeStep)
+{
+    numUpdated_ = 0;
+
+    PODVector<ComponentUpdaterBase*>& updaters = GetUpdaters();
+    for (unsigned i = 0; i < updaters.Size(); i++)
+        updaters[i]->Update(timeStep);
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Math/MathDefs.h>
+
+using namespace Urho3D;
+
+
+/// ComponentUpdater : the active components of a type in a contiguous list, updated by a typed Update(float timeStep)
+/// in one pass at the E_SCENEPOSTUPDATE of the root scene (see GameContext::HandleUpdateComponents),
+/// instead of one E_SCENEPOSTUPDATE handler by component.
+/// The component is added when it would have subscribed to E_SCENEPOSTUPDATE and removed when it would have unsubscribed.
+/// GOC_AIController has no updater : AIManager runs the AI updates in phases (see AIManager::HandlePostUpdate).
+
+// the updaters run in this order
+enum ComponentUpdaterOrder
+{
+    UPDATER_Spawner = 0,
+    UPDATER_Move2D,
+    UPDATER_Destroyer,
+    UPDATER_Animator2D,
+    UPDATER_BodyExploder2D,
+    UPDATER_Life,
+    UPDATER_DropZone,
+    UPDATER_Player
+};
+
+class ComponentUpdaterBase
+{
+public:
+    ComponentUpdaterBase(int order);
+    virtual ~ComponentUpdaterBase();
+
+    virtual void Update(float timeStep) = 0;
+    virtual unsigned GetNumComponents() const = 0;
+
+    int GetOrder() const
+    {
+        return order_;
+    }
+
+    /// Update the components of all the updaters
+    static void UpdateAll(float timeStep);
+    /// The number of components updated in the last pass
+    static unsigned GetNumUpdated()
+    {
+        return numUpdated_;
+    }
+
+protected:
+    static unsigned numUpdated_;
+
+private:
+    static PODVector<ComponentUpdaterBase*>& GetUpdaters();
+
+    int order_;
+};
+
+/// T has an "unsigned updaterIndex_" initialized to M_MAX_UNSIGNED and a "void Update(float timeStep)".
+template <class T> class ComponentUpdater : public ComponentUpdaterBase
+{
+public:
+    ComponentUpdater(int order) :
+        ComponentUpdaterBase(order),
+        numHoles_(0),
+        updating_(false) { }
+
+    void Add(T* component)
+    {
+        if (component->updaterIndex_ != M_MAX_UNSIGNED)
+            return;
+
+        component->updaterIndex_ = components_.Size();
+        components_.Push(component);
+    }
+    void Remove(T* component)
+    {
+        const unsigned index = component->updaterIndex_;
+        if (index == M_MAX_UNSIGNED)
+            return;
+
+        component->updaterIndex_ = M_MAX_UNSIGNED;
+
+        // in the pass : let a hole, the list is compacted at the end of the pass
+        if (updating_)
+        {
+            components_[index] = 0;
+            numHoles_++;
+        }
+        else
+        {
+            RemoveAt(index);
+        }
+    }
+    bool Contains(const T* component) const
+    {
+        return component->updaterIndex_ != M_MAX_UNSIGNED;
+    }
+
+    virtual void Update(float timeStep)
+    {
+        updating_ = true;
+
+        // the components added in the pass are updated in the pass
+        for (unsigned i = 0; i < components_.Size(); i++)
+        {
+            T* component = components_[i];
+            if (component)
+            {
+                component->Update(timeStep);
+                numUpdated_++;
+            }
+        }
+
+        updating_ = false;
+
+        if (numHoles_)
+            Compact();
+    }
+    virtual unsigned GetNumComponents() const
+    {
+        return components_.Size() - numHoles_;
+    }
+
+private:
+    void RemoveAt(unsigned index)
+    {
+        // move the last component in the hole
+        T* last = components_.Back();
+        components_[index] = last;
+        if (last)
+            last->updaterIndex_ = index;
+        components_.Pop();
+    }
+    void Compact()
+    {
+        unsigned i = 0;
+        while (i < components_.Size())
+        {
+            if (!components_[i])
+                RemoveAt(i);
+            else
+                i++;
+        }
+        numHoles_ = 0;
+    }
+
+    PODVector<T*> components_;
+    unsigned numHoles_;
+    bool updating_;
+};
@@ -24,6 +24,7 @@
 #include "GameEvents.h"
 #include "GameContext.h"
 #include "GameNetwork.h"
+#include "GOABlock.h"
 
 #include "GOC_Abilities.h"
 #include "CommonComponents.h"
@@ -687,6 +688,7 @@ enum AnimationAlignement
 };
 
 unsigned GOC_Animator2D::sFirstSpecificStateIndex_;
+ComponentUpdater<GOC_Animator2D> GOC_Animator2D::updater_(UPDATER_Animator2D);
 
 GOC_Animator2D::GOC_Animator2D(Context* context) :
     Component(context),
@@ -696,6 +698,7 @@ GOC_Animator2D::GOC_Animator2D(Context* context) :
     currentState(0),
     currentStateTime(0),
     forceNextState(0),
+    goa_(0),
     customTemplate(false),
     autoSwitchAnimation_(false),
     subscribeOk_(false),
@@ -703,7 +706,8 @@ GOC_Animator2D::GOC_Animator2D(Context* context) :
     followOwnerY_(false),
     alignment_(0),
     forceAnimVersion_(-1),
-    spawnEntityMode_(SPAWNENTITY_ALWAYS)
+    spawnEntityMode_(SPAWNENTITY_ALWAYS),
+    updaterIndex_(M_MAX_UNSIGNED)
 {
     eventActions_.Resize(NumEventSenderType);
 }
@@ -712,9 +716,12 @@ GOC_Animator2D::~GOC_Animator2D()
 {
 //    URHO3D_LOGDEBUG("~GOC_Animator2D()");
 
+    updater_.Remove(this);
     Stop();
 
     ClearCustomTemplate();
+
+    GOABlock::Release(goa_);
 }
 
 void GOC_Animator2D::RegisterObject(Context* context)
@@ -1069,7 +1076,7 @@ void GOC_Animator2D::SetDirection(const Vector2& dir)
 #endif
 
         // notify
-        node_->SetVar(GOA::DIRECTION, direction);
+        goa_->SetDirection(direction);
 
         MarkNetworkUpdate();
     }
@@ -1380,7 +1387,7 @@ void GOC_Animator2D::Start()
     //        URHO3D_LOGINFOF("GOC_Animator2D() - Start : %s(%u) Net Controlled Mode !", node_->GetName().CString(), node_->GetID());
     */
     if (GetScene())
-        SubscribeToEvent(GetScene(), E_SCENEPOSTUPDATE, URHO3D_HANDLER(GOC_Animator2D, OnUpdate));
+        updater_.Add(this);
 
 #ifdef ACTIVE_NETWORK_SERVERRECONCILIATION
     if (controller_ && (controller_->IsMainController() || GameContext::Get().ServerMode_))
@@ -1453,6 +1460,7 @@ void GOC_Animator2D::Stop()
 
     owner_.Reset();
     UnsubscribeFromAllEvents();
+    updater_.Remove(this);
 
     if (node_->GetParent() != GameContext::Get().preloadGOTNode_ && animatedSprite && animatedSprite->GetComponent<AnimatedSprite2D>() == animatedSprite && !animatedSprite->GetRenderTargetAttr().Empty())
     {
@@ -1569,8 +1577,10 @@ void GOC_Animator2D::CheckAttributes()
     // Direction
     if (direction.x_ == 0.f)
     {
-        if (node_->GetVar(GOA::DIRECTION) != Variant::EMPTY && node_->GetVar(GOA::DIRECTION).GetVector2().x_ != 0.f)
-            SetDirection(node_->GetVar(GOA::DIRECTION).GetVector2());
+        // the direction can be set in the node variables by the spawner
+        goa_->Load(GOAB_Direction);
+        if (goa_->GetDirection().x_ != 0.f)
+            SetDirection(goa_->GetDirection());
         else
             SetDirection(Vector2(1.f, 0.f));
     }
@@ -1637,8 +1647,16 @@ void GOC_Animator2D::OnNodeSet(Node* node)
 //        gocSound = node->GetComponent<GOC_SoundEmitter>();
         gocmove_ = node_->GetComponent<GOC_Move2D>();
 
+        if (!goa_)
+            goa_ = GOABlock::Acquire(node);
+
 //        URHO3D_LOGINFOF("GOC_Animator2D() - OnNodeSet : Node=%s(%u) ... OK !", node->GetName().CString(), node->GetID());
     }
+    else
+    {
+        GOABlock::Release(goa_);
+        goa_ = 0;
+    }
 }
 
 void GOC_Animator2D::OnComponentChanged(StringHash eventType, VariantMap& eventData)
@@ -1722,9 +1740,9 @@ void GOC_Animator2D::OnEventActions(StringHash eventType, VariantMap& eventData)
 
 #define PARTICULE_INACTIVEDELAY 0.2f
 
-void GOC_Animator2D::OnUpdate(StringHash eventType, VariantMap& eventData)
+void GOC_Animator2D::Update(float timestep)
 {
-    timeStep = eventData[SceneUpdate::P_TIMESTEP].GetFloat();
+    timeStep = timestep;
 
 //    URHO3D_PROFILE(GOC_Animator2D);
     delayParticule += timeStep;
@@ -1741,7 +1759,8 @@ void GOC_Animator2D::OnChangeDirection(StringHash eventType, VariantMap& eventDa
     if (controller_->control_.direction_ == 0.f)
     {
         direction.y_ = 0.f;
-        float dirx = direction.x_ != 0.f ? direction.x_ : node_->GetVar(GOA::DIRECTION) != Variant::EMPTY ? node_->GetVar(GOA::DIRECTION).GetVector2().x_ : 0.f;
+        goa_->Load(GOAB_Direction);
+        float dirx = direction.x_ != 0.f ? direction.x_ : goa_->GetDirection().x_;
         controller_->control_.direction_ = dirx != 0.f ? dirx : (Random(100) < 50 ? -1.f : 1.f);
     }
 
@@ -2123,7 +2142,7 @@ bool GOC_Animator2D::UpdateDirection()
     if (!controller_)
         return false;
 
-    unsigned moveState = node_->GetVar(GOA::MOVESTATE).GetUInt();
+    unsigned moveState = goa_->GetMoveState();
     bool reverseflip = false;
 
     // Update Climbing direction
@@ -2281,7 +2300,7 @@ bool GOC_Animator2D::UpdateDirection()
                 (*it)->SetFlipX(physicFlipX_);
 
         // notify
-        node_->SetVar(GOA::DIRECTION, direction);
+        goa_->SetDirection(direction);
         MarkNetworkUpdate();
     }
 
@@ -2503,7 +2522,7 @@ inline void GOC_Animator2D::NotifyCurrentState()
 
 void GOC_Animator2D::Update()
 {
-    unsigned moveState = node_->GetVar(GOA::MOVESTATE).GetUInt();
+    unsigned moveState = goa_->GetMoveState();
 
 //    URHO3D_LOGINFOF("GOC_Animator2D() - Update : node=%s(%u) movestate=%s(%u) ...", node_->GetName().CString(), node_->GetID(), GameHelpers::GetMoveStateString(moveState).CString());
     if (moveState)
@@ -2757,7 +2776,7 @@ inline void GOC_Animator2D::Dispatch(const StringHash& event, const VariantMap&
 
 inline void GOC_Animator2D::FindNextState(const VariantMap& param)
 {
-    unsigned moveState = node_->GetVar(GOA::MOVESTATE).GetUInt();
+    unsigned moveState = goa_->GetMoveState();
 
     if (!forceNextState)
     {
@@ -3434,9 +3453,8 @@ void GOC_Animator2D::ToDestroy(const VariantMap& param)
     else
     {
 //        URHO3D_LOGINFOF("GOC_Animator2D() - ToDestroy : Node=%s(%u) Send GO_DESTROY", node_->GetName().CString(), node_->GetID());
-        VariantMap& eventData = context_->GetEventDataMap();
-        eventData[Go_Destroy::GO_PTR] = node_;
-        node_->SendEvent(GO_DESTROY, eventData);
+        GoDestroyEvent event = { 0, GO_None, 0, M_MAX_UNSIGNED, node_ };
+        EventChannel<GoDestroyEvent>::Get().Send(node_, event);
     }
     toDisappearCounter_ = -1;
 }
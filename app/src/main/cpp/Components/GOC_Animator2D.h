@@ -16,6 +16,7 @@ using namespace Urho3D;
 class GOC_Move2D;
 class GOC_Controller;
 class GOC_Abilities;
+class GOABlock;
 class GOC_Animator2D;
 
 //#include "TimerRemover.h"
@@ -24,6 +25,8 @@ class GOC_Animator2D;
 #include "GameHelpers.h"
 #include "GameEvents.h"
 
+#include "ComponentUpdater.h"
+
 struct GOC_Animator2D_Template;
 
 enum EventSenderType
@@ -321,6 +324,8 @@ public:
 
     void Start();
     void Stop();
+    /// Called each frame by the updater
+    void Update(float timestep);
     void ResetState();
 
     bool PlugDrawables();
@@ -355,11 +360,12 @@ protected :
     virtual void OnNodeSet(Node* node);
 
 private :
+    friend class ComponentUpdater<GOC_Animator2D>;
+
     /// Handler
     void OnComponentChanged(StringHash eventType, VariantMap& eventData);
     void OnEvent(StringHash eventType, VariantMap& eventData);
     void OnEventActions(StringHash eventType, VariantMap& eventData);
-    void OnUpdate(StringHash eventType, VariantMap& eventData);
     void OnChangeDirection(StringHash eventType, VariantMap& eventData);
     void OnUpdateDirection(StringHash eventType, VariantMap& eventData);
     void OnChangeState(StringHash eventType, VariantMap& eventData);
@@ -419,6 +425,7 @@ private :
     WeakPtr<Node> owner_;
     WeakPtr<GOC_Abilities> abilities_;
     GOC_Move2D* gocmove_;
+    GOABlock* goa_;
 
     bool customTemplate;
     bool autoSwitchAnimation_;
@@ -448,7 +455,10 @@ private :
 
     Vector<HashMap<StringHash, Actions> > eventActions_;
 
+    unsigned updaterIndex_;
+
     static unsigned sFirstSpecificStateIndex_;
+    static ComponentUpdater<GOC_Animator2D> updater_;
 };
 
 
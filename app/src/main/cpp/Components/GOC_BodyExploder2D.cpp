@@ -43,6 +43,8 @@
 #include "GOC_BodyExploder2D.h"
 
 
+ComponentUpdater<GOC_BodyExploder2D> GOC_BodyExploder2D::updater_(UPDATER_BodyExploder2D);
+
 GOC_BodyExploder2D::GOC_BodyExploder2D(Context* context) :
     Component(context),
     numExplodedNodes_(0),
@@ -58,7 +60,8 @@ GOC_BodyExploder2D::GOC_BodyExploder2D(Context* context) :
     prepared_(false),
     hideOriginalBody_(false),
     useScrapsEmitter_(false),
-    useObjectPool_(true)
+    useObjectPool_(true),
+    updaterIndex_(M_MAX_UNSIGNED)
 { ; }
 
 GOC_BodyExploder2D::~GOC_BodyExploder2D()
@@ -66,6 +69,7 @@ GOC_BodyExploder2D::~GOC_BodyExploder2D()
 //    URHO3D_LOGDEBUG("~GOC_BodyExploder2D()");
 
     UnsubscribeFromAllEvents();
+    updater_.Remove(this);
 #ifdef ACTIVE_POOL
     if (useObjectPool_)
         return;
@@ -795,7 +799,10 @@ void GOC_BodyExploder2D::OnTrigEvent(StringHash eventType, VariantMap& eventData
     impulseTimer_ = 0.f;
 
     if (hideOriginalBody_)
-        SubscribeToEvent(GetScene(), E_SCENEPOSTUPDATE, URHO3D_HANDLER(GOC_BodyExploder2D, HandleWaitStateForHide));
+    {
+        if (GetScene())
+            updater_.Add(this);
+    }
     else
         Explode();
 }
@@ -803,21 +810,21 @@ void GOC_BodyExploder2D::OnTrigEvent(StringHash eventType, VariantMap& eventData
 // delai necessaire pour que GOC_Animator2D reagisse a l'event Dead avant le BodyExploder
 // autrement affichage des deux bodies (le setenabled ne servant a rien ici dans ce cas,
 // car reactiver juste apres par l'Animator)
-void GOC_BodyExploder2D::HandleWaitStateForHide(StringHash eventType, VariantMap& eventData)
+void GOC_BodyExploder2D::Update(float timeStep)
 {
-//    URHO3D_LOGINFOF("GOC_BodyExploder2D() - HandleWaitStateForHide : node=%s(%u) ...", node_->GetName().CString(), node_->GetID());
+//    URHO3D_LOGINFOF("GOC_BodyExploder2D() - Update : wait state for hide node=%s(%u) ...", node_->GetName().CString(), node_->GetID());
 
     if (!node_->IsEnabled())
     {
-        UnsubscribeFromEvent(GetScene(), E_SCENEPOSTUPDATE);
+        updater_.Remove(this);
         return;
     }
 
     if (GetComponent<GOC_Animator2D>()->GetStateValue().Value() == STATE_EXPLODE)
     {
-//        URHO3D_LOGINFOF("GOC_BodyExploder2D() - HandleWaitStateForHide : node=%s(%u) ... OK !", node_->GetName().CString(), node_->GetID());
+//        URHO3D_LOGINFOF("GOC_BodyExploder2D() - Update : wait state for hide node=%s(%u) ... OK !", node_->GetName().CString(), node_->GetID());
 
-        UnsubscribeFromEvent(GetScene(), E_SCENEPOSTUPDATE);
+        updater_.Remove(this);
 
         // after waiting for Dead State => hide drawable and inactive physics
         node_->GetDerivedComponent<Drawable2D>()->SetEnabled(false);
@@ -2,6 +2,8 @@
 
 #include <Urho3D/Scene/Component.h>
 
+#include "ComponentUpdater.h"
+
 namespace Urho3D
 {
 struct SpriteInfo;
@@ -85,9 +87,13 @@ public :
 
     void DrawDebugGeometry(DebugRenderer* debug, bool depthTest);
 
+    /// Called each frame by the updater while waiting for the explode state before hiding the body
+    void Update(float timeStep);
+
 private :
+    friend class ComponentUpdater<GOC_BodyExploder2D>;
+
     void OnTrigEvent(StringHash eventType, VariantMap& eventData);
-    void HandleWaitStateForHide(StringHash eventType, VariantMap& eventData);
 
     bool SetStateToExplode(AnimatedSprite2D* animatedSprite, String& restoreAnimation);
     void PrepareExplodedNodes(AnimatedSprite2D* animatedSprite);
@@ -127,6 +133,9 @@ private :
     bool hideOriginalBody_;
     bool useScrapsEmitter_;
     bool useObjectPool_;
+
+    unsigned updaterIndex_;
+    static ComponentUpdater<GOC_BodyExploder2D> updater_;
 };
 
 
@@ -453,11 +453,8 @@ void GOC_Collectable::HandleEmpty(StringHash eventType, VariantMap& data)
         return;
     }
 
-    VariantMap eventData;
-    eventData[Go_Destroy::GO_ID] = GetNode()->GetID();
-    eventData[Go_Destroy::GO_TYPE] = GetNode()->GetVar(GOA::TYPECONTROLLER).GetInt();
-    eventData[Go_Destroy::GO_MAP] = GetNode()->GetVar(GOA::ONMAP).GetUInt();
-    node_->SendEvent(GO_DESTROY, eventData);
+    GoDestroyEvent event = { node_->GetID(), node_->GetVar(GOA::TYPECONTROLLER).GetInt(), node_->GetVar(GOA::ONMAP).GetUInt(), M_MAX_UNSIGNED, 0 };
+    EventChannel<GoDestroyEvent>::Get().Send(node_, event);
 }
 
 
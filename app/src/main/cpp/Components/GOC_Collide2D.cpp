@@ -26,6 +26,7 @@
 
 #include "MAN_Effects.h"
 #include "MapWorld.h"
+#include "MapContactRegistry.h"
 #include "ViewManager.h"
 #include "Actor.h"
 #include "Player.h"
@@ -52,7 +53,9 @@ GOC_Collide2D::GOC_Collide2D(Context* context) :
 { }
 
 GOC_Collide2D::~GOC_Collide2D()
-{ }
+{
+    MapContactRegistry::Get().RemoveCollider(this);
+}
 
 void GOC_Collide2D::OnSetEnabled()
 {
@@ -161,6 +164,7 @@ void GOC_Collide2D::ClearContacts()
 #else
 //    URHO3D_LOGINFOF("GOC_Collide2D() - ClearContacts : Node=%s(%u) ... clear contacts !", node_->GetName().CString(), node_->GetID());
     wallContacts.Clear();
+    MapContactRegistry::Get().RemoveCollider(this);
 #endif
     numGroundContacts_ = 0;
     lastVictim_.Reset();
@@ -299,10 +303,10 @@ void GOC_Collide2D::AddWallContact2D(CollisionShape2D* cs, unsigned ishape, cons
             }
         }
         else
-            wallContacts += Pair<unsigned, WallContact>(wallContactRef, WallContact(walltype, 1));
+            wallContacts += Pair<unsigned, WallContact>(wallContactRef, WallContact(walltype, 1, cs));
     }
     else
-        wallContacts += Pair<unsigned, WallContact>(wallContactRef, WallContact(walltype, 1));
+        wallContacts += Pair<unsigned, WallContact>(wallContactRef, WallContact(walltype, 1, cs));
 
     /*
         if (walltype == Wall_Ground && !numGroundContacts_)
@@ -337,7 +341,7 @@ void GOC_Collide2D::AddWallContact2D(CollisionShape2D* cs, unsigned ishape, cons
     */
 
     if (newContact)
-        SubscribeToEvent(cs, MAPTILEREMOVED, URHO3D_HANDLER(GOC_Collide2D, HandleBreakContact));
+        MapContactRegistry::Get().AddContact(cs, this);
 
     if (newContact)
     {
@@ -409,7 +413,7 @@ void GOC_Collide2D::RemoveWallContact2D(CollisionShape2D* cs, unsigned ishape)
 //                numGroundContacts_--;
 
             wallContacts.Erase(it);
-            UnsubscribeFromEvent(cs, MAPTILEREMOVED);
+            MapContactRegistry::Get().RemoveContact(cs, this);
         }
     }
 
@@ -874,43 +878,86 @@ void GOC_Collide2D::HandleEndContact(StringHash eventType, VariantMap& eventData
     }
 }
 
-void GOC_Collide2D::HandleBreakContact(StringHash eventType, VariantMap& eventData)
+void GOC_Collide2D::BreakContactsOnTile(CollisionShape2D* shape, const Rect& tilerect)
 {
 #if (WALLCONTACTMODE == 1)
-    CollisionShape2D* cs = (CollisionShape2D*)GetEventSender();
+    if (shape->IsTrigger())
+        return;
 
-    if (!cs->IsTrigger())
+    PODVector<GOC_Collide2D*> colliders;
+    MapContactRegistry::Get().GetColliders(shape, colliders);
+    if (!colliders.Size())
+        return;
+
+    b2AABB tileaabb;
+    tileaabb.lowerBound.Set(tilerect.min_.x_, tilerect.min_.y_);
+    tileaabb.upperBound.Set(tilerect.max_.x_, tilerect.max_.y_);
+
+    // only the colliders on the tile : the others keep their contacts with the shape
+    for (unsigned i = 0; i < colliders.Size(); i++)
     {
-        /// TODO : check the tile where the node is hanged on, if same remove the contacts
-        WallType walltype;
+        GOC_Collide2D* collider = colliders[i];
+        b2Body* b2body = collider->body ? collider->body->GetBody() : 0;
+        if (!b2body)
+            continue;
 
-        HashMap<unsigned, WallContact>::Iterator it = wallContacts.Begin();
-        while (it != wallContacts.End())
+        for (b2Fixture* fixture = b2body->GetFixtureList(); fixture; fixture = fixture->GetNext())
         {
-            if (CompareHash(cs, it->first_))
-            {
-                walltype = it->second_.type_;
-                it = wallContacts.Erase(it);
+            if (fixture->IsSensor())
                 continue;
+
+            b2AABB aabb;
+            fixture->GetShape()->ComputeAABB(&aabb, b2body->GetTransform(), 0);
+            if (b2TestOverlap(aabb, tileaabb))
+            {
+                collider->BreakContacts(shape);
+                break;
             }
-            ++it;
         }
+    }
+#endif
+}
 
-        UnsubscribeFromEvent(cs, MAPTILEREMOVED);
+void GOC_Collide2D::BreakContacts(CollisionShape2D* cs)
+{
+#if (WALLCONTACTMODE == 1)
+    WallType walltype = Wall_Border;
+    int numgroundcontacts = 0;
+    bool removed = false;
 
-        if (walltype == Wall_Ground)
-            //if (walltype == Wall_Ground && numGroundContacts_ > 0)
-            numGroundContacts_--;
+    HashMap<unsigned, WallContact>::Iterator it = wallContacts.Begin();
+    while (it != wallContacts.End())
+    {
+        if (it->second_.shape_ == cs)
+        {
+            walltype = it->second_.type_;
+            if (walltype == Wall_Ground)
+                numgroundcontacts++;
+            it = wallContacts.Erase(it);
+            removed = true;
+            continue;
+        }
+        ++it;
+    }
 
-    #ifdef DUMP_DEBUG_MAPCOLLIDEUPDATE
-        URHO3D_LOGINFOF("GOC_Collide2D() - HandleBreakContact : %s(%u) Remove WallContact with cs=%u numgrd=%d ",
-                        GetNode()->GetName().CString(), GetNode()->GetID(), cs, numGroundContacts_);
-    #endif
+    MapContactRegistry::Get().RemoveContact(cs, this, true);
 
-        GOC_Move2D* gocmove = node_->GetComponent<GOC_Move2D>();
-        if (gocmove)
-            gocmove->OnWallContactEnd(walltype, numGroundContacts_, wallContacts.Size());
-    }
+    if (!removed)
+        return;
+
+    numGroundContacts_ = Max(numGroundContacts_ - numgroundcontacts, 0);
+
+    // a sleeping body on the removed tile falls
+    body->SetAwake(true);
+
+#ifdef DUMP_DEBUG_MAPCOLLIDEUPDATE
+    URHO3D_LOGINFOF("GOC_Collide2D() - BreakContacts : %s(%u) Remove WallContact with cs=%u numgrd=%d ",
+                    GetNode()->GetName().CString(), GetNode()->GetID(), cs, numGroundContacts_);
+#endif
+
+    GOC_Move2D* gocmove = node_->GetComponent<GOC_Move2D>();
+    if (gocmove)
+        gocmove->OnWallContactEnd(walltype, numGroundContacts_, wallContacts.Size());
 #endif
 }
 
@@ -940,6 +987,8 @@ void GOC_Collide2D::OnBreakGroundContacts(StringHash eventType, VariantMap& even
     {
         if (it->second_.type_ == Wall_Ground)
         {
+            if (it->second_.shape_)
+                MapContactRegistry::Get().RemoveContact(it->second_.shape_, this);
             it = wallContacts.Erase(it);
             continue;
         }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Urho3D/Math/Rect.h>
 #include <Urho3D/Scene/Component.h>
 
 #include "ShortIntVector2.h"
@@ -17,12 +18,14 @@ using namespace Urho3D;
 
 struct WallContact
 {
-    WallContact() : type_(Wall_Ground), count_(1) { }
-    WallContact(WallType type, unsigned char count) : type_(type), count_(count) { }
-    WallContact(const WallContact& wc) : type_(wc.type_), count_(wc.count_) { }
+    WallContact() : type_(Wall_Ground), count_(1), shape_(0) { }
+    WallContact(WallType type, unsigned char count, CollisionShape2D* shape=0) : type_(type), count_(count), shape_(shape) { }
+    WallContact(const WallContact& wc) : type_(wc.type_), count_(wc.count_), shape_(wc.shape_) { }
 
     WallType type_;
     unsigned char count_;
+    // the map shape in contact (see MapContactRegistry)
+    CollisionShape2D* shape_;
 };
 
 #define WALLCONTACTMODE 1
@@ -69,6 +72,9 @@ public :
 
     void DumpContacts();
 
+    /// Break the wall contacts of the colliders in contact with the shape of a removed tile (see MapContactRegistry)
+    static void BreakContactsOnTile(CollisionShape2D* shape, const Rect& tilerect);
+
     RigidBody2D* body;
 
 protected :
@@ -85,7 +91,7 @@ protected :
 #endif
     void HandleBeginContact(StringHash eventType, VariantMap& eventData);
     void HandleEndContact(StringHash eventType, VariantMap& eventData);
-    void HandleBreakContact(StringHash eventType, VariantMap& eventData);
+    void BreakContacts(CollisionShape2D* cs);
     void HandleDead(StringHash eventType, VariantMap& eventData);
 
     void OnBreakGroundContacts(StringHash eventType, VariantMap& eventData);
@@ -17,6 +17,7 @@
 #include "GameEvents.h"
 #include "GameContext.h"
 #include "GameHelpers.h"
+#include "GOABlock.h"
 #include "GameOptions.h"
 
 #include "GOC_Animator2D.h"
@@ -44,6 +45,8 @@ GOC_Controller::GOC_Controller(Context* context) :
     interaction_(false),
     controlType_(GO_None),
     currentIdPath_(-1),
+    pathRequestId_(0),
+    goa_(0),
     thinker_(0),
     lastdesync_(true)
 { }
@@ -55,6 +58,8 @@ GOC_Controller::GOC_Controller(Context* context, int type) :
     interaction_(false),
     controlType_(type),
     currentIdPath_(-1),
+    pathRequestId_(0),
+    goa_(0),
     thinker_(0),
     lastdesync_(true)
 { }
@@ -63,6 +68,7 @@ GOC_Controller::~GOC_Controller()
 {
 //    URHO3D_LOGDEBUG("~GOC_Controller()");
     Stop();
+    GOABlock::Release(goa_);
 }
 
 void GOC_Controller::RegisterObject(Context* context)
@@ -611,21 +617,46 @@ bool GOC_Controller::Update(unsigned buttons, bool forceUpdate)
 void GOC_Controller::FindAndFollowPath(const Vector2& destination)
 {
 #ifdef ACTIVE_PATHFINDER
-    currentIdPath_ = PathFinder2D::FindPath(GetNode()->GetWorldPosition2D(), ViewManager::FRONTVIEW_Index, destination, ViewManager::FRONTVIEW_Index, MV_WALK);
-    if (currentIdPath_ != -1)
-    {
-        currentPath_ = PathFinder2D::GetPath(currentIdPath_);
-        currentIdUserPath_ = PathFinder2D::SetNodeOnPath(currentIdPath_, GetNode());
-        followPath_ = true;
-        noreverse_ = false;
-        lastimpulse_ = false;
-        lastcount_ = 0;
-    }
+    // the path is searched by the work queue : follow it at GO_PATHREQUESTDONE
+    pathRequestId_ = PathFinder2D::RequestPath(GetNode()->GetWorldPosition2D(), ViewManager::FRONTVIEW_Index, destination, ViewManager::FRONTVIEW_Index, MV_WALK, GetNode());
+    if (pathRequestId_)
+        SubscribeToEvent(GetNode(), GO_PATHREQUESTDONE, URHO3D_HANDLER(GOC_Controller, OnPathRequestDone));
+#endif
+}
+
+void GOC_Controller::OnPathRequestDone(StringHash eventType, VariantMap& eventData)
+{
+#ifdef ACTIVE_PATHFINDER
+    // an older request
+    if (eventData[Go_PathRequestDone::GO_PATHREQUESTID].GetUInt() != pathRequestId_)
+        return;
+
+    pathRequestId_ = 0;
+    UnsubscribeFromEvent(GetNode(), GO_PATHREQUESTDONE);
+
+    const int idpath = eventData[Go_PathRequestDone::GO_PATHID].GetInt();
+    if (idpath == -1)
+        return;
+
+    currentIdUserPath_ = PathFinder2D::SetNodeOnPath(idpath, GetNode());
+    if (currentIdUserPath_ == -1)
+        return;
+
+    currentIdPath_ = idpath;
+    currentPath_ = PathFinder2D::GetPath(currentIdPath_);
+    followPath_ = true;
+    noreverse_ = false;
+    lastimpulse_ = false;
+    lastcount_ = 0;
 #endif
 }
 
 void GOC_Controller::StopFollowPath()
 {
+    if (pathRequestId_ && node_)
+        UnsubscribeFromEvent(node_, GO_PATHREQUESTDONE);
+    pathRequestId_ = 0;
+
     currentIdPath_ = -1;
     currentPath_ = 0;
     followPath_ = false;
@@ -669,7 +700,7 @@ void GOC_Controller::UpdateFollowPath()
 #ifdef NOREVERSE
             if (lastimpulse_)
             {
-                node_->SetVar(GOA::KEEPDIRECTION, true);
+                goa_->SetKeepDirection(true);
                 noreverse_ = true;
             }
 #endif
@@ -682,7 +713,7 @@ void GOC_Controller::UpdateFollowPath()
 #ifdef NOREVERSE
             if (lastimpulse_)
             {
-                node_->SetVar(GOA::KEEPDIRECTION, true);
+                goa_->SetKeepDirection(true);
                 noreverse_ = true;
             }
 #endif
@@ -700,7 +731,7 @@ void GOC_Controller::UpdateFollowPath()
 #ifdef NOREVERSE
             if (noreverse_)
             {
-                node_->SetVar(GOA::KEEPDIRECTION, false);
+                goa_->SetKeepDirection(false);
                 node_->SendEvent(GO_CHANGEDIRECTION);
             }
 #endif
@@ -732,7 +763,7 @@ void GOC_Controller::UpdateFollowPath()
     // if near last point and velocity > limit, reverse to init stabilization on point
     if (PathFinder2D::IsOnLastPathSegment(path, index) && p.x_ > -1.f && p.x_ < 1.f)
     {
-        Vector2 vel = node_->GetVar(GOA::VELOCITY).GetVector2();
+        const Vector2& vel = goa_->GetVelocity();
         if (Abs(vel.x_) < 1.5f)
             return;
 
@@ -755,7 +786,7 @@ void GOC_Controller::UpdateFollowPath()
 #ifdef NOREVERSE
             if (lastimpulse_)
             {
-                node_->SetVar(GOA::KEEPDIRECTION, true);
+                goa_->SetKeepDirection(true);
                 noreverse_ = true;
             }
 #endif
@@ -769,7 +800,7 @@ void GOC_Controller::UpdateFollowPath()
 #ifdef NOREVERSE
             if (lastimpulse_)
             {
-                node_->SetVar(GOA::KEEPDIRECTION, true);
+                goa_->SetKeepDirection(true);
                 noreverse_ = true;
             }
 #endif
@@ -806,10 +837,18 @@ void GOC_Controller::OnNodeSet(Node* node)
             node->RemoveComponent(prevGocControl);
         }
 
+        if (!goa_)
+            goa_ = GOABlock::Acquire(node);
+
         SetControllerType(GetControllerType(), true);
 
         OnSetEnabled();
     }
+    else
+    {
+        GOABlock::Release(goa_);
+        goa_ = 0;
+    }
 }
 
 void GOC_Controller::OnMountNodeDead(StringHash eventType, VariantMap& eventData)
@@ -15,6 +15,7 @@ class RigidBody2D;
 using namespace Urho3D;
 
 class Actor;
+class GOABlock;
 
 static const unsigned ButtonHoldThreshold = 20U;
 struct ObjectControlLocal
@@ -127,6 +128,7 @@ protected :
     virtual void OnNodeSet(Node* node);
 
     void OnMountNodeDead(StringHash eventType, VariantMap& eventData);
+    void OnPathRequestDone(StringHash eventType, VariantMap& eventData);
 
     bool mainController_;
     bool controlActionEnable_;
@@ -139,6 +141,9 @@ protected :
     int currentIdPath_;
     int currentIdUserPath_;
     void* currentPath_;
+    // the pending request of FindAndFollowPath
+    unsigned pathRequestId_;
+    GOABlock* goa_;
 
 private :
     void HandleNetUpdate(StringHash eventType, VariantMap& eventData);
@@ -488,15 +488,45 @@ Behavior* GOC_AIController::ChooseBehavior()
     return behavior;
 }
 
+void GOC_AIController::SetLodTier(unsigned char tier)
+{
+    if (aiInfos_.lodTier == tier)
+        return;
+
+    // frozen : cancel the order and stop
+    if (tier == AILOD_Far)
+    {
+        aiInfos_.Reset();
+        prevbuttons_ = control_.buttons_;
+        GOC_Controller::Update(0, true);
+    }
+
+    aiInfos_.lodTier = tier;
+}
+
 bool GOC_AIController::Update(unsigned time)
 {
-    if (!IsStarted())
+    Behavior* behavior = PrepareUpdate(time);
+    if (!behavior)
         return true;
 
+    // update logic behavior
+    behavior->Update(*this);
+
+    ApplyUpdate(time);
+
+    return true;
+}
+
+Behavior* GOC_AIController::PrepareUpdate(unsigned time)
+{
+    if (!IsStarted())
+        return 0;
+
     if (externalController_)
     {
         bool update = GOC_Controller::Update(externalController_->control_.buttons_, true);
-        return true;
+        return 0;
     }
 
 //    URHO3D_LOGINFOF("GOC_AIController() - Update : node=%s(%u) targetdetection=%d updateaggro=%d ...", node_->GetName().CString(), node_->GetID(), targetDetection_, aiInfos_.updateAggressivity);
@@ -515,7 +545,7 @@ bool GOC_AIController::Update(unsigned time)
     if (!behavior)
     {
         URHO3D_LOGINFOF("GOC_AIController() - Update() : can't find behavior for node %u ! Waiting for new behavior ", node_->GetID());
-        return true;
+        return 0;
     }
 //    else
 //    {
@@ -538,7 +568,7 @@ bool GOC_AIController::Update(unsigned time)
 //            URHO3D_LOGERRORF("AIManager() - Update() : node %u no need update !", node_->GetID());
 //        }
 
-        return true;
+        return 0;
     }
 
     // skip if updatedelay expired
@@ -553,16 +583,18 @@ bool GOC_AIController::Update(unsigned time)
         // skip if lastupdate finished a short time ago
         else if (updatedelay < MIN_AIUPDATEDELAY)
         {
-            return true;
+            return 0;
         }
     }
 
 //    URHO3D_LOGINFOF("GOC_AIController() - Update() : %s(%u) time=%u buttons=%u ...",
 //                    node_->GetName().CString(), node_->GetID(), time, aiInfos_.buttons);
 
-    // update logic behavior
-    behavior->Update(*this);
+    return behavior;
+}
 
+void GOC_AIController::ApplyUpdate(unsigned time)
+{
     if (aiInfos_.waitCallBackOrderOfType || aiInfos_.buttons != node_->GetVar(GOA::BUTTONS).GetUInt())
     {
         // to achieve an order, aicontrol handle alone and callback
@@ -617,7 +649,6 @@ bool GOC_AIController::Update(unsigned time)
 
 //    URHO3D_LOGINFOF("GOC_AIController() - Update() : %s(%u) time=%u buttons=%u ... OK !",
 //                    node_->GetName().CString(), node_->GetID(), time, aiInfos_.buttons);
-    return true;
 }
 
 void GOC_AIController::OnDead(StringHash eventType, VariantMap& eventData)
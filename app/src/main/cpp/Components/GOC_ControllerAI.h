@@ -13,6 +13,17 @@ const unsigned MAX_AIWAITCALLBACKDELAY = 3000U;
 const unsigned MIN_AIUPDATEDELAY = 300U;
 const unsigned MAX_AIJUMPDELAY = 1U;
 
+/// AI level of detail (see AIManager) : the near agents update at full rate,
+/// the mid-range agents update at a reduced rate without the path refinement, the far agents are frozen.
+enum AILodTier
+{
+    AILOD_Near = 0,
+    AILOD_Mid,
+    AILOD_Far,
+    AILOD_NumTiers
+};
+const unsigned AILOD_MIDUPDATEDELAY = 1000U;
+
 /// Low-Level AI  = Behaviors
 /// High-Level AI = AIController
 
@@ -46,7 +57,7 @@ struct AInodeInfos
     AInodeInfos() : minRangeTarget(defaultMinWlkRangeTarget), maxRangeTarget(defaultMaxWlkRangeTarget),
         updateAggressivity(false), lastUpdate(0), lastState(0), state(0), buttons(0),
         lastOrder(0), order(0), nextOrder(0), callBackOrder(0),
-        targetID(0), aggressiveDelay(0) { }
+        targetID(0), aggressiveDelay(0), lodTier(AILOD_Near) { }
 
     void Reset()
     {
@@ -81,6 +92,8 @@ struct AInodeInfos
 
     int waitCallBackOrderOfType;
 
+    unsigned char lodTier;
+
     /// TODO : use a common stack for commands and command's values
 //    int stackCommand_[MAX_STACKCOMMAND];
 //    int stackCommandSize_;
@@ -144,6 +157,11 @@ public :
 
     void UpdateRangeValues(MoveTypeMode movetype);
     bool Update(unsigned time);
+    void SetLodTier(unsigned char tier);
+    /// Update in phases (see AIManager) : the behavior to update, 0 if no update need
+    Behavior* PrepareUpdate(unsigned time);
+    /// Apply the ai infos updated by the behavior to the controls
+    void ApplyUpdate(unsigned time);
 
     void Dump() const;
 
@@ -20,6 +20,7 @@
 #include "DefsViews.h"
 
 #include "GameAttributes.h"
+#include "GOABlock.h"
 #include "GameEvents.h"
 #include "GameContext.h"
 #include "GameNetwork.h"
@@ -48,6 +49,7 @@ extern const char* RemoveStateNames[];
 const float TimeLockViewDelay = 0.5f;
 
 bool GOC_Destroyer::useWorld2D_ = true;
+ComponentUpdater<GOC_Destroyer> GOC_Destroyer::updater_(UPDATER_Destroyer);
 
 static bool stilePositionUpdated_[2];
 static bool sChangeMap_, sInsideBounds_, sWaitForMap_, moveEntityData_;
@@ -70,7 +72,8 @@ GOC_Destroyer::GOC_Destroyer(Context* context) :
     worldUpdatePosition_(true),
     lifeNotifier_(true),
     checkUnstuck_(true),
-    allowWallSpawning_(false)
+    allowWallSpawning_(false),
+    updaterIndex_(M_MAX_UNSIGNED)
 {
     enabled_ = false;
 
@@ -83,6 +86,7 @@ GOC_Destroyer::GOC_Destroyer(Context* context) :
 GOC_Destroyer::~GOC_Destroyer()
 {
 //    URHO3D_LOGDEBUGF("~GOC_Destroyer() - Node=%s(%u)", node_->GetName().CString(), node_->GetID());
+    updater_.Remove(this);
 }
 
 void GOC_Destroyer::RegisterObject(Context* context)
@@ -158,6 +162,7 @@ void GOC_Destroyer::Reset(bool toActive)
 
         ResetViewZ();
         UnsubscribeFromAllEvents();
+        updater_.Remove(this);
 
 //        URHO3D_LOGDEBUGF("GOC_Destroyer() - Reset : %s(%u) toActive=%s enabled=%s nodeEnabled=%s ... ",
 //                        node_->GetName().CString(), node_->GetID(), toActive ? "true" : "false", enabled_ ? "true" : "false", node_->IsEnabled() ? "true" : "false");
@@ -218,13 +223,12 @@ void GOC_Destroyer::SetEnablePositionUpdate(bool enable)
     {
         if (!worldUpdatePosition_)
         {
-            if (HasSubscribedToEvent(GetScene(), E_SCENEPOSTUPDATE))
-                UnsubscribeFromEvent(GetScene(), E_SCENEPOSTUPDATE);
+            updater_.Remove(this);
         }
-        else if (!HasSubscribedToEvent(GetScene(), E_SCENEPOSTUPDATE))
+        else if (!updater_.Contains(this))
         {
-            URHO3D_LOGDEBUGF("GOC_Destroyer() - SetEnablePositionUpdate : %s(%u) worldUpdatePosition_=%s Subscribe to Event !", node_->GetName().CString(), node_->GetID(), enable?"true":"false");
-            SubscribeToEvent(GetScene(), E_SCENEPOSTUPDATE, URHO3D_HANDLER(GOC_Destroyer, HandleUpdateWorld2D));
+            URHO3D_LOGDEBUGF("GOC_Destroyer() - SetEnablePositionUpdate : %s(%u) worldUpdatePosition_=%s Add to the updater !", node_->GetName().CString(), node_->GetID(), enable?"true":"false");
+            updater_.Add(this);
         }
     }
 }
@@ -628,7 +632,7 @@ void GOC_Destroyer::OnSetEnabled()
     if (!GetScene())
     {
         UnsubscribeFromEvent(E_SCENEUPDATE);
-        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+        updater_.Remove(this);
         UnsubscribeFromEvent(WORLD_ENTITYCREATE);
         URHO3D_LOGWARNINGF("GOC_Destroyer() - OnSetEnabled : Node=%s(%u) No Scene !", node_->GetName().CString(), node_->GetID());
         return;
@@ -647,16 +651,12 @@ void GOC_Destroyer::OnSetEnabled()
     if (!useWorld2D_)
     {
         GOC_Controller* controller = node_->GetDerivedComponent<GOC_Controller>();
-        VariantMap& eventData = context_->GetEventDataMap();
-        eventData[Go_Appear::GO_ID] = node_->GetID();
-        if (node_->GetVar(GOA::TYPECONTROLLER) != Variant::EMPTY)
-            eventData[Go_Appear::GO_TYPE] = node_->GetVar(GOA::TYPECONTROLLER).GetInt();
-        else
-            eventData[Go_Appear::GO_TYPE] = GO_None;
-        eventData[Go_Appear::GO_MAINCONTROL] = controller ? controller->IsMainController() : false;
+        const Variant& typecontroller = node_->GetVar(GOA::TYPECONTROLLER);
+        GoAppearEvent event = { node_->GetID(), typecontroller != Variant::EMPTY ? typecontroller.GetInt() : GO_None,
+                                controller ? controller->IsMainController() : false, 0, M_MAX_UNSIGNED };
 //        URHO3D_LOGDEBUGF("GOC_Destroyer() - OnSetEnabled : Node=%s(%u) Appear (NO World2D!)", node_->GetName().CString(), node_->GetID());
 
-        node_->SendEvent(GO_APPEAR, eventData);
+        EventChannel<GoAppearEvent>::Get().Send(node_, event);
     }
 //    else
 //        SubscribeToEvent(node_, WORLD_ENTITYCREATE, URHO3D_HANDLER(GOC_Destroyer, OnWorldEntityCreate));
@@ -703,7 +703,7 @@ void GOC_Destroyer::OnSetEnabled()
             switchViewEnable_ = node_->GetComponent<ObjectMaped>() ? false : true;
             elapsedTimeLockView_ = TimeLockViewDelay;
 
-            SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(GOC_Destroyer, HandleUpdateWorld2D));
+            updater_.Add(this);
 
             bool ok = UpdateShapesRect();
         }
@@ -722,7 +722,7 @@ void GOC_Destroyer::OnSetEnabled()
 //        URHO3D_LOGDEBUGF("GOC_Destroyer() - OnSetEnabled : node=%s(%u) stop on World2D at mPoint=%s",
 //                                    node_->GetName().CString(), node_->GetID(), mapWorldPosition_.mPoint_.ToString().CString());
 
-        UnsubscribeFromEvent(GetScene(), E_SCENEPOSTUPDATE);
+        updater_.Remove(this);
     }
 
 //    URHO3D_LOGDEBUGF("GOC_Destroyer() - OnSetEnabled : Node=%s(%u) componentEnable=%s nodeEnable=%s world2D=%s bodyawake=%s ... OK !",
@@ -796,14 +796,17 @@ void GOC_Destroyer::OnWorldEntityCreate(StringHash eventType, VariantMap& eventD
     mapWorldPosition_.defined_ = true;
 
     // specific tileindex (for static furniture)
-    if (eventData[Go_Appear::GO_TILE] != Variant::EMPTY)
-        mapWorldPosition_.tileIndex_ = eventData[Go_Appear::GO_TILE].GetUInt();
+    VariantMap::Iterator it = eventData.Find(Go_Appear::GO_TILE);
+    const unsigned tileindex = it != eventData.End() ? it->second_.GetUInt() : M_MAX_UNSIGNED;
+    if (tileindex != M_MAX_UNSIGNED)
+        mapWorldPosition_.tileIndex_ = tileindex;
 
     // already specified mappoint (for static furniture)
     unsigned mPoint = mapWorldPosition_.mPoint_.ToHash();
-    if (eventData[Go_Appear::GO_MAP] != Variant::EMPTY)
+    it = eventData.Find(Go_Appear::GO_MAP);
+    if (it != eventData.End())
     {
-        mPoint = eventData[Go_Appear::GO_MAP].GetUInt();
+        mPoint = it->second_.GetUInt();
     }
     else
     {
@@ -823,10 +826,8 @@ void GOC_Destroyer::OnWorldEntityCreate(StringHash eventType, VariantMap& eventD
     int controltype = controller ? controller->GetControllerType() : GO_None;
 
     node_->SetVar(GOA::ONMAP, mPoint);
-    eventData[Go_Appear::GO_ID] = node_->GetID();
-    eventData[Go_Appear::GO_TYPE] = controltype;
-    eventData[Go_Appear::GO_MAINCONTROL] = controller ? controller->IsMainController() : false;
-    node_->SendEvent(GO_APPEAR, eventData);
+    GoAppearEvent event = { node_->GetID(), controltype, controller ? controller->IsMainController() : false, mPoint, tileindex };
+    EventChannel<GoAppearEvent>::Get().Send(node_, event);
 
     if (controltype & GO_Entity)
     {
@@ -863,6 +864,7 @@ void GOC_Destroyer::Destroy(float delay, bool reset)
         return;
 
     UnsubscribeFromAllEvents();
+    updater_.Remove(this);
 
     if (reset && destroyMode_ != FREEMEMORY && delay != 0.f)
         Reset(destroyMode_ == DISABLE);
@@ -899,15 +901,9 @@ void GOC_Destroyer::Destroy(float delay, bool reset)
 
     GOC_Controller* controller = node_->GetDerivedComponent<GOC_Controller>();
     int controltype = controller ? controller->GetControllerType() : GO_None;
-    eventData[Go_Destroy::GO_ID] = nodeid;
-    eventData[Go_Destroy::GO_TYPE] = controltype;
-    eventData[Go_Destroy::GO_MAP] = mapWorldPosition_.mPoint_.ToHash();
-    eventData[Go_Destroy::GO_PTR] = 0;
-
-    if (GOT::GetTypeProperties(node_->GetVar(GOA::GOT).GetStringHash()) & GOT_Anchored)
-        eventData[Go_Destroy::GO_TILE] = mapWorldPosition_.tileIndex_;
-
-    node_->SendEvent(GO_DESTROY, eventData);
+    const bool anchored = GOT::GetTypeProperties(node_->GetVar(GOA::GOT).GetStringHash()) & GOT_Anchored;
+    GoDestroyEvent event = { nodeid, controltype, mapWorldPosition_.mPoint_.ToHash(), anchored ? mapWorldPosition_.tileIndex_ : M_MAX_UNSIGNED, 0 };
+    EventChannel<GoDestroyEvent>::Get().Send(node_, event);
 
     if (controltype & GO_Entity)
     {
@@ -1476,7 +1472,7 @@ void GOC_Destroyer::UpdateAreaStates(bool sendfluidevent)
     if (!body_)
         return;
 
-    unsigned movestates = node_->GetVar(GOA::MOVESTATE).GetUInt();
+    unsigned movestates = GOABlock::GetMoveState(node_);
 
     // take care of climbing
     if ((movestates & MSK_MV_CLIMBWALL) == MSK_MV_CLIMBWALL || (movestates & MSK_MV_CLIMBROOF) == MSK_MV_CLIMBROOF)
@@ -1680,6 +1676,10 @@ bool GOC_Destroyer::UpdatePositions(VariantMap& eventData, UpdatePositionMode mo
 
     stilePositionUpdated_[0] = sMPosition_.tileIndex_ != mapWorldPosition_.tileIndex_ || mode == UPDATEPOS_FORCE || !mapWorldPosition_.defined_;
 
+    // the entity grid cells are larger than the tiles
+    if (stilePositionUpdated_[0])
+        World2D::UpdateEntityPosition(node_->GetID(), sMPosition_.position_);
+
     sChangeMap_ = (sMPosition_.mPoint_ != mapWorldPosition_.mPoint_ || mode == UPDATEPOS_FORCE || (currentMap_ && currentMap_->GetMapPoint() != sMPosition_.mPoint_));
     sInsideBounds_ = sChangeMap_ ? World2D::IsInsideWorldBounds(mapWorldPosition_.position_) : true;
     sChangeMap_ &= sInsideBounds_;
@@ -2030,11 +2030,8 @@ bool GOC_Destroyer::UpdatePositions(VariantMap& eventData, UpdatePositionMode mo
 
         if (mode != UPDATEPOS_NOCHANGEMAP)
         {
-            eventData[Go_ChangeMap::GO_ID] = node_->GetID();
-            eventData[Go_ChangeMap::GO_TYPE] = node_->GetVar(GOA::TYPECONTROLLER).GetInt();
-            eventData[Go_ChangeMap::GO_MAPFROM] = sOldHashPoint_;
-            eventData[Go_ChangeMap::GO_MAPTO] = sNewHashPoint_;
-            node_->SendEvent(GO_CHANGEMAP, eventData);
+            GoChangeMapEvent event = { node_->GetID(), node_->GetVar(GOA::TYPECONTROLLER).GetInt(), sOldHashPoint_, sNewHashPoint_ };
+            EventChannel<GoChangeMapEvent>::Get().Send(node_, event);
         }
 
 //        if (currentMap_ && moveEntityData_)
@@ -2065,17 +2062,17 @@ void GOC_Destroyer::DumpWorldMapPositions()
                     node_->GetName().CString(), node_->GetID(), mapWorldPosition_.ToString().CString());
 }
 
-void GOC_Destroyer::HandleUpdateWorld2D(StringHash eventType, VariantMap& eventData)
+void GOC_Destroyer::Update(float timeStep)
 {
 //    URHO3D_PROFILE(GOC_Destroyer);
 
-    if (!UpdatePositions(eventData))
+    if (!UpdatePositions(context_->GetEventDataMap(false)))
         return;
 
 #ifdef SWITCHVIEW_DELAY_TEST
     if (!switchViewEnable_)
     {
-        elapsedTimeLockView_ -= eventData[ScenePostUpdate::P_TIMESTEP].GetFloat();
+        elapsedTimeLockView_ -= timeStep;
         if (elapsedTimeLockView_ <= 0.f)
         {
             switchViewEnable_ = true;
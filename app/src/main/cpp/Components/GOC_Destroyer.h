@@ -9,6 +9,7 @@
 #include "DefsMove.h"
 
 #include "TimerRemover.h"
+#include "ComponentUpdater.h"
 
 namespace Urho3D
 {
@@ -146,17 +147,21 @@ public :
 
     void WorldAppearCallBack();
 
+    /// Called each frame by the updater : update the world positions
+    void Update(float timeStep);
+
     void DumpWorldMapPositions();
 
     virtual void DrawDebugGeometry(DebugRenderer* debugRenderer, bool depthTest) const;
 
 private :
+    friend class ComponentUpdater<GOC_Destroyer>;
+
     bool Unstuck();
 
     void OnWorldEntityCreate(StringHash eventType, VariantMap& eventData);
     void OnWorldEntityDestroy(StringHash eventType, VariantMap& eventData);
 
-    void HandleUpdateWorld2D(StringHash eventType, VariantMap& eventData);
     void HandleUpdateTime(StringHash eventType, VariantMap& eventData);
     void HandleUpdateTimePeriod(StringHash eventType, VariantMap& eventData);
 
@@ -184,7 +189,11 @@ private :
     FeatureType lastCellCheckFeature_[2];
 
     Rect shapesRect_;
+
+    unsigned updaterIndex_;
+
     static bool useWorld2D_;
+    static ComponentUpdater<GOC_Destroyer> updater_;
 };
 
 
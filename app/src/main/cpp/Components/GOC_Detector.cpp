@@ -12,6 +12,7 @@
 #include <Urho3D/Urho2D/ConstraintWeld2D.h>
 
 #include "GameAttributes.h"
+#include "GOABlock.h"
 #include "GameEvents.h"
 #include "GameContext.h"
 
@@ -257,7 +258,7 @@ void GOC_Detector::HandleContact(StringHash eventType, VariantMap& eventData)
             {
                 bool dirOk;
 
-                Vector2 vel = other->GetNode()->GetVar(GOA::VELOCITY).GetVector2();
+                Vector2 vel = GOABlock::GetVelocity(other->GetNode());
                 if (vel == Vector2::ZERO)
                     vel = other->GetLinearVelocity();
                 if (vel == Vector2::ZERO)
@@ -325,7 +326,7 @@ void GOC_Detector::HandleContact(StringHash eventType, VariantMap& eventData)
             {
                 bool dirOk;
 
-                Vector2 vel = other->GetNode()->GetVar(GOA::VELOCITY).GetVector2();
+                Vector2 vel = GOABlock::GetVelocity(other->GetNode());
                 if (vel == Vector2::ZERO)
                     vel = other->GetLinearVelocity();
                 if (vel == Vector2::ZERO)
@@ -34,11 +34,13 @@
 #define DELAY_INITIALMOVE 0.07f
 
 
+ComponentUpdater<GOC_DropZone> GOC_DropZone::updater_(UPDATER_DropZone);
+
 GOC_DropZone::GOC_DropZone(Context* context) :
     Component(context), dropZone_(0),
     actived_(0), activeStorage_(0), activeThrow_(0), buildObjects_(0), removeParts_(0),
     throwItemsRunning_(false), radius_(0), numHitsToTrig_(3), hitCount_(0), lastHitTime_(0),
-    linearVelocity_(10.f), angularVelocity_(3.f), impulse_(0.5f), throwDelay_(0.2f) { }
+    linearVelocity_(10.f), angularVelocity_(3.f), impulse_(0.5f), throwDelay_(0.2f), updaterIndex_(M_MAX_UNSIGNED) { }
 
 GOC_DropZone::~GOC_DropZone()
 {
@@ -88,6 +90,7 @@ void GOC_DropZone::OnSetEnabled()
 //        dropZone_ = 0;
 
         UnsubscribeFromAllEvents();
+        updater_.Remove(this);
     }
 }
 
@@ -278,6 +281,7 @@ void GOC_DropZone::Stop()
 {
     Clear();
     UnsubscribeFromAllEvents();
+    updater_.Remove(this);
 }
 
 bool GOC_DropZone::AddItem(const Slot& slot)
@@ -536,20 +540,21 @@ void GOC_DropZone::ThrowOutItems()
         node_->SendEvent(GO_STORAGECHANGED, eventData);
     }
 
-    SubscribeToEvent(GetScene(), E_SCENEPOSTUPDATE, URHO3D_HANDLER(GOC_DropZone, HandleThrowOutItems));
+    if (GetScene())
+        updater_.Add(this);
     UnsubscribeFromEvent(E_PHYSICSBEGINCONTACT2D);
 }
 
-void GOC_DropZone::HandleThrowOutItems(StringHash eventType, VariantMap& eventData)
+void GOC_DropZone::Update(float timeStep)
 {
-//    URHO3D_LOGINFOF("GOC_DropZone() - HandleThrowOutItems");
-    throwItemsTimer_ += eventData[SceneUpdate::P_TIMESTEP].GetFloat();
+//    URHO3D_LOGINFOF("GOC_DropZone() - Update : throw out items");
+    throwItemsTimer_ += timeStep;
 
     // Spawn Items with Delay Between each one
     if (throwItemsEndIndex_ < items_.Size())
         if (throwItemsTimer_ > DELAY_BETWEEN_SPAWN * throwItemsEndIndex_)
         {
-//            URHO3D_LOGINFOF("GOC_DropZone() - HandleThrowOutItems - Spawn item index=%u", throwItemsEndIndex_);
+//            URHO3D_LOGINFOF("GOC_DropZone() - Update : Spawn item index=%u", throwItemsEndIndex_);
             // SPAWN item
             if (!itemsAttr_[throwItemsEndIndex_].Empty())
             {
@@ -585,7 +590,7 @@ void GOC_DropZone::HandleThrowOutItems(StringHash eventType, VariantMap& eventDa
     // At End of spawn - stop initial move
     if (throwItemsTimer_ > throwDelay_ * items_.Size() + DELAY_INITIALMOVE)
     {
-//        URHO3D_LOGINFOF("GOC_DropZone() - HandleThrowOutItems : Stop Initial Move !");
+//        URHO3D_LOGINFOF("GOC_DropZone() - Update : Stop Initial Move !");
         for (unsigned i=0; i < itemsNodes_.Size(); ++i)
         {
             if (!itemsNodes_[i]) continue;
@@ -598,10 +603,10 @@ void GOC_DropZone::HandleThrowOutItems(StringHash eventType, VariantMap& eventDa
         throwItemsRunning_ = false;
 
         Clear();
-        UnsubscribeFromEvent(GetScene(), E_SCENEPOSTUPDATE);
+        updater_.Remove(this);
         SubscribeToEvent(GetNode(), E_PHYSICSBEGINCONTACT2D, URHO3D_HANDLER(GOC_DropZone, HandleContact));
     }
-//    URHO3D_LOGINFOF("GOC_DropZone() - HandleThrowOutItems OK");
+//    URHO3D_LOGINFOF("GOC_DropZone() - Update : throw out items OK");
 }
 
 void GOC_DropZone::NetClientUpdateStorage(unsigned servernodeid, VariantMap& eventData)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Slot.h"
+#include "ComponentUpdater.h"
 
 namespace Urho3D
 {
@@ -59,10 +60,15 @@ public :
     virtual void OnSetEnabled();
     virtual void CleanDependences();
 
+    /// Called each frame by the updater while the stored items are thrown out
+    void Update(float timeStep);
+
 protected :
     virtual void OnNodeSet(Node* node);
 
 private :
+    friend class ComponentUpdater<GOC_DropZone>;
+
     void Stop();
     void Clear();
 
@@ -72,7 +78,6 @@ private :
 
     void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
     void HandleContact(StringHash eventType, VariantMap& eventData);
-    void HandleThrowOutItems(StringHash eventType, VariantMap& eventData);
 
     RigidBody2D* body_;
     CollisionCircle2D* dropZone_;
@@ -98,6 +103,9 @@ private :
     Vector<Slot> items_;
     Vector<String> itemsAttr_;
     Vector<WeakPtr<Node> > itemsNodes_;
+
+    unsigned updaterIndex_;
+    static ComponentUpdater<GOC_DropZone> updater_;
 };
 
 
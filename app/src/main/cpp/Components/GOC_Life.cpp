@@ -109,6 +109,8 @@ void GOC_Life_Template::Dump() const
 
 /// GOC_Life Implementation
 
+ComponentUpdater<GOC_Life> GOC_Life::updater_(UPDATER_Life);
+
 GOC_Life::GOC_Life(Context* context) :
     Component(context),
 //	customTemplate(false),
@@ -118,7 +120,8 @@ GOC_Life::GOC_Life(Context* context) :
     killer(0),
     props(0.f, 0, 0.f),
     updateProps_(false),
-    waitServerReset_(false)
+    waitServerReset_(false),
+    updaterIndex_(M_MAX_UNSIGNED)
 {
     ;
 }
@@ -127,6 +130,7 @@ GOC_Life::~GOC_Life()
 {
     SetLifeBars(false);
     UnsubscribeFromAllEvents();
+    updater_.Remove(this);
 //    ClearCustomTemplate();
 }
 
@@ -297,12 +301,12 @@ void GOC_Life::SetInvulnerability(float i)
     {
         if (props.invulnerability > 0.f)
         {
-            SubscribeToEvent(GetScene(), E_SCENEPOSTUPDATE, URHO3D_HANDLER(GOC_Life, HandleInvulnerabilityUpdate));
+            updater_.Add(this);
         }
         else
         {
             haloInvulnerability_ = 0;
-            UnsubscribeFromEvent(GetScene(), E_SCENEPOSTUPDATE);
+            updater_.Remove(this);
         }
     }
 }
@@ -533,8 +537,8 @@ void GOC_Life::OnSetEnabled()
     {
         lastGainInvulnerabilityTime = 0;
         haloInvulnerability_ = 0;
-        if (props.invulnerability > 0.f)
-            SubscribeToEvent(GetScene(), E_SCENEPOSTUPDATE, URHO3D_HANDLER(GOC_Life, HandleInvulnerabilityUpdate));
+        if (props.invulnerability > 0.f && GetScene())
+            updater_.Add(this);
 
         // ServerMode don't need to use LifeUpdate ?
 //        if (GameContext::Get().ServerMode_)
@@ -555,9 +559,9 @@ void GOC_Life::OnSetEnabled()
     }
 }
 
-void GOC_Life::HandleInvulnerabilityUpdate(StringHash eventType, VariantMap& eventData)
+void GOC_Life::Update(float timeStep)
 {
-    props.invulnerability -= eventData[SceneUpdate::P_TIMESTEP].GetFloat();
+    props.invulnerability -= timeStep;
 
     if (props.invulnerability > 0.8f)
     {
@@ -571,7 +575,7 @@ void GOC_Life::HandleInvulnerabilityUpdate(StringHash eventType, VariantMap& eve
     else if (props.invulnerability <= 0.f)
     {
         haloInvulnerability_ = 0;
-        UnsubscribeFromEvent(GetScene(), E_SCENEPOSTUPDATE);
+        updater_.Remove(this);
     }
 }
 
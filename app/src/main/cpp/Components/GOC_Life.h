@@ -2,6 +2,8 @@
 
 #include <Urho3D/Scene/Component.h>
 
+#include "ComponentUpdater.h"
+
 using namespace Urho3D;
 
 struct LifeProps
@@ -119,9 +121,14 @@ public :
     virtual void ApplyAttributes();
     virtual void OnSetEnabled();
 
+    /// Called each frame by the updater while invulnerable
+    void Update(float timeStep);
+
     void Dump() const;
 
 private :
+    friend class ComponentUpdater<GOC_Life>;
+
     void SetEnergyLost(float e);
     void ValidateMarkNetworkUpdate();
 
@@ -132,7 +139,6 @@ private :
     void UpdateProperties();
     void UpdateLifeBars();
 
-    void HandleInvulnerabilityUpdate(StringHash eventType, VariantMap& eventData);
     void HandleLifeUpdate(StringHash eventType, VariantMap& eventData);
     void HandleUpdateLifeBar(StringHash eventType, VariantMap& eventData);
 //    void HandleReceiveEffect(StringHash eventType, VariantMap& eventData);
@@ -150,6 +156,9 @@ private :
     WeakPtr<Node> killerPtr;
     HashMap<int, WeakPtr<UIElement> > lifebarsui_;
     WeakPtr<Node> lifebarnode_;
+
+    unsigned updaterIndex_;
+    static ComponentUpdater<GOC_Life> updater_;
 };
 
 
@@ -21,6 +21,7 @@
 #include "GameEvents.h"
 #include "GameContext.h"
 #include "GameHelpers.h"
+#include "GOABlock.h"
 
 #include "GOC_Destroyer.h"
 #include "GOC_Collide2D.h"
@@ -129,6 +130,8 @@ void GOC_Move2D_Template::Dump() const
 const float GOC_Move2D::heightMax = 1.f;
 const float GOC_Move2D::velJumpMax = 6.f;
 
+ComponentUpdater<GOC_Move2D> GOC_Move2D::updater_(UPDATER_Move2D);
+
 const float MOVE_EPSILON = 0.01f;
 
 const char* moveTypeModes[] =
@@ -175,6 +178,7 @@ GOC_Move2D::GOC_Move2D(Context* context) :
     body(0),
     destroyer_(0),
     controller_(0),
+    goa_(0),
     moveType_(MOVE2D_WALK),
     lastMoveType_(MOVE2D_UNDEFINED),
     buttons_(0),
@@ -182,11 +186,15 @@ GOC_Move2D::GOC_Move2D(Context* context) :
     numJumps_(2),
     moveStates_(0),
     physicsEnable_(true),
-    physicsReduced_(false)
+    physicsReduced_(false),
+    updaterIndex_(M_MAX_UNSIGNED)
 { }
 
 GOC_Move2D::~GOC_Move2D()
-{ }
+{
+    updater_.Remove(this);
+    GOABlock::Release(goa_);
+}
 
 void GOC_Move2D::RegisterObject(Context* context)
 {
@@ -316,12 +324,13 @@ void GOC_Move2D::UpdateAttributes()
         // Always Active Box2D CCD
 //        body->SetBullet(true);
 
-        node_->SetVar(GOA::VELOCITY, Vector2::ZERO);
+        goa_->SetVelocity(Vector2::ZERO);
 
         destroyer_ = node_->GetComponent<GOC_Destroyer>();
         controller_ = node_->GetDerivedComponent<GOC_Controller>();
 
         UnsubscribeFromAllEvents();
+        updater_.Remove(this);
 
         if (!controller_)
         {
@@ -374,7 +383,7 @@ void GOC_Move2D::UpdateAttributes()
 //            URHO3D_LOGINFOF("GOC_Move2D() - UpdateAttributes : Node=%s(%u) Subscribe To Standard Events", node_->GetName().CString(), node_->GetID());
 
             SubscribeToEvent(node_, GOC_CONTROLUPDATE, URHO3D_HANDLER(GOC_Move2D, HandleControlUpdate));
-            SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(GOC_Move2D, HandleUpdate));
+            updater_.Add(this);
         }
 
         SubscribeToEvent(node_, EVENT_CHANGEGRAVITY, URHO3D_HANDLER(GOC_Move2D, HandleGravityChanged));
@@ -416,7 +425,7 @@ void GOC_Move2D::UpdateAttributes()
 
 //        URHO3D_LOGINFOF("GOC_Move2D() - UpdateAttributes : Node=%s(%u) update moveState=%u MV_FALL=%s", node_->GetName().CString(), node_->GetID(), moveStates_, moveStates_ & MV_INFALL ? "true":"false");
 
-        node_->SetVar(GOA::MOVESTATE, moveStates_);
+        goa_->SetMoveState(moveStates_);
 
         SetVehicleWheels();
     }
@@ -424,6 +433,7 @@ void GOC_Move2D::UpdateAttributes()
     {
 //        URHO3D_LOGINFOF("GOC_Move2D() - UpdateAttributes : Node=%s(%u) Enabled=false or no Scene => UnsubscribeToEvents !", node_->GetName().CString(), node_->GetID());
         UnsubscribeFromAllEvents();
+        updater_.Remove(this);
     }
 }
 
@@ -432,7 +442,7 @@ void GOC_Move2D::GetLinearVelocity(Vector2& vel)
 {
     lastvel_ = vel;
     vel = body->GetLinearVelocity();
-    node_->SetVar(GOA::VELOCITY, vel);
+    goa_->SetVelocity(vel);
 }
 
 void GOC_Move2D::StopMove()
@@ -481,8 +491,16 @@ void GOC_Move2D::OnNodeSet(Node* node)
 {
     if (node)
     {
+        if (!goa_)
+            goa_ = GOABlock::Acquire(node);
+
         UpdateAttributes();
     }
+    else
+    {
+        GOABlock::Release(goa_);
+        goa_ = 0;
+    }
 }
 
 
@@ -942,7 +960,7 @@ bool GOC_Move2D::Update_Fly()
     {
         bool touchground = (moveStates_ & MV_TOUCHGROUND);
         moveStates_ = (moveStates_ & ~MV_TOUCHGROUND) | MV_INFALL | MV_INAIR;
-        node_->SetVar(GOA::MOVESTATE, moveStates_);
+        goa_->SetMoveState(moveStates_);
 
         // Remove Ground Contact in GOC_Collide2D
         if (touchground)
@@ -1136,7 +1154,7 @@ bool GOC_Move2D::ControlUpdate_Air()
 #ifdef DUMP_DEBUG_MOVEUPDATE
                 URHO3D_LOGINFOF("GOC_Move2D() - ControlUpdate_Air : Node=%s(%u) Go DOWN ! (m=%u)", node_->GetName().CString(), node_->GetID(), moveStates_);
 #endif
-                node_->SetVar(GOA::MOVESTATE, moveStates_);
+                goa_->SetMoveState(moveStates_);
                 ApplyImpulseY(-template_->vel_[vJUMP]);
                 node_->SendEvent(EVENT_FALL);
             }
@@ -1153,7 +1171,7 @@ bool GOC_Move2D::ControlUpdate_Air()
 //            if (moveStates_ & MV_CLIMB)
 //                body->SetGravityScale(1.f);
 
-            node_->SetVar(GOA::MOVESTATE, moveStates_);
+            goa_->SetMoveState(moveStates_);
         }
 
         if (vel_.y_ < template_->vel_[vFLYMAX])
@@ -1228,7 +1246,7 @@ bool GOC_Move2D::ControlUpdate_Liquid()
 //            if (moveStates_ & MV_CLIMB)
 //                body->SetGravityScale(0.2f);
 
-            node_->SetVar(GOA::MOVESTATE, moveStates_);
+            goa_->SetMoveState(moveStates_);
 
             // Go Down
             if (buttons_ & CTRL_DOWN)
@@ -1283,7 +1301,7 @@ bool GOC_Move2D::ControlUpdate_Ground()
 #endif
             ApplyForceX(-template_->vel_[vWALK] * 4.f);
 
-            if (!node_->GetVar(GOA::KEEPDIRECTION).GetBool())
+            if (!goa_->GetKeepDirection())
             {
                 lastDirectionX_ = -1;
                 node_->SendEvent(GO_CHANGEDIRECTION);
@@ -1294,7 +1312,7 @@ bool GOC_Move2D::ControlUpdate_Ground()
                 startjumpy_ = destroyer_->GetWorldMapPosition().position_.y_;
                 numRemainJumps_--;
                 moveStates_ = (moveStates_ & ~MSK_MV_TOUCHWALLS) | MV_INJUMP | MV_INAIR;
-                node_->SetVar(GOA::MOVESTATE, moveStates_);
+                goa_->SetMoveState(moveStates_);
                 ApplyImpulseY(body->GetMass() > 2.f ? 0.5f* body->GetMass() * template_->vel_[vJUMPMIN] : template_->vel_[vJUMPMIN]);
 #ifdef DUMP_DEBUG_MOVEUPDATE
                 URHO3D_LOGINFOF("GOC_Move2D() - ControlUpdate_Ground : Node=%s(%u) Climber On Wall Go JUMP startjumpy_=%f (numjumps=%d/%d) ! (m=%u)", node_->GetName().CString(), node_->GetID(), startjumpy_, numRemainJumps_, numJumps_, moveStates_);
@@ -1311,7 +1329,7 @@ bool GOC_Move2D::ControlUpdate_Ground()
 #endif
             ApplyForceX(template_->vel_[vWALK] * 4.f);
 
-            if (!node_->GetVar(GOA::KEEPDIRECTION).GetBool())
+            if (!goa_->GetKeepDirection())
             {
                 lastDirectionX_ = 1;
                 node_->SendEvent(GO_CHANGEDIRECTION);
@@ -1321,7 +1339,7 @@ bool GOC_Move2D::ControlUpdate_Ground()
                 startjumpy_ = destroyer_->GetWorldMapPosition().position_.y_;
                 numRemainJumps_--;
                 moveStates_ = (moveStates_ & ~MSK_MV_TOUCHWALLS) | MV_INJUMP | MV_INAIR;
-                node_->SetVar(GOA::MOVESTATE, moveStates_);
+                goa_->SetMoveState(moveStates_);
                 ApplyImpulseY(body->GetMass() > 2.f ? 0.5f* body->GetMass() * template_->vel_[vJUMPMIN] : template_->vel_[vJUMPMIN]);
 #ifdef DUMP_DEBUG_MOVEUPDATE
                 URHO3D_LOGINFOF("GOC_Move2D() - ControlUpdate_Ground : Node=%s(%u) Climber On Wall Go JUMP startjumpy_=%f (numjumps=%d/%d) ! (m=%u)", node_->GetName().CString(), node_->GetID(), startjumpy_, numRemainJumps_, numJumps_, moveStates_);
@@ -1336,7 +1354,7 @@ bool GOC_Move2D::ControlUpdate_Ground()
 #ifdef DUMP_DEBUG_MOVEUPDATE
             URHO3D_LOGINFOF("GOC_Move2D() - ControlUpdate_Ground : Node=%s(%u) Change direction To UP", node_->GetName().CString(), node_->GetID());
 #endif
-            if (!node_->GetVar(GOA::KEEPDIRECTION).GetBool())
+            if (!goa_->GetKeepDirection())
             {
                 lastDirectionY_ = -1;
                 node_->SendEvent(GO_CHANGEDIRECTION);
@@ -1348,7 +1366,7 @@ bool GOC_Move2D::ControlUpdate_Ground()
 #ifdef DUMP_DEBUG_MOVEUPDATE
             URHO3D_LOGINFOF("GOC_Move2D() - ControlUpdate_Ground : Node=%s(%u) Change direction To DOWN", node_->GetName().CString(), node_->GetID());
 #endif
-            if (!node_->GetVar(GOA::KEEPDIRECTION).GetBool())
+            if (!goa_->GetKeepDirection())
             {
                 lastDirectionY_ = 1;
                 node_->SendEvent(GO_CHANGEDIRECTION);
@@ -1365,7 +1383,7 @@ bool GOC_Move2D::ControlUpdate_Ground()
 #endif
             ApplyForceX(-template_->vel_[vWALK] * 4.f);
 
-            if (!node_->GetVar(GOA::KEEPDIRECTION).GetBool())
+            if (!goa_->GetKeepDirection())
             {
                 lastDirectionX_ = -1;
                 node_->SendEvent(GO_CHANGEDIRECTION);
@@ -1379,7 +1397,7 @@ bool GOC_Move2D::ControlUpdate_Ground()
 #endif
             ApplyForceX(template_->vel_[vWALK] * 4.f);
 
-            if (!node_->GetVar(GOA::KEEPDIRECTION).GetBool())
+            if (!goa_->GetKeepDirection())
             {
                 lastDirectionX_ = 1;
                 node_->SendEvent(GO_CHANGEDIRECTION);
@@ -1404,7 +1422,7 @@ bool GOC_Move2D::ControlUpdate_Ground()
 #ifdef DUMP_DEBUG_MOVEUPDATE
                     URHO3D_LOGINFOF("GOC_Move2D() - ControlUpdate_Ground : Node=%s(%u) Go DOWN ! (m=%u)", node_->GetName().CString(), node_->GetID(), moveStates_);
 #endif
-                    node_->SetVar(GOA::MOVESTATE, moveStates_);
+                    goa_->SetMoveState(moveStates_);
                     ApplyImpulseY(-template_->vel_[vJUMP]);
                     node_->SendEvent(EVENT_FALL);
                 }
@@ -1424,7 +1442,7 @@ bool GOC_Move2D::ControlUpdate_Ground()
 #ifdef DUMP_DEBUG_MOVEUPDATE
             URHO3D_LOGWARNING("GOC_Move2D() - ControlUpdate_Ground : Can't Jump ; Touch Roof !");
 #endif
-            node_->SetVar(GOA::MOVESTATE, moveStates_);
+            goa_->SetMoveState(moveStates_);
             ApplyImpulseY(-template_->vel_[vJUMP]);
             node_->SendEvent(EVENT_FALL);
             return true;
@@ -1445,7 +1463,7 @@ bool GOC_Move2D::ControlUpdate_Ground()
 
                 moveStates_ = (moveStates_ & ~MSK_MV_TOUCHWALLS) | MV_INJUMP | MV_INAIR;
 
-                node_->SetVar(GOA::MOVESTATE, moveStates_);
+                goa_->SetMoveState(moveStates_);
 
                 if (body->GetMass() > 2.f)
                     ApplyImpulseY(0.5f* body->GetMass() * template_->vel_[vJUMPMIN]);
@@ -1465,7 +1483,7 @@ bool GOC_Move2D::ControlUpdate_Ground()
                     numRemainJumps_--;
 
                     moveStates_ = moveStates_ | MV_INJUMP;
-                    node_->SetVar(GOA::MOVESTATE, moveStates_);
+                    goa_->SetMoveState(moveStates_);
                     ApplyImpulseY(template_->vel_[vJUMPMIN]);
 #ifdef DUMP_DEBUG_MOVEUPDATE
                     URHO3D_LOGINFOF("GOC_Move2D() - ControlUpdate_Ground : Node=%s(%u) Go Double JUMP (numjumps=%d/%d) ! (m=%u)",
@@ -1497,7 +1515,7 @@ bool GOC_Move2D::ControlUpdate_Ground()
 }
 
 
-void GOC_Move2D::HandleUpdate(StringHash eventType, VariantMap& eventData)
+void GOC_Move2D::Update(float timeStep)
 {
 //    URHO3D_PROFILE(GOC_Move2D);
 
@@ -1538,7 +1556,7 @@ void GOC_Move2D::HandleUpdate(StringHash eventType, VariantMap& eventData)
         UpdateLineOfSight();
     }
 
-    node_->SetVar(GOA::MOVESTATE, moveStates_);
+    goa_->SetMoveState(moveStates_);
 }
 
 void GOC_Move2D::HandleControlUpdate(StringHash eventType, VariantMap& eventData)
@@ -1571,7 +1589,7 @@ void GOC_Move2D::HandleGravityChanged(StringHash eventType, VariantMap& eventDat
     if (body->GetGravityScale() == WATERGRAVITY)
     {
         moveStates_ = (moveStates_ & ~MV_INAIR) | MV_INLIQUID;
-        node_->SetVar(GOA::MOVESTATE, moveStates_);
+        goa_->SetMoveState(moveStates_);
 
         if (!node_->GetVar(GOA::ISDEAD).GetBool())
             node_->SendEvent(EVENT_CHANGEAREA);
@@ -1579,7 +1597,7 @@ void GOC_Move2D::HandleGravityChanged(StringHash eventType, VariantMap& eventDat
     else if (body->GetGravityScale() == AIRGRAVITY)
     {
         moveStates_ = (moveStates_ & ~MV_INLIQUID) | MV_INAIR;
-        node_->SetVar(GOA::MOVESTATE, moveStates_);
+        goa_->SetMoveState(moveStates_);
 
         if (!node_->GetVar(GOA::ISDEAD).GetBool())
             node_->SendEvent(EVENT_CHANGEAREA);
@@ -1694,7 +1712,7 @@ void GOC_Move2D::OnWallContactBegin(int walltype, int wallside)
     case Wall_Ground:
         numRemainJumps_ = numJumps_;
         moveStates_ = (moveStates_ & ~(MV_INJUMP | MV_INFALL | MV_INAIR)) | defaultStates_ | MV_TOUCHGROUND;
-        node_->SetVar(GOA::MOVESTATE, moveStates_);
+        goa_->SetMoveState(moveStates_);
 #ifdef DUMP_DEBUG_MOVEUPDATE
         URHO3D_LOGINFOF("GOC_Move2D() - OnWallContactBegin : Node=%s(%u) Add MV_TOUCHGROUND ... on Ground (m=%u) numRemainJumps_=%d", node_->GetName().CString(), node_->GetID(), moveStates_, numRemainJumps_);
 #endif
@@ -1710,19 +1728,19 @@ void GOC_Move2D::OnWallContactBegin(int walltype, int wallside)
         {
             StopMove();
             moveStates_ = wallside < 0 ? moveStates_ | MV_DIRECTION : moveStates_ & ~MV_DIRECTION;
-            node_->SetVar(GOA::MOVESTATE, moveStates_);
+            goa_->SetMoveState(moveStates_);
             node_->SendEvent(EVENT_CLIMB);
             break;
         }
 
-        node_->SetVar(GOA::MOVESTATE, moveStates_);
+        goa_->SetMoveState(moveStates_);
         break;
     case Wall_Roof:
         if (moveStates_ & MV_CLIMB)
         {
             numRemainJumps_ = numJumps_;
             moveStates_ = (moveStates_ & ~(MV_INJUMP | MV_INFALL | MV_INAIR)) | defaultStates_ | MV_TOUCHROOF;
-            node_->SetVar(GOA::MOVESTATE, moveStates_);
+            goa_->SetMoveState(moveStates_);
 #ifdef DUMP_DEBUG_MOVEUPDATE
             URHO3D_LOGINFOF("GOC_Move2D() - OnWallContactBegin : Node=%s(%u) Roof", node_->GetName().CString(), node_->GetID());
 #endif
@@ -1732,7 +1750,7 @@ void GOC_Move2D::OnWallContactBegin(int walltype, int wallside)
         else
         {
             moveStates_ = moveStates_ | MV_TOUCHROOF;
-            node_->SetVar(GOA::MOVESTATE, moveStates_);
+            goa_->SetMoveState(moveStates_);
         }
         break;
     }
@@ -1748,7 +1766,7 @@ void GOC_Move2D::OnWallContactEnd(int walltype, int numgroundcontacts, int numco
         if (numgroundcontacts <= 0 && vel_.y_ < -template_->vel_[vFALLMIN])
         {
             moveStates_ = moveStates_ & ~MV_TOUCHGROUND;
-            node_->SetVar(GOA::MOVESTATE, moveStates_);
+            goa_->SetMoveState(moveStates_);
 #ifdef DUMP_DEBUG_MOVEUPDATE
             URHO3D_LOGINFOF("GOC_Move2D() - OnWallContactEnd : Node=%s(%u) Remove MV_TOUCHGROUND ... NumGroundContacts = %d ! (m=%u)", node_->GetName().CString(), node_->GetID(), numgroundcontacts, moveStates_);
 #endif
@@ -1761,7 +1779,7 @@ void GOC_Move2D::OnWallContactEnd(int walltype, int numgroundcontacts, int numco
 #ifdef DUMP_DEBUG_MOVEUPDATE
         URHO3D_LOGINFOF("GOC_Move2D() - OnWallContactEnd : Node=%s(%u) ~MV_TOUCHWALL NumContacts = %d ! (m=%u)", node_->GetName().CString(), node_->GetID(), numcontacts, moveStates_);
 #endif
-        node_->SetVar(GOA::MOVESTATE, moveStates_);
+        goa_->SetMoveState(moveStates_);
         if ((moveStates_ & MV_CLIMB))
         {
             if (numcontacts <= 0)
@@ -1777,7 +1795,7 @@ void GOC_Move2D::OnWallContactEnd(int walltype, int numgroundcontacts, int numco
 #ifdef DUMP_DEBUG_MOVEUPDATE
         URHO3D_LOGINFOF("GOC_Move2D() - OnWallContactEnd : Node=%s(%u) ~MV_TOUCHROOF NumContacts = %d ! (m=%u)", node_->GetName().CString(), node_->GetID(), numcontacts, moveStates_);
 #endif
-        node_->SetVar(GOA::MOVESTATE, moveStates_);
+        goa_->SetMoveState(moveStates_);
         if ((moveStates_ & MV_CLIMB))
         {
             if (numcontacts <= 0)
@@ -1794,7 +1812,7 @@ void GOC_Move2D::OnWallContactEnd(int walltype, int numgroundcontacts, int numco
 //        URHO3D_LOGINFOF("GOC_Move2D() - OnWallContactEnd : Node=%s(%u) no more contact => FALL ! ", node_->GetName().CString(), node_->GetID());
 //    #endif
 //		moveStates_ = (moveStates_ & ~(MSK_MV_TOUCHWALLS|MV_INJUMP)) | MV_INFALL | MV_INAIR;
-//		node_->SetVar(GOA::MOVESTATE, moveStates_);
+//		goa_->SetMoveState(moveStates_);
 //        node_->SendEvent(EVENT_FALL);
 //    }
 }
@@ -5,6 +5,7 @@
 #include <Urho3D/Urho2D/RigidBody2D.h>
 
 #include "DefsMove.h"
+#include "ComponentUpdater.h"
 
 namespace Urho3D
 {
@@ -16,6 +17,7 @@ using namespace Urho3D;
 
 class GOC_Destroyer;
 class GOC_Controller;
+class GOABlock;
 
 enum Velocities
 {
@@ -174,17 +176,21 @@ public :
     void OnWallContactBegin(int walltype, int wallside);
     void OnWallContactEnd(int walltype, int numgroundcontacts, int numcontacts);
 
+    /// Called each frame by the updater
+    void Update(float timeStep);
+
 protected :
     void UpdateAttributes();
 
     virtual void OnNodeSet(Node* node);
 
-    void HandleUpdate(StringHash eventType, VariantMap& eventData);
     void HandleControlUpdate(StringHash eventType, VariantMap& eventData);
     void HandleControlUpdate_Mount(StringHash eventType, VariantMap& eventData);
     void HandleGravityChanged(StringHash eventType, VariantMap& eventData);
 
 private :
+    friend class ComponentUpdater<GOC_Move2D>;
+
     void UpdateLineOfSight();
 
     void Update_Climb();
@@ -201,6 +207,7 @@ private :
 
     GOC_Destroyer* destroyer_;
     GOC_Controller* controller_;
+    GOABlock* goa_;
     WeakPtr<Node> vehicleWheels_;
 
     MoveTypeMode moveType_, lastMoveType_;
@@ -214,6 +221,9 @@ private :
 
     Vector2 vel_, lastvel_;
     float startjumpy_;
+
+    unsigned updaterIndex_;
+    static ComponentUpdater<GOC_Move2D> updater_;
 };
 
 inline void GOC_Move2D::SetLinearVelocity(const Vector2& vel)
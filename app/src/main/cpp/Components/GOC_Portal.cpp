@@ -14,6 +14,7 @@
 #include <Urho3D/Urho2D/PhysicsWorld2D.h>
 
 #include "GameAttributes.h"
+#include "GOABlock.h"
 #include "GameEvents.h"
 #include "GameNetwork.h"
 #include "GameContext.h"
@@ -63,6 +64,7 @@ GOC_Portal::GOC_Portal(Context* context) :
 GOC_Portal::~GOC_Portal()
 {
 //    URHO3D_LOGDEBUG("~GOC_Portal");
+    EventChannel<GoAppearEvent>::Get().Unsubscribe(this);
 }
 
 void GOC_Portal::RegisterObject(Context* context)
@@ -108,10 +110,14 @@ void GOC_Portal::OnNodeSet(Node* node)
     if (node)
     {
         enabled_ = true;
-        SubscribeToEvent(node, GO_APPEAR, URHO3D_HANDLER(GOC_Portal, HandleAppear));
+        EventChannel<GoAppearEvent>::Get().Subscribe<GOC_Portal, &GOC_Portal::HandleAppear>(this, node);
 
         OnSetEnabled();
     }
+    else
+    {
+        EventChannel<GoAppearEvent>::Get().Unsubscribe(this);
+    }
 }
 
 void GOC_Portal::SetDestinationMap(const ShortIntVector2& map)
@@ -181,12 +187,12 @@ void GOC_Portal::Teleport(Node* node)
     teleportedInfos_.Back().nodeid_ = node->GetID();
 }
 
-void GOC_Portal::HandleAppear(StringHash eventType, VariantMap& eventData)
+void GOC_Portal::HandleAppear(Object* sender, const GoAppearEvent& event)
 {
     // if not Destination, randomize map point destination here
     if (!IsDestinationDefined())
     {
-        const ShortIntVector2 mpoint(eventData[Go_Appear::GO_MAP].GetUInt());
+        const ShortIntVector2 mpoint(event.mpoint_);
         const unsigned randseed = node_->GetID();
 
         dMap_.x_ = mpoint.x_ + (GetRand(randseed, 0, 100) > 50 ? 1 : -1) * GetRand(randseed+1, 3, 5);
@@ -230,7 +236,7 @@ void GOC_Portal::HandleBeginContact(StringHash eventType, VariantMap& eventData)
     int allowedControllerType = GameContext::Get().ServerMode_ ? GO_NetPlayer : GO_Player;
 
     if (control && (control->GetControllerType() & (allowedControllerType | GO_AI_Ally)) &&
-        Sign(control->control_.direction_) != Sign(node_->GetVar(GOA::DIRECTION).GetVector2().x_))
+        Sign(control->control_.direction_) != Sign(GOABlock::GetDirection(node_).x_))
     {
         URHO3D_LOGINFOF("GOC_Portal() - HandleBeginContact : nodeID=%u nodeInContact=%s(%u) controllertype=%d allowedControllerType=%d...",
                             node_->GetID(), entity->GetName().CString(), entity->GetID(), control->GetControllerType(), allowedControllerType);
@@ -263,7 +269,7 @@ void GOC_Portal::HandleBeginContact(StringHash eventType, VariantMap& eventData)
             viewport = ViewManager::Get()->GetControllerViewport(mountedController ? mountedController->GetThinker() : control->GetThinker());
 
         URHO3D_LOGINFOF("GOC_Portal() - HandleBeginContact : nodeID=%u nodeInContact=%s(%u) control=%u portaldir=%f controllerdir=%f portal at %s... Try to Get the Destination Map=%s ...",
-                            node_->GetID(), entity->GetName().CString(), entity->GetID(), control, node_->GetVar(GOA::DIRECTION).GetVector2().x_, control ? control->control_.direction_ : 0.f,
+                            node_->GetID(), entity->GetName().CString(), entity->GetID(), control, GOABlock::GetDirection(node_).x_, control ? control->control_.direction_ : 0.f,
                             GetComponent<GOC_Destroyer>()->GetWorldMapPosition().ToString().CString(), dMap_.ToString().CString());
 
         dViewports_.Push(viewport);
@@ -542,7 +548,7 @@ void GOC_Portal::HandleApplyDestination(StringHash eventType, VariantMap& eventD
                 if (destinationArea->GetName() == "GOT_Portal")
                 {
                     // never pop on a portal
-                    newposition.x_+= (int)destinationArea->GetVar(GOA::DIRECTION).GetVector2().x_;
+                    newposition.x_+= (int)GOABlock::GetDirection(destinationArea).x_;
                     // ajust position due to bottom alignement for portal (prevent to collide inside wall for avatar)
                     newposition.y_-= 1;
                     SetDestinationPosition(newposition);
@@ -555,7 +561,7 @@ void GOC_Portal::HandleApplyDestination(StringHash eventType, VariantMap& eventD
                     {
                         newportal->SetDestinationMap(mapposition.mPoint_);
                         // never pop in portal and ajust y position due to bottom alignement for portal (prevent to collide inside wall for avatar)
-                        newportal->SetDestinationPosition(mapposition.mPosition_ + IntVector2((int)node_->GetVar(GOA::DIRECTION).GetVector2().x_, -1));
+                        newportal->SetDestinationPosition(mapposition.mPosition_ + IntVector2((int)GOABlock::GetDirection(node_).x_, -1));
                         newportal->SetDestinationViewZ(mapposition.viewZ_);
                         URHO3D_LOGINFOF("GOC_Portal() - HandleApplyDestination : current portal nodeID=%u => destination portal nodeID=%u desactived for 10sec",
                                         node_->GetID(), destinationArea->GetID());
@@ -3,6 +3,8 @@
 
 using namespace Urho3D;
 
+struct GoAppearEvent;
+
 
 class GOC_Portal : public Component
 {
@@ -40,7 +42,7 @@ private :
     void Desactive();
     void Teleport(Node* node);
 
-    void HandleAppear(StringHash eventType, VariantMap& eventData);
+    void HandleAppear(Object* sender, const GoAppearEvent& event);
     void HandleBeginContact(StringHash eventType, VariantMap& eventData);
     void HandleReactivePortal(StringHash eventType, VariantMap& eventData);
     void HandleApplyDestination(StringHash eventType, VariantMap& eventData);
@@ -17,12 +17,16 @@
 
 const Vector2 DEFAULTSPAWNINTERVAL(10.f, 30.f);
 
+ComponentUpdater<GOC_Spawner> GOC_Spawner::updater_(UPDATER_Spawner);
+
 GOC_Spawner::GOC_Spawner(Context* context) :
-    Component(context), actived_(false), maxLivingSpawnables_(5), spawnInterval_(DEFAULTSPAWNINTERVAL), delay_(0.f)
+    Component(context), actived_(false), maxLivingSpawnables_(5), spawnInterval_(DEFAULTSPAWNINTERVAL), delay_(0.f), updaterIndex_(M_MAX_UNSIGNED)
 { }
 
 GOC_Spawner::~GOC_Spawner()
-{ }
+{
+    updater_.Remove(this);
+}
 
 void GOC_Spawner::RegisterObject(Context* context)
 {
@@ -98,13 +102,14 @@ void GOC_Spawner::UpdateAttributes()
 
     if (GetScene() && IsEnabledEffective() && actived_ && !GameContext::Get().ClientMode_)
     {
-        SubscribeToEvent(GetScene(), E_SCENEUPDATE, URHO3D_HANDLER(GOC_Spawner, HandleUpdate));
-        SubscribeToEvent(GAME_STOP, URHO3D_HANDLER(GOC_Spawner, HandleUpdate));
+        updater_.Add(this);
+        SubscribeToEvent(GAME_STOP, URHO3D_HANDLER(GOC_Spawner, HandleStop));
         spawnDelay_ = Random(spawnInterval_.x_, spawnInterval_.y_);
     }
     else
     {
         UnsubscribeFromAllEvents();
+        updater_.Remove(this);
 
         // Desactive the drawable of the Spawner if exist
 //        if (node_)
@@ -116,15 +121,15 @@ void GOC_Spawner::UpdateAttributes()
     }
 }
 
-void GOC_Spawner::HandleUpdate(StringHash eventType, VariantMap& eventData)
+void GOC_Spawner::HandleStop(StringHash eventType, VariantMap& eventData)
 {
-    if (eventType == GAME_STOP)
-    {
-        UnsubscribeFromAllEvents();
-        return;
-    }
+    UnsubscribeFromAllEvents();
+    updater_.Remove(this);
+}
 
-    delay_ += eventData[SceneUpdate::P_TIMESTEP].GetFloat();
+void GOC_Spawner::Update(float timeStep)
+{
+    delay_ += timeStep;
     if (delay_ > spawnDelay_)
     {
         spawnDelay_ = Random(spawnInterval_.x_, spawnInterval_.y_);
@@ -133,11 +138,11 @@ void GOC_Spawner::HandleUpdate(StringHash eventType, VariantMap& eventData)
         // check for max living spawnables
         if (spawnables_.Size() >= maxLivingSpawnables_)
         {
-//            URHO3D_LOGINFOF("GOC_Spawner() - HandleUpdate : Check Living Spawnables ...");
+//            URHO3D_LOGINFOF("GOC_Spawner() - Update : Check Living Spawnables ...");
             unsigned i = 0;
             while (i < spawnables_.Size())
             {
-//                URHO3D_LOGINFOF("GOC_Spawner() - HandleUpdate : spawnables_[%u] = %s(%u) inpool=%s", i, spawnables_[i] ? spawnables_[i]->GetName().CString() : "none", spawnables_[i] ? spawnables_[i]->GetID() : 0,
+//                URHO3D_LOGINFOF("GOC_Spawner() - Update : spawnables_[%u] = %s(%u) inpool=%s", i, spawnables_[i] ? spawnables_[i]->GetName().CString() : "none", spawnables_[i] ? spawnables_[i]->GetID() : 0,
 //                                spawnables_[i] ? (ObjectPool::IsInPool(spawnables_[i]) ? "true":"false") : "false");
 
                 if (!spawnables_[i] || ObjectPool::IsInPool(spawnables_[i]))
@@ -151,7 +156,7 @@ void GOC_Spawner::HandleUpdate(StringHash eventType, VariantMap& eventData)
         {
             // Spawn
             const StringHash& got = GameHelpers::GetRandomMonsters(spawnableObjectTypes_.Size() ? &spawnableObjectTypes_ : 0);
-//            URHO3D_LOGINFOF("GOC_Spawner() - HandleUpdate : numSpawnableObjects = %u, spawn index = %u", numSpawnableObjects, index);
+//            URHO3D_LOGINFOF("GOC_Spawner() - Update : numSpawnableObjects = %u, spawn index = %u", numSpawnableObjects, index);
 
             PhysicEntityInfo physicInfo;
             physicInfo.positionx_ = node_->GetWorldPosition2D().x_;
@@ -179,7 +184,7 @@ void GOC_Spawner::HandleUpdate(StringHash eventType, VariantMap& eventData)
         }
         else
         {
-            URHO3D_LOGINFOF("GOC_Spawner() - HandleUpdate : Max Living Spawnables Reached (%u)", maxLivingSpawnables_);
+            URHO3D_LOGINFOF("GOC_Spawner() - Update : Max Living Spawnables Reached (%u)", maxLivingSpawnables_);
         }
     }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ComponentUpdater.h"
 
 using namespace Urho3D;
 
@@ -29,12 +30,17 @@ public :
 
     virtual void OnSetEnabled();
 
+    /// Called each frame by the updater while actived
+    void Update(float timeStep);
+
 protected :
     virtual void OnNodeSet(Node* node);
 
 private :
+    friend class ComponentUpdater<GOC_Spawner>;
+
     void UpdateAttributes();
-    void HandleUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleStop(StringHash eventType, VariantMap& eventData);
 
     bool actived_;
     int maxLivingSpawnables_;
@@ -42,6 +48,9 @@ private :
     float spawnDelay_, delay_;
     Vector<StringHash> spawnableObjectTypes_;
     Vector<WeakPtr<Node> > spawnables_;
+
+    unsigned updaterIndex_;
+    static ComponentUpdater<GOC_Spawner> updater_;
 };
 
 
@@ -362,6 +362,7 @@ void FluidDatas::Resize(int index, unsigned width, unsigned height)
         height_ = height;
         fluidmap_.Resize(width*height);
         linkedCells_ = false;
+        renderStamp_++;
 
         for (FluidMap::Iterator it=fluidmap_.Begin(); it != fluidmap_.End(); ++it)
             it->Clear();
@@ -431,11 +432,17 @@ void FluidDatas::LinkInnerCells(FluidDatas* depthZ)
             fluidmap_[addr].LinkDepthCell(0);
     }
 
+    depthDatas_ = depthZ;
     linkedCells_ = true;
 }
 
 void FluidDatas::LinkBorderCells(int direction, FluidDatas& fluidData)
 {
+    renderStamp_++;
+
+    if (direction < MapDirection::NoBorders)
+        linkedDatas_[direction] = &fluidData;
+
     switch (direction)
     {
     case MapDirection::North:
@@ -469,6 +476,8 @@ void FluidDatas::UnLinkBorderCells(int direction)
     if (!fluidmap_.Size())
         return;
 
+    renderStamp_++;
+
     switch (direction)
     {
     case MapDirection::AllBorders:
@@ -477,6 +486,7 @@ void FluidDatas::UnLinkBorderCells(int direction)
         // Top Border Cells
         for (unsigned x = 0; x < width_; x++)
             fluidmap_[x].Top = 0;
+        ReturnBorderFlows(MapDirection::North);
         if (direction == MapDirection::North)
             break;
 
@@ -484,6 +494,7 @@ void FluidDatas::UnLinkBorderCells(int direction)
         // Bottom Border Cells
         for (unsigned x = 0; x < width_; x++)
             fluidmap_[(height_-1)*width_+x].Bottom = 0;
+        ReturnBorderFlows(MapDirection::South);
         if (direction == MapDirection::South)
             break;
 
@@ -491,6 +502,7 @@ void FluidDatas::UnLinkBorderCells(int direction)
         // Right Border Cells
         for (unsigned y = 0; y < height_; y++)
             fluidmap_[y*width_+width_-1].Right = 0;
+        ReturnBorderFlows(MapDirection::East);
         if (direction == MapDirection::East)
             break;
 
@@ -498,11 +510,47 @@ void FluidDatas::UnLinkBorderCells(int direction)
         // Left Border Cells
         for (unsigned y = 0; y < height_; y++)
             fluidmap_[y*width_].Left = 0;
+        ReturnBorderFlows(MapDirection::West);
         if (direction == MapDirection::West)
             break;
     }
 }
 
+void FluidDatas::ReturnBorderFlows(int direction)
+{
+    linkedDatas_[direction] = 0;
+
+    const unsigned numSideCells = FluidGridPlanes::GetNumSideCells(width_, height_);
+    if (haloFlows_.Size() != numSideCells)
+        return;
+
+    // the flows not pulled by the unlinked map go back to the border cells
+    const int offset = FluidGridPlanes::GetSideOffset(direction, width_, height_);
+    const int length = direction < MapDirection::East ? width_ : height_;
+    for (int k = 0; k < length; k++)
+    {
+        float& flow = haloFlows_[offset+k];
+        if (flow != 0.f)
+        {
+            FluidCell& cell = fluidmap_[GetBorderAddr(direction, k)];
+            if (cell.type_ != BLOCK)
+            {
+                cell.flowC_ += flow;
+                cell.Update();
+                WakeCell(GetBorderAddr(direction, k));
+            }
+            flow = 0.f;
+        }
+        haloMoved_[offset+k] = 0;
+    }
+}
+
+unsigned FluidDatas::GetBorderAddr(int direction, int k)
+{
+    return direction == MapDirection::North ? k : direction == MapDirection::South ? (height_-1)*width_ + k :
+           direction == MapDirection::East ? k*width_ + width_-1 : k*width_;
+}
+
 void FluidDatas::Clear()
 {
     Pull();
@@ -523,7 +571,9 @@ void FluidDatas::Pull()
             it->Clear();
     }
 
-    lastFrameUpdate_ = 0U;
+    WakeAll();
+
+    lastTickUpdate_ = 0U;
 }
 
 const float fluidFromIntToFloat = (FLUID_MAXVALUE + FLUID_MAXCOMPRESSIONVALUE) / 255.f;
@@ -589,6 +639,8 @@ void FluidDatas::SetCells()
 #ifdef DUMP_MAPDEBUG_FLUIDVIEW
     GameHelpers::DumpData(&fluidmap_[0], 1, 2, width_, height_);
 #endif
+
+    WakeAll();
 }
 
 // TODO ASYNC
@@ -619,3 +671,389 @@ bool FluidDatas::UpdateMapData(HiresTimer* timer)
     return true;
 }
 
+
+inline void LoadGridHaloCell(FluidGridPlanes& grid, int index, const FluidCell* cell)
+{
+    grid.solid_[index] = cell ? (cell->type_ == BLOCK ? FGS_Block : FGS_Open) : FGS_Void;
+    grid.mass_[grid.read_][index] = cell && cell->type_ != BLOCK ? cell->massC_ : 0.f;
+}
+
+void FluidDatas::UpdateSources()
+{
+    for (PODVector<FluidSource>::Iterator it=sources_.Begin(); it!=sources_.End(); ++it)
+    {
+        if (it->quantity_ < 0)
+            continue;
+
+        FluidSource& source = *it;
+
+        const unsigned addr = width_ * source.starty_ + source.startx_;
+        fluidmap_[addr].AddFluid(source.fluid_, source.flow_);
+        WakeCell(addr);
+        source.quantity_ -= source.flow_;
+    }
+}
+
+// border exchange of a fluid map (see FluidGridPullSide and FluidGridExportBorder)
+struct FluidDatasBorder
+{
+    FluidDatasBorder(FluidDatas& datas) : datas_(datas) { }
+
+    void ReceiveBorderFlow(int side, int k, float flow)
+    {
+        static const int flowdirs[4] = { FD_Top, FD_Bottom, FD_Right, FD_Left };
+
+        const unsigned addr = FluidDatas::GetBorderAddr(side, k);
+        FluidCell& cell = datas_.fluidmap_[addr];
+        if (cell.type_ != BLOCK)
+        {
+            cell.flowC_ += flow;
+            if (flow > 0.f)
+                cell.flowdir_ |= flowdirs[side];
+            cell.SetState(FluidCell::SETTLED, false);
+            cell.Update();
+        }
+        datas_.WakeCell(addr);
+    }
+
+    void GetBorderCell(int side, int k, unsigned char& solid, float& mass) const
+    {
+        const FluidCell& cell = datas_.fluidmap_[FluidDatas::GetBorderAddr(side, k)];
+        solid = cell.type_ == BLOCK ? FGS_Block : FGS_Open;
+        mass = cell.type_ == BLOCK ? 0.f : cell.massC_;
+    }
+
+    FluidDatas& datas_;
+};
+
+void FluidDatas::PullBorderFlows()
+{
+    const unsigned numSideCells = FluidGridPlanes::GetNumSideCells(width_, height_);
+    FluidDatasBorder border(*this);
+
+    for (int side = 0; side < NUM_FLUIDGRIDSIDES; side++)
+    {
+        FluidDatas* linked = linkedDatas_[side];
+        if (!linked || linked->haloFlows_.Size() != numSideCells)
+            continue;
+
+        FluidGridPullSide(border, side, width_, height_, &linked->haloFlows_[0], &linked->haloMoved_[0]);
+    }
+}
+
+void FluidDatas::AllocateSideBuffers()
+{
+    const unsigned numSideCells = FluidGridPlanes::GetNumSideCells(width_, height_);
+    if (haloFlows_.Size() == numSideCells)
+        return;
+
+    borderMass_.Resize(numSideCells);
+    borderSolid_.Resize(numSideCells);
+    haloMass_.Resize(numSideCells);
+    haloFlows_.Resize(numSideCells);
+    haloMoved_.Resize(numSideCells);
+    memset(&borderSolid_[0], FGS_Void, numSideCells);
+    memset(&haloFlows_[0], 0, numSideCells * sizeof(float));
+    memset(&haloMoved_[0], 0, numSideCells);
+}
+
+void FluidDatas::ExportBorder()
+{
+    if (borderMass_.Size() != FluidGridPlanes::GetNumSideCells(width_, height_))
+        return;
+
+    FluidGridExportBorder(FluidDatasBorder(*this), width_, height_, &borderSolid_[0], &borderMass_[0]);
+}
+
+void FluidDatas::PrepareGrid()
+{
+    const unsigned numfloats = FluidGridPlanes::GetNumFloats(width_, height_);
+    const unsigned numbytes = FluidGridPlanes::GetNumBytes(width_, height_);
+    const bool resized = gridFloats_.Size() != numfloats || gridBytes_.Size() != numbytes;
+    if (resized)
+    {
+        gridFloats_.Resize(numfloats);
+        gridBytes_.Resize(numbytes);
+    }
+
+    grid_.Bind(&gridFloats_[0], &gridBytes_[0], width_, height_);
+
+    if (resized)
+    {
+        memset(&gridFloats_[0], 0, numfloats * sizeof(float));
+        memset(grid_.solid_, FGS_Void, grid_.size_);
+        memset(grid_.stable_, 0, numbytes - grid_.size_);
+        grid_.WakeAll();
+    }
+
+#ifdef FLUID_SIMULATION_INTERPOLATE
+    if (tickMass_.Size() != width_ * height_)
+    {
+        tickMass_.Resize(width_ * height_);
+        memset(&tickMass_[0], 0, tickMass_.Size() * sizeof(float));
+    }
+    else
+    {
+        // end of the interpolation of the last tick : restore the simulated masses
+        InterpolateGrid(1.f);
+    }
+#endif
+
+    for (int b = 0; b < grid_.numBlocks_; b++)
+        grid_.blocks_[b] &= ~FGB_Touched;
+
+    FluidGridPrepareBlocks(grid_);
+}
+
+void FluidDatas::LoadGrid()
+{
+    const int width = width_;
+    const int height = height_;
+    float* mass = grid_.GetReadMass();
+    float* outD = grid_.out_[FGF_DepthZ];
+    float* tickMass = tickMass_.Size() ? &tickMass_[0] : 0;
+
+    for (int by = 0; by < grid_.blocksY_; by++)
+    {
+        const int y0 = by << FLUID_BLOCKSHIFT;
+        const int y1 = Min(y0 + FLUID_BLOCKSIZE, height);
+
+        for (int bx = 0; bx < grid_.blocksX_; bx++)
+        {
+            if (!grid_.IsBlockSimulated(by * grid_.blocksX_ + bx))
+                continue;
+
+            const int x0 = bx << FLUID_BLOCKSHIFT;
+            const int x1 = Min(x0 + FLUID_BLOCKSIZE, width);
+
+            for (int y = y0; y < y1; y++)
+            {
+                unsigned addr = y * width + x0;
+                int index = grid_.GetIndex(x0, y);
+                for (int x = x0; x < x1; x++, addr++, index++)
+                {
+                    const FluidCell& cell = fluidmap_[addr];
+
+                    outD[index] = 0.f;
+
+                    if (tickMass)
+                        tickMass[addr] = cell.type_ != BLOCK ? cell.massC_ : 0.f;
+
+                    if (cell.type_ == BLOCK)
+                    {
+                        grid_.solid_[index] = FGS_Block;
+                        grid_.stable_[index] = FLUID_SETTLEDCOUNT;
+                        grid_.depth_[index] = FGD_None;
+                        mass[index] = 0.f;
+                        continue;
+                    }
+
+                    grid_.solid_[index] = FGS_Open;
+                    grid_.stable_[index] = cell.HasState(FluidCell::SETTLED) ? FLUID_SETTLEDCOUNT : (unsigned char)Min(cell.stateCount_, FLUID_SETTLEDCOUNT-1);
+                    mass[index] = cell.massC_;
+
+                    if (cell.DepthZ)
+                    {
+                        grid_.depth_[index] = cell.DepthZ->type_ != BLOCK && (!cell.featCheck_ || (*cell.featCheck_) <= MapFeatureType::Threshold) ? FGD_Flow : FGD_None;
+                        grid_.depthMass_[index] = cell.DepthZ->massC_;
+                    }
+                    else
+                        grid_.depth_[index] = FGD_None;
+                }
+            }
+        }
+    }
+
+    // halo : the borders exported by the linked maps
+    const unsigned numSideCells = FluidGridPlanes::GetNumSideCells(width, height);
+    for (int side = 0; side < NUM_FLUIDGRIDSIDES; side++)
+    {
+        const FluidDatas* linked = linkedDatas_[side];
+        const int offset = FluidGridPlanes::GetSideOffset(side, width, height);
+
+        if (linked && linked->borderSolid_.Size() == numSideCells)
+        {
+            const int linkedOffset = FluidGridPlanes::GetSideOffset(MapDirection::Inverse(side), width, height);
+            FluidGridLoadHalo(grid_, side, &linked->borderMass_[linkedOffset], &linked->borderSolid_[linkedOffset], &haloFlows_[offset]);
+        }
+        // the linked map has never been simulated : use its cells
+        else
+        {
+            const int length = grid_.GetSideLength(side);
+            for (int k = 0; k < length; k++)
+            {
+                const FluidCell& cell = fluidmap_[GetBorderAddr(side, k)];
+                const FluidCell* linkedCell = side == MapDirection::North ? cell.Top : side == MapDirection::South ? cell.Bottom : side == MapDirection::East ? cell.Right : cell.Left;
+                const int index = grid_.GetHaloIndex(side, k);
+                LoadGridHaloCell(grid_, index, linked ? linkedCell : 0);
+                if (grid_.solid_[index] == FGS_Open)
+                    mass[index] += haloFlows_[offset+k];
+            }
+        }
+    }
+
+    FluidGridSaveHalo(grid_, &haloMass_[0]);
+}
+
+void FluidDatas::StoreGrid()
+{
+    const int width = width_;
+    const int height = height_;
+    const int s = grid_.stride_;
+    const float* mass = grid_.GetReadMass();
+    const float* outB = grid_.out_[FGF_Bottom];
+    const float* outL = grid_.out_[FGF_Left];
+    const float* outR = grid_.out_[FGF_Right];
+    const float* outT = grid_.out_[FGF_Top];
+    const float* outD = grid_.out_[FGF_DepthZ];
+    bool changed = false;
+
+    for (int by = 0; by < grid_.blocksY_; by++)
+    {
+        const int y0 = by << FLUID_BLOCKSHIFT;
+        const int y1 = Min(y0 + FLUID_BLOCKSIZE, height);
+
+        for (int bx = 0; bx < grid_.blocksX_; bx++)
+        {
+            // only the blocks simulated since the LoadGrid
+            if (!(grid_.blocks_[by * grid_.blocksX_ + bx] & FGB_Touched))
+                continue;
+
+            const int x0 = bx << FLUID_BLOCKSHIFT;
+            const int x1 = Min(x0 + FLUID_BLOCKSIZE, width);
+
+            for (int y = y0; y < y1; y++)
+            {
+                unsigned addr = y * width + x0;
+                int index = grid_.GetIndex(x0, y);
+                for (int x = x0; x < x1; x++, addr++, index++)
+                {
+                    FluidCell& cell = fluidmap_[addr];
+
+                    if (cell.type_ == BLOCK)
+                        continue;
+
+                    const bool keepFlowDir = cell.type_ < WATER || cell.HasState(FluidCell::SETTLED);
+
+                    const float m = mass[index];
+                    if (m != cell.massC_)
+                    {
+                        changed = true;
+                        if (m == 0.f)
+                        {
+                            cell.Reset();
+                        }
+                        else
+                        {
+                            cell.type_ = WATER;
+                            cell.massC_ = m;
+                            cell.UpdateMass();
+                        }
+                    }
+
+                    if (cell.type_ >= WATER)
+                    {
+                        int flowdir = keepFlowDir ? cell.flowdir_ : FD_None;
+                        if (outB[index] > 0.f || outT[index+s] > 0.f)
+                            flowdir |= FD_Bottom;
+                        if (outT[index] > 0.f || outB[index-s] > 0.f)
+                            flowdir |= FD_Top;
+                        if (outL[index] > 0.f || outR[index-1] > 0.f)
+                            flowdir |= FD_Left;
+                        if (outR[index] > 0.f || outL[index+1] > 0.f)
+                            flowdir |= FD_Right;
+                        cell.flowdir_ = flowdir;
+                    }
+
+                    cell.SetState(FluidCell::SETTLED, grid_.stable_[index] >= FLUID_SETTLEDCOUNT);
+                    cell.stateCount_ = grid_.stable_[index];
+
+                    if (cell.DepthZ)
+                    {
+                        if (outD[index] != 0.f)
+                        {
+                            cell.DepthZ->flowC_ += outD[index];
+                            cell.DepthZ->SetState(FluidCell::SETTLED, false);
+                            cell.DepthZ->Update();
+                            if (depthDatas_)
+                                depthDatas_->WakeCell(addr);
+                        }
+                        else if (grid_.change_[index] & FGC_Moved)
+                        {
+                            cell.DepthZ->SetState(FluidCell::SETTLED, false);
+                            if (depthDatas_)
+                                depthDatas_->WakeCell(addr);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // halo : keep the flows sent to the linked maps, they are pulled before their next simulation
+    FluidGridCollectHaloFlows(grid_, &haloMass_[0], &haloFlows_[0], &haloMoved_[0]);
+
+    if (changed)
+        renderStamp_++;
+}
+
+void FluidDatas::InterpolateGrid(float alpha)
+{
+    if (!tickMass_.Size() || !grid_.numBlocks_)
+        return;
+
+    const int width = width_;
+    const int height = height_;
+
+    for (int by = 0; by < grid_.blocksY_; by++)
+    {
+        const int y0 = by << FLUID_BLOCKSHIFT;
+        const int y1 = Min(y0 + FLUID_BLOCKSIZE, height);
+
+        for (int bx = 0; bx < grid_.blocksX_; bx++)
+        {
+            // the other blocks have not changed in the last tick
+            if (!(grid_.blocks_[by * grid_.blocksX_ + bx] & FGB_Touched))
+                continue;
+
+            renderStamp_++;
+
+            const int x0 = bx << FLUID_BLOCKSHIFT;
+            const int x1 = Min(x0 + FLUID_BLOCKSIZE, width);
+
+            for (int y = y0; y < y1; y++)
+            {
+                unsigned addr = y * width + x0;
+                for (int x = x0; x < x1; x++, addr++)
+                {
+                    FluidCell& cell = fluidmap_[addr];
+                    if (cell.type_ >= WATER)
+                        cell.mass_ = alpha < 1.f ? tickMass_[addr] + (cell.massC_ - tickMass_[addr]) * alpha : cell.massC_;
+                }
+            }
+        }
+    }
+}
+
+void FluidDatas::WakeCell(unsigned addr)
+{
+    renderStamp_++;
+
+    // the grid is not allocated yet : all the blocks are woken at the allocation
+    if (gridBytes_.Size() != FluidGridPlanes::GetNumBytes(width_, height_))
+        return;
+
+    grid_.Bind(&gridFloats_[0], &gridBytes_[0], width_, height_);
+    grid_.WakeCell(addr % width_, addr / width_);
+}
+
+void FluidDatas::WakeAll()
+{
+    renderStamp_++;
+
+    if (gridBytes_.Size() != FluidGridPlanes::GetNumBytes(width_, height_))
+        return;
+
+    grid_.Bind(&gridFloats_[0], &gridBytes_[0], width_, height_);
+    grid_.WakeAll();
+}
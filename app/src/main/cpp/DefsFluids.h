@@ -3,6 +3,7 @@
 #include <Urho3D/Urho2D/Drawable2D.h>
 
 #include "MapFeatureTypes.h"
+#include "FluidGrid.h"
 
 
 using namespace Urho3D;
@@ -10,23 +11,6 @@ using namespace Urho3D;
 const float FLUID_MINDRAWF = PIXEL_SIZE * 3.f;
 const float FLUID_MAXDRAWF = 1.0f;
 
-// Max and min cell liquid values
-const float FLUID_MAXVALUE = 1.0f;
-const float FLUID_MINVALUE = 0.05f;
-
-// Extra liquid a cell can store than the cell above it
-const float FLUID_MAXCOMPRESSIONVALUE = 0.1f;
-
-//const float FLUID_GROUNDIMPREGNATION = 0.001f;
-//const float FLUID_MINGROUNDSATURATIONVALUE = 2.f*FLUID_MINVALUE;
-
-// Lowest and highest amount of liquids allowed to flow per iteration
-const float FLUID_MINflowValue_ = 0.01f;
-const float FLUID_MAXflowValue_ = 1.2f;
-
-// Adjusts flow speed (0.0f - 1.0f)
-const float FLUID_FLOWSPEED = 1.0f;
-
 enum MaterialType
 {
     AIR         = 0,
@@ -558,7 +542,10 @@ struct ObjectFeatured;
 
 struct FluidDatas
 {
-    FluidDatas() : lastFrameUpdate_(0U), viewZ_(0), indexFluidZ_(0), featureMap_(0), checkMap_(0), linkedCells_(false) { }
+    FluidDatas() : lastTickUpdate_(0U), renderStamp_(0U), viewZ_(0), indexFluidZ_(0), featureMap_(0), checkMap_(0), depthDatas_(0), linkedCells_(false)
+    {
+        linkedDatas_[0] = linkedDatas_[1] = linkedDatas_[2] = linkedDatas_[3] = 0;
+    }
     void Resize(int index, unsigned width, unsigned height);
 
     void LinkFeatureMaps(ObjectFeatured* features, PODVector<FeatureType>* featureMap, PODVector<FeatureType>* checkMap)
@@ -576,9 +563,36 @@ struct FluidDatas
     void SetCells();
     bool UpdateMapData(HiresTimer* timer);
 
+    /// Add the fluid of the sources
+    void UpdateSources();
+    /// Allocate the side buffers of the border exchange, in the main thread before the exchange : the linked maps use them in parallel
+    void AllocateSideBuffers();
+    /// Apply the flows sent by the linked maps to the border cells
+    void PullBorderFlows();
+    /// Copy the border cells for the halos of the linked maps
+    void ExportBorder();
+    /// Allocate the simulation grid and select the blocks to simulate
+    void PrepareGrid();
+    /// Copy the cells of the simulated blocks (and the exported borders of the linked maps) in the simulation grid
+    void LoadGrid();
+    /// Copy back the simulation grid in the cells and keep the flows sent to the linked maps
+    void StoreGrid();
+    /// Set the rendered masses of the simulated cells between the masses of the last two ticks (FLUID_SIMULATION_INTERPOLATE)
+    void InterpolateGrid(float alpha);
+    /// Wake the simulation blocks around the cell (after a change of the tile or of the fluid)
+    void WakeCell(unsigned addr);
+    void WakeAll();
+
+    int GetNumActiveBlocks() const { return grid_.numActiveBlocks_; }
+    int GetNumBlocks() const { return grid_.numBlocks_; }
+
+    static unsigned GetBorderAddr(int direction, int k);
+
     ObjectFeatured* features_;
 
-    unsigned lastFrameUpdate_;
+    unsigned lastTickUpdate_;
+    // incremented at each change of the cells seen by the render (see WaterLayer tile caches)
+    unsigned renderStamp_;
 
     int viewZ_;
     int indexFluidZ_;
@@ -589,8 +603,31 @@ struct FluidDatas
     FluidMap fluidmap_;
     PODVector<FluidSource> sources_;
 
+    FluidDatas* depthDatas_;
+    // fluid datas of the linked maps by MapDirection
+    FluidDatas* linkedDatas_[4];
+
+    // border exchange with the linked maps (see FluidGridPlanes side buffers)
+    PODVector<float> borderMass_;
+    PODVector<unsigned char> borderSolid_;
+    PODVector<float> haloMass_;
+    PODVector<float> haloFlows_;
+    PODVector<unsigned char> haloMoved_;
+
+    // structure-of-arrays simulation grid
+    FluidGridPlanes grid_;
+    PODVector<float> gridFloats_;
+    PODVector<unsigned char> gridBytes_;
+    // masses of the cells at the start of the tick, for the interpolation
+    PODVector<float> tickMass_;
+
     bool linkedCells_;
 
+private:
+    void ReturnBorderFlows(int direction);
+
+public:
+
     static unsigned width_, height_;
 };
 
@@ -12,6 +12,7 @@
 #include "DefsViews.h"
 #include "DefsColliders.h"
 
+#include "MapAreaFlags.h"
 #include "MapFeatureTypes.h"
 #include "MapTiles.h"
 
@@ -87,6 +88,15 @@ typedef PODVector<FeatureType> FeaturedMap;
 typedef PODVector<ConnectIndex> ConnectedMap;
 typedef PODVector<Tile* > TiledMap;
 
+// the storages of the map buffers : size in bytes by address (MapPool counts the allocations of a map swap)
+typedef HashMap<unsigned long long, unsigned> MapBuffers;
+
+template <class T> inline void AddMapBuffer(MapBuffers& buffers, const T& buffer)
+{
+    if (buffer.Capacity())
+        buffers[(unsigned long long)(size_t)buffer.Buffer()] = buffer.Capacity() * sizeof(*buffer.Buffer());
+}
+
 typedef anl::SMappingRanges AnlMappingRange;
 
 const float MAPMASS = 100.f;
@@ -104,17 +114,6 @@ enum Direction
     AllDir = 15
 };
 
-enum AreaFlag
-{
-    nomoveFlag         = 0x0000,
-    walkableFlag       = 0x0001,
-    jumpableRightFlag  = 0x0002,
-    jumpableLeftFlag   = 0x0004,
-    jumpableFlag       = jumpableRightFlag | jumpableLeftFlag,
-    flyableFlag        = 0x0008,
-    swimmableFlag      = 0x0010
-};
-
 enum WallType
 {
     Wall_Ground = 0,
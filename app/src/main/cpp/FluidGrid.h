@@ -0,0 +1,859 @@
+#pragma once
+
+// Max and min cell liquid values
+const float FLUID_MAXVALUE = 1.0f;
+const float FLUID_MINVALUE = 0.05f;
+
+// Extra liquid a cell can store than the cell above it
+const float FLUID_MAXCOMPRESSIONVALUE = 0.1f;
+
+//const float FLUID_GROUNDIMPREGNATION = 0.001f;
+//const float FLUID_MINGROUNDSATURATIONVALUE = 2.f*FLUID_MINVALUE;
+
+// Lowest and highest amount of liquids allowed to flow per iteration
+const float FLUID_MINflowValue_ = 0.01f;
+const float FLUID_MAXflowValue_ = 1.2f;
+
+// Adjusts flow speed (0.0f - 1.0f)
+const float FLUID_FLOWSPEED = 1.0f;
+
+// Number of iterations without mass change before a cell is settled
+const unsigned char FLUID_SETTLEDCOUNT = 10;
+
+// Activity blocks of 8x8 cells
+const int FLUID_BLOCKSHIFT = 3;
+const int FLUID_BLOCKSIZE = 1 << FLUID_BLOCKSHIFT;
+
+// Number of iterations without change before an active block sleeps
+const unsigned char FLUID_BLOCKSLEEPCOUNT = 10;
+
+
+inline float FluidMin(float a, float b)
+{
+    return a < b ? a : b;
+}
+inline float FluidMax(float a, float b)
+{
+    return a > b ? a : b;
+}
+inline float FluidClamp(float value, float min, float max)
+{
+    return value < min ? min : (value > max ? max : value);
+}
+
+// Calculate how much liquid should flow to Vertical destination with pressure
+inline float CalculateFlow(float totalmass)
+{
+    if (totalmass <= FLUID_MAXVALUE)
+        return FLUID_MAXVALUE;
+    else if (totalmass < 2.f * FLUID_MAXVALUE + FLUID_MAXCOMPRESSIONVALUE)
+        return (FLUID_MAXVALUE * FLUID_MAXVALUE + totalmass * FLUID_MAXCOMPRESSIONVALUE) / (FLUID_MAXVALUE + FLUID_MAXCOMPRESSIONVALUE);
+    else
+        return (totalmass + FLUID_MAXCOMPRESSIONVALUE) * 0.5f;
+}
+
+
+enum FluidGridSolid
+{
+    FGS_Open = 0,
+    FGS_Block,
+    FGS_Void        // no cell (world border or unlinked map)
+};
+
+enum FluidGridChange
+{
+    FGC_Idle = 0,
+    FGC_Stable = 1, // simulated without mass change
+    FGC_Moved = 2   // simulated with flows : unsettles the neighbors
+};
+
+enum FluidGridDepth
+{
+    FGD_None = 0,
+    FGD_Flow = 1    // the cell can flow into its depthZ cell
+};
+
+enum FluidGridBlock
+{
+    FGB_Asleep = 0,
+    FGB_Active = 1,     // simulated
+    FGB_Border = 2,     // asleep next to an active block : only receives the incoming flows
+    FGB_Busy = 4,       // flows or unsettled liquid in the last iteration
+    FGB_Touched = 8     // simulated since the last load of the grid
+};
+
+// Sides of the grid in the MapDirection order
+enum FluidGridSide
+{
+    FGH_North = 0,
+    FGH_South,
+    FGH_East,
+    FGH_West,
+    NUM_FLUIDGRIDSIDES
+};
+
+enum FluidGridFlow
+{
+    FGF_Bottom = 0,
+    FGF_Left,
+    FGF_Right,
+    FGF_Top,
+    FGF_DepthZ,
+    NUM_FLUIDGRIDFLOWS
+};
+
+/// FluidGridPlanes : structure-of-arrays view of a fluid map used by the simulation.
+/// Each plane has a one-cell halo ring (stride = width+2) that mirrors the border cells of the linked maps,
+/// so the neighbors of a cell are reached by index arithmetic. The masses are double-buffered : the flows are
+/// computed from the read buffer and the new masses are written in the write buffer.
+/// The cells are grouped in blocks of FLUID_BLOCKSIZE² : only the active blocks are simulated, a block sleeps after
+/// FLUID_BLOCKSLEEPCOUNT iterations without change and is woken by the flows of its neighbors or by WakeCell.
+struct FluidGridPlanes
+{
+    enum
+    {
+        NUM_FLOATPLANES = 8,
+        NUM_BYTEPLANES = 4
+    };
+
+    FluidGridPlanes() :
+        width_(0), height_(0), stride_(0), size_(0), read_(0), blocksX_(0), blocksY_(0), numBlocks_(0), numActiveBlocks_(0) { }
+
+    static int GetNumBlocks(int size)
+    {
+        return (size + FLUID_BLOCKSIZE - 1) >> FLUID_BLOCKSHIFT;
+    }
+    static unsigned GetNumFloats(int width, int height)
+    {
+        return NUM_FLOATPLANES * (width+2) * (height+2);
+    }
+    static unsigned GetNumBytes(int width, int height)
+    {
+        return NUM_BYTEPLANES * (width+2) * (height+2) + 2 * GetNumBlocks(width) * GetNumBlocks(height);
+    }
+
+    /// Slice the planes in the given buffers (GetNumFloats and GetNumBytes sized)
+    void Bind(float* floats, unsigned char* bytes, int width, int height)
+    {
+        width_ = width;
+        height_ = height;
+        stride_ = width + 2;
+        size_ = stride_ * (height + 2);
+
+        mass_[0]   = floats;
+        mass_[1]   = floats + size_;
+        out_[FGF_Bottom] = floats + 2 * size_;
+        out_[FGF_Left]   = floats + 3 * size_;
+        out_[FGF_Right]  = floats + 4 * size_;
+        out_[FGF_Top]    = floats + 5 * size_;
+        depthMass_ = floats + 6 * size_;
+        out_[FGF_DepthZ] = floats + 7 * size_;
+
+        solid_   = bytes;
+        stable_  = bytes + size_;
+        change_  = bytes + 2 * size_;
+        depth_   = bytes + 3 * size_;
+
+        blocksX_ = GetNumBlocks(width);
+        blocksY_ = GetNumBlocks(height);
+        numBlocks_ = blocksX_ * blocksY_;
+        blocks_ = bytes + NUM_BYTEPLANES * size_;
+        blockQuiet_ = blocks_ + numBlocks_;
+    }
+
+    void WakeAll()
+    {
+        for (int b = 0; b < numBlocks_; b++)
+        {
+            blocks_[b] |= FGB_Active;
+            blockQuiet_[b] = 0;
+        }
+        numActiveBlocks_ = numBlocks_;
+    }
+    /// Wake the blocks around the map cell (x,y)
+    void WakeCell(int x, int y)
+    {
+        const int bx0 = x > 0 ? (x-1) >> FLUID_BLOCKSHIFT : 0;
+        const int by0 = y > 0 ? (y-1) >> FLUID_BLOCKSHIFT : 0;
+        const int bx1 = x+1 < width_ ? (x+1) >> FLUID_BLOCKSHIFT : blocksX_-1;
+        const int by1 = y+1 < height_ ? (y+1) >> FLUID_BLOCKSHIFT : blocksY_-1;
+
+        for (int by = by0; by <= by1; by++)
+            for (int bx = bx0; bx <= bx1; bx++)
+            {
+                const int b = by * blocksX_ + bx;
+                if (!(blocks_[b] & FGB_Active))
+                    numActiveBlocks_++;
+                blocks_[b] |= FGB_Active;
+                blockQuiet_[b] = 0;
+            }
+    }
+    bool IsBlockSimulated(int b) const
+    {
+        return (blocks_[b] & (FGB_Active | FGB_Border)) != 0;
+    }
+
+    /// Index in the planes of the map cell (x,y), the halo is at x|y = -1 and x=width|y=height
+    int GetIndex(int x, int y) const
+    {
+        return (y + 1) * stride_ + x + 1;
+    }
+
+    /// Side buffers : the cells of the four sides in a row (North, South, East, West)
+    static unsigned GetNumSideCells(int width, int height)
+    {
+        return 2 * (width + height);
+    }
+    static int GetSideOffset(int side, int width, int height)
+    {
+        return side == FGH_North ? 0 : side == FGH_South ? width : side == FGH_East ? 2 * width : 2 * width + height;
+    }
+    int GetSideLength(int side) const
+    {
+        return side < FGH_East ? width_ : height_;
+    }
+    /// Index in the planes of the k-th border cell of the side
+    int GetBorderIndex(int side, int k) const
+    {
+        return side == FGH_North ? GetIndex(k, 0) : side == FGH_South ? GetIndex(k, height_-1) : side == FGH_East ? GetIndex(width_-1, k) : GetIndex(0, k);
+    }
+    /// Index in the planes of the k-th halo cell of the side
+    int GetHaloIndex(int side, int k) const
+    {
+        return side == FGH_North ? GetIndex(k, -1) : side == FGH_South ? GetIndex(k, height_) : side == FGH_East ? GetIndex(width_, k) : GetIndex(-1, k);
+    }
+
+    float* GetReadMass() const
+    {
+        return mass_[read_];
+    }
+    float* GetWriteMass() const
+    {
+        return mass_[read_ ^ 1];
+    }
+    void Swap()
+    {
+        read_ ^= 1;
+    }
+
+    int width_, height_;
+    int stride_, size_;
+    int read_;
+
+    float* mass_[2];
+    // flows leaving the cells in the last iteration (the depthZ flows are accumulated)
+    float* out_[NUM_FLUIDGRIDFLOWS];
+    float* depthMass_;
+
+    unsigned char* solid_;
+    unsigned char* stable_;
+    unsigned char* change_;
+    unsigned char* depth_;
+
+    int blocksX_, blocksY_, numBlocks_;
+    int numActiveBlocks_;
+    // FluidGridBlock flags
+    unsigned char* blocks_;
+    // iterations without change of the active blocks
+    unsigned char* blockQuiet_;
+};
+
+
+/// Simulation 5 rules for one cell (see MapSimulatorLiquid::Simulate5) : fills the flows and the remaining mass.
+/// Returns FGC_Idle if the cell is emptied before the settle check.
+inline unsigned char FluidGridTransferCell(const FluidGridPlanes& grid, const float* mass, int i, bool removeFlowAtVoid, float* flows, float& remain)
+{
+    const int s = grid.stride_;
+    const unsigned char* solid = grid.solid_;
+
+    const float startMass = mass[i];
+    float r = startMass;
+    float flow;
+
+    // Flow to bottom cell
+    const int b = i + s;
+    if (solid[b] == FGS_Open)
+    {
+        flow = FluidClamp((CalculateFlow(r + mass[b]) - mass[b]) * FLUID_FLOWSPEED, 0.f, FluidMin(FLUID_MAXflowValue_, r));
+        flows[FGF_Bottom] = flow;
+        r -= flow;
+    }
+    // If Bottom Block, Flow to DepthZ cell
+    else if (solid[b] == FGS_Block)
+    {
+        if (grid.depth_[i] & FGD_Flow)
+        {
+            flow = (r - grid.depthMass_[i]) / 4.f;
+            if (flow > FLUID_MINflowValue_)
+                flow *= FLUID_FLOWSPEED;
+            flow *= FLUID_FLOWSPEED;
+            flow = FluidMin(FluidMax(0.f, flow), FluidMin(FLUID_MAXflowValue_, r));
+            flows[FGF_DepthZ] = flow;
+            r -= flow;
+        }
+    }
+    else if (removeFlowAtVoid)
+    {
+        remain = r - CalculateFlow(r);
+        return FGC_Idle;
+    }
+
+    if (removeFlowAtVoid)
+    {
+        const float sideFlow = r;
+        if (solid[i-1] == FGS_Void)
+            r -= sideFlow / 2.f;
+        if (solid[i+1] == FGS_Void)
+            r -= sideFlow / 2.f;
+    }
+
+    // Check to ensure we still have liquid in this cell
+    if (r < FLUID_MINVALUE)
+    {
+        remain = 0.f;
+        return FGC_Idle;
+    }
+
+    // Flow to side cells
+    const bool flowToLeft = solid[i-1] == FGS_Open && r > mass[i-1];
+    const bool flowToRight = solid[i+1] == FGS_Open && r > mass[i+1];
+    const float sideFlow = r;
+
+    if (flowToLeft)
+    {
+        flow = FluidMax(0.f, FluidMin((sideFlow - mass[i-1]) / 4.f * FLUID_FLOWSPEED, FLUID_MAXflowValue_));
+        flows[FGF_Left] = flow;
+        r -= flow;
+
+        if (r < FLUID_MINVALUE)
+        {
+            remain = 0.f;
+            return FGC_Idle;
+        }
+    }
+
+    if (flowToRight)
+    {
+        flow = FluidMax(0.f, FluidMin((sideFlow - mass[i+1]) / 4.f * FLUID_FLOWSPEED, FLUID_MAXflowValue_));
+        flows[FGF_Right] = flow;
+        r -= flow;
+
+        if (r < FLUID_MINVALUE)
+        {
+            remain = 0.f;
+            return FGC_Idle;
+        }
+    }
+
+    // Flow to Top cell
+    const int t = i - s;
+    if (solid[t] == FGS_Open)
+    {
+        flow = r - CalculateFlow(r + mass[t]);
+        if (flow > FLUID_MINflowValue_)
+            flow *= FLUID_FLOWSPEED;
+        flow = FluidMin(FluidMax(0.f, flow), FluidMin(FLUID_MAXflowValue_, r));
+        flows[FGF_Top] = flow;
+        r -= flow;
+    }
+    else if (solid[t] == FGS_Void && removeFlowAtVoid)
+    {
+        r -= CalculateFlow(r);
+    }
+
+    if (r < FLUID_MINVALUE)
+    {
+        remain = 0.f;
+        return FGC_Idle;
+    }
+
+    remain = r;
+    return startMass == r ? FGC_Stable : FGC_Moved;
+}
+
+/// Mark the asleep blocks next to the active blocks as border blocks and the simulated blocks as touched.
+inline void FluidGridPrepareBlocks(FluidGridPlanes& grid)
+{
+    unsigned char* blocks = grid.blocks_;
+
+    for (int b = 0; b < grid.numBlocks_; b++)
+        blocks[b] &= ~FGB_Border;
+
+    for (int by = 0; by < grid.blocksY_; by++)
+    {
+        for (int bx = 0; bx < grid.blocksX_; bx++)
+        {
+            if (!(blocks[by * grid.blocksX_ + bx] & FGB_Active))
+                continue;
+
+            const int bx0 = bx > 0 ? bx-1 : 0;
+            const int by0 = by > 0 ? by-1 : 0;
+            const int bx1 = bx+1 < grid.blocksX_ ? bx+1 : bx;
+            const int by1 = by+1 < grid.blocksY_ ? by+1 : by;
+            for (int y = by0; y <= by1; y++)
+                for (int x = bx0; x <= bx1; x++)
+                    if (!(blocks[y * grid.blocksX_ + x] & FGB_Active))
+                        blocks[y * grid.blocksX_ + x] |= FGB_Border;
+        }
+    }
+
+    for (int b = 0; b < grid.numBlocks_; b++)
+        if (blocks[b] & (FGB_Active | FGB_Border))
+            blocks[b] |= FGB_Touched;
+}
+
+/// Update the block states after an iteration : the busy blocks are activated, the quiet active blocks fall asleep.
+/// Returns the number of active blocks.
+inline int FluidGridUpdateBlocks(FluidGridPlanes& grid)
+{
+    unsigned char* blocks = grid.blocks_;
+    unsigned char* quiet = grid.blockQuiet_;
+    int numactive = 0;
+
+    for (int b = 0; b < grid.numBlocks_; b++)
+    {
+        const unsigned char touched = blocks[b] & FGB_Touched;
+
+        if (blocks[b] & FGB_Busy)
+        {
+            blocks[b] = FGB_Active;
+            quiet[b] = 0;
+        }
+        else if ((blocks[b] & FGB_Active) && ++quiet[b] < FLUID_BLOCKSLEEPCOUNT)
+        {
+            blocks[b] = FGB_Active;
+        }
+        else
+        {
+            blocks[b] = FGB_Asleep;
+        }
+
+        if (blocks[b])
+            numactive++;
+
+        blocks[b] |= touched;
+    }
+
+    grid.numActiveBlocks_ = numactive;
+    return numactive;
+}
+
+/// Transfer pass on a row of cells : computes the flows leaving each cell from the read masses, writes the remaining masses in the write buffer.
+inline unsigned FluidGridTransferRow(FluidGridPlanes& grid, int start, int end, bool removeFlowAtVoid)
+{
+    const float* mass = grid.GetReadMass();
+    float* remain = grid.GetWriteMass();
+    float* outB = grid.out_[FGF_Bottom];
+    float* outL = grid.out_[FGF_Left];
+    float* outR = grid.out_[FGF_Right];
+    float* outT = grid.out_[FGF_Top];
+    float* outD = grid.out_[FGF_DepthZ];
+    const unsigned char* solid = grid.solid_;
+    const unsigned char* stable = grid.stable_;
+    unsigned char* change = grid.change_;
+
+    unsigned numflows = 0;
+    float flows[NUM_FLUIDGRIDFLOWS];
+
+    for (int i = start; i < end; i++)
+    {
+        const float m = mass[i];
+
+        flows[FGF_Bottom] = flows[FGF_Left] = flows[FGF_Right] = flows[FGF_Top] = flows[FGF_DepthZ] = 0.f;
+        remain[i] = m;
+        change[i] = FGC_Idle;
+
+        if (solid[i] == FGS_Open)
+        {
+            // too few liquid : reset the cell
+            if (m > 0.f && m < 0.75f * FLUID_MINVALUE)
+                remain[i] = 0.f;
+
+            else if (m >= FLUID_MINVALUE && stable[i] < FLUID_SETTLEDCOUNT)
+            {
+                change[i] = FluidGridTransferCell(grid, mass, i, removeFlowAtVoid, flows, remain[i]);
+                if (remain[i] != m)
+                    numflows++;
+            }
+        }
+
+        outB[i] = flows[FGF_Bottom];
+        outL[i] = flows[FGF_Left];
+        outR[i] = flows[FGF_Right];
+        outT[i] = flows[FGF_Top];
+        outD[i] += flows[FGF_DepthZ];
+    }
+
+    return numflows;
+}
+
+/// Transfer pass on a row of cells of a border block : the cells keep their masses.
+inline void FluidGridKeepRow(FluidGridPlanes& grid, int start, int end)
+{
+    const float* mass = grid.GetReadMass();
+    float* remain = grid.GetWriteMass();
+
+    for (int i = start; i < end; i++)
+    {
+        remain[i] = mass[i];
+        grid.out_[FGF_Bottom][i] = grid.out_[FGF_Left][i] = grid.out_[FGF_Right][i] = grid.out_[FGF_Top][i] = 0.f;
+        grid.change_[i] = FGC_Idle;
+    }
+}
+
+/// Transfer pass : computes the flows of the active blocks. Returns the number of simulated cells with flows.
+inline unsigned FluidGridTransfer(FluidGridPlanes& grid, bool removeFlowAtVoid)
+{
+    const int s = grid.stride_;
+    const float* mass = grid.GetReadMass();
+    float* remain = grid.GetWriteMass();
+
+    // the halo keeps its mass and receives the flows in the gather pass
+    for (int x = 0; x < s; x++)
+    {
+        remain[x] = mass[x];
+        remain[grid.size_-s+x] = mass[grid.size_-s+x];
+    }
+    for (int y = 1; y <= grid.height_; y++)
+    {
+        remain[y*s] = mass[y*s];
+        remain[y*s+s-1] = mass[y*s+s-1];
+    }
+
+    unsigned numflows = 0;
+
+    for (int by = 0; by < grid.blocksY_; by++)
+    {
+        const int y0 = by << FLUID_BLOCKSHIFT;
+        const int y1 = y0 + FLUID_BLOCKSIZE < grid.height_ ? y0 + FLUID_BLOCKSIZE : grid.height_;
+
+        for (int bx = 0; bx < grid.blocksX_; bx++)
+        {
+            const unsigned char block = grid.blocks_[by * grid.blocksX_ + bx];
+            if (!(block & (FGB_Active | FGB_Border)))
+                continue;
+
+            const int x0 = bx << FLUID_BLOCKSHIFT;
+            const int x1 = x0 + FLUID_BLOCKSIZE < grid.width_ ? x0 + FLUID_BLOCKSIZE : grid.width_;
+
+            for (int y = y0; y < y1; y++)
+            {
+                const int start = grid.GetIndex(x0, y);
+                if (block & FGB_Active)
+                    numflows += FluidGridTransferRow(grid, start, start + x1 - x0, removeFlowAtVoid);
+                else
+                    FluidGridKeepRow(grid, start, start + x1 - x0);
+            }
+        }
+    }
+
+    return numflows;
+}
+
+/// Gather pass : adds the incoming flows to the remaining masses, empties the cells without enough liquid
+/// and updates the settle counters. Branch-free over each row. Returns the number of cells with a mass change.
+inline unsigned FluidGridGather(FluidGridPlanes& grid)
+{
+    const int s = grid.stride_;
+    const int w = grid.width_;
+    const int h = grid.height_;
+    const float* mass = grid.GetReadMass();
+    float* next = grid.GetWriteMass();
+    const float* outB = grid.out_[FGF_Bottom];
+    const float* outL = grid.out_[FGF_Left];
+    const float* outR = grid.out_[FGF_Right];
+    const float* outT = grid.out_[FGF_Top];
+    const unsigned char* change = grid.change_;
+    unsigned char* stable = grid.stable_;
+
+    // halo : flows to the linked maps
+    for (int x = 1; x <= w; x++)
+    {
+        next[x] += outT[x+s];
+        next[(h+1)*s+x] += outB[h*s+x];
+    }
+    for (int y = 1; y <= h; y++)
+    {
+        next[y*s] += outL[y*s+1];
+        next[y*s+w+1] += outR[y*s+w];
+    }
+
+    unsigned numupdated = 0;
+
+    for (int by = 0; by < grid.blocksY_; by++)
+    {
+        const int y0 = by << FLUID_BLOCKSHIFT;
+        const int y1 = y0 + FLUID_BLOCKSIZE < h ? y0 + FLUID_BLOCKSIZE : h;
+
+        for (int bx = 0; bx < grid.blocksX_; bx++)
+        {
+            unsigned char& block = grid.blocks_[by * grid.blocksX_ + bx];
+            if (!(block & (FGB_Active | FGB_Border)))
+                continue;
+
+            const int x0 = bx << FLUID_BLOCKSHIFT;
+            const int x1 = x0 + FLUID_BLOCKSIZE < w ? x0 + FLUID_BLOCKSIZE : w;
+            bool busy = false;
+
+            for (int y = y0; y < y1; y++)
+            {
+                const int start = grid.GetIndex(x0, y);
+                const int end = start + x1 - x0;
+
+                for (int i = start; i < end; i++)
+                {
+                    const float m = mass[i];
+                    float n = next[i] + outB[i-s] + outT[i+s] + outR[i-1] + outL[i+1];
+
+                    // the cell empties if there is not enough liquid and no liquid above (the row above is already updated)
+                    const bool updated = n != m;
+                    n = updated && n < FLUID_MINVALUE && !(next[i-s] > 0.f) ? 0.f : n;
+                    next[i] = n;
+
+                    const unsigned char moved = (change[i] | change[i-1] | change[i+1] | change[i-s] | change[i+s] | change[i+s-1] | change[i+s+1]) & FGC_Moved;
+                    const unsigned char count = stable[i] + ((change[i] & FGC_Stable) && stable[i] < 255 ? 1 : 0);
+                    stable[i] = updated || moved ? 0 : count;
+
+                    numupdated += updated ? 1 : 0;
+                    busy |= updated || (n >= FLUID_MINVALUE && stable[i] < FLUID_SETTLEDCOUNT);
+                }
+            }
+
+            if (busy)
+                block |= FGB_Busy;
+        }
+    }
+
+    return numupdated;
+}
+
+/// Equalize the supported side cells on the write masses by alternate sweeps (see Equalize1SideF).
+/// Only the cells inside the runs of active blocks are equalized.
+inline bool FluidGridEqualize(FluidGridPlanes& grid, int numPasses)
+{
+    const int s = grid.stride_;
+    const int w = grid.width_;
+    const int h = grid.height_;
+    const int nbx = grid.blocksX_;
+    const unsigned char* solid = grid.solid_;
+    float* mass = grid.GetWriteMass();
+    bool updated = false;
+
+    for (int pass = 0; pass < numPasses; pass++)
+    {
+        const int dirInc = pass & 1 ? -1 : 1;
+
+        for (int row = 0; row < h; row++)
+        {
+            const int y = dirInc > 0 ? row : h-1-row;
+            unsigned char* blocks = grid.blocks_ + (y >> FLUID_BLOCKSHIFT) * nbx;
+
+            for (int col = 0; col < nbx; )
+            {
+                if (!(blocks[dirInc > 0 ? col : nbx-1-col] & FGB_Active))
+                {
+                    col++;
+                    continue;
+                }
+
+                // run of active blocks in the sweep direction
+                int colEnd = col + 1;
+                while (colEnd < nbx && (blocks[dirInc > 0 ? colEnd : nbx-1-colEnd] & FGB_Active))
+                    colEnd++;
+
+                const int xmin = dirInc > 0 ? col << FLUID_BLOCKSHIFT : (nbx-colEnd) << FLUID_BLOCKSHIFT;
+                const int xmax = dirInc > 0 ? (colEnd << FLUID_BLOCKSHIFT < w ? colEnd << FLUID_BLOCKSHIFT : w) - 1 : ((nbx-col) << FLUID_BLOCKSHIFT < w ? (nbx-col) << FLUID_BLOCKSHIFT : w) - 1;
+                // the side cell must be in the run
+                const int xside = dirInc > 0 ? xmax : xmin;
+
+                for (int x = dirInc > 0 ? xmin : xmax; x >= xmin && x <= xmax; x += dirInc)
+                {
+                    if (x == xside)
+                        continue;
+
+                    const int i = grid.GetIndex(x, y);
+                    const int side = i + dirInc;
+
+                    if (mass[i] < FLUID_MINVALUE || solid[i+s] == FGS_Void || (solid[i+s] != FGS_Block && mass[i+s] < FLUID_MINVALUE))
+                        continue;
+
+                    if (mass[side] < FLUID_MINVALUE || solid[side+s] == FGS_Void || (solid[side+s] != FGS_Block && mass[side+s] < FLUID_MINVALUE))
+                        continue;
+
+                    const float m = FluidMax((mass[i] + mass[side]) * 0.5f, FLUID_MINVALUE);
+                    if (m != mass[i] || m != mass[side])
+                    {
+                        blocks[x >> FLUID_BLOCKSHIFT] |= FGB_Busy;
+                        blocks[(x + dirInc) >> FLUID_BLOCKSHIFT] |= FGB_Busy;
+                    }
+                    mass[i] = mass[side] = m;
+                    updated = true;
+                }
+
+                col = colEnd;
+            }
+        }
+    }
+
+    return updated;
+}
+
+/// Load the halo of a side from the border cells exported by the linked grid (borderMass and borderSolid start at the linked side)
+/// and the flows sent to the linked grid not pulled yet. Without linked grid, the halo is void.
+inline void FluidGridLoadHalo(FluidGridPlanes& grid, int side, const float* borderMass, const unsigned char* borderSolid, const float* pendingFlows)
+{
+    float* mass = grid.GetReadMass();
+    const int length = grid.GetSideLength(side);
+
+    for (int k = 0; k < length; k++)
+    {
+        const int i = grid.GetHaloIndex(side, k);
+        grid.solid_[i] = borderSolid ? borderSolid[k] : (unsigned char)FGS_Void;
+        mass[i] = borderSolid && borderSolid[k] == FGS_Open ? borderMass[k] + pendingFlows[k] : 0.f;
+    }
+}
+
+/// Keep the loaded halo masses to collect the flows sent to the linked grids after the iterations.
+inline void FluidGridSaveHalo(const FluidGridPlanes& grid, float* haloMass)
+{
+    const float* mass = grid.GetReadMass();
+
+    for (int side = 0; side < NUM_FLUIDGRIDSIDES; side++)
+    {
+        float* sideMass = haloMass + FluidGridPlanes::GetSideOffset(side, grid.width_, grid.height_);
+        const int length = grid.GetSideLength(side);
+        for (int k = 0; k < length; k++)
+            sideMass[k] = mass[grid.GetHaloIndex(side, k)];
+    }
+}
+
+/// Accumulate the flows sent in the halo since FluidGridSaveHalo and flag the moved border cells.
+/// The linked grids pull and reset these values before their next iterations.
+inline void FluidGridCollectHaloFlows(const FluidGridPlanes& grid, const float* haloMass, float* haloFlows, unsigned char* haloMoved)
+{
+    const float* mass = grid.GetReadMass();
+
+    for (int side = 0; side < NUM_FLUIDGRIDSIDES; side++)
+    {
+        const int offset = FluidGridPlanes::GetSideOffset(side, grid.width_, grid.height_);
+        const int length = grid.GetSideLength(side);
+        for (int k = 0; k < length; k++)
+        {
+            const int i = grid.GetHaloIndex(side, k);
+            if (grid.solid_[i] != FGS_Open)
+                continue;
+
+            haloFlows[offset+k] += mass[i] - haloMass[offset+k];
+            if (grid.change_[grid.GetBorderIndex(side, k)] & FGC_Moved)
+                haloMoved[offset+k] = 1;
+        }
+    }
+}
+
+inline int FluidGridInverseSide(int side)
+{
+    return side == FGH_North ? FGH_South : side == FGH_South ? FGH_North : side == FGH_East ? FGH_West : FGH_East;
+}
+
+/// Pull the flows sent across the side by the linked grid (linkedFlows and linkedMoved are the side buffers of the linked grid
+/// filled by FluidGridCollectHaloFlows) : receiver.ReceiveBorderFlow(side, k, flow) is called for the border cells with a pending flow
+/// or a moved neighbor, then the pending values are reset. Only the side of the linked grid that faces this grid is touched,
+/// so the grids can pull in parallel when the side buffers are allocated before.
+template <class T>
+inline void FluidGridPullSide(T& receiver, int side, int width, int height, float* linkedFlows, unsigned char* linkedMoved)
+{
+    const int offset = FluidGridPlanes::GetSideOffset(FluidGridInverseSide(side), width, height);
+    const int length = side < FGH_East ? width : height;
+
+    for (int k = 0; k < length; k++)
+    {
+        float& flow = linkedFlows[offset+k];
+        unsigned char& moved = linkedMoved[offset+k];
+        if (flow == 0.f && !moved)
+            continue;
+
+        receiver.ReceiveBorderFlow(side, k, flow);
+
+        flow = 0.f;
+        moved = 0;
+    }
+}
+
+/// Export the border cells in the side buffers for the halos of the linked grids : exporter.GetBorderCell(side, k, solid, mass)
+/// gives the k-th border cell of the side.
+template <class T>
+inline void FluidGridExportBorder(const T& exporter, int width, int height, unsigned char* borderSolid, float* borderMass)
+{
+    for (int side = 0; side < NUM_FLUIDGRIDSIDES; side++)
+    {
+        const int offset = FluidGridPlanes::GetSideOffset(side, width, height);
+        const int length = side < FGH_East ? width : height;
+        for (int k = 0; k < length; k++)
+            exporter.GetBorderCell(side, k, borderSolid[offset+k], borderMass[offset+k]);
+    }
+}
+
+/// One iteration of the simulation 5 on the active blocks of the grid. Returns the number of updates.
+inline unsigned FluidGridStep(FluidGridPlanes& grid, bool removeFlowAtVoid, bool equalize)
+{
+    FluidGridPrepareBlocks(grid);
+
+    unsigned updated = FluidGridTransfer(grid, removeFlowAtVoid);
+
+    updated += FluidGridGather(grid);
+
+    if (updated && equalize)
+        if (FluidGridEqualize(grid, 2))
+            updated++;
+
+    grid.Swap();
+
+    FluidGridUpdateBlocks(grid);
+
+    return updated;
+}
+
+
+/// FluidStepClock : fixed timestep of the fluid simulation.
+/// The frame time is accumulated and the simulation advances by whole ticks of step_ seconds, so the fluids flow at the same
+/// speed at any frame rate and a scenario gives the same result after the same number of ticks.
+/// After a hitch, at most maxSteps_ ticks are done in a frame : the time beyond is dropped and the fluids slow down instead of stalling the frame.
+struct FluidStepClock
+{
+    FluidStepClock() :
+        step_(0.075f), maxSteps_(4), accumulator_(0.0), ticks_(0U) { }
+
+    /// Set the timestep and the catch-up cap. The first Advance does a tick at once, the ticks keep counting.
+    void Reset(float step, int maxSteps)
+    {
+        step_ = step;
+        maxSteps_ = maxSteps > 0 ? maxSteps : 1;
+        accumulator_ = step;
+    }
+
+    /// Accumulate the frame time and return the number of ticks to simulate in this frame
+    int Advance(float timestep)
+    {
+        accumulator_ += timestep;
+
+        int numSteps = (int)(accumulator_ / step_);
+        accumulator_ -= numSteps * (double)step_;
+
+        if (numSteps > maxSteps_)
+            numSteps = maxSteps_;
+
+        ticks_ += numSteps;
+        return numSteps;
+    }
+
+    /// Fraction of the next tick already elapsed, used to interpolate the rendered masses between the last two ticks
+    float GetAlpha() const
+    {
+        return (float)(accumulator_ / step_);
+    }
+
+    float step_;
+    int maxSteps_;
+    double accumulator_;
+    unsigned ticks_;
+};
@@ -6,6 +6,7 @@
 #include <Urho3D/Core/Context.h>
 #include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Core/Profiler.h>
 
 #include <Urho3D/Container/Ptr.h>
 
@@ -91,6 +92,9 @@
 #include "GOC_ZoneEffect.h"
 #include "GOC_EntityAdder.h"
 #include "GOC_ControllerPlayer.h"
+#include "ComponentUpdater.h"
+#include "EventChannel.h"
+#include "GOABlock.h"
 #include "CraftRecipes.h"
 #include "ScrapsEmitter.h"
 #include "Player.h"
@@ -590,6 +594,9 @@ void GameContext::Initialize()
     renderer2d_->SetInitialVertexBufferSize(30000U);
     physicsWorld_ = rootScene_->CreateComponent<PhysicsWorld2D>(LOCAL);
 
+    // the components with an updater are updated in one pass
+    SubscribeToEvent(rootScene_, E_SCENEPOSTUPDATE, URHO3D_HANDLER(GameContext, HandleUpdateComponents));
+
     // Create Stuff for rendered Target Textures
 #ifdef ACTIVE_RENDERTARGET
     {
@@ -2042,6 +2049,29 @@ void GameContext::UnsubscribeFromCursorVisiblityEvents()
     UnsubscribeFromEvent(E_MOUSEMOVE);
 }
 
+void GameContext::HandleUpdateComponents(StringHash eventType, VariantMap& eventData)
+{
+    URHO3D_PROFILE(ComponentUpdaters);
+
+    const float timestep = eventData[ScenePostUpdate::P_TIMESTEP].GetFloat();
+
+    if (ClientMode_)
+        GOABlock::LoadAll();
+
+    ComponentUpdaterBase::UpdateAll(timestep);
+
+    // the typed events posted in the frame
+    EventChannelBase::FlushAll();
+
+    // the typed GOA fields written in the frame
+    GOABlock::FlushAll();
+
+#ifdef ACTIVE_POOL_ADAPTIVESIZE
+    // the pool categories follow the demand, the clones after the updates of the frame
+    ObjectPool::UpdateSizes(timestep);
+#endif
+}
+
 void GameContext::HandleBeginUpdate(StringHash eventType, VariantMap& eventData)
 {
 //    URHO3D_LOGINFO("GameContext() - HandleBeginUpdate ... ");
@@ -212,6 +212,7 @@ public :
 private :
     void HandleCursorVisibility(StringHash eventType, VariantMap& eventData);
     void HandleBeginUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleUpdateComponents(StringHash eventType, VariantMap& eventData);
 
     static GameContext* gameContext_;
 
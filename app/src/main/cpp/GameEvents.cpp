@@ -1,6 +1,7 @@
 #include <Urho3D/Urho3D.h>
 
 #include <Urho3D/IO/Log.h>
+#include <Urho3D/Scene/Node.h>
 
 #include "GameEvents.h"
 
@@ -80,6 +81,7 @@ void GOE::InitEventTable()
     events_ += Pair<StringHash,String>(StringHash("Go_CollideAttack"), "Go_CollideAttack");
     events_ += Pair<StringHash,String>(StringHash("Go_ReceiveEffect"), "Go_ReceiveEffect");
     events_ += Pair<StringHash,String>(StringHash("MapTileRemoved"), "MapTileRemoved");
+    events_ += Pair<StringHash,String>(StringHash("Go_PathRequestDone"), "Go_PathRequestDone");
 
     events_ += Pair<StringHash,String>(StringHash("Go_ChangeDirection"), "Go_ChangeDirection");
     events_ += Pair<StringHash,String>(StringHash("Go_UpdateDirection"), "Go_UpdateDirection");
@@ -190,3 +192,32 @@ void GOE::DumpAll()
         ++index;
     }
 }
+
+
+void GoAppearEvent::ToEventData(VariantMap& eventData) const
+{
+    eventData[Go_Appear::GO_ID] = id_;
+    eventData[Go_Appear::GO_TYPE] = type_;
+    eventData[Go_Appear::GO_MAINCONTROL] = mainController_;
+    eventData[Go_Appear::GO_MAP] = mpoint_;
+    if (tile_ != M_MAX_UNSIGNED)
+        eventData[Go_Appear::GO_TILE] = tile_;
+}
+
+void GoChangeMapEvent::ToEventData(VariantMap& eventData) const
+{
+    eventData[Go_ChangeMap::GO_ID] = id_;
+    eventData[Go_ChangeMap::GO_TYPE] = type_;
+    eventData[Go_ChangeMap::GO_MAPFROM] = mapFrom_;
+    eventData[Go_ChangeMap::GO_MAPTO] = mapTo_;
+}
+
+void GoDestroyEvent::ToEventData(VariantMap& eventData) const
+{
+    eventData[Go_Destroy::GO_ID] = id_;
+    eventData[Go_Destroy::GO_TYPE] = type_;
+    eventData[Go_Destroy::GO_MAP] = mpoint_;
+    eventData[Go_Destroy::GO_PTR] = node_;
+    if (tile_ != M_MAX_UNSIGNED)
+        eventData[Go_Destroy::GO_TILE] = tile_;
+}
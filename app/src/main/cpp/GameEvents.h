@@ -1,6 +1,9 @@
 #pragma once
 
 #include <Urho3D/Core/Object.h>
+#include <Urho3D/Math/MathDefs.h>
+
+#include "EventChannel.h"
 
 //#define URHO3D_EVENT(eventID, eventName) static const Urho3D::StringHash eventID(#eventName); namespace eventName
 //#define URHO3D_PARAM(paramID, paramName) static const Urho3D::StringHash paramID(#paramName)
@@ -9,6 +12,8 @@
 
 namespace Urho3D
 {
+class Node;
+
 /// Game
 URHO3D_EVENT(GAME_SCREENRESIZED, Game_ScreenResized) { }
 URHO3D_EVENT(GAME_REMOVESCENE, Game_RemoveScene) { }
@@ -138,9 +143,9 @@ URHO3D_EVENT(GO_CHANGESTATE, Go_ChangeState)
     URHO3D_PARAM(GO_ID, GoID);         // ID of the GO that animState change
     URHO3D_PARAM(GO_STATE, GoState);   // unsigned : new State
 }
-/// APPEAR Event
-/// => Sender : GOC_Destroyer
-/// => Subscribers : GOManager, World2D
+/// APPEAR Event (typed : GoAppearEvent, the params are the params of WORLD_ENTITYCREATE)
+/// => Sender : GOC_Destroyer, Map
+/// => Subscribers : GOManager, World2D, GOC_Portal (its node)
 URHO3D_EVENT(GO_APPEAR, Go_Appear)
 {
     URHO3D_PARAM(GO_ID, GoID);         // ID of the node GO appeared
@@ -149,7 +154,7 @@ URHO3D_EVENT(GO_APPEAR, Go_Appear)
     URHO3D_PARAM(GO_MAP, GoMap);
     URHO3D_PARAM(GO_TILE, GoTile);
 }
-/// CHANGEMAP Event
+/// CHANGEMAP Event (typed : GoChangeMapEvent)
 /// => Sender : GOC_Destroyer
 /// => Subscribers : World2D
 URHO3D_EVENT(GO_CHANGEMAP, Go_ChangeMap)
@@ -159,9 +164,9 @@ URHO3D_EVENT(GO_CHANGEMAP, Go_ChangeMap)
     URHO3D_PARAM(GO_MAPFROM, MapFrom);
     URHO3D_PARAM(GO_MAPTO, MapTo);
 }
-/// DESTROY Event
-/// => Sender : GOC_Animator2D, GOC_Destroyer, GOC_Collectable,
-/// => Subscribers : GOManager, World2D, GOC_Destroyer
+/// DESTROY Event (typed : GoDestroyEvent)
+/// => Sender : GOC_Animator2D, GOC_Destroyer, GOC_Collectable, World2D
+/// => Subscribers : GOManager, World2D, GO_Pools, Actor and Player (their avatar)
 URHO3D_EVENT(GO_DESTROY, Go_Destroy)
 {
     URHO3D_PARAM(GO_ID, GoID);         // ID of the GO To Destroy
@@ -297,6 +302,12 @@ URHO3D_EVENT(MAPTILEREMOVED, MapTileRemoved)                // Sender is a Colli
     URHO3D_PARAM(MAPPOINT, MapPoint);                       // map point
     URHO3D_PARAM(MAPTILEINDEX, MapTileIndex);               // index tile
 }
+/// PathFinder2D : result of a path request, sent by the requester node on the main thread
+URHO3D_EVENT(GO_PATHREQUESTDONE, Go_PathRequestDone)
+{
+    URHO3D_PARAM(GO_PATHREQUESTID, GoPathRequestId);        // UInt : id returned by PathFinder2D::RequestPath
+    URHO3D_PARAM(GO_PATHID, GoPathId);                      // Int : idpath or NoPathFound
+}
 /// GOC_Move2D
 /// GO Change Direction
 URHO3D_EVENT(GO_CHANGEDIRECTION, Go_ChangeDirection) { }
@@ -487,6 +498,48 @@ URHO3D_EVENT(SPRITER_ANIMATIONINSIDE, SPRITER_AnimationInside) { }
 using namespace Urho3D;
 
 
+/// Typed payloads of the hot GO events, sent with EventChannel<T>::Get().Send(node, event) (see EventChannel)
+/// the game listeners of GO_APPEAR, GO_CHANGEMAP, GO_DESTROY subscribe to the channel of the payload,
+/// the Urho3D receivers (scripts) get still the VariantMap event (compatibility bridge of EventChannel::Send).
+/// The other hot events stay Urho3D events : GOC_LIFEDEAD, EVENT_JUMP, EVENT_FALL (the moves of GOC_Move2D) are subscribed by name from the data
+/// (animator templates, trigger events of the body exploders and fallers), MAPTILEREMOVED has a receiver by collision shape
+/// (see MapContactRegistry) and the contacts are the events of PhysicsWorld2D.
+struct GoAppearEvent
+{
+    static StringHash GetEventType() { return GO_APPEAR; }
+    void ToEventData(VariantMap& eventData) const;
+
+    unsigned id_;
+    int type_;
+    bool mainController_;
+    unsigned mpoint_;
+    unsigned tile_;     // M_MAX_UNSIGNED : no tile
+};
+
+struct GoChangeMapEvent
+{
+    static StringHash GetEventType() { return GO_CHANGEMAP; }
+    void ToEventData(VariantMap& eventData) const;
+
+    unsigned id_;
+    int type_;
+    unsigned mapFrom_;
+    unsigned mapTo_;
+};
+
+struct GoDestroyEvent
+{
+    static StringHash GetEventType() { return GO_DESTROY; }
+    void ToEventData(VariantMap& eventData) const;
+
+    unsigned id_;
+    int type_;
+    unsigned mpoint_;
+    unsigned tile_;     // M_MAX_UNSIGNED : no tile (not anchored)
+    Node* node_;        // GO_PTR
+};
+
+
 /// GO Events
 struct GOE
 {
@@ -80,6 +80,7 @@
 #include "GameNetwork.h"
 #include "GameOptions.h"
 #include "GameAttributes.h"
+#include "GOABlock.h"
 #include "GameEvents.h"
 
 #include "TimerRemover.h"
@@ -1695,7 +1696,7 @@ bool GameHelpers::SetPhysicProperties(Node* node, const PhysicEntityInfo& physic
                     node->SetNetRotation(Quaternion(physicInfo.rotation_));
 
                 // Set New Position if not on ground or dy is enough
-                if (Abs(dy) > 0.1f || (node->GetVar(GOA::MOVESTATE).GetUInt() & MV_TOUCHGROUND) == 0)
+                if (Abs(dy) > 0.1f || (GOABlock::GetMoveState(node) & MV_TOUCHGROUND) == 0)
                 {
                     // set position coord only if coherent with the velocity (prevent bounce)
                     if ((physicInfo.vely_ <= 0.f && dy < 0) || (physicInfo.vely_ >= 0.f && dy > 0))
@@ -1848,7 +1849,7 @@ void GameHelpers::GetDropPoint(Node* holder, float& x, float& y)
     GOC_Destroyer* destroyer = holder->GetComponent<GOC_Destroyer>();
     if (!isdead && destroyer && destroyer->GetShapesRect().Defined())
     {
-        Vector2 direction = holder->GetVar(GOA::DIRECTION).GetVector2();
+        Vector2 direction = GOABlock::GetDirection(holder);
         Rect holderRect = destroyer->GetWorldShapesRect();
         x = direction.x_ >= 0.f ? holderRect.max_.x_ + 0.2f : holderRect.min_.x_ - 0.5f;
         y = direction.y_ >= 0.f ? holderRect.max_.y_ + 0.2f : holderRect.min_.y_ - 0.5f;
@@ -2874,6 +2875,7 @@ bool GameHelpers::AddWater(const WorldMapPosition& position, float qty)
         return false;
     
     fcell->AddFluid(WATER, qty);
+    map->GetObjectFeatured()->WakeFluidCells(position.tileIndex_);
     return true;
 }
 
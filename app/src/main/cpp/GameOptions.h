@@ -54,9 +54,14 @@
 
 #define ACTIVE_PRELOADER
 #define ACTIVE_POOL
+#define ACTIVE_POOL_SNAPSHOT
+//#define ACTIVE_POOL_FREESTATS
+#define ACTIVE_POOL_ADAPTIVESIZE
 #define ACTIVE_CONSOLECOMMAND
 #define ACTIVE_SDLMAPPINGJOYSTICK_DB
 #define ACTIVE_PATHFINDER
+#define ACTIVE_PATHFINDER_FLOWFIELD
+#define AI_THINK_THREADING
 #define ACTIVE_SPLASHUI
 
 #define RANDOMIZE_ARENA
@@ -117,6 +122,8 @@
 #define ACTIVE_WORLD2D_PROFILING
 //#define ACTIVE_WORLD2D_DEBUG
 #define ACTIVE_WORLD2D_THREADING
+#define ACTIVE_OBJECTTILED_THREADING
+#define ACTIVE_MAPPOOL_KEEPBUFFERS
 
 #define ACTIVE_GAMELOGLEVEL
 #define GAMELOGLEVEL_MINIMAL LOG_ERROR
@@ -78,9 +78,13 @@
 /// Fluid Simulator : MapSimulatorLiquid
 #define FLUID_SIMULATION 5
 #define FLUID_ITERATIONS 1
+#define FLUID_SIMULATION_SOA
+#define FLUID_SIMULATION_THREADING
 #define FLUID_SIMULATION_REMOVEFLOWATEMPTYBORDER
 //#define FLUID_SIMULATION_UPDATEINTERVAL  0.1 // Interval for fluid simulation update in seconds
-#define FLUID_SIMULATION_UPDATEINTERVAL  0.075 // Interval for fluid simulation update in seconds
+#define FLUID_SIMULATION_UPDATEINTERVAL  0.075 // Fixed timestep of the fluid simulation in seconds
+#define FLUID_SIMULATION_MAXSTEPS 4 // Max fluid simulation ticks in a frame (catch-up after a hitch)
+//#define FLUID_SIMULATION_INTERPOLATE // Interpolate the rendered fluid masses between the last two ticks (rebuild the fluid batches each frame)
 
 /// Fluid Render : ObjectTile
 #define FLUID_RENDER_USEMESH 4
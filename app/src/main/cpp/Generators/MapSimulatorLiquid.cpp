@@ -1,6 +1,7 @@
 #include <Urho3D/Urho3D.h>
 #include <Urho3D/IO/Log.h>
-#include <Urho3D/Urho2D/Renderer2D.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/WorkQueue.h>
 
 #include "GameOptionsTest.h"
 #include "GameContext.h"
@@ -8,6 +9,7 @@
 #include "MemoryObjects.h"
 
 #include "MapSimulatorLiquid.h"
+#include "ObjectFeatured.h"
 
 
 #define FLUID_EQUALIZE
@@ -17,11 +19,20 @@ MapSimulatorLiquid* MapSimulatorLiquid::simulator_ = 0;
 int MapSimulatorLiquid::mode_ = FLUID_SIMULATION;
 int MapSimulatorLiquid::numiterations_ = FLUID_ITERATIONS;
 
+unsigned MapSimulatorLiquid::statsTick_ = 0U;
+int MapSimulatorLiquid::numActiveBlocks_ = 0;
+int MapSimulatorLiquid::numBlocks_ = 0;
+int MapSimulatorLiquid::lastNumActiveBlocks_ = 0;
+int MapSimulatorLiquid::lastNumBlocks_ = 0;
+
 
 MapSimulatorLiquid::MapSimulatorLiquid() :
     MapGenerator("MapSimulatorLiquid"),
     fluidDatas_(0)
 {
+#ifdef FLUID_SIMULATION_SOA
+    numJobsRunning_.store(0, std::memory_order_relaxed);
+#endif
     simulator_ = this;
 }
 
@@ -31,11 +42,11 @@ MapSimulatorLiquid::~MapSimulatorLiquid()
         simulator_ = 0;
 }
 
-int MapSimulatorLiquid::Update(FluidDatas& fluiddatas)
+int MapSimulatorLiquid::Update(FluidDatas& fluiddatas, unsigned tick)
 {
-    if (fluiddatas.lastFrameUpdate_ == GameContext::Get().renderer2d_->GetCurrentFrameInfo().frameNumber_)
+    if (fluiddatas.lastTickUpdate_ == tick)
     {
-//        URHO3D_LOGWARNINGF("MapSimulatorLiquid() - Update : fluidDatas_=%u ... already done this frame ...", &fluiddatas);
+//        URHO3D_LOGWARNINGF("MapSimulatorLiquid() - Update : fluidDatas_=%u ... already done this tick ...", &fluiddatas);
         return 1;
     }
 
@@ -44,34 +55,225 @@ int MapSimulatorLiquid::Update(FluidDatas& fluiddatas)
 //    URHO3D_LOGINFOF("MapSimulatorLiquid() - Update : fluidDatas_=%u ... xSize=%d ySize=%d ...", fluidDatas_, xSize_, ySize_);
 
     // Update FluidSources
-    for (PODVector<FluidSource>::Iterator it=fluiddatas.sources_.Begin(); it!=fluiddatas.sources_.End(); ++it)
-    {
-        if (it->quantity_ < 0)
-            continue;
-
-        FluidSource& source = *it;
-
-        FluidCell& cell = fluiddatas.fluidmap_[xSize_ * source.starty_ + source.startx_];
-        cell.AddFluid(source.fluid_, source.flow_);
-        source.quantity_ -= source.flow_;
-    }
+    fluiddatas.UpdateSources();
 
     // Update Fluids
     int numiterations = numiterations_;
     if (mode_ == 5)
+#ifdef FLUID_SIMULATION_SOA
+    {
+        fluiddatas.AllocateSideBuffers();
+        fluiddatas.PullBorderFlows();
+        fluiddatas.ExportBorder();
+        amountUpdated_ = SimulateGrid(fluiddatas, numiterations);
+    }
+#else
+    {
         while (numiterations--)
             Simulate5();
+        // the cell simulations don't track the changed cells
+        if (amountUpdated_)
+            fluiddatas.renderStamp_++;
+    }
+#endif
 
     else if (mode_ == 6)
+    {
         while (numiterations--)
             Simulate6();
+        if (amountUpdated_)
+            fluiddatas.renderStamp_++;
+    }
 //        URHO3D_LOGINFOF("MapSimulatorLiquid() - Update : Simulation=%d Iterations=%d ... amountUpdated=%u OK !", params_[0], params_.Size() > 1 ? params_[1] : 1, amountUpdated_);
 
-    fluidDatas_->lastFrameUpdate_ = GameContext::Get().renderer2d_->GetCurrentFrameInfo().frameNumber_;
+    fluidDatas_->lastTickUpdate_ = tick;
+
+#ifdef FLUID_SIMULATION_SOA
+    AddBlockStats(fluiddatas);
+#endif
 
     return amountUpdated_;
 }
 
+#ifdef FLUID_SIMULATION_SOA
+
+void FluidMapJobThread(const WorkItem* item, unsigned threadIndex)
+{
+    FluidMapJob& job = *reinterpret_cast<FluidMapJob*>(item->aux_);
+    job.amountUpdated_ += MapSimulatorLiquid::UpdatePhase(job.featured_, job.phase_, job.numiterations_);
+    // release : the cells and the side buffers of the map are visible to the main thread when it reads the counter
+    job.numRunning_->fetch_sub(1, std::memory_order_release);
+}
+
+/// Phase 0 : add the sources, pull the flows sent by the linked maps and export the borders.
+/// Phase 1 : simulate the fluid views with the exported borders of the linked maps as halos.
+/// A map only writes its own cells in a phase : the jobs of the maps can run in any order.
+/// The side buffers are allocated before the phases (see UpdateMaps) : a job never resizes the buffers read by the other jobs.
+int MapSimulatorLiquid::UpdatePhase(ObjectFeatured* featured, int phase, int numiterations)
+{
+    Vector<FluidDatas>& fluidViews = featured->fluidView_;
+    int amountUpdated = 0;
+
+    if (phase == 0)
+    {
+        for (unsigned i = 0; i < fluidViews.Size(); i++)
+        {
+            fluidViews[i].UpdateSources();
+            fluidViews[i].PullBorderFlows();
+            fluidViews[i].ExportBorder();
+        }
+    }
+    else
+    {
+        for (unsigned i = 0; i < fluidViews.Size(); i++)
+            amountUpdated += SimulateGrid(fluidViews[i], numiterations);
+    }
+
+    return amountUpdated;
+}
+
+void MapSimulatorLiquid::RunPhase(int phase)
+{
+    WorkQueue* queue = GameContext::Get().gameWorkQueue_;
+
+#ifdef FLUID_SIMULATION_THREADING
+    if (queue && queue->GetNumThreads() > 0 && jobs_.Size() > 1)
+    {
+        queue->Pause();
+
+        for (unsigned i = 0; i < jobs_.Size(); i++)
+        {
+            FluidMapJob& job = jobs_[i];
+            job.phase_ = phase;
+            job.numRunning_ = &numJobsRunning_;
+
+            job.item_ = queue->GetFreeItem();
+            job.item_->sendEvent_ = false;
+            job.item_->priority_ = FLUID_WORKITEM_PRIORITY;
+            job.item_->workFunction_ = FluidMapJobThread;
+            job.item_->aux_ = &job;
+        }
+
+        numJobsRunning_.store(jobs_.Size(), std::memory_order_relaxed);
+
+        for (unsigned i = 0; i < jobs_.Size(); i++)
+            queue->AddWorkItem(jobs_[i].item_);
+
+        queue->Resume();
+
+        // all the maps end the phase before the next one
+        WaitPhase();
+
+        return;
+    }
+#endif
+
+    for (unsigned i = 0; i < jobs_.Size(); i++)
+        jobs_[i].amountUpdated_ += UpdatePhase(jobs_[i].featured_, phase, jobs_[i].numiterations_);
+}
+
+void MapSimulatorLiquid::WaitPhase()
+{
+    // the main thread runs the jobs not yet taken by the workers : the other items of the queue are not run by this wait
+    WorkQueue* queue = GameContext::Get().gameWorkQueue_;
+    for (unsigned i = 0; i < jobs_.Size(); i++)
+    {
+        FluidMapJob& job = jobs_[i];
+        if (job.item_ && job.item_->aux_ == &job && queue->RemoveWorkItem(job.item_))
+        {
+            job.amountUpdated_ += UpdatePhase(job.featured_, job.phase_, job.numiterations_);
+            numJobsRunning_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    // only the jobs in progress in the workers remain
+    // acquire : pairs with the release of FluidMapJobThread
+    while (numJobsRunning_.load(std::memory_order_acquire) != 0)
+        Time::Sleep(0);
+
+    for (unsigned i = 0; i < jobs_.Size(); i++)
+        jobs_[i].item_.Reset();
+}
+
+void MapSimulatorLiquid::AddBlockStats(const FluidDatas& fluiddatas)
+{
+    // Debug Stats : sum of the blocks of the fluid views updated in a tick
+    if (statsTick_ != fluiddatas.lastTickUpdate_)
+    {
+        statsTick_ = fluiddatas.lastTickUpdate_;
+        lastNumActiveBlocks_ = numActiveBlocks_;
+        lastNumBlocks_ = numBlocks_;
+        numActiveBlocks_ = numBlocks_ = 0;
+    }
+    numActiveBlocks_ += fluiddatas.GetNumActiveBlocks();
+    numBlocks_ += fluiddatas.GetNumBlocks();
+}
+
+#endif
+
+int MapSimulatorLiquid::UpdateMaps(const PODVector<ObjectFeatured*>& maps, unsigned tick)
+{
+    int amountUpdated = 0;
+
+#ifdef FLUID_SIMULATION_SOA
+    if (mode_ == 5)
+    {
+        jobs_.Clear();
+        for (unsigned i = 0; i < maps.Size(); i++)
+        {
+            ObjectFeatured* featured = maps[i];
+            if (!featured->fluidView_.Size())
+                continue;
+
+            // already done this tick (by an other viewport)
+            if (featured->fluidView_.Front().lastTickUpdate_ == tick)
+            {
+                amountUpdated++;
+                continue;
+            }
+
+            // the side buffers are allocated here, in the main thread, before the jobs read them
+            for (unsigned j = 0; j < featured->fluidView_.Size(); j++)
+            {
+                featured->fluidView_[j].lastTickUpdate_ = tick;
+                featured->fluidView_[j].AllocateSideBuffers();
+            }
+
+            jobs_.Resize(jobs_.Size()+1);
+            FluidMapJob& job = jobs_.Back();
+            job.featured_ = featured;
+            job.numiterations_ = numiterations_;
+            job.amountUpdated_ = 0;
+        }
+
+        RunPhase(0);
+        RunPhase(1);
+
+        for (unsigned i = 0; i < jobs_.Size(); i++)
+        {
+            amountUpdated += jobs_[i].amountUpdated_;
+
+            const Vector<FluidDatas>& fluidViews = jobs_[i].featured_->fluidView_;
+            for (unsigned j = 0; j < fluidViews.Size(); j++)
+                AddBlockStats(fluidViews[j]);
+        }
+
+        jobs_.Clear();
+
+        return amountUpdated;
+    }
+#endif
+
+    for (unsigned i = 0; i < maps.Size(); i++)
+    {
+        Vector<FluidDatas>& fluidViews = maps[i]->fluidView_;
+        for (unsigned j = 0; j < fluidViews.Size(); j++)
+            amountUpdated += Update(fluidViews[j], tick);
+    }
+
+    return amountUpdated;
+}
+
 void MapSimulatorLiquid::Make()
 {
 //    URHO3D_LOGINFOF("MapSimulatorLiquid() - Make ...");
@@ -83,17 +285,6 @@ void MapSimulatorLiquid::Make()
 /// Simulation Section
 
 
-// Calculate how much liquid should flow to Vertical destination with pressure
-inline float CalculateFlow(float totalmass)
-{
-    if (totalmass <= FLUID_MAXVALUE)
-        return FLUID_MAXVALUE;
-    else if (totalmass < 2.f * FLUID_MAXVALUE + FLUID_MAXCOMPRESSIONVALUE)
-        return (FLUID_MAXVALUE * FLUID_MAXVALUE + totalmass * FLUID_MAXCOMPRESSIONVALUE) / (FLUID_MAXVALUE + FLUID_MAXCOMPRESSIONVALUE);
-    else
-        return (totalmass + FLUID_MAXCOMPRESSIONVALUE) * 0.5f;
-}
-
 #ifdef FLUID_EQUALIZE
 //bool Equalize1SideF(FluidMap& fluidmap, int numPasses)
 //{
@@ -181,6 +372,50 @@ bool EqualizeDepthZ(FluidMap& fluidmap)
     return (updated);
 }
 
+/// EqualizeDepthZ on the active blocks of the simulation grid, wakes the changed depthZ cells
+bool EqualizeDepthZ(FluidDatas& fluiddatas)
+{
+    FluidMap& fluidmap = fluiddatas.fluidmap_;
+    const FluidGridPlanes& grid = fluiddatas.grid_;
+    const int width = FluidDatas::width_;
+    const int height = FluidDatas::height_;
+    bool updated = false;
+
+    for (int by = 0; by < grid.blocksY_; by++)
+    {
+        const int y0 = by << FLUID_BLOCKSHIFT;
+        const int y1 = Min(y0 + FLUID_BLOCKSIZE, height);
+
+        for (int bx = 0; bx < grid.blocksX_; bx++)
+        {
+            if (!(grid.blocks_[by * grid.blocksX_ + bx] & FGB_Active))
+                continue;
+
+            const int x0 = bx << FLUID_BLOCKSHIFT;
+            const int x1 = Min(x0 + FLUID_BLOCKSIZE, width);
+
+            for (int y = y0; y < y1; y++)
+            {
+                for (unsigned addr = y * width + x0; addr < (unsigned)(y * width + x1); ++addr)
+                {
+                    FluidCell& cell = fluidmap[addr];
+                    if (cell.DepthZ && (!cell.featCheck_ || (*cell.featCheck_) <= MapFeatureType::Threshold) &&
+                        cell.pattern_ != FPT_WaterFall && cell.DepthZ->pattern_ != FPT_WaterFall)
+                    {
+                        const float mass = (cell.massC_ + cell.DepthZ->massC_) * 0.5f;
+                        if (mass != cell.DepthZ->massC_ && fluiddatas.depthDatas_)
+                            fluiddatas.depthDatas_->WakeCell(addr);
+                        cell.mass_ = cell.DepthZ->mass_= cell.massC_ = cell.DepthZ->massC_ = mass;
+                        updated = true;
+                    }
+                }
+            }
+        }
+    }
+
+    return (updated);
+}
+
 bool Equalize3SideF(FluidMap& fluidmap, int numPasses)
 {
     bool updated=false;
@@ -239,6 +474,33 @@ bool Equalize3SideF(FluidMap& fluidmap, int numPasses)
 
 #endif // FLUID_EQUALIZE
 
+void MapSimulatorLiquid::UpdateBorderCell(unsigned addr)
+{
+    FluidCell& cell = fluidDatas_->fluidmap_[addr];
+
+    // wake the block if a linked map has changed the cell
+    if (cell.Update() || (cell.type_ >= WATER && cell.massC_ >= FLUID_MINVALUE && !(cell.state_ & FluidCell::SETTLED)))
+        fluidDatas_->WakeCell(addr);
+}
+
+void MapSimulatorLiquid::UpdateBorderCells()
+{
+    int x,y;
+
+    // Top Border Cells
+    for (x = 0; x < xSize_; x++)
+        UpdateBorderCell(x);
+    // Bottom Border Cells
+    for (x = 0; x < xSize_; x++)
+        UpdateBorderCell((ySize_-1)*xSize_ + x);
+    // Left Border Cells
+    for (y = 1; y < ySize_-1; y++)
+        UpdateBorderCell(y*xSize_);
+    // Right Border Cells
+    for (y = 1; y < ySize_-1; y++)
+        UpdateBorderCell((y+1)*xSize_-1);
+}
+
 /// Simulation 5 : Simple Compression Simulation (based on src:http://www.jgallant.com/2d-liquid-simulator-with-cellular-automaton-in-unity/)
 
 void MapSimulatorLiquid::Simulate5()
@@ -252,22 +514,7 @@ void MapSimulatorLiquid::Simulate5()
     const unsigned size = fluidmap.Size();
 
     // 0 - Update Border Cells Only (for the changes made by linked Maps)
-    {
-        int x,y;
-
-        // Top Border Cells
-        for (x = 0; x < xSize_; x++)
-            fluidmap[x].Update();
-        // Bottom Border Cells
-        for (x = 0; x < xSize_; x++)
-            fluidmap[(ySize_-1)*xSize_ + x].Update();
-        // Left Border Cells
-        for (y = 1; y < ySize_-1; y++)
-            fluidmap[y*xSize_].Update();
-        // Right Border Cells
-        for (y = 1; y < ySize_-1; y++)
-            fluidmap[(y+1)*xSize_-1].Update();
-    }
+    UpdateBorderCells();
 
 #ifdef FLUID_EQUALIZE
     if (fluidDatas_->viewZ_ == INNERVIEW)
@@ -616,6 +863,47 @@ void MapSimulatorLiquid::Simulate5()
 
 
 
+#ifdef FLUID_SIMULATION_SOA
+
+/// Simulation 5 on the structure-of-arrays grid (see FluidGrid.h) :
+/// the cells of the active blocks are copied once in the grid, the iterations run on the contiguous planes, then the grid is copied back in the cells.
+/// The settled blocks sleep and cost nothing until a tile change, a fluid source or a flow from a neighbor block wakes them.
+/// The linked maps are seen through their exported borders : the flows sent to them are kept until they pull them (see FluidDatas::PullBorderFlows).
+int MapSimulatorLiquid::SimulateGrid(FluidDatas& fluiddatas, int numiterations)
+{
+    int amountUpdated = 0;
+
+    fluiddatas.PrepareGrid();
+
+#ifdef FLUID_EQUALIZE
+    const bool equalize = true;
+    if (fluiddatas.viewZ_ == INNERVIEW)
+        if (EqualizeDepthZ(fluiddatas))
+            amountUpdated++;
+#else
+    const bool equalize = false;
+#endif
+
+#ifdef FLUID_SIMULATION_REMOVEFLOWATEMPTYBORDER
+    const bool removeFlowAtVoid = true;
+#else
+    const bool removeFlowAtVoid = false;
+#endif
+
+    // 1 - Simulate
+    fluiddatas.LoadGrid();
+
+    while (numiterations--)
+        amountUpdated += FluidGridStep(fluiddatas.grid_, removeFlowAtVoid, equalize);
+
+    // 2 - Update Cells
+    fluiddatas.StoreGrid();
+
+    return amountUpdated;
+}
+
+#endif
+
 void MapSimulatorLiquid::Simulate6()
 {
     if (!fluidDatas_)
@@ -1,11 +1,36 @@
 #pragma once
 
+#include <atomic>
+
+#include <Urho3D/Core/WorkQueue.h>
+
+#include "GameOptionsTest.h"
+
 #include "MapGenerator.h"
 #include "DefsFluids.h"
 
 
 using namespace Urho3D;
 
+struct ObjectFeatured;
+
+#ifdef FLUID_SIMULATION_SOA
+const unsigned FLUID_WORKITEM_PRIORITY = 1004U;
+
+struct FluidMapJob
+{
+    FluidMapJob() : featured_(0), phase_(0), numiterations_(0), amountUpdated_(0), numRunning_(0) { }
+
+    ObjectFeatured* featured_;
+    int phase_;
+    int numiterations_;
+    int amountUpdated_;
+
+    // running jobs of the phase, decremented by the job at its end
+    std::atomic<unsigned>* numRunning_;
+    SharedPtr<WorkItem> item_;
+};
+#endif
 
 class MapSimulatorLiquid : public MapGenerator
 {
@@ -23,14 +48,36 @@ public:
         numiterations_ = numiterations;
     }
 
-    int Update(FluidDatas& fluiddatas);
+    /// Simulate a tick of the fluid view (once by tick)
+    int Update(FluidDatas& fluiddatas, unsigned tick);
+    /// Simulate a tick of the fluid views of the maps by parallel jobs on the game work queue (FLUID_SIMULATION_THREADING)
+    int UpdateMaps(const PODVector<ObjectFeatured*>& maps, unsigned tick);
+
+#ifdef FLUID_SIMULATION_SOA
+    static int UpdatePhase(ObjectFeatured* featured, int phase, int numiterations);
+#endif
+
+    /// Active and total simulation blocks of the fluid views updated in the last tick
+    static int GetNumActiveBlocks() { return lastNumActiveBlocks_; }
+    static int GetNumBlocks() { return lastNumBlocks_; }
 
 protected:
     virtual void Make();
 
 private:
+    void UpdateBorderCell(unsigned addr);
+    void UpdateBorderCells();
     void Simulate5();
     void Simulate6();
+#ifdef FLUID_SIMULATION_SOA
+    static int SimulateGrid(FluidDatas& fluiddatas, int numiterations);
+    static void AddBlockStats(const FluidDatas& fluiddatas);
+    void RunPhase(int phase);
+    void WaitPhase();
+
+    Vector<FluidMapJob> jobs_;
+    std::atomic<unsigned> numJobsRunning_;
+#endif
 
     FluidDatas* fluidDatas_;
 
@@ -38,5 +85,9 @@ private:
 
     static int mode_;
     static int numiterations_;
+
+    static unsigned statsTick_;
+    static int numActiveBlocks_, numBlocks_;
+    static int lastNumActiveBlocks_, lastNumBlocks_;
     static MapSimulatorLiquid* simulator_;
 };
@@ -486,7 +486,10 @@ void GEF_Rain::HandleUpdate(StringHash eventType, VariantMap& eventData)
                 {
                     FluidCell* fluidcell = map->GetFluidCellPtr(Droplet::hittedTiles_[i], ViewManager::INNERVIEW_Index);
                     if (fluidcell && fluidcell->type_ != BLOCK)
+                    {
                         fluidcell->AddFluid(WATER, ratiointensity * intensity_ * FLUID_MINVALUE);
+                        map->GetObjectFeatured()->WakeFluidCells(Droplet::hittedTiles_[i]);
+                    }
                 }
             }
             //        URHO3D_LOGERRORF("GEF_Rain() - HandleUpdate() : Updated in %u/%u msec ... iCount=%u/%u hittedTiles=%u", raintimer_.GetCurrentTime(), raintimer_.GetExpirationTime(), iCount_, Droplet::NUM_DROPLETS, Droplet::hittedTiles_.Size());
@@ -91,19 +91,16 @@ void WaterLine::Clear()
     deformations_.Clear();
 }
 
-bool CheckConnectedNeighborsAt(WaterSurface*& surface, Vector<WaterSurface>& surfaces, int offsetx, int offsety)
+bool CheckConnectedNeighborsAt(WaterSurface*& surface, Vector<WaterSurface>& surfaces, const HashMap<unsigned, unsigned>& surfaceIndexes, int offsetx, int offsety)
 {
     /// TODO : resolve cell addr with neighbor maps
     unsigned neighboraddr = surface->addr_ + offsety * FluidDatas::width_;
     if (!offsety)
         neighboraddr += offsetx;
 
-    WaterSurface* neighbor = 0;
-
     // find the neighbor in surfaces bank
-    for (int i = 0; i < surfaces.Size(); i++)
-        if (surfaces[i].addr_ == neighboraddr)
-            neighbor = &surfaces[i];
+    HashMap<unsigned, unsigned>::ConstIterator it = surfaceIndexes.Find(neighboraddr);
+    WaterSurface* neighbor = it != surfaceIndexes.End() ? &surfaces[it->second_] : 0;
 
     if (!neighbor || neighbor->cell_->drawn_)
     {
@@ -161,7 +158,7 @@ bool CheckConnectedNeighborsAt(WaterSurface*& surface, Vector<WaterSurface>& sur
     return false;
 }
 
-void WaterLine::ExpandFrom(WaterSurface* surface, Vector<WaterSurface>& surfaces)
+void WaterLine::ExpandFrom(WaterSurface* surface, Vector<WaterSurface>& surfaces, const HashMap<unsigned, unsigned>& surfaceIndexes)
 {
     if (!surface)
         return;
@@ -176,13 +173,13 @@ void WaterLine::ExpandFrom(WaterSurface* surface, Vector<WaterSurface>& surfaces
     for (;;)
     {
         // Check Top
-        if (CheckConnectedNeighborsAt(surface, surfaces, 1, -1))
+        if (CheckConnectedNeighborsAt(surface, surfaces, surfaceIndexes, 1, -1))
             continue;
         // Check Bottom
-        if (CheckConnectedNeighborsAt(surface, surfaces, 1, 1))
+        if (CheckConnectedNeighborsAt(surface, surfaces, surfaceIndexes, 1, 1))
             continue;
         // Check Right
-        if (CheckConnectedNeighborsAt(surface, surfaces, 1, 0))
+        if (CheckConnectedNeighborsAt(surface, surfaces, surfaceIndexes, 1, 0))
             continue;
         break;
     }
@@ -192,13 +189,13 @@ void WaterLine::ExpandFrom(WaterSurface* surface, Vector<WaterSurface>& surfaces
     for (;;)
     {
         // Check Top
-        if (CheckConnectedNeighborsAt(surface, surfaces, -1, -1))
+        if (CheckConnectedNeighborsAt(surface, surfaces, surfaceIndexes, -1, -1))
             continue;
         // Check Bottom
-        if (CheckConnectedNeighborsAt(surface, surfaces, -1, 1))
+        if (CheckConnectedNeighborsAt(surface, surfaces, surfaceIndexes, -1, 1))
             continue;
         // Check Left
-        if (CheckConnectedNeighborsAt(surface, surfaces, -1, 0))
+        if (CheckConnectedNeighborsAt(surface, surfaces, surfaceIndexes, -1, 0))
             continue;
         break;
     }
@@ -229,6 +226,22 @@ void WaterLine::ExpandFrom(WaterSurface* surface, Vector<WaterSurface>& surfaces
     surfaceEnd_ = surface;
 }
 
+void WaterLine::LinkVertices(Vector<Vertex2D>& vertices)
+{
+    WaterSurface* surface = surface_;
+    while (surface)
+    {
+        if (surface->vertex0_)
+        {
+            surface->vertex0_ = &vertices[surface->vertexIndex0_];
+            surface->vertex1_ = &vertices[surface->vertexIndex1_];
+        }
+        if (surface == surfaceEnd_)
+            break;
+        surface = surface->next_;
+    }
+}
+
 void WaterLine::Update(SourceBatch2D& batch, SourceBatch2D& batch2, const float zf)
 {
     const Vector2 tileSize = MapInfo::info.mTileHalfSize_ * 2.f;
@@ -640,6 +653,40 @@ void WaterDeformationPoint::Update()
 }
 
 
+// WaterTileCache
+
+void WaterTileCache::GetStamps(const FluidDatas& fluiddata, unsigned* stamps)
+{
+    stamps[0] = fluiddata.renderStamp_;
+    stamps[1] = fluiddata.depthDatas_ ? fluiddata.depthDatas_->renderStamp_ : 0U;
+    for (int i = 0; i < 4; i++)
+        stamps[i+2] = fluiddata.linkedDatas_[i] ? fluiddata.linkedDatas_[i]->renderStamp_ : 0U;
+}
+
+bool WaterTileCache::IsValid(int viewZ, const ViewportRenderData& mapdata, const FluidDatas& fluiddata) const
+{
+    if (!valid_ || viewZ_ != viewZ || map_ != mapdata.objectTiled_->map_ || rect_ != mapdata.chunkGroup_.rect_)
+        return false;
+
+    if (memcmp(&transform_, &mapdata.objectTiled_->GetNode()->GetWorldTransform2D(), sizeof(Matrix2x3)) != 0)
+        return false;
+
+    unsigned stamps[NUM_STAMPS];
+    GetStamps(fluiddata, stamps);
+    return memcmp(stamps, stamps_, sizeof(stamps)) == 0;
+}
+
+void WaterTileCache::Validate(int viewZ, const ViewportRenderData& mapdata, const FluidDatas& fluiddata)
+{
+    viewZ_ = viewZ;
+    map_ = mapdata.objectTiled_->map_;
+    rect_ = mapdata.chunkGroup_.rect_;
+    transform_ = mapdata.objectTiled_->GetNode()->GetWorldTransform2D();
+    GetStamps(fluiddata, stamps_);
+    valid_ = true;
+}
+
+
 // WaterLayerData
 
 WaterLayerData::WaterLayerData()
@@ -675,28 +722,58 @@ void WaterLayerData::Clear(int viewZ)
     waterlinesBatch_.vertices_.Clear();
 }
 
-bool WaterLayerData::UpdateSimulation()
+void WaterLayerData::ClearTileCaches(const ViewportRenderData* mapdata)
 {
-    bool updated = false;
+    if (!mapdata)
+    {
+        tileCaches_.Clear();
+        return;
+    }
 
-    for (unsigned i = 0; i < mapdatas_.Size(); i++)
+    for (unsigned i = 0; i < tileCaches_.Size();)
     {
-        ViewportRenderData* mapdata = mapdatas_[i];
-        ObjectFeatured* featureData = mapdata->objectTiled_->GetObjectFeatured();
-        int numFluidViews = featureData->fluidView_.Size();
-        if (!numFluidViews)
-            continue;
+        if (tileCaches_[i].mapdata_ == mapdata)
+            tileCaches_.EraseSwap(i);
+        else
+            i++;
+    }
+}
 
-        bool mapSimulUpdated = false;
-        for (int i = 0; i < numFluidViews; i++)
+WaterTileCache& WaterLayerData::GetTileCache(int viewZ, const ViewportRenderData& mapdata, const FluidDatas& fluiddata)
+{
+    for (unsigned i = 0; i < tileCaches_.Size(); i++)
+    {
+        WaterTileCache& cache = tileCaches_[i];
+        if (cache.fluiddata_ == &fluiddata && cache.viewZ_ == viewZ && cache.mapdata_ == &mapdata)
         {
-            // Update Fluid Simulation
-            if (MapSimulatorLiquid::Get()->Update(featureData->fluidView_[i]))
-                mapSimulUpdated = true;
+            cache.used_ = true;
+            return cache;
         }
+    }
 
-        updated |= mapSimulUpdated;
+    tileCaches_.Resize(tileCaches_.Size()+1);
+    WaterTileCache& cache = tileCaches_.Back();
+    cache.mapdata_ = &mapdata;
+    cache.fluiddata_ = &fluiddata;
+    cache.viewZ_ = viewZ;
+    cache.valid_ = false;
+    cache.used_ = true;
+    return cache;
+}
+
+bool WaterLayerData::UpdateSimulation(unsigned tick)
+{
+    PODVector<ObjectFeatured*> maps;
+    for (unsigned i = 0; i < mapdatas_.Size(); i++)
+    {
+        ObjectFeatured* featureData = mapdatas_[i]->objectTiled_->GetObjectFeatured();
+        if (featureData->fluidView_.Size())
+            maps.Push(featureData);
     }
+
+    // Update Fluid Simulation : the maps run in parallel jobs
+    bool updated = maps.Size() && MapSimulatorLiquid::Get()->UpdateMaps(maps, tick) > 0;
+
 //    URHO3D_LOGINFOF("WaterLayerData() - UpdateSimulation ... viewport=%d updated=%s ... OK !", viewport_, updated ? "true" : "false");
 
     if (updated)
@@ -705,8 +782,21 @@ bool WaterLayerData::UpdateSimulation()
     return updated;
 }
 
+void WaterLayerData::InterpolateSimulation(float alpha)
+{
+    for (unsigned i = 0; i < mapdatas_.Size(); i++)
+    {
+        Vector<FluidDatas>& fluidViews = mapdatas_[i]->objectTiled_->GetObjectFeatured()->fluidView_;
+        for (unsigned j = 0; j < fluidViews.Size(); j++)
+            fluidViews[j].InterpolateGrid(alpha);
+    }
+
+    if (mapdatas_.Size())
+        batchesDirty_ = true;
+}
+
 // Patterned Fluid Batches
-void WaterLayerData::UpdateTiledBatch(int viewZ, const ViewportRenderData& mapdata, FluidDatas& fluiddata)
+void WaterLayerData::UpdateTiledBatch(int viewZ, const ViewportRenderData& mapdata, FluidDatas& fluiddata, WaterTileCache& cache)
 {
     const Matrix2x3& worldTransform2D = mapdata.objectTiled_->GetNode()->GetWorldTransform2D();
 
@@ -739,10 +829,12 @@ void WaterLayerData::UpdateTiledBatch(int viewZ, const ViewportRenderData& mapda
     V0---------V3
     */
 
-    SourceBatch2D& batch = viewZ == fluiddata.viewZ_ ? watertilesFrontBatch_ : watertilesBackBatch_;
     const float alpha = 1.f;
 
-    Vector<Vertex2D>& vertices = batch.vertices_;
+    Vector<Vertex2D>& vertices = cache.vertices_;
+    Vector<WaterSurface>& surfaces = cache.surfaces_;
+    vertices.Clear();
+    surfaces.Clear();
     Vertex2D vertex[16];
 
     float xv[16];
@@ -1649,7 +1741,8 @@ void WaterLayerData::UpdateTiledBatch(int viewZ, const ViewportRenderData& mapda
             if (drawSurface)
             {
                 // Add WaterSurfaces for generating WaterLines (include the WaterTile under the waterline)
-                waterSurfaces_.Resize(waterSurfaces_.Size()+1);
+                surfaces.Resize(surfaces.Size()+1);
+                WaterSurface& surface = surfaces.Back();
 
                 bottomy = worldTransform2D.m11_ * bottomy + worldTransform2D.m12_;
 
@@ -1658,15 +1751,17 @@ void WaterLayerData::UpdateTiledBatch(int viewZ, const ViewportRenderData& mapda
                     unsigned baseindex = vertices.Size() - 4 * numQuads;
                     Vertex2D& vertice0 = vertices[baseindex + surfaceVertexIndex[0]];
                     Vertex2D& vertice1 = vertices[baseindex + surfaceVertexIndex[1]];
-                    waterSurfaces_.Back().Set(mapdata.objectTiled_->map_, &cell, addr, bottomy, vertice0, vertice1, numQuads == 1);
+                    surface.Set(mapdata.objectTiled_->map_, &cell, addr, bottomy, vertice0, vertice1, numQuads == 1);
+                    surface.vertexIndex0_ = baseindex + surfaceVertexIndex[0];
+                    surface.vertexIndex1_ = baseindex + surfaceVertexIndex[1];
                 }
                 else
                 {
-                    waterSurfaces_.Back().Set(mapdata.objectTiled_->map_, &cell, addr, bottomy, vertex[surfaceVertexIndex[0]], vertex[surfaceVertexIndex[1]], false);
+                    surface.Set(mapdata.objectTiled_->map_, &cell, addr, bottomy, vertex[surfaceVertexIndex[0]], vertex[surfaceVertexIndex[1]], false);
                 }
 
 #ifdef FLUID_RENDER_COLORDEBUG
-                waterSurfaces_.Back().debugColor_ = coloruint;
+                surface.debugColor_ = coloruint;
 #endif
             }
 
@@ -1682,6 +1777,9 @@ void WaterLayerData::UpdateBatches()
 
     // WaterTiles
     {
+        for (unsigned i = 0; i < tileCaches_.Size(); i++)
+            tileCaches_[i].used_ = false;
+
         for (unsigned i = 0; i < mapdatas_.Size(); i++)
         {
             ViewportRenderData& mapdata = *mapdatas_[i];
@@ -1690,15 +1788,51 @@ void WaterLayerData::UpdateBatches()
 
             const Vector<int>& fluidViewIds = featureData->GetFluidViewIDs(viewZ);
             for (int j = 0; j < fluidViewIds.Size(); j++)
-                UpdateTiledBatch(viewZ, mapdata, featureData->GetFluidView(fluidViewIds[j]));
+            {
+                FluidDatas& fluiddata = featureData->GetFluidView(fluidViewIds[j]);
+
+                // rebuild the tiles only if the cells have changed
+                WaterTileCache& cache = GetTileCache(viewZ, mapdata, fluiddata);
+                if (!cache.IsValid(viewZ, mapdata, fluiddata))
+                {
+                    UpdateTiledBatch(viewZ, mapdata, fluiddata, cache);
+                    cache.Validate(viewZ, mapdata, fluiddata);
+                }
+
+                SourceBatch2D& batch = viewZ == fluiddata.viewZ_ ? watertilesFrontBatch_ : watertilesBackBatch_;
+                const unsigned baseindex = batch.vertices_.Size();
+                batch.vertices_.Push(cache.vertices_);
+
+                // the surfaces are only in the front batch
+                const unsigned surfaceindex = waterSurfaces_.Size();
+                waterSurfaces_.Push(cache.surfaces_);
+                for (unsigned k = surfaceindex; k < waterSurfaces_.Size(); k++)
+                {
+                    waterSurfaces_[k].vertexIndex0_ += baseindex;
+                    waterSurfaces_[k].vertexIndex1_ += baseindex;
+                }
+            }
+        }
+
+        // remove the caches of the fluid views no more visible
+        for (unsigned i = 0; i < tileCaches_.Size();)
+        {
+            if (!tileCaches_[i].used_)
+                tileCaches_.EraseSwap(i);
+            else
+                i++;
         }
     }
 
     // WaterLines
     {
         // Reset FluidCell drawn status before Expand the Waterlines
+        waterSurfaceIndexes_.Clear();
         for (int i = 0; i < waterSurfaces_.Size(); i++)
+        {
             waterSurfaces_[i].cell_->drawn_ = false;
+            waterSurfaceIndexes_[waterSurfaces_[i].addr_] = i;
+        }
 
         // Find WaterLines
         // Get WaterSurfaces not again used, and create new waterlines.
@@ -1747,7 +1881,7 @@ void WaterLayerData::UpdateBatches()
             }
 
             // Expand the waterline from the watersurface
-            waterline.ExpandFrom(surface, waterSurfaces_);
+            waterline.ExpandFrom(surface, waterSurfaces_, waterSurfaceIndexes_);
         }
 
         // Apply Deformation to WaterLines
@@ -1760,6 +1894,7 @@ void WaterLayerData::UpdateBatches()
             if (waterline.expanded_)
             {
                 // Update Line Deformation and Batch
+                waterline.LinkVertices(watertilesFrontBatch_.vertices_);
                 waterline.Update(waterlinesBatch_, watertilesFrontBatch_, zf);
 
                 numwaterlines++;
@@ -1816,11 +1951,12 @@ void WaterLayer::Init()
     {
         layerDatas_[i].viewport_ = i;
         layerDatas_[i].Clear();
+        layerDatas_[i].ClearTileCaches();
     }
 
     sourceBatchesToRender_[0].Clear();
 
-    fluidUpdateTime_ = FLUID_SIMULATION_UPDATEINTERVAL+1;
+    fluidClock_.Reset(FLUID_SIMULATION_UPDATEINTERVAL, FLUID_SIMULATION_MAXSTEPS);
 }
 
 void WaterLayer::Clear()
@@ -1843,6 +1979,8 @@ void WaterLayer::SetViewportData(bool enable, ViewportRenderData* mapdata)
     {
         if (layerData.mapdatas_.Contains(mapdata))
             layerData.mapdatas_.Remove(mapdata);
+
+        layerData.ClearTileCaches(mapdata);
     }
 }
 
@@ -1898,7 +2036,7 @@ void WaterLayer::OnSetEnabled()
     {
         if (IsEnabledEffective() && GameContext::Get().gameConfig_.fluidEnabled_)
         {
-            fluidUpdateTime_ = FLUID_SIMULATION_UPDATEINTERVAL+1;
+            fluidClock_.Reset(FLUID_SIMULATION_UPDATEINTERVAL, FLUID_SIMULATION_MAXSTEPS);
 
             SubscribeToEvent(GetScene(), E_SCENEPOSTUPDATE, URHO3D_HANDLER(WaterLayer, HandleUpdateFluids));
             SubscribeToEvent(node_, E_PHYSICSBEGINCONTACT2D, URHO3D_HANDLER(WaterLayer, HandleBeginFluidContact));
@@ -1964,16 +2102,22 @@ void WaterLayer::HandleUpdateFluids(StringHash eventType, VariantMap& eventData)
 
     URHO3D_PROFILE(WaterLayer_UpdateFluids);
 
-    fluidUpdateTime_ += eventData[SceneUpdate::P_TIMESTEP].GetFloat();
+    // fixed ticks : the fluids flow at the same speed at any frame rate
+    const unsigned tick = fluidClock_.ticks_;
+    const int numticks = fluidClock_.Advance(eventData[SceneUpdate::P_TIMESTEP].GetFloat());
+    unsigned numviewports = ViewManager::Get()->GetNumViewports();
 
-    if (fluidUpdateTime_ > FLUID_SIMULATION_UPDATEINTERVAL)
+    for (int i = 1; i <= numticks; i++)
     {
-        unsigned numviewports = ViewManager::Get()->GetNumViewports();
         for (unsigned viewport = 0; viewport < numviewports; viewport++)
-            bool update = layerDatas_[viewport].UpdateSimulation();
-
-        fluidUpdateTime_ = 0.f;
+            bool update = layerDatas_[viewport].UpdateSimulation(tick + i);
     }
+
+#ifdef FLUID_SIMULATION_INTERPOLATE
+    const float alpha = fluidClock_.GetAlpha();
+    for (unsigned viewport = 0; viewport < numviewports; viewport++)
+        layerDatas_[viewport].InterpolateSimulation(alpha);
+#endif
 }
 
 const float MAX_SPLASHVEL = 10.f;
@@ -40,6 +40,8 @@ struct WaterSurface
     WaterSurface* next_;
     Vertex2D* vertex0_;
     Vertex2D* vertex1_;
+    // index of the vertices in the tile batch (the vertex pointers are linked before the update of the waterline)
+    unsigned vertexIndex0_, vertexIndex1_;
 
     float bottomy_;
     float x0_, y0_;
@@ -87,7 +89,8 @@ struct WaterLine
 
     void Clear();
 
-    void ExpandFrom(WaterSurface* surface, Vector<WaterSurface>& surfaces);
+    void ExpandFrom(WaterSurface* surface, Vector<WaterSurface>& surfaces, const HashMap<unsigned, unsigned>& surfaceIndexes);
+    void LinkVertices(Vector<Vertex2D>& vertices);
     void Update(SourceBatch2D& batch, SourceBatch2D& batch2, const float zf);
 
     bool expanded_;
@@ -112,15 +115,47 @@ struct WaterLine
     static const float deformationThreshold_;
 };
 
+/// WaterTileCache : the water tiles and surfaces of a fluid view built for a viewport.
+/// They are kept while the cells of the fluid view and of its linked views don't change (see FluidDatas::renderStamp_).
+struct WaterTileCache
+{
+    enum
+    {
+        NUM_STAMPS = 6
+    };
+
+    bool IsValid(int viewZ, const ViewportRenderData& mapdata, const FluidDatas& fluiddata) const;
+    void Validate(int viewZ, const ViewportRenderData& mapdata, const FluidDatas& fluiddata);
+
+    static void GetStamps(const FluidDatas& fluiddata, unsigned* stamps);
+
+    const ViewportRenderData* mapdata_;
+    const FluidDatas* fluiddata_;
+    MapBase* map_;
+    int viewZ_;
+    IntRect rect_;
+    Matrix2x3 transform_;
+    // stamps of the fluid view, of its depth view and of the linked views
+    unsigned stamps_[NUM_STAMPS];
+    bool valid_;
+    bool used_;
+
+    Vector<Vertex2D> vertices_;
+    Vector<WaterSurface> surfaces_;
+};
+
 struct WaterLayerData
 {
     WaterLayerData();
 
     void Clear(int viewZ=0);
+    void ClearTileCaches(const ViewportRenderData* mapdata=0);
 
-    bool UpdateSimulation();
+    bool UpdateSimulation(unsigned tick);
+    void InterpolateSimulation(float alpha);
 
-    void UpdateTiledBatch(int viewZ, const ViewportRenderData& data, FluidDatas& fluiddata);
+    WaterTileCache& GetTileCache(int viewZ, const ViewportRenderData& mapdata, const FluidDatas& fluiddata);
+    void UpdateTiledBatch(int viewZ, const ViewportRenderData& data, FluidDatas& fluiddata, WaterTileCache& cache);
     void UpdateBatches();
 
     int viewport_;
@@ -129,6 +164,10 @@ struct WaterLayerData
     Vector<ViewportRenderData* > mapdatas_;
     Vector<WaterSurface> waterSurfaces_;
     Vector<WaterLine> waterLines_;
+    // last index of the water surface by cell address
+    HashMap<unsigned, unsigned> waterSurfaceIndexes_;
+    // tiles of the fluid views rebuilt only if their cells have changed
+    Vector<WaterTileCache> tileCaches_;
 
     bool batchesDirty_;
     SourceBatch2D watertilesBackBatch_, watertilesFrontBatch_, waterlinesBatch_;
@@ -200,7 +239,8 @@ private:
 
     Vector<WaterDeformationPoint> waterDeformationPoints_;
 
-    float fluidUpdateTime_;
+    // fixed timestep of the fluid simulation
+    FluidStepClock fluidClock_;
 
     static WaterLayer* waterLayer_;
 };
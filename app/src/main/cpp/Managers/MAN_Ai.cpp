@@ -3,6 +3,8 @@
 #include <Urho3D/Core/Context.h>
 
 #include <Urho3D/Core/Profiler.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/WorkQueue.h>
 
 #include <Urho3D/IO/Log.h>
 
@@ -11,11 +13,14 @@
 
 #include "GameAttributes.h"
 #include "GameEvents.h"
+#include "GameContext.h"
 
 #include "GOC_ControllerAI.h"
 
 #include "Behavior.h"
 #include "MAN_Go.h"
+#include "MapWorld.h"
+#include "ViewManager.h"
 
 #include "MAN_Ai.h"
 
@@ -23,7 +28,12 @@
 #define CLEANFACTOR 2
 
 #define MAXTIMEUPDATE 6U   // milliseconds for update pass
+#define MAXTIMEGATHER 3U   // milliseconds for the gathering of the agents to think, the think and apply phases use the rest of the pass
 
+// distances to the nearest player of the lod tiers in map widths, a tier is left beyond its distance * AILOD_HYSTERESIS
+#define AILOD_NEARDISTANCE 1.f
+#define AILOD_MIDDISTANCE 2.f
+#define AILOD_HYSTERESIS 1.25f
 
 static const int DEFAULT_AIUPDATE_FPS = 30;
 
@@ -35,8 +45,17 @@ AIManager::AIManager() :
     timer_(0),
     updateFps_(DEFAULT_AIUPDATE_FPS),
     updateInterval_(1.0f / (float)DEFAULT_AIUPDATE_FPS),
-    updateAcc_(0.0f)
-{ }
+    updateAcc_(0.0f),
+#ifdef AI_THINK_THREADING
+    numThinkAgents_(0),
+#endif
+    numPasses_(0),
+    numUpdated_(0),
+    numThought_(0)
+{
+    for (unsigned i = 0; i < AILOD_NumTiers; i++)
+        lodCounts_[i] = lodRoundCounts_[i] = 0;
+}
 
 AIManager::AIManager(Context* context) :
     Object(context),
@@ -44,8 +63,17 @@ AIManager::AIManager(Context* context) :
     timer_(0),
     updateFps_(DEFAULT_AIUPDATE_FPS),
     updateInterval_(1.0f / (float)DEFAULT_AIUPDATE_FPS),
-    updateAcc_(0.0f)
-{ }
+    updateAcc_(0.0f),
+#ifdef AI_THINK_THREADING
+    numThinkAgents_(0),
+#endif
+    numPasses_(0),
+    numUpdated_(0),
+    numThought_(0)
+{
+    for (unsigned i = 0; i < AILOD_NumTiers; i++)
+        lodCounts_[i] = lodRoundCounts_[i] = 0;
+}
 
 AIManager::AIManager(const AIManager& ai) :
     Object(ai.context_),
@@ -54,8 +82,17 @@ AIManager::AIManager(const AIManager& ai) :
     timer_(0),
     updateFps_(DEFAULT_AIUPDATE_FPS),
     updateInterval_(1.0f / (float)DEFAULT_AIUPDATE_FPS),
-    updateAcc_(0.0f)
-{ }
+    updateAcc_(0.0f),
+#ifdef AI_THINK_THREADING
+    numThinkAgents_(0),
+#endif
+    numPasses_(0),
+    numUpdated_(0),
+    numThought_(0)
+{
+    for (unsigned i = 0; i < AILOD_NumTiers; i++)
+        lodCounts_[i] = lodRoundCounts_[i] = 0;
+}
 
 AIManager::~AIManager()
 {
@@ -176,16 +213,212 @@ void AIManager::DumpAll()
         it->Dump();
 }
 
-void AIManager::Update()
+void AIManager::GetLodCounts(unsigned* counts)
+{
+    for (unsigned i = 0; i < AILOD_NumTiers; i++)
+        counts[i] = 0;
+
+    for (Vector<AIManager>::ConstIterator it=aiManagers.Begin(); it!=aiManagers.End(); ++it)
+        for (unsigned i = 0; i < AILOD_NumTiers; i++)
+            counts[i] += it->lodCounts_[i];
+}
+
+void AIManager::UpdateLodViews()
+{
+    lodPlayers_.Clear();
+    for (int i = 0; i < GameContext::Get().numPlayers_; i++)
+    {
+        Node* avatar = GameContext::Get().playerAvatars_[i];
+        if (avatar && avatar->IsEnabled())
+            lodPlayers_.Push(avatar->GetWorldPosition2D());
+    }
+
+    lodVisibleRects_.Clear();
+    if (World2D::GetWorld())
+    {
+        for (unsigned i = 0; i < ViewManager::Get()->GetNumViewports(); i++)
+            lodVisibleRects_.Push(World2D::GetExtendedVisibleRect(i));
+    }
+}
+
+unsigned char AIManager::GetLodTier(Node* node, unsigned char tier) const
+{
+    // no player to compare : full update
+    if (!lodPlayers_.Size())
+        return AILOD_Near;
+
+    const Vector2 position = node->GetWorldPosition2D();
+
+    // visible in a viewport
+    for (unsigned i = 0; i < lodVisibleRects_.Size(); i++)
+    {
+        if (lodVisibleRects_[i].IsInside(position) == INSIDE)
+            return AILOD_Near;
+    }
+
+    float sqdistance = M_INFINITY;
+    for (unsigned i = 0; i < lodPlayers_.Size(); i++)
+        sqdistance = Min(sqdistance, (lodPlayers_[i] - position).LengthSquared());
+
+    // hysteresis : the limits of the current tier and of the nearer tiers are extended
+    const float mapwidth = World2D::GetWorldMapWidth();
+    const float limits[AILOD_Far] = { AILOD_NEARDISTANCE * mapwidth, AILOD_MIDDISTANCE * mapwidth };
+
+    unsigned char newtier = AILOD_Near;
+    for (unsigned char i = 0; i < AILOD_Far; i++)
+    {
+        const float limit = tier <= i ? limits[i] * AILOD_HYSTERESIS : limits[i];
+        if (sqdistance > limit * limit)
+            newtier = i + 1;
+    }
+
+    return newtier;
+}
+
+bool AIManager::UpdateLod(Node* node, GOC_AIController* aiControl, unsigned time)
+{
+    const unsigned char tier = GetLodTier(node, aiControl->GetaiInfos().lodTier);
+    aiControl->SetLodTier(tier);
+    lodRoundCounts_[tier]++;
+
+    return tier == AILOD_Near || (tier == AILOD_Mid && time - aiControl->GetLastTimeUpdate() >= AILOD_MIDUPDATEDELAY);
+}
+
+#ifdef AI_THINK_THREADING
+static void AIThink(AIThinkJob& job)
+{
+    Vector<AIThinkAgent>& agents = *job.agents_;
+
+    for (unsigned i = job.begin_; i < job.end_; i++)
+    {
+        AIThinkAgent& agent = agents[i];
+        agent.behavior_->Think(*agent.controller_, agent.snapshot_, agent.commands_);
+    }
+}
+
+static void AIThinkJobThread(const WorkItem* item, unsigned threadIndex)
+{
+    AIThinkJob& job = *static_cast<AIThinkJob*>(item->aux_);
+    AIThink(job);
+    // release : the commands of the agents are visible to the main thread when it reads the counter
+    job.numRunning_->fetch_sub(1, std::memory_order_release);
+}
+
+void AIManager::AddThinkAgent(GOC_AIController* aiControl, Behavior* behavior, unsigned time)
+{
+    if (numThinkAgents_ == thinkAgents_.Size())
+        thinkAgents_.Resize(numThinkAgents_ + 1);
+
+    AIThinkAgent& agent = thinkAgents_[numThinkAgents_++];
+    agent.controller_ = aiControl;
+    agent.behavior_ = behavior;
+    agent.snapshot_.Set(*aiControl, time);
+    agent.commands_.Clear();
+}
+
+void AIManager::ThinkAgents(unsigned time)
+{
+    WorkQueue* queue = GameContext::Get().gameWorkQueue_;
+
+    // think phase : the batches of agents on the workers, the scene is frozen until the end of the phase
+    const unsigned numjobs = (numThinkAgents_ + AI_THINK_BATCHSIZE - 1) / AI_THINK_BATCHSIZE;
+    thinkJobs_.Resize(numjobs);
+
+    for (unsigned i = 0; i < numjobs; i++)
+    {
+        AIThinkJob& job = thinkJobs_[i];
+        job.agents_ = &thinkAgents_;
+        job.begin_ = i * AI_THINK_BATCHSIZE;
+        job.end_ = Min(job.begin_ + AI_THINK_BATCHSIZE, numThinkAgents_);
+        job.numRunning_ = &numThinkJobsRunning_;
+    }
+
+    if (queue && queue->GetNumThreads() > 0 && numjobs > 1)
+    {
+        queue->Pause();
+
+        for (unsigned i = 0; i < numjobs; i++)
+        {
+            AIThinkJob& job = thinkJobs_[i];
+            job.item_ = queue->GetFreeItem();
+            job.item_->sendEvent_ = false;
+            job.item_->priority_ = AI_THINK_WORKITEM_PRIORITY;
+            job.item_->workFunction_ = AIThinkJobThread;
+            job.item_->aux_ = &job;
+        }
+
+        numThinkJobsRunning_.store(numjobs, std::memory_order_relaxed);
+
+        for (unsigned i = 0; i < numjobs; i++)
+            queue->AddWorkItem(thinkJobs_[i].item_);
+
+        queue->Resume();
+
+        WaitThinkJobs();
+    }
+    else
+    {
+        for (unsigned i = 0; i < numjobs; i++)
+            AIThink(thinkJobs_[i]);
+    }
+
+    // apply phase : the commands and the controls on the main thread
+    for (unsigned i = 0; i < numThinkAgents_; i++)
+    {
+        AIThinkAgent& agent = thinkAgents_[i];
+        // an agent may be removed by the apply of the previous agents
+        if (agent.controller_)
+        {
+            agent.commands_.Apply(*agent.controller_, *agent.behavior_);
+            agent.controller_->ApplyUpdate(time);
+        }
+        agent.controller_.Reset();
+    }
+
+    numThought_ += numThinkAgents_;
+    numThinkAgents_ = 0;
+}
+
+void AIManager::WaitThinkJobs()
 {
-    Controls control;
+    // the main thread runs the jobs not yet taken by the workers : the other items of the queue are not run by this wait
+    WorkQueue* queue = GameContext::Get().gameWorkQueue_;
+    for (unsigned i = 0; i < thinkJobs_.Size(); i++)
+    {
+        AIThinkJob& job = thinkJobs_[i];
+        if (job.item_ && job.item_->aux_ == &job && queue->RemoveWorkItem(job.item_))
+        {
+            AIThink(job);
+            numThinkJobsRunning_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
 
-    Behavior* behavior = 0;
+    // only the jobs in progress in the workers remain
+    // acquire : pairs with the release of AIThinkJobThread
+    while (numThinkJobsRunning_.load(std::memory_order_acquire) != 0)
+        Time::Sleep(0);
+
+    for (unsigned i = 0; i < thinkJobs_.Size(); i++)
+        thinkJobs_[i].item_.Reset();
+}
+#endif
+
+void AIManager::Update()
+{
+    unsigned numupdated = 0;
 
+#ifdef AI_THINK_THREADING
+    timer_.SetExpirationTime(MAXTIMEGATHER);
+#else
     timer_.SetExpirationTime(MAXTIMEUPDATE);
+#endif
 
     unsigned time = Time::GetSystemTime();
 
+    UpdateLodViews();
+
+    const EntityRegistry& registry = EntityRegistry::Get();
+
     Vector<unsigned>::Iterator itend = iCount_;
     Vector<unsigned>::Iterator it = iCount_;
     do
@@ -195,7 +428,10 @@ void AIManager::Update()
         // get node
         if (nodeId)
         {
-            Node* node = scene_->GetNode(nodeId);
+            // resolve the node with the registry handle, the scene lookup only for the unregistered nodes
+            Node* node = registry.GetNode(nodeHandles_[it - nodeIDs_.Begin()]);
+            if (!node)
+                node = scene_->GetNode(nodeId);
             if (node)
             {
                 GOC_AIController* aiControl = node->GetComponent<GOC_AIController>();
@@ -205,12 +441,43 @@ void AIManager::Update()
                     nodeId = 0;
                 }
 
+                // level of detail : the far agents are frozen, the mid-range agents skip updates
+                else if (!UpdateLod(node, aiControl, time))
+                {
+//                    URHO3D_LOGINFOF("AIManager() - Update() : node %u skipped by the lod tier %u", nodeId, aiControl->GetaiInfos().lodTier);
+                }
+
+#ifdef AI_THINK_THREADING
+                // gather the agents to think, update the others
+                else
+                {
+                    Behavior* behavior = aiControl->PrepareUpdate(time);
+                    if (behavior)
+                    {
+                        if (behavior->CanThink())
+                        {
+                            AddThinkAgent(aiControl, behavior, time);
+                        }
+                        else
+                        {
+                            behavior->Update(*aiControl);
+                            aiControl->ApplyUpdate(time);
+                        }
+                    }
+                    numupdated++;
+                }
+#else
                 // update ai controller
                 else if (!aiControl->Update(time))
                 {
 //                    URHO3D_LOGERRORF("AIManager() - Update() : can't update aicontrol node %u ! index deleted", nodeId);
                     nodeId = 0;
                 }
+                else
+                {
+                    numupdated++;
+                }
+#endif
             }
             else
             {
@@ -222,8 +489,17 @@ void AIManager::Update()
         it++;
 
         if (it == nodeIDs_.End())
+        {
             it = nodeIDs_.Begin();
 
+            // end of the round : publish the tier counts
+            for (unsigned i = 0; i < AILOD_NumTiers; i++)
+            {
+                lodCounts_[i] = lodRoundCounts_[i];
+                lodRoundCounts_[i] = 0;
+            }
+        }
+
         // check timer expiration of the pass update
         if (timer_.Expired())
         {
@@ -235,6 +511,14 @@ void AIManager::Update()
     }
     while (it != itend);
 
+#ifdef AI_THINK_THREADING
+    if (numThinkAgents_)
+        ThinkAgents(time);
+#endif
+
+    numPasses_++;
+    numUpdated_ += numupdated;
+
 //    iCount_ = nodeIDs_.Begin();
 
 //    URHO3D_LOGINFOF("AIManager() - Update() : Finish in %u (%u passes)",
@@ -247,6 +531,12 @@ void AIManager::GetNodeIDs()
     {
         nodeIDs_ = goManager_->GetActiveAiNodes();
         iCount_ = nodeIDs_.Begin();
+
+        const EntityRegistry& registry = EntityRegistry::Get();
+        nodeHandles_.Resize(nodeIDs_.Size());
+        for (unsigned i=0; i < nodeIDs_.Size(); i++)
+            nodeHandles_[i] = registry.GetHandle(nodeIDs_[i]);
+
         lastUpdate_ = GOManager::GetLastUpdate();
 //        URHO3D_LOGINFOF("AIManager() - GetNodeIDs : Size = %u", nodeIDs_.Size());
     }
@@ -277,6 +567,9 @@ void AIManager::HandlePostUpdate(StringHash eventType, VariantMap& eventData)
 void AIManager::Dump() const
 {
     URHO3D_LOGINFOF("  num managed nodes=%u (gomanager has %u nodes)", nodeIDs_.Size(), GOManager::GetNumActiveAiNodes());
+    URHO3D_LOGINFOF("  lod tiers : near=%u mid=%u far=%u", lodCounts_[AILOD_Near], lodCounts_[AILOD_Mid], lodCounts_[AILOD_Far]);
+    URHO3D_LOGINFOF("  num update passes=%u agents updated by pass=%.1f (thought=%.1f)", numPasses_,
+                    numPasses_ ? (float)numUpdated_ / numPasses_ : 0.f, numPasses_ ? (float)numThought_ / numPasses_ : 0.f);
     for (unsigned i=0; i < nodeIDs_.Size(); i++)
         URHO3D_LOGINFOF("  node[%d]=%u", i, nodeIDs_[i]);
 }
@@ -1,7 +1,17 @@
 #pragma once
 
+#include <atomic>
+
+#include <Urho3D/Core/WorkQueue.h>
+
+#include "GameOptions.h"
+
 #include "TimerSimple.h"
 
+#include "Behavior.h"
+#include "GOC_ControllerAI.h"
+#include "EntityRegistry.h"
+
 namespace Urho3D
 {
 class Scene;
@@ -11,6 +21,29 @@ using namespace Urho3D;
 
 class GOManager;
 
+#ifdef AI_THINK_THREADING
+const unsigned AI_THINK_WORKITEM_PRIORITY = 1003U;
+// agents by think job
+const unsigned AI_THINK_BATCHSIZE = 32;
+
+struct AIThinkAgent
+{
+    WeakPtr<GOC_AIController> controller_;
+    Behavior* behavior_;
+    BehaviorSnapshot snapshot_;
+    BehaviorCommands commands_;
+};
+
+struct AIThinkJob
+{
+    Vector<AIThinkAgent>* agents_;
+    unsigned begin_, end_;
+    // running jobs of the think phase, decremented by the job at its end
+    std::atomic<unsigned>* numRunning_;
+    SharedPtr<WorkItem> item_;
+};
+#endif
+
 class AIManager : public Object
 {
     URHO3D_OBJECT(AIManager, Object);
@@ -40,11 +73,21 @@ public :
     static void StopManagers();
     static void RemoveManagers();
     static void DumpAll();
+    /// The agents by AILodTier
+    static void GetLodCounts(unsigned* counts);
 
 private :
     void Update();
+#ifdef AI_THINK_THREADING
+    void AddThinkAgent(GOC_AIController* aiControl, Behavior* behavior, unsigned time);
+    void ThinkAgents(unsigned time);
+    void WaitThinkJobs();
+#endif
 
     void GetNodeIDs();
+    void UpdateLodViews();
+    unsigned char GetLodTier(Node* node, unsigned char tier) const;
+    bool UpdateLod(Node* node, GOC_AIController* aiControl, unsigned time);
     void HandlePostUpdate(StringHash eventType, VariantMap& eventData);
 
     Scene* scene_;
@@ -60,9 +103,27 @@ private :
     /// Update time accumulator.
     float updateAcc_;
     Vector<unsigned> nodeIDs_;  // ID nodes managed
+    PODVector<EntityHandle> nodeHandles_;  // the registry handles of nodeIDs_
 
     unsigned lastUpdate_;
 
+#ifdef AI_THINK_THREADING
+    // the agents of the update pass in the think phase
+    Vector<AIThinkAgent> thinkAgents_;
+    unsigned numThinkAgents_;
+    Vector<AIThinkJob> thinkJobs_;
+    std::atomic<unsigned> numThinkJobsRunning_;
+#endif
+    // the players and the visible rects of the viewports for the lod tiers
+    PODVector<Vector2> lodPlayers_;
+    PODVector<Rect> lodVisibleRects_;
+    // the agents by tier in the last round of nodeIDs_, in the current round
+    unsigned lodCounts_[AILOD_NumTiers];
+    unsigned lodRoundCounts_[AILOD_NumTiers];
+
+    // Debug Stats : agents updated in the update passes, agents in the think phase
+    unsigned numPasses_, numUpdated_, numThought_;
+
     static Vector<AIManager> aiManagers;     // AI managers
 };
 
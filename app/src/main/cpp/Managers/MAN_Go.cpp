@@ -7,11 +7,22 @@
 #include "GameAttributes.h"
 #include "GameEvents.h"
 
+#include "EntityRegistry.h"
+
 #include "MAN_Go.h"
 
 
 GOManager* GOManager::goManager_=0;
 
+// keep the controller type and the flags of the registry records (the records are added by World2D)
+static void UpdateEntityController(unsigned nodeId, int goType, bool mainController)
+{
+    EntityRegistry& registry = EntityRegistry::Get();
+    EntityHandle handle = registry.GetHandle(nodeId);
+    registry.SetControllerType(handle, goType);
+    registry.SetFlags(handle, ENTITY_MainController, mainController);
+}
+
 unsigned GOManager::GetNumEnemies()
 {
     return goManager_ ? goManager_->enemy.Size() : 0;
@@ -78,6 +89,8 @@ GOManager::GOManager(Context* context) :
 GOManager::~GOManager()
 {
     URHO3D_LOGDEBUG("~GOManager()");
+    EventChannel<GoAppearEvent>::Get().Unsubscribe(this);
+    EventChannel<GoDestroyEvent>::Get().Unsubscribe(this);
     goManager_ = 0;
 }
 
@@ -94,8 +107,8 @@ void GOManager::Start()
 
     Reset(false);
 
-    SubscribeToEvent(GO_APPEAR, URHO3D_HANDLER(GOManager, HandleGOAppear));
-    SubscribeToEvent(GO_DESTROY, URHO3D_HANDLER(GOManager, HandleGODestroy));
+    EventChannel<GoAppearEvent>::Get().Subscribe<GOManager, &GOManager::HandleGOAppear>(this);
+    EventChannel<GoDestroyEvent>::Get().Subscribe<GOManager, &GOManager::HandleGODestroy>(this);
 
     SubscribeToEvent(GOC_LIFERESTORE, URHO3D_HANDLER(GOManager,HandleGOActive));
     SubscribeToEvent(GOC_LIFEDEAD, URHO3D_HANDLER(GOManager,HandleGODead));
@@ -105,8 +118,8 @@ void GOManager::Start()
 
 void GOManager::Stop()
 {
-    UnsubscribeFromEvent(GO_APPEAR);
-    UnsubscribeFromEvent(GO_DESTROY);
+    EventChannel<GoAppearEvent>::Get().Unsubscribe(this);
+    EventChannel<GoDestroyEvent>::Get().Unsubscribe(this);
 
     UnsubscribeFromEvent(GOC_LIFERESTORE);
     UnsubscribeFromEvent(GOC_LIFEDEAD);
@@ -152,125 +165,121 @@ int GOManager::firstActivePlayer()
     return -1;
 }
 
-void GOManager::HandleGOAppear(StringHash eventType, VariantMap& eventData)
+void GOManager::HandleGOAppear(Object* sender, const GoAppearEvent& event)
 {
-    if (eventType == GO_APPEAR)
-    {
-        if (eventData[Go_Appear::GO_TYPE].GetInt() == GO_None)
-            return;
+    if (event.type_ == GO_None)
+        return;
 
-        unsigned nodeId = eventData[Go_Appear::GO_ID].GetUInt();
-        int goType = eventData[Go_Appear::GO_TYPE].GetInt();
-        bool mainController = eventData[Go_Appear::GO_MAINCONTROL].GetBool();
+    unsigned nodeId = event.id_;
+    int goType = event.type_;
+    bool mainController = event.mainController_;
 
 //        URHO3D_LOGERRORF("GOManager() - HandleGOAppear : nodeid=%u type=%d mainctrl=%u", nodeId, goType, mainController);
 
-        switch (goType)
+    UpdateEntityController(nodeId, goType, mainController);
+
+    switch (goType)
+    {
+    case GO_AI :
+        if (!bots.Contains(nodeId))
+            bots.Push(nodeId);
+        if (!activeBots.Contains(nodeId))
+        {
+            activeBots.Push(nodeId);
+            lastUpdate_++;
+        }
+    case GO_AI_Enemy :
+        if (!enemy.Contains(nodeId))
+            enemy.Push(nodeId);
+        if (mainController)
         {
-        case GO_AI :
-            if (!bots.Contains(nodeId))
-                bots.Push(nodeId);
-            if (!activeBots.Contains(nodeId))
-            {
-                activeBots.Push(nodeId);
-                lastUpdate_++;
-            }
-        case GO_AI_Enemy :
-            if (!enemy.Contains(nodeId))
-                enemy.Push(nodeId);
-            if (mainController)
-            {
 //                URHO3D_LOGERRORF("GOManager() - HandleGOAppear : Enemy id=%u appeared : num = %u", nodeId, enemy.Size());
-                if (!activeEnemy.Contains(nodeId))
-                    activeEnemy.Push(nodeId);
-                if (!activeAiNodes.Contains(nodeId))
-                {
-                    activeAiNodes.Push(nodeId);
-                    lastUpdate_++;
-                }
-            }
-            break;
-        case GO_AI_None :
-        case GO_AI_Ally :
-            if (mainController && !activeAiNodes.Contains(nodeId))
+            if (!activeEnemy.Contains(nodeId))
+                activeEnemy.Push(nodeId);
+            if (!activeAiNodes.Contains(nodeId))
             {
                 activeAiNodes.Push(nodeId);
                 lastUpdate_++;
-//                URHO3D_LOGINFOF("GOManager() - HandleGOAppear : Ally id=%u appeared : num = %u", nodeId, enemy.Size() - activeAiNodes.Size());
-            }
-            break;
-        case GO_Player :
-        case GO_NetPlayer :
-            if (!player.Contains(nodeId))
-            {
-                player.Push(nodeId);
             }
-            if (!activePlayer.Contains(nodeId))
-            {
-                activePlayer.Push(nodeId);
-                URHO3D_LOGERRORF("GOManager() - HandleGOAppear : Player appeared : nodeid=%u numplayers=%u", nodeId, activePlayer.Size());
-            }
-            break;
         }
+        break;
+    case GO_AI_None :
+    case GO_AI_Ally :
+        if (mainController && !activeAiNodes.Contains(nodeId))
+        {
+            activeAiNodes.Push(nodeId);
+            lastUpdate_++;
+//                URHO3D_LOGINFOF("GOManager() - HandleGOAppear : Ally id=%u appeared : num = %u", nodeId, enemy.Size() - activeAiNodes.Size());
+        }
+        break;
+    case GO_Player :
+    case GO_NetPlayer :
+        if (!player.Contains(nodeId))
+        {
+            player.Push(nodeId);
+        }
+        if (!activePlayer.Contains(nodeId))
+        {
+            activePlayer.Push(nodeId);
+            URHO3D_LOGERRORF("GOManager() - HandleGOAppear : Player appeared : nodeid=%u numplayers=%u", nodeId, activePlayer.Size());
+        }
+        break;
     }
 }
 
-void GOManager::HandleGODestroy(StringHash eventType, VariantMap& eventData)
+void GOManager::HandleGODestroy(Object* sender, const GoDestroyEvent& event)
 {
-    if (eventType == GO_DESTROY)
-    {
-        if (eventData[Go_Destroy::GO_TYPE].GetUInt() == GO_None)
-            return;
+    if (event.type_ == GO_None)
+        return;
 
-        unsigned nodeId = eventData[Go_Destroy::GO_ID].GetUInt();
-        int goType = eventData[Go_Destroy::GO_TYPE].GetInt();
+    unsigned nodeId = event.id_;
+    int goType = event.type_;
 
 //        URHO3D_LOGINFOF("GOManager() - HandleGODestroy : GO DESTROY node=%u type=%d", nodeId, goType);
 
-        switch (goType)
+    switch (goType)
+    {
+    case GO_AI :
+        if (bots.Contains(nodeId))
         {
-        case GO_AI :
-            if (bots.Contains(nodeId))
-            {
-                bots.Remove(nodeId);
-                activeBots.Remove(nodeId);
-                lastUpdate_++;
-            }
-        case GO_AI_Enemy :
-            if (enemy.Contains(nodeId))
-            {
-                enemy.Remove(nodeId);
-                activeEnemy.Remove(nodeId);
+            bots.Remove(nodeId);
+            activeBots.Remove(nodeId);
+            lastUpdate_++;
+        }
+    case GO_AI_Enemy :
+        if (enemy.Contains(nodeId))
+        {
+            enemy.Remove(nodeId);
+            activeEnemy.Remove(nodeId);
 //                URHO3D_LOGINFOF("GOManager() - HandleGODestroy : Enemy destroyed : num = %u", enemy.Size());
-            }
-            if (activeAiNodes.Contains(nodeId))
-            {
-                activeAiNodes.Remove(nodeId);
-                lastUpdate_++;
-            }
-            break;
-        case GO_AI_None :
-        case GO_AI_Ally :
-            if (activeAiNodes.Contains(nodeId))
-            {
-                activeAiNodes.Remove(nodeId);
-                lastUpdate_++;
+        }
+        if (activeAiNodes.Contains(nodeId))
+        {
+            activeAiNodes.Remove(nodeId);
+            lastUpdate_++;
+        }
+        break;
+    case GO_AI_None :
+    case GO_AI_Ally :
+        if (activeAiNodes.Contains(nodeId))
+        {
+            activeAiNodes.Remove(nodeId);
+            lastUpdate_++;
 //                URHO3D_LOGINFOF("GOManager() - HandleGOAppear : Ally destroyed : num = %u", activeAiNodes.Size());
-            }
-            break;
-        case GO_Player :
-        case GO_NetPlayer :
-            if (player.Contains(nodeId))
-            {
-                player.Remove(nodeId);
+        }
+        break;
+    case GO_Player :
+    case GO_NetPlayer :
+        if (player.Contains(nodeId))
+        {
+            player.Remove(nodeId);
 //                URHO3D_LOGINFOF("GOManager() - HandleGODestroy : Player destroyed : numPlayerAlive = %u", player.Size());
-            }
-            if (activePlayer.Contains(nodeId))
-            {
-                activePlayer.Remove(nodeId);
-            }
-            break;
         }
+        if (activePlayer.Contains(nodeId))
+        {
+            activePlayer.Remove(nodeId);
+        }
+        break;
     }
 }
 
@@ -283,6 +292,8 @@ void GOManager::HandleGOActive(StringHash eventType, VariantMap& eventData)
         bool mainController = eventData[GOC_Life_Events::GO_MAINCONTROL].GetBool();
 
 //        URHO3D_LOGINFOF("GOManager() - HandleGOActive : GO GOC_LIFERESTORE node=%u type=%d", nodeId, goType);
+
+        EntityRegistry::Get().SetFlags(EntityRegistry::Get().GetHandle(nodeId), ENTITY_Dead, false);
         switch (goType)
         {
         case GO_AI :
@@ -334,6 +345,8 @@ void GOManager::HandleGODead(StringHash eventType, VariantMap& eventData)
 
         URHO3D_LOGINFOF("GOManager() - HandleGODead : GO GOC_LIFEDEAD node=%u type=%d", nodeId, goType);
 
+        EntityRegistry::Get().SetFlags(EntityRegistry::Get().GetHandle(nodeId), ENTITY_Dead, true);
+
         switch (goType)
         {
         case GO_AI :
@@ -382,6 +395,8 @@ void GOManager::HandleGOChangeType(StringHash eventType, VariantMap& eventData)
         int goType = eventData[ControllerChange::GO_TYPE].GetInt();
         bool mainController = eventData[ControllerChange::GO_MAINCONTROL].GetBool();
 
+        UpdateEntityController(nodeId, goType, mainController);
+
         switch (goType)
         {
         case GO_AI_None :
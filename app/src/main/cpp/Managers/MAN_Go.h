@@ -3,6 +3,8 @@
 
 using namespace Urho3D;
 
+struct GoAppearEvent;
+struct GoDestroyEvent;
 
 class GOManager : public Object
 {
@@ -45,8 +47,8 @@ public :
     static bool IsA(unsigned nodeId, int controllerType);
 
 private :
-    void HandleGOAppear(StringHash eventType, VariantMap& eventData);
-    void HandleGODestroy(StringHash eventType, VariantMap& eventData);
+    void HandleGOAppear(Object* sender, const GoAppearEvent& event);
+    void HandleGODestroy(Object* sender, const GoDestroyEvent& event);
     void HandleGOActive(StringHash eventType, VariantMap& eventData);
     void HandleGODead(StringHash eventType, VariantMap& eventData);
     void HandleGOChangeType(StringHash eventType, VariantMap& eventData);
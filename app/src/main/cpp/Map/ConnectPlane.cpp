@@ -0,0 +1,206 @@
+#include "ConnectPlane.h"
+
+
+/// Connected8 index by [sides][empty corners]
+struct ConnectCornerTable
+{
+    ConnectCornerTable()
+    {
+        for (int sides = 0; sides < 16; sides++)
+            for (int corners = 0; corners < 16; corners++)
+                index_[sides][corners] = ConnectPlane::GetCornerConnectIndex(sides, corners);
+    }
+
+    ConnectIndex index_[16][16];
+};
+
+static const ConnectCornerTable sConnectCornerTable_;
+
+// neighbor planes aligned on the bits of the current word
+static inline unsigned long long GetPlaneRight(const unsigned long long* row, unsigned w, unsigned numwords)
+{
+    return (row[w] >> 1) | (w+1 < numwords ? row[w+1] << 63 : 0ULL);
+}
+
+static inline unsigned long long GetPlaneLeft(const unsigned long long* row, unsigned w)
+{
+    return (row[w] << 1) | (w > 0 ? row[w-1] >> 63 : 0ULL);
+}
+
+static inline int GetPlaneBit(unsigned long long plane, unsigned bit)
+{
+    return (int)((plane >> bit) & 1ULL);
+}
+
+
+ConnectPlane::ConnectPlane() :
+    width_(0),
+    height_(0),
+    rowWords_(0)
+{ }
+
+void ConnectPlane::Clear()
+{
+    bits_.Clear();
+    width_ = height_ = rowWords_ = 0;
+}
+
+void ConnectPlane::Update(const FeatureType* features, unsigned width, unsigned height, int ymin, int ymax)
+{
+    if (width_ != width || height_ != height)
+    {
+        width_ = width;
+        height_ = height;
+        rowWords_ = (width + 63) >> 6;
+        bits_.Resize(rowWords_ * height);
+        ymin = 0;
+        ymax = height-1;
+    }
+
+    for (int y = ymin; y <= ymax; y++)
+    {
+        const FeatureType* frow = features + y * width;
+        unsigned long long* row = &bits_[y * rowWords_];
+
+        for (unsigned w = 0; w < rowWords_; w++)
+        {
+            const unsigned x0 = w << 6;
+            const unsigned numbits = Min(64U, width - x0);
+            unsigned long long bits = 0ULL;
+            for (unsigned b = 0; b < numbits; b++)
+                bits |= (unsigned long long)(frow[x0 + b] > MapFeatureType::InnerSpace) << b;
+            row[w] = bits;
+        }
+    }
+}
+
+void ConnectPlane::SetConnectIndexes(const FeatureType* features, ConnectIndex* connections, const IntRect& rect, bool corners) const
+{
+    const unsigned numwords = rowWords_;
+
+    for (int y = rect.top_; y <= rect.bottom_; y++)
+    {
+        const unsigned long long* row = &bits_[y * numwords];
+        const unsigned long long* above = y > 0 ? row - numwords : 0;
+        const unsigned long long* below = y+1 < (int)height_ ? row + numwords : 0;
+
+        for (unsigned w = (unsigned)rect.left_ >> 6; w <= (unsigned)rect.right_ >> 6; w++)
+        {
+            const unsigned long long top = above ? above[w] : 0ULL;
+            const unsigned long long right = GetPlaneRight(row, w, numwords);
+            const unsigned long long bottom = below ? below[w] : 0ULL;
+            const unsigned long long left = GetPlaneLeft(row, w);
+
+            unsigned long long topleft = 0ULL, topright = 0ULL, bottomright = 0ULL, bottomleft = 0ULL;
+            if (corners)
+            {
+                if (above)
+                {
+                    topleft = GetPlaneLeft(above, w);
+                    topright = GetPlaneRight(above, w, numwords);
+                }
+                if (below)
+                {
+                    bottomleft = GetPlaneLeft(below, w);
+                    bottomright = GetPlaneRight(below, w, numwords);
+                }
+            }
+
+            const int xmin = Max(rect.left_, (int)(w << 6));
+            const int xmax = Min(rect.right_, (int)(w << 6) + 63);
+            unsigned addr = y * width_ + xmin;
+
+            for (int x = xmin; x <= xmax; x++, addr++)
+            {
+                if (features[addr] < MapFeatureType::NoRender)
+                {
+                    connections[addr] = MapTilesConnectType::Void;
+                    continue;
+                }
+
+                const unsigned bit = x & 63;
+                const int sides = GetPlaneBit(top, bit) | (GetPlaneBit(right, bit) << RightBit) |
+                                  (GetPlaneBit(bottom, bit) << BottomBit) | (GetPlaneBit(left, bit) << LeftBit);
+
+                if (corners)
+                {
+                    const int solidcorners = GetPlaneBit(topleft, bit) | (GetPlaneBit(topright, bit) << TopRightBit) |
+                                             (GetPlaneBit(bottomright, bit) << BottomRightBit) | (GetPlaneBit(bottomleft, bit) << BottomLeftBit);
+                    connections[addr] = sConnectCornerTable_.index_[sides][~solidcorners & FourCorners];
+                }
+                else
+                {
+                    connections[addr] = sides;
+                }
+            }
+        }
+    }
+}
+
+ConnectIndex ConnectPlane::GetCornerConnectIndex(int sides, int emptycorners)
+{
+    const bool topleft = (emptycorners & TopLeftCorner) != 0;
+    const bool topright = (emptycorners & TopRightCorner) != 0;
+    const bool bottomright = (emptycorners & BottomRightCorner) != 0;
+    const bool bottomleft = (emptycorners & BottomLeftCorner) != 0;
+
+    switch (sides)
+    {
+    /// 2-Connected cases : the corner between the sides
+    case MapTilesConnectType::TopRightConnect :
+        return topright ? MapTilesConnectType::TopRightConnect_Corner : sides;
+    case MapTilesConnectType::BottomRightConnect :
+        return bottomright ? MapTilesConnectType::BottomRightConnect_Corner : sides;
+    case MapTilesConnectType::TopLeftConnect :
+        return topleft ? MapTilesConnectType::TopLeftConnect_Corner : sides;
+    case MapTilesConnectType::BottomLeftConnect :
+        return bottomleft ? MapTilesConnectType::BottomLeftConnect_Corner : sides;
+    /// 3-Connected cases : the two corners on the side of the connected border
+    case MapTilesConnectType::TopRightBottomConnect :
+        if (bottomright && topright)
+            return MapTilesConnectType::TopRightBottomConnect_CornerTopBottom;
+        return bottomright ? MapTilesConnectType::TopRightBottomConnect_CornerBottom :
+               topright ? MapTilesConnectType::TopRightBottomConnect_CornerTop : sides;
+    case MapTilesConnectType::TopRightLeftConnect :
+        if (topright && topleft)
+            return MapTilesConnectType::TopRightLeftConnect_CornerRightLeft;
+        return topright ? MapTilesConnectType::TopRightLeftConnect_CornerRight :
+               topleft ? MapTilesConnectType::TopRightLeftConnect_CornerLeft : sides;
+    case MapTilesConnectType::TopBottomLeftConnect :
+        if (topleft && bottomleft)
+            return MapTilesConnectType::TopBottomLeftConnect_CornerTopBottom;
+        return topleft ? MapTilesConnectType::TopBottomLeftConnect_CornerTop :
+               bottomleft ? MapTilesConnectType::TopBottomLeftConnect_CornerBottom : sides;
+    case MapTilesConnectType::RightBottomLeftConnect :
+        if (bottomleft && bottomright)
+            return MapTilesConnectType::RightBottomLeftConnect_CornerRightLeft;
+        return bottomleft ? MapTilesConnectType::RightBottomLeftConnect_CornerLeft :
+               bottomright ? MapTilesConnectType::RightBottomLeftConnect_CornerRight : sides;
+    /// 4-Connected cases : the empty corners
+    case MapTilesConnectType::AllConnect :
+    {
+        static const ConnectIndex allConnect[16] =
+        {
+            MapTilesConnectType::AllConnect,                          // no corner
+            MapTilesConnectType::AllConnect_C1_TopLeft,               // TL
+            MapTilesConnectType::AllConnect_C1_TopRight,              // TR
+            MapTilesConnectType::AllConnect_C2_TopLeftRight,          // TL TR
+            MapTilesConnectType::AllConnect_C1_BottomRight,           // BR
+            MapTilesConnectType::AllConnect_C2_TopLeft_BottomRight,   // TL BR
+            MapTilesConnectType::AllConnect_C2_TopBottomRight,        // TR BR
+            MapTilesConnectType::AllConnect_C3_NoBottomLeftCorner,    // TL TR BR
+            MapTilesConnectType::AllConnect_C1_BottomLeft,            // BL
+            MapTilesConnectType::AllConnect_C2_TopBottomLeft,         // TL BL
+            MapTilesConnectType::AllConnect_C2_TopRight_BottomLeft,   // TR BL
+            MapTilesConnectType::AllConnect_C3_NoBottomRightCorner,   // TL TR BL
+            MapTilesConnectType::AllConnect_C2_BottomRightLeft,       // BR BL
+            MapTilesConnectType::AllConnect_C3_NoTopRightCorner,      // TL BR BL
+            MapTilesConnectType::AllConnect_C3_NoTopLeftCorner,       // TR BR BL
+            MapTilesConnectType::AllConnect_C4                        // TL TR BR BL
+        };
+        return allConnect[emptycorners & FourCorners];
+    }
+    default :
+        return sides;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Math/Rect.h>
+
+#include "MapFeatureTypes.h"
+#include "MapTilesConnect.h"
+
+using namespace Urho3D;
+
+
+/// ConnectPlane : table-driven connect indexes of the tiles (Connected4 and Connected8 modes).
+/// One bit by tile (feature > InnerSpace), 64 tiles by word : the side and corner neighbors of a word are read with shifts.
+/// The Connected8 index comes from a table [sides][empty corners] with the corner rules of Tile::GetCornerIndex.
+/// The tiles outside the map are not connected, as with the border setters Tile::GetConnectIndexNghb2/3.
+class ConnectPlane
+{
+public:
+    ConnectPlane();
+
+    void Clear();
+
+    /// Set the bits of the rows ymin to ymax from the features, all the rows if the size changes
+    void Update(const FeatureType* features, unsigned width, unsigned height, int ymin, int ymax);
+    /// Set the connect indexes of the tiles in the rect (included), Void for the features under NoRender
+    void SetConnectIndexes(const FeatureType* features, ConnectIndex* connections, const IntRect& rect, bool corners) const;
+
+    /// Connected8 index of a tile with the connected sides (ContactSide) and the empty corners (CornerValue)
+    static ConnectIndex GetCornerConnectIndex(int sides, int emptycorners);
+
+    unsigned GetWidth() const { return width_; }
+    unsigned GetHeight() const { return height_; }
+
+private:
+    PODVector<unsigned long long> bits_;
+    unsigned width_, height_;
+    unsigned rowWords_;
+};
@@ -0,0 +1,194 @@
+#include "EntityGrid.h"
+
+
+EntityGrid::EntityGrid(float cellsize) :
+    stamp_(0)
+{
+    SetCellSize(cellsize);
+}
+
+void EntityGrid::SetCellSize(float cellsize)
+{
+    Clear();
+
+    cellSize_ = cellsize > 0.f ? cellsize : 1.f;
+    invCellSize_ = 1.f / cellSize_;
+}
+
+void EntityGrid::Clear()
+{
+    entries_.Clear();
+    indexes_.Clear();
+    cells_.Clear();
+}
+
+void EntityGrid::Insert(unsigned id, const Vector2& position, StringHash type)
+{
+    HashMap<unsigned, unsigned>::ConstIterator it = indexes_.Find(id);
+    if (it != indexes_.End())
+    {
+        entries_[it->second_].type_ = type;
+        Move(id, position);
+        return;
+    }
+
+    const unsigned index = entries_.Size();
+    entries_.Resize(index + 1);
+
+    Entry& entry = entries_[index];
+    entry.id_ = id;
+    entry.type_ = type;
+    entry.position_ = position;
+    entry.stamp_ = stamp_;
+    indexes_[id] = index;
+
+    AddToCell(index, GetCellKey(position));
+}
+
+void EntityGrid::Move(unsigned id, const Vector2& position)
+{
+    HashMap<unsigned, unsigned>::ConstIterator it = indexes_.Find(id);
+    if (it == indexes_.End())
+        return;
+
+    const unsigned index = it->second_;
+    Entry& entry = entries_[index];
+    entry.position_ = position;
+
+    const unsigned key = GetCellKey(position);
+    if (key == entry.cell_)
+        return;
+
+    RemoveFromCell(index);
+    AddToCell(index, key);
+}
+
+void EntityGrid::Remove(unsigned id)
+{
+    HashMap<unsigned, unsigned>::Iterator it = indexes_.Find(id);
+    if (it == indexes_.End())
+        return;
+
+    const unsigned index = it->second_;
+    indexes_.Erase(it);
+    RemoveFromCell(index);
+
+    // move the last entry in the hole
+    const unsigned last = entries_.Size() - 1;
+    if (index != last)
+    {
+        Entry& moved = entries_[index];
+        moved = entries_[last];
+        indexes_[moved.id_] = index;
+        cells_[moved.cell_][moved.slot_] = index;
+    }
+
+    entries_.Resize(last);
+}
+
+void EntityGrid::AddToCell(unsigned index, unsigned key)
+{
+    PODVector<unsigned>& cell = cells_[key];
+
+    Entry& entry = entries_[index];
+    entry.cell_ = key;
+    entry.slot_ = cell.Size();
+
+    cell.Push(index);
+}
+
+void EntityGrid::RemoveFromCell(unsigned index)
+{
+    const Entry& entry = entries_[index];
+
+    HashMap<unsigned, PODVector<unsigned> >::Iterator it = cells_.Find(entry.cell_);
+    PODVector<unsigned>& cell = it->second_;
+
+    // move the last index of the cell in the hole
+    const unsigned last = cell.Back();
+    cell[entry.slot_] = last;
+    entries_[last].slot_ = entry.slot_;
+    cell.Pop();
+
+    if (cell.Empty())
+        cells_.Erase(it);
+}
+
+void EntityGrid::Query(const Rect& rect, PODVector<unsigned>& ids, StringHash type)
+{
+    stamp_++;
+    QueryRect(rect, ids, type);
+}
+
+void EntityGrid::Query(const Rect* rects, unsigned numrects, PODVector<unsigned>& ids, StringHash type)
+{
+    stamp_++;
+    for (unsigned i = 0; i < numrects; i++)
+        QueryRect(rects[i], ids, type);
+}
+
+void EntityGrid::QueryRadius(const Vector2& center, float radius, PODVector<unsigned>& ids, StringHash type)
+{
+    const float sqradius = radius * radius;
+    const int xmin = GetCellCoord(center.x_ - radius);
+    const int xmax = GetCellCoord(center.x_ + radius);
+    const int ymin = GetCellCoord(center.y_ - radius);
+    const int ymax = GetCellCoord(center.y_ + radius);
+
+    for (int y = ymin; y <= ymax; y++)
+    {
+        for (int x = xmin; x <= xmax; x++)
+        {
+            HashMap<unsigned, PODVector<unsigned> >::ConstIterator it = cells_.Find(GetCellKey(x, y));
+            if (it == cells_.End())
+                continue;
+
+            const PODVector<unsigned>& cell = it->second_;
+            for (unsigned i = 0; i < cell.Size(); i++)
+            {
+                const Entry& entry = entries_[cell[i]];
+                if ((type == StringHash::ZERO || entry.type_ == type) && (entry.position_ - center).LengthSquared() <= sqradius)
+                    ids.Push(entry.id_);
+            }
+        }
+    }
+}
+
+void EntityGrid::QueryRect(const Rect& rect, PODVector<unsigned>& ids, StringHash type)
+{
+    const int xmin = GetCellCoord(rect.min_.x_);
+    const int xmax = GetCellCoord(rect.max_.x_);
+    const int ymin = GetCellCoord(rect.min_.y_);
+    const int ymax = GetCellCoord(rect.max_.y_);
+
+    for (int y = ymin; y <= ymax; y++)
+    {
+        // inner cells : no position test on x
+        const bool innery = y > ymin && y < ymax;
+
+        for (int x = xmin; x <= xmax; x++)
+        {
+            HashMap<unsigned, PODVector<unsigned> >::ConstIterator it = cells_.Find(GetCellKey(x, y));
+            if (it == cells_.End())
+                continue;
+
+            const bool inner = innery && x > xmin && x < xmax;
+
+            const PODVector<unsigned>& cell = it->second_;
+            for (unsigned i = 0; i < cell.Size(); i++)
+            {
+                Entry& entry = entries_[cell[i]];
+                if (entry.stamp_ == stamp_)
+                    continue;
+                if (type != StringHash::ZERO && entry.type_ != type)
+                    continue;
+                if (!inner && (entry.position_.x_ < rect.min_.x_ || entry.position_.x_ > rect.max_.x_ ||
+                               entry.position_.y_ < rect.min_.y_ || entry.position_.y_ > rect.max_.y_))
+                    continue;
+
+                entry.stamp_ = stamp_;
+                ids.Push(entry.id_);
+            }
+        }
+    }
+}
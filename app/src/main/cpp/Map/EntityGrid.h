@@ -0,0 +1,92 @@
+#pragma once
+
+#include <Urho3D/Container/HashMap.h>
+#include <Urho3D/Math/Rect.h>
+#include <Urho3D/Math/StringHash.h>
+
+using namespace Urho3D;
+
+
+/// EntityGrid : uniform grid of the entities in world space.
+/// The rect, radius and type queries visit only the cells overlapping the query and return each entity once.
+/// The entities are moved in the grid when they change of tile (see GOC_Destroyer::UpdatePositions).
+
+// cell size in tiles
+const int ENTITYGRID_CELLTILES = 8;
+
+class EntityGrid
+{
+public:
+    EntityGrid(float cellsize=1.f);
+
+    /// Set the cell size, the grid is cleared
+    void SetCellSize(float cellsize);
+    void Clear();
+
+    /// Insert or move an entity
+    void Insert(unsigned id, const Vector2& position, StringHash type=StringHash::ZERO);
+    /// Move an entity, skip if the entity is not in the grid
+    void Move(unsigned id, const Vector2& position);
+    void Remove(unsigned id);
+
+    /// Add the ids of the entities inside the rects to ids, filtered by type if type isn't zero
+    void Query(const Rect& rect, PODVector<unsigned>& ids, StringHash type=StringHash::ZERO);
+    void Query(const Rect* rects, unsigned numrects, PODVector<unsigned>& ids, StringHash type=StringHash::ZERO);
+    void QueryRadius(const Vector2& center, float radius, PODVector<unsigned>& ids, StringHash type=StringHash::ZERO);
+
+    bool Contains(unsigned id) const
+    {
+        return indexes_.Contains(id);
+    }
+    float GetCellSize() const
+    {
+        return cellSize_;
+    }
+    unsigned GetNumEntities() const
+    {
+        return entries_.Size();
+    }
+    unsigned GetNumCells() const
+    {
+        return cells_.Size();
+    }
+
+private:
+    struct Entry
+    {
+        unsigned id_;
+        StringHash type_;
+        Vector2 position_;
+        // the cell key and the index in the cell
+        unsigned cell_;
+        unsigned slot_;
+        // last query that returned the entity
+        unsigned stamp_;
+    };
+
+    int GetCellCoord(float value) const
+    {
+        return FloorToInt(value * invCellSize_);
+    }
+    unsigned GetCellKey(int x, int y) const
+    {
+        return ((unsigned)(x & 0xFFFF) << 16) | (unsigned)(y & 0xFFFF);
+    }
+    unsigned GetCellKey(const Vector2& position) const
+    {
+        return GetCellKey(GetCellCoord(position.x_), GetCellCoord(position.y_));
+    }
+
+    void AddToCell(unsigned index, unsigned key);
+    void RemoveFromCell(unsigned index);
+    void QueryRect(const Rect& rect, PODVector<unsigned>& ids, StringHash type);
+
+    float cellSize_, invCellSize_;
+
+    PODVector<Entry> entries_;
+    // entity id => index in entries_
+    HashMap<unsigned, unsigned> indexes_;
+    // cell key => indexes in entries_
+    HashMap<unsigned, PODVector<unsigned> > cells_;
+    unsigned stamp_;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "MapFeatureTypes.h"
+
+const int REPLACEFEATURE        = 1;
+const int REPLACEFEATUREBACK    = 2;
+const int REPLACEFRONTIER       = 3;
+const int COPYTILEMODIFIER      = 4;
+const int TRANSFERFRONTIER      = 5;
+const int REPLACEFEATUREBACK2   = 6;
+
+/// number of tiles processed by all the passes before going to the next block (fits in L1 for 5 views)
+const unsigned FEATUREFILTER_BLOCKSIZE = 1024;
+
+
+/// FeatureFilterPass : a per-tile feature filter resolved on the view buffers
+struct FeatureFilterPass
+{
+    int filter_;
+    FeatureType feature1_;
+    FeatureType feature2_;
+    FeatureType featureBack_;
+    FeatureType* view1_;
+    const FeatureType* view2_;
+};
+
+/// the filters that only read and write the current tile can be fused
+inline bool IsPointwiseFeatureFilter(int filter)
+{
+    return filter == REPLACEFEATURE || filter == REPLACEFEATUREBACK || filter == REPLACEFEATUREBACK2;
+}
+
+/// Apply a chain of per-tile filters in a single pass over the views.
+/// The tiles are processed by blocks and all the passes run on a block while it is in cache.
+/// The result is the same as applying each filter on the whole views one after the other.
+inline void ApplyFeatureFilterPasses(const FeatureFilterPass* passes, unsigned numpasses, unsigned numtiles, unsigned blocksize=FEATUREFILTER_BLOCKSIZE)
+{
+    for (unsigned start = 0; start < numtiles; start += blocksize)
+    {
+        const unsigned end = start + blocksize < numtiles ? start + blocksize : numtiles;
+
+        for (unsigned i = 0; i < numpasses; i++)
+        {
+            const FeatureFilterPass& pass = passes[i];
+            FeatureType* view1 = pass.view1_;
+            const FeatureType* view2 = pass.view2_;
+            const FeatureType feature1 = pass.feature1_;
+            const FeatureType feature2 = pass.feature2_;
+            const FeatureType featureBack = pass.featureBack_;
+
+            if (pass.filter_ == REPLACEFEATURE)
+            {
+                for (unsigned addr = start; addr < end; addr++)
+                    view1[addr] = view1[addr] == feature1 ? feature2 : view1[addr];
+            }
+            else if (pass.filter_ == REPLACEFEATUREBACK)
+            {
+                for (unsigned addr = start; addr < end; addr++)
+                    view1[addr] = view1[addr] == feature1 && view2[addr] > featureBack ? feature2 : view1[addr];
+            }
+            else if (pass.filter_ == REPLACEFEATUREBACK2)
+            {
+                for (unsigned addr = start; addr < end; addr++)
+                    view1[addr] = view1[addr] == feature1 && view2[addr] == featureBack ? feature2 : view1[addr];
+            }
+        }
+    }
+}
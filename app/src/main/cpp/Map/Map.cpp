@@ -62,6 +62,7 @@
 #if defined(HANDLE_ENTITIES) || defined(HANDLE_FURNITURES)
 #include "GOC_Animator2D.h"
 #include "GOC_Detector.h"
+#include "GOC_Collide2D.h"
 #include "GOC_Controller.h"
 #include "GOC_Collectable.h"
 #include "ObjectPool.h"
@@ -74,6 +75,8 @@
 
 #include "MapColliderGenerator.h"
 
+#include "PathFinder2D.h"
+
 #include "ObjectMaped.h"
 #include "Map.h"
 
@@ -1192,6 +1195,10 @@ void MapBase::SetTile(FeatureType feat, int x, int y, int viewZ, Tile** removedt
     fluidcell->Set(featref);
     fluidcell->UnsettleNeighbors();
     fluidcell->ResetDirections();
+    featuredMap_->WakeFluidCells(tileindex);
+
+    // Update the abstract path graph
+    PathFinder2D::MarkTileChanged(GetMapPoint(), tileindex);
 
 //    URHO3D_LOGINFOF("MapBase() - SetTile : Update ObjectSkinned : x=%d y=%d ... ", x, y);
 
@@ -1418,6 +1425,7 @@ void MapBase::SetTiles(FeatureType feat, int viewZ, const Vector<unsigned>& tile
         fluidcell->Set(featref);
         fluidcell->UnsettleNeighbors();
         fluidcell->ResetDirections();
+        featuredMap_->WakeFluidCells(tileindex);
 
         // Set Tile Views
         for(HashSet<IntVector2>::Iterator it = viewsToUpdate.Begin(); it != viewsToUpdate.End(); ++it)
@@ -1505,6 +1513,7 @@ bool MapBase::SetTileEntity(FeatureType feature, unsigned tileindex, int viewZ,
         fluidcell->Set(feature);
         fluidcell->UnsettleNeighbors();
         fluidcell->ResetDirections();
+        featuredMap_->WakeFluidCells(tileindex);
     }
 
     // Add Tile Node
@@ -1881,6 +1890,14 @@ bool MapBase::GenerateColliders(HiresTimer* timer, bool setPhysic)
 
 static unsigned char sLastContourId_;
 
+// break the contacts of the bodies on the removed tile (a bit larger than the tile for the bodies resting on its edges)
+static void BreakTileContacts(const MapBase* map, CollisionShape2D* shape, unsigned tileindex)
+{
+    const Vector2 center = map->GetWorldTilePosition(map->GetTileCoords(tileindex));
+    const Vector2 halfsize(0.55f * Map::info_->tileWidth_, 0.55f * Map::info_->tileHeight_);
+    GOC_Collide2D::BreakContactsOnTile(shape, Rect(center - halfsize, center + halfsize));
+}
+
 bool MapBase::UpdatePhysicColliders(HiresTimer* timer)
 {
     /// TODO Async
@@ -2792,6 +2809,8 @@ bool MapBase::UpdateCollisionChain(PhysicCollider& collider, unsigned tileindex)
             URHO3D_LOGINFOF("MapBase() - UpdateCollisionChain : mPoint=%s sLastContourId_=%c cs=%u SendEvent MAPTILEREMOVED at %u ...",
                             GetMapGeneratorStatus().mappoint_.ToString().CString(), (char)(65+sLastContourId_-1), collisionChain, tileindex);
 #endif
+            BreakTileContacts(this, collisionChain, tileindex);
+
             VariantMap& eventData = collisionChain->GetContext()->GetEventDataMap();
             eventData[MapTileRemoved::MAPPOINT] = GetMapPoint().ToHash();
             eventData[MapTileRemoved::MAPTILEINDEX] = tileindex;
@@ -3011,6 +3030,8 @@ bool MapBase::UpdateCollisionChain(MapCollider* mapCollider, int x, int y)
             // Send Event (for node hanging on the tile)
             URHO3D_LOGDEBUGF("MapBase() - UpdateCollisionChain : mPoint=%s lastcontourid=%c cs=%u SendEvent MAPTILEREMOVED at %u ...", GetMapPoint().ToString().CString(), (char)(65+lastcontourid-1), collisionChain, tileindex);
 
+            BreakTileContacts(this, collisionChain, tileindex);
+
             VariantMap& eventData = context_->GetEventDataMap();
             eventData[MapTileRemoved::MAPPOINT] = GetMapPoint().ToHash();
             eventData[MapTileRemoved::MAPTILEINDEX] = tileindex;
@@ -3408,6 +3429,7 @@ bool MapBase::UpdatePlateformBoxes(PhysicCollider& collider, unsigned tileindex,
         if (plateform->tileleft_ == tileindex)
         {
             // Send Event before remove collisionbox
+            BreakTileContacts(this, plateform->box_, tileindex);
             VariantMap& eventData = GameContext::Get().context_->GetEventDataMap();
             eventData[MapTileRemoved::MAPPOINT] = GetMapPoint().ToHash();
             eventData[MapTileRemoved::MAPTILEINDEX] = tileindex;
@@ -3478,6 +3500,7 @@ bool MapBase::UpdatePlateformBoxes(PhysicCollider& collider, unsigned tileindex,
 #endif
             }
 
+            BreakTileContacts(this, plateform->box_, tileindex);
             VariantMap& eventData = GameContext::Get().context_->GetEventDataMap();
             eventData[MapTileRemoved::MAPPOINT] = GetMapPoint().ToHash();
             eventData[MapTileRemoved::MAPTILEINDEX] = tileindex;
@@ -4450,6 +4473,45 @@ bool Map::Clear(HiresTimer* timer)
     return true;
 }
 
+void Map::GetBuffers(MapBuffers& buffers) const
+{
+#ifdef USE_TILERENDERING
+    if (objectTiled_)
+        objectTiled_->GetBuffers(buffers);
+#else
+    if (skinnedMap_)
+        skinnedMap_->GetBuffers(buffers);
+#endif
+
+    AddMapBuffer(buffers, los_);
+    AddMapBuffer(buffers, sboxes_);
+    AddMapBuffer(buffers, splateforms_);
+    AddMapBuffer(buffers, schains_);
+
+    AddMapBuffer(buffers, physicColliders_);
+    for (unsigned i=0; i < physicColliders_.Size(); ++i)
+    {
+        const PhysicCollider& collider = physicColliders_[i];
+        AddMapBuffer(buffers, collider.contourIds_);
+        AddMapBuffer(buffers, collider.contourVertices_);
+        for (unsigned j=0; j < collider.contourVertices_.Size(); ++j)
+            AddMapBuffer(buffers, collider.contourVertices_[j]);
+        AddMapBuffer(buffers, collider.infoVertices_);
+        for (unsigned j=0; j < collider.infoVertices_.Size(); ++j)
+            AddMapBuffer(buffers, collider.infoVertices_[j]);
+    }
+
+    AddMapBuffer(buffers, renderColliders_);
+    for (unsigned i=0; i < renderColliders_.Size(); ++i)
+    {
+        const RenderCollider& collider = renderColliders_[i];
+        AddMapBuffer(buffers, collider.contourIds_);
+        AddMapBuffer(buffers, collider.contourVertices_);
+        for (unsigned j=0; j < collider.contourVertices_.Size(); ++j)
+            AddMapBuffer(buffers, collider.contourVertices_[j]);
+    }
+}
+
 void Map::PullFluids()
 {
     if (featuredMap_)
@@ -4513,6 +4575,18 @@ bool Map::Set(Node* node, HiresTimer* timer)
         assert(node);
 
         String nodeName = ToString("Map_%d_%d", GetMapPoint().x_, GetMapPoint().y_);
+#ifdef ACTIVE_MAPPOOL_KEEPBUFFERS
+        // reuse the root node of the previous map (keeps the render shapes)
+        if (pooledNode_)
+        {
+            node->AddChild(pooledNode_);
+            pooledNode_->SetName(nodeName);
+            pooledNode_->SetEnabled(true);
+            node_ = WeakPtr<Node>(pooledNode_.Get());
+            pooledNode_.Reset();
+        }
+        else
+#endif
         node_ = WeakPtr<Node>(node->CreateChild(nodeName, LOCAL));
         nodeRoot_ = node_;
         node_->SetTemporary(true);
@@ -5450,6 +5524,7 @@ bool Map::SetVisibleEntities(bool visible, HiresTimer* timer)
 
                 // Erase the nodeid before using Destroy, else "it" will be illformed and crash after next reading in the list!
                 // In fact, GOC_Destroyer::Destroy send GO_DESTROY event to World2D then World2D remove "it" too.
+                World2D::UnregisterEntity(*it);
                 it = entities.Erase(it);
 
 //                if (node && dynamicObjectFromServer)
@@ -5877,12 +5952,9 @@ Node* Map::AddEntity(const StringHash& got, int entityid, int nodeid, unsigned h
             unsigned mpointhashed = GetMapPoint().ToHash();
             if ((GOT::GetTypeProperties(got) & GOT_Effect) != 0)
             {
-                VariantMap& eventData = context_->GetEventDataMap();
-                eventData[Go_Appear::GO_ID] = node->GetID();
-                eventData[Go_Appear::GO_TYPE] = node->GetVar(GOA::TYPECONTROLLER) != Variant::EMPTY ? node->GetVar(GOA::TYPECONTROLLER).GetInt() : GO_None;
-                eventData[Go_Appear::GO_MAP] = mpointhashed;
-                eventData[Go_Appear::GO_MAINCONTROL] = controller ? controller->IsMainController() : false;
-                node->SendEvent(GO_APPEAR, eventData);
+                GoAppearEvent event = { node->GetID(), node->GetVar(GOA::TYPECONTROLLER) != Variant::EMPTY ? node->GetVar(GOA::TYPECONTROLLER).GetInt() : GO_None,
+                                        controller ? controller->IsMainController() : false, mpointhashed, M_MAX_UNSIGNED };
+                EventChannel<GoAppearEvent>::Get().Send(node, event);
             }
             node->SetVar(GOA::ONMAP, mpointhashed);
         }
@@ -6413,8 +6485,30 @@ bool Map::RemoveNodes(bool removeentities, HiresTimer* timer)
         URHO3D_PROFILE(Map_RemoveSafe);
 #endif
 
+#ifdef ACTIVE_MAPPOOL_KEEPBUFFERS
+        // keep the root node and its render shapes for the next map : the statics and the other children are removed
+        if (node_)
+        {
+            if (nodeStatic_)
+                GameHelpers::RemoveNodeSafe(nodeStatic_);
+
+            // the dynamic "Box" nodes of MapBase::UpdateCollisionBox have bodies : they must not come back with the next map
+            PODVector<Node*> children;
+            node_->GetChildren(children);
+            for (unsigned i=0; i < children.Size(); i++)
+            {
+                if (!children[i]->GetComponent<RenderShape>())
+                    children[i]->Remove();
+            }
+
+            pooledNode_ = node_.Get();
+            pooledNode_->SetEnabled(false);
+            pooledNode_->Remove();
+        }
+#else
         if (node_)
             GameHelpers::RemoveNodeSafe(node_);
+#endif
 
         URHO3D_LOGDEBUGF("Map() - RemoveNodes mPoint=%s ... RemoveNodeSafe OK ... timer=%d/%d msec", GetMapPoint().ToString().CString(), timer ? timer->GetUSec(false) / 1000 : 0, delayUpdateUsec_/1000);
 
@@ -6503,10 +6597,10 @@ void Map::OnTileModified(int x, int y)
     }
 #endif
 
-    // Update chunk maskViews
+    // Update maskViews around the tile (the connections and the dimension tiles only change in the neighborhood)
     /// already made by objectTiled_->MarkChunkGroupDirty->UpdateChunkGroup but need in instant here for updatecollider
     /// TODO : bypass objectTiled_->MarkChunkGroupDirty->UpdateChunkGroup->UpdateMaskViews
-    featuredMap_->UpdateMaskViews(chunkgroup.GetTileGroup(), 0, 0, skinnedMap_->GetSkin() ? skinnedMap_->GetSkin()->neighborMode_ : Connected0);
+    featuredMap_->UpdateMaskViews(IntRect(x-1, y-1, x+1, y+1), skinnedMap_->GetSkin() ? skinnedMap_->GetSkin()->neighborMode_ : Connected0);
 
     SetMiniMapAt(x, y);
 
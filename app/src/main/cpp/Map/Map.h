@@ -559,6 +559,7 @@ public:
 public:
     void Resize();
     bool Clear(HiresTimer* timer=0);
+    void GetBuffers(MapBuffers& buffers) const;
     void PullFluids();
     void Initialize(const ShortIntVector2& mPoint, unsigned wseed);
 private:
@@ -755,6 +756,10 @@ private:
     // Nodes
     WeakPtr<Node> node_;
     WeakPtr<Node> nodeTag_;
+#ifdef ACTIVE_MAPPOOL_KEEPBUFFERS
+    // root node kept detached with its render shapes while the map is in the pool
+    SharedPtr<Node> pooledNode_;
+#endif
     Node* localEntitiesNode_;
     Node* replicatedEntitiesNode_;
     Vector<Node* > nodeImages_;
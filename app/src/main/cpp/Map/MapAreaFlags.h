@@ -0,0 +1,13 @@
+#pragma once
+
+/// The area props of a tile (see MapBase::GetAreaProps).
+enum AreaFlag
+{
+    nomoveFlag         = 0x0000,
+    walkableFlag       = 0x0001,
+    jumpableRightFlag  = 0x0002,
+    jumpableLeftFlag   = 0x0004,
+    jumpableFlag       = jumpableRightFlag | jumpableLeftFlag,
+    flyableFlag        = 0x0008,
+    swimmableFlag      = 0x0010
+};
@@ -0,0 +1,100 @@
+#include "MapContactRegistry.h"
+
+
+MapContactRegistry MapContactRegistry::registry_;
+
+
+void MapContactRegistry::Clear()
+{
+    contacts_.Clear();
+    shapes_.Clear();
+}
+
+void MapContactRegistry::AddContact(CollisionShape2D* shape, GOC_Collide2D* collider)
+{
+    PODVector<Contact>& contacts = contacts_[shape];
+    for (unsigned i = 0; i < contacts.Size(); i++)
+    {
+        if (contacts[i].collider_ == collider)
+        {
+            contacts[i].count_++;
+            return;
+        }
+    }
+
+    Contact contact = { collider, 1 };
+    contacts.Push(contact);
+    shapes_[collider].Push(shape);
+}
+
+void MapContactRegistry::RemoveContact(CollisionShape2D* shape, GOC_Collide2D* collider, bool all)
+{
+    HashMap<CollisionShape2D*, PODVector<Contact> >::Iterator it = contacts_.Find(shape);
+    if (it == contacts_.End())
+        return;
+
+    PODVector<Contact>& contacts = it->second_;
+    for (unsigned i = 0; i < contacts.Size(); i++)
+    {
+        if (contacts[i].collider_ != collider)
+            continue;
+
+        if (!all && contacts[i].count_ > 1)
+        {
+            contacts[i].count_--;
+            return;
+        }
+
+        // the order of the colliders doesn't matter : move the last contact in the hole
+        contacts[i] = contacts.Back();
+        contacts.Pop();
+        if (contacts.Empty())
+            contacts_.Erase(it);
+
+        HashMap<GOC_Collide2D*, PODVector<CollisionShape2D*> >::Iterator jt = shapes_.Find(collider);
+        if (jt != shapes_.End())
+        {
+            jt->second_.Remove(shape);
+            if (jt->second_.Empty())
+                shapes_.Erase(jt);
+        }
+        return;
+    }
+}
+
+void MapContactRegistry::RemoveCollider(GOC_Collide2D* collider)
+{
+    HashMap<GOC_Collide2D*, PODVector<CollisionShape2D*> >::Iterator jt = shapes_.Find(collider);
+    if (jt == shapes_.End())
+        return;
+
+    // copy : RemoveContact erases the entry of the collider with its last shape
+    PODVector<CollisionShape2D*> shapes = jt->second_;
+    for (unsigned i = 0; i < shapes.Size(); i++)
+        RemoveContact(shapes[i], collider, true);
+}
+
+void MapContactRegistry::GetColliders(CollisionShape2D* shape, PODVector<GOC_Collide2D*>& colliders) const
+{
+    HashMap<CollisionShape2D*, PODVector<Contact> >::ConstIterator it = contacts_.Find(shape);
+    if (it == contacts_.End())
+        return;
+
+    const PODVector<Contact>& contacts = it->second_;
+    for (unsigned i = 0; i < contacts.Size(); i++)
+        colliders.Push(contacts[i].collider_);
+}
+
+unsigned MapContactRegistry::GetNumContacts(CollisionShape2D* shape, GOC_Collide2D* collider) const
+{
+    HashMap<CollisionShape2D*, PODVector<Contact> >::ConstIterator it = contacts_.Find(shape);
+    if (it == contacts_.End())
+        return 0;
+
+    const PODVector<Contact>& contacts = it->second_;
+    for (unsigned i = 0; i < contacts.Size(); i++)
+        if (contacts[i].collider_ == collider)
+            return contacts[i].count_;
+
+    return 0;
+}
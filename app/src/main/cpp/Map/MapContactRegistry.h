@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Urho3D/Container/HashMap.h>
+
+namespace Urho3D
+{
+class CollisionShape2D;
+}
+
+using namespace Urho3D;
+
+class GOC_Collide2D;
+
+
+/// MapContactRegistry : the colliders (GOC_Collide2D) in contact with each map shape (collision chain, plateform box).
+/// A removed tile looks up only the colliders of its shape (see GOC_Collide2D::BreakContactsOnTile)
+/// instead of one MAPTILEREMOVED subscription by contact.
+/// The registry never dereferences the shapes and the colliders.
+
+class MapContactRegistry
+{
+public:
+    struct Contact
+    {
+        GOC_Collide2D* collider_;
+        // number of wall contacts of the collider with the shape
+        unsigned count_;
+    };
+
+    static MapContactRegistry& Get()
+    {
+        return registry_;
+    }
+
+    void Clear();
+
+    void AddContact(CollisionShape2D* shape, GOC_Collide2D* collider);
+    /// Remove one wall contact, or all the wall contacts of the collider with the shape
+    void RemoveContact(CollisionShape2D* shape, GOC_Collide2D* collider, bool all=false);
+    /// Remove all the contacts of the collider
+    void RemoveCollider(GOC_Collide2D* collider);
+
+    /// Add the colliders in contact with the shape to colliders
+    void GetColliders(CollisionShape2D* shape, PODVector<GOC_Collide2D*>& colliders) const;
+    unsigned GetNumContacts(CollisionShape2D* shape, GOC_Collide2D* collider) const;
+    unsigned GetNumShapes() const
+    {
+        return contacts_.Size();
+    }
+
+private:
+    HashMap<CollisionShape2D*, PODVector<Contact> > contacts_;
+    HashMap<GOC_Collide2D*, PODVector<CollisionShape2D*> > shapes_;
+
+    static MapContactRegistry registry_;
+};
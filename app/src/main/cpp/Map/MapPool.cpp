@@ -16,7 +16,12 @@ void MapPool::RegisterObject(Context* context)
 }
 
 MapPool::MapPool(Context* context)
-    : Object(context)
+    : Object(context),
+      lastSwapAllocs_(0),
+      lastSwapBytes_(0),
+      numSwaps_(0),
+      totalSwapAllocs_(0),
+      totalSwapBytes_(0)
 {
     URHO3D_LOGDEBUGF("MapPool()");
 }
@@ -62,10 +67,33 @@ bool MapPool::Free(Map* map, HiresTimer* timer)
 
     if (!freemaps_.Contains(map))
     {
+        // the storages not in the map at Get have been allocated for this map swap (checked before Clear which may release them)
+        HashMap<Map*, MapBuffers>::Iterator it = swapBuffers_.Find(map);
+        if (it != swapBuffers_.End())
+        {
+            MapBuffers buffers;
+            map->GetBuffers(buffers);
+
+            lastSwapAllocs_ = lastSwapBytes_ = 0;
+            for (MapBuffers::ConstIterator jt = buffers.Begin(); jt != buffers.End(); ++jt)
+            {
+                if (!it->second_.Contains(jt->first_))
+                {
+                    lastSwapAllocs_++;
+                    lastSwapBytes_ += jt->second_;
+                }
+            }
+
+            totalSwapAllocs_ += lastSwapAllocs_;
+            totalSwapBytes_ += lastSwapBytes_;
+            numSwaps_++;
+            swapBuffers_.Erase(it);
+        }
+
         if (!map->Clear(timer))
             return false;
 
-        URHO3D_LOGINFOF("MapPool() - Free point=%s ... OK !", map->GetMapPoint().ToString().CString());
+        URHO3D_LOGINFOF("MapPool() - Free point=%s ... OK ! swapAllocated=%u allocs %u bytes", map->GetMapPoint().ToString().CString(), lastSwapAllocs_, lastSwapBytes_);
         freemaps_.Push(map);
     }
 
@@ -90,6 +118,10 @@ Map* MapPool::Get()
 
         freemaps_.Pop();
 
+        MapBuffers& buffers = swapBuffers_[map];
+        buffers.Clear();
+        map->GetBuffers(buffers);
+
         return map;
     }
     return 0;
@@ -97,6 +129,7 @@ Map* MapPool::Get()
 
 void MapPool::Dump() const
 {
-    URHO3D_LOGINFOF("MapPool - Dump() : numFreeMaps = %u/%u", freemaps_.Size(), maps_.Size());
+    URHO3D_LOGINFOF("MapPool - Dump() : numFreeMaps = %u/%u numSwaps=%u lastSwapAllocated=%u allocs %u bytes avgSwapAllocated=%.1f allocs %u bytes", freemaps_.Size(), maps_.Size(),
+                    numSwaps_, lastSwapAllocs_, lastSwapBytes_, numSwaps_ ? (float)totalSwapAllocs_ / numSwaps_ : 0.f, numSwaps_ ? (unsigned)(totalSwapBytes_ / numSwaps_) : 0);
 }
 
@@ -58,10 +58,40 @@ public :
         return freemaps_.Size();
     }
 
+    /// allocations of the map buffers during the last map swap (Get to Free) : the storages not in the map at Get
+    unsigned GetLastSwapAllocs() const
+    {
+        return lastSwapAllocs_;
+    }
+    unsigned GetLastSwapBytes() const
+    {
+        return lastSwapBytes_;
+    }
+    unsigned GetNumSwaps() const
+    {
+        return numSwaps_;
+    }
+    unsigned GetTotalSwapAllocs() const
+    {
+        return totalSwapAllocs_;
+    }
+    unsigned long long GetTotalSwapBytes() const
+    {
+        return totalSwapBytes_;
+    }
+
     void Dump() const;
 
 private :
 
     Vector<SharedPtr<Map> > maps_;
     PODVector<Map*> freemaps_;
+
+    // the buffers of the maps when they left the pool
+    HashMap<Map*, MapBuffers> swapBuffers_;
+
+    unsigned lastSwapAllocs_, lastSwapBytes_;
+    unsigned numSwaps_;
+    unsigned totalSwapAllocs_;
+    unsigned long long totalSwapBytes_;
 };
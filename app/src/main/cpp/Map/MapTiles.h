@@ -10,8 +10,6 @@
 using namespace Urho3D;
 
 
-typedef unsigned char ConnectIndex;
-
 //enum TilePropertiesFlag
 //{
 //    ShapeType         = 0x0003,
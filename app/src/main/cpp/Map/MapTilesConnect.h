@@ -4,6 +4,8 @@
 
 extern const unsigned MAPFEATURES_SIZE;
 
+typedef unsigned char ConnectIndex;
+
 enum SideBit
 {
     TopBit = 0,
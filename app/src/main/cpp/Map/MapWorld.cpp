@@ -54,6 +54,7 @@
 #include "TimerRemover.h"
 #include "Actor.h"
 #include "MAN_Go.h"
+#include "EntityRegistry.h"
 
 #include "Map.h"
 #include "ObjectMaped.h"
@@ -64,6 +65,7 @@
 #include "MapGenerator.h"
 #include "MapSimulatorLiquid.h"
 #include "ViewManager.h"
+#include "MAN_Ai.h"
 #include "MAN_Weather.h"
 
 #include "MapWorld.h"
@@ -110,6 +112,7 @@ bool World2D::noBounds_ = true;
 Rect World2D::extVisibleRectCached_;
 Vector<ShortIntVector2> World2D::keepedVisibleMaps_;
 HashMap<ShortIntVector2, MapEntityInfo> World2D::mapEntities_;
+EntityGrid World2D::entityGrid_;
 HashMap<ShortIntVector2, MapFurnitureLocation> World2D::mapFurnitures_;
 WeakPtr<Node> World2D::entitiesRootNodes_[2];
 
@@ -181,6 +184,9 @@ World2D::~World2D()
     URHO3D_LOGDEBUG("~World2D() - ...");
 
 //	  Stop();
+    EventChannel<GoAppearEvent>::Get().Unsubscribe(this);
+    EventChannel<GoChangeMapEvent>::Get().Unsubscribe(this);
+    EventChannel<GoDestroyEvent>::Get().Unsubscribe(this);
 
     if (mapStorage_)
     {
@@ -204,6 +210,8 @@ World2D::~World2D()
 
     keepedVisibleMaps_.Clear();
     mapEntities_.Clear();
+    entityGrid_.Clear();
+    EntityRegistry::Get().Clear();
     mapFurnitures_.Clear();
     entitiesRootNodes_[0].Reset();
     entitiesRootNodes_[1].Reset();
@@ -698,6 +706,8 @@ bool World2D::SetWorld(bool load)
 
     mWidth_ = info_->mWidth_;
     mHeight_ = info_->mHeight_;
+    entityGrid_.SetCellSize(ENTITYGRID_CELLTILES * info_->mTileWidth_);
+    EntityRegistry::Get().Clear();
     mTileWidth_ = info_->mTileWidth_;
     mTileHeight_ = info_->mTileHeight_;
 
@@ -962,12 +972,40 @@ void World2D::AttachEntityToMapNode(Node* entity, const ShortIntVector2& mPoint,
     }
 }
 
+// register the entity and add it in the grid, the grid is keyed by the registry handles
+static void RegisterEntity(EntityGrid& grid, Node* node, const ShortIntVector2& mPoint)
+{
+    if (!node)
+        return;
+
+    EntityRegistry& registry = EntityRegistry::Get();
+    const EntityHandle previous = registry.GetHandle(node->GetID());
+    const StringHash got = node->GetVar(GOA::GOT).GetStringHash();
+    const EntityHandle handle = registry.Register(node, mPoint.ToHash(), got, node->GetVar(GOA::TYPECONTROLLER).GetInt());
+
+    // the id was registered for a removed node
+    if (previous != handle)
+        grid.Remove(previous);
+
+    if (handle != ENTITYHANDLE_NONE)
+        grid.Insert(handle, node->GetWorldPosition2D(), got);
+}
+
+static Rect GetMapRect(const ShortIntVector2& mPoint, float width, float height)
+{
+    return Rect((float)mPoint.x_ * width, (float)mPoint.y_ * height, (float)(mPoint.x_+1) * width, (float)(mPoint.y_+1) * height);
+}
+
 void World2D::AddEntity(const ShortIntVector2& mPoint, unsigned id)
 {
     List<unsigned>& entities = mapEntities_[mPoint].entities_;
     List<unsigned>::ConstIterator it = entities.Find(id);
     if (it == entities.End())
+    {
         entities += id;
+        if (world_)
+            RegisterEntity(entityGrid_, world_->GetScene()->GetNode(id), mPoint);
+    }
 }
 
 void World2D::RemoveEntity(const ShortIntVector2& mPoint, unsigned id)
@@ -980,6 +1018,7 @@ void World2D::RemoveEntity(const ShortIntVector2& mPoint, unsigned id)
     if (it != entities.End())
     {
         entities.Erase(it);
+        UnregisterEntity(id);
 //        world_->DumpNodeList(entities, "map");
     }
 }
@@ -996,18 +1035,14 @@ void World2D::DestroyEntity(const ShortIntVector2& mPoint, Node* node)
 //    map->GetMapData()->RemoveEntityData(node);
 
     // if no destroyer
-    VariantMap& eventData = node->GetContext()->GetEventDataMap();
-    eventData[Go_Destroy::GO_ID] = node->GetID();
-    eventData[Go_Destroy::GO_TYPE] = node->GetVar(GOA::TYPECONTROLLER).GetInt();
-    eventData[Go_Destroy::GO_MAP] = mPoint.ToHash();
-    eventData[Go_Destroy::GO_PTR] = 0;
+    GoDestroyEvent event = { node->GetID(), node->GetVar(GOA::TYPECONTROLLER).GetInt(), mPoint.ToHash(), M_MAX_UNSIGNED, 0 };
 
     // for static furniture
 //    if ((GOT::GetTypeProperties(node->GetVar(GOA::GOT).GetStringHash()) & (GOT_Furniture | GOT_Anchored)) == (GOT_Furniture | GOT_Anchored))
     if (node->GetVar(GOA::ONTILE) != Variant::EMPTY)
-        eventData[Go_Destroy::GO_TILE] = node->GetVar(GOA::ONTILE).GetUInt();
+        event.tile_ = node->GetVar(GOA::ONTILE).GetUInt();
 
-    node->SendEvent(GO_DESTROY, eventData);
+    EventChannel<GoDestroyEvent>::Get().Send(node, event);
 
     URHO3D_LOGINFOF("World2D() - DestroyEntity : %s(%u) ... OK !", node->GetName().CString(), node->GetID());
 
@@ -1170,9 +1205,14 @@ void World2D::PurgeEntities(const ShortIntVector2& mPoint)
     while (it != ids.End())
     {
         if (GOManager::IsA(*it, GO_Player | GO_AI_Ally))
+        {
             it++;
+        }
         else
+        {
+            UnregisterEntity(*it);
             it = ids.Erase(it);
+        }
     }
 }
 
@@ -2104,6 +2144,24 @@ PODVector<unsigned>* World2D::GetLosTable(const ShortIntVector2& mPoint)
     return 0;
 }
 
+static PODVector<unsigned> sEntityIds_;
+
+void World2D::UnregisterEntity(unsigned id)
+{
+    EntityRegistry& registry = EntityRegistry::Get();
+    const EntityHandle handle = registry.GetHandle(id);
+    if (handle == ENTITYHANDLE_NONE)
+        return;
+
+    entityGrid_.Remove(handle);
+    registry.Unregister(handle);
+}
+
+void World2D::UpdateEntityPosition(unsigned id, const Vector2& position)
+{
+    entityGrid_.Move(EntityRegistry::Get().GetHandle(id), position);
+}
+
 void World2D::GetFilteredEntities(const ShortIntVector2& mPoint, PODVector<Node*>& entities, int skipControllerType)
 {
     if (!world_)
@@ -2111,24 +2169,20 @@ void World2D::GetFilteredEntities(const ShortIntVector2& mPoint, PODVector<Node*
 
     entities.Clear();
 
-    List<unsigned>& ids = mapEntities_[mPoint].entities_;
-    if (!ids.Size())
-    {
-        URHO3D_LOGWARNINGF("World2D() - GetEntities : mPoint=%s noentities !", mPoint.ToString().CString());
-        return;
-    }
+    sEntityIds_.Clear();
+    entityGrid_.Query(GetMapRect(mPoint, mWidth_, mHeight_), sEntityIds_);
 
-    Scene* scene = world_->GetScene();
-    Node* node;
+    const EntityRegistry& registry = EntityRegistry::Get();
+    const EntityRecord* record;
 
-    for (List<unsigned>::ConstIterator it=ids.Begin(); it!=ids.End(); ++it)
+    for (PODVector<unsigned>::ConstIterator it=sEntityIds_.Begin(); it!=sEntityIds_.End(); ++it)
     {
-        node = scene->GetNode(*it);
+        record = registry.GetRecord(*it);
 
-        if (!node || GOManager::IsA(*it, skipControllerType))
+        if (!record || !record->node_ || GOManager::IsA(record->id_, skipControllerType))
             continue;
 
-        entities.Push(node);
+        entities.Push(record->node_.Get());
     }
 }
 
@@ -2139,20 +2193,43 @@ void World2D::GetEntities(const ShortIntVector2& mPoint, PODVector<Node*>& entit
 
     entities.Clear();
 
-    List<unsigned>& ids = mapEntities_[mPoint].entities_;
-    if (!ids.Size())
-    {
-        URHO3D_LOGWARNINGF("World2D() - GetEntities : mPoint=%s noentities !", mPoint.ToString().CString());
+    GetEntities(GetMapRect(mPoint, mWidth_, mHeight_), entities, type);
+}
+
+void World2D::GetEntities(const Rect& rect, PODVector<Node*>& entities, const StringHash& type)
+{
+    if (!world_)
         return;
+
+    sEntityIds_.Clear();
+    entityGrid_.Query(rect, sEntityIds_, type);
+
+    const EntityRegistry& registry = EntityRegistry::Get();
+    Node* node;
+
+    for (PODVector<unsigned>::ConstIterator it=sEntityIds_.Begin(); it!=sEntityIds_.End(); ++it)
+    {
+        node = registry.GetNode(*it);
+        if (node)
+            entities.Push(node);
     }
+}
 
-    Scene* scene = world_->GetScene();
+void World2D::GetEntities(const Vector2& center, float radius, PODVector<Node*>& entities, const StringHash& type)
+{
+    if (!world_)
+        return;
+
+    sEntityIds_.Clear();
+    entityGrid_.QueryRadius(center, radius, sEntityIds_, type);
+
+    const EntityRegistry& registry = EntityRegistry::Get();
     Node* node;
 
-    for (List<unsigned>::ConstIterator it=ids.Begin(); it!=ids.End(); ++it)
+    for (PODVector<unsigned>::ConstIterator it=sEntityIds_.Begin(); it!=sEntityIds_.End(); ++it)
     {
-        node = scene->GetNode(*it);
-        if (node && node->GetVar(GOA::GOT).GetUInt() == type.Value())
+        node = registry.GetNode(*it);
+        if (node)
             entities.Push(node);
     }
 }
@@ -2190,43 +2267,32 @@ void World2D::GetVisibleEntities(PODVector<Node*>& entities)
     if (!world_)
         return;
 
-    Scene* scene = world_->GetScene();
+    const EntityRegistry& registry = EntityRegistry::Get();
     Node* node;
-    ShortIntVector2 mpoint;
-    int xmin, xmax, ymin, ymax;
+
+    // the rects of the visible maps of the viewports, the grid returns the entities once
+    static PODVector<Rect> visiblerects;
+    visiblerects.Clear();
 
     unsigned numviewports = Min(ViewManager::Get()->GetNumViewports(), world_->viewinfos_.Size());
     for (unsigned i = 0; i < numviewports; i++)
     {
-        IntRect& visibleMapArea = world_->viewinfos_[i].visibleArea_;
-
-        xmin = visibleMapArea.left_;
-        xmax = visibleMapArea.right_;
-        ymin = visibleMapArea.top_;
-        ymax = visibleMapArea.bottom_;
-
-        for (int x = xmin; x <= xmax; x++)
-        {
-            mpoint.x_ = x;
-            for (int y = ymin; y <= ymax; y++)
-            {
-                mpoint.y_ = y;
+        const IntRect& visibleMapArea = world_->viewinfos_[i].visibleArea_;
+        visiblerects.Push(Rect((float)visibleMapArea.left_ * mWidth_, (float)visibleMapArea.top_ * mHeight_,
+                               (float)(visibleMapArea.right_+1) * mWidth_, (float)(visibleMapArea.bottom_+1) * mHeight_));
+    }
 
-                const List<unsigned>& ids = GetEntities(mpoint);
-                for (List<unsigned>::ConstIterator it=ids.Begin(); it!=ids.End(); ++it)
-                {
-                    node = scene->GetNode(*it);
+    sEntityIds_.Clear();
+    entityGrid_.Query(visiblerects.Buffer(), visiblerects.Size(), sEntityIds_);
 
-                    if (!node || !node->IsEnabled())
-                        continue;
+    for (PODVector<unsigned>::ConstIterator it=sEntityIds_.Begin(); it!=sEntityIds_.End(); ++it)
+    {
+        node = registry.GetNode(*it);
 
-                    if (entities.Contains(node))
-                        continue;
+        if (!node || !node->IsEnabled())
+            continue;
 
-                    entities.Push(node);
-                }
-            }
-        }
+        entities.Push(node);
     }
 }
 
@@ -2331,9 +2397,9 @@ void World2D::Start()
     SubscribeToEvent(WORLD_DIRTY, URHO3D_HANDLER(World2D, HandleChunksDirty));
 
 #if defined(HANDLE_ENTITIES) || defined(HANDLE_FURNITURES)
-    SubscribeToEvent(GO_APPEAR, URHO3D_HANDLER(World2D, HandleObjectAppear));
-    SubscribeToEvent(GO_CHANGEMAP, URHO3D_HANDLER(World2D,HandleObjectChangeMap));
-    SubscribeToEvent(GO_DESTROY, URHO3D_HANDLER(World2D, HandleObjectDestroy));
+    EventChannel<GoAppearEvent>::Get().Subscribe<World2D, &World2D::HandleObjectAppear>(this);
+    EventChannel<GoChangeMapEvent>::Get().Subscribe<World2D, &World2D::HandleObjectChangeMap>(this);
+    EventChannel<GoDestroyEvent>::Get().Subscribe<World2D, &World2D::HandleObjectDestroy>(this);
 #endif
 
     if (GameContext::Get().gameConfig_.fluidEnabled_)
@@ -2344,9 +2410,9 @@ void World2D::Stop()
 {
     UnsubscribeFromEvent(WORLD_DIRTY);
 #if defined(HANDLE_ENTITIES) || defined(HANDLE_FURNITURES)
-    UnsubscribeFromEvent(GO_APPEAR);
-    UnsubscribeFromEvent(GO_CHANGEMAP);
-    UnsubscribeFromEvent(GO_DESTROY);
+    EventChannel<GoAppearEvent>::Get().Unsubscribe(this);
+    EventChannel<GoChangeMapEvent>::Get().Unsubscribe(this);
+    EventChannel<GoDestroyEvent>::Get().Unsubscribe(this);
 #endif
 
 #ifdef HANDLE_BACKGROUND_LAYERS
@@ -2457,15 +2523,15 @@ void World2D::HandleChunksDirty(StringHash eventType, VariantMap& eventData)
 }
 
 
-void World2D::HandleObjectAppear(StringHash eventType, VariantMap& eventData)
+void World2D::HandleObjectAppear(Object* sender, const GoAppearEvent& event)
 {
 #if defined(HANDLE_ENTITIES) || defined(HANDLE_FURNITURES)
-    unsigned nodeId = eventData[Go_Appear::GO_ID].GetUInt();
+    unsigned nodeId = event.id_;
     Node* node = GetScene()->GetNode(nodeId);
     if (!node)
         return;
 
-    ShortIntVector2 mpoint(eventData[Go_Appear::GO_MAP].GetUInt());
+    ShortIntVector2 mpoint(event.mpoint_);
 
     /// entities (furnitures is an entity too)
     {
@@ -2476,9 +2542,10 @@ void World2D::HandleObjectAppear(StringHash eventType, VariantMap& eventData)
         if (!entities.Contains(nodeId))
         {
             entities.Push(nodeId);
+            RegisterEntity(entityGrid_, node, mpoint);
 
             URHO3D_LOGINFOF("World2D() - HandleObjectAppear : GO APPEAR node=%s(%u) type=%d mpoint=%s viewZ=%d entitiesInMap=%u",
-                            node->GetName().CString(), nodeId, eventData[Go_Appear::GO_TYPE].GetInt(), mpoint.ToString().CString(),
+                            node->GetName().CString(), nodeId, event.type_, mpoint.ToString().CString(),
                             node->GetVar(GOA::ONVIEWZ).GetInt(), entities.Size());
 
 //            DumpNodeList(entities, "list after adding entity :");
@@ -2499,13 +2566,13 @@ void World2D::HandleObjectAppear(StringHash eventType, VariantMap& eventData)
 #endif
 }
 
-void World2D::HandleObjectChangeMap(StringHash eventType, VariantMap& eventData)
+void World2D::HandleObjectChangeMap(Object* sender, const GoChangeMapEvent& event)
 {
 #if defined(HANDLE_ENTITIES) || defined(HANDLE_FURNITURES)
-    unsigned nodeId = eventData[Go_ChangeMap::GO_ID].GetUInt();
-    int goType = eventData[Go_ChangeMap::GO_TYPE].GetInt();
-    ShortIntVector2 mapFrom(eventData[Go_ChangeMap::GO_MAPFROM].GetUInt());
-    ShortIntVector2 mapTo(eventData[Go_ChangeMap::GO_MAPTO].GetUInt());
+    unsigned nodeId = event.id_;
+    int goType = event.type_;
+    ShortIntVector2 mapFrom(event.mapFrom_);
+    ShortIntVector2 mapTo(event.mapTo_);
 
     Node* node = GetScene()->GetNode(nodeId);
     if (!node)
@@ -2525,10 +2592,16 @@ void World2D::HandleObjectChangeMap(StringHash eventType, VariantMap& eventData)
             if (node->GetVar(GOA::ISDEAD).GetBool())
             {
                 URHO3D_LOGERRORF("World2D() - HandleObjectChangeMap : nodeId=%u => is Dead remove from map=%s!", nodeId, mapFrom.ToString().CString());
+                UnregisterEntity(nodeId);
                 return;
             }
 
             GetEntities(mapTo).Push(nodeId);
+
+            EntityRegistry& registry = EntityRegistry::Get();
+            const EntityHandle handle = registry.GetHandle(nodeId);
+            registry.SetMapPoint(handle, mapTo.ToHash());
+            entityGrid_.Move(handle, node->GetWorldPosition2D());
         }
     }
 
@@ -2567,13 +2640,13 @@ void World2D::HandleObjectChangeMap(StringHash eventType, VariantMap& eventData)
 #endif
 }
 
-void World2D::HandleObjectDestroy(StringHash eventType, VariantMap& eventData)
+void World2D::HandleObjectDestroy(Object* sender, const GoDestroyEvent& event)
 {
 #if defined(HANDLE_ENTITIES) || defined(HANDLE_FURNITURES)
 
-    Node* node = (Node*) eventData[Go_Destroy::GO_PTR].GetPtr();
-    unsigned nodeId = !node ? eventData[Go_Destroy::GO_ID].GetUInt() : node->GetID();
-    ShortIntVector2 mpoint(!node ? eventData[Go_Destroy::GO_MAP].GetUInt() : node->GetVar(GOA::ONMAP).GetUInt());
+    Node* node = event.node_;
+    unsigned nodeId = !node ? event.id_ : node->GetID();
+    ShortIntVector2 mpoint(!node ? event.mpoint_ : node->GetVar(GOA::ONMAP).GetUInt());
 
     /// entities (furnitures is an entity too)
     List<unsigned>& entities = GetEntities(mpoint);
@@ -2586,12 +2659,13 @@ void World2D::HandleObjectDestroy(StringHash eventType, VariantMap& eventData)
             return;
         }
         it = entities.Erase(it);
+        UnregisterEntity(nodeId);
     }
 
     /// static furnitures (just for static)
-    if (eventData[Go_Destroy::GO_TILE] != Variant::EMPTY)
+    if (event.tile_ != M_MAX_UNSIGNED)
     {
-        List<MapFurnitureRef >& furnitures = mapFurnitures_[mpoint][eventData[Go_Destroy::GO_TILE].GetUInt()];
+        List<MapFurnitureRef >& furnitures = mapFurnitures_[mpoint][event.tile_];
         List<MapFurnitureRef>::Iterator it;
         bool furnitureExists = false;
         for (it=furnitures.Begin(); it != furnitures.End(); ++it)
@@ -3781,6 +3855,12 @@ void World2D::DrawDebugGeometry(DebugRenderer* debug, bool activeTagText)
             MapPool* mappool = mapStorage_->GetPool();
             String text;
             text.AppendWithFormat("Free Game Objects : \n Maps(%u/%u)\n%s\n\n", mappool->GetFreeSize(), mappool->GetSize(), ObjectPool::GetDebugData().CString());
+#ifdef FLUID_SIMULATION_SOA
+            text.AppendWithFormat("Fluid Blocks : \n Active(%d/%d)\n\n", MapSimulatorLiquid::GetNumActiveBlocks(), MapSimulatorLiquid::GetNumBlocks());
+#endif
+            unsigned ailods[AILOD_NumTiers];
+            AIManager::GetLodCounts(ailods);
+            text.AppendWithFormat("AI Lod : \n Near(%u) Mid(%u) Far(%u)\n\n", ailods[AILOD_Near], ailods[AILOD_Mid], ailods[AILOD_Far]);
             world2DDebugPoolText_->SetText(text);
         }
 #endif
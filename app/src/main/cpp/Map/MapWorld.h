@@ -18,6 +18,8 @@ class Connection;
 #include "DefsNetwork.h"
 #include "DefsWorld.h"
 
+#include "EntityGrid.h"
+
 class Map;
 class MapStorage;
 class MapSimulatorLiquid;
@@ -25,6 +27,9 @@ class ViewManager;
 class Actor;
 struct ActorInfo;
 struct ClientInfo;
+struct GoAppearEvent;
+struct GoChangeMapEvent;
+struct GoDestroyEvent;
 
 using namespace Urho3D;
 
@@ -247,6 +252,9 @@ public:
     static List<unsigned>& GetEntities(const ShortIntVector2& mPoint) { return mapEntities_[mPoint].entities_; }
     static MapEntityInfo& GetEntitiesInfo(const ShortIntVector2& mPoint) { return mapEntities_[mPoint]; }
     static void GetVisibleEntities(PODVector<Node*>& entities); // TODO : viewport
+    static void GetEntities(const Rect& rect, PODVector<Node*>& entities, const StringHash& type=StringHash::ZERO);
+    static void GetEntities(const Vector2& center, float radius, PODVector<Node*>& entities, const StringHash& type=StringHash::ZERO);
+    static EntityGrid& GetEntityGrid() { return entityGrid_; }
     static PODVector<Node*> FindEntitiesAt(const String& entityName, const ShortIntVector2& mPoint, int viewZ);
     static List<MapFurnitureRef> FindFurnituresAt(const ShortIntVector2& mPoint, unsigned tileindex);
 
@@ -280,6 +288,10 @@ public:
     static void AttachEntityToMapNode(Node* entity, const ShortIntVector2& mPoint, CreateMode mode=LOCAL);
     static void AddEntity(const ShortIntVector2& mPoint, unsigned id);
     static void RemoveEntity(const ShortIntVector2& mPoint, unsigned id);
+    /// Remove the entity from the entity registry and from the entity grid, the map lists are unchanged
+    static void UnregisterEntity(unsigned id);
+    /// The entity has changed of tile : update the entity grid
+    static void UpdateEntityPosition(unsigned id, const Vector2& position);
     static void DestroyEntity(const ShortIntVector2& mPoint, Node* node); 
     static void PurgeEntityData(const ShortIntVector2& mPoint, Node* node);
     static void PurgeEntityData(Map* map, Node* node);    
@@ -354,9 +366,9 @@ private:
     virtual void OnNodeSet(Node* node);
 private:
     void HandleChunksDirty(StringHash eventType, VariantMap& eventData);
-    void HandleObjectAppear(StringHash eventType, VariantMap& eventData);
-    void HandleObjectChangeMap(StringHash eventType, VariantMap& eventData);
-    void HandleObjectDestroy(StringHash eventType, VariantMap& eventData);
+    void HandleObjectAppear(Object* sender, const GoAppearEvent& event);
+    void HandleObjectChangeMap(Object* sender, const GoChangeMapEvent& event);
+    void HandleObjectDestroy(Object* sender, const GoDestroyEvent& event);
 
 /// Debug & Dump
 public:
@@ -420,6 +432,8 @@ private :
     static WeakPtr<Node> entitiesRootNodes_[2];
     static Vector<ShortIntVector2> keepedVisibleMaps_;
     static HashMap<ShortIntVector2, MapEntityInfo > mapEntities_;
+    // the entities of mapEntities_ by position
+    static EntityGrid entityGrid_;
     static HashMap<ShortIntVector2, MapFurnitureLocation> mapFurnitures_;
 
     static World2D* world_;
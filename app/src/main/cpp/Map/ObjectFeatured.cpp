@@ -42,6 +42,8 @@ const char* FeatureFilterStr[] =
 
 Vector<int> ObjectFeatured::viewZs_;
 static Vector<unsigned> workMap_;
+static PODVector<FeatureFilterPass> filterPasses_;
+static TileGroup dirtyTiles_;
 
 void ObjectFeatured::SetViewZs(const Vector<int>& viewZs)
 {
@@ -102,6 +104,13 @@ void ObjectFeatured::PullFluids()
     }
 }
 
+void ObjectFeatured::WakeFluidCells(unsigned addr)
+{
+    // Wake the fluid simulation around the cell in all the fluid views (the views are linked by depth)
+    for (unsigned i=0; i < fluidView_.Size(); ++i)
+        fluidView_[i].WakeCell(addr);
+}
+
 void ObjectFeatured::Resize(unsigned width, unsigned height, unsigned numviews)
 {
     // resize maskViews table
@@ -191,6 +200,31 @@ void ObjectFeatured::Resize(unsigned width, unsigned height, unsigned numviews)
     }
 }
 
+void ObjectFeatured::GetBuffers(MapBuffers& buffers) const
+{
+    AddMapBuffer(buffers, terrainMap_);
+    AddMapBuffer(buffers, biomeMap_);
+
+    AddMapBuffer(buffers, featuredView_);
+    for (unsigned i=0; i < featuredView_.Size(); ++i)
+        AddMapBuffer(buffers, featuredView_[i]);
+
+    AddMapBuffer(buffers, maskedView_);
+    for (unsigned i=0; i < maskedView_.Size(); ++i)
+    {
+        AddMapBuffer(buffers, maskedView_[i]);
+        for (unsigned j=0; j < maskedView_[i].Size(); ++j)
+            AddMapBuffer(buffers, maskedView_[i][j]);
+    }
+
+    AddMapBuffer(buffers, fluidView_);
+    for (unsigned i=0; i < fluidView_.Size(); ++i)
+    {
+        AddMapBuffer(buffers, fluidView_[i].fluidmap_);
+        AddMapBuffer(buffers, fluidView_[i].sources_);
+    }
+}
+
 void ObjectFeatured::Copy(int left, int top, ObjectFeatured& object)
 {
     // copy the views defs and filters
@@ -679,6 +713,38 @@ void ObjectFeatured::ApplyFeatureFilter(unsigned id)
 #endif
 }
 
+// Fuse the following per-tile filters from id in one pass and return the index of the next filter to apply
+unsigned ObjectFeatured::ApplyFusedFeatureFilters(unsigned id)
+{
+    filterPasses_.Clear();
+
+    for (; id < featurefilters_.Size(); id++)
+    {
+        const FeatureFilterInfo& info = featurefilters_[id];
+
+        // only used with the tile modifiers
+        if (info.filter_ == COPYTILEMODIFIER)
+            continue;
+
+        if (!IsPointwiseFeatureFilter(info.filter_))
+            break;
+
+        FeatureFilterPass pass;
+        pass.filter_ = info.filter_;
+        pass.feature1_ = info.feature1_;
+        pass.feature2_ = info.feature2_;
+        pass.featureBack_ = info.featureBack_;
+        pass.view1_ = &GetFeatureView(info.viewId1_)[0];
+        pass.view2_ = info.filter_ != REPLACEFEATURE ? &GetFeatureView(info.viewId2_)[0] : 0;
+        filterPasses_.Push(pass);
+    }
+
+    if (filterPasses_.Size())
+        ApplyFeatureFilterPasses(&filterPasses_[0], filterPasses_.Size(), width_*height_);
+
+    return id;
+}
+
 bool ObjectFeatured::ApplyFeatureFilters(unsigned addr)
 {
     bool change = false;
@@ -1002,9 +1068,16 @@ bool ObjectFeatured::ApplyFeatureFilters(HiresTimer* timer, const long long& del
             return true;
         }
 
-        ApplyFeatureFilter(indexToSet_);
-
-        indexToSet_++;
+        int filter = featurefilters_[indexToSet_].filter_;
+        if (filter == COPYTILEMODIFIER || IsPointwiseFeatureFilter(filter))
+        {
+            indexToSet_ = ApplyFusedFeatureFilters(indexToSet_);
+        }
+        else
+        {
+            ApplyFeatureFilter(indexToSet_);
+            indexToSet_++;
+        }
 
 //        URHO3D_LOGDEBUGF("ObjectFeatured() - ApplyFeatureFilters ... filter=%u/%u ... timer=%d msec",
 //                        indexToSet_, featurefilters_.Size(), timer ? timer->GetUSec(false) / 1000 : 0);
@@ -1279,6 +1352,23 @@ bool ObjectFeatured::UpdateMaskViews(const TileGroup& tileGroup, HiresTimer* tim
     return true;
 }
 
+// Instant update of the maskviews for the tiles in rect (clamped to the map)
+bool ObjectFeatured::UpdateMaskViews(const IntRect& rect, NeighborMode nghmode)
+{
+    dirtyTiles_.Clear();
+
+    const int xmin = Max(rect.left_, 0);
+    const int ymin = Max(rect.top_, 0);
+    const int xmax = Min(rect.right_, (int)width_-1);
+    const int ymax = Min(rect.bottom_, (int)height_-1);
+
+    for (int y = ymin; y <= ymax; y++)
+        for (int x = xmin; x <= xmax; x++)
+            dirtyTiles_.Push(GetTileIndex(x, y));
+
+    return UpdateMaskViews(dirtyTiles_, 0, 0, nghmode);
+}
+
 bool ObjectFeatured::UpdateMaskViews(HiresTimer* timer, const long long& delay, NeighborMode nghmode)
 {
 //    URHO3D_LOGDEBUGF("ObjectFeatured() - UpdateMaskViews : ... startTimer=%d", timer ? timer->GetUSec(false)/1000 : 0);
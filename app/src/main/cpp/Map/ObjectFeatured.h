@@ -7,13 +7,8 @@
 #include "DefsChunks.h"
 #include "DefsFluids.h"
 
+#include "FeatureFilterPipeline.h"
 
-const int REPLACEFEATURE        = 1;
-const int REPLACEFEATUREBACK    = 2;
-const int REPLACEFRONTIER       = 3;
-const int COPYTILEMODIFIER      = 4;
-const int TRANSFERFRONTIER      = 5;
-const int REPLACEFEATUREBACK2   = 6;
 
 #define ConnectedMapID  0
 #define FeaturedMapID   1
@@ -34,7 +29,9 @@ struct ObjectFeatured : public RefCounted
 
     void Clear();
     void PullFluids();
+    void WakeFluidCells(unsigned addr);
     void Resize(unsigned width, unsigned height, unsigned numviews=0);
+    void GetBuffers(MapBuffers& buffers) const;
     void Copy(int left, int top, ObjectFeatured& object);
 
     /// Setters
@@ -55,6 +52,7 @@ struct ObjectFeatured : public RefCounted
 
     /// Apply Feature Filters
     void ApplyFeatureFilter(unsigned id);
+    unsigned ApplyFusedFeatureFilters(unsigned id);
     void ApplyFeatureFilter(const List<TileModifier >& modifiers, unsigned id);
     bool ApplyFeatureFilters(unsigned tileindex);
     bool ApplyFeatureFilters(const List<TileModifier >& modifiers, HiresTimer* timer=0, const long long& delay=0);
@@ -66,6 +64,7 @@ struct ObjectFeatured : public RefCounted
     bool IsTotallyMasked(const FeaturedMap& mask, unsigned char dimension, unsigned addr) const;
     bool UpdateMaskViews(const TileGroup& tileGroup, HiresTimer* timer, const long long& delay, NeighborMode nghmode);
     bool UpdateMaskViews(HiresTimer* timer, const long long& delay, NeighborMode nghmode);
+    bool UpdateMaskViews(const IntRect& rect, NeighborMode nghmode);
 
     /// Getters
     unsigned GetNumViews() const;
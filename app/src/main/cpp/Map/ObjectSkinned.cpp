@@ -71,6 +71,9 @@ void ObjectSkinned::Init()
     indexToSet_ = indexVToSet_ = 0;
     numviews_ = 0;
     map_ = 0;
+    connectPlane_.Clear();
+    setOrderWidth_ = setOrderHeight_ = 0;
+    setViewsUsec_ = 0;
 }
 
 void ObjectSkinned::Clear()
@@ -109,6 +112,20 @@ void ObjectSkinned::Resize(unsigned width, unsigned height, unsigned numviews)//
         tiledViews_[i].Resize(size);
 }
 
+void ObjectSkinned::GetBuffers(MapBuffers& buffers) const
+{
+    if (feature_)
+        feature_->GetBuffers(buffers);
+
+    AddMapBuffer(buffers, connectedViews_);
+    for (unsigned i=0; i < connectedViews_.Size(); ++i)
+        AddMapBuffer(buffers, connectedViews_[i]);
+
+    AddMapBuffer(buffers, tiledViews_);
+    for (unsigned i=0; i < tiledViews_.Size(); ++i)
+        AddMapBuffer(buffers, tiledViews_[i]);
+}
+
 // StandAlone Use : Not used in MapWorld
 void ObjectSkinned::Set(ObjectFeatured* feature, TerrainAtlas* atlas, MapTerrain* terrain, MapSkin* skin)
 {
@@ -220,225 +237,133 @@ const Vector<TiledMap>& ObjectSkinned::GetTiledViews() const
 
 
 ///
-/// Get Gid for 4-Neighbors Mode
+/// Table-driven Connectivity for Connected4 and Connected8 Modes
 ///
 
-inline int ObjectSkinned::GetGid42FromSkin(const SkinData& sdata, const FeatureType* fdata, unsigned addr, ConnectIndex& index, const short int& nghb1, const short int& nghb2) const
-{
-    if (fdata[addr] < MapFeatureType::NoRender)
-    {
-        index = MapTilesConnectType::Void;
-        return 0;
-    }
-
-    SkinData::ConstIterator it = sdata.Find(fdata[addr]);
-    if (it == sdata.End())
-    {
-        index = MapTilesConnectType::Void;
-        return 0;
-    }
-
-    index = Tile::GetConnectIndexNghb2(feature_->nghTable4_, fdata, addr, nghb1, nghb2);
-
-    return it->second_ ? it->second_->GetRandomTileGidForConnectIndex(index) : 0;
-}
-
-inline int ObjectSkinned::GetGid43FromSkin(const SkinData& sdata, const FeatureType* fdata, unsigned addr, ConnectIndex& index, const short int& nghb1, const short int& nghb2, const short int& nghb3) const
-{
-    if (fdata[addr] < MapFeatureType::NoRender)
-    {
-        index = MapTilesConnectType::Void;
-        return 0;
-    }
-    SkinData::ConstIterator it = sdata.Find(fdata[addr]);
-    if (it == sdata.End())
-    {
-        index = MapTilesConnectType::Void;
-        return 0;
-    }
-
-    index = Tile::GetConnectIndexNghb3(feature_->nghTable4_, fdata, addr, nghb1, nghb2, nghb3);
-
-    return it->second_ ? it->second_->GetRandomTileGidForConnectIndex(index) : 0;
-}
-
-inline int ObjectSkinned::GetGid44FromSkin(const SkinData& sdata, const FeatureType* fdata, unsigned addr, ConnectIndex& index) const
+// Keep the order of the old per-tile setters (inner, borders left & right, borders top & bottom, corners) : the random gids stay the same
+void ObjectSkinned::UpdateSetOrder()
 {
-    if (fdata[addr] < MapFeatureType::NoRender)
-    {
-        index = MapTilesConnectType::Void;
-        return 0;
-    }
-
-    SkinData::ConstIterator it = sdata.Find(fdata[addr]);
-    if (it == sdata.End())
-    {
-        index = MapTilesConnectType::Void;
-        return 0;
-    }
-
-    index = Tile::GetConnectIndexNghb4(feature_->nghTable4_, fdata, addr);
-
-    return it->second_ ? it->second_->GetRandomTileGidForConnectIndex(index) : 0;
-}
+    const unsigned width = GetWidth();
+    const unsigned height = GetHeight();
 
-inline int ObjectSkinned::GetGid42FromTerrain(const FeatureType* fdata, unsigned addr, ConnectIndex& index, const short int& nghb1, const short int& nghb2) const
-{
-    if (fdata[addr] < MapFeatureType::NoRender)
-    {
-        index = MapTilesConnectType::Void;
-        return 0;
-    }
+    if (setOrderWidth_ == width && setOrderHeight_ == height)
+        return;
 
-    index = Tile::GetConnectIndexNghb2(feature_->nghTable4_, fdata, addr, nghb1, nghb2);
+    setOrderWidth_ = width;
+    setOrderHeight_ = height;
+    setOrder_.Clear();
+    setOrder_.Reserve(width * height);
 
-    return atlas_->GetBiomeTerrain(feature_->GetTerrainValue(addr)).GetRandomTileGidForConnectIndex(index);
-}
+    for (unsigned y=1; y < height-1; y++)
+        for (unsigned x=1; x < width-1; x++)
+            setOrder_.Push(width*y + x);
 
-inline int ObjectSkinned::GetGid43FromTerrain(const FeatureType* fdata, unsigned addr, ConnectIndex& index, const short int& nghb1, const short int& nghb2, const short int& nghb3) const
-{
-    if (fdata[addr] < MapFeatureType::NoRender)
+    for (unsigned y=1; y < height-1; y++)
     {
-        index = MapTilesConnectType::Void;
-        return 0;
+        setOrder_.Push(width*y);
+        setOrder_.Push(width*y + width-1);
     }
 
-    index = Tile::GetConnectIndexNghb3(feature_->nghTable4_, fdata, addr, nghb1, nghb2, nghb3);
+    const unsigned lastRowAddr = (height-1) * width;
+    const unsigned lastColAddr = width - 1;
 
-    return atlas_->GetBiomeTerrain(feature_->GetTerrainValue(addr)).GetRandomTileGidForConnectIndex(index);
-}
-
-inline int ObjectSkinned::GetGid44FromTerrain(const FeatureType* fdata, unsigned addr, ConnectIndex& index) const
-{
-    if (fdata[addr] < MapFeatureType::NoRender)
+    for (unsigned x=1; x < width-1; x++)
     {
-        index = MapTilesConnectType::Void;
-        return 0;
+        setOrder_.Push(x);
+        setOrder_.Push(lastRowAddr + x);
     }
 
-    index = Tile::GetConnectIndexNghb4(feature_->nghTable4_, fdata, addr);
-    return atlas_->GetBiomeTerrain(feature_->GetTerrainValue(addr)).GetRandomTileGidForConnectIndex(index);
+    setOrder_.Push(0);
+    setOrder_.Push(lastColAddr);
+    setOrder_.Push(lastRowAddr);
+    setOrder_.Push(lastRowAddr + lastColAddr);
 }
 
-///
-/// Get Gid for 8-Neighbors Mode
-///
-
-inline int ObjectSkinned::GetGid82FromSkin(const SkinData& sdata, const FeatureType* fdata, unsigned addr, ConnectIndex& index, const short int& nghb1, const short int& nghb2) const
+void ObjectSkinned::SetTileGids(const FeatureType* fdata, ConnectedMap& connections, TiledMap& tiles, const unsigned* addrs, unsigned numaddrs)
 {
-    if (fdata[addr] < MapFeatureType::NoRender)
-    {
-        index = MapTilesConnectType::Void;
-        return 0;
-    }
-
-    SkinData::ConstIterator it = sdata.Find(fdata[addr]);
-    if (it == sdata.End())
+    if (skin_)
     {
-        index = MapTilesConnectType::Void;
-        return 0;
-    }
-
-    index = Tile::GetConnectIndexNghb2(feature_->nghTable4_, fdata, addr, nghb1, nghb2);
+        // skin lookup by feature
+        const MapTerrain* skinTerrains[256];
+        bool skinFound[256];
+        memset(skinFound, 0, sizeof(skinFound));
+        const SkinData& sdata = skin_->skinData_;
+        for (SkinData::ConstIterator it = sdata.Begin(); it != sdata.End(); ++it)
+        {
+            skinTerrains[it->first_] = it->second_;
+            skinFound[it->first_] = true;
+        }
 
-    if (index > 2)
-        Tile::GetCornerIndex(feature_->nghCorner_, fdata, addr, index);
+        for (unsigned i = 0; i < numaddrs; i++)
+        {
+            const unsigned addr = addrs[i];
+            ConnectIndex& index = connections[addr];
+            int gid = 0;
 
-    return it->second_ ? it->second_->GetRandomTileGidForConnectIndex(index) : 0;
-}
+            if (index != MapTilesConnectType::Void)
+            {
+                if (!skinFound[fdata[addr]])
+                    index = MapTilesConnectType::Void;
+                else if (skinTerrains[fdata[addr]])
+                    gid = skinTerrains[fdata[addr]]->GetRandomTileGidForConnectIndex(index);
+            }
 
-inline int ObjectSkinned::GetGid83FromSkin(const SkinData& sdata, const FeatureType* fdata, unsigned addr, ConnectIndex& index, const short int& nghb1, const short int& nghb2, const short int& nghb3) const
-{
-    if (fdata[addr] < MapFeatureType::NoRender)
-    {
-        index = MapTilesConnectType::Void;
-        return 0;
+            tiles[addr] = atlas_->GetTile(gid);
+        }
     }
-
-    SkinData::ConstIterator it = sdata.Find(fdata[addr]);
-    if (it == sdata.End())
+    else
     {
-        index = MapTilesConnectType::Void;
-        return 0;
+        for (unsigned i = 0; i < numaddrs; i++)
+        {
+            const unsigned addr = addrs[i];
+            const ConnectIndex index = connections[addr];
+            tiles[addr] = atlas_->GetTile(index != MapTilesConnectType::Void ? atlas_->GetBiomeTerrain(feature_->GetTerrainValue(addr)).GetRandomTileGidForConnectIndex(index) : 0);
+        }
     }
-
-    index = Tile::GetConnectIndexNghb3(feature_->nghTable4_, fdata, addr, nghb1, nghb2, nghb3);
-
-    if (index > 2)
-        Tile::GetCornerIndex(feature_->nghCorner_, fdata, addr, index);
-
-    return it->second_ ? it->second_->GetRandomTileGidForConnectIndex(index) : 0;
 }
 
-inline int ObjectSkinned::GetGid84FromSkin(const SkinData& sdata, const FeatureType* fdata, unsigned addr, ConnectIndex& index) const
+void ObjectSkinned::SetConnectedView(unsigned viewid, bool corners)
 {
-    if (fdata[addr] < MapFeatureType::NoRender)
-    {
-        index = MapTilesConnectType::Void;
-        return 0;
-    }
-
-    SkinData::ConstIterator it = sdata.Find(fdata[addr]);
-    if (it == sdata.End())
-    {
-        index = MapTilesConnectType::Void;
-        return 0;
-    }
-
-    index = Tile::GetConnectIndexNghb4(feature_->nghTable4_, fdata, addr);
+    const FeatureType* fdata = &(feature_->GetFeatureView(viewid)[0]);
+    ConnectedMap& connectedView = GetConnectedView(viewid);
+    TiledMap& tiledView = GetTiledView(viewid);
 
-    if (index > 2)
-        Tile::GetCornerIndex(feature_->nghCorner_, fdata, addr, index);
+    connectPlane_.Update(fdata, GetWidth(), GetHeight(), 0, GetHeight()-1);
+    UpdateSetOrder();
 
-    return it->second_ ? it->second_->GetRandomTileGidForConnectIndex(index) : 0;
+    connectPlane_.SetConnectIndexes(fdata, &connectedView[0], IntRect(0, 0, GetWidth()-1, GetHeight()-1), corners);
+    SetTileGids(fdata, connectedView, tiledView, &setOrder_[0], setOrder_.Size());
 }
 
-inline int ObjectSkinned::GetGid82FromTerrain(const FeatureType* fdata, unsigned addr, ConnectIndex& index, const short int& nghb1, const short int& nghb2) const
+// Update the tile at (x,y) and its neighborhood after an edit
+void ObjectSkinned::SetConnectedTiles(unsigned viewid, int x, int y, bool corners)
 {
-    if (fdata[addr] < MapFeatureType::NoRender)
-    {
-        index = MapTilesConnectType::Void;
-        return 0;
-    }
-
-    index = Tile::GetConnectIndexNghb2(feature_->nghTable4_, fdata, addr, nghb1, nghb2);
+    const int width = GetWidth();
+    const int height = GetHeight();
+    const FeatureType* fdata = &(feature_->GetFeatureView(viewid)[0]);
+    ConnectedMap& connectedView = GetConnectedView(viewid);
+    TiledMap& tiledView = GetTiledView(viewid);
 
-    if (index > 2)
-        Tile::GetCornerIndex(feature_->nghCorner_, fdata, addr, index);
+    connectPlane_.Update(fdata, width, height, Max(y-2, 0), Min(y+2, height-1));
 
-    return atlas_->GetBiomeTerrain(feature_->GetTerrainValue(addr)).GetRandomTileGidForConnectIndex(index);
-}
+    // the center and the sides, the corners only change in Connected8
+    const int numcells = corners ? 9 : 5;
+    const int cells[9][2] = { {0, 0}, {-1, 0}, {0, -1}, {1, 0}, {0, 1}, {-1, -1}, {1, -1}, {-1, 1}, {1, 1} };
+    unsigned addrs[9];
+    unsigned numaddrs = 0;
 
-inline int ObjectSkinned::GetGid83FromTerrain(const FeatureType* fdata, unsigned addr, ConnectIndex& index, const short int& nghb1, const short int& nghb2, const short int& nghb3) const
-{
-    if (fdata[addr] < MapFeatureType::NoRender)
+    for (int i = 0; i < numcells; i++)
     {
-        index = MapTilesConnectType::Void;
-        return 0;
-    }
-
-    index = Tile::GetConnectIndexNghb3(feature_->nghTable4_, fdata, addr, nghb1, nghb2, nghb3);
-
-    if (index > 2)
-        Tile::GetCornerIndex(feature_->nghCorner_, fdata, addr, index);
-
-    return atlas_->GetBiomeTerrain(feature_->GetTerrainValue(addr)).GetRandomTileGidForConnectIndex(index);
-}
+        const int xi = x + cells[i][0];
+        const int yi = y + cells[i][1];
+        if (xi < 0 || yi < 0 || xi >= width || yi >= height)
+            continue;
 
-inline int ObjectSkinned::GetGid84FromTerrain(const FeatureType* fdata, unsigned addr, ConnectIndex& index) const
-{
-    if (fdata[addr] < MapFeatureType::NoRender)
-    {
-        index = MapTilesConnectType::Void;
-        return 0;
+        connectPlane_.SetConnectIndexes(fdata, &connectedView[0], IntRect(xi, yi, xi, yi), corners);
+        addrs[numaddrs++] = yi*width + xi;
     }
 
-    index = Tile::GetConnectIndexNghb4(feature_->nghTable4_, fdata, addr);
-
-    if (index > 2)
-        Tile::GetCornerIndex(feature_->nghCorner_, fdata, addr, index);
-
-    return atlas_->GetBiomeTerrain(feature_->GetTerrainValue(addr)).GetRandomTileGidForConnectIndex(index);
+    SetTileGids(fdata, connectedView, tiledView, addrs, numaddrs);
 }
 
 ///
@@ -542,95 +467,14 @@ void ObjectSkinned::SetViewFromSkin(unsigned viewid)
     const unsigned height = GetHeight();
 
     unsigned addr = 0;
-    SkinData& sdata = skin_->skinData_;
 
     GameRand::SetSeedRand(TILRAND, TILEMAPSEED+viewid);
 
-    if (skin_->neighborMode_ == Connected4)
+    if (skin_->neighborMode_ == Connected4 || skin_->neighborMode_ == Connected8)
     {
-//        URHO3D_LOGINFOF("ObjectSkinned() - SetViewFromSkin : id=%u skin=%u featureData=%u 4-ConnectedTiles ...", viewid, skin_, fdata);
-
-        // Set inner blocks
-        for (unsigned y=1; y < height-1; y++)
-            for (unsigned x=1; x < width-1; x++)
-            {
-                addr = width*y + x;
-                tiledView[addr] = atlas_->GetTile(GetGid44FromSkin(sdata, fdata, addr, connectedView[addr]));
-            }
-
-        // borders left & right
-        for (unsigned y=1; y < height-1; y++)
-        {
-            // border left
-            addr = width*y;
-            tiledView[addr] = atlas_->GetTile(GetGid43FromSkin(sdata, fdata, addr, connectedView[addr], TopBit, RightBit, BottomBit));
-            // border right
-            addr += width - 1;
-            tiledView[addr] = atlas_->GetTile(GetGid43FromSkin(sdata, fdata, addr, connectedView[addr], TopBit, BottomBit, LeftBit));
-        }
+//        URHO3D_LOGINFOF("ObjectSkinned() - SetViewFromSkin : id=%u skin=%u featureData=%u %s-ConnectedTiles ...", viewid, skin_, fdata, skin_->neighborMode_ == Connected4 ? "4" : "8");
 
-        // borders top & bottom
-        const unsigned lastRowAddr = (height-1) * width;
-        const unsigned lastColAddr = width - 1;
-
-        for (unsigned x=1; x < width-1; x++)
-        {
-            // border top
-            tiledView[x] = atlas_->GetTile(GetGid43FromSkin(sdata, fdata, x, connectedView[x], RightBit, BottomBit, LeftBit));
-            // border bottom
-            addr = lastRowAddr + x;
-            tiledView[addr] = atlas_->GetTile(GetGid43FromSkin(sdata, fdata, addr, connectedView[addr], TopBit, RightBit, LeftBit));
-        }
-
-        // Set corner blocks
-        tiledView[0] = atlas_->GetTile(GetGid42FromSkin(sdata, fdata, 0, connectedView[0], RightBit, BottomBit));
-        tiledView[lastColAddr] = atlas_->GetTile(GetGid42FromSkin(sdata, fdata, lastColAddr, connectedView[lastColAddr], BottomBit, LeftBit));
-        tiledView[lastRowAddr] = atlas_->GetTile(GetGid42FromSkin(sdata, fdata, lastRowAddr, connectedView[lastRowAddr], TopBit, RightBit));
-        addr = lastRowAddr + lastColAddr;
-        tiledView[addr] = atlas_->GetTile(GetGid42FromSkin(sdata, fdata, addr, connectedView[addr], TopBit, LeftBit));
-    }
-    else if (skin_->neighborMode_ == Connected8)
-    {
-//        URHO3D_LOGINFOF("ObjectSkinned() - SetViewFromSkin : id=%u skin=%u featureData=%u 8-ConnectedTiles ...", viewid, skin_, fdata);
-
-        // Set inner blocks
-        for (unsigned y=1; y < height-1; y++)
-            for (unsigned x=1; x < width-1; x++)
-            {
-                addr = width*y + x;
-                tiledView[addr] = atlas_->GetTile(GetGid84FromSkin(sdata, fdata, addr, connectedView[addr]));
-            }
-
-        // borders left & right
-        for (unsigned y=1; y < height-1; y++)
-        {
-            // border left
-            addr = width*y;
-            tiledView[addr] = atlas_->GetTile(GetGid83FromSkin(sdata, fdata, addr, connectedView[addr], TopBit, RightBit, BottomBit));
-            // border right
-            addr += width - 1;
-            tiledView[addr] = atlas_->GetTile(GetGid83FromSkin(sdata, fdata, addr, connectedView[addr], TopBit, BottomBit, LeftBit));
-        }
-
-        // borders top & bottom
-        const unsigned lastRowAddr = (height-1) * width;
-        const unsigned lastColAddr = width - 1;
-
-        for (unsigned x=1; x < width-1; x++)
-        {
-            // border top
-            tiledView[x] = atlas_->GetTile(GetGid83FromSkin(sdata, fdata, x, connectedView[x], RightBit, BottomBit, LeftBit));
-            // border bottom
-            addr = lastRowAddr + x;
-            tiledView[addr] = atlas_->GetTile(GetGid83FromSkin(sdata, fdata, addr, connectedView[addr], TopBit, RightBit, LeftBit));
-        }
-
-        // Set corner blocks
-        tiledView[0] = atlas_->GetTile(GetGid82FromSkin(sdata, fdata, 0, connectedView[0], RightBit, BottomBit));
-        tiledView[lastColAddr] = atlas_->GetTile(GetGid82FromSkin(sdata, fdata, lastColAddr, connectedView[lastColAddr], BottomBit, LeftBit));
-        tiledView[lastRowAddr] = atlas_->GetTile(GetGid82FromSkin(sdata, fdata, lastRowAddr, connectedView[lastRowAddr], TopBit, RightBit));
-        addr = lastRowAddr + lastColAddr;
-        tiledView[addr] = atlas_->GetTile(GetGid82FromSkin(sdata, fdata, addr, connectedView[addr], TopBit, LeftBit));
+        SetConnectedView(viewid, skin_->neighborMode_ == Connected8);
     }
     else
     {
@@ -649,13 +493,15 @@ void ObjectSkinned::SetViewFromSkin(unsigned viewid)
                 tiles[i] = Tile::INITTILEPTR;
         }
 
+        // connect indexes of the sides (the dimension tiles below depend on their drawing order, not the connections)
+        connectPlane_.Update(fdata, width, height, 0, height-1);
+        connectPlane_.SetConnectIndexes(fdata, &connectedView[0], IntRect(0, 0, width-1, height-1), false);
+
         /// Important : For Dimension Tiles, Don't change this order : top, left, inner, right and bottom
         // border top
         {
             // corner top left
             {
-                connectedView[0] = fdata[0] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb2(feature_->nghTable4_, fdata, 0, RightBit, BottomBit) : MapTilesConnectType::Void;
-
                 tile = atlas_->GetTile(GetGid0_2X2FromSkin(skin, fdata, tiles, 0));
                 tiles[0] = tile;
 
@@ -680,8 +526,6 @@ void ObjectSkinned::SetViewFromSkin(unsigned viewid)
             // top
             for (unsigned x=1; x < width-1; x++)
             {
-                connectedView[x] = fdata[x] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb3(feature_->nghTable4_, fdata, x, RightBit, BottomBit, LeftBit) : MapTilesConnectType::Void;
-
                 if (tiles[x]->GetDimensions() < TILE_RENDER)
                     continue;
 
@@ -708,8 +552,6 @@ void ObjectSkinned::SetViewFromSkin(unsigned viewid)
             }
             // corner top right
             {
-                connectedView[lastColAddr] = fdata[lastColAddr] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb2(feature_->nghTable4_, fdata, lastColAddr,  BottomBit, LeftBit) : MapTilesConnectType::Void;
-
                 if (tiles[lastColAddr]->GetDimensions() > TILE_RENDER)
                 {
                     tile = atlas_->GetTile(GetGid0_1X2FromSkin(skin, fdata, tiles, lastColAddr));
@@ -726,8 +568,6 @@ void ObjectSkinned::SetViewFromSkin(unsigned viewid)
         for (unsigned y=1; y < height-1; y++)
         {
             addr = width*y;
-            connectedView[addr] = fdata[addr] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb3(feature_->nghTable4_, fdata, addr, TopBit, RightBit, BottomBit) : MapTilesConnectType::Void;
-
             if (tiles[addr]->GetDimensions() < TILE_RENDER)
                 continue;
 
@@ -758,8 +598,6 @@ void ObjectSkinned::SetViewFromSkin(unsigned viewid)
             for (unsigned x=1; x < width-1; x++)
             {
                 addr = width*y + x;
-                connectedView[addr] = fdata[addr] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb4(feature_->nghTable4_, fdata, addr) : MapTilesConnectType::Void;
-
                 if (tiles[addr]->GetDimensions() < TILE_RENDER)
                     continue;
 
@@ -790,8 +628,6 @@ void ObjectSkinned::SetViewFromSkin(unsigned viewid)
         {
             // border right
             addr = width*(y+1) - 1;
-            connectedView[addr] = fdata[addr] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb3(feature_->nghTable4_, fdata, addr, TopBit, BottomBit, LeftBit) : MapTilesConnectType::Void;
-
             if (tiles[addr]->GetDimensions() < TILE_RENDER)
                 continue;
 
@@ -808,8 +644,6 @@ void ObjectSkinned::SetViewFromSkin(unsigned viewid)
             const unsigned lastRowAddr = (height-1) * width;
             // corner left bottom
             {
-                connectedView[lastRowAddr] = fdata[lastRowAddr] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb2(feature_->nghTable4_, fdata, lastRowAddr, TopBit, RightBit) : MapTilesConnectType::Void;
-
                 if (tiles[lastRowAddr]->GetDimensions() > TILE_RENDER)
                 {
                     tile = atlas_->GetTile(GetGid0_2X1FromSkin(skin, fdata, tiles, lastRowAddr));
@@ -824,8 +658,6 @@ void ObjectSkinned::SetViewFromSkin(unsigned viewid)
             for (unsigned x=1; x < width-1; x++)
             {
                 addr = lastRowAddr + x;
-                connectedView[addr] = fdata[addr] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb3(feature_->nghTable4_, fdata, addr, TopBit, RightBit, LeftBit) : MapTilesConnectType::Void;
-
                 if (tiles[addr]->GetDimensions() < TILE_RENDER)
                     continue;
 
@@ -839,8 +671,6 @@ void ObjectSkinned::SetViewFromSkin(unsigned viewid)
             // corner right bottom
             {
                 addr = lastRowAddr + lastColAddr;
-                connectedView[addr] = fdata[addr] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb2(feature_->nghTable4_, fdata, addr, TopBit, LeftBit) : MapTilesConnectType::Void;
-
                 if (tiles[addr]->GetDimensions() > TILE_RENDER)
                     tiles[addr] = atlas_->GetTile(GetGid0_1X1FromSkin(skin, fdata, addr));
             }
@@ -867,43 +697,7 @@ void ObjectSkinned::SetViewFromTerrain(unsigned viewid)
 
     if (atlas_->GetNeighborMode() == Connected4)
     {
-        for (unsigned y=1; y < height-1; y++)
-            for (unsigned x=1; x < width-1; x++)
-            {
-                addr = width*y + x;
-                tiledView[addr] = atlas_->GetTile(GetGid44FromTerrain(fdata, addr, connectedView[addr]));
-            }
-
-        // borders left & right
-        for (unsigned y=1; y < height-1; y++)
-        {
-            // border left
-            addr = width*y;
-            tiledView[addr] = atlas_->GetTile(GetGid43FromTerrain(fdata, addr, connectedView[addr], TopBit, RightBit, BottomBit));
-            // border right
-            addr += width - 1;
-            tiledView[addr] = atlas_->GetTile(GetGid43FromTerrain(fdata, addr, connectedView[addr], TopBit, BottomBit, LeftBit));
-        }
-
-        // borders top & bottom
-        const unsigned lastRowAddr = (height-1) * width;
-        const unsigned lastColAddr = width - 1;
-
-        for (unsigned x=1; x < width-1; x++)
-        {
-            // border top
-            tiledView[x] = atlas_->GetTile(GetGid43FromTerrain(fdata, x, connectedView[x], RightBit, BottomBit, LeftBit));
-            // border bottom
-            addr = lastRowAddr + x;
-            tiledView[addr] = atlas_->GetTile(GetGid43FromTerrain(fdata, addr, connectedView[addr], TopBit, RightBit, LeftBit));
-        }
-
-        // Set corner blocks
-        tiledView[0] = atlas_->GetTile(GetGid42FromTerrain(fdata, 0, connectedView[0], RightBit, BottomBit));
-        tiledView[lastColAddr] = atlas_->GetTile(GetGid42FromTerrain(fdata, lastColAddr, connectedView[lastColAddr], BottomBit, LeftBit));
-        tiledView[lastRowAddr] = atlas_->GetTile(GetGid42FromTerrain(fdata, lastRowAddr, connectedView[lastRowAddr], TopBit, RightBit));
-        addr = lastRowAddr + lastColAddr;
-        tiledView[addr] = atlas_->GetTile(GetGid42FromTerrain(fdata, addr, connectedView[addr], TopBit, LeftBit));
+        SetConnectedView(viewid, false);
     }
     else if (atlas_->GetNeighborMode() == Connected8)
     {
@@ -925,13 +719,15 @@ void ObjectSkinned::SetViewFromTerrain(unsigned viewid)
                 tiles[i] = Tile::INITTILEPTR;
         }
 
+        // connect indexes of the sides (the dimension tiles below depend on their drawing order, not the connections)
+        connectPlane_.Update(fdata, width, height, 0, height-1);
+        connectPlane_.SetConnectIndexes(fdata, &connectedView[0], IntRect(0, 0, width-1, height-1), false);
+
         /// Important : For Dimension Tiles, Don't change this order : top, left, inner, right and bottom
         // border top
         {
             // corner top left
             {
-                connectedView[0] = fdata[0] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb2(feature_->nghTable4_, fdata, 0, RightBit, BottomBit) : MapTilesConnectType::Void;
-
                 tile = atlas_->GetTile(GetGid0_2X2FromTerrain(fdata, tiles, 0));
                 tiles[0] = tile;
 
@@ -956,8 +752,6 @@ void ObjectSkinned::SetViewFromTerrain(unsigned viewid)
             // top
             for (unsigned x=1; x < width-1; x++)
             {
-                connectedView[x] = fdata[x] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb3(feature_->nghTable4_, fdata, x, RightBit, BottomBit, LeftBit) : MapTilesConnectType::Void;
-
                 if (tiles[x]->GetDimensions() < TILE_RENDER)
                     continue;
 
@@ -984,8 +778,6 @@ void ObjectSkinned::SetViewFromTerrain(unsigned viewid)
             }
             // corner top right
             {
-                connectedView[lastColAddr] = fdata[lastColAddr] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb2(feature_->nghTable4_, fdata, lastColAddr,  BottomBit, LeftBit) : MapTilesConnectType::Void;
-
                 if (tiles[lastColAddr]->GetDimensions() > TILE_RENDER)
                 {
                     tile = atlas_->GetTile(GetGid0_1X2FromTerrain(fdata, tiles, lastColAddr));
@@ -1002,8 +794,6 @@ void ObjectSkinned::SetViewFromTerrain(unsigned viewid)
         for (unsigned y=1; y < height-1; y++)
         {
             addr = width*y;
-            connectedView[addr] = fdata[addr] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb3(feature_->nghTable4_, fdata, addr, TopBit, RightBit, BottomBit) : MapTilesConnectType::Void;
-
             if (tiles[addr]->GetDimensions() < TILE_RENDER)
                 continue;
 
@@ -1035,8 +825,6 @@ void ObjectSkinned::SetViewFromTerrain(unsigned viewid)
             for (unsigned x=1; x < width-1; x++)
             {
                 addr = width*y + x;
-                connectedView[addr] = fdata[addr] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb4(feature_->nghTable4_, fdata, addr) : MapTilesConnectType::Void;
-
                 if (tiles[addr]->GetDimensions() < TILE_RENDER)
                     continue;
 
@@ -1068,8 +856,6 @@ void ObjectSkinned::SetViewFromTerrain(unsigned viewid)
         {
             // border right
             addr = width*(y+1) - 1;
-            connectedView[addr] = fdata[addr] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb3(feature_->nghTable4_, fdata, addr, TopBit, BottomBit, LeftBit) : MapTilesConnectType::Void;
-
             if (tiles[addr]->GetDimensions() < TILE_RENDER)
                 continue;
 
@@ -1086,8 +872,6 @@ void ObjectSkinned::SetViewFromTerrain(unsigned viewid)
             const unsigned lastRowAddr = (height-1) * width;
             // corner left bottom
             {
-                connectedView[lastRowAddr] = fdata[lastRowAddr] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb2(feature_->nghTable4_, fdata, lastRowAddr, TopBit, RightBit) : MapTilesConnectType::Void;
-
                 if (tiles[lastRowAddr]->GetDimensions() > TILE_RENDER)
                 {
                     tile = atlas_->GetTile(GetGid0_2X1FromTerrain(fdata, tiles, lastRowAddr));
@@ -1102,8 +886,6 @@ void ObjectSkinned::SetViewFromTerrain(unsigned viewid)
             for (unsigned x=1; x < width-1; x++)
             {
                 addr = lastRowAddr + x;
-                connectedView[addr] = fdata[addr] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb3(feature_->nghTable4_, fdata, addr, TopBit, RightBit, LeftBit) : MapTilesConnectType::Void;
-
                 if (tiles[addr]->GetDimensions() < TILE_RENDER)
                     continue;
 
@@ -1117,8 +899,6 @@ void ObjectSkinned::SetViewFromTerrain(unsigned viewid)
             // corner right bottom
             {
                 addr = lastRowAddr + lastColAddr;
-                connectedView[addr] = fdata[addr] >= MapFeatureType::NoRender ? Tile::GetConnectIndexNghb2(feature_->nghTable4_, fdata, addr, TopBit, LeftBit) : MapTilesConnectType::Void;
-
                 if (tiles[addr]->GetDimensions() > TILE_RENDER)
                     tiles[addr] = atlas_->GetTile(GetGid0_1X1FromTerrain(fdata, addr));
             }
@@ -1144,6 +924,7 @@ bool ObjectSkinned::SetViews(HiresTimer* timer, const long long& delay)
 
         indexToSet_++;
         indexVToSet_ = 0;
+        setViewsUsec_ = 0;
     }
 
     if (indexToSet_ == 1)
@@ -1155,17 +936,22 @@ bool ObjectSkinned::SetViews(HiresTimer* timer, const long long& delay)
             {
                 indexToSet_++;
 
-                URHO3D_LOGINFOF("ObjectSkinned() - SetViews ... OK !");
+                URHO3D_LOGINFOF("ObjectSkinned() - SetViews ... map=%s numviews=%u size=%ux%u time=%d usec ... OK !",
+                                map_ ? map_->GetMapPoint().ToString().CString() : "none", numviews_, GetWidth(), GetHeight(), (int)setViewsUsec_);
                 indexVToSet_ = 0;
                 indexToSet_ = 0;
                 return true;
             }
 
+            HiresTimer viewTimer;
+
             if (skin_)
                 SetViewFromSkin(indexVToSet_);
             else
                 SetViewFromTerrain(indexVToSet_);
 
+            setViewsUsec_ += viewTimer.GetUSec(false);
+
 #ifdef DUMP_SKINWARNINGS
             GameHelpers::DumpData(&GetConnectedView(indexVToSet_)[0], -1, 2, GetWidth(), GetHeight());
 #endif
@@ -1190,40 +976,6 @@ void ObjectSkinned::SetView(int viewid)
         SetViewFromTerrain(viewid);
 }
 
-inline void ObjectSkinned::SetConnectIndex_4(const FeatureType* features, ConnectedMap& connections, Tile** tiles, unsigned addr, int x, int y)
-{
-    // inner
-    if (y > 0 && y < GetHeight()-1)
-    {
-        if (x > 0 && x < GetWidth()-1)
-            tiles[addr] = atlas_->GetTile(GetGid44FromSkin(skin_->skinData_, features, addr, connections[addr]));
-        else if (x == 0)
-            tiles[addr] = atlas_->GetTile(GetGid43FromSkin(skin_->skinData_, features, addr, connections[addr], TopBit, RightBit, BottomBit));
-        else
-            tiles[addr] = atlas_->GetTile(GetGid43FromSkin(skin_->skinData_, features, addr, connections[addr], TopBit, BottomBit, LeftBit));
-    }
-    // top
-    else if (y == 0)
-    {
-        if (x > 0 && x < GetWidth()-1)
-            tiles[addr] = atlas_->GetTile(GetGid43FromSkin(skin_->skinData_, features, addr, connections[addr], RightBit, BottomBit, LeftBit));
-        else if (x == 0)
-            tiles[addr] = atlas_->GetTile(GetGid42FromSkin(skin_->skinData_, features, addr, connections[addr], RightBit, BottomBit));
-        else
-            tiles[addr] = atlas_->GetTile(GetGid42FromSkin(skin_->skinData_, features, addr, connections[addr], BottomBit, LeftBit));
-    }
-    // bottom
-    else
-    {
-        if (x > 0 && x < GetWidth()-1)
-            tiles[addr] = atlas_->GetTile(GetGid43FromSkin(skin_->skinData_, features, addr, connections[addr], TopBit, RightBit, LeftBit));
-        else if (x == 0)
-            tiles[addr] = atlas_->GetTile(GetGid42FromSkin(skin_->skinData_, features, addr, connections[addr], TopBit, RightBit));
-        else
-            tiles[addr] = atlas_->GetTile(GetGid42FromSkin(skin_->skinData_, features, addr, connections[addr], TopBit, LeftBit));
-    }
-}
-
 //inline void ObjectSkinned::SetConnectIndex_0(const FeatureType* features, ConnectedMap& connections, unsigned addr, int x, int y)
 //{
 //    if (y > 0 && y < GetHeight()-1)
@@ -1620,20 +1372,14 @@ void ObjectSkinned::SetTileFromSkin(int x, int y, int viewid, int maxdim)
 #ifdef DUMP_MAPDEBUG_SETTILE
         URHO3D_LOGINFOF("ObjectSkinned() - SetTileFromSkin mode=Connected4 x=%d y=%d viewid=%d", x, y, viewid);
 #endif
-        SetConnectIndex_4(features, connectedView, tiles, addr, x, y);
-
-        if (x > 0)
-            SetConnectIndex_4(features, connectedView, tiles, addr-1, x-1, y);
-        if (y > 0)
-            SetConnectIndex_4(features, connectedView, tiles, addr-width, x, y-1);
-        if (x < width-1)
-            SetConnectIndex_4(features, connectedView, tiles, addr+1, x+1, y);
-        if (y < height-1)
-            SetConnectIndex_4(features, connectedView, tiles, addr+width, x, y-1);
+        SetConnectedTiles(viewid, x, y, false);
     }
     else if (skin_->neighborMode_ == Connected8)
     {
-        URHO3D_LOGINFOF("ObjectSkinned() - SetTileFromSkin mode=Connected8 x=%d y=%d viewid=%d NOT IMPLEMENTED", x, y, viewid);
+#ifdef DUMP_MAPDEBUG_SETTILE
+        URHO3D_LOGINFOF("ObjectSkinned() - SetTileFromSkin mode=Connected8 x=%d y=%d viewid=%d", x, y, viewid);
+#endif
+        SetConnectedTiles(viewid, x, y, true);
     }
     else
     {
@@ -1685,16 +1431,7 @@ void ObjectSkinned::SetTileFromTerrain(int x, int y, int viewid, int maxdim)
 #ifdef DUMP_MAPDEBUG_SETTILE
         URHO3D_LOGINFOF("ObjectSkinned() - SetTileFromTerrain mode=Connected4 x=%d y=%d viewid=%d", x, y, viewid);
 #endif
-        SetConnectIndex_4(features, connectedView, tiles, addr, x, y);
-
-        if (x > 0)
-            SetConnectIndex_4(features, connectedView, tiles, addr-1, x-1, y);
-        if (y > 0)
-            SetConnectIndex_4(features, connectedView, tiles, addr-width, x, y-1);
-        if (x < width-1)
-            SetConnectIndex_4(features, connectedView, tiles, addr+1, x+1, y);
-        if (y < height-1)
-            SetConnectIndex_4(features, connectedView, tiles, addr+width, x, y-1);
+        SetConnectedTiles(viewid, x, y, false);
     }
     else if (atlas_->GetNeighborMode() == Connected8)
     {
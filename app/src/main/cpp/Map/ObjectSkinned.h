@@ -10,6 +10,7 @@
 #include "GameOptions.h"
 
 #include "ObjectFeatured.h"
+#include "ConnectPlane.h"
 
 
 class World2DInfo;
@@ -25,6 +26,7 @@ struct ObjectSkinned : public RefCounted
 
     void Clear();
     void Resize(unsigned width, unsigned height, unsigned numviews);//, bool featureShared=false);
+    void GetBuffers(MapBuffers& buffers) const;
 
     void Set(ObjectFeatured* feature, TerrainAtlas* atlas, MapTerrain* terrain, MapSkin* skin=0);
     void SetNumViews(unsigned numviews);
@@ -93,20 +95,6 @@ private :
 #endif
     void Init();
 
-    inline int GetGid42FromSkin(const SkinData& sdata, const FeatureType* features, unsigned addr, ConnectIndex& index, const short int& nghb1, const short int& nghb2) const;
-    inline int GetGid43FromSkin(const SkinData& sdata, const FeatureType* features, unsigned addr, ConnectIndex& index, const short int& nghb1, const short int& nghb2, const short int& nghb3) const;
-    inline int GetGid44FromSkin(const SkinData& sdata, const FeatureType* features, unsigned addr, ConnectIndex& index) const;
-    inline int GetGid42FromTerrain(const FeatureType* features, unsigned addr, ConnectIndex& index, const short int& nghb1, const short int& nghb2) const;
-    inline int GetGid43FromTerrain(const FeatureType* features, unsigned addr, ConnectIndex& index, const short int& nghb1, const short int& nghb2, const short int& nghb3) const;
-    inline int GetGid44FromTerrain(const FeatureType* features, unsigned addr, ConnectIndex& index) const;
-
-    inline int GetGid82FromSkin(const SkinData& sdata, const FeatureType* features, unsigned addr, ConnectIndex& index, const short int& nghb1, const short int& nghb2) const;
-    inline int GetGid83FromSkin(const SkinData& sdata, const FeatureType* features, unsigned addr, ConnectIndex& index, const short int& nghb1, const short int& nghb2, const short int& nghb3) const;
-    inline int GetGid84FromSkin(const SkinData& sdata, const FeatureType* features, unsigned addr, ConnectIndex& index) const;
-    inline int GetGid82FromTerrain(const FeatureType* features, unsigned addr, ConnectIndex& index, const short int& nghb1, const short int& nghb2) const;
-    inline int GetGid83FromTerrain(const FeatureType* features, unsigned addr, ConnectIndex& index, const short int& nghb1, const short int& nghb2, const short int& nghb3) const;
-    inline int GetGid84FromTerrain(const FeatureType* features, unsigned addr, ConnectIndex& index) const;
-
     inline int GetGid0_1X1FromSkin(const MapSkin& skin, const FeatureType* features, unsigned addr) const;
     inline int GetGid0_2X1FromSkin(const MapSkin& skin, const FeatureType* features, const TilePtr* render, unsigned addr) const;
     inline int GetGid0_1X2FromSkin(const MapSkin& skin, const FeatureType* features, const TilePtr* render, unsigned addr) const;
@@ -116,7 +104,10 @@ private :
     inline int GetGid0_1X2FromTerrain(const FeatureType* features, const TilePtr* render, unsigned addr) const;
     inline int GetGid0_2X2FromTerrain(const FeatureType* features, const TilePtr* render, unsigned addr) const;
 
-    inline void SetConnectIndex_4(const FeatureType* features, ConnectedMap& connections, Tile** tiles, unsigned addr, int x, int y);
+    void UpdateSetOrder();
+    void SetTileGids(const FeatureType* features, ConnectedMap& connections, TiledMap& tiles, const unsigned* addrs, unsigned numaddrs);
+    void SetConnectedView(unsigned viewid, bool corners);
+    void SetConnectedTiles(unsigned viewid, int x, int y, bool corners);
 //    inline void SetConnectIndex_0(const FeatureType* features, ConnectedMap& connections, unsigned addr, int x, int y);
     inline void SetConnectIndex_0(const FeatureType* features, ConnectedMap& connections, unsigned addr, int x, int y, int viewid);
 
@@ -137,5 +128,13 @@ private :
 
     Vector<ConnectedMap> connectedViews_;
     Vector<TiledMap> tiledViews_;
+
+    /// connect indexes of the views by bit plane (Connected0 views, Connected4/Connected8 views and edits)
+    ConnectPlane connectPlane_;
+    /// Connected4/Connected8 : tile addresses in the order used to draw the random gids
+    PODVector<unsigned> setOrder_;
+    unsigned setOrderWidth_, setOrderHeight_;
+    /// time spent in SetViews for the current map
+    long long setViewsUsec_;
 };
 
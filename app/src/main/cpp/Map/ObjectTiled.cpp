@@ -6,6 +6,7 @@
 
 #include <Urho3D/Core/Context.h>
 #include <Urho3D/Core/Profiler.h>
+#include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/IO/Log.h>
 
 #include <Urho3D/Graphics/Camera.h>
@@ -191,6 +192,628 @@ void BatchInfo::UpdateVerticePositions(Node* node)
         vertices[i].position_ = worldTransform * localpositions_[i];
 }
 
+
+/// ChunkViewGenerator
+
+// get the terrain id of a tile : the offset depends on the tile dimension
+static inline unsigned char GetTileTerrainId(const TiledMap& tiles, unsigned addr, const short int* neighborInd)
+{
+    if (!tiles[addr] || tiles[addr] == Tile::EMPTYPTR)
+        return 0;
+
+    return tiles[addr+neighborInd[Tile::DimensionNghIndex[tiles[addr]->GetDimensions()]]]->GetTerrain();
+}
+
+// push the quad of a sprite in a batch
+static inline void PushQuadVertices(Sprite2D* sprite, float xf, float yf, float zf, const Matrix2x3& worldTransform, Vertex2D* vertex,
+                                    Vector<Vector2>& localpositions, Vector<Vertex2D>& vertices)
+{
+    const Rect& drawRect = sprite->GetFixedDrawRectangle();
+    const Rect& textureRect = sprite->GetFixedTextRectangle();
+
+    localpositions.Push(Vector2(xf + drawRect.min_.x_, yf + drawRect.min_.y_));
+    localpositions.Push(Vector2(xf + drawRect.min_.x_, yf + drawRect.max_.y_));
+    localpositions.Push(Vector2(xf + drawRect.max_.x_, yf + drawRect.max_.y_));
+    localpositions.Push(Vector2(xf + drawRect.max_.x_, yf + drawRect.min_.y_));
+
+    vertex[0].position_ = worldTransform * localpositions[localpositions.Size()-4];
+    vertex[1].position_ = worldTransform * localpositions[localpositions.Size()-3];
+    vertex[2].position_ = worldTransform * localpositions[localpositions.Size()-2];
+    vertex[3].position_ = worldTransform * localpositions[localpositions.Size()-1];
+
+#ifdef URHO3D_VULKAN
+    for (int i =0; i < 4; i++)
+        vertex[i].z_ = zf;
+#else
+    for (int i =0; i < 4; i++)
+        vertex[i].position_.z_ = zf;
+#endif
+
+    vertex[0].uv_ = textureRect.min_;
+    vertex[1].uv_ = Vector2(textureRect.min_.x_, textureRect.max_.y_);
+    vertex[2].uv_ = textureRect.max_;
+    vertex[3].uv_ = Vector2(textureRect.max_.x_, textureRect.min_.y_);
+
+    for (int i=0; i<4; i++)
+        vertices.Push(vertex[i]);
+}
+
+/// ChunkViewGenerator : generates the tiles, decals or sewings quads of a view, row by row.
+/// Used by the main thread (UpdateChunkViewBatches) and by the chunk workers (ChunkBuildJob).
+/// The Sink receives the quads :
+///     void SetBatch(MapObjectType type, int indexView, int drawOrder, int layer, bool roof, Texture2D* texture);
+///     void PushQuad(Sprite2D* sprite, Texture2D* texture, float xf, float yf, float zf, Vertex2D* vertex);
+class ChunkViewGenerator
+{
+public:
+    ChunkViewGenerator(const ChunkViewParams& params, MapObjectType type);
+
+    template <typename Sink> void GenerateRow(const Chunk& chunk, int y, Sink& sink)
+    {
+        if (type_ == TILE)
+            GenerateTileRow(chunk, y, sink);
+        else if (type_ == DECAL)
+            GenerateDecalRow(chunk, y, sink);
+        else
+            GenerateSewingRow(chunk, y, sink);
+    }
+
+private:
+    template <typename Sink> void GenerateTileRow(const Chunk& chunk, int y, Sink& sink);
+    template <typename Sink> void GenerateDecalRow(const Chunk& chunk, int y, Sink& sink);
+    template <typename Sink> void GenerateSewingRow(const Chunk& chunk, int y, Sink& sink);
+
+    unsigned char GetTerrainId(unsigned addr) const
+    {
+        return GetTileTerrainId(*params_.tiles_, addr, params_.neighborInd_);
+    }
+    void UpdateColor()
+    {
+        if (newcolor_ != lastcolor_)
+        {
+            vertex_[0].color_ = vertex_[1].color_ = vertex_[2].color_ = vertex_[3].color_ = newcolor_;
+            lastcolor_ = newcolor_;
+        }
+    }
+
+    const ChunkViewParams& params_;
+    const TerrainAtlas* atlas_;
+    MapObjectType type_;
+
+    Color viewZColor_, viewPColor_;
+    int drawOrderZ_, drawOrderP_, drawOrderR_;
+    int roofViewModifier_;
+    int layer_;
+    float zf_;
+
+    unsigned newcolor_, lastcolor_;
+    unsigned char terrainid_;
+    int drawOrder_;
+    int indexView_;
+    bool isRoof_;
+    Vertex2D vertex_[4];
+};
+
+ChunkViewGenerator::ChunkViewGenerator(const ChunkViewParams& params, MapObjectType type) :
+    params_(params),
+    atlas_(ObjectTiled::GetAtlas()),
+    type_(type),
+    newcolor_(0),
+    lastcolor_(0),
+    terrainid_(255),
+    indexView_(params.indexV_),
+    isRoof_(false)
+{
+    const int viewZ = params.viewZ_;
+    const int layermodifier = viewZ > INNERVIEW ? params.layermodifier_ : -params.layermodifier_;
+    const int orderInLayer = params.orderInLayer_ + (type == TILE ? 0 : type == DECAL ? LAYER_DECALS : LAYER_SEWINGS);
+
+    const float viewcolor = (float)viewZ / (float)params.currentViewZ_;
+    const float backmodifier = viewZ == BACKVIEW ? 0.5f : 1.f;
+    viewZColor_ = Color(viewcolor * backmodifier, viewcolor * backmodifier, viewcolor * backmodifier, type == SEWING ? 0.65f : 1.f);
+    viewPColor_ = type == SEWING ? viewZColor_ : Color(viewcolor * 0.6f, viewcolor * 0.6f, viewcolor * 0.6f, 1.f);
+
+    drawOrderZ_ = ((viewZ + layermodifier) << 20) + (orderInLayer << 10);
+    drawOrderP_ = ((viewZ + layermodifier + LAYER_PLATEFORMS) << 20) + (orderInLayer << 10);
+    drawOrderR_ = ((viewZ + layermodifier + (viewZ > INNERVIEW ? LAYER_FRONTROOFS : LAYER_BACKROOFS)) << 20) + (orderInLayer << 10);
+    roofViewModifier_ = viewZ > INNERVIEW ? 1 : -1;
+    drawOrder_ = drawOrderZ_;
+
+    layer_ = type == DECAL && params.fluidEnabled_ && params.viewID_ == FrontView_ViewId ? LAYERFRONTSHAPES : LAYERGROUNDS;
+
+    // the sewings are always in front
+    if (type == SEWING)
+        zf_ = 1.f;
+    else
+        zf_ = params.containPlateforms_ ? 1.f - (viewZ + LAYER_PLATEFORMS) * PIXEL_SIZE : 1.f -(viewZ + layermodifier) * PIXEL_SIZE;
+}
+
+template <typename Sink>
+void ChunkViewGenerator::GenerateTileRow(const Chunk& chunk, int y, Sink& sink)
+{
+    const ChunkViewParams& p = params_;
+    const FeaturedMap& mask = *p.mask_;
+    const TiledMap& tiles = *p.tiles_;
+    const ConnectedMap& connections = *p.connections_;
+    const int indexV = p.indexV_;
+    const float yf = ((float)(p.height_ - y) - p.center_.y_) * p.theight_;
+
+    unsigned addr = y * p.width_ + chunk.startCol;
+    for (int x=chunk.startCol; x < chunk.endCol; x++,addr++)
+    {
+        FeatureType feat = mask[addr];
+        // Skip NoRender (Masked Tiles)
+        if (feat == MapFeatureType::NoRender)
+            continue;
+
+        if (connections[addr] == MapTilesConnectType::Void)
+            continue;
+
+        Tile* tile = tiles[addr];
+        if (tile->GetDimensions() < TILE_RENDER)
+            continue;
+
+        if (p.containPlateforms_)
+        {
+#ifdef RENDER_PLATEFORMS
+            if (feat == MapFeatureType::RoomPlateForm)
+            {
+                if (drawOrder_ != drawOrderP_ || tile->GetTerrain() != terrainid_)
+                    newcolor_ = (viewPColor_*atlas_->GetTerrain(tile->GetTerrain()).GetColor()).ToUInt();
+                terrainid_ = tile->GetTerrain();
+                drawOrder_ = drawOrderP_;
+                indexView_ = indexV + 1;
+                isRoof_ = false;
+            }
+            else
+            {
+                if (drawOrder_ != drawOrderZ_ || tile->GetTerrain() != terrainid_)
+                    newcolor_ = (viewZColor_*atlas_->GetTerrain(tile->GetTerrain()).GetColor()).ToUInt();
+                terrainid_ = tile->GetTerrain();
+            #ifdef RENDER_ROOFS
+                isRoof_ = (feat == MapFeatureType::OuterRoof || feat == MapFeatureType::InnerRoof);
+            #endif
+                drawOrder_ = isRoof_ ? drawOrderR_ : drawOrderZ_;
+                indexView_ = isRoof_ ? indexV + roofViewModifier_ : indexV;
+            }
+#else
+            if (feat == MapFeatureType::RoomPlateForm)
+                continue;
+#endif
+        }
+        else
+        {
+            if (tile->GetTerrain() != terrainid_)
+            {
+                terrainid_ = tile->GetTerrain();
+                newcolor_ = (viewZColor_*atlas_->GetTerrain(terrainid_).GetColor()).ToUInt();
+            }
+#ifdef RENDER_ROOFS
+            isRoof_ = (feat == MapFeatureType::OuterRoof || feat == MapFeatureType::InnerRoof);
+#elif defined(ACTIVE_DUNGEONROOFS)
+            if (feat == MapFeatureType::OuterRoof || feat == MapFeatureType::InnerRoof)
+                continue;
+#endif
+            drawOrder_ = isRoof_ ? drawOrderR_ : drawOrderZ_;
+            indexView_ = isRoof_ ? indexV + roofViewModifier_ : indexV;
+        }
+
+        // a roof in front of the first view is never rendered
+        if (indexView_ < 0)
+            continue;
+
+        UpdateColor();
+
+        Sprite2D* sprite = tile->GetSprite();
+        sink.SetBatch(TILE, indexView_, drawOrder_, LAYERGROUNDS, isRoof_, sprite->GetTexture());
+        sink.PushQuad(sprite, sprite->GetTexture(), ((float)x - p.center_.x_) * p.twidth_, yf, zf_, vertex_);
+    }
+}
+
+template <typename Sink>
+void ChunkViewGenerator::GenerateDecalRow(const Chunk& chunk, int y, Sink& sink)
+{
+    const ChunkViewParams& p = params_;
+    const FeaturedMap& mask = *p.mask_;
+    const ConnectedMap& connections = *p.connections_;
+    const int indexV = p.indexV_;
+    const int width = p.width_;
+    const float twidth = p.twidth_;
+    const float theight = p.theight_;
+    const float yf = ((float)p.height_ - y - p.center_.y_) * theight;
+
+    unsigned addr = y * width + chunk.startCol;
+    for (int x=chunk.startCol; x < chunk.endCol; x++,addr++)
+    {
+        if (mask[addr] <= MapFeatureType::NoRender)
+            continue;
+
+        const ConnectIndex& connectIndex = connections[addr];
+        if (connectIndex == MapTilesConnectType::Void)
+            continue;
+
+        const unsigned char terrainid = GetTerrainId(addr);
+
+        if (!atlas_->GetTerrain(terrainid).UseDecals())
+            continue;
+
+        if (p.containPlateforms_)
+        {
+#ifdef RENDER_PLATEFORMS
+            if (mask[addr] == MapFeatureType::RoomPlateForm)
+            {
+                if (drawOrder_ != drawOrderP_ || terrainid != terrainid_)
+                    newcolor_ = (viewPColor_*atlas_->GetTerrain(terrainid).GetColor()).ToUInt();
+                terrainid_ = terrainid;
+                drawOrder_ = drawOrderP_;
+                indexView_ = indexV + 1;
+            }
+            else
+            {
+                if (drawOrder_ != drawOrderZ_ || terrainid != terrainid_)
+                    newcolor_ = (viewZColor_*atlas_->GetTerrain(terrainid).GetColor()).ToUInt();
+                terrainid_ = terrainid;
+                drawOrder_ = drawOrderZ_;
+                indexView_ = indexV;
+            }
+#else
+            if (mask[addr] == MapFeatureType::RoomPlateForm)
+                continue;
+#endif
+        }
+        else if (terrainid != terrainid_)
+        {
+            terrainid_ = terrainid;
+            newcolor_ = (viewZColor_*atlas_->GetTerrain(terrainid).GetColor()).ToUInt();
+        }
+
+        UpdateColor();
+
+        Texture2D* texture = atlas_->GetDecalSprite(terrainid, 1, addr)->GetTexture();
+        const float xf = ((float)x - p.center_.x_) * twidth;
+
+        sink.SetBatch(DECAL, indexView_, drawOrder_, layer_, false, texture);
+
+        if ((connectIndex & LeftSide) == 0 || (x > 0 && mask[addr-1] == MapFeatureType::RoomPlateForm && mask[addr] != MapFeatureType::RoomPlateForm))
+            sink.PushQuad(atlas_->GetDecalSprite(terrainid, LeftSide, addr+LeftSide), texture, xf, yf-0.5f*theight, zf_, vertex_);
+
+        if ((connectIndex & RightSide) == 0 || (x < width-1 && mask[addr+1] == MapFeatureType::RoomPlateForm && mask[addr] != MapFeatureType::RoomPlateForm))
+            sink.PushQuad(atlas_->GetDecalSprite(terrainid, RightSide, addr+RightSide), texture, xf+twidth, yf-0.5f*theight, zf_, vertex_);
+
+        if ((connectIndex & TopSide) == 0 || (y > 0 && mask[addr-width] == MapFeatureType::RoomPlateForm && mask[addr] != MapFeatureType::RoomPlateForm))
+            sink.PushQuad(atlas_->GetDecalSprite(terrainid, TopSide, addr+TopSide), texture, xf+0.5f*twidth, yf, zf_, vertex_);
+
+        if ((connectIndex & BottomSide) == 0 || (y < p.height_-1 && mask[addr+width] == MapFeatureType::RoomPlateForm && mask[addr] != MapFeatureType::RoomPlateForm))
+            sink.PushQuad(atlas_->GetDecalSprite(terrainid, BottomSide, addr+BottomSide), texture, xf+0.5f*twidth, yf-1.f*theight, zf_, vertex_);
+    }
+}
+
+template <typename Sink>
+void ChunkViewGenerator::GenerateSewingRow(const Chunk& chunk, int y, Sink& sink)
+{
+    const ChunkViewParams& p = params_;
+    const FeaturedMap& mask = *p.mask_;
+    const ConnectedMap& connections = *p.connections_;
+    const int indexV = p.indexV_;
+    const int width = p.width_;
+    const int height = p.height_;
+    const float twidth = p.twidth_;
+    const float theight = p.theight_;
+    const float yf = ((float)height - y - p.center_.y_) * theight;
+
+    // check if viewid is also in connectmap (just check the num of views : cave(3)/dungeon(5)
+    // for example : if cmap is cavetype and map is dungeontype and if viewid=3-backview (there no backview in cave)
+    //               then in this case, the border terrains are empty, terrainid2 equal 0 and sewing is made.
+    const PODVector<unsigned char>& westTerrains = *p.borderTerrains_[MapDirection::West];
+    const PODVector<unsigned char>& eastTerrains = *p.borderTerrains_[MapDirection::East];
+    const PODVector<unsigned char>& northTerrains = *p.borderTerrains_[MapDirection::North];
+    const PODVector<unsigned char>& southTerrains = *p.borderTerrains_[MapDirection::South];
+
+    unsigned char terrainid1, terrainid2;
+
+    unsigned addr = y * width + chunk.startCol;
+    for (int x=chunk.startCol; x < chunk.endCol; x++,addr++)
+    {
+        if (mask[addr] <= MapFeatureType::NoRender)
+            continue;
+
+        const ConnectIndex& connectIndex = connections[addr];
+        if (connectIndex == MapTilesConnectType::Void)
+            continue;
+
+        terrainid1 = GetTerrainId(addr);
+
+        if (!atlas_->GetTerrain(terrainid1).UseDecals())
+            continue;
+
+        if (p.containPlateforms_)
+        {
+#ifdef RENDER_PLATEFORMS
+            if (mask[addr] == MapFeatureType::RoomPlateForm)
+            {
+                if (drawOrder_ != drawOrderP_ || terrainid1 != terrainid_)
+                    newcolor_ = (viewPColor_*atlas_->GetTerrain(terrainid1).GetColor()).ToUInt();
+                terrainid_ = terrainid1;
+                drawOrder_ = drawOrderP_;
+                indexView_ = indexV + 1;
+            }
+            else
+            {
+                if (drawOrder_ != drawOrderZ_ || terrainid1 != terrainid_)
+                    newcolor_ = (viewZColor_*atlas_->GetTerrain(terrainid1).GetColor()).ToUInt();
+                terrainid_ = terrainid1;
+                drawOrder_ = drawOrderZ_;
+                indexView_ = indexV;
+            }
+#else
+            if (mask[addr] == MapFeatureType::RoomPlateForm)
+                continue;
+#endif
+        }
+        else
+        {
+            if (drawOrder_ != drawOrderZ_ || terrainid1 != terrainid_)
+                newcolor_ = (viewZColor_*atlas_->GetTerrain(terrainid1).GetColor()).ToUInt();
+            if (terrainid1 != terrainid_)
+            {
+                terrainid_ = terrainid1;
+                drawOrder_ = drawOrderZ_;
+                indexView_ = indexV;
+            }
+        }
+
+        UpdateColor();
+
+        Texture2D* texture = atlas_->GetDecalSprite(terrainid1, 1, addr)->GetTexture();
+        const float xf = ((float)x - p.center_.x_) * twidth;
+        bool batched = false;
+
+        if ((connectIndex & LeftSide) != 0)
+        {
+            terrainid2 = x == 0 ? (westTerrains.Size() ? westTerrains[y] : 0) : GetTerrainId(addr-1);
+            if (terrainid1 > terrainid2)
+            {
+                if (!batched)
+                {
+                    sink.SetBatch(SEWING, indexView_, drawOrder_, LAYERGROUNDS, false, texture);
+                    batched = true;
+                }
+                sink.PushQuad(atlas_->GetDecalSprite(terrainid1, LeftSide, addr+LeftSide), texture, xf, yf-0.5f*theight, zf_, vertex_);
+            }
+        }
+
+        if ((connectIndex & RightSide) != 0)
+        {
+            terrainid2 = x == width-1 ? (eastTerrains.Size() ? eastTerrains[y] : 0) : GetTerrainId(addr+1);
+            if (terrainid1 > terrainid2)
+            {
+                if (!batched)
+                {
+                    sink.SetBatch(SEWING, indexView_, drawOrder_, LAYERGROUNDS, false, texture);
+                    batched = true;
+                }
+                sink.PushQuad(atlas_->GetDecalSprite(terrainid1, RightSide, addr+RightSide), texture, xf+twidth, yf-0.5f*theight, zf_, vertex_);
+            }
+        }
+
+        if ((connectIndex & TopSide) != 0)
+        {
+            terrainid2 = y == 0 ? (northTerrains.Size() ? northTerrains[x] : 0) : GetTerrainId(addr-width);
+            if (terrainid1 > terrainid2)
+            {
+                if (!batched)
+                {
+                    sink.SetBatch(SEWING, indexView_, drawOrder_, LAYERGROUNDS, false, texture);
+                    batched = true;
+                }
+                sink.PushQuad(atlas_->GetDecalSprite(terrainid1, TopSide, addr+TopSide), texture, xf+0.5f*twidth, yf, zf_, vertex_);
+            }
+        }
+
+        if ((connectIndex & BottomSide) != 0)
+        {
+            terrainid2 = y == height-1 ? (southTerrains.Size() ? southTerrains[x] : 0) : GetTerrainId(addr+width);
+            if (terrainid1 > terrainid2)
+            {
+                if (!batched)
+                {
+                    sink.SetBatch(SEWING, indexView_, drawOrder_, LAYERGROUNDS, false, texture);
+                    batched = true;
+                }
+                sink.PushQuad(atlas_->GetDecalSprite(terrainid1, BottomSide, addr+BottomSide), texture, xf+0.5f*twidth, yf-theight, zf_, vertex_);
+            }
+        }
+    }
+}
+
+/// ChunkBatchInfoSink : puts the generated quads in the BatchInfos of the ObjectTiled (main thread)
+struct ChunkBatchInfoSink
+{
+    ChunkBatchInfoSink(ObjectTiled& object, int indexZ) :
+        object_(object),
+        worldTransform_(object.GetNode()->GetWorldTransform2D()),
+        indexZ_(indexZ),
+        indexC_(0),
+        indexM_(0),
+        material_(0),
+        lasttexture_(0),
+        batchinfo_(0)
+#ifdef URHO3D_VULKAN
+        , texmode_(0)
+#endif
+    { }
+
+    void SetBatch(MapObjectType type, int indexView, int drawOrder, int layer, bool roof, Texture2D* texture)
+    {
+#ifdef ACTIVE_LAYERMATERIALS
+        Material* material = GameContext::Get().layerMaterials_[layer];
+#else
+        Material* material = object_.renderer_->GetMaterial(texture, BLEND_ALPHA);
+#endif
+        if (material_ != material)
+        {
+            material_ = material;
+            indexM_ = object_.GetMaterialIndex(material);
+            lasttexture_ = 0;
+        }
+
+        // get the good source batch considering chunk, material and plateforms
+        batchinfo_ = &object_.GetChunkBatchInfo(type, indexZ_, indexView, indexC_, roof ? object_.GetMaterialIndex(material, 1) : indexM_, drawOrder);
+    }
+
+    void PushQuad(Sprite2D* sprite, Texture2D* texture, float xf, float yf, float zf, Vertex2D* vertex)
+    {
+        if (lasttexture_ != texture)
+        {
+            lasttexture_ = texture;
+            SetTextureMode(TXM_UNIT, material_->GetTextureUnit(texture), texmode_);
+        }
+        vertex[0].texmode_ = vertex[1].texmode_ = vertex[2].texmode_ = vertex[3].texmode_ = texmode_;
+
+        PushQuadVertices(sprite, xf, yf, zf, worldTransform_, vertex, batchinfo_->localpositions_, batchinfo_->batch_.vertices_);
+    }
+
+    ObjectTiled& object_;
+    const Matrix2x3 worldTransform_;
+    int indexZ_;
+    unsigned indexC_;
+    unsigned indexM_;
+    Material* material_;
+    Texture2D* lasttexture_;
+    BatchInfo* batchinfo_;
+#ifdef URHO3D_VULKAN
+    unsigned texmode_;
+#else
+    Vector4 texmode_;
+#endif
+};
+
+
+#ifdef ACTIVE_OBJECTTILED_THREADING
+
+/// ChunkBuildJob
+
+void ChunkBuildThread(const WorkItem* item, unsigned threadIndex)
+{
+    ChunkBuildJob& job = *reinterpret_cast<ChunkBuildJob*>(item->aux_);
+    job.Build();
+    // release : the batches are visible to the main thread when it reads the counter
+    job.numRunning_->fetch_sub(1, std::memory_order_release);
+}
+
+void ChunkBuildJob::Build()
+{
+    const ChunkBuildSnapshot& snap = *snapshot_;
+
+    batches_.Clear();
+    lastBatch_ = M_MAX_UNSIGNED;
+
+    for (int indexZ = 0; indexZ < (int)snap.viewIds_.Size(); indexZ++)
+    {
+        if (snap.tilesEnable_)
+            BuildViews(TILE, indexZ);
+#ifdef RENDER_TERRAINS_BORDERS
+        if (snap.decalsEnable_)
+            BuildViews(DECAL, indexZ);
+#endif
+#ifdef RENDER_TERRAINS_SEWINGS
+        if (snap.decalsEnable_)
+            BuildViews(SEWING, indexZ);
+#endif
+    }
+}
+
+void ChunkBuildJob::BuildViews(MapObjectType type, int indexZ)
+{
+    const ChunkBuildSnapshot& snap = *snapshot_;
+    const Chunk& chunk = snap.chinfo_->chunks_[indexC_];
+    const PODVector<int>& viewIds = snap.viewIds_[indexZ];
+    const int numViews = Min(viewIds.Size(), snap.numviews_);
+
+    indexZ_ = indexZ;
+
+    ChunkViewParams params;
+    params.neighborInd_ = snap.neighborInd_;
+    params.currentViewZ_ = snap.currentViewZs_[indexZ];
+    params.width_ = snap.width_;
+    params.height_ = snap.height_;
+    params.twidth_ = snap.twidth_;
+    params.theight_ = snap.theight_;
+    params.center_ = snap.center_;
+    params.layermodifier_ = snap.layermodifier_;
+    params.orderInLayer_ = snap.orderInLayer_;
+    params.fluidEnabled_ = snap.fluidEnabled_;
+
+    for (int indexV = 0; indexV < numViews; indexV++)
+    {
+        const int viewID = viewIds[indexV];
+        if (viewID == NOVIEW)
+            continue;
+
+        params.mask_ = &snap.masks_[indexZ][indexV];
+        params.tiles_ = &snap.tiledViews_[viewID];
+        params.connections_ = &snap.connectedViews_[viewID];
+        for (int dir = 0; dir < 4; dir++)
+            params.borderTerrains_[dir] = &snap.borderTerrains_[dir][viewID];
+        params.viewID_ = viewID;
+        params.viewZ_ = snap.viewZs_[viewID];
+        params.indexV_ = indexV;
+        params.containPlateforms_ = (indexV == (int)viewIds.Size()-1);
+
+        ChunkViewGenerator generator(params, type);
+        for (int y = chunk.startRow; y < chunk.endRow; y++)
+            generator.GenerateRow(chunk, y, *this);
+    }
+}
+
+void ChunkBuildJob::SetBatch(MapObjectType type, int indexView, int drawOrder, int layer, bool roof, Texture2D* texture)
+{
+#ifdef ACTIVE_LAYERMATERIALS
+    // one material by layer : the texture is not a batch key
+    texture = 0;
+#endif
+    if (lastBatch_ < batches_.Size())
+    {
+        const ChunkBuildBatch& batch = batches_[lastBatch_];
+        if (batch.type_ == type && batch.indexZ_ == indexZ_ && batch.indexView_ == indexView && batch.drawOrder_ == drawOrder &&
+            batch.layer_ == layer && batch.roof_ == roof && batch.texture_ == texture)
+            return;
+    }
+
+    for (unsigned i = 0; i < batches_.Size(); i++)
+    {
+        const ChunkBuildBatch& batch = batches_[i];
+        if (batch.type_ == type && batch.indexZ_ == indexZ_ && batch.indexView_ == indexView && batch.drawOrder_ == drawOrder &&
+            batch.layer_ == layer && batch.roof_ == roof && batch.texture_ == texture)
+        {
+            lastBatch_ = i;
+            return;
+        }
+    }
+
+    batches_.Resize(batches_.Size()+1);
+    lastBatch_ = batches_.Size()-1;
+
+    ChunkBuildBatch& batch = batches_.Back();
+    batch.type_ = type;
+    batch.indexZ_ = indexZ_;
+    batch.indexView_ = indexView;
+    batch.drawOrder_ = drawOrder;
+    batch.layer_ = layer;
+    batch.roof_ = roof;
+    batch.texture_ = texture;
+}
+
+void ChunkBuildJob::PushQuad(Sprite2D* sprite, Texture2D* texture, float xf, float yf, float zf, Vertex2D* vertex)
+{
+    ChunkBuildBatch& batch = batches_[lastBatch_];
+    PushQuadVertices(sprite, xf, yf, zf, snapshot_->worldTransform_, vertex, batch.localpositions_, batch.vertices_);
+    // the texture unit is resolved in the main thread
+    batch.textures_.Push(texture);
+}
+
+#endif // ACTIVE_OBJECTTILED_THREADING
+
 #endif
 
 /// ObjectTiled Implementation
@@ -203,6 +826,7 @@ bool ObjectTiled::tilesEnable_ = true;
 bool ObjectTiled::decalsEnable_ = true;
 //int ObjectTiled::viewRangeMode_ = ViewRange_Frustum;
 int ObjectTiled::viewRangeMode_ = ViewRange_WorldVisibleRect;
+bool ObjectTiled::chunkBuildThreading_ = true;
 
 const StringHash eventFluidUpdate = E_SCENEPOSTUPDATE;
 //const StringHash eventUpdate = E_SCENEUPDATE;
@@ -264,6 +888,12 @@ void ObjectTiled::SetViewRangeMode(int mode)
 
 
 
+void ObjectTiled::SetChunkBuildThreading(bool state)
+{
+    chunkBuildThreading_ = state;
+}
+
+
 ObjectTiled::ObjectTiled() :
     Drawable2D(0),
     chinfo_(0),
@@ -304,6 +934,10 @@ ObjectTiled::~ObjectTiled()
 {
 //    URHO3D_LOGDEBUG("~ObjectTiled() ...");
 
+#if defined(ACTIVE_OBJECTTILED_THREADING) && !defined(USE_CHUNKBATCH)
+    WaitChunkBuildJobs();
+#endif
+
     skinData_.Reset();
 
     /// Free none shared ChunkInfo
@@ -326,10 +960,21 @@ void ObjectTiled::Init()
     for (int i=0; i < MAX_VIEWPORTS; i++)
         viewportDatas_[i].Set(this, i);
 
+#ifdef ACTIVE_MAPPOOL_KEEPBUFFERS
+    ResetChunksBatches();
+#else
     ClearChunksBatches();
+#endif
 
     dirtyChunkGroups_.Clear();
 
+#if defined(ACTIVE_OBJECTTILED_THREADING) && !defined(USE_CHUNKBATCH)
+    chunkBuildJobs_.Clear();
+    chunkBuildIndexes_.Clear();
+    numChunkBuildJobsRunning_.store(0, std::memory_order_relaxed);
+    chunkBuildRunning_ = chunkBuildAll_ = false;
+#endif
+
     if (!skinData_)
         skinData_ = SharedPtr<ObjectSkinned>(new ObjectSkinned());
 }
@@ -352,6 +997,10 @@ void ObjectTiled::Resize(int width, int height, unsigned numviews, ChunkInfo* ch
 
 void ObjectTiled::Clear()
 {
+#if defined(ACTIVE_OBJECTTILED_THREADING) && !defined(USE_CHUNKBATCH)
+    WaitChunkBuildJobs();
+#endif
+
     if (skinData_)
         skinData_->Clear();
 
@@ -363,6 +1012,26 @@ void ObjectTiled::Clear()
     Init();
 }
 
+void ObjectTiled::GetBuffers(MapBuffers& buffers) const
+{
+    if (skinData_)
+        skinData_->GetBuffers(buffers);
+
+#ifdef USE_CHUNKBATCH
+    AddMapBuffer(buffers, chunkBatches_);
+    for (unsigned i=0; i < chunkBatches_.Size(); ++i)
+        AddMapBuffer(buffers, chunkBatches_[i]);
+#else
+    AddMapBuffer(buffers, viewBatchesTable_);
+    for (unsigned i=0; i < viewBatchesTable_.Size(); ++i)
+    {
+        const BatchInfo& batchInfo = viewBatchesTable_[i];
+        AddMapBuffer(buffers, batchInfo.localpositions_);
+        AddMapBuffer(buffers, batchInfo.batch_.vertices_);
+    }
+#endif
+}
+
 void ObjectTiled::AllocateChunkBatches()
 {
     if (chinfo_->numx_*chinfo_->numy_ == 0)
@@ -408,11 +1077,31 @@ void ObjectTiled::ClearChunksBatches()
 #endif // USE_CHUNKBATCH
 }
 
+/// Reset the batches in place for a pooled map : the BatchInfos and their keys are kept with their vertex buffers at the high-water mark.
+/// The batches are dirty and empty until the tiles are set again.
+void ObjectTiled::ResetChunksBatches()
+{
+#ifdef USE_CHUNKBATCH
+    ClearChunksBatches();
+#else
+    for (unsigned i=0; i < viewBatchesTable_.Size(); i++)
+        viewBatchesTable_[i].Clear();
+
+    viewMaterialsTable_.Clear();
+#endif // USE_CHUNKBATCH
+}
+
 void ObjectTiled::SetChunked(ChunkInfo* chinfo, bool shared)
 {
     unsigned oldchunks = chinfo_ ? chinfo_->numx_*chinfo_->numy_ : 0;
     unsigned newchunks = chinfo ? chinfo->numx_*chinfo->numy_ : 0;
 
+#ifdef ACTIVE_MAPPOOL_KEEPBUFFERS
+    // the kept batch keys are indexed by chunk
+    if (oldchunks != newchunks)
+        ClearChunksBatches();
+#endif
+
     /// Free none shared ChunkInfo only if it's chunked
     if (chinfo_ && isChunked_)
     {
@@ -1074,818 +1763,146 @@ void ObjectTiled::ClearBatchVertices(MapObjectType type, int indexZ, int indexV,
     }
 }
 
-bool ObjectTiled::UpdateTiledBatches(const ChunkGroup& chunkGroup, int indexZ, int indexV, HiresTimer* timer, const long long& delay)
+// get the terrain id of a tile
+inline unsigned char ObjectTiled::GetTerrainId(const TiledMap& tiles, unsigned addr)
 {
-    if (TimeOver(timer))
-        return false;
-
-    URHO3D_PROFILE(ObjectTile_TileBatches);
+    return GetTileTerrainId(tiles, addr, neighborInd);
+}
 
+bool ObjectTiled::GetChunkViewParams(int indexZ, int indexV, ChunkViewParams& params)
+{
     const int currentViewZ = ViewManager::Get()->GetViewZ(indexZ);
     const Vector<int>& viewIds = GetObjectFeatured()->GetViewIDs(currentViewZ);
     if (indexV >= (int)viewIds.Size())
     {
 #ifdef DUMP_OBJECTTILED_UPDATEINFOS
-        URHO3D_LOGERRORF("ObjectTiled() - UpdateTiledBatches ... currentViewZ=%d viewIndex=%d > viewIDs Size=%u ... return !",
-                         currentViewZ, indexV+1, viewIds.Size());
-#endif
-        return true;
-    }
-
-    if (indexV >= (int)viewIds.Size())
-    {
-#ifdef DUMP_OBJECTTILED_UPDATEINFOS
-        URHO3D_LOGERRORF("ObjectTiled() - UpdateTiledBatches ... currentViewZ=%d viewIndex=%d > viewIDs Size=%u ... return !",
+        URHO3D_LOGERRORF("ObjectTiled() - GetChunkViewParams ... currentViewZ=%d viewIndex=%d > viewIDs Size=%u ... return !",
                          currentViewZ, indexV+1, viewIds.Size());
 #endif
-        return true;
+        return false;
     }
 
     const int viewID = viewIds[indexV];
+    if (viewID == NOVIEW)
+        return false;
 
-    const bool containPlateforms = (indexV == (int)viewIds.Size()-1);
-    const PODVector<unsigned>& chindex = chunkGroup.chIndexes_;
-    const ChunkInfo* chinfo = chunkGroup.chinfo_;
-    const unsigned numchunks = chunkGroup.numChunks_;
-
-    const int height = GetHeight();
     const int width = GetWidth();
-    const float twidth = chinfo->tileWidth_;
-    const float theight = chinfo->tileHeight_;
-    const Vector2 center((float)width * hotspot_.x_, (float)height * hotspot_.y_);
-
-    const FeaturedMap& mask = (indexV == (int)viewIds.Size()-1) ? GetObjectFeatured()->GetFeatureView(viewID) : GetObjectFeatured()->GetMaskedView(indexZ, indexV);
-    const Matrix2x3& worldTransform = node_->GetWorldTransform2D();
-    const TiledMap& tiles = GetObjectSkinned()->GetTiledView(viewID);
-    const ConnectedMap& connections = GetObjectSkinned()->GetConnectedView(viewID);
-
-    int viewZ = GetObjectFeatured()->GetViewZ(viewID);
-    int layermodifier = viewZ > INNERVIEW ? layermodifier_ : -layermodifier_;
-
-    float viewcolor = (float)viewZ / (float)currentViewZ;
-    float backmodifier = viewZ == BACKVIEW ? 0.5f : 1.f;
-    Color viewZColor = Color(viewcolor * backmodifier, viewcolor * backmodifier, viewcolor * backmodifier, 1.f);
-    Color viewPColor = Color(viewcolor * 0.6f, viewcolor * 0.6f, viewcolor * 0.6f, 1.f);
-    unsigned newcolor, lastcolor = 0;
-
-    const int drawOrderZ = ((viewZ + layermodifier) << 20) + (orderInLayer_ << 10);
-    const int drawOrderP = ((viewZ + layermodifier + LAYER_PLATEFORMS) << 20) + (orderInLayer_ << 10);
-#ifdef RENDER_ROOFS
-    const int roofViewModifier = viewZ > INNERVIEW ? 1 : -1;
-    const int drawOrderR = ((viewZ + layermodifier + (viewZ > INNERVIEW ? LAYER_FRONTROOFS : LAYER_BACKROOFS)) << 20) + (orderInLayer_ << 10);
-    bool isRoof = false;
-#endif
-
-    const float zf = 1.f -(viewZ + layermodifier) * PIXEL_SIZE;
-    const float zfplatform = 1.f - (viewZ + LAYER_PLATEFORMS) * PIXEL_SIZE;
-
-    float xf, yf;
-    unsigned addr;
-    unsigned numbatches=0;
-    Tile* tile;
-    Sprite2D* sprite;
-    unsigned char terrainid=255;
-    Material *material, *lastmaterial = 0;
-    unsigned indexM;
-#ifdef ACTIVE_LAYERMATERIALS
-    material = GameContext::Get().layerMaterials_[LAYERGROUNDS];
-    indexM = GetMaterialIndex(material);
-#endif
-#ifdef RENDER_ROOFS
-    const unsigned indexMRoof = GetMaterialIndex(material, 1);
-#endif
-    Texture2D *lasttexture=0;
-    Vertex2D vertex0, vertex1, vertex2, vertex3;
-
-    int drawOrder = drawOrderZ;
-    int indexView = indexV;
-
-#ifdef URHO3D_VULKAN
-    unsigned texmode = 0;
-#else
-    Vector4 texmode;
-#endif
-
-#ifdef DUMP_OBJECTTILED_UPDATEINFOS
-    URHO3D_LOGINFOF("ObjectTiled() - UpdateTiledBatches ... currentViewZ=%d(indexZ=%d) viewid=%d(%d/%u) chunk=%u/%u ... start at ystart=%d ...",
-                    currentViewZ, indexZ, viewID, indexV+1, viewIds.Size(), indexChunks_+1, numchunks, indexStartY_);
-#endif
-
-    for (unsigned c = indexChunks_; c < numchunks; c++)
-    {
-        unsigned indexC = chindex[c];
-//        URHO3D_LOGINFOF("ObjectTiled() - UpdateTiledBatches ... Update chunk=%u index=%u", c, indexC);
-
-        const Chunk& chunk = chinfo->chunks_[indexC];
-
-//        URHO3D_LOGINFOF("ObjectTiled() - UpdateTiledBatches ... w=%d h=%d Update chunk=%u chunkrow=%d to %d chunkcol=%d to %d...",
-//                            width, height, c, chunk.startRow, chunk.endRow, chunk.startCol, chunk.endCol);
-
-        // Be sure to check BatchInfo Dirty for each Material to clear batches for the case of "CREATEMODE : remove the last tile in a chunk"
-        if (indexStartY_ == 0)
-        {
-#ifdef RENDER_ROOFS
-            ClearBatchVertices(TILE, indexZ, indexV-1, indexC);
-            if (!containPlateforms)
-                ClearBatchVertices(TILE, indexZ, indexV+1, indexC);
-#endif
-            ClearBatchVertices(TILE, indexZ, indexV, indexC);
-            if (containPlateforms)
-                ClearBatchVertices(TILE, indexZ, indexV+1, indexC);
-
-#ifdef DUMP_ERROR_ON_TIMEOVER
-            if (timer)
-                LogTimeOver(ToString("ObjectTiled() - UpdateTiledBatches : map=%s ... currentViewZ=%d view=%d/%u chunks=%u/%u Clearing Vertices",
-                                     node_->GetName().CString(), currentViewZ, indexV+1, viewIds.Size(), indexChunks_, numchunks), timer, delay);
-#endif
-        }
-
-        for (int y=chunk.startRow + indexStartY_; y < chunk.endRow; y++)
-        {
-            addr = y * width + chunk.startCol;
-            yf = ((float)(height - y) - center.y_) * theight;
-
-            for (int x=chunk.startCol; x < chunk.endCol; x++,addr++)
-            {
-                FeatureType feat = mask[addr];
-                // Skip NoRender (Masked Tiles)
-                if (feat == MapFeatureType::NoRender)
-                    continue;
-
-                const ConnectIndex& connectIndex = connections[addr];
-                if (connectIndex == MapTilesConnectType::Void)
-                    continue;
-
-                tile = tiles[addr];
-                if (tile->GetDimensions() < TILE_RENDER)
-                    continue;
-
-                if (containPlateforms)
-                {
-#ifdef RENDER_PLATEFORMS
-                    if (feat == MapFeatureType::RoomPlateForm)
-                    {
-                        if (drawOrder != drawOrderP || tile->GetTerrain() != terrainid)
-                            newcolor = (viewPColor*atlas_->GetTerrain(tile->GetTerrain()).GetColor()).ToUInt();
-                        terrainid = tile->GetTerrain();
-                        drawOrder = drawOrderP;
-                        indexView = indexV + 1;
-                        isRoof = false;
-                    }
-                    else
-                    {
-                        if (drawOrder != drawOrderZ || tile->GetTerrain() != terrainid)
-                            newcolor = (viewZColor*atlas_->GetTerrain(tile->GetTerrain()).GetColor()).ToUInt();
-                        terrainid = tile->GetTerrain();
-                    #ifdef RENDER_ROOFS
-                        isRoof = (feat == MapFeatureType::OuterRoof || feat == MapFeatureType::InnerRoof);
-                    #endif
-                        drawOrder = isRoof ? drawOrderR : drawOrderZ;
-                        indexView = isRoof ? indexV + roofViewModifier : indexV;
-                    }
-#else
-                    if (feat == MapFeatureType::RoomPlateForm)
-                        continue;
-#endif
-                }
-                else
-                {
-                    if (tile->GetTerrain() != terrainid)
-                    {
-                        terrainid = tile->GetTerrain();
-                        newcolor = (viewZColor*atlas_->GetTerrain(terrainid).GetColor()).ToUInt();
-                    }
-#ifdef RENDER_ROOFS
-                    isRoof = (feat == MapFeatureType::OuterRoof || feat == MapFeatureType::InnerRoof);
-                #elif defined(ACTIVE_DUNGEONROOFS)
-                    if (feat == MapFeatureType::OuterRoof || feat == MapFeatureType::InnerRoof)
-                        continue;
-#endif
-                    drawOrder = isRoof ? drawOrderR : drawOrderZ;
-                    indexView = isRoof ? indexV + roofViewModifier : indexV;
-                }
-
-                sprite = tile->GetSprite();
-#ifndef ACTIVE_LAYERMATERIALS
-                material = renderer_->GetMaterial(sprite->GetTexture(), BLEND_ALPHA);
-                if (lastmaterial != material)
-                {
-                    indexM = GetMaterialIndex(material);
-                    lastmaterial = material;
-                }
-#endif
-                if (lasttexture != sprite->GetTexture())
-                {
-                    lasttexture = sprite->GetTexture();
-                    SetTextureMode(TXM_UNIT, material->GetTextureUnit(lasttexture), texmode);
-                    vertex0.texmode_ = vertex1.texmode_ = vertex2.texmode_ = vertex3.texmode_ = texmode;
-                }
-
-                if (newcolor != lastcolor)
-                {
-                    vertex0.color_ = vertex1.color_ = vertex2.color_ = vertex3.color_ = newcolor;
-                    lastcolor = newcolor;
-                }
-
-                // get the good source batch considering chunk, material and plateforms
-                BatchInfo& batchinfo = GetChunkBatchInfo(TILE, indexZ, indexView, indexC, isRoof ? indexMRoof : indexM, drawOrder);
-
-//                if (indexZ == 1 && indexC == 23)
-//                {
-//                    URHO3D_LOGERRORF("... indexZ=%d indexV=%d indexC=%u indexM=%u viewID=%s(%d) addr=%u indexView=%d(%d) draworder=%d(%d) feat=%u batchinfo=%u",
-//                                     indexZ, indexV, indexC, isRoof ? indexMRoof : indexM, ViewManager::GetViewName(viewID).CString(), viewID, addr, indexView, indexV, drawOrder, drawOrderZ, feat, &batchinfo);
-//                }
-
-                const Rect& drawRect = sprite->GetFixedDrawRectangle();
-                const Rect& textureRect = sprite->GetFixedTextRectangle();
-
-                xf = ((float)x - center.x_) * twidth;
-
-                Vector<Vector2>& localpositions = batchinfo.localpositions_;
-                localpositions.Push(Vector2(xf + drawRect.min_.x_, yf + drawRect.min_.y_));
-                localpositions.Push(Vector2(xf + drawRect.min_.x_, yf + drawRect.max_.y_));
-                localpositions.Push(Vector2(xf + drawRect.max_.x_, yf + drawRect.max_.y_));
-                localpositions.Push(Vector2(xf + drawRect.max_.x_, yf + drawRect.min_.y_));
-
-                vertex0.position_ = worldTransform * localpositions[localpositions.Size()-4];
-                vertex1.position_ = worldTransform * localpositions[localpositions.Size()-3];
-                vertex2.position_ = worldTransform * localpositions[localpositions.Size()-2];
-                vertex3.position_ = worldTransform * localpositions[localpositions.Size()-1];
-#ifdef URHO3D_VULKAN
-                vertex0.z_ = vertex1.z_= vertex2.z_ = vertex3.z_ = containPlateforms ? zfplatform : zf;
-#else
-                vertex0.position_.z_ = vertex1.position_.z_= vertex2.position_.z_ = vertex3.position_.z_ = containPlateforms ? zfplatform : zf;
-#endif
-                vertex0.uv_ = textureRect.min_;
-                vertex1.uv_ = Vector2(textureRect.min_.x_, textureRect.max_.y_);
-                vertex2.uv_ = textureRect.max_;
-                vertex3.uv_ = Vector2(textureRect.max_.x_, textureRect.min_.y_);
-
-                Vector<Vertex2D>& vertices = batchinfo.batch_.vertices_;
-                vertices.Push(vertex0);
-                vertices.Push(vertex1);
-                vertices.Push(vertex2);
-                vertices.Push(vertex3);
-            }
-
-            if (TimeOver(timer))
-            {
-                indexStartY_ = y - chunk.startRow + 1;
-                indexChunks_ = c;
-#ifdef DUMP_ERROR_ON_TIMEOVER
-                LogTimeOver(ToString("ObjectTiled() - UpdateTiledBatches : map=%s ... currentViewZ=%d view=%d/%u chunks=%u/%u break at y=%d => ystart=%d",
-                                     node_->GetName().CString(), currentViewZ, indexV+1, viewIds.Size(), indexChunks_, numchunks, y, indexStartY_), timer, delay);
-#endif
-                return false;
-            }
-        }
+    const int height = GetHeight();
 
-        indexStartY_ = 0;
-    }
-#ifdef DUMP_OBJECTTILED_UPDATEINFOS
-    URHO3D_LOGERRORF("ObjectTiled() - UpdateTiledBatches ... currentViewZ=%d view=%d/%u drawOrders=Tile(%u),Plaform(%u) zf=%f ... OK !",
-                     currentViewZ, indexV+1, viewIds.Size(), drawOrderZ, drawOrderP, zf);
-#endif
-    indexChunks_ = numchunks-1;
+    // the last view contains the plateforms and is not masked
+    params.containPlateforms_ = (indexV == (int)viewIds.Size()-1);
+    params.mask_ = params.containPlateforms_ ? &GetObjectFeatured()->GetFeatureView(viewID) : &GetObjectFeatured()->GetMaskedView(indexZ, indexV);
+    params.tiles_ = &GetObjectSkinned()->GetTiledView(viewID);
+    params.connections_ = &GetObjectSkinned()->GetConnectedView(viewID);
+    params.neighborInd_ = neighborInd;
+    for (int dir = 0; dir < 4; dir++)
+        params.borderTerrains_[dir] = &borderTerrains_[dir];
+    params.viewID_ = viewID;
+    params.viewZ_ = GetObjectFeatured()->GetViewZ(viewID);
+    params.currentViewZ_ = currentViewZ;
+    params.indexV_ = indexV;
+    params.width_ = width;
+    params.height_ = height;
+    params.twidth_ = chinfo_->tileWidth_;
+    params.theight_ = chinfo_->tileHeight_;
+    params.center_ = Vector2((float)width * hotspot_.x_, (float)height * hotspot_.y_);
+    params.layermodifier_ = layermodifier_;
+    params.orderInLayer_ = orderInLayer_;
+    params.fluidEnabled_ = GameContext::Get().gameConfig_.fluidEnabled_;
     return true;
 }
 
-inline void ObjectTiled::PushDecalToVertices(int side, unsigned char terrainid, int rand, float xf, float yf, float zf, const Matrix2x3& worldTransform, Vertex2D* vertex, BatchInfo& batchinfo)
-{
-    Sprite2D* sprite = atlas_->GetDecalSprite(terrainid, side, rand+side);
-    const Rect& drawRect = sprite->GetFixedDrawRectangle();
-    const Rect& textureRect = sprite->GetFixedTextRectangle();
-
-    Vector<Vector2>& localpositions = batchinfo.localpositions_;
-    localpositions.Push(Vector2(xf + drawRect.min_.x_, yf + drawRect.min_.y_));
-    localpositions.Push(Vector2(xf + drawRect.min_.x_, yf + drawRect.max_.y_));
-    localpositions.Push(Vector2(xf + drawRect.max_.x_, yf + drawRect.max_.y_));
-    localpositions.Push(Vector2(xf + drawRect.max_.x_, yf + drawRect.min_.y_));
-
-    vertex[0].position_ = worldTransform * localpositions[localpositions.Size()-4];
-    vertex[1].position_ = worldTransform * localpositions[localpositions.Size()-3];
-    vertex[2].position_ = worldTransform * localpositions[localpositions.Size()-2];
-    vertex[3].position_ = worldTransform * localpositions[localpositions.Size()-1];
-
-#ifdef URHO3D_VULKAN
-    for (int i =0; i < 4; i++)
-        vertex[i].z_ = zf;
-#else
-    for (int i =0; i < 4; i++)
-        vertex[i].position_.z_ = zf;
-#endif
-
-    vertex[0].uv_ = textureRect.min_;
-    vertex[1].uv_ = Vector2(textureRect.min_.x_, textureRect.max_.y_);
-    vertex[2].uv_ = textureRect.max_;
-    vertex[3].uv_ = Vector2(textureRect.max_.x_, textureRect.min_.y_);
-
-    Vector<Vertex2D>& vertices = batchinfo.batch_.vertices_;
-    for (int i=0; i<4; i++)
-        vertices.Push(vertex[i]);
-}
-
-// get the terrain id of a tile
-inline unsigned char ObjectTiled::GetTerrainId(const TiledMap& tiles, unsigned addr)
+// get the terrain ids on the border of the connected map in the direction dir (empty if the view doesn't exist in the connected map)
+void ObjectTiled::GetBorderTerrains(int dir, int viewID, PODVector<unsigned char>& terrains)
 {
-    if (!tiles[addr] || tiles[addr] == Tile::EMPTYPTR)
-        return 0;
+    Map* cmap = map_ ? map_->GetConnectedMap(dir) : 0;
+    if (!cmap || viewID >= cmap->GetNumViews())
+    {
+        terrains.Clear();
+        return;
+    }
 
-    // first, get the offset depending on the tile dimension
-    // second, apply the offset to get the tile with the terrainid
-    return tiles[addr+neighborInd[Tile::DimensionNghIndex[tiles[addr]->GetDimensions()]]]->GetTerrain();
+    const int width = GetWidth();
+    const int height = GetHeight();
+    const TiledMap& ctiles = cmap->GetTiledView(viewID);
+    if (dir == MapDirection::West || dir == MapDirection::East)
+    {
+        terrains.Resize(height);
+        for (int y = 0; y < height; y++)
+            terrains[y] = GetTerrainId(ctiles, dir == MapDirection::West ? y * width + width - 1 : y * width);
+    }
+    else
+    {
+        terrains.Resize(width);
+        for (int x = 0; x < width; x++)
+            terrains[x] = GetTerrainId(ctiles, dir == MapDirection::North ? width * (height-1) + x : x);
+    }
 }
 
-bool ObjectTiled::UpdateDecalBatches(const ChunkGroup& chunkGroup, int indexZ, int indexV, HiresTimer* timer, const long long& delay)
+bool ObjectTiled::UpdateChunkViewBatches(MapObjectType type, const ChunkGroup& chunkGroup, int indexZ, int indexV, HiresTimer* timer, const long long& delay)
 {
-    if (TimeOver(timer))
-        return false;
-
-    URHO3D_PROFILE(ObjectTile_DecalBatches);
-
-    const int currentViewZ = ViewManager::Get()->GetViewZ(indexZ);
-    const Vector<int>& viewIds = GetObjectFeatured()->GetViewIDs(currentViewZ);
-    if ((int)viewIds.Size() <= indexV) return true;
-    const int viewID = viewIds[indexV];
-    if (viewID == NOVIEW) return true;
-
-    const bool containPlateforms = (indexV == (int)viewIds.Size()-1);
-    const PODVector<unsigned>& chindex = chunkGroup.chIndexes_;
-    const ChunkInfo* chinfo = chunkGroup.chinfo_;
-    const unsigned numchunks = chunkGroup.numChunks_;
+    ChunkViewParams params;
+    if (!GetChunkViewParams(indexZ, indexV, params))
+        return true;
 
-    const int height = GetHeight();
-    const int width = GetWidth();
-    const int size = height*width;
-    const float twidth = chinfo->tileWidth_;
-    const float theight = chinfo->tileHeight_;
-    const Vector2 center((float)width * hotspot_.x_, (float)height * hotspot_.y_);
-
-    const FeaturedMap& mask = (indexV == (int)viewIds.Size()-1) ? GetObjectFeatured()->GetFeatureView(viewID) : GetObjectFeatured()->GetMaskedView(indexZ, indexV);
-
-    const Matrix2x3& worldTransform = node_->GetWorldTransform2D();
-    const TiledMap& tiles = GetObjectSkinned()->GetTiledView(viewID);
-    const ConnectedMap& connections = GetObjectSkinned()->GetConnectedView(viewID);
-//    const float adjustFactor = 0.8f;
-
-    int viewZ = GetObjectFeatured()->GetViewZ(viewID);
-    int layermodifier = viewZ > INNERVIEW ? layermodifier_ : -layermodifier_;
-
-    float viewcolor = (float)viewZ / (float)currentViewZ;
-    float backmodifier = viewZ == BACKVIEW ? 0.5f : 1.f;
-    Color viewZColor = Color(viewcolor * backmodifier, viewcolor * backmodifier, viewcolor * backmodifier, 1.f);
-    Color viewPColor = Color(viewcolor * 0.6f, viewcolor * 0.6f, viewcolor * 0.6f, 1.f);
-    unsigned newcolor, lastcolor = 0;
-
-    int drawOrderZ = ((viewZ + layermodifier) << 20) + ((orderInLayer_ + LAYER_DECALS) << 10);
-    int drawOrderP = ((viewZ + layermodifier + LAYER_PLATEFORMS) << 20) + ((orderInLayer_ + LAYER_DECALS) << 10);
-
-    const float zf = 1.f -(viewZ + layermodifier) * PIXEL_SIZE;
-    const float zfplatform = 1.f - (viewZ + LAYER_PLATEFORMS) * PIXEL_SIZE;
-
-//    if (currentViewZ == INNERVIEW)
-//    {
-//        drawOrderZ = (viewZ + LAYER_DECALS + INNERVIEWOVERFRONT) << 20;
-//        drawOrderP = ((viewZ + INNERVIEWOVERFRONT + LAYER_PLATEFORMS) << 20);
-//    }
-
-    float xf, yf;
-    unsigned addr;
-    unsigned numbatches = 0;
-    Tile* tile;
-    unsigned char lastterrainid=255, terrainid=0;
-    Sprite2D* sprite;
-    Material *material, *lastmaterial = 0;
-    unsigned indexM;
-#ifdef ACTIVE_LAYERMATERIALS
-//    material = GameContext::Get().layerMaterials_[viewIds.Back() == viewID ? LAYERFRONTSHAPES : LAYERGROUNDS];
-
-    if (GameContext::Get().gameConfig_.fluidEnabled_)
-        material = GameContext::Get().layerMaterials_[viewID == FrontView_ViewId ? LAYERFRONTSHAPES : LAYERGROUNDS];
-    else
-        material = GameContext::Get().layerMaterials_[LAYERGROUNDS];
-
-    indexM = GetMaterialIndex(material);
-#endif
-    Texture2D *lasttexture=0;
-
-#ifdef URHO3D_VULKAN
-    unsigned texmode = 0;
-#else
-    Vector4 texmode;
-#endif
-
-    Vertex2D vertex[4];
-
-    int drawOrder = drawOrderZ;
-    int indexView = indexV;
-
-//    if (chunkGroup.id_ != MapDirection::All && indexChunks_ == 0)
-//    {
-//        URHO3D_LOGINFOF("ObjectTiled() - UpdateDecalBatches ... currentViewZ=%d view=%d/%u indexChunks=%u/%u ...",
-//                        currentViewZ, indexV+1, viewIds.Size(), indexChunks_+1, numchunks);
-//        DumpData(&connections[0], -1, 2, width, height);
-//    }
-
-    for (unsigned c = indexChunks_; c < numchunks; c++)
+    if (type == SEWING)
     {
-        unsigned indexC = chindex[c];
-        const Chunk& chunk = chinfo->chunks_[indexC];
-
-//        URHO3D_LOGINFOF("ObjectTiled() - UpdateDecalBatches ... Update chunk=%u chunkrow=%d to %d chunkcol=%d to %d...",
-//                            c, chunk.startRow, chunk.endRow, chunk.startCol, chunk.endCol);
-
-        // Be sure to check BatchInfo Dirty for each Material to clear batches for the case of "CREATEMODE : remove the last tile in a chunk"
-        if (indexStartY_ == 0)
-        {
-            ClearBatchVertices(DECAL, indexZ, indexV, indexC);
-            if (containPlateforms)
-                ClearBatchVertices(DECAL, indexZ, indexV+1, indexC);
-
-#ifdef DUMP_ERROR_ON_TIMEOVER
-            if (timer)
-                LogTimeOver(ToString("ObjectTiled() - UpdateDecalBatches : map=%s ... currentViewZ=%d view=%d/%u chunks=%u/%u Clearing Vertices", node_->GetName().CString(), currentViewZ, indexV+1, viewIds.Size(), indexChunks_, numchunks), timer, delay);
-#endif
-        }
-
-        for (int y=chunk.startRow + indexStartY_; y < chunk.endRow; y++)
-        {
-            addr = y * width + chunk.startCol;
-
-            yf = ((float)height - y - center.y_) * theight;
-
-            for (int x=chunk.startCol; x < chunk.endCol; x++,addr++)
-            {
-                if (mask[addr] <= MapFeatureType::NoRender)
-                    continue;
-
-                const ConnectIndex& connectIndex = connections[addr];
-                if (connectIndex == MapTilesConnectType::Void)
-                    continue;
-
-                terrainid = GetTerrainId(tiles, addr);
-
-                if (!atlas_->GetTerrain(terrainid).UseDecals())
-                    continue;
-
-                if (containPlateforms)
-                {
-#ifdef RENDER_PLATEFORMS
-                    if (mask[addr] == MapFeatureType::RoomPlateForm)
-                    {
-                        if (drawOrder != drawOrderP || terrainid != lastterrainid)
-                            newcolor = (viewPColor*atlas_->GetTerrain(terrainid).GetColor()).ToUInt();
-                        lastterrainid = terrainid;
-                        drawOrder = drawOrderP;
-                        indexView = indexV + 1;
-                    }
-                    else
-                    {
-                        if (drawOrder != drawOrderZ || terrainid != lastterrainid)
-                            newcolor = (viewZColor*atlas_->GetTerrain(terrainid).GetColor()).ToUInt();
-                        lastterrainid = terrainid;
-                        drawOrder = drawOrderZ;
-                        indexView = indexV;
-                    }
-#else
-                    if (mask[addr] == MapFeatureType::RoomPlateForm)
-                        continue;
-#endif
-                }
-                else
-                {
-                    if (terrainid != lastterrainid)
-                    {
-                        lastterrainid = terrainid;
-                        newcolor = (viewZColor*atlas_->GetTerrain(terrainid).GetColor()).ToUInt();
-                    }
-                }
-
-                sprite = atlas_->GetDecalSprite(terrainid, 1, addr);
-#ifndef ACTIVE_LAYERMATERIALS
-                material = renderer_->GetMaterial(sprite->GetTexture(), BLEND_ALPHA);
-                if (lastmaterial != material)
-                {
-                    indexM = GetMaterialIndex(material);
-                    lastmaterial = material;
-                }
-#endif
-                if (lasttexture != sprite->GetTexture())
-                {
-                    lasttexture = sprite->GetTexture();
-                    SetTextureMode(TXM_UNIT, material->GetTextureUnit(lasttexture), texmode);
-                    vertex[0].texmode_ = vertex[1].texmode_ = vertex[2].texmode_ = vertex[3].texmode_ = texmode;
-                }
-
-                if (newcolor != lastcolor)
-                {
-                    vertex[0].color_ = vertex[1].color_ = vertex[2].color_ = vertex[3].color_ = newcolor;
-                    lastcolor = newcolor;
-                }
-
-                xf = ((float)x - center.x_) * twidth;
-
-                // get the good source batch considering chunk, material and plateforms
-                BatchInfo& batchinfo = GetChunkBatchInfo(DECAL, indexZ, indexView, indexC, indexM, drawOrder);
-
-                if ((connectIndex & LeftSide) == 0 || (x > 0 && mask[addr-1] == MapFeatureType::RoomPlateForm && mask[addr] != MapFeatureType::RoomPlateForm))
-                    PushDecalToVertices(LeftSide, terrainid, addr, xf, yf-0.5f*theight, containPlateforms ? zfplatform : zf, worldTransform, vertex, batchinfo);
-
-                if ((connectIndex & RightSide) == 0 || (x < width-1 && mask[addr+1] == MapFeatureType::RoomPlateForm && mask[addr] != MapFeatureType::RoomPlateForm))
-                    PushDecalToVertices(RightSide, terrainid, addr, xf+twidth, yf-0.5f*theight, containPlateforms ? zfplatform : zf, worldTransform, vertex, batchinfo);
-
-                if ((connectIndex & TopSide) == 0 || (y > 0 && mask[addr-width] == MapFeatureType::RoomPlateForm && mask[addr] != MapFeatureType::RoomPlateForm))
-                    PushDecalToVertices(TopSide, terrainid, addr, xf+0.5f*twidth, yf, containPlateforms ? zfplatform : zf, worldTransform, vertex, batchinfo);
-
-                if ((connectIndex & BottomSide) == 0 || (y < height-1 && mask[addr+width] == MapFeatureType::RoomPlateForm && mask[addr] != MapFeatureType::RoomPlateForm))
-                    PushDecalToVertices(BottomSide, terrainid, addr, xf+0.5f*twidth, yf-1.f*theight, containPlateforms ? zfplatform : zf, worldTransform, vertex, batchinfo);
-            }
-
-            if (TimeOver(timer))
-            {
-                indexStartY_ = y - chunk.startRow + 1;
-                indexChunks_ = c;
-#ifdef DUMP_ERROR_ON_TIMEOVER
-                LogTimeOver(ToString("ObjectTiled() - UpdateDecalBatches : map=%s ... currentViewZ=%d view=%d/%u chunks=%u/%u y=%d", node_->GetName().CString(), currentViewZ, indexV+1, viewIds.Size(), indexChunks_, numchunks, y), timer, delay);
-#endif
-                return false;
-            }
-        }
-
-        indexStartY_ = 0;
+        for (int dir = 0; dir < 4; dir++)
+            GetBorderTerrains(dir, params.viewID_, borderTerrains_[dir]);
     }
-#ifdef DUMP_OBJECTTILED_UPDATEINFOS
-    URHO3D_LOGINFOF("ObjectTiled() - UpdateDecalBatches ... currentViewZ=%d view=%d/%u drawOrders=%u,%u ... OK !", currentViewZ, indexV+1, viewIds.Size(), drawOrder, drawOrderP);
-#endif
-    indexChunks_ = numchunks-1;
-    return true;
-}
-
-bool ObjectTiled::UpdateSewingBatches(const ChunkGroup& chunkGroup, int indexZ, int indexV, HiresTimer* timer, const long long& delay)
-{
-    if (TimeOver(timer))
-        return false;
-
-    URHO3D_PROFILE(ObjectTile_SewingBatches);
-
-    const int currentViewZ = ViewManager::Get()->GetViewZ(indexZ);
-    const Vector<int>& viewIds = GetObjectFeatured()->GetViewIDs(currentViewZ);
-    if ((int)viewIds.Size() <= indexV) return true;
-    const int viewID = viewIds[indexV];
-    if (viewID == NOVIEW) return true;
-
-    const bool containPlateforms = (indexV == (int)viewIds.Size()-1);
-    const PODVector<unsigned>& chindex = chunkGroup.chIndexes_;
-    const ChunkInfo* chinfo = chunkGroup.chinfo_;
-    const unsigned numchunks = chunkGroup.numChunks_;
-
-    const int height = GetHeight();
-    const int width = GetWidth();
-    const int size = height*width;
-    const float twidth = chinfo->tileWidth_;
-    const float theight = chinfo->tileHeight_;
-    const Vector2 center((float)width * hotspot_.x_, (float)height * hotspot_.y_);
-
-    const FeaturedMap& mask = (indexV == (int)viewIds.Size()-1) ? GetObjectFeatured()->GetFeatureView(viewID) : GetObjectFeatured()->GetMaskedView(indexZ, indexV);
-
-    const Matrix2x3& worldTransform = node_->GetWorldTransform2D();
-    const TiledMap& tiles = GetObjectSkinned()->GetTiledView(viewID);
-    const ConnectedMap& connections = GetObjectSkinned()->GetConnectedView(viewID);
-
-    int viewZ = GetObjectFeatured()->GetViewZ(viewID);
-    int layermodifier = viewZ > INNERVIEW ? layermodifier_ : -layermodifier_;
-
-    float viewcolor = (float)viewZ / (float)currentViewZ;
-    float backmodifier = viewZ == BACKVIEW ? 0.5f : 1.f;
-    Color viewSColor = Color(viewcolor * backmodifier, viewcolor * backmodifier, viewcolor * backmodifier, 0.65f);
-    unsigned newcolor, lastcolor = 0;
-
-    int drawOrderP = ((viewZ + layermodifier + LAYER_PLATEFORMS) << 20) + ((orderInLayer_ + LAYER_SEWINGS) << 10);
-//    if (currentViewZ == INNERVIEW)
-//        drawOrderP = ((viewZ + LAYER_PLATEFORMS + INNERVIEWOVERFRONT) << 20) + 1;
-    int drawOrderS = ((viewZ + layermodifier) << 20) + ((orderInLayer_ + LAYER_SEWINGS) << 10);
-//    if (currentViewZ == INNERVIEW)
-//        drawOrderS = ((viewZ + INNERVIEWOVERFRONT) << 20) + 1;
-    int drawOrderSewing = drawOrderS;
-    int indexView = indexV;
-    unsigned indexM;
-
-    float xf, yf;
-    unsigned addr;
-    Tile* tile;
-    Sprite2D* sprite;
-    unsigned char lastterrainid=255, terrainid1=0, terrainid2=0;
-    Material *material, *lastmaterial = 0;
-#ifdef ACTIVE_LAYERMATERIALS
-    material = GameContext::Get().layerMaterials_[LAYERGROUNDS];
-    indexM = GetMaterialIndex(material);
-#endif
-    Vertex2D vertex[4];
-    BatchInfo* batchinfo = 0;
-    Texture2D *lasttexture=0;
-
-#ifdef URHO3D_VULKAN
-    unsigned texmode = 0;
-#else
-    Vector4 texmode;
-#endif
-
-#ifdef DUMP_OBJECTTILED_UPDATEINFOS
-    URHO3D_LOGINFOF("ObjectTiled() - UpdateSewingBatches ... map=%s chgrp=%d currentViewZ=%d view=%s(z=%d) (%d/%u) ...", map_->GetMapPoint().ToString().CString(), chunkGroup.id_, currentViewZ, mapViewsNames[viewID], viewZ, indexV+1, viewIds.Size());
-#endif
-
-    for (unsigned c = indexChunks_; c < numchunks; c++)
-    {
-        unsigned indexC = chindex[c];
-        const Chunk& chunk = chinfo->chunks_[indexC];
-//        URHO3D_LOGINFOF("ObjectTiled() - UpdateSewingBatches ... Update chunk=%u chunkrow=%d to %d chunkcol=%d to %d...",
-//                            c, chunk.startRow, chunk.endRow, chunk.startCol, chunk.endCol);
-
-        // Be sure to check BatchInfo Dirty for each Material to clear batches for the case of "CREATEMODE : remove the last tile in a chunk"
-        if (indexStartY_ == 0)
-        {
-            ClearBatchVertices(SEWING, indexZ, indexV, indexC);
-            if (containPlateforms)
-                ClearBatchVertices(SEWING, indexZ, indexV+1, indexC);
-
-#ifdef DUMP_ERROR_ON_TIMEOVER
-            if (timer)
-                LogTimeOver(ToString("ObjectTiled() - UpdateSewingBatches : map=%s ... currentViewZ=%d view=%d/%u chunks=%u/%u Clearing Vertices", node_->GetName().CString(), currentViewZ, indexV+1, viewIds.Size(), indexChunks_, numchunks), timer, delay);
-#endif
-        }
-
-        for (int y=chunk.startRow + indexStartY_; y < chunk.endRow; y++)
-        {
-            addr = y * width + chunk.startCol;
-
-            yf = ((float)height - y - center.y_) * theight;
-
-            for (int x=chunk.startCol; x < chunk.endCol; x++,addr++)
-            {
-                if (mask[addr] <= MapFeatureType::NoRender)
-                    continue;
-
-                const ConnectIndex& connectIndex = connections[addr];
-                if (connectIndex == MapTilesConnectType::Void)
-                    continue;
-
-                terrainid1 = GetTerrainId(tiles, addr);
-
-                if (!atlas_->GetTerrain(terrainid1).UseDecals())
-                    continue;
-
-                if (containPlateforms)
-                {
-#ifdef RENDER_PLATEFORMS
-                    if (mask[addr] == MapFeatureType::RoomPlateForm)
-                    {
-                        if (drawOrderSewing != drawOrderP || terrainid1 != lastterrainid)
-                            newcolor = (viewSColor*atlas_->GetTerrain(terrainid1).GetColor()).ToUInt();
-                        lastterrainid = terrainid1;
-                        drawOrderSewing = drawOrderP;
-                        indexView = indexV + 1;
-                    }
-                    else
-                    {
-                        if (drawOrderSewing != drawOrderS || terrainid1 != lastterrainid)
-                            newcolor = (viewSColor*atlas_->GetTerrain(terrainid1).GetColor()).ToUInt();
-                        lastterrainid = terrainid1;
-                        drawOrderSewing = drawOrderS;
-                        indexView = indexV;
-                    }
-#else
-                    if (mask[addr] == MapFeatureType::RoomPlateForm)
-                        continue;
-#endif
-                }
-                else
-                {
-                    if (drawOrderSewing != drawOrderS || terrainid1 != lastterrainid)
-                        newcolor = (viewSColor*atlas_->GetTerrain(terrainid1).GetColor()).ToUInt();
-                    if (terrainid1 != lastterrainid)
-                    {
-                        lastterrainid = terrainid1;
-                        drawOrderSewing = drawOrderS;
-                        indexView = indexV;
-                    }
-                }
-
-                sprite = atlas_->GetDecalSprite(terrainid1, 1, addr);
-#ifndef ACTIVE_LAYERMATERIALS
-                material = renderer_->GetMaterial(sprite->GetTexture(), BLEND_ALPHA);
-                if (lastmaterial != material)
-                {
-                    indexM = GetMaterialIndex(material);
-                    lastmaterial = material;
-                }
-#endif
-                if (lasttexture != sprite->GetTexture())
-                {
-                    lasttexture = sprite->GetTexture();
-                    SetTextureMode(TXM_UNIT, material->GetTextureUnit(lasttexture), texmode);
-                    vertex[0].texmode_ = vertex[1].texmode_ = vertex[2].texmode_ = vertex[3].texmode_ = texmode;
-                }
-
-                if (newcolor != lastcolor)
-                {
-                    vertex[0].color_ = vertex[1].color_ = vertex[2].color_ = vertex[3].color_ = newcolor;
-                    lastcolor = newcolor;
-                }
-
-                xf = ((float)x - center.x_) * twidth;
-
-                batchinfo = 0;
-
-                if ((connectIndex & LeftSide) != 0)
-                {
-                    if (x == 0)
-                    {
-                        // check if viewid is also in connectmap (just check the num of views : cave(3)/dungeon(5)
-                        // for example : if cmap is cavetype and map is dungeontype and if viewid=3-backview (there no backview in cave)
-                        //               then in this case, terrainid2 equal 0 and sewing is made.
-                        Map* cmap = map_->GetConnectedMap(MapDirection::West);
-                        terrainid2 = cmap && viewID < cmap->GetNumViews() ? GetTerrainId(cmap->GetTiledView(viewID), addr + width - 1) : 0;
-                    }
-                    else
-                    {
-                        terrainid2 = GetTerrainId(tiles, addr-1);
-                    }
-
-                    if (terrainid1 > terrainid2)
-                    {
-                        if (!batchinfo)
-                            batchinfo = &GetChunkBatchInfo(SEWING, indexZ, indexView, indexC, indexM, drawOrderSewing);
-                        PushDecalToVertices(LeftSide, terrainid1, addr, xf, yf-0.5f*theight, 1.f, worldTransform, vertex, *batchinfo);
-                    }
-                }
-
-                if ((connectIndex & RightSide) != 0)
-                {
-                    if (x == width-1)
-                    {
-                        Map* cmap = map_->GetConnectedMap(MapDirection::East);
-                        terrainid2 = cmap && viewID < cmap->GetNumViews() ?  GetTerrainId(cmap->GetTiledView(viewID), addr - width + 1) : 0;
-                    }
-                    else
-                    {
-                        terrainid2 = GetTerrainId(tiles, addr+1);
-                    }
 
-                    if (terrainid1 > terrainid2)
-                    {
-                        if (!batchinfo)
-                            batchinfo = &GetChunkBatchInfo(SEWING, indexZ, indexView, indexC, indexM, drawOrderSewing);
-                        PushDecalToVertices(RightSide, terrainid1, addr, xf+twidth, yf-0.5f*theight, 1.f, worldTransform, vertex, *batchinfo);
-                    }
-                }
+    const PODVector<unsigned>& chindex = chunkGroup.chIndexes_;
+    const ChunkInfo* chinfo = chunkGroup.chinfo_;
+    const unsigned numchunks = chunkGroup.numChunks_;
 
-                if ((connectIndex & TopSide) != 0)
-                {
-                    if (y == 0)
-                    {
-                        Map* cmap = map_->GetConnectedMap(MapDirection::North);
-                        terrainid2 = cmap && viewID < cmap->GetNumViews() ? GetTerrainId(cmap->GetTiledView(viewID), width * (height-1) + x) : 0;
-                    }
-                    else
-                    {
-                        terrainid2 = GetTerrainId(tiles, addr-width);
-                    }
+    ChunkViewGenerator generator(params, type);
+    ChunkBatchInfoSink sink(*this, indexZ);
 
-                    if (terrainid1 > terrainid2)
-                    {
-                        if (!batchinfo)
-                            batchinfo = &GetChunkBatchInfo(SEWING, indexZ, indexView, indexC, indexM, drawOrderSewing);
-                        PushDecalToVertices(TopSide, terrainid1, addr, xf+0.5f*twidth, yf, 1.f, worldTransform, vertex, *batchinfo);
-                    }
-                }
+#ifdef DUMP_OBJECTTILED_UPDATEINFOS
+    URHO3D_LOGINFOF("ObjectTiled() - UpdateChunkViewBatches ... type=%d currentViewZ=%d(indexZ=%d) viewid=%d(%d) chunk=%u/%u ... start at ystart=%d ...",
+                    type, params.currentViewZ_, indexZ, params.viewID_, indexV+1, indexChunks_+1, numchunks, indexStartY_);
+#endif
 
-                if ((connectIndex & BottomSide) != 0)
-                {
-                    if (y == height-1)
-                    {
-                        Map* cmap = map_->GetConnectedMap(MapDirection::South);
-                        terrainid2 = cmap && viewID < cmap->GetNumViews() ? GetTerrainId(cmap->GetTiledView(viewID), x) : 0;
-                    }
-                    else
-                    {
-                        terrainid2 = GetTerrainId(tiles, addr+width);
-                    }
+    for (unsigned c = indexChunks_; c < numchunks; c++)
+    {
+        const unsigned indexC = chindex[c];
+        const Chunk& chunk = chinfo->chunks_[indexC];
 
-                    if (terrainid1 > terrainid2)
-                    {
-                        if (!batchinfo)
-                            batchinfo = &GetChunkBatchInfo(SEWING, indexZ, indexView, indexC, indexM, drawOrderSewing);
-                        PushDecalToVertices(BottomSide, terrainid1, addr, xf+0.5f*twidth, yf-theight, 1.f, worldTransform, vertex, *batchinfo);
-                    }
-                }
+        // Be sure to check BatchInfo Dirty for each Material to clear batches for the case of "CREATEMODE : remove the last tile in a chunk"
+        if (indexStartY_ == 0)
+        {
+#ifdef RENDER_ROOFS
+            if (type == TILE)
+            {
+                ClearBatchVertices(TILE, indexZ, indexV-1, indexC);
+                if (!params.containPlateforms_)
+                    ClearBatchVertices(TILE, indexZ, indexV+1, indexC);
             }
+#endif
+            ClearBatchVertices(type, indexZ, indexV, indexC);
+            if (params.containPlateforms_)
+                ClearBatchVertices(type, indexZ, indexV+1, indexC);
+
+#ifdef DUMP_ERROR_ON_TIMEOVER
+            if (timer)
+                LogTimeOver(ToString("ObjectTiled() - UpdateChunkViewBatches : map=%s ... type=%d currentViewZ=%d view=%d chunks=%u/%u Clearing Vertices",
+                                     node_->GetName().CString(), type, params.currentViewZ_, indexV+1, indexChunks_, numchunks), timer, delay);
+#endif
+        }
 
-            if (y+1 < chunk.endRow && TimeOver(timer))
+        sink.indexC_ = indexC;
+
+        for (int y=chunk.startRow + indexStartY_; y < chunk.endRow; y++)
+        {
+            generator.GenerateRow(chunk, y, sink);
+
+            if (TimeOver(timer))
             {
                 indexStartY_ = y - chunk.startRow + 1;
                 indexChunks_ = c;
 #ifdef DUMP_ERROR_ON_TIMEOVER
-                LogTimeOver(ToString("ObjectTiled() - UpdateSewingBatches : map=%s ... currentViewZ=%d view=%d/%u chunks=%u/%u y=%d", node_->GetName().CString(), currentViewZ, indexV+1, viewIds.Size(), indexChunks_, numchunks, y), timer, delay);
+                LogTimeOver(ToString("ObjectTiled() - UpdateChunkViewBatches : map=%s ... type=%d currentViewZ=%d view=%d chunks=%u/%u break at y=%d => ystart=%d",
+                                     node_->GetName().CString(), type, params.currentViewZ_, indexV+1, indexChunks_, numchunks, y, indexStartY_), timer, delay);
 #endif
                 return false;
             }
@@ -1893,13 +1910,44 @@ bool ObjectTiled::UpdateSewingBatches(const ChunkGroup& chunkGroup, int indexZ,
 
         indexStartY_ = 0;
     }
+
 #ifdef DUMP_OBJECTTILED_UPDATEINFOS
-    URHO3D_LOGINFOF("ObjectTiled() - UpdateSewingBatches ... currentViewZ=%d view=%d/%u ... OK !", currentViewZ, indexV+1, viewIds.Size());
+    URHO3D_LOGINFOF("ObjectTiled() - UpdateChunkViewBatches ... type=%d currentViewZ=%d view=%d ... OK !", type, params.currentViewZ_, indexV+1);
 #endif
     indexChunks_ = numchunks-1;
     return true;
 }
 
+bool ObjectTiled::UpdateTiledBatches(const ChunkGroup& chunkGroup, int indexZ, int indexV, HiresTimer* timer, const long long& delay)
+{
+    if (TimeOver(timer))
+        return false;
+
+    URHO3D_PROFILE(ObjectTile_TileBatches);
+
+    return UpdateChunkViewBatches(TILE, chunkGroup, indexZ, indexV, timer, delay);
+}
+
+bool ObjectTiled::UpdateDecalBatches(const ChunkGroup& chunkGroup, int indexZ, int indexV, HiresTimer* timer, const long long& delay)
+{
+    if (TimeOver(timer))
+        return false;
+
+    URHO3D_PROFILE(ObjectTile_DecalBatches);
+
+    return UpdateChunkViewBatches(DECAL, chunkGroup, indexZ, indexV, timer, delay);
+}
+
+bool ObjectTiled::UpdateSewingBatches(const ChunkGroup& chunkGroup, int indexZ, int indexV, HiresTimer* timer, const long long& delay)
+{
+    if (TimeOver(timer))
+        return false;
+
+    URHO3D_PROFILE(ObjectTile_SewingBatches);
+
+    return UpdateChunkViewBatches(SEWING, chunkGroup, indexZ, indexV, timer, delay);
+}
+
 #else
 
 bool ObjectTiled::UpdateTiledBatches(const ChunkGroup& chunkGroup, int indexZ, int indexV, HiresTimer* timer, const long long& delay)
@@ -3090,6 +3138,22 @@ bool ObjectTiled::UpdateChunkGroup(const ChunkGroup& chunkGroup, HiresTimer* tim
 
 bool ObjectTiled::UpdateDirtyChunks(HiresTimer* timer, const long long& delay)
 {
+#if defined(ACTIVE_OBJECTTILED_THREADING) && !defined(USE_CHUNKBATCH)
+    if (timer && (chunkBuildRunning_ || (dirtyChunkGroups_.Size() && UseChunkBuildJobs())))
+    {
+        // the workers don't consume the frame budget : only stop the maps updating loop if the mask views are time over
+        UpdateChunkBuilds(timer, delay);
+        return !TimeOver(timer, delay);
+    }
+
+    // instant update : finish the running jobs before updating in the main thread
+    if (chunkBuildRunning_)
+    {
+        WaitChunkBuildJobs();
+        ApplyChunkBuildJobs();
+    }
+#endif
+
     if (!dirtyChunkGroups_.Size())
     {
 //        URHO3D_LOGINFOF("ObjectTiled() - UpdateDirtyChunks %s no diry chunks to update !", node_->GetName().CString());
@@ -3136,6 +3200,347 @@ bool ObjectTiled::UpdateDirtyChunks(HiresTimer* timer, const long long& delay)
     return false;
 }
 
+#if defined(ACTIVE_OBJECTTILED_THREADING) && !defined(USE_CHUNKBATCH)
+
+bool ObjectTiled::UseChunkBuildJobs() const
+{
+    WorkQueue* queue = GameContext::Get().gameWorkQueue_;
+    // dynamic objects move their vertices each frame : keep them in the main thread
+    return chunkBuildThreading_ && !isDynamic_ && queue && queue->GetNumThreads() > 0;
+}
+
+void ObjectTiled::AddChunkBuilds(const ChunkGroup& chunkGroup)
+{
+    const PODVector<unsigned>& chindex = chunkGroup.chIndexes_;
+    for (unsigned c = 0; c < chunkGroup.numChunks_; c++)
+    {
+        if (!chunkBuildIndexes_.Contains(chindex[c]))
+            chunkBuildIndexes_.Push(chindex[c]);
+    }
+}
+
+/// copy the rows of a view read by the jobs, the other rows of the snapshot buffer are not read
+template <class T> void CopySnapshotRows(const PODVector<T>& src, PODVector<T>& dst, const ChunkBuildSnapshot& snap)
+{
+    dst.Resize(src.Size());
+    if (src.Size() < (unsigned)(snap.width_ * snap.height_))
+        return;
+
+    for (int y = 0; y < snap.height_; y++)
+    {
+        if (snap.rowsUsed_[y])
+            memcpy(dst.Buffer() + y * snap.width_, src.Buffer() + y * snap.width_, snap.width_ * sizeof(T));
+    }
+}
+
+void ObjectTiled::PrepareChunkBuildSnapshot()
+{
+    URHO3D_PROFILE(ObjectTile_BuildSnapshot);
+
+    ChunkBuildSnapshot& snap = chunkBuildSnapshot_;
+    ObjectFeatured* featured = GetObjectFeatured();
+    ObjectSkinned* skinned = GetObjectSkinned();
+
+    snap.chinfo_ = chinfo_;
+    snap.width_ = GetWidth();
+    snap.height_ = GetHeight();
+    snap.twidth_ = chinfo_->tileWidth_;
+    snap.theight_ = chinfo_->tileHeight_;
+    snap.center_ = Vector2((float)snap.width_ * hotspot_.x_, (float)snap.height_ * hotspot_.y_);
+    snap.worldTransform_ = node_->GetWorldTransform2D();
+    snap.layermodifier_ = layermodifier_;
+    snap.orderInLayer_ = orderInLayer_;
+    snap.tilesEnable_ = tilesEnable_;
+    snap.decalsEnable_ = decalsEnable_ && skinned->UseDimensionTiles();
+    snap.fluidEnabled_ = GameContext::Get().gameConfig_.fluidEnabled_;
+    snap.numviews_ = numviews_;
+    for (int i=0; i < 9; i++)
+        snap.neighborInd_[i] = neighborInd[i];
+
+    const int numViewZ = ViewManager::Get()->GetNumViewZ();
+    const unsigned numViews = skinned->GetNumViews();
+
+    // the rows read by the dirty chunks : the rows of the chunks and one row around for the neighbor tiles
+    snap.rowsUsed_.Resize(snap.height_);
+    memset(snap.rowsUsed_.Buffer(), 0, snap.height_);
+    for (unsigned i = 0; i < chunkBuildIndexes_.Size(); i++)
+    {
+        const Chunk& chunk = chinfo_->chunks_[chunkBuildIndexes_[i]];
+        const int endRow = Min(chunk.endRow+1, snap.height_);
+        for (int y = Max(chunk.startRow-1, 0); y < endRow; y++)
+            snap.rowsUsed_[y] = 1;
+    }
+
+    // the views read by the jobs
+    snap.viewsUsed_.Resize(numViews);
+    memset(snap.viewsUsed_.Buffer(), 0, numViews);
+
+    snap.currentViewZs_.Resize(numViewZ);
+    snap.viewIds_.Resize(numViewZ);
+    snap.masks_.Resize(numViewZ);
+    for (int indexZ = 0; indexZ < numViewZ; indexZ++)
+    {
+        const int currentViewZ = ViewManager::Get()->GetViewZ(indexZ);
+        const Vector<int>& viewIds = featured->GetViewIDs(currentViewZ);
+        const unsigned numIds = viewIds.Size();
+
+        snap.currentViewZs_[indexZ] = currentViewZ;
+        snap.viewIds_[indexZ].Resize(numIds);
+        snap.masks_[indexZ].Resize(numIds);
+        for (unsigned indexV = 0; indexV < numIds; indexV++)
+        {
+            snap.viewIds_[indexZ][indexV] = viewIds[indexV];
+            if (viewIds[indexV] == NOVIEW || indexV >= numviews_)
+                continue;
+            snap.viewsUsed_[viewIds[indexV]] = 1;
+            // the last view contains the plateforms and is not masked
+            CopySnapshotRows(indexV == viewIds.Size()-1 ? featured->GetFeatureView(viewIds[indexV]) : featured->GetMaskedView(indexZ, indexV), snap.masks_[indexZ][indexV], snap);
+        }
+    }
+
+    // copy the rows of the used views : the buffers keep their capacity between the builds
+    snap.viewZs_.Resize(numViews);
+    snap.tiledViews_.Resize(numViews);
+    snap.connectedViews_.Resize(numViews);
+    for (unsigned viewID = 0; viewID < numViews; viewID++)
+    {
+        snap.viewZs_[viewID] = featured->GetViewZ(viewID);
+        if (!snap.viewsUsed_[viewID])
+            continue;
+        CopySnapshotRows(skinned->GetTiledView(viewID), snap.tiledViews_[viewID], snap);
+        CopySnapshotRows(skinned->GetConnectedView(viewID), snap.connectedViews_[viewID], snap);
+    }
+
+    // terrains of the connected maps used by the sewings
+    for (int dir = 0; dir < 4; dir++)
+    {
+        Vector<PODVector<unsigned char> >& borderTerrains = snap.borderTerrains_[dir];
+        borderTerrains.Resize(numViews);
+        for (unsigned viewID = 0; viewID < numViews; viewID++)
+        {
+            if (snap.decalsEnable_ && snap.viewsUsed_[viewID])
+                GetBorderTerrains(dir, viewID, borderTerrains[viewID]);
+            else
+                borderTerrains[viewID].Clear();
+        }
+    }
+}
+
+void ObjectTiled::StartChunkBuildJobs()
+{
+    if (!chunkBuildIndexes_.Size())
+        return;
+
+    PrepareChunkBuildSnapshot();
+
+    WorkQueue* queue = GameContext::Get().gameWorkQueue_;
+
+    queue->Pause();
+
+    chunkBuildJobs_.Resize(chunkBuildIndexes_.Size());
+    for (unsigned i = 0; i < chunkBuildIndexes_.Size(); i++)
+    {
+        ChunkBuildJob& job = chunkBuildJobs_[i];
+        job.snapshot_ = &chunkBuildSnapshot_;
+        job.indexC_ = chunkBuildIndexes_[i];
+        job.numRunning_ = &numChunkBuildJobsRunning_;
+
+        job.item_ = queue->GetFreeItem();
+        job.item_->sendEvent_ = false;
+        job.item_->priority_ = OBJECTTILED_WORKITEM_PRIORITY;
+        job.item_->workFunction_ = ChunkBuildThread;
+        job.item_->aux_ = &job;
+    }
+
+    numChunkBuildJobsRunning_.store(chunkBuildJobs_.Size(), std::memory_order_relaxed);
+
+    for (unsigned i = 0; i < chunkBuildJobs_.Size(); i++)
+        queue->AddWorkItem(chunkBuildJobs_[i].item_);
+
+    queue->Resume();
+
+#ifdef DUMP_OBJECTTILED_UPDATEINFOS
+    URHO3D_LOGINFOF("ObjectTiled() - StartChunkBuildJobs %s ... numJobs=%u", node_->GetName().CString(), chunkBuildJobs_.Size());
+#endif
+
+    chunkBuildIndexes_.Clear();
+    chunkBuildRunning_ = true;
+}
+
+bool ObjectTiled::ChunkBuildJobsFinished() const
+{
+    // acquire : pairs with the release of ChunkBuildThread, the batches of the jobs are complete
+    return numChunkBuildJobsRunning_.load(std::memory_order_acquire) == 0;
+}
+
+void ObjectTiled::WaitChunkBuildJobs()
+{
+    if (!chunkBuildRunning_ || ChunkBuildJobsFinished())
+        return;
+
+    // the jobs not yet taken by the workers are built here : the other items of the queue are not run by this wait
+    WorkQueue* queue = GameContext::Get().gameWorkQueue_;
+    for (unsigned i = 0; i < chunkBuildJobs_.Size(); i++)
+    {
+        ChunkBuildJob& job = chunkBuildJobs_[i];
+        if (job.item_ && job.item_->aux_ == &job && queue->RemoveWorkItem(job.item_))
+        {
+            job.Build();
+            numChunkBuildJobsRunning_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    // only the jobs in progress in the workers remain
+    // acquire : pairs with the release of ChunkBuildThread
+    while (numChunkBuildJobsRunning_.load(std::memory_order_acquire) != 0)
+        Time::Sleep(0);
+}
+
+void ObjectTiled::ApplyChunkBuildJobs()
+{
+    URHO3D_PROFILE(ObjectTile_ApplyChunkBuilds);
+
+    if (!chunkBuildRunning_)
+        return;
+
+    chunkBuildRunning_ = false;
+
+    const int numViewZ = ViewManager::Get()->GetNumViewZ();
+
+    // Clear the previous vertices of the rebuilt chunks
+    for (unsigned i = 0; i < chunkBuildJobs_.Size(); i++)
+    {
+        const unsigned indexC = chunkBuildJobs_[i].indexC_;
+        for (int indexZ = 0; indexZ < numViewZ; indexZ++)
+        {
+            for (int indexV = 0; indexV <= (int)numviews_; indexV++)
+            {
+                unsigned basekey = GetBaseBatchInfoKey(indexZ, indexV);
+                for (unsigned m = 0; m < viewMaterialsTable_.Size(); m++)
+                    for (int type = 0; type < NUM_MAPOBJECTTYPE; type++)
+                    {
+                        BatchInfo* binfo = GetChunkBatchInfoBased((MapObjectType)type, basekey, indexC, m);
+                        if (!binfo)
+                            continue;
+                        binfo->dirty_ = true;
+                        binfo->localpositions_.Clear();
+                        binfo->batch_.vertices_.Clear();
+                    }
+            }
+        }
+    }
+
+#ifdef ACTIVE_LAYERMATERIALS
+    // keep the same material indexes than UpdateTiledBatches
+    GetMaterialIndex(GameContext::Get().layerMaterials_[LAYERGROUNDS]);
+    const unsigned indexMRoof = GetMaterialIndex(GameContext::Get().layerMaterials_[LAYERGROUNDS], 1);
+#endif
+
+#ifdef URHO3D_VULKAN
+    unsigned texmode = 0;
+#else
+    Vector4 texmode;
+#endif
+
+    // Swap the generated vertices in the batches
+    Material* material;
+    unsigned indexM;
+    for (unsigned i = 0; i < chunkBuildJobs_.Size(); i++)
+    {
+        ChunkBuildJob& job = chunkBuildJobs_[i];
+        for (unsigned j = 0; j < job.batches_.Size(); j++)
+        {
+            ChunkBuildBatch& build = job.batches_[j];
+            if (!build.vertices_.Size())
+                continue;
+
+#ifdef ACTIVE_LAYERMATERIALS
+            material = GameContext::Get().layerMaterials_[build.layer_];
+            indexM = build.roof_ ? indexMRoof : GetMaterialIndex(material);
+#else
+            material = renderer_->GetMaterial(build.textures_.Front(), BLEND_ALPHA);
+            indexM = build.roof_ ? GetMaterialIndex(material, 1) : GetMaterialIndex(material);
+#endif
+
+            // Resolve the texture units
+            Texture2D* lasttexture = 0;
+            Vertex2D* vertex = build.vertices_.Buffer();
+            for (unsigned q = 0; q < build.textures_.Size(); q++, vertex += 4)
+            {
+                if (lasttexture != build.textures_[q])
+                {
+                    lasttexture = build.textures_[q];
+                    SetTextureMode(TXM_UNIT, material->GetTextureUnit(lasttexture), texmode);
+                }
+                vertex[0].texmode_ = vertex[1].texmode_ = vertex[2].texmode_ = vertex[3].texmode_ = texmode;
+            }
+
+            BatchInfo& batchinfo = GetChunkBatchInfo(build.type_, build.indexZ_, build.indexView_, job.indexC_, indexM, build.drawOrder_);
+            if (!batchinfo.batch_.vertices_.Size())
+            {
+                batchinfo.batch_.vertices_.Swap(build.vertices_);
+                batchinfo.localpositions_.Swap(build.localpositions_);
+            }
+            else
+            {
+                batchinfo.batch_.vertices_.Push(build.vertices_);
+                batchinfo.localpositions_.Push(build.localpositions_);
+            }
+        }
+
+        job.batches_.Clear();
+        job.item_.Reset();
+    }
+
+    GetObjectSkinned()->indexToSet_ = 0;
+
+    SetDirty();
+
+    sourceBatchReady_ = true;
+
+#ifdef DUMP_OBJECTTILED_UPDATEINFOS
+    URHO3D_LOGINFOF("ObjectTiled() - ApplyChunkBuildJobs %s ... numJobs=%u OK !", node_->GetName().CString(), chunkBuildJobs_.Size());
+#endif
+}
+
+bool ObjectTiled::UpdateChunkBuilds(HiresTimer* timer, const long long& delay)
+{
+    if (chunkBuildRunning_)
+    {
+        if (!ChunkBuildJobsFinished())
+            return false;
+
+        // swap the finished chunks : the previous vertices stay rendered until here
+        ApplyChunkBuildJobs();
+    }
+
+    // Update the mask views of the dirty chunk groups in the main thread and collect their chunks
+    while (dirtyChunkGroups_.Size())
+    {
+        const ChunkGroup& chunkGroup = *dirtyChunkGroups_.Back();
+
+        if (indexToSet_ == 0)
+        {
+            GetObjectFeatured()->indexToSet_ = 0;
+            indexToSet_ = 1;
+        }
+
+        if (!GetObjectFeatured()->UpdateMaskViews(chunkGroup.GetTileGroup(), timer, delay, skinData_->GetSkin() ? skinData_->GetSkin()->neighborMode_ : Connected0))
+            return false;
+
+        indexToSet_ = 0;
+
+        AddChunkBuilds(chunkGroup);
+        dirtyChunkGroups_.Pop();
+    }
+
+    StartChunkBuildJobs();
+
+    return !chunkBuildRunning_;
+}
+
+#endif
+
 void ObjectTiled::UpdateChunksVisiblity(ViewportRenderData& viewportdata)
 {
 #ifdef DUMP_OBJECTTILED_UPDATEINFOS
@@ -3168,6 +3573,42 @@ bool ObjectTiled::UpdateViewBatches(int numViewZ, HiresTimer* timer, const long
 
     sourceBatchReady_ = false;
 
+#if defined(ACTIVE_OBJECTTILED_THREADING) && !defined(USE_CHUNKBATCH)
+    if (timer && UseChunkBuildJobs())
+    {
+        if (!chunkBuildAll_)
+        {
+            if (chunkBuildRunning_)
+            {
+                WaitChunkBuildJobs();
+                ApplyChunkBuildJobs();
+            }
+
+            // all the chunks are generated in parallel by the workers
+            AddChunkBuilds(chinfo_->GetDefaultChunkGroup(MapDirection::All));
+            StartChunkBuildJobs();
+            chunkBuildAll_ = true;
+            return false;
+        }
+
+        if (!ChunkBuildJobsFinished())
+            return false;
+
+        ApplyChunkBuildJobs();
+        chunkBuildAll_ = false;
+        sourceBatchReady_ = true;
+        indexToSet_ = 0;
+        return true;
+    }
+
+    if (chunkBuildRunning_)
+    {
+        WaitChunkBuildJobs();
+        ApplyChunkBuildJobs();
+        chunkBuildAll_ = false;
+    }
+#endif
+
     for (;;)
     {
         URHO3D_LOGINFOF("ObjectTiled() - UpdateViewBatches ... indexZ=%d/%d ... timer=%d msec",
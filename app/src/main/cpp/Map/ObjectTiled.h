@@ -4,8 +4,13 @@
 
 #ifdef USE_TILERENDERING
 
+#include <atomic>
+
+#include <Urho3D/Core/WorkQueue.h>
 #include <Urho3D/Graphics/Material.h>
+#include <Urho3D/Graphics/Texture2D.h>
 #include <Urho3D/Urho2D/Drawable2D.h>
+#include <Urho3D/Urho2D/Sprite2D.h>
 
 #include "DefsMap.h"
 #include "DefsChunks.h"
@@ -82,6 +87,104 @@ struct BatchInfo
     SourceBatch2D batch_;
     int drawOrder_;
 };
+
+/// ChunkViewParams : the view read by the ChunkViewGenerator, from the object (main thread) or from the ChunkBuildSnapshot (workers)
+struct ChunkViewParams
+{
+    const FeaturedMap* mask_;
+    const TiledMap* tiles_;
+    const ConnectedMap* connections_;
+    const short int* neighborInd_;
+    /// terrain ids on the borders of the connected maps by MapDirection (empty if no connected map)
+    const PODVector<unsigned char>* borderTerrains_[4];
+    int viewID_;
+    int viewZ_;
+    int currentViewZ_;
+    int indexV_;
+    bool containPlateforms_;
+    int width_, height_;
+    float twidth_, theight_;
+    Vector2 center_;
+    int layermodifier_;
+    int orderInLayer_;
+    bool fluidEnabled_;
+};
+
+#ifdef ACTIVE_OBJECTTILED_THREADING
+const unsigned OBJECTTILED_WORKITEM_PRIORITY = 1002U;
+
+/// ChunkBuildBatch : vertices generated by a worker for a chunk (one per type, viewZ, view, draworder and material)
+struct ChunkBuildBatch
+{
+    MapObjectType type_;
+    int indexZ_;
+    int indexView_;
+    int drawOrder_;
+    int layer_;
+    bool roof_;
+    Texture2D* texture_;
+    /// texture by quad : the texture unit is resolved in the main thread
+    PODVector<Texture2D*> textures_;
+    Vector<Vector2> localpositions_;
+    Vector<Vertex2D> vertices_;
+};
+
+/// ChunkBuildSnapshot : copy of the views read by the chunk workers, never modified while the jobs are running
+struct ChunkBuildSnapshot
+{
+    const ChunkInfo* chinfo_;
+    int width_, height_;
+    float twidth_, theight_;
+    Vector2 center_;
+    Matrix2x3 worldTransform_;
+    int layermodifier_;
+    int orderInLayer_;
+    bool tilesEnable_;
+    bool decalsEnable_;
+    bool fluidEnabled_;
+    unsigned numviews_;
+    short int neighborInd_[9];
+
+    /// by indexZ
+    PODVector<int> currentViewZs_;
+    Vector<PODVector<int> > viewIds_;
+    Vector<Vector<FeaturedMap> > masks_;
+    /// by viewID
+    PODVector<int> viewZs_;
+    Vector<TiledMap> tiledViews_;
+    Vector<ConnectedMap> connectedViews_;
+    /// terrain ids on the borders of the connected maps (by MapDirection and viewID)
+    Vector<PODVector<unsigned char> > borderTerrains_[4];
+    /// rows and views copied for the dirty chunks
+    PODVector<unsigned char> rowsUsed_;
+    PODVector<unsigned char> viewsUsed_;
+};
+
+/// ChunkBuildJob : a worker job that generates the tiles, decals and sewings vertices of one chunk
+struct ChunkBuildJob
+{
+    ChunkBuildJob() : snapshot_(0), indexC_(0), numRunning_(0), indexZ_(0), lastBatch_(M_MAX_UNSIGNED) { }
+
+    void Build();
+
+    /// ChunkViewGenerator sink
+    void SetBatch(MapObjectType type, int indexView, int drawOrder, int layer, bool roof, Texture2D* texture);
+    void PushQuad(Sprite2D* sprite, Texture2D* texture, float xf, float yf, float zf, Vertex2D* vertex);
+
+    const ChunkBuildSnapshot* snapshot_;
+    unsigned indexC_;
+    /// running jobs counter of the ObjectTiled : decremented by the worker when the batches are built
+    std::atomic<unsigned>* numRunning_;
+    SharedPtr<WorkItem> item_;
+    Vector<ChunkBuildBatch> batches_;
+
+private:
+    void BuildViews(MapObjectType type, int indexZ);
+
+    int indexZ_;
+    unsigned lastBatch_;
+};
+#endif
 #endif
 
 
@@ -90,6 +193,9 @@ class ObjectTiled : public Drawable2D
     URHO3D_OBJECT(ObjectTiled, Drawable2D);
 
     friend struct ObjectSkinned;
+#ifndef USE_CHUNKBATCH
+    friend struct ChunkBatchInfoSink;
+#endif
     friend class Map;
     friend class ObjectMaped;
 
@@ -126,6 +232,11 @@ public:
     {
         return viewRangeMode_;
     }
+    static void SetChunkBuildThreading(bool state);
+    static bool GetChunkBuildThreading()
+    {
+        return chunkBuildThreading_;
+    }
 
 private :
     static TerrainAtlas* atlas_;
@@ -133,6 +244,7 @@ private :
     static int maxDrawViews_;
     static bool tilesEnable_, decalsEnable_;
     static int viewRangeMode_;
+    static bool chunkBuildThreading_;
 
 public :
     /// Construct.
@@ -144,6 +256,7 @@ public :
 
     void Resize(int width, int height, unsigned numviews, ChunkInfo* chinfo=0);
     void Clear();
+    void GetBuffers(MapBuffers& buffers) const;
 
     void SetChunked(unsigned char numx, unsigned char numy);
     void SetChunked(ChunkInfo* chinfo, bool shared=true);
@@ -228,6 +341,7 @@ private :
     void Init();
     void AllocateChunkBatches();
     void ClearChunksBatches();
+    void ResetChunksBatches();
 
     void ApplyCuttingLevel(int viewport=-1);
 
@@ -249,7 +363,9 @@ private :
     BatchInfo* GetChunkBatchInfoBased(MapObjectType type, unsigned baseKey, unsigned indexC, unsigned indexM);
     BatchInfo& GetChunkBatchInfo(MapObjectType type, int indexZ, int indexV, unsigned indexC, unsigned indexM, int drawOrder);
     void ClearBatchVertices(MapObjectType type, int indexZ, int indexV, unsigned indexC);
-    inline void PushDecalToVertices(int side, unsigned char terrainid, int rand, float xf, float yf, float zf, const Matrix2x3& worldTransform, Vertex2D* vertex, BatchInfo& batchinfo);
+    bool GetChunkViewParams(int indexZ, int indexV, ChunkViewParams& params);
+    void GetBorderTerrains(int dir, int viewID, PODVector<unsigned char>& terrains);
+    bool UpdateChunkViewBatches(MapObjectType type, const ChunkGroup& chunkGroup, int indexZ, int indexV, HiresTimer* timer, const long long& delay);
 #endif
     bool UpdateTiledBatches(const ChunkGroup& chunkGroup, int indexZ, int indexV, HiresTimer* timer, const long long& delay);
     bool UpdateDecalBatches(const ChunkGroup& chunkGroup, int indexZ, int indexV, HiresTimer* timer, const long long& delay);
@@ -260,6 +376,18 @@ private :
     void UpdateSourceBatchesToRender(ViewportRenderData& data);
     void UpdateChunksVisiblity(ViewportRenderData& viewportdata);
 
+#if defined(ACTIVE_OBJECTTILED_THREADING) && !defined(USE_CHUNKBATCH)
+    /// Chunk Build Jobs
+    bool UseChunkBuildJobs() const;
+    void AddChunkBuilds(const ChunkGroup& chunkGroup);
+    void PrepareChunkBuildSnapshot();
+    void StartChunkBuildJobs();
+    bool ChunkBuildJobsFinished() const;
+    void WaitChunkBuildJobs();
+    void ApplyChunkBuildJobs();
+    bool UpdateChunkBuilds(HiresTimer* timer, const long long& delay);
+#endif
+
     SharedPtr<ObjectSkinned> skinData_;
 
     short int neighborInd[9];
@@ -288,6 +416,16 @@ private :
     Vector<BatchInfo > viewBatchesTable_;
     Vector<WeakPtr<Material> > viewMaterialsTable_;
     HashMap<unsigned, unsigned > viewBatchesIndexes_;
+    /// terrain ids on the borders of the connected maps for the sewings of the main thread
+    PODVector<unsigned char> borderTerrains_[4];
+#ifdef ACTIVE_OBJECTTILED_THREADING
+    ChunkBuildSnapshot chunkBuildSnapshot_;
+    Vector<ChunkBuildJob> chunkBuildJobs_;
+    PODVector<unsigned> chunkBuildIndexes_;
+    std::atomic<unsigned> numChunkBuildJobsRunning_;
+    bool chunkBuildRunning_;
+    bool chunkBuildAll_;
+#endif
 #endif
 };
 
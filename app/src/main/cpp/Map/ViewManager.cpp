@@ -30,6 +30,7 @@
 #include "GameEvents.h"
 #include "GameContext.h"
 #include "GameAttributes.h"
+#include "GOABlock.h"
 #include "GameHelpers.h"
 
 #include "GOC_Controller.h"
@@ -1005,10 +1006,10 @@ void ViewManager::UpdateFocus(int viewport, const float& timeStep)
                         node = node->GetParent()->GetName() == MOUNTNODE ? node->GetParent()->GetParent() : node->GetParent();
 
                     position += node->GetWorldPosition2D();
-                    velocity += node->GetVar(GOA::VELOCITY).GetVector2();
+                    velocity += GOABlock::GetVelocity(node);
 
 #ifdef CAMERAFOCUS_ADJUSTWALK
-                    movestate = node->GetVar(GOA::MOVESTATE).GetUInt();
+                    movestate = GOABlock::GetMoveState(node);
 
                     if (((movestate & (MV_WALK|MV_FLY|MV_INFALL)) == MV_WALK) || (movestate & MV_TOUCHGROUND))
                     {
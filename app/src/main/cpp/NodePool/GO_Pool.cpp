@@ -221,7 +221,7 @@ void GO_Pools::Start()
 
 void GO_Pools::SubscribeToEvents()
 {
-    SubscribeToEvent(GO_DESTROY, URHO3D_HANDLER(GO_Pools, HandleObjectDestroy));
+    EventChannel<GoDestroyEvent>::Get().Subscribe<GO_Pools, &GO_Pools::HandleObjectDestroy>(this);
 }
 
 void GO_Pools::Restore()
@@ -229,7 +229,7 @@ void GO_Pools::Restore()
     URHO3D_LOGINFO("GO_Pools() - Restore !");
 
     if (gopools_)
-        gopools_->UnsubscribeFromEvent(GO_DESTROY);
+        EventChannel<GoDestroyEvent>::Get().Unsubscribe(gopools_);
 
     for (Vector<Vector<GO_Pool> >::Iterator it = pools_.Begin(); it != pools_.End(); ++it)
         for (Vector<GO_Pool>::Iterator jt = it->Begin(); jt != it->End(); ++jt)
@@ -245,6 +245,9 @@ void GO_Pools::Reset()
     poolHashs_.Clear();
     pools_.Clear();
 
+    if (gopools_)
+        EventChannel<GoDestroyEvent>::Get().Unsubscribe(gopools_);
+
     delete gopools_;
     gopools_ = 0;
 
@@ -363,9 +366,9 @@ void GO_Pools::Free(Node* node)
         pool->FreeGO(node);
 }
 
-void GO_Pools::HandleObjectDestroy(StringHash eventType, VariantMap& eventData)
+void GO_Pools::HandleObjectDestroy(Object* sender, const GoDestroyEvent& event)
 {
-    Node* node = nodePool_->GetScene()->GetNode(eventData[Go_Destroy::GO_ID].GetUInt());
+    Node* node = nodePool_->GetScene()->GetNode(event.id_);
     if (node && node->GetParent() == nodePool_)
     {
 //        URHO3D_LOGINFOF("GO_Pools() - HandleObjectDestroy - FreeGO node=%u", node);
@@ -3,6 +3,7 @@
 
 using namespace Urho3D;
 
+struct GoDestroyEvent;
 
 class GO_Pool : public Object
 {
@@ -68,7 +69,7 @@ public :
 
 private :
     void SubscribeToEvents();
-    void HandleObjectDestroy(StringHash eventType, VariantMap& eventData);
+    void HandleObjectDestroy(Object* sender, const GoDestroyEvent& event);
 
     static WeakPtr<Node> nodePool_;
     static Vector<StringHash> poolHashs_;
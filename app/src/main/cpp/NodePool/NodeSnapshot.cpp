@@ -0,0 +1,145 @@
+#include <Urho3D/Scene/Component.h>
+#include <Urho3D/Scene/Node.h>
+
+#include "NodeSnapshot.h"
+
+
+void NodeSnapshot::Capture(Node* source)
+{
+    Clear();
+
+    const Vector<SharedPtr<Node> >& children = source->GetChildren();
+    nodes_.Resize(1 + children.Size());
+
+    for (unsigned n = 0; n < nodes_.Size(); n++)
+    {
+        Node* node = n ? children[n-1].Get() : source;
+        NodeEntry& nodeEntry = nodes_[n];
+
+        nodeEntry.firstAttribute_ = attributes_.Size();
+        const Vector<AttributeInfo>* attributes = node->GetAttributes();
+        if (attributes)
+        {
+            for (unsigned i = 0; i < attributes->Size(); i++)
+            {
+                const AttributeInfo& attr = attributes->At(i);
+                // same as GameHelpers::CopyAttributes : no network-only attributes
+                if (attr.mode_ & AM_FILE)
+                {
+                    attributes_.Push(&attr);
+                    values_.Resize(values_.Size() + 1);
+                    node->OnGetAttribute(attr, values_.Back());
+                }
+            }
+        }
+        nodeEntry.numAttributes_ = attributes_.Size() - nodeEntry.firstAttribute_;
+
+        nodeEntry.firstComponent_ = components_.Size();
+        const Vector<SharedPtr<Component> >& components = node->GetComponents();
+        for (unsigned j = 0; j < components.Size(); j++)
+        {
+            Component* component = components[j].Get();
+            if (component->IsTemporary())
+                continue;
+
+            components_.Resize(components_.Size() + 1);
+            ComponentEntry& componentEntry = components_.Back();
+            componentEntry.type_ = component->GetType();
+            componentEntry.firstAttribute_ = attributes_.Size();
+
+            attributes = component->GetAttributes();
+            if (attributes)
+            {
+                for (unsigned i = 0; i < attributes->Size(); i++)
+                {
+                    const AttributeInfo& attr = attributes->At(i);
+                    if (attr.mode_ & AM_FILE)
+                    {
+                        attributes_.Push(&attr);
+                        values_.Resize(values_.Size() + 1);
+                        component->OnGetAttribute(attr, values_.Back());
+                    }
+                }
+            }
+            componentEntry.numAttributes_ = attributes_.Size() - componentEntry.firstAttribute_;
+        }
+        nodeEntry.numComponents_ = components_.Size() - nodeEntry.firstComponent_;
+    }
+}
+
+bool NodeSnapshot::Restore(Node* dest) const
+{
+    if (IsEmpty() || !CheckStructure(dest))
+        return false;
+
+    const Vector<SharedPtr<Node> >& children = dest->GetChildren();
+
+    for (unsigned n = 0; n < nodes_.Size(); n++)
+    {
+        Node* node = n ? children[n-1].Get() : dest;
+        const NodeEntry& nodeEntry = nodes_[n];
+
+        RestoreAttributes(node, nodeEntry.firstAttribute_, nodeEntry.numAttributes_);
+
+        const Vector<SharedPtr<Component> >& components = node->GetComponents();
+        unsigned c = nodeEntry.firstComponent_;
+        for (unsigned j = 0; j < components.Size() && c < nodeEntry.firstComponent_ + nodeEntry.numComponents_; j++)
+        {
+            Component* component = components[j].Get();
+            if (component->IsTemporary())
+                continue;
+
+            RestoreAttributes(component, components_[c].firstAttribute_, components_[c].numAttributes_);
+            c++;
+        }
+    }
+
+    return true;
+}
+
+void NodeSnapshot::Clear()
+{
+    nodes_.Clear();
+    components_.Clear();
+    attributes_.Clear();
+    values_.Clear();
+}
+
+bool NodeSnapshot::CheckStructure(Node* dest) const
+{
+    // the dest can have more children and more components (added at runtime) : they are kept like in GameHelpers::CopyAttributes
+    const Vector<SharedPtr<Node> >& children = dest->GetChildren();
+    if (children.Size() + 1 < nodes_.Size())
+        return false;
+
+    for (unsigned n = 0; n < nodes_.Size(); n++)
+    {
+        Node* node = n ? children[n-1].Get() : dest;
+        const NodeEntry& nodeEntry = nodes_[n];
+
+        const Vector<SharedPtr<Component> >& components = node->GetComponents();
+        unsigned c = nodeEntry.firstComponent_;
+        for (unsigned j = 0; j < components.Size() && c < nodeEntry.firstComponent_ + nodeEntry.numComponents_; j++)
+        {
+            Component* component = components[j].Get();
+            if (component->IsTemporary())
+                continue;
+
+            if (component->GetType() != components_[c].type_)
+                return false;
+            c++;
+        }
+
+        // a missing component
+        if (c < nodeEntry.firstComponent_ + nodeEntry.numComponents_)
+            return false;
+    }
+
+    return true;
+}
+
+void NodeSnapshot::RestoreAttributes(Serializable* serializable, unsigned first, unsigned num) const
+{
+    for (unsigned i = first; i < first + num; i++)
+        serializable->OnSetAttribute(*attributes_[i], values_[i]);
+}
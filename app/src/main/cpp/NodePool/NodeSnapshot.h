@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Attribute.h>
+#include <Urho3D/Core/Variant.h>
+#include <Urho3D/Math/StringHash.h>
+
+namespace Urho3D
+{
+class Node;
+class Serializable;
+}
+
+using namespace Urho3D;
+
+
+/// NodeSnapshot : the file attributes of a template node, of its components and of its first children, captured once in flat arrays.
+/// Restore sets the captured values on a node with the same structure (a pooled clone of the template)
+/// without getting the attributes of the template and without resolving the components.
+/// Restore returns false and doesn't change the node if the structure differs : the caller falls back to GameHelpers::CopyAttributes.
+
+class NodeSnapshot
+{
+public:
+    NodeSnapshot() { }
+
+    void Capture(Node* source);
+    bool Restore(Node* dest) const;
+    void Clear();
+
+    bool IsEmpty() const
+    {
+        return nodes_.Empty();
+    }
+    unsigned GetNumAttributes() const
+    {
+        return attributes_.Size();
+    }
+
+private:
+    struct NodeEntry
+    {
+        unsigned firstAttribute_, numAttributes_;
+        unsigned firstComponent_, numComponents_;
+    };
+    struct ComponentEntry
+    {
+        StringHash type_;
+        unsigned firstAttribute_, numAttributes_;
+    };
+
+    bool CheckStructure(Node* dest) const;
+    void RestoreAttributes(Serializable* serializable, unsigned first, unsigned num) const;
+
+    // the template node then its children
+    PODVector<NodeEntry> nodes_;
+    // the not temporary components of the nodes
+    PODVector<ComponentEntry> components_;
+    // the file attributes and their values
+    PODVector<const AttributeInfo*> attributes_;
+    Vector<Variant> values_;
+};
@@ -1,4 +1,6 @@
 #include <Urho3D/Urho3D.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
 #include <Urho3D/IO/Log.h>
 #include <Urho3D/Resource/ResourceCache.h>
 #include <Urho3D/Scene/Scene.h>
@@ -16,17 +18,56 @@
 #include "GameHelpers.h"
 #include "GameRand.h"
 
+#include "GOC_Animator2D.h"
 #include "GOC_Destroyer.h"
 
+#include "GOABlock.h"
 #include "ObjectPool.h"
 
 #define DEFAULT_NUMOBJECTS 10
 
-
-ObjectPoolCategory::ObjectPoolCategory()
+// the reserved ids allow a category to grow to this factor of its size
+#define OBJECTPOOL_CAPACITYFACTOR 2
+// the duration of an usage window (sec) and the number of idle windows before a shrink
+#define OBJECTPOOL_SIZINGDELAY 2.f
+#define OBJECTPOOL_SHRINKWINDOWS 5
+// the time given by frame to the clones of a growing category (usec)
+#define OBJECTPOOL_GROWDELAY 1000
+#define OBJECTPOOL_SIZEHINTSFILE "ObjectPool.dat"
+
+
+ObjectPoolCategory::ObjectPoolCategory() :
+    updateState_(-1),
+    capacity_(0),
+    minSize_(0),
+    initialSize_(0),
+    cloneStart_(0),
+    numSnapshotFrees_(0),
+    numCopyFrees_(0),
+    snapshotFreesTime_(0),
+    copyFreesTime_(0),
+    highWater_(0),
+    peakUsed_(0),
+    numMisses_(0),
+    idleWindows_(0),
+    sizingTime_(0.f)
 { }
 
-ObjectPoolCategory::ObjectPoolCategory(const ObjectPoolCategory& obj)
+ObjectPoolCategory::ObjectPoolCategory(const ObjectPoolCategory& obj) :
+    updateState_(-1),
+    capacity_(0),
+    minSize_(0),
+    initialSize_(0),
+    cloneStart_(0),
+    numSnapshotFrees_(0),
+    numCopyFrees_(0),
+    snapshotFreesTime_(0),
+    copyFreesTime_(0),
+    highWater_(0),
+    peakUsed_(0),
+    numMisses_(0),
+    idleWindows_(0),
+    sizingTime_(0.f)
 { }
 
 ObjectPoolCategory::~ObjectPoolCategory()
@@ -152,10 +193,12 @@ Node* ObjectPoolCategory::GetPoolNode(unsigned newid)
         Node* node;
         unsigned oldid;
 
-        // specific LOCAL node
-        if (newid >= firstNodeID_ && newid <= lastNodeID_)
+        // specific LOCAL node (not cloned if the category has shrunk, not given before its apply attributes)
+        Node* localnode = newid >= firstNodeID_ && newid <= lastNodeID_ && (newid - firstNodeID_) / numNodeIdsByObject_ < GetNumApplied() ?
+                          GameContext::Get().rootScene_->GetNode(newid) : 0;
+        if (localnode)
         {
-            node = GameContext::Get().rootScene_->GetNode(newid);
+            node = localnode;
             freenodes_.RemoveSwap(node);
             oldid = node->GetID();
         }
@@ -184,6 +227,12 @@ Node* ObjectPoolCategory::GetPoolNode(unsigned newid)
 //        node->AddTag("InUse");
         node->isInPool_ = false;
 
+        unsigned used = GetNumApplied() - freenodes_.Size();
+        if (used > highWater_)
+            highWater_ = used;
+        if (used > peakUsed_)
+            peakUsed_ = used;
+
 //        URHO3D_LOGINFOF("ObjectPoolCategory() - GetPoolNode : %s(oldid=%u replicatedID=%u newid=%u(check=%u)) free=%u/%u",
 //                        GOT::GetType(GOT_).CString(), oldid, currentReplicatedNodeID_, newid, node->GetID(), freenodes_.Size(), nodes_.Size());
 
@@ -191,6 +240,8 @@ Node* ObjectPoolCategory::GetPoolNode(unsigned newid)
     }
 
 //    URHO3D_LOGERRORF("ObjectPoolCategory() - GetPoolNode : %s(hash=%u) ... No Free Node !!!", GOT::GetType(GOT_).CString(), GOT_.Value());
+    numMisses_++;
+    highWater_ = nodes_.Size();
     return 0;
 }
 
@@ -251,7 +302,7 @@ bool ObjectPoolCategory::FreePoolNode(Node* node, bool cleanDependences)
 //        URHO3D_LOGINFOF("ObjectPoolCategory() - FreePoolNode : type=%s CopyAttributes Before nodeEnabled=%s ... ",
 //                GOT::GetType(GOT_).CString(), node->IsEnabled() ? "true" : "false");
 
-        GameHelpers::CopyAttributes(template_, node, false, false);
+        RestoreNode(node);
 
         node->RemoveAllTags();
         node->isInPool_ = true;
@@ -287,6 +338,58 @@ bool ObjectPoolCategory::FreePoolNode(Node* node, bool cleanDependences)
     return false;
 }
 
+void ObjectPoolCategory::RestoreNode(Node* node)
+{
+#ifdef ACTIVE_POOL_FREESTATS
+    HiresTimer timer;
+#endif
+
+    bool restored = false;
+
+#ifdef ACTIVE_POOL_SNAPSHOT
+    if (snapshot_.IsEmpty())
+        snapshot_.Capture(template_);
+
+    // same resets than GameHelpers::CopyAttributes
+    GOC_Animator2D* animator = node->GetComponent<GOC_Animator2D>();
+    if (animator)
+    {
+        animator->UnplugDrawables();
+    }
+    else
+    {
+        AnimatedSprite2D* animatedsprite = node->GetComponent<AnimatedSprite2D>();
+        if (animatedsprite)
+            animatedsprite->ClearRenderedAnimations();
+    }
+
+    restored = snapshot_.Restore(node);
+
+    if (animator)
+        animator->PlugDrawables();
+#endif
+
+    // the structure of the node has changed (a component added or removed) : copy from the template
+    if (!restored)
+        GameHelpers::CopyAttributes(template_, node, false, false);
+
+    // the node variables are the variables of the template
+    GOABlock::Reload(node);
+
+#ifdef ACTIVE_POOL_FREESTATS
+    if (restored)
+    {
+        numSnapshotFrees_++;
+        snapshotFreesTime_ += timer.GetUSec(false);
+    }
+    else
+    {
+        numCopyFrees_++;
+        copyFreesTime_ += timer.GetUSec(false);
+    }
+#endif
+}
+
 void ObjectPoolCategory::ApplyScaleVariation(Node* node, unsigned nodeid)
 {
     unsigned rand = nodeid > LOCAL ? nodeid : node->GetID();
@@ -299,6 +402,7 @@ void ObjectPoolCategory::ApplyScaleVariation(Node* node, unsigned nodeid)
 bool ObjectPoolCategory::Create(bool replicate, const StringHash& got, Node* nodePool, Node* templateNode, unsigned* ids)
 {
     template_.Reset();
+    snapshot_.Clear();
     nodes_.Clear();
     freenodes_.Clear();
 
@@ -312,6 +416,12 @@ bool ObjectPoolCategory::Create(bool replicate, const StringHash& got, Node* nod
     GOT_ = got;
     gotinfo_ = &GOT::GetConstInfo(GOT_);
     requestedSize_ = 0;
+    updateState_ = -1;
+    capacity_ = 0;
+    minSize_ = Max(1U, gotinfo_->poolqty_ / 2);
+    initialSize_ = 0;
+    highWater_ = peakUsed_ = numMisses_ = idleWindows_ = 0;
+    sizingTime_ = 0.f;
 
     if (nodeCategory_)
     {
@@ -366,21 +476,42 @@ bool ObjectPoolCategory::Create(bool replicate, const StringHash& got, Node* nod
     return true;
 }
 
+void ObjectPoolCategory::SetCapacity(unsigned capacity)
+{
+    // the ids of the nodes in the pool are reserved by ObjectPool::CreateCategories, the capacity can't change after the first clones
+    if (nodes_.Size())
+        return;
+
+    capacity_ = capacity;
+}
+
 void ObjectPoolCategory::Resize(unsigned size)
 {
+    if (size > capacity_)
+    {
+        if (nodes_.Size())
+            size = capacity_;
+        else
+            capacity_ = size;
+    }
+
+    if (!initialSize_)
+        initialSize_ = size;
+
     requestedSize_ = size;
     updateState_ = 0;
+    cloneStart_ = nodes_.Size();
 
     nodes_.Reserve(size);
     freenodes_.Reserve(size);
 
     // Calculate the last Ids
-    lastNodeID_ = firstNodeID_ + numNodeIdsByObject_ * size - 1;
-    lastComponentID_ = firstComponentID_ + numComponentIdsByObject_ * size - 1;
+    lastNodeID_ = firstNodeID_ + numNodeIdsByObject_ * capacity_ - 1;
+    lastComponentID_ = firstComponentID_ + numComponentIdsByObject_ * capacity_ - 1;
     if (replicatedState_)
     {
-        lastReplicatedNodeID_ = firstReplicatedNodeID_ + numNodeIdsByObject_ * size - 1 ;
-        lastReplicatedComponentID_ = firstReplicatedComponentID_ + numComponentIdsByObject_ * size - 1;
+        lastReplicatedNodeID_ = firstReplicatedNodeID_ + numNodeIdsByObject_ * capacity_ - 1 ;
+        lastReplicatedComponentID_ = firstReplicatedComponentID_ + numComponentIdsByObject_ * capacity_ - 1;
     }
     else
     {
@@ -388,8 +519,8 @@ void ObjectPoolCategory::Resize(unsigned size)
         lastReplicatedComponentID_ = 0;
     }
 
-    URHO3D_LOGINFOF("ObjectPoolCategory() - Resize type=%s(%u) CreateMode=%s templateID=%u size=%u LOCAL n=%u->%u c=%u->%u REPLI n=%u->%u c=%u->%u ... OK !",
-                    GOT::GetType(GOT_).CString(), GOT_.Value(), replicatedState_ ? "REPLICATED":"LOCAL", template_->GetID(), size,
+    URHO3D_LOGINFOF("ObjectPoolCategory() - Resize type=%s(%u) CreateMode=%s templateID=%u size=%u/%u LOCAL n=%u->%u c=%u->%u REPLI n=%u->%u c=%u->%u ... OK !",
+                    GOT::GetType(GOT_).CString(), GOT_.Value(), replicatedState_ ? "REPLICATED":"LOCAL", template_->GetID(), size, capacity_,
                     firstNodeID_, lastNodeID_, firstComponentID_, lastComponentID_,
                     firstReplicatedNodeID_, lastReplicatedNodeID_, firstReplicatedComponentID_, lastReplicatedComponentID_);
 }
@@ -415,8 +546,8 @@ bool ObjectPoolCategory::Update(HiresTimer* timer, const long long& delay)
                 return true;
             }
 
+            // the node is free after the apply attributes
             nodes_.Push(node);
-            freenodes_.Push(node.Get());
 
             if (nodes_.Size() < requestedSize_ && TimeOver(timer, delay))
                 return false;
@@ -425,7 +556,7 @@ bool ObjectPoolCategory::Update(HiresTimer* timer, const long long& delay)
             componentid += numComponentIdsByObject_;
         }
 
-        updateState_++;
+        updateState_ = cloneStart_ + 1;
     }
 
     if (updateState_ > 0)
@@ -453,6 +584,9 @@ bool ObjectPoolCategory::Update(HiresTimer* timer, const long long& delay)
 
             node->ApplyAttributes();
 
+            // the nodes before the apply attributes are never given nor restored : the node isn't in the free nodes
+            freenodes_.Push(node);
+
             inode++;
 
             if (inode < requestedSize_ && TimeOver(timer, delay))
@@ -464,6 +598,8 @@ bool ObjectPoolCategory::Update(HiresTimer* timer, const long long& delay)
 
         URHO3D_LOGINFOF("ObjectPoolCategory() - Update : Resize type=%s(%u) ... OK !", GOT::GetType(GOT_).CString(), GOT_.Value());
 
+        updateState_ = -1;
+
 //        Dump();
         return true;
     }
@@ -471,11 +607,91 @@ bool ObjectPoolCategory::Update(HiresTimer* timer, const long long& delay)
     return false;
 }
 
+bool ObjectPoolCategory::UpdateSize(float timestep)
+{
+    // not created or resizing
+    if (!nodes_.Size() || updateState_ != -1)
+        return false;
+
+    const unsigned size = nodes_.Size();
+
+    // grow ahead of the demand : less than a quarter of the pool is free
+    if (size < capacity_ && freenodes_.Size() * 4 < size)
+    {
+        unsigned newsize = Min(capacity_, Max(size + Max(1U, size / 2), highWater_ + highWater_ / 2));
+
+        URHO3D_LOGINFOF("ObjectPoolCategory() - UpdateSize : type=%s(%u) free=%u/%u highwater=%u misses=%u => grow to %u/%u !",
+                        GOT::GetType(GOT_).CString(), GOT_.Value(), freenodes_.Size(), size, highWater_, numMisses_, newsize, capacity_);
+
+        idleWindows_ = 0;
+        Resize(newsize);
+        return true;
+    }
+
+    sizingTime_ += timestep;
+    if (sizingTime_ < OBJECTPOOL_SIZINGDELAY)
+        return false;
+
+    sizingTime_ = 0.f;
+
+    // shrink the idle pool gradually : less than the half of the pool used during several windows
+    if (size > minSize_ && highWater_ < size / 2)
+    {
+        idleWindows_++;
+        if (idleWindows_ >= OBJECTPOOL_SHRINKWINDOWS)
+        {
+            idleWindows_ = 0;
+            Shrink(Max(minSize_, size - Max(1U, size / 8)));
+        }
+    }
+    else
+    {
+        idleWindows_ = 0;
+    }
+
+    // next window
+    highWater_ = nodes_.Size() - freenodes_.Size();
+
+    return false;
+}
+
+void ObjectPoolCategory::Shrink(unsigned size)
+{
+    const unsigned oldsize = nodes_.Size();
+
+    // the ids of a node depend on its position in the pool : remove only the free nodes at the end
+    while (nodes_.Size() > size)
+    {
+        Node* node = nodes_.Back();
+        if (!freenodes_.Contains(node))
+            break;
+
+        freenodes_.Remove(node);
+        node->Remove();
+        nodes_.Pop();
+    }
+
+    requestedSize_ = nodes_.Size();
+
+    if (nodes_.Size() != oldsize)
+        URHO3D_LOGINFOF("ObjectPoolCategory() - Shrink : type=%s(%u) size=%u => %u/%u !",
+                        GOT::GetType(GOT_).CString(), GOT_.Value(), oldsize, nodes_.Size(), capacity_);
+}
+
+unsigned ObjectPoolCategory::GetSizeHint() const
+{
+    // the size needed by the session, the hint decreases by a quarter at most by session
+    unsigned size = peakUsed_ + peakUsed_ / 4 + 1;
+    size = Max(size, initialSize_ - initialSize_ / 4);
+    return Clamp(size, minSize_, capacity_);
+}
 
 /// restore all the categories to the pool
 void ObjectPoolCategory::RestoreObjects(bool allObjects)
 {
-    if (GetFreeSize() == GetSize())
+    // the nodes in resize are free after their apply attributes
+    const unsigned numapplied = GetNumApplied();
+    if (GetFreeSize() == numapplied)
         return;
 
     URHO3D_LOGINFOF("ObjectPoolCategory() - RestoreObjects : Category = %s(%u)  ... templateID=%u IDs=%u->%u",
@@ -487,7 +703,7 @@ void ObjectPoolCategory::RestoreObjects(bool allObjects)
     if (!allObjects)
     {
         Node* node;
-        for (unsigned i=0; i < GetSize(); i++)
+        for (unsigned i=0; i < numapplied; i++)
         {
             node = nodes_[i];
 
@@ -505,7 +721,7 @@ void ObjectPoolCategory::RestoreObjects(bool allObjects)
     }
     else
     {
-        for (unsigned i=0; i < GetSize(); i++)
+        for (unsigned i=0; i < numapplied; i++)
         {
             count++;
             r = FreePoolNode(nodes_[i], true);
@@ -528,6 +744,16 @@ void ObjectPoolCategory::Dump(bool logonlyerrors) const
                     GOT::GetType(GOT_).CString(), GOT_.Value(), GetFreeSize(), GetSize(), template_->GetID(),
                     firstNodeID_, lastNodeID_, firstReplicatedNodeID_, lastReplicatedNodeID_);
 
+#ifdef ACTIVE_POOL_FREESTATS
+    URHO3D_LOGINFOF("-> frees : snapshot=%u (%.2f us/free, %u attributes) copy=%u (%.2f us/free)",
+                    numSnapshotFrees_, numSnapshotFrees_ ? (float)snapshotFreesTime_ / numSnapshotFrees_ : 0.f, snapshot_.GetNumAttributes(),
+                    numCopyFrees_, numCopyFrees_ ? (float)copyFreesTime_ / numCopyFrees_ : 0.f);
+#endif
+#ifdef ACTIVE_POOL_ADAPTIVESIZE
+    URHO3D_LOGINFOF("-> sizing : size=%u (initial=%u min=%u capacity=%u) highwater=%u peak=%u misses=%u hint=%u",
+                    GetSize(), initialSize_, minSize_, capacity_, highWater_, peakUsed_, numMisses_, GetSizeHint());
+#endif
+
     if (!logonlyerrors)
         for (unsigned i=0; i <freenodes_.Size(); i++)
         {
@@ -571,6 +797,9 @@ void ObjectPool::Reset(Node* node)
         pool_ = new ObjectPool(node->GetContext());
         pool_->categories_.Clear();
         pool_->nodePool_ = node->CreateChild("ObjectPool", LOCAL);
+#ifdef ACTIVE_POOL_ADAPTIVESIZE
+        pool_->LoadSizeHints();
+#endif
 
         URHO3D_LOGINFOF("ObjectPool() - Reset ... Root=%u NodePool=%u ... OK !", node->GetID(), pool_->nodePool_->GetID());
     }
@@ -579,7 +808,8 @@ void ObjectPool::Reset(Node* node)
 ObjectPool::ObjectPool(Context* context) :
     Object(context),
     firstLocalNodeID_(0),
-    createstate_(0)
+    createstate_(0),
+    sizingEnabled_(false)
 {
     SetForceLocalMode(true);
 }
@@ -610,7 +840,14 @@ void ObjectPool::Stop()
 {
     URHO3D_LOGINFO("ObjectPool() - Stop ...");
 
+#ifdef ACTIVE_POOL_ADAPTIVESIZE
+    if (sizingEnabled_)
+        SaveSizeHints();
+#endif
+
     createstate_ = 0;
+    sizingEnabled_ = false;
+    categoriesToUpdate_.Clear();
     categories_.Clear();
 
     GameHelpers::RemoveNodeSafe(nodePool_, false);
@@ -641,11 +878,36 @@ ObjectPoolCategory* ObjectPool::CreateCategory(const GOTInfo& info, Node* templa
         }
     }
 
-    category.Resize(info.poolqty_);
+    category.SetCapacity(GetCategoryCapacity(info));
+    category.Resize(GetCategoryInitialSize(info));
 
     return &category;
 }
 
+unsigned ObjectPool::GetCategoryCapacity(const GOTInfo& info) const
+{
+#ifdef ACTIVE_POOL_ADAPTIVESIZE
+    // the replicated ids must be the same on the server and the clients : the hints of the local save don't change them
+    if (info.replicatedMode_)
+        return info.poolqty_ * OBJECTPOOL_CAPACITYFACTOR;
+
+    HashMap<StringHash, unsigned>::ConstIterator it = sizeHints_.Find(info.got_);
+    return Max(info.poolqty_, it != sizeHints_.End() ? it->second_ : 0U) * OBJECTPOOL_CAPACITYFACTOR;
+#else
+    return info.poolqty_;
+#endif
+}
+
+unsigned ObjectPool::GetCategoryInitialSize(const GOTInfo& info) const
+{
+#ifdef ACTIVE_POOL_ADAPTIVESIZE
+    HashMap<StringHash, unsigned>::ConstIterator it = sizeHints_.Find(info.got_);
+    if (it != sizeHints_.End())
+        return Clamp(it->second_, Max(1U, info.poolqty_ / 2), GetCategoryCapacity(info));
+#endif
+    return info.poolqty_;
+}
+
 bool ObjectPool::CreateCategories(Scene* scene, const HashMap<StringHash, GOTInfo >& infos, const HashMap<StringHash, WeakPtr<Node> >& templates, HiresTimer* timer, const long long& delay)
 {
     // Reserve Scene Ids
@@ -681,7 +943,7 @@ bool ObjectPool::CreateCategories(Scene* scene, const HashMap<StringHash, GOTInf
             }
 
             Node* node = itt->second_;
-            unsigned numObjects = info.poolqty_;
+            unsigned numObjects = GetCategoryCapacity(info);
 
             unsigned numNodes = 1 + node->GetNumChildren(true);
             unsigned numComponents = node->GetNumComponents(true);
@@ -767,7 +1029,7 @@ bool ObjectPool::CreateCategories(Scene* scene, const HashMap<StringHash, GOTInf
                 continue;
 
             Node* node = itt->second_;
-            unsigned numObjects = info.poolqty_;
+            unsigned numObjects = GetCategoryCapacity(info);
 
             unsigned numNodes = 1 + node->GetNumChildren(true);
             unsigned numComponents = node->GetNumComponents(true);
@@ -815,6 +1077,7 @@ bool ObjectPool::CreateCategories(Scene* scene, const HashMap<StringHash, GOTInf
             categoriesToUpdate_.PopFront();
         }
 
+        sizingEnabled_ = true;
         return true;
     }
 
@@ -923,6 +1186,7 @@ Node* ObjectPool::CreateChildIn(const StringHash& got, int& entityid, Node* pare
     {
 //        URHO3D_LOGWARNINGF("ObjectPool() - CreateChildIn node id=%u => load nodeattributes !", id);
         GameHelpers::LoadNodeAttributes(node, *nodeAttr, false);
+        GOABlock::Reload(node);
         viewZ = node->GetVar(GOA::ONVIEWZ).GetInt();
     }
 
@@ -1052,6 +1316,88 @@ bool ObjectPool::IsInPool(Node* node)
     return category->IsNodeInPool(node);
 }
 
+void ObjectPool::UpdateSizes(float timestep)
+{
+    if (!pool_ || !pool_->sizingEnabled_)
+        return;
+
+    List<ObjectPoolCategory* >& categoriesToUpdate = pool_->categoriesToUpdate_;
+
+    for (HashMap<StringHash, ObjectPoolCategory >::Iterator it=pool_->categories_.Begin(); it!=pool_->categories_.End(); ++it)
+    {
+        if (it->second_.UpdateSize(timestep))
+            categoriesToUpdate.Push(&it->second_);
+    }
+
+    if (!categoriesToUpdate.Size())
+        return;
+
+    // the clones of the growing categories are time-sliced : the scene isn't thread-safe
+    HiresTimer timer;
+    while (categoriesToUpdate.Size())
+    {
+        if (!categoriesToUpdate.Front()->Update(&timer, OBJECTPOOL_GROWDELAY))
+            return;
+
+        categoriesToUpdate.PopFront();
+    }
+}
+
+void ObjectPool::LoadSizeHints()
+{
+    sizeHints_.Clear();
+
+    const String& saveDir = GameContext::Get().gameConfig_.saveDir_;
+    if (saveDir.Empty())
+        return;
+
+    String filename = saveDir + GAMEDATADIR + OBJECTPOOL_SIZEHINTSFILE;
+    if (!GetSubsystem<FileSystem>()->FileExists(filename))
+        return;
+
+    File file(context_, filename, FILE_READ);
+    if (file.IsOpen())
+    {
+        unsigned numhints = file.ReadVLE();
+        for (unsigned i=0; i < numhints; i++)
+        {
+            StringHash got(file.ReadUInt());
+            sizeHints_[got] = file.ReadVLE();
+        }
+
+        URHO3D_LOGINFOF("ObjectPool() - LoadSizeHints : %s numhints=%u ... OK !", filename.CString(), numhints);
+
+        file.Close();
+    }
+}
+
+void ObjectPool::SaveSizeHints()
+{
+    const String& saveDir = GameContext::Get().gameConfig_.saveDir_;
+    if (saveDir.Empty())
+        return;
+
+    // keep the hints of the categories not created in this session
+    for (HashMap<StringHash, ObjectPoolCategory >::ConstIterator it=categories_.Begin(); it!=categories_.End(); ++it)
+        sizeHints_[it->first_] = it->second_.GetSizeHint();
+
+    String filename = saveDir + GAMEDATADIR + OBJECTPOOL_SIZEHINTSFILE;
+    File file(context_, filename, FILE_WRITE);
+    if (file.IsOpen())
+    {
+        file.WriteVLE(sizeHints_.Size());
+        for (HashMap<StringHash, unsigned>::ConstIterator it=sizeHints_.Begin(); it!=sizeHints_.End(); ++it)
+        {
+            file.WriteUInt(it->first_.Value());
+            file.WriteVLE(it->second_);
+        }
+
+        URHO3D_LOGINFOF("ObjectPool() - SaveSizeHints : %s numhints=%u ... OK !", filename.CString(), sizeHints_.Size());
+
+        file.Close();
+    }
+}
+
 void ObjectPool::DumpCategories() const
 {
     URHO3D_LOGINFOF("ObjectPool() - DumpCategories : ----------------------------------------------");
@@ -2,6 +2,8 @@
 
 #include "DefsGame.h"
 
+#include "NodeSnapshot.h"
+
 namespace Urho3D
 {
 class AnimatedSprite2D;
@@ -42,6 +44,7 @@ public :
     }
 
     bool Create(bool replicate, const StringHash& GOT, Node* nodePool, Node* templateNode, unsigned* ids);
+    void SetCapacity(unsigned capacity);
     void Resize(unsigned size);
     void SetIds(CreateMode mode, unsigned firstNodeID=0, unsigned firstComponentID=0);
     void SynchronizeReplicatedNodes(unsigned startNodeID);
@@ -81,6 +84,16 @@ public :
     {
         return freenodes_.Size();
     }
+    unsigned GetCapacity() const
+    {
+        return capacity_;
+    }
+    /// the nodes with their attributes applied : the first nodes of the pool, the next ones are in resize
+    unsigned GetNumApplied() const
+    {
+        return updateState_ == -1 ? nodes_.Size() : updateState_ > 0 ? updateState_ - 1 : cloneStart_;
+    }
+    unsigned GetSizeHint() const;
 
     Node* GetPoolNode(unsigned id=0);
     bool FreePoolNode(Node* node, bool cleanDependences=false);
@@ -95,7 +108,10 @@ public :
 
 private :
     void ApplyScaleVariation(Node* node, unsigned nodeid);
+    void RestoreNode(Node* node);
     bool Update(HiresTimer* timer, const long long& delay);
+    bool UpdateSize(float timestep);
+    void Shrink(unsigned size);
 
 //    void ApplyEntityVariation(AnimatedSprite2D* animatedSprite, int entityid=-1);
 //    void ResetAttributes(Node* node);
@@ -104,9 +120,15 @@ private :
     const GOTInfo* gotinfo_;
     unsigned requestedSize_;
     int updateState_;
+    // the nodes ids are reserved for the capacity, the pool size stays between minSize_ and capacity_
+    unsigned capacity_, minSize_, initialSize_;
+    // the first node cloned by the last resize
+    unsigned cloneStart_;
 
     WeakPtr<Node> nodeCategory_;
     WeakPtr<Node> template_;
+    // the attributes of the template, captured at the first free
+    NodeSnapshot snapshot_;
     Vector<SharedPtr<Node> > nodes_;
     PODVector<Node* > freenodes_;
     bool replicatedState_;
@@ -116,6 +138,15 @@ private :
     unsigned numComponentIdsByObject_;
     unsigned currentReplicatedNodeID_;
     unsigned currentReplicatedComponentID_;
+
+    // the cost of the frees (ACTIVE_POOL_FREESTATS) : restored by the snapshot or copied from the template
+    unsigned numSnapshotFrees_, numCopyFrees_;
+    long long snapshotFreesTime_, copyFreesTime_;
+
+    // the usage (ACTIVE_POOL_ADAPTIVESIZE) : the high-water mark of the current window, of the session and the gets without free node
+    unsigned highWater_, peakUsed_, numMisses_;
+    unsigned idleWindows_;
+    float sizingTime_;
 };
 
 class ObjectPool : public Object
@@ -159,6 +190,7 @@ public :
         return debugTxt_;
     }
     static void Reset(Node* node=0);
+    static void UpdateSizes(float timestep);
 
     static Node* CreateChildIn(const StringHash& got, int& entityid, Node* parent=0, unsigned id=0, int viewZ=-1, const NodeAttributes* nodeAttr=0, bool applyAttr=false, ObjectPoolCategory** category=0, bool* outsidePool=0);
     static void ChangeToReplicatedID(Node* node, unsigned newid);
@@ -169,6 +201,11 @@ public :
 private :
     static void UpdateDebugData();
 
+    void LoadSizeHints();
+    void SaveSizeHints();
+    unsigned GetCategoryCapacity(const GOTInfo& info) const;
+    unsigned GetCategoryInitialSize(const GOTInfo& info) const;
+
     WeakPtr<Node> nodePool_;
     HashMap<StringHash, ObjectPoolCategory > categories_;
 
@@ -184,6 +221,10 @@ private :
     unsigned lastReplicatedComponentID_;
 
     int createstate_;
+    bool sizingEnabled_;
+
+    // the pool sizes of the last session by got
+    HashMap<StringHash, unsigned> sizeHints_;
 
     static ObjectPool* pool_;
     static String debugTxt_;
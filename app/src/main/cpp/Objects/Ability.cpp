@@ -14,6 +14,7 @@
 #include "DefsMove.h"
 
 #include "GameAttributes.h"
+#include "GOABlock.h"
 #include "GameEvents.h"
 #include "GameContext.h"
 #include "GameHelpers.h"
@@ -629,7 +630,7 @@ Node* ABI_Shooter::Use(const Vector2& wpoint, ObjectControlInfo** oinfo)
 
 //        URHO3D_LOGINFOF("ABI_Shooter() - Use : dir=%f,%f ...", direction.x_, direction.y_);
 
-        if (holder_->GetVar(GOA::MOVESTATE).GetUInt() & MV_TOUCHGROUND && direction.y_ < 0.f && direction.x_*direction.x_ < 0.2f)
+        if (GOABlock::GetMoveState(holder_) & MV_TOUCHGROUND && direction.y_ < 0.f && direction.x_*direction.x_ < 0.2f)
             return 0;
 
         GOC_Destroyer* holderdestroyer = holder_->GetComponent<GOC_Destroyer>();
@@ -742,7 +743,7 @@ Node* ABIBomb::Use(const Vector2& wpoint, ObjectControlInfo** oinfo)
         Vector2 direction = wpoint - holder_->GetWorldPosition2D();
         direction.Normalize();
 
-        if (holder_->GetVar(GOA::MOVESTATE).GetUInt() & MV_TOUCHGROUND && direction.y_ < 0.f && direction.x_*direction.x_ < 0.2f)
+        if (GOABlock::GetMoveState(holder_) & MV_TOUCHGROUND && direction.y_ < 0.f && direction.x_*direction.x_ < 0.2f)
             return 0;
 
         GOC_Destroyer* holderdestroyer = holder_->GetComponent<GOC_Destroyer>();
@@ -913,7 +914,7 @@ void ABI_Fly::OnActive(bool active)
     if (active)
     {
         Drawable2D* drawable = holder_->GetDerivedComponent<Drawable2D>();
-        float angle = holder_->GetVar(GOA::DIRECTION).GetVector2().x_ > 0.f ? 180.f : 0.f;
+        float angle = GOABlock::GetDirection(holder_).x_ > 0.f ? 180.f : 0.f;
         GameHelpers::SpawnParticleEffectInNode(holder_->GetContext(), holder_, ParticuleEffect_[PE_TORCHE], drawable->GetLayer(), drawable->GetViewMask(),
                                                    holder_->GetWorldPosition2D()+Vector2(0.f, 0.5f), angle, 3.f, true, 2.f, Color::WHITE, LOCAL);
     }
@@ -0,0 +1,185 @@
+#include "EntityRegistry.h"
+
+
+EntityRegistry EntityRegistry::registry_;
+
+static const PODVector<EntityHandle> sEmptyHandles_;
+
+static unsigned GetNextGeneration(unsigned generation)
+{
+    return generation < ENTITYHANDLE_GENERATIONMASK ? generation + 1 : 1;
+}
+
+
+void EntityRegistry::Clear()
+{
+    // the slots are kept : the handles of the removed entities stay invalid
+    for (unsigned i = 0; i < records_.Size(); i++)
+    {
+        const unsigned index = records_[i].handle_ & ENTITYHANDLE_INDEXMASK;
+        Slot& slot = slots_[index];
+        slot.generation_ = GetNextGeneration(slot.generation_);
+        freeSlots_.Push(index);
+    }
+
+    records_.Clear();
+    handles_.Clear();
+    mapLists_.Clear();
+    typeLists_.Clear();
+}
+
+EntityHandle EntityRegistry::Register(Node* node, unsigned mpoint, StringHash got, int controllertype)
+{
+    if (!node)
+        return ENTITYHANDLE_NONE;
+
+    EntityHandle handle = GetHandle(node->GetID());
+    if (handle != ENTITYHANDLE_NONE)
+    {
+        EntityRecord& record = GetRecordRef(handle);
+        // an other node with the same id (the node has been removed)
+        if (record.node_.Get() != node)
+        {
+            Unregister(handle);
+            return Register(node, mpoint, got, controllertype);
+        }
+
+        SetMapPoint(handle, mpoint);
+        SetControllerType(handle, controllertype);
+        if (record.got_ != got)
+        {
+            RemoveFromList(typeLists_[record.got_], record.typeSlot_, &EntityRecord::typeSlot_);
+            record.got_ = got;
+            AddToList(typeLists_[got], handle, &EntityRecord::typeSlot_);
+        }
+        return handle;
+    }
+
+    unsigned index;
+    if (freeSlots_.Size())
+    {
+        index = freeSlots_.Back();
+        freeSlots_.Pop();
+    }
+    else
+    {
+        index = slots_.Size();
+        if (index > ENTITYHANDLE_INDEXMASK)
+            return ENTITYHANDLE_NONE;
+
+        slots_.Resize(index + 1);
+        slots_[index].generation_ = 1;
+    }
+
+    Slot& slot = slots_[index];
+    slot.dense_ = records_.Size();
+    handle = (slot.generation_ << ENTITYHANDLE_INDEXBITS) | index;
+
+    records_.Resize(records_.Size() + 1);
+    EntityRecord& record = records_.Back();
+    record.node_ = node;
+    record.id_ = node->GetID();
+    record.mpoint_ = mpoint;
+    record.got_ = got;
+    record.controllerType_ = controllertype;
+    record.flags_ = 0;
+    record.handle_ = handle;
+
+    handles_[record.id_] = handle;
+    AddToList(mapLists_[mpoint], handle, &EntityRecord::mapSlot_);
+    AddToList(typeLists_[got], handle, &EntityRecord::typeSlot_);
+
+    return handle;
+}
+
+void EntityRegistry::Unregister(EntityHandle handle)
+{
+    if (!IsValid(handle))
+        return;
+
+    const unsigned index = handle & ENTITYHANDLE_INDEXMASK;
+    Slot& slot = slots_[index];
+    const unsigned dense = slot.dense_;
+
+    {
+        EntityRecord& record = records_[dense];
+        HashMap<unsigned, EntityHandle>::Iterator it = handles_.Find(record.id_);
+        if (it != handles_.End() && it->second_ == handle)
+            handles_.Erase(it);
+
+        RemoveFromList(mapLists_[record.mpoint_], record.mapSlot_, &EntityRecord::mapSlot_);
+        RemoveFromList(typeLists_[record.got_], record.typeSlot_, &EntityRecord::typeSlot_);
+    }
+
+    // move the last record in the hole
+    const unsigned last = records_.Size() - 1;
+    if (dense != last)
+    {
+        records_[dense] = records_[last];
+        slots_[records_[dense].handle_ & ENTITYHANDLE_INDEXMASK].dense_ = dense;
+    }
+    records_.Resize(last);
+
+    // a new generation for the slot : the handle is no more valid
+    slot.generation_ = GetNextGeneration(slot.generation_);
+    freeSlots_.Push(index);
+}
+
+void EntityRegistry::SetMapPoint(EntityHandle handle, unsigned mpoint)
+{
+    if (!IsValid(handle))
+        return;
+
+    EntityRecord& record = GetRecordRef(handle);
+    if (record.mpoint_ == mpoint)
+        return;
+
+    RemoveFromList(mapLists_[record.mpoint_], record.mapSlot_, &EntityRecord::mapSlot_);
+    record.mpoint_ = mpoint;
+    AddToList(mapLists_[mpoint], handle, &EntityRecord::mapSlot_);
+}
+
+void EntityRegistry::SetControllerType(EntityHandle handle, int controllertype)
+{
+    if (IsValid(handle))
+        GetRecordRef(handle).controllerType_ = controllertype;
+}
+
+void EntityRegistry::SetFlags(EntityHandle handle, unsigned flags, bool enable)
+{
+    if (!IsValid(handle))
+        return;
+
+    EntityRecord& record = GetRecordRef(handle);
+    if (enable)
+        record.flags_ |= flags;
+    else
+        record.flags_ &= ~flags;
+}
+
+const PODVector<EntityHandle>& EntityRegistry::GetMapEntities(unsigned mpoint) const
+{
+    HashMap<unsigned, PODVector<EntityHandle> >::ConstIterator it = mapLists_.Find(mpoint);
+    return it != mapLists_.End() ? it->second_ : sEmptyHandles_;
+}
+
+const PODVector<EntityHandle>& EntityRegistry::GetTypeEntities(StringHash got) const
+{
+    HashMap<StringHash, PODVector<EntityHandle> >::ConstIterator it = typeLists_.Find(got);
+    return it != typeLists_.End() ? it->second_ : sEmptyHandles_;
+}
+
+void EntityRegistry::AddToList(PODVector<EntityHandle>& list, EntityHandle handle, unsigned EntityRecord::* slot)
+{
+    GetRecordRef(handle).*slot = list.Size();
+    list.Push(handle);
+}
+
+void EntityRegistry::RemoveFromList(PODVector<EntityHandle>& list, unsigned index, unsigned EntityRecord::* slot)
+{
+    // move the last handle of the list in the hole
+    const EntityHandle last = list.Back();
+    list[index] = last;
+    GetRecordRef(last).*slot = index;
+    list.Pop();
+}
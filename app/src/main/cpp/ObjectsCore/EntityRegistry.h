@@ -0,0 +1,118 @@
+#pragma once
+
+#include <Urho3D/Container/HashMap.h>
+#include <Urho3D/Scene/Node.h>
+
+using namespace Urho3D;
+
+
+/// EntityRegistry : the entities of the world in a dense array, referenced by generational handles.
+/// A handle is the index of a slot and the generation of the slot, the handles of a removed entity are no more valid
+/// when the slot is reused. The hot loops resolve the handles without the hash lookups of Scene::GetNode.
+
+typedef unsigned EntityHandle;
+
+const EntityHandle ENTITYHANDLE_NONE = 0;
+const unsigned ENTITYHANDLE_INDEXBITS = 20;
+const unsigned ENTITYHANDLE_INDEXMASK = (1U << ENTITYHANDLE_INDEXBITS) - 1;
+const unsigned ENTITYHANDLE_GENERATIONMASK = (1U << (32 - ENTITYHANDLE_INDEXBITS)) - 1;
+
+enum EntityFlag
+{
+    ENTITY_MainController = 1 << 0,
+    ENTITY_Dead = 1 << 1
+};
+
+struct EntityRecord
+{
+    WeakPtr<Node> node_;
+    unsigned id_;
+    // the hash of the map point
+    unsigned mpoint_;
+    StringHash got_;
+    int controllerType_;
+    unsigned flags_;
+    EntityHandle handle_;
+    // the indexes in the lists of the map and of the type
+    unsigned mapSlot_, typeSlot_;
+};
+
+class EntityRegistry
+{
+public:
+    EntityRegistry() { }
+
+    static EntityRegistry& Get()
+    {
+        return registry_;
+    }
+
+    void Clear();
+
+    /// Register an entity or update the map point and the type of a registered entity
+    EntityHandle Register(Node* node, unsigned mpoint, StringHash got, int controllertype=0);
+    void Unregister(EntityHandle handle);
+
+    void SetMapPoint(EntityHandle handle, unsigned mpoint);
+    void SetControllerType(EntityHandle handle, int controllertype);
+    void SetFlags(EntityHandle handle, unsigned flags, bool enable);
+
+    bool IsValid(EntityHandle handle) const
+    {
+        const unsigned index = handle & ENTITYHANDLE_INDEXMASK;
+        return index < slots_.Size() && slots_[index].generation_ == handle >> ENTITYHANDLE_INDEXBITS;
+    }
+    /// The node of the entity, 0 if the handle is no more valid or if the node has been removed
+    Node* GetNode(EntityHandle handle) const
+    {
+        return IsValid(handle) ? records_[slots_[handle & ENTITYHANDLE_INDEXMASK].dense_].node_.Get() : 0;
+    }
+    const EntityRecord* GetRecord(EntityHandle handle) const
+    {
+        return IsValid(handle) ? &records_[slots_[handle & ENTITYHANDLE_INDEXMASK].dense_] : 0;
+    }
+    /// The handle of a node id (hash lookup), ENTITYHANDLE_NONE if not registered
+    EntityHandle GetHandle(unsigned nodeid) const
+    {
+        HashMap<unsigned, EntityHandle>::ConstIterator it = handles_.Find(nodeid);
+        return it != handles_.End() ? it->second_ : ENTITYHANDLE_NONE;
+    }
+
+    /// The dense array, to iterate all the entities
+    const Vector<EntityRecord>& GetRecords() const
+    {
+        return records_;
+    }
+    const PODVector<EntityHandle>& GetMapEntities(unsigned mpoint) const;
+    const PODVector<EntityHandle>& GetTypeEntities(StringHash got) const;
+    unsigned GetNumEntities() const
+    {
+        return records_.Size();
+    }
+
+private:
+    struct Slot
+    {
+        unsigned dense_;
+        // never 0 : ENTITYHANDLE_NONE is never valid
+        unsigned generation_;
+    };
+
+    EntityRecord& GetRecordRef(EntityHandle handle)
+    {
+        return records_[slots_[handle & ENTITYHANDLE_INDEXMASK].dense_];
+    }
+    void AddToList(PODVector<EntityHandle>& list, EntityHandle handle, unsigned EntityRecord::* slot);
+    void RemoveFromList(PODVector<EntityHandle>& list, unsigned index, unsigned EntityRecord::* slot);
+
+    PODVector<Slot> slots_;
+    PODVector<unsigned> freeSlots_;
+    Vector<EntityRecord> records_;
+
+    // node id => handle
+    HashMap<unsigned, EntityHandle> handles_;
+    HashMap<unsigned, PODVector<EntityHandle> > mapLists_;
+    HashMap<StringHash, PODVector<EntityHandle> > typeLists_;
+
+    static EntityRegistry registry_;
+};
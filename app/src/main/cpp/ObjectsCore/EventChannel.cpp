@@ -0,0 +1,40 @@
+#include <Urho3D/Core/Context.h>
+
+#include "EventChannel.h"
+
+
+// not a static member : the channels are function-local statics, constructed in any order
+PODVector<EventChannelBase*>& EventChannelBase::GetChannels()
+{
+    static PODVector<EventChannelBase*> channels;
+    return channels;
+}
+
+EventChannelBase::EventChannelBase()
+{
+    GetChannels().Push(this);
+}
+
+EventChannelBase::~EventChannelBase()
+{
+    GetChannels().Remove(this);
+}
+
+void EventChannelBase::FlushAll()
+{
+    PODVector<EventChannelBase*>& channels = GetChannels();
+    for (unsigned i = 0; i < channels.Size(); i++)
+        channels[i]->Flush();
+}
+
+bool EventChannelBase::HasEventReceivers(Object* sender, StringHash eventType)
+{
+    Context* context = sender->GetContext();
+
+    EventReceiverGroup* group = context->GetEventReceivers(sender, eventType);
+    if (group && group->receivers_.Size())
+        return true;
+
+    group = context->GetEventReceivers(eventType);
+    return group && group->receivers_.Size();
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <Urho3D/Container/Ptr.h>
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Object.h>
+
+using namespace Urho3D;
+
+
+/// EventChannel : a typed event with a POD payload T, delivered to a flat list of listeners (receiver + member function)
+/// without VariantMap and without the lookup of the Urho3D event receivers.
+/// A listener listens the events of one sender or of all the senders (sender=0) ; it unsubscribes before the destruction of the receiver and of the sender.
+/// Send delivers the event now, Post queues it until the next flush of the channels (EventChannelBase::FlushAll at the scene post update, see GameContext).
+/// Compatibility bridge : Send sends before the VariantMap event T::GetEventType() if an Urho3D receiver (script, component) is subscribed to it.
+/// T has a "static StringHash GetEventType()" and a "void ToEventData(VariantMap& eventData) const".
+/// The listeners are scanned at each event : a channel is for the events with a few listeners (the managers, some components by sender),
+/// the events with receivers by node and the events subscribed by name from the data (animator templates, trigger events) stay Urho3D events.
+
+class EventChannelBase
+{
+public:
+    EventChannelBase();
+    virtual ~EventChannelBase();
+
+    virtual void Flush() = 0;
+
+    /// Deliver the queued events of all the channels
+    static void FlushAll();
+    /// true if an Urho3D receiver is subscribed to the event of the sender or to the event of all the senders
+    static bool HasEventReceivers(Object* sender, StringHash eventType);
+
+private:
+    static PODVector<EventChannelBase*>& GetChannels();
+};
+
+template <class T> class EventChannel : public EventChannelBase
+{
+public:
+    EventChannel() :
+        dispatching_(0),
+        numHoles_(0) { }
+
+    static EventChannel<T>& Get()
+    {
+        static EventChannel<T> channel;
+        return channel;
+    }
+
+    /// Subscribe : EventChannel<T>::Get().Subscribe<R, &R::HandleEvent>(this) with "void R::HandleEvent(Object* sender, const T& event)"
+    template <class R, void (R::*F)(Object*, const T&)> void Subscribe(R* receiver, Object* sender = 0)
+    {
+        Thunk thunk = &Invoke<R, F>;
+        for (unsigned i = 0; i < listeners_.Size(); i++)
+            if (listeners_[i].receiver_ == receiver && listeners_[i].sender_ == sender && listeners_[i].thunk_ == thunk)
+                return;
+
+        Listener listener = { receiver, sender, thunk };
+        listeners_.Push(listener);
+    }
+    /// Unsubscribe the receiver from all the senders
+    template <class R> void Unsubscribe(R* receiver)
+    {
+        RemoveListeners(receiver);
+    }
+
+    void Send(Object* sender, const T& event)
+    {
+        // compatibility bridge : a local VariantMap, the event data map of the context can be in use by the caller
+        if (sender && HasEventReceivers(sender, T::GetEventType()))
+        {
+            VariantMap eventData;
+            event.ToEventData(eventData);
+            sender->SendEvent(T::GetEventType(), eventData);
+        }
+
+        Dispatch(sender, event);
+    }
+    void Post(Object* sender, const T& event)
+    {
+        queue_.Resize(queue_.Size() + 1);
+        queue_.Back().sender_ = sender;
+        queue_.Back().event_ = event;
+    }
+    virtual void Flush()
+    {
+        // the events posted in the flush are delivered in the flush
+        for (unsigned i = 0; i < queue_.Size(); i++)
+        {
+            // a destroyed sender : only the listeners of all the senders get the event
+            Object* sender = queue_[i].sender_.Get();
+            const T event = queue_[i].event_;
+            if (sender)
+                Send(sender, event);
+            else
+                Dispatch(0, event);
+        }
+        queue_.Clear();
+    }
+
+    unsigned GetNumListeners() const
+    {
+        return listeners_.Size() - numHoles_;
+    }
+    unsigned GetNumQueuedEvents() const
+    {
+        return queue_.Size();
+    }
+
+private:
+    typedef void (*Thunk)(void* receiver, Object* sender, const T& event);
+
+    struct Listener
+    {
+        void* receiver_;
+        Object* sender_;
+        Thunk thunk_;
+    };
+    struct QueuedEvent
+    {
+        WeakPtr<Object> sender_;
+        T event_;
+    };
+
+    template <class R, void (R::*F)(Object*, const T&)> static void Invoke(void* receiver, Object* sender, const T& event)
+    {
+        (static_cast<R*>(receiver)->*F)(sender, event);
+    }
+
+    void Dispatch(Object* sender, const T& event)
+    {
+        dispatching_++;
+
+        // the listeners subscribed in the dispatch don't get this event
+        const unsigned numListeners = listeners_.Size();
+        for (unsigned i = 0; i < numListeners; i++)
+        {
+            const Listener listener = listeners_[i];
+            if (listener.thunk_ && (!listener.sender_ || listener.sender_ == sender))
+                listener.thunk_(listener.receiver_, sender, event);
+        }
+
+        dispatching_--;
+
+        if (!dispatching_ && numHoles_)
+            Compact();
+    }
+    void RemoveListeners(void* receiver)
+    {
+        for (unsigned i = 0; i < listeners_.Size();)
+        {
+            if (listeners_[i].receiver_ != receiver || !listeners_[i].thunk_)
+            {
+                i++;
+            }
+            // in a dispatch : let a hole, the list is compacted at the end of the dispatch
+            else if (dispatching_)
+            {
+                listeners_[i].thunk_ = 0;
+                numHoles_++;
+                i++;
+            }
+            else
+            {
+                listeners_.Erase(i);
+            }
+        }
+    }
+    void Compact()
+    {
+        // keep the order of the subscriptions
+        unsigned j = 0;
+        for (unsigned i = 0; i < listeners_.Size(); i++)
+            if (listeners_[i].thunk_)
+                listeners_[j++] = listeners_[i];
+        listeners_.Resize(j);
+        numHoles_ = 0;
+    }
+
+    PODVector<Listener> listeners_;
+    Vector<QueuedEvent> queue_;
+    unsigned dispatching_;
+    unsigned numHoles_;
+};
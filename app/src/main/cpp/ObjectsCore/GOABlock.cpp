@@ -0,0 +1,126 @@
+#include "GameAttributes.h"
+
+#include "GOABlock.h"
+
+
+HashMap<const Node*, GOABlock*> GOABlock::blocks_;
+PODVector<GOABlock*> GOABlock::dirtyBlocks_;
+
+
+GOABlock::GOABlock() :
+    moveState_(0),
+    keepDirection_(false),
+    dirty_(0),
+    refs_(0),
+    node_(0)
+{ }
+
+GOABlock* GOABlock::Acquire(Node* node)
+{
+    GOABlock*& block = blocks_[node];
+    if (!block)
+    {
+        block = new GOABlock();
+        block->node_ = node;
+        block->Load();
+    }
+
+    block->refs_++;
+    return block;
+}
+
+void GOABlock::Release(GOABlock* block)
+{
+    if (!block || !block->refs_ || --block->refs_)
+        return;
+
+    // the components of a pooled node keep their block : the release is rare
+    block->Flush();
+    dirtyBlocks_.Remove(block);
+    blocks_.Erase(block->node_);
+    delete block;
+}
+
+GOABlock* GOABlock::Get(const Node* node)
+{
+    HashMap<const Node*, GOABlock*>::ConstIterator it = blocks_.Find(node);
+    return it != blocks_.End() ? it->second_ : 0;
+}
+
+void GOABlock::FlushAll()
+{
+    for (unsigned i = 0; i < dirtyBlocks_.Size(); i++)
+        dirtyBlocks_[i]->Flush();
+
+    dirtyBlocks_.Clear();
+}
+
+void GOABlock::LoadAll()
+{
+    for (HashMap<const Node*, GOABlock*>::Iterator it = blocks_.Begin(); it != blocks_.End(); ++it)
+        it->second_->Load();
+}
+
+void GOABlock::Reload(Node* node)
+{
+    GOABlock* block = Get(node);
+    if (block)
+    {
+        if (block->dirty_)
+        {
+            dirtyBlocks_.Remove(block);
+            block->dirty_ = 0;
+        }
+        block->Load();
+    }
+}
+
+void GOABlock::Load(unsigned fields)
+{
+    // keep the dirty fields : they are the last written values
+    fields &= ~dirty_;
+
+    if (fields & GOAB_MoveState)
+        moveState_ = node_->GetVar(GOA::MOVESTATE).GetUInt();
+    if (fields & GOAB_Velocity)
+        velocity_ = node_->GetVar(GOA::VELOCITY).GetVector2();
+    if (fields & GOAB_Direction)
+        direction_ = node_->GetVar(GOA::DIRECTION).GetVector2();
+    if (fields & GOAB_KeepDirection)
+        keepDirection_ = node_->GetVar(GOA::KEEPDIRECTION).GetBool();
+}
+
+void GOABlock::Flush()
+{
+    if (!dirty_ || !node_)
+        return;
+
+    if (dirty_ & GOAB_MoveState)
+        node_->SetVar(GOA::MOVESTATE, moveState_);
+    if (dirty_ & GOAB_Velocity)
+        node_->SetVar(GOA::VELOCITY, velocity_);
+    if (dirty_ & GOAB_Direction)
+        node_->SetVar(GOA::DIRECTION, direction_);
+    if (dirty_ & GOAB_KeepDirection)
+        node_->SetVar(GOA::KEEPDIRECTION, keepDirection_);
+
+    dirty_ = 0;
+}
+
+unsigned GOABlock::GetMoveState(const Node* node)
+{
+    GOABlock* block = Get(node);
+    return block ? block->moveState_ : node->GetVar(GOA::MOVESTATE).GetUInt();
+}
+
+Vector2 GOABlock::GetVelocity(const Node* node)
+{
+    GOABlock* block = Get(node);
+    return block ? block->velocity_ : node->GetVar(GOA::VELOCITY).GetVector2();
+}
+
+Vector2 GOABlock::GetDirection(const Node* node)
+{
+    GOABlock* block = Get(node);
+    return block ? block->direction_ : node->GetVar(GOA::DIRECTION).GetVector2();
+}
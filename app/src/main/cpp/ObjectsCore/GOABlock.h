@@ -0,0 +1,137 @@
+#pragma once
+
+#include <Urho3D/Container/HashMap.h>
+#include <Urho3D/Math/Vector2.h>
+#include <Urho3D/Scene/Node.h>
+
+using namespace Urho3D;
+
+
+/// GOABlock : the hot GOA node variables of a game object in typed fields.
+/// The components handling these variables (GOC_Move2D, GOC_Controller, GOC_Animator2D) keep a pointer to the block of their node :
+/// they read and write the fields without the VariantMap lookup and the Variant conversion.
+/// A write marks the field dirty, the dirty fields are copied in the node variables by GOABlock::FlushAll at the scene post update
+/// (see GameContext) and at the release of the block : the VariantMap stays the reference for the serialization, the network and the scripts.
+/// The other readers use the static getters (block if any, else the node variable).
+
+enum GOABlockField
+{
+    GOAB_MoveState = 1 << 0,
+    GOAB_Velocity = 1 << 1,
+    GOAB_Direction = 1 << 2,
+    GOAB_KeepDirection = 1 << 3,
+
+    GOAB_All = GOAB_MoveState | GOAB_Velocity | GOAB_Direction | GOAB_KeepDirection
+};
+
+class GOABlock
+{
+public:
+    GOABlock();
+
+    /// Get the block of the node (created and loaded from the node variables at the first acquire), one acquire by component
+    static GOABlock* Acquire(Node* node);
+    /// Release the block acquired by a component, the last release flushes the dirty fields and deletes the block
+    static void Release(GOABlock* block);
+    /// The block of the node (hash lookup), 0 if none
+    static GOABlock* Get(const Node* node);
+    /// Copy the dirty fields of all the blocks in the node variables
+    static void FlushAll();
+    /// Reload the not dirty fields of all the blocks (client : the node variables are replicated by the server)
+    static void LoadAll();
+    static unsigned GetNumBlocks()
+    {
+        return blocks_.Size();
+    }
+
+    /// Reload the not dirty fields from the node variables (after a direct change of the variables, a network update or a pool reset)
+    void Load(unsigned fields=GOAB_All);
+    /// Drop the dirty fields of the block of the node and reload all the fields (after a reset of all the node variables)
+    static void Reload(Node* node);
+    /// Copy the dirty fields in the node variables
+    void Flush();
+
+    void SetMoveState(unsigned movestate)
+    {
+        if (movestate != moveState_)
+        {
+            moveState_ = movestate;
+            MarkDirty(GOAB_MoveState);
+        }
+    }
+    void SetVelocity(const Vector2& velocity)
+    {
+        if (velocity != velocity_)
+        {
+            velocity_ = velocity;
+            MarkDirty(GOAB_Velocity);
+        }
+    }
+    void SetDirection(const Vector2& direction)
+    {
+        if (direction != direction_)
+        {
+            direction_ = direction;
+            MarkDirty(GOAB_Direction);
+        }
+    }
+    void SetKeepDirection(bool keepdirection)
+    {
+        if (keepdirection != keepDirection_)
+        {
+            keepDirection_ = keepdirection;
+            MarkDirty(GOAB_KeepDirection);
+        }
+    }
+
+    Node* GetNode() const
+    {
+        return node_;
+    }
+    unsigned GetMoveState() const
+    {
+        return moveState_;
+    }
+    const Vector2& GetVelocity() const
+    {
+        return velocity_;
+    }
+    const Vector2& GetDirection() const
+    {
+        return direction_;
+    }
+    bool GetKeepDirection() const
+    {
+        return keepDirection_;
+    }
+    unsigned GetDirtyFields() const
+    {
+        return dirty_;
+    }
+
+    static unsigned GetMoveState(const Node* node);
+    static Vector2 GetVelocity(const Node* node);
+    static Vector2 GetDirection(const Node* node);
+
+private:
+    void MarkDirty(unsigned field)
+    {
+        if (!dirty_)
+            dirtyBlocks_.Push(this);
+        dirty_ |= field;
+    }
+
+    // the hot fields first
+    unsigned moveState_;
+    Vector2 velocity_;
+    Vector2 direction_;
+    bool keepDirection_;
+    // fields not copied in the node variables
+    unsigned dirty_;
+    // the number of components holding the block
+    unsigned refs_;
+    Node* node_;
+
+    static HashMap<const Node*, GOABlock*> blocks_;
+    static PODVector<GOABlock*> dirtyBlocks_;
+};
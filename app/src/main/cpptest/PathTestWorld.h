@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstdlib>
+#include <vector>
+
+#include "../cpp/AI/PathHierarchy.h"
+
+// Test world : 3x3 maps (map points 0..2), the map y goes up and the tile y goes down like World2D.
+// Walkers can move in all the free tiles but jump only from a support, swimmers only in the water.
+struct TestWorld
+{
+    static const int MAPWIDTH = 20;
+    static const int MAPHEIGHT = 14;
+    static const int NUMMAPS = 3;
+
+    std::vector<unsigned char> blocked_;
+    std::vector<unsigned char> water_;
+    bool maps_[NUMMAPS * NUMMAPS];
+
+    // platforms : a floor every 5 rows with gaps
+    TestWorld(int blockpercent, unsigned seed, bool platforms=false)
+    {
+        blocked_.resize(MAPWIDTH * NUMMAPS * MAPHEIGHT * NUMMAPS);
+        water_.resize(blocked_.size());
+        std::srand(seed);
+        for (unsigned i = 0; i < blocked_.size(); i++)
+        {
+            const bool floor = platforms && (i / (MAPWIDTH * NUMMAPS)) % 5 == 4;
+            blocked_[i] = floor ? std::rand() % 100 >= 12 : std::rand() % 100 < blockpercent;
+            // water in the lowest maps
+            water_[i] = (int)(i / (MAPWIDTH * NUMMAPS)) >= MAPHEIGHT * NUMMAPS - 10;
+        }
+        for (int i = 0; i < NUMMAPS * NUMMAPS; i++)
+            maps_[i] = true;
+    }
+
+    // the world tiles y are between -(NUMMAPS-1)*MAPHEIGHT and MAPHEIGHT
+    int GetIndex(int x, int y) const
+    {
+        return (y + (NUMMAPS-1) * MAPHEIGHT) * MAPWIDTH * NUMMAPS + x;
+    }
+    bool IsInside(int x, int y) const
+    {
+        const int mx = GetPathClusterCoord(x, MAPWIDTH);
+        const int my = -GetPathClusterCoord(y, MAPHEIGHT);
+        return mx >= 0 && mx < NUMMAPS && my >= 0 && my < NUMMAPS && maps_[my * NUMMAPS + mx];
+    }
+    bool IsBlocked(int x, int y) const
+    {
+        return !IsInside(x, y) || blocked_[GetIndex(x, y)];
+    }
+    void SetBlocked(int x, int y, bool blocked)
+    {
+        blocked_[GetIndex(x, y)] = blocked;
+    }
+
+    int GetMapWidth() const
+    {
+        return MAPWIDTH;
+    }
+    int GetMapHeight() const
+    {
+        return MAPHEIGHT;
+    }
+    const void* GetMapStamp(int mx, int my) const
+    {
+        return mx >= 0 && mx < NUMMAPS && my >= 0 && my < NUMMAPS && maps_[my * NUMMAPS + mx] ? &maps_[my * NUMMAPS + mx] : 0;
+    }
+    bool IsPassable(int movetype, int x, int y) const
+    {
+        if (IsBlocked(x, y))
+            return false;
+        return movetype == PMT_Swimmer ? water_[GetIndex(x, y)] != 0 : true;
+    }
+    unsigned GetCost(int movetype, int ax, int ay, int bx, int by) const
+    {
+        const int dx = ax - bx;
+        const int dy = ay - by;
+        if (movetype != PMT_Walker)
+            return dx == 0 || dy == 0 ? 10 : 14;
+        const bool support = IsBlocked(bx, by+1) || IsBlocked(bx-1, by) || IsBlocked(bx+1, by);
+        // jump
+        if (dy > 0)
+            return support ? (dx ? 80 : 60) : PATHSEARCH_NOWAY;
+        // fall
+        if (dy < 0)
+            return dx ? 13 : 9;
+        return support ? 10 : 45;
+    }
+    unsigned GetHeuristic(int movetype, int ax, int ay, int bx, int by) const
+    {
+        const unsigned dx = Abs(ax - bx);
+        const unsigned dy = Abs(ay - by);
+        if (movetype != PMT_Walker)
+            return dx > dy ? dx * 10 + dy * 4 : dy * 10 + dx * 4;
+        const unsigned jcost = ay > by ? dy * 60 : dy * 9;
+        return dx > dy ? dx * 10 + dy * 35 + jcost : dy * 45 + dx * 35 + jcost;
+    }
+};
+
+// Search in the tiles of all the world, with the heuristic to the goal (A* of an agent) or without (reference Dijkstra : the optimal costs, the walker heuristic isn't admissible)
+struct FlatNav
+{
+    FlatNav(const TestWorld& world, int movetype, bool heuristic=false) :
+        world_(world), movetype_(movetype), heuristic_(heuristic), goalx_(0), goaly_(0) { }
+
+    void SetGoal(int x, int y)
+    {
+        goalx_ = x;
+        goaly_ = y;
+    }
+    unsigned GetKey(int x, int y) const
+    {
+        return GetPathSearchKey(0, world_.GetIndex(x, y));
+    }
+    int GetX(unsigned key) const
+    {
+        return GetPathSearchTile(key) % (TestWorld::MAPWIDTH * TestWorld::NUMMAPS);
+    }
+    int GetY(unsigned key) const
+    {
+        return (int)(GetPathSearchTile(key) / (TestWorld::MAPWIDTH * TestWorld::NUMMAPS)) - (TestWorld::NUMMAPS-1) * TestWorld::MAPHEIGHT;
+    }
+
+    unsigned GetNumSlots() const
+    {
+        return 1;
+    }
+    unsigned GetNumTiles() const
+    {
+        return world_.blocked_.size();
+    }
+    unsigned GetNeighbors(unsigned key, unsigned* keys) const
+    {
+        unsigned numneighbors = 0;
+        for (int dy = -1; dy <= 1; dy++)
+            for (int dx = -1; dx <= 1; dx++)
+                if ((dx || dy) && world_.IsPassable(movetype_, GetX(key) + dx, GetY(key) + dy))
+                    keys[numneighbors++] = GetKey(GetX(key) + dx, GetY(key) + dy);
+        return numneighbors;
+    }
+    unsigned GetCost(unsigned from, unsigned to) const
+    {
+        return world_.GetCost(movetype_, GetX(from), GetY(from), GetX(to), GetY(to));
+    }
+    unsigned GetHeuristic(unsigned key) const
+    {
+        return heuristic_ ? world_.GetHeuristic(movetype_, GetX(key), GetY(key), goalx_, goaly_) : 0;
+    }
+    bool IsTimeOut(unsigned) const
+    {
+        return false;
+    }
+
+    const TestWorld& world_;
+    int movetype_;
+    bool heuristic_;
+    int goalx_, goaly_;
+};
+
+// a passable tile in the map (mx,my)
+inline IntVector2 GetRandomTile(const TestWorld& world, int movetype, int mx, int my)
+{
+    for (;;)
+    {
+        const int x = mx * TestWorld::MAPWIDTH + std::rand() % TestWorld::MAPWIDTH;
+        const int y = -my * TestWorld::MAPHEIGHT + std::rand() % TestWorld::MAPHEIGHT;
+        if (world.IsPassable(movetype, x, y))
+            return IntVector2(x, y);
+    }
+}
+
+// a passable tile in all the maps
+inline IntVector2 GetRandomTile(const TestWorld& world, int movetype)
+{
+    for (;;)
+    {
+        const int x = std::rand() % (TestWorld::MAPWIDTH * TestWorld::NUMMAPS);
+        const int y = TestWorld::MAPHEIGHT - 1 - std::rand() % (TestWorld::MAPHEIGHT * TestWorld::NUMMAPS);
+        if (world.IsPassable(movetype, x, y))
+            return IntVector2(x, y);
+    }
+}
@@ -0,0 +1,142 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <string>
+#include <vector>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/Object.h>
+#include <Urho3D/Scene/SceneEvents.h>
+
+#include "../cpp/Components/ComponentUpdater.h"
+
+using namespace Urho3D;
+
+// a component updated by an updater or by an E_SCENEPOSTUPDATE handler like the GOC components before the updaters
+class TestUpdatedComponent : public Object
+{
+    URHO3D_OBJECT(TestUpdatedComponent, Object);
+
+public:
+    TestUpdatedComponent(Context* context) :
+        Object(context),
+        elapsed_(0.f),
+        numUpdates_(0),
+        updaterIndex_(M_MAX_UNSIGNED) { }
+
+    void Update(float timeStep)
+    {
+        elapsed_ += timeStep;
+        numUpdates_++;
+        if (onUpdate_)
+            onUpdate_(this);
+    }
+    void HandleUpdate(StringHash eventType, VariantMap& eventData)
+    {
+        Update(eventData[ScenePostUpdate::P_TIMESTEP].GetFloat());
+    }
+
+    float elapsed_;
+    unsigned numUpdates_;
+    unsigned updaterIndex_;
+    void (*onUpdate_)(TestUpdatedComponent*) = 0;
+};
+
+static ComponentUpdater<TestUpdatedComponent>* sUpdater_ = 0;
+static std::vector<TestUpdatedComponent*>* sComponents_ = 0;
+
+TEST_CASE("ComponentUpdater updates the active components once by pass", "[componentupdater]") {
+    SharedPtr<Context> context(new Context());
+    ComponentUpdater<TestUpdatedComponent> updater(UPDATER_Player + 1);
+
+    std::vector<SharedPtr<TestUpdatedComponent> > components;
+    std::vector<TestUpdatedComponent*> pointers;
+    for (int i = 0; i < 10; i++)
+    {
+        components.push_back(SharedPtr<TestUpdatedComponent>(new TestUpdatedComponent(context)));
+        pointers.push_back(components.back().Get());
+        updater.Add(pointers.back());
+    }
+
+    // adding twice doesn't duplicate
+    updater.Add(pointers[0]);
+    REQUIRE(updater.GetNumComponents() == 10);
+
+    updater.Remove(pointers[3]);
+    REQUIRE_FALSE(updater.Contains(pointers[3]));
+    updater.Update(0.5f);
+    REQUIRE(pointers[3]->numUpdates_ == 0);
+    REQUIRE(pointers[9]->numUpdates_ == 1);
+    REQUIRE(pointers[9]->elapsed_ == 0.5f);
+
+    // the components removed in the pass are not updated after their removal, the added components are updated in the pass
+    sUpdater_ = &updater;
+    sComponents_ = &pointers;
+    pointers[0]->onUpdate_ = [](TestUpdatedComponent* component) {
+        for (unsigned i = 1; i < sComponents_->size(); i++)
+            if (i % 2)
+                sUpdater_->Remove((*sComponents_)[i]);
+        sUpdater_->Add((*sComponents_)[3]);
+    };
+    for (unsigned i = 0; i < pointers.size(); i++)
+        pointers[i]->numUpdates_ = 0;
+
+    updater.Update(0.5f);
+    for (unsigned i = 0; i < pointers.size(); i++)
+        REQUIRE(pointers[i]->numUpdates_ == (i % 2 == 0 || i == 3 ? 1U : 0U));
+    REQUIRE(updater.GetNumComponents() == 6);
+
+    // the list is compacted : the next pass updates the remaining components once
+    pointers[0]->onUpdate_ = 0;
+    for (unsigned i = 0; i < pointers.size(); i++)
+        pointers[i]->numUpdates_ = 0;
+    updater.Update(0.5f);
+    for (unsigned i = 0; i < pointers.size(); i++)
+        REQUIRE(pointers[i]->numUpdates_ == (updater.Contains(pointers[i]) ? 1U : 0U));
+
+    for (unsigned i = 0; i < pointers.size(); i++)
+        updater.Remove(pointers[i]);
+    REQUIRE(updater.GetNumComponents() == 0);
+}
+
+TEST_CASE("ComponentUpdater dispatch benchmark", "[componentupdater][!benchmark]") {
+    const unsigned numcomponents = 2000;
+
+    SharedPtr<Context> context(new Context());
+    SharedPtr<Object> sender(new TestUpdatedComponent(context));
+    ComponentUpdater<TestUpdatedComponent> updater(UPDATER_Player + 1);
+
+    std::vector<SharedPtr<TestUpdatedComponent> > subscribed, updated;
+    for (unsigned i = 0; i < numcomponents; i++)
+    {
+        subscribed.push_back(SharedPtr<TestUpdatedComponent>(new TestUpdatedComponent(context)));
+        subscribed.back()->SubscribeToEvent(sender, E_SCENEPOSTUPDATE, new EventHandlerImpl<TestUpdatedComponent>(subscribed.back(), &TestUpdatedComponent::HandleUpdate));
+
+        updated.push_back(SharedPtr<TestUpdatedComponent>(new TestUpdatedComponent(context)));
+        updater.Add(updated.back());
+    }
+
+    // one frame of the scene : the event of Scene::Update
+    VariantMap& eventData = context->GetEventDataMap();
+    eventData[ScenePostUpdate::P_TIMESTEP] = 0.016f;
+    sender->SendEvent(E_SCENEPOSTUPDATE, eventData);
+    updater.Update(0.016f);
+    REQUIRE(subscribed.back()->numUpdates_ == 1);
+    REQUIRE(updated.back()->numUpdates_ == 1);
+
+    BENCHMARK_ADVANCED("event handlers " + std::to_string(numcomponents))(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            VariantMap& eventData = context->GetEventDataMap();
+            eventData[ScenePostUpdate::P_TIMESTEP] = 0.016f;
+            sender->SendEvent(E_SCENEPOSTUPDATE, eventData);
+            return subscribed.back()->numUpdates_;
+        });
+    };
+
+    BENCHMARK_ADVANCED("component updater " + std::to_string(numcomponents))(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            updater.Update(0.016f);
+            return updated.back()->numUpdates_;
+        });
+    };
+}
@@ -0,0 +1,311 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+#include "../cpp/Map/ConnectPlane.h"
+
+using namespace Urho3D;
+
+static const FeatureType SOLID = MapFeatureType::RoomWall;
+static const FeatureType EMPTY = MapFeatureType::NoMapFeature;
+
+// Reference : the per-tile setters of ObjectSkinned before the table (Tile::GetConnectIndexNghb4 and Tile::GetCornerIndex),
+// on a map with a one-tile empty ring so the border tiles use the same setter as the inner tiles.
+struct RefMap
+{
+    RefMap(int width, int height) :
+        width_(width+2),
+        features_((width+2) * (height+2), EMPTY)
+    {
+        nghTable4_[TopBit] = -width_;
+        nghTable4_[RightBit] = 1;
+        nghTable4_[BottomBit] = width_;
+        nghTable4_[LeftBit] = -1;
+        nghCorner_[TopLeftBit] = -width_-1;
+        nghCorner_[TopRightBit] = -width_+1;
+        nghCorner_[BottomRightBit] = width_+1;
+        nghCorner_[BottomLeftBit] = width_-1;
+    }
+
+    FeatureType& At(int x, int y)
+    {
+        return features_[(y+1) * width_ + x+1];
+    }
+
+    int GetConnectIndexNghb4(unsigned addr) const
+    {
+        const FeatureType* dataMap = &features_[0];
+        if (dataMap[addr] <= MapFeatureType::InnerSpace) return MapTilesConnectType::NoConnect;
+
+        int connectIndex = MapTilesConnectType::NoConnect;
+
+        if (dataMap[addr+nghTable4_[TopBit]] > MapFeatureType::InnerSpace) connectIndex = connectIndex | TopSide;
+        if (dataMap[addr+nghTable4_[RightBit]] > MapFeatureType::InnerSpace) connectIndex = connectIndex | RightSide;
+        if (dataMap[addr+nghTable4_[BottomBit]] > MapFeatureType::InnerSpace) connectIndex = connectIndex | BottomSide;
+        if (dataMap[addr+nghTable4_[LeftBit]] > MapFeatureType::InnerSpace) connectIndex = connectIndex | LeftSide;
+
+        return connectIndex;
+    }
+
+    bool IsEmpty(unsigned addr, int corner) const
+    {
+        return features_[addr+nghCorner_[corner]] <= MapFeatureType::InnerSpace;
+    }
+
+    void GetCornerIndex(unsigned addr, ConnectIndex& index) const
+    {
+        bool cornerCheck1, cornerCheck2;
+
+        switch (index)
+        {
+        case MapTilesConnectType::TopRightConnect :
+            if (IsEmpty(addr, TopRightBit))
+                index = MapTilesConnectType::TopRightConnect_Corner;
+            break;
+        case MapTilesConnectType::BottomRightConnect :
+            if (IsEmpty(addr, BottomRightBit))
+                index = MapTilesConnectType::BottomRightConnect_Corner;
+            break;
+        case MapTilesConnectType::TopLeftConnect :
+            if (IsEmpty(addr, TopLeftBit))
+                index = MapTilesConnectType::TopLeftConnect_Corner;
+            break;
+        case MapTilesConnectType::BottomLeftConnect :
+            if (IsEmpty(addr, BottomLeftBit))
+                index = MapTilesConnectType::BottomLeftConnect_Corner;
+            break;
+        case MapTilesConnectType::TopRightBottomConnect :
+            cornerCheck1 = IsEmpty(addr, BottomRightBit);
+            cornerCheck2 = IsEmpty(addr, TopRightBit);
+            if (cornerCheck1 || cornerCheck2)
+            {
+                if (cornerCheck1 && cornerCheck2)
+                    index = MapTilesConnectType::TopRightBottomConnect_CornerTopBottom;
+                else
+                    index = cornerCheck1 ? MapTilesConnectType::TopRightBottomConnect_CornerBottom :
+                            MapTilesConnectType::TopRightBottomConnect_CornerTop;
+            }
+            break;
+        case MapTilesConnectType::TopRightLeftConnect :
+            cornerCheck1 = IsEmpty(addr, TopRightBit);
+            cornerCheck2 = IsEmpty(addr, TopLeftBit);
+            if (cornerCheck1 || cornerCheck2)
+            {
+                if (cornerCheck1 && cornerCheck2)
+                    index = MapTilesConnectType::TopRightLeftConnect_CornerRightLeft;
+                else
+                    index = cornerCheck1 ? MapTilesConnectType::TopRightLeftConnect_CornerRight :
+                            MapTilesConnectType::TopRightLeftConnect_CornerLeft;
+            }
+            break;
+        case MapTilesConnectType::TopBottomLeftConnect :
+            cornerCheck1 = IsEmpty(addr, TopLeftBit);
+            cornerCheck2 = IsEmpty(addr, BottomLeftBit);
+            if (cornerCheck1 || cornerCheck2)
+            {
+                if (cornerCheck1 && cornerCheck2)
+                    index = MapTilesConnectType::TopBottomLeftConnect_CornerTopBottom;
+                else
+                    index = cornerCheck1 ? MapTilesConnectType::TopBottomLeftConnect_CornerTop :
+                            MapTilesConnectType::TopBottomLeftConnect_CornerBottom;
+            }
+            break;
+        case MapTilesConnectType::RightBottomLeftConnect :
+            cornerCheck1 = IsEmpty(addr, BottomLeftBit);
+            cornerCheck2 = IsEmpty(addr, BottomRightBit);
+            if (cornerCheck1 || cornerCheck2)
+            {
+                if (cornerCheck1 && cornerCheck2)
+                    index = MapTilesConnectType::RightBottomLeftConnect_CornerRightLeft;
+                else
+                    index = cornerCheck1 ? MapTilesConnectType::RightBottomLeftConnect_CornerLeft :
+                            MapTilesConnectType::RightBottomLeftConnect_CornerRight;
+            }
+            break;
+        case MapTilesConnectType::AllConnect :
+        {
+            int cornerValue = NoCorner;
+            int numCorners = 0;
+            if (IsEmpty(addr, TopLeftBit))
+            {
+                cornerValue = cornerValue | TopLeftCorner;
+                numCorners++;
+            }
+            if (IsEmpty(addr, TopRightBit))
+            {
+                cornerValue = cornerValue | TopRightCorner;
+                numCorners++;
+            }
+            if (IsEmpty(addr, BottomRightBit))
+            {
+                cornerValue = cornerValue | BottomRightCorner;
+                numCorners++;
+            }
+            if (IsEmpty(addr, BottomLeftBit))
+            {
+                cornerValue = cornerValue | BottomLeftCorner;
+                numCorners++;
+            }
+
+            if (!numCorners)
+                break;
+
+            if (numCorners == 4)
+                index = MapTilesConnectType::AllConnect_C4;
+            else if (numCorners == 1)
+            {
+                if (cornerValue == TopLeftCorner)
+                    index = MapTilesConnectType::AllConnect_C1_TopLeft;
+                else if (cornerValue == TopRightCorner)
+                    index = MapTilesConnectType::AllConnect_C1_TopRight;
+                else if (cornerValue == BottomRightCorner)
+                    index = MapTilesConnectType::AllConnect_C1_BottomRight;
+                else
+                    index = MapTilesConnectType::AllConnect_C1_BottomLeft;
+            }
+            else if (numCorners == 2)
+            {
+                if (cornerValue == (TopLeftCorner | TopRightCorner))
+                    index = MapTilesConnectType::AllConnect_C2_TopLeftRight;
+                else if (cornerValue == (BottomRightCorner | BottomLeftCorner))
+                    index = MapTilesConnectType::AllConnect_C2_BottomRightLeft;
+                else if (cornerValue == (TopRightCorner | BottomRightCorner))
+                    index = MapTilesConnectType::AllConnect_C2_TopBottomRight;
+                else if (cornerValue == (TopLeftCorner | BottomLeftCorner))
+                    index = MapTilesConnectType::AllConnect_C2_TopBottomLeft;
+                else if (cornerValue == (TopLeftCorner | BottomRightCorner))
+                    index = MapTilesConnectType::AllConnect_C2_TopLeft_BottomRight;
+                else
+                    index = MapTilesConnectType::AllConnect_C2_TopRight_BottomLeft;
+            }
+            else
+            {
+                if (cornerValue == (TopLeftCorner | TopRightCorner | BottomLeftCorner))
+                    index = MapTilesConnectType::AllConnect_C3_NoBottomRightCorner;
+                else if (cornerValue == (TopLeftCorner | TopRightCorner | BottomRightCorner))
+                    index = MapTilesConnectType::AllConnect_C3_NoBottomLeftCorner;
+                else if (cornerValue == (BottomLeftCorner | BottomRightCorner | TopLeftCorner))
+                    index = MapTilesConnectType::AllConnect_C3_NoTopRightCorner;
+                else
+                    index = MapTilesConnectType::AllConnect_C3_NoTopLeftCorner;
+            }
+            break;
+        }
+        default :
+            break;
+        }
+    }
+
+    // the connect index of the old setters in Connected4 (corners=false) and Connected8 (corners=true)
+    ConnectIndex GetConnectIndex(int x, int y, bool corners) const
+    {
+        const unsigned addr = (y+1) * width_ + x+1;
+        if (features_[addr] < MapFeatureType::NoRender)
+            return MapTilesConnectType::Void;
+
+        ConnectIndex index = GetConnectIndexNghb4(addr);
+        if (corners && index > 2)
+            GetCornerIndex(addr, index);
+        return index;
+    }
+
+    int width_;
+    std::vector<FeatureType> features_;
+    short int nghTable4_[4];
+    short int nghCorner_[4];
+};
+
+// the 3x3 neighborhood of the center tile by mask (bit i for the neighbor i, the center is skipped)
+static void SetNeighborhood(RefMap& ref, std::vector<FeatureType>& features, int mask, FeatureType center)
+{
+    int bit = 0;
+    for (int y = 0; y < 3; y++)
+        for (int x = 0; x < 3; x++)
+        {
+            FeatureType feature = center;
+            if (x != 1 || y != 1)
+                feature = mask & (1 << bit++) ? SOLID : EMPTY;
+            features[y*3 + x] = feature;
+            ref.At(x, y) = feature;
+        }
+}
+
+TEST_CASE("ConnectPlane gives the connect indexes of the old setters for the 256 neighborhoods", "[connectplane]") {
+    RefMap ref(3, 3);
+    std::vector<FeatureType> features(9);
+    ConnectIndex connections[9];
+    ConnectPlane plane;
+
+    for (int mask = 0; mask < 256; mask++)
+    {
+        SetNeighborhood(ref, features, mask, SOLID);
+        plane.Update(&features[0], 3, 3, 0, 2);
+
+        plane.SetConnectIndexes(&features[0], connections, IntRect(0, 0, 2, 2), false);
+        REQUIRE(connections[4] == ref.GetConnectIndex(1, 1, false));
+
+        plane.SetConnectIndexes(&features[0], connections, IntRect(0, 0, 2, 2), true);
+        REQUIRE(connections[4] == ref.GetConnectIndex(1, 1, true));
+
+        // the border tiles of the patch
+        for (int i = 0; i < 9; i++)
+            REQUIRE(connections[i] == ref.GetConnectIndex(i % 3, i / 3, true));
+    }
+
+    // the features under NoRender are Void, whatever their neighbors
+    for (int center = 0; center < (int)MAPFEATURES_SIZE; center++)
+    {
+        SetNeighborhood(ref, features, 0xFF, (FeatureType)center);
+        plane.Update(&features[0], 3, 3, 0, 2);
+        plane.SetConnectIndexes(&features[0], connections, IntRect(1, 1, 1, 1), true);
+        REQUIRE(connections[4] == ref.GetConnectIndex(1, 1, true));
+    }
+}
+
+TEST_CASE("ConnectPlane matches the old setters on a map across the words and after edits", "[connectplane]") {
+    const int width = 150, height = 40;
+    RefMap ref(width, height);
+    std::vector<FeatureType> features(width * height);
+    std::vector<ConnectIndex> connections(width * height);
+
+    unsigned seed = 12345;
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+        {
+            seed = seed * 1103515245U + 12345U;
+            const FeatureType feature = (FeatureType)((seed >> 16) % MAPFEATURES_SIZE);
+            features[y*width + x] = feature;
+            ref.At(x, y) = feature;
+        }
+
+    ConnectPlane plane;
+    plane.Update(&features[0], width, height, 0, height-1);
+
+    for (int corners = 0; corners < 2; corners++)
+    {
+        plane.SetConnectIndexes(&features[0], &connections[0], IntRect(0, 0, width-1, height-1), corners != 0);
+        for (int y = 0; y < height; y++)
+            for (int x = 0; x < width; x++)
+                REQUIRE(connections[y*width + x] == ref.GetConnectIndex(x, y, corners != 0));
+    }
+
+    // the edits of ObjectSkinned::SetConnectedTiles : the rows around the tile, the tile and its neighbors
+    const int edits[][2] = { {63, 10}, {64, 11}, {0, 0}, {149, 39}, {127, 20}, {128, 0} };
+    for (unsigned i = 0; i < sizeof(edits) / sizeof(edits[0]); i++)
+    {
+        const int x = edits[i][0], y = edits[i][1];
+        const FeatureType feature = features[y*width + x] > MapFeatureType::InnerSpace ? EMPTY : SOLID;
+        features[y*width + x] = feature;
+        ref.At(x, y) = feature;
+
+        plane.Update(&features[0], width, height, y > 1 ? y-2 : 0, y+2 < height ? y+2 : height-1);
+        for (int yi = y-1; yi <= y+1; yi++)
+            for (int xi = x-1; xi <= x+1; xi++)
+                if (xi >= 0 && yi >= 0 && xi < width && yi < height)
+                    plane.SetConnectIndexes(&features[0], &connections[0], IntRect(xi, yi, xi, yi), true);
+
+        for (int yi = 0; yi < height; yi++)
+            for (int xi = 0; xi < width; xi++)
+                REQUIRE(connections[yi*width + xi] == ref.GetConnectIndex(xi, yi, true));
+    }
+}
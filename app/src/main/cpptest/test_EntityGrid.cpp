@@ -0,0 +1,193 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "../cpp/Map/EntityGrid.h"
+
+// Test world : 3x3 maps of 64x40 tiles of 0.32 (the World2D default sizes), the entities are in the lists of their maps like World2D.
+struct TestEntities
+{
+    static const int NUMMAPS = 3;
+    static const int NUMTYPES = 4;
+
+    const float tilesize_;
+    const float mapwidth_, mapheight_;
+
+    std::vector<Vector2> positions_;
+    std::vector<unsigned> types_;
+    std::vector<bool> removed_;
+    std::vector<std::vector<unsigned> > mapEntities_;
+
+    EntityGrid grid_;
+
+    TestEntities(unsigned numentities, unsigned seed) :
+        tilesize_(0.32f), mapwidth_(64 * tilesize_), mapheight_(40 * tilesize_),
+        mapEntities_(NUMMAPS * NUMMAPS), grid_(ENTITYGRID_CELLTILES * tilesize_)
+    {
+        std::srand(seed);
+        for (unsigned id = 0; id < numentities; id++)
+        {
+            positions_.push_back(GetRandomPosition());
+            types_.push_back(1 + std::rand() % NUMTYPES);
+            removed_.push_back(false);
+            mapEntities_[GetMap(positions_[id])].push_back(id);
+            grid_.Insert(id, positions_[id], StringHash(types_[id]));
+        }
+    }
+
+    float GetRandom(float range) const
+    {
+        return range * (float)std::rand() / ((float)RAND_MAX + 1.f);
+    }
+    Vector2 GetRandomPosition() const
+    {
+        return Vector2(GetRandom(NUMMAPS * mapwidth_), GetRandom(NUMMAPS * mapheight_));
+    }
+    int GetMap(const Vector2& position) const
+    {
+        return (int)(position.y_ / mapheight_) * NUMMAPS + (int)(position.x_ / mapwidth_);
+    }
+
+    void Move(unsigned id, const Vector2& position)
+    {
+        std::vector<unsigned>& from = mapEntities_[GetMap(positions_[id])];
+        from.erase(std::find(from.begin(), from.end(), id));
+        positions_[id] = position;
+        mapEntities_[GetMap(position)].push_back(id);
+        grid_.Move(id, position);
+    }
+    void Remove(unsigned id)
+    {
+        std::vector<unsigned>& from = mapEntities_[GetMap(positions_[id])];
+        from.erase(std::find(from.begin(), from.end(), id));
+        removed_[id] = true;
+        grid_.Remove(id);
+    }
+
+    // the scan of the entity lists of the maps overlapping the rects, deduped like World2D::GetVisibleEntities
+    void ScanMaps(const Rect* rects, unsigned numrects, PODVector<unsigned>& ids, unsigned type) const
+    {
+        for (unsigned r = 0; r < numrects; r++)
+        {
+            const Rect& rect = rects[r];
+            const int xmin = std::max(0, (int)(rect.min_.x_ / mapwidth_));
+            const int xmax = std::min(NUMMAPS - 1, (int)(rect.max_.x_ / mapwidth_));
+            const int ymin = std::max(0, (int)(rect.min_.y_ / mapheight_));
+            const int ymax = std::min(NUMMAPS - 1, (int)(rect.max_.y_ / mapheight_));
+            for (int y = ymin; y <= ymax; y++)
+                for (int x = xmin; x <= xmax; x++)
+                {
+                    const std::vector<unsigned>& entities = mapEntities_[y * NUMMAPS + x];
+                    for (unsigned i = 0; i < entities.size(); i++)
+                    {
+                        const unsigned id = entities[i];
+                        const Vector2& position = positions_[id];
+                        if ((type && types_[id] != type) || position.x_ < rect.min_.x_ || position.x_ > rect.max_.x_ ||
+                            position.y_ < rect.min_.y_ || position.y_ > rect.max_.y_)
+                            continue;
+                        if (ids.Contains(id))
+                            continue;
+                        ids.Push(id);
+                    }
+                }
+        }
+    }
+    void ScanRadius(const Vector2& center, float radius, PODVector<unsigned>& ids, unsigned type) const
+    {
+        for (unsigned id = 0; id < positions_.size(); id++)
+        {
+            if (!removed_[id] && (!type || types_[id] == type) && (positions_[id] - center).LengthSquared() <= radius * radius)
+                ids.Push(id);
+        }
+    }
+};
+
+static std::vector<unsigned> Sorted(const PODVector<unsigned>& ids)
+{
+    std::vector<unsigned> sorted(ids.Begin(), ids.End());
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+TEST_CASE("EntityGrid gives the entities of the map scans", "[entitygrid]") {
+    TestEntities entities(2000, 7);
+
+    // move a half, remove a tenth
+    for (unsigned id = 0; id < 2000; id += 2)
+        entities.Move(id, entities.GetRandomPosition());
+    for (unsigned id = 1; id < 2000; id += 10)
+        entities.Remove(id);
+
+    REQUIRE(entities.grid_.GetNumEntities() == 1800);
+
+    PODVector<unsigned> ids, refids;
+    for (int i = 0; i < 200; i++)
+    {
+        const Vector2 center = entities.GetRandomPosition();
+        const Vector2 halfsize(entities.GetRandom(15.f), entities.GetRandom(10.f));
+        const unsigned type = i % 2 ? 1 + i % TestEntities::NUMTYPES : 0;
+
+        // two overlapping viewports
+        const Rect rects[2] = { Rect(center.x_ - halfsize.x_, center.y_ - halfsize.y_, center.x_ + halfsize.x_, center.y_ + halfsize.y_),
+                                Rect(center.x_, center.y_ - halfsize.y_, center.x_ + 2.f * halfsize.x_, center.y_ + halfsize.y_) };
+        const unsigned numrects = 1 + i % 2;
+
+        ids.Clear();
+        refids.Clear();
+        entities.grid_.Query(rects, numrects, ids, type ? StringHash(type) : StringHash::ZERO);
+        entities.ScanMaps(rects, numrects, refids, type);
+        REQUIRE(ids.Size() == refids.Size());
+        REQUIRE(Sorted(ids) == Sorted(refids));
+
+        ids.Clear();
+        refids.Clear();
+        entities.grid_.QueryRadius(center, halfsize.x_, ids, type ? StringHash(type) : StringHash::ZERO);
+        entities.ScanRadius(center, halfsize.x_, refids, type);
+        REQUIRE(Sorted(ids) == Sorted(refids));
+    }
+
+    // the empty cells are released
+    for (unsigned id = 0; id < 2000; id++)
+        if (!entities.removed_[id])
+            entities.Remove(id);
+
+    REQUIRE(entities.grid_.GetNumEntities() == 0);
+    REQUIRE(entities.grid_.GetNumCells() == 0);
+}
+
+TEST_CASE("EntityGrid viewport benchmark", "[entitygrid][!benchmark]") {
+    const unsigned numentities = 5000;
+    TestEntities entities(numentities, 11);
+
+    // the viewport of the World2D camera centered on the middle map
+    const Vector2 center(1.5f * entities.mapwidth_, 1.5f * entities.mapheight_);
+    const Rect viewport(center.x_ - 10.f, center.y_ - 6.f, center.x_ + 10.f, center.y_ + 6.f);
+
+    PODVector<unsigned> ids, refids;
+    entities.grid_.Query(viewport, ids);
+    entities.ScanMaps(&viewport, 1, refids, 0);
+    REQUIRE(Sorted(ids) == Sorted(refids));
+
+    WARN(std::to_string(numentities) + " entities, " + std::to_string(ids.Size()) + " in the viewport, " +
+         std::to_string(entities.grid_.GetNumCells()) + " cells");
+
+    BENCHMARK_ADVANCED("map scans " + std::to_string(numentities))(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            refids.Clear();
+            entities.ScanMaps(&viewport, 1, refids, 0);
+            return refids.Size();
+        });
+    };
+
+    BENCHMARK_ADVANCED("entity grid " + std::to_string(numentities))(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            ids.Clear();
+            entities.grid_.Query(viewport, ids);
+            return ids.Size();
+        });
+    };
+}
@@ -0,0 +1,153 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Scene/Scene.h>
+
+#include "../cpp/ObjectsCore/EntityRegistry.h"
+
+static std::vector<EntityHandle> Sorted(const PODVector<EntityHandle>& handles)
+{
+    std::vector<EntityHandle> sorted(handles.Begin(), handles.End());
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+static std::vector<EntityHandle> Sorted(std::vector<EntityHandle> handles)
+{
+    std::sort(handles.begin(), handles.end());
+    return handles;
+}
+
+TEST_CASE("EntityRegistry invalidates the handles of the removed entities", "[entityregistry]") {
+    SharedPtr<Context> context(new Context());
+    SharedPtr<Scene> scene(new Scene(context));
+    EntityRegistry registry;
+
+    Node* node1 = scene->CreateChild(String::EMPTY, LOCAL);
+    Node* node2 = scene->CreateChild(String::EMPTY, LOCAL);
+    Node* node3 = scene->CreateChild(String::EMPTY, LOCAL);
+
+    const EntityHandle handle1 = registry.Register(node1, 1, StringHash(10), 0x20);
+    const EntityHandle handle2 = registry.Register(node2, 1, StringHash(11));
+    const EntityHandle handle3 = registry.Register(node3, 2, StringHash(10));
+
+    REQUIRE(handle1 != ENTITYHANDLE_NONE);
+    REQUIRE(registry.GetNumEntities() == 3);
+    REQUIRE(registry.GetNode(handle2) == node2);
+    REQUIRE(registry.GetHandle(node3->GetID()) == handle3);
+    REQUIRE(registry.GetRecord(handle1)->controllerType_ == 0x20);
+    REQUIRE(registry.GetMapEntities(1).Size() == 2);
+    REQUIRE(registry.GetTypeEntities(StringHash(10)).Size() == 2);
+
+    // registering again updates the record
+    REQUIRE(registry.Register(node2, 2, StringHash(10)) == handle2);
+    REQUIRE(registry.GetMapEntities(1).Size() == 1);
+    REQUIRE(registry.GetMapEntities(2).Size() == 2);
+    REQUIRE(registry.GetTypeEntities(StringHash(11)).Size() == 0);
+
+    registry.SetFlags(handle3, ENTITY_MainController | ENTITY_Dead, true);
+    registry.SetFlags(handle3, ENTITY_Dead, false);
+    REQUIRE(registry.GetRecord(handle3)->flags_ == ENTITY_MainController);
+
+    // swap-remove : the other handles stay valid
+    registry.Unregister(handle1);
+    REQUIRE_FALSE(registry.IsValid(handle1));
+    REQUIRE(registry.GetNode(handle1) == 0);
+    REQUIRE(registry.GetHandle(node1->GetID()) == ENTITYHANDLE_NONE);
+    REQUIRE(registry.GetNode(handle2) == node2);
+    REQUIRE(registry.GetNode(handle3) == node3);
+    REQUIRE(registry.GetRecord(handle3)->flags_ == ENTITY_MainController);
+
+    // the slot is reused with an other generation
+    Node* node4 = scene->CreateChild(String::EMPTY, LOCAL);
+    const EntityHandle handle4 = registry.Register(node4, 1, StringHash(10));
+    REQUIRE((handle4 & ENTITYHANDLE_INDEXMASK) == (handle1 & ENTITYHANDLE_INDEXMASK));
+    REQUIRE(handle4 != handle1);
+    REQUIRE_FALSE(registry.IsValid(handle1));
+    REQUIRE(registry.GetNode(handle4) == node4);
+
+    // a removed node isn't returned
+    node4->Remove();
+    REQUIRE(registry.GetNode(handle4) == 0);
+
+    registry.Clear();
+    REQUIRE(registry.GetNumEntities() == 0);
+    REQUIRE_FALSE(registry.IsValid(handle2));
+    REQUIRE(registry.GetMapEntities(2).Size() == 0);
+    REQUIRE_FALSE(registry.IsValid(ENTITYHANDLE_NONE));
+}
+
+TEST_CASE("EntityRegistry keeps the lists of the maps and of the types", "[entityregistry]") {
+    SharedPtr<Context> context(new Context());
+    SharedPtr<Scene> scene(new Scene(context));
+    EntityRegistry registry;
+
+    const unsigned NUMMAPS = 4;
+    const unsigned NUMTYPES = 3;
+
+    std::vector<Node*> nodes;
+    std::vector<EntityHandle> handles;
+    std::vector<unsigned> maps, types;
+
+    std::srand(3);
+    for (int i = 0; i < 3000; i++)
+    {
+        const int action = handles.size() ? std::rand() % 3 : 0;
+        if (action == 0)
+        {
+            Node* node = scene->CreateChild(String::EMPTY, LOCAL);
+            nodes.push_back(node);
+            maps.push_back(std::rand() % NUMMAPS);
+            types.push_back(1 + std::rand() % NUMTYPES);
+            handles.push_back(registry.Register(node, maps.back(), StringHash(types.back())));
+        }
+        else
+        {
+            const unsigned index = std::rand() % handles.size();
+            if (action == 1)
+            {
+                maps[index] = std::rand() % NUMMAPS;
+                registry.SetMapPoint(handles[index], maps[index]);
+            }
+            else
+            {
+                registry.Unregister(handles[index]);
+                REQUIRE_FALSE(registry.IsValid(handles[index]));
+                nodes.erase(nodes.begin() + index);
+                handles.erase(handles.begin() + index);
+                maps.erase(maps.begin() + index);
+                types.erase(types.begin() + index);
+            }
+        }
+    }
+
+    REQUIRE(registry.GetNumEntities() == handles.size());
+
+    for (unsigned i = 0; i < handles.size(); i++)
+    {
+        REQUIRE(registry.GetNode(handles[i]) == nodes[i]);
+        REQUIRE(registry.GetHandle(nodes[i]->GetID()) == handles[i]);
+    }
+
+    for (unsigned mpoint = 0; mpoint < NUMMAPS; mpoint++)
+    {
+        std::vector<EntityHandle> refhandles;
+        for (unsigned i = 0; i < handles.size(); i++)
+            if (maps[i] == mpoint)
+                refhandles.push_back(handles[i]);
+        REQUIRE(Sorted(registry.GetMapEntities(mpoint)) == Sorted(refhandles));
+    }
+
+    for (unsigned type = 1; type <= NUMTYPES; type++)
+    {
+        std::vector<EntityHandle> refhandles;
+        for (unsigned i = 0; i < handles.size(); i++)
+            if (types[i] == type)
+                refhandles.push_back(handles[i]);
+        REQUIRE(Sorted(registry.GetTypeEntities(StringHash(type))) == Sorted(refhandles));
+    }
+}
@@ -0,0 +1,246 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <string>
+#include <vector>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/Object.h>
+
+#include "../cpp/ObjectsCore/EventChannel.h"
+
+using namespace Urho3D;
+
+URHO3D_EVENT(TEST_HOTEVENT, Test_HotEvent)
+{
+    URHO3D_PARAM(P_ID, Id);
+    URHO3D_PARAM(P_VALUE, Value);
+}
+
+// a typed payload like GoDestroyEvent
+struct TestHotEvent
+{
+    static StringHash GetEventType() { return TEST_HOTEVENT; }
+    void ToEventData(VariantMap& eventData) const
+    {
+        eventData[Test_HotEvent::P_ID] = id_;
+        eventData[Test_HotEvent::P_VALUE] = value_;
+    }
+
+    unsigned id_;
+    int value_;
+};
+
+class TestListener : public Object
+{
+    URHO3D_OBJECT(TestListener, Object);
+
+public:
+    TestListener(Context* context, int tag = 0) :
+        Object(context),
+        tag_(tag),
+        numEvents_(0),
+        sum_(0),
+        lastSender_(0) { }
+
+    void HandleEvent(Object* sender, const TestHotEvent& event)
+    {
+        numEvents_++;
+        sum_ += event.value_;
+        lastSender_ = sender;
+        if (order_)
+            order_->push_back(tag_);
+        if (onEvent_)
+            onEvent_(this);
+    }
+    void HandleVariantEvent(StringHash eventType, VariantMap& eventData)
+    {
+        numEvents_++;
+        sum_ += eventData[Test_HotEvent::P_VALUE].GetInt();
+    }
+
+    int tag_;
+    unsigned numEvents_;
+    int sum_;
+    Object* lastSender_;
+    void (*onEvent_)(TestListener*) = 0;
+
+    static std::vector<int>* order_;
+};
+
+std::vector<int>* TestListener::order_ = 0;
+
+static EventChannel<TestHotEvent>* sChannel_ = 0;
+static std::vector<SharedPtr<TestListener> >* sListeners_ = 0;
+
+TEST_CASE("EventChannel delivers to the listeners of the sender and of all the senders", "[eventchannel]") {
+    SharedPtr<Context> context(new Context());
+    EventChannel<TestHotEvent> channel;
+
+    SharedPtr<TestListener> sender1(new TestListener(context));
+    SharedPtr<TestListener> sender2(new TestListener(context));
+
+    std::vector<SharedPtr<TestListener> > listeners;
+    for (int i = 0; i < 4; i++)
+        listeners.push_back(SharedPtr<TestListener>(new TestListener(context, i)));
+
+    channel.Subscribe<TestListener, &TestListener::HandleEvent>(listeners[0]);
+    channel.Subscribe<TestListener, &TestListener::HandleEvent>(listeners[1], sender1);
+    channel.Subscribe<TestListener, &TestListener::HandleEvent>(listeners[2]);
+    channel.Subscribe<TestListener, &TestListener::HandleEvent>(listeners[3], sender2);
+    // subscribing twice doesn't duplicate
+    channel.Subscribe<TestListener, &TestListener::HandleEvent>(listeners[0]);
+    REQUIRE(channel.GetNumListeners() == 4);
+
+    std::vector<int> order;
+    TestListener::order_ = &order;
+    TestHotEvent event = { 1, 10 };
+    channel.Send(sender1, event);
+    REQUIRE(listeners[0]->numEvents_ == 1);
+    REQUIRE(listeners[1]->numEvents_ == 1);
+    REQUIRE(listeners[2]->numEvents_ == 1);
+    REQUIRE(listeners[3]->numEvents_ == 0);
+    REQUIRE(listeners[1]->lastSender_ == sender1.Get());
+    // in the order of the subscriptions
+    REQUIRE(order == std::vector<int>({ 0, 1, 2 }));
+
+    channel.Unsubscribe(listeners[0].Get());
+    channel.Send(sender2, event);
+    REQUIRE(listeners[0]->numEvents_ == 1);
+    REQUIRE(listeners[3]->numEvents_ == 1);
+    REQUIRE(listeners[3]->sum_ == 10);
+    REQUIRE(channel.GetNumListeners() == 3);
+
+    // the listeners unsubscribed in the dispatch don't get the event, the others get it once
+    sChannel_ = &channel;
+    sListeners_ = &listeners;
+    listeners[1]->onEvent_ = [](TestListener* listener) {
+        sChannel_->Unsubscribe(listener);
+        sChannel_->Unsubscribe((*sListeners_)[2].Get());
+        sChannel_->Subscribe<TestListener, &TestListener::HandleEvent>((*sListeners_)[0].Get());
+    };
+    order.clear();
+    channel.Send(sender1, event);
+    REQUIRE(order == std::vector<int>({ 1 }));
+    REQUIRE(channel.GetNumListeners() == 2);
+
+    order.clear();
+    channel.Send(sender2, event);
+    REQUIRE(order == std::vector<int>({ 3, 0 }));
+
+    channel.Unsubscribe(listeners[0].Get());
+    channel.Unsubscribe(listeners[3].Get());
+    REQUIRE(channel.GetNumListeners() == 0);
+    TestListener::order_ = 0;
+}
+
+TEST_CASE("EventChannel sends the VariantMap event to the Urho3D receivers", "[eventchannel]") {
+    SharedPtr<Context> context(new Context());
+    EventChannel<TestHotEvent> channel;
+
+    SharedPtr<TestListener> sender(new TestListener(context));
+    SharedPtr<TestListener> typedListener(new TestListener(context));
+    SharedPtr<TestListener> urhoReceiver(new TestListener(context));
+
+    channel.Subscribe<TestListener, &TestListener::HandleEvent>(typedListener);
+    REQUIRE_FALSE(EventChannelBase::HasEventReceivers(sender, TEST_HOTEVENT));
+
+    TestHotEvent event = { 1, 5 };
+    channel.Send(sender, event);
+    REQUIRE(typedListener->numEvents_ == 1);
+
+    urhoReceiver->SubscribeToEvent(sender, TEST_HOTEVENT, new EventHandlerImpl<TestListener>(urhoReceiver, &TestListener::HandleVariantEvent));
+    REQUIRE(EventChannelBase::HasEventReceivers(sender, TEST_HOTEVENT));
+    channel.Send(sender, event);
+    REQUIRE(typedListener->numEvents_ == 2);
+    REQUIRE(urhoReceiver->numEvents_ == 1);
+    REQUIRE(urhoReceiver->sum_ == 5);
+
+    urhoReceiver->UnsubscribeFromAllEvents();
+    urhoReceiver->SubscribeToEvent(TEST_HOTEVENT, new EventHandlerImpl<TestListener>(urhoReceiver, &TestListener::HandleVariantEvent));
+    channel.Send(sender, event);
+    REQUIRE(urhoReceiver->numEvents_ == 2);
+
+    channel.Unsubscribe(typedListener.Get());
+}
+
+TEST_CASE("EventChannel delivers the posted events at the flush", "[eventchannel]") {
+    SharedPtr<Context> context(new Context());
+    EventChannel<TestHotEvent> channel;
+
+    SharedPtr<TestListener> sender1(new TestListener(context));
+    SharedPtr<TestListener> sender2(new TestListener(context));
+    SharedPtr<TestListener> globalListener(new TestListener(context));
+    SharedPtr<TestListener> senderListener(new TestListener(context));
+
+    channel.Subscribe<TestListener, &TestListener::HandleEvent>(globalListener);
+    channel.Subscribe<TestListener, &TestListener::HandleEvent>(senderListener, sender1);
+
+    TestHotEvent event1 = { 1, 1 };
+    TestHotEvent event2 = { 2, 2 };
+    channel.Post(sender1, event1);
+    channel.Post(sender2, event2);
+    REQUIRE(channel.GetNumQueuedEvents() == 2);
+    REQUIRE(globalListener->numEvents_ == 0);
+
+    channel.Post(sender1, event1);
+    channel.Flush();
+    REQUIRE(channel.GetNumQueuedEvents() == 0);
+    REQUIRE(globalListener->numEvents_ == 3);
+    REQUIRE(globalListener->sum_ == 4);
+    REQUIRE(senderListener->numEvents_ == 2);
+
+    // a destroyed sender : only the listeners of all the senders get the event
+    channel.Post(sender1, event1);
+    sender1.Reset();
+    EventChannelBase::FlushAll();
+    REQUIRE(globalListener->numEvents_ == 4);
+    REQUIRE(globalListener->lastSender_ == 0);
+    REQUIRE(senderListener->numEvents_ == 2);
+
+    channel.Unsubscribe(globalListener.Get());
+    channel.Unsubscribe(senderListener.Get());
+}
+
+TEST_CASE("EventChannel per-event cost benchmark", "[eventchannel][!benchmark]") {
+    // the global listeners of GO_DESTROY : World2D, GOManager, GO_Pools
+    const unsigned numlisteners = 3;
+
+    // separated contexts : the typed channel checks that there is no Urho3D receiver for the bridge
+    SharedPtr<Context> context(new Context());
+    SharedPtr<Context> typedContext(new Context());
+    SharedPtr<TestListener> sender(new TestListener(context));
+    SharedPtr<TestListener> typedSender(new TestListener(typedContext));
+    EventChannel<TestHotEvent> channel;
+
+    std::vector<SharedPtr<TestListener> > urhoReceivers, typedListeners;
+    for (unsigned i = 0; i < numlisteners; i++)
+    {
+        urhoReceivers.push_back(SharedPtr<TestListener>(new TestListener(context)));
+        urhoReceivers.back()->SubscribeToEvent(TEST_HOTEVENT, new EventHandlerImpl<TestListener>(urhoReceivers.back(), &TestListener::HandleVariantEvent));
+
+        typedListeners.push_back(SharedPtr<TestListener>(new TestListener(typedContext)));
+        channel.Subscribe<TestListener, &TestListener::HandleEvent>(typedListeners.back());
+    }
+
+    BENCHMARK_ADVANCED("VariantMap event " + std::to_string(numlisteners) + " receivers")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            VariantMap& eventData = context->GetEventDataMap();
+            eventData[Test_HotEvent::P_ID] = 1U;
+            eventData[Test_HotEvent::P_VALUE] = 1;
+            sender->SendEvent(TEST_HOTEVENT, eventData);
+            return urhoReceivers.back()->numEvents_;
+        });
+    };
+
+    BENCHMARK_ADVANCED("typed channel " + std::to_string(numlisteners) + " listeners")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            TestHotEvent event = { 1, 1 };
+            channel.Send(typedSender, event);
+            return typedListeners.back()->numEvents_;
+        });
+    };
+
+    for (unsigned i = 0; i < numlisteners; i++)
+        channel.Unsubscribe(typedListeners[i].Get());
+}
@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+#include "../cpp/Map/FeatureFilterPipeline.h"
+
+// views (see DefsViews.h)
+enum { FrontView = 0, BackGround, InnerView, BackView, OuterView, NumViews };
+
+struct TestFilter
+{
+    int filter_;
+    unsigned view1_, view2_;
+    FeatureType feature1_, feature2_, featureBack_;
+};
+
+// per-tile filters of the dungeon model (ObjectFeatured::SetViewConfiguration)
+static const TestFilter dungeonFilters[] =
+{
+    { REPLACEFEATURE, InnerView, 0, MapFeatureType::Window, MapFeatureType::RoomInnerSpace, 0 },
+    { REPLACEFEATURE, InnerView, 0, MapFeatureType::InnerSpace, MapFeatureType::RoomInnerSpace, 0 },
+    { REPLACEFEATURE, InnerView, 0, MapFeatureType::CorridorPlateForm, MapFeatureType::RoomWall, 0 },
+    { REPLACEFEATURE, InnerView, 0, MapFeatureType::InnerRoof, MapFeatureType::RoofInnerSpace, 0 },
+    { REPLACEFEATUREBACK, InnerView, FrontView, MapFeatureType::RoofInnerSpace, MapFeatureType::RoomWall, MapFeatureType::Threshold },
+    { REPLACEFEATURE, BackView, 0, MapFeatureType::Window, MapFeatureType::RoomWall, 0 },
+    { REPLACEFEATURE, BackView, 0, MapFeatureType::CorridorPlateForm, MapFeatureType::NoMapFeature, 0 },
+    { REPLACEFEATURE, BackView, 0, MapFeatureType::RoomPlateForm, MapFeatureType::RoomWall, 0 },
+    { REPLACEFEATURE, BackView, 0, MapFeatureType::RoomFloor, MapFeatureType::RoomWall, 0 },
+    { REPLACEFEATURE, BackView, 0, MapFeatureType::InnerSpace, MapFeatureType::RoomWall, 0 },
+    { REPLACEFEATUREBACK, BackView, FrontView, MapFeatureType::InnerRoof, MapFeatureType::RoomWall, MapFeatureType::Threshold },
+    { REPLACEFEATURE, OuterView, 0, MapFeatureType::InnerSpace, MapFeatureType::RoomWall, 0 },
+    { REPLACEFEATURE, OuterView, 0, MapFeatureType::InnerRoof, MapFeatureType::OuterRoof, 0 },
+    { REPLACEFEATURE, OuterView, 0, MapFeatureType::RoomPlateForm, MapFeatureType::RoomWall, 0 },
+    { REPLACEFEATUREBACK, OuterView, FrontView, MapFeatureType::Window, MapFeatureType::RoomWall, MapFeatureType::Threshold },
+    { REPLACEFEATUREBACK2, BackGround, BackView, MapFeatureType::NoMapFeature, MapFeatureType::RoofInnerSpace, MapFeatureType::InnerRoof },
+};
+static const unsigned numDungeonFilters = sizeof(dungeonFilters) / sizeof(TestFilter);
+
+typedef std::vector<std::vector<FeatureType> > TestViews;
+
+static TestViews MakeViews(unsigned size, unsigned seed)
+{
+    srand(seed);
+    TestViews views(NumViews, std::vector<FeatureType>(size));
+    for (unsigned v = 0; v < NumViews; v++)
+        for (unsigned i = 0; i < size; i++)
+            views[v][i] = (FeatureType)(rand() % MAPFEATURES_SIZE);
+    return views;
+}
+
+static void MakePasses(TestViews& views, std::vector<FeatureFilterPass>& passes)
+{
+    passes.resize(numDungeonFilters);
+    for (unsigned i = 0; i < numDungeonFilters; i++)
+    {
+        const TestFilter& f = dungeonFilters[i];
+        FeatureFilterPass& pass = passes[i];
+        pass.filter_ = f.filter_;
+        pass.feature1_ = f.feature1_;
+        pass.feature2_ = f.feature2_;
+        pass.featureBack_ = f.featureBack_;
+        pass.view1_ = &views[f.view1_][0];
+        pass.view2_ = &views[f.view2_][0];
+    }
+}
+
+// one full pass by filter, as ObjectFeatured::ApplyFeatureFilter
+static void ApplySequential(TestViews& views)
+{
+    for (unsigned i = 0; i < numDungeonFilters; i++)
+    {
+        const TestFilter& f = dungeonFilters[i];
+        std::vector<FeatureType>& view1 = views[f.view1_];
+        const std::vector<FeatureType>& view2 = views[f.view2_];
+        for (unsigned addr = 0; addr < view1.size(); addr++)
+        {
+            if (view1[addr] != f.feature1_)
+                continue;
+            if (f.filter_ == REPLACEFEATURE ||
+               (f.filter_ == REPLACEFEATUREBACK && view2[addr] > f.featureBack_) ||
+               (f.filter_ == REPLACEFEATUREBACK2 && view2[addr] == f.featureBack_))
+                view1[addr] = f.feature2_;
+        }
+    }
+}
+
+TEST_CASE("Fused filters match the sequential filters", "[featurefilters]") {
+    const unsigned sizes[] = { 64, 128, 100 };
+    for (unsigned s = 0; s < 3; s++)
+    {
+        const unsigned numtiles = sizes[s] * sizes[s];
+        TestViews reference = MakeViews(numtiles, s+1);
+        TestViews fused = reference;
+
+        ApplySequential(reference);
+
+        std::vector<FeatureFilterPass> passes;
+        MakePasses(fused, passes);
+        ApplyFeatureFilterPasses(&passes[0], passes.size(), numtiles);
+
+        REQUIRE(fused == reference);
+    }
+}
+
+TEST_CASE("Fused filters benchmark", "[featurefilters][!benchmark]") {
+    const unsigned sizes[] = { 64, 128 };
+    for (unsigned s = 0; s < 2; s++)
+    {
+        const unsigned width = sizes[s];
+        const unsigned numtiles = width * width;
+        const TestViews source = MakeViews(numtiles, 1234);
+
+        BENCHMARK_ADVANCED("sequential " + std::to_string(width) + "x" + std::to_string(width))(Catch::Benchmark::Chronometer meter) {
+            TestViews views = source;
+            meter.measure([&] { ApplySequential(views); return views[InnerView][0]; });
+        };
+
+        BENCHMARK_ADVANCED("fused " + std::to_string(width) + "x" + std::to_string(width))(Catch::Benchmark::Chronometer meter) {
+            TestViews views = source;
+            std::vector<FeatureFilterPass> passes;
+            MakePasses(views, passes);
+            meter.measure([&] { ApplyFeatureFilterPasses(&passes[0], passes.size(), numtiles); return views[InnerView][0]; });
+        };
+    }
+}
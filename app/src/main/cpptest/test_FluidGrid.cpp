@@ -0,0 +1,689 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "../cpp/FluidGrid.h"
+
+enum { AIR = 0, BLOCK = 1, WATER = 2 };
+
+// Reference : the cells linked by pointers of MapSimulatorLiquid::Simulate5
+// (with FLUID_SIMULATION_REMOVEFLOWATEMPTYBORDER and FLUID_EQUALIZE, without depthZ)
+struct RefCell
+{
+    int type_;
+    bool settled_;
+    int stateCount_;
+    float massC_, flowC_;
+    RefCell *Bottom, *Left, *Right, *Top;
+
+    void SetSettled(bool enable)
+    {
+        if (type_ == BLOCK)
+            return;
+        settled_ = enable;
+        if (!enable)
+            stateCount_ = 0;
+    }
+    void Reset()
+    {
+        type_ = AIR;
+        settled_ = false;
+        massC_ = flowC_ = 0.f;
+    }
+    void UnsettleNeighbors()
+    {
+        if (Bottom) Bottom->SetSettled(false);
+        if (Left) Left->SetSettled(false);
+        if (Right) Right->SetSettled(false);
+        if (Top)
+        {
+            Top->SetSettled(false);
+            if (Top->Right) Top->Right->SetSettled(false);
+            if (Top->Left) Top->Left->SetSettled(false);
+        }
+    }
+    bool Update()
+    {
+        if (type_ == BLOCK || flowC_ == 0.f)
+            return false;
+        if (massC_ + flowC_ < FLUID_MINVALUE && (!Top || Top->type_ < WATER))
+        {
+            type_ = AIR;
+            settled_ = false;
+            massC_ = 0.f;
+        }
+        else
+        {
+            type_ = WATER;
+            SetSettled(false);
+            massC_ += flowC_;
+        }
+        flowC_ = 0.f;
+        return true;
+    }
+};
+
+struct Scenario
+{
+    int width_, height_;
+    std::vector<int> types_;
+    std::vector<float> masses_;
+};
+
+static void SimulateReference(std::vector<RefCell>& cells)
+{
+    const int size = (int)cells.size();
+    int updated = 0;
+
+    for (int addr = 0; addr < size; addr++)
+    {
+        RefCell& cell = cells[addr];
+        if (cell.type_ == BLOCK)
+            continue;
+        if (cell.massC_ > 0.f && cell.massC_ < 0.75f*FLUID_MINVALUE)
+        {
+            cell.Reset();
+            continue;
+        }
+        if (cell.massC_ < FLUID_MINVALUE || cell.settled_)
+            continue;
+
+        float startMass, rMassC, flow, sideFlow;
+        startMass = rMassC = cell.massC_;
+
+        if (cell.Bottom)
+        {
+            if (cell.Bottom->type_ != BLOCK)
+            {
+                flow = FluidClamp((CalculateFlow(rMassC + cell.Bottom->massC_) - cell.Bottom->massC_) * FLUID_FLOWSPEED, 0.f, FluidMin(FLUID_MAXflowValue_, rMassC));
+                if (flow != 0.f)
+                {
+                    rMassC -= flow;
+                    cell.flowC_ -= flow;
+                    cell.Bottom->flowC_ += flow;
+                    cell.Bottom->SetSettled(false);
+                    updated++;
+                }
+            }
+        }
+        else
+        {
+            flow = CalculateFlow(rMassC);
+            cell.flowC_ -= flow;
+            updated++;
+            continue;
+        }
+
+        sideFlow = rMassC;
+        if (!cell.Left)
+        {
+            rMassC -= sideFlow/2.f;
+            cell.flowC_ -= sideFlow/2.f;
+        }
+        if (!cell.Right)
+        {
+            rMassC -= sideFlow/2.f;
+            cell.flowC_ -= sideFlow/2.f;
+        }
+        if (rMassC < FLUID_MINVALUE)
+        {
+            cell.flowC_ -= rMassC;
+            continue;
+        }
+
+        const bool flowToLeft = cell.Left && cell.Left->type_ != BLOCK && rMassC > cell.Left->massC_;
+        const bool flowToRight = cell.Right && cell.Right->type_ != BLOCK && rMassC > cell.Right->massC_;
+        sideFlow = rMassC;
+        if (flowToLeft)
+        {
+            flow = FluidMax(0.f, FluidMin((sideFlow - cell.Left->massC_)/4.f*FLUID_FLOWSPEED, FLUID_MAXflowValue_));
+            if (flow != 0.f)
+            {
+                rMassC -= flow;
+                cell.flowC_ -= flow;
+                cell.Left->flowC_ += flow;
+                cell.Left->SetSettled(false);
+                updated++;
+            }
+            if (rMassC < FLUID_MINVALUE)
+            {
+                cell.flowC_ -= rMassC;
+                continue;
+            }
+        }
+        if (flowToRight)
+        {
+            flow = FluidMax(0.f, FluidMin((sideFlow - cell.Right->massC_)/4.f*FLUID_FLOWSPEED, FLUID_MAXflowValue_));
+            if (flow != 0.f)
+            {
+                rMassC -= flow;
+                cell.flowC_ -= flow;
+                cell.Right->flowC_ += flow;
+                cell.Right->SetSettled(false);
+                updated++;
+            }
+        }
+        if (rMassC < FLUID_MINVALUE)
+        {
+            cell.flowC_ -= rMassC;
+            continue;
+        }
+
+        if (cell.Top)
+        {
+            if (cell.Top->type_ != BLOCK)
+            {
+                flow = rMassC - CalculateFlow(rMassC + cell.Top->massC_);
+                if (flow > FLUID_MINflowValue_)
+                    flow *= FLUID_FLOWSPEED;
+                flow = FluidMin(FluidMax(0.f, flow), FluidMin(FLUID_MAXflowValue_, rMassC));
+                if (flow != 0.f)
+                {
+                    rMassC -= flow;
+                    cell.flowC_ -= flow;
+                    cell.Top->flowC_ += flow;
+                    cell.Top->SetSettled(false);
+                    updated++;
+                }
+            }
+        }
+        else
+        {
+            flow = CalculateFlow(rMassC);
+            rMassC -= flow;
+            cell.flowC_ -= flow;
+            updated++;
+        }
+        if (rMassC < FLUID_MINVALUE)
+        {
+            cell.flowC_ -= rMassC;
+            continue;
+        }
+
+        if (startMass == rMassC)
+        {
+            cell.stateCount_++;
+            if (cell.stateCount_ >= FLUID_SETTLEDCOUNT)
+                cell.SetSettled(true);
+        }
+        else
+            cell.UnsettleNeighbors();
+    }
+
+    if (!updated)
+        return;
+
+    for (int addr = 0; addr < size; addr++)
+        cells[addr].Update();
+
+    // Equalize1SideF
+    for (int pass = 0, dirInc = 1; pass < 2; pass++, dirInc = -dirInc)
+    {
+        const int start = dirInc > 0 ? 0 : size-1;
+        const int end = dirInc > 0 ? size : -1;
+        for (int addr = start; addr != end; addr += dirInc)
+        {
+            RefCell& cell = cells[addr];
+            if (cell.massC_ < FLUID_MINVALUE || !cell.Bottom || (cell.Bottom->type_ != BLOCK && cell.Bottom->massC_ < FLUID_MINVALUE))
+                continue;
+            RefCell* side = dirInc > 0 ? cell.Right : cell.Left;
+            if (!side || side->massC_ < FLUID_MINVALUE || !side->Bottom || (side->Bottom->type_ != BLOCK && side->Bottom->massC_ < FLUID_MINVALUE))
+                continue;
+            cell.massC_ = side->massC_ = FluidMax((cell.massC_ + side->massC_) * 0.5f, FLUID_MINVALUE);
+        }
+    }
+}
+
+static std::vector<RefCell> MakeReference(const Scenario& scenario)
+{
+    const int w = scenario.width_, h = scenario.height_;
+    std::vector<RefCell> cells(w * h);
+    for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++)
+        {
+            RefCell& cell = cells[y*w+x];
+            cell.type_ = scenario.types_[y*w+x];
+            cell.massC_ = cell.type_ == BLOCK ? 0.f : scenario.masses_[y*w+x];
+            if (cell.type_ != BLOCK && cell.massC_ > 0.f)
+                cell.type_ = WATER;
+            cell.flowC_ = 0.f;
+            cell.settled_ = false;
+            cell.stateCount_ = 0;
+            cell.Bottom = y < h-1 ? &cells[(y+1)*w+x] : 0;
+            cell.Top = y > 0 ? &cells[(y-1)*w+x] : 0;
+            cell.Left = x > 0 ? &cells[y*w+x-1] : 0;
+            cell.Right = x < w-1 ? &cells[y*w+x+1] : 0;
+        }
+    return cells;
+}
+
+struct TestGrid
+{
+    std::vector<float> floats_;
+    std::vector<unsigned char> bytes_;
+    FluidGridPlanes planes_;
+};
+
+static void MakeGrid(const Scenario& scenario, TestGrid& grid)
+{
+    const int w = scenario.width_, h = scenario.height_;
+    grid.floats_.assign(FluidGridPlanes::GetNumFloats(w, h), 0.f);
+    grid.bytes_.assign(FluidGridPlanes::GetNumBytes(w, h), 0);
+    grid.planes_.Bind(&grid.floats_[0], &grid.bytes_[0], w, h);
+    memset(grid.planes_.solid_, FGS_Void, grid.planes_.size_);
+    grid.planes_.WakeAll();
+
+    float* mass = grid.planes_.GetReadMass();
+    for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++)
+        {
+            const int i = grid.planes_.GetIndex(x, y);
+            const bool block = scenario.types_[y*w+x] == BLOCK;
+            grid.planes_.solid_[i] = block ? FGS_Block : FGS_Open;
+            grid.planes_.stable_[i] = block ? FLUID_SETTLEDCOUNT : 0;
+            mass[i] = block ? 0.f : scenario.masses_[y*w+x];
+        }
+}
+
+static double TotalMass(const std::vector<RefCell>& cells)
+{
+    double total = 0.0;
+    for (size_t i = 0; i < cells.size(); i++)
+        total += cells[i].massC_;
+    return total;
+}
+
+static double TotalMass(const TestGrid& grid)
+{
+    double total = 0.0;
+    const float* mass = grid.planes_.GetReadMass();
+    for (int y = 0; y < grid.planes_.height_; y++)
+        for (int x = 0; x < grid.planes_.width_; x++)
+            total += mass[grid.planes_.GetIndex(x, y)];
+    return total;
+}
+
+// a basin closed by blocks on the sides and the bottom
+static Scenario MakeBasin(int width, int height)
+{
+    Scenario scenario;
+    scenario.width_ = width;
+    scenario.height_ = height;
+    scenario.types_.assign(width * height, AIR);
+    scenario.masses_.assign(width * height, 0.f);
+    for (int y = 0; y < height; y++)
+    {
+        scenario.types_[y*width] = BLOCK;
+        scenario.types_[y*width+width-1] = BLOCK;
+    }
+    for (int x = 0; x < width; x++)
+        scenario.types_[(height-1)*width+x] = BLOCK;
+    return scenario;
+}
+
+static void CompareWithReference(const Scenario& scenario, int numiterations, float tolerance)
+{
+    std::vector<RefCell> reference = MakeReference(scenario);
+    TestGrid grid;
+    MakeGrid(scenario, grid);
+
+    for (int i = 0; i < numiterations; i++)
+    {
+        SimulateReference(reference);
+        FluidGridStep(grid.planes_, true, true);
+    }
+
+    const double refTotal = TotalMass(reference);
+    const double gridTotal = TotalMass(grid);
+    REQUIRE(std::fabs(refTotal - gridTotal) <= tolerance * scenario.width_ * scenario.height_);
+
+    // compare the water levels of the columns
+    const float* mass = grid.planes_.GetReadMass();
+    for (int x = 0; x < scenario.width_; x++)
+    {
+        double refColumn = 0.0, gridColumn = 0.0;
+        for (int y = 0; y < scenario.height_; y++)
+        {
+            refColumn += reference[y*scenario.width_+x].massC_;
+            gridColumn += mass[grid.planes_.GetIndex(x, y)];
+        }
+        REQUIRE(std::fabs(refColumn - gridColumn) <= tolerance * scenario.height_);
+    }
+}
+
+TEST_CASE("Fluid grid follows the simulation 5 on a dam break", "[fluidgrid]") {
+    Scenario scenario = MakeBasin(32, 16);
+    for (int y = 2; y < 15; y++)
+        for (int x = 1; x < 8; x++)
+            scenario.masses_[y*32+x] = FLUID_MAXVALUE;
+
+    CompareWithReference(scenario, 400, 0.05f);
+}
+
+TEST_CASE("Fluid grid follows the simulation 5 on a falling drop", "[fluidgrid]") {
+    Scenario scenario = MakeBasin(16, 24);
+    for (int x = 1; x < 15; x++)
+    {
+        scenario.masses_[22*16+x] = FLUID_MAXVALUE;
+        scenario.masses_[21*16+x] = 0.5f;
+    }
+    for (int y = 2; y < 6; y++)
+        for (int x = 6; x < 10; x++)
+            scenario.masses_[y*16+x] = FLUID_MAXVALUE;
+
+    CompareWithReference(scenario, 300, 0.05f);
+}
+
+TEST_CASE("Fluid grid keeps a resting lake at rest", "[fluidgrid]") {
+    Scenario scenario = MakeBasin(24, 12);
+    for (int y = 6; y < 11; y++)
+        for (int x = 1; x < 23; x++)
+            scenario.masses_[y*24+x] = FLUID_MAXVALUE;
+
+    TestGrid grid;
+    MakeGrid(scenario, grid);
+    const double initial = TotalMass(grid);
+
+    for (int i = 0; i < 500; i++)
+        FluidGridStep(grid.planes_, true, true);
+
+    // the compression is settled : the next step doesn't move the water anymore
+    std::vector<float> previous(grid.planes_.GetReadMass(), grid.planes_.GetReadMass() + grid.planes_.size_);
+    FluidGridStep(grid.planes_, true, true);
+    const float* mass = grid.planes_.GetReadMass();
+    float maxdelta = 0.f;
+    for (int i = 0; i < grid.planes_.size_; i++)
+        maxdelta = FluidMax(maxdelta, std::fabs(mass[i] - previous[i]));
+
+    REQUIRE(maxdelta < FLUID_MINVALUE);
+    REQUIRE(std::fabs(TotalMass(grid) - initial) < 1e-2);
+}
+
+TEST_CASE("Fluid grid sleeps at rest and wakes on changes", "[fluidgrid]") {
+    Scenario scenario = MakeBasin(40, 24);
+    for (int y = 14; y < 23; y++)
+        for (int x = 1; x < 39; x++)
+            scenario.masses_[y*40+x] = FLUID_MAXVALUE;
+
+    TestGrid tracked;
+    MakeGrid(scenario, tracked);
+
+    int iteration = 0;
+    while (tracked.planes_.numActiveBlocks_ && iteration++ < 5000)
+        FluidGridStep(tracked.planes_, true, true);
+
+    REQUIRE(tracked.planes_.numActiveBlocks_ == 0);
+    REQUIRE(FluidGridStep(tracked.planes_, true, true) == 0);
+
+    // a copy of the lake fully simulated at each iteration
+    TestGrid full = tracked;
+    full.planes_.Bind(&full.floats_[0], &full.bytes_[0], scenario.width_, scenario.height_);
+    full.planes_.read_ = tracked.planes_.read_;
+
+    // pour some water in the lake
+    for (int y = 2; y < 5; y++)
+        for (int x = 30; x < 34; x++)
+        {
+            const int i = tracked.planes_.GetIndex(x, y);
+            tracked.planes_.GetReadMass()[i] = full.planes_.GetReadMass()[i] = FLUID_MAXVALUE;
+            tracked.planes_.WakeCell(x, y);
+        }
+
+    REQUIRE(tracked.planes_.numActiveBlocks_ > 0);
+    REQUIRE(tracked.planes_.numActiveBlocks_ < tracked.planes_.numBlocks_);
+
+    for (int i = 0; i < 200; i++)
+    {
+        full.planes_.WakeAll();
+        FluidGridStep(tracked.planes_, true, true);
+        FluidGridStep(full.planes_, true, true);
+    }
+
+    // the asleep blocks are not equalized : small differences on the lake surface
+    REQUIRE(std::fabs(TotalMass(tracked) - TotalMass(full)) < 1e-3 * TotalMass(full));
+
+    const float* trackedMass = tracked.planes_.GetReadMass();
+    const float* fullMass = full.planes_.GetReadMass();
+    float maxdelta = 0.f;
+    for (int i = 0; i < tracked.planes_.size_; i++)
+        maxdelta = FluidMax(maxdelta, std::fabs(trackedMass[i] - fullMass[i]));
+    REQUIRE(maxdelta < FLUID_MINVALUE);
+}
+
+// two grids linked by a seam as two maps : the borders are exported before the iterations,
+// the flows sent in the halo are pulled by the linked grid before its next iterations (see FluidDatas)
+struct SeamGrid
+{
+    // a flow pulled from the linked grid (see FluidGridPullSide)
+    void ReceiveBorderFlow(int side, int k, float flow)
+    {
+        FluidGridPlanes& grid = grid_.planes_;
+        const int i = grid.GetBorderIndex(side, k);
+        if (grid.solid_[i] == FGS_Open)
+        {
+            grid.GetReadMass()[i] += flow;
+            grid.stable_[i] = 0;
+        }
+        const int x = side == FGH_East ? grid.width_-1 : side == FGH_West ? 0 : k;
+        const int y = side == FGH_South ? grid.height_-1 : side == FGH_North ? 0 : k;
+        grid.WakeCell(x, y);
+    }
+    // a border cell exported for the linked grid (see FluidGridExportBorder)
+    void GetBorderCell(int side, int k, unsigned char& solid, float& mass) const
+    {
+        const FluidGridPlanes& grid = grid_.planes_;
+        const int i = grid.GetBorderIndex(side, k);
+        solid = grid.solid_[i] == FGS_Block ? FGS_Block : FGS_Open;
+        mass = grid.GetReadMass()[i];
+    }
+
+    TestGrid grid_;
+    std::vector<float> borderMass_, haloMass_, haloFlows_;
+    std::vector<unsigned char> borderSolid_, haloMoved_;
+    SeamGrid* linked_[NUM_FLUIDGRIDSIDES];
+};
+
+static void InitSeamGrid(SeamGrid& seam, const Scenario& scenario)
+{
+    MakeGrid(scenario, seam.grid_);
+    const unsigned numSideCells = FluidGridPlanes::GetNumSideCells(scenario.width_, scenario.height_);
+    seam.borderMass_.assign(numSideCells, 0.f);
+    seam.haloMass_.assign(numSideCells, 0.f);
+    seam.haloFlows_.assign(numSideCells, 0.f);
+    seam.borderSolid_.assign(numSideCells, FGS_Void);
+    seam.haloMoved_.assign(numSideCells, 0);
+    for (int side = 0; side < NUM_FLUIDGRIDSIDES; side++)
+        seam.linked_[side] = 0;
+}
+
+// the exchange of FluidDatas::PullBorderFlows and FluidDatas::ExportBorder
+static void PullAndExport(SeamGrid& seam)
+{
+    const FluidGridPlanes& grid = seam.grid_.planes_;
+
+    for (int side = 0; side < NUM_FLUIDGRIDSIDES; side++)
+    {
+        SeamGrid* linked = seam.linked_[side];
+        if (linked)
+            FluidGridPullSide(seam, side, grid.width_, grid.height_, &linked->haloFlows_[0], &linked->haloMoved_[0]);
+    }
+
+    FluidGridExportBorder(seam, grid.width_, grid.height_, &seam.borderSolid_[0], &seam.borderMass_[0]);
+}
+
+static void SimulateSeam(SeamGrid& seam, bool removeFlowAtVoid)
+{
+    FluidGridPlanes& grid = seam.grid_.planes_;
+
+    for (int side = 0; side < NUM_FLUIDGRIDSIDES; side++)
+    {
+        SeamGrid* linked = seam.linked_[side];
+        const int offset = FluidGridPlanes::GetSideOffset(FluidGridInverseSide(side), grid.width_, grid.height_);
+        const int pendingOffset = FluidGridPlanes::GetSideOffset(side, grid.width_, grid.height_);
+        FluidGridLoadHalo(grid, side, linked ? &linked->borderMass_[offset] : 0, linked ? &linked->borderSolid_[offset] : 0, &seam.haloFlows_[pendingOffset]);
+    }
+    FluidGridSaveHalo(grid, &seam.haloMass_[0]);
+
+    FluidGridStep(grid, removeFlowAtVoid, true);
+
+    FluidGridCollectHaloFlows(grid, &seam.haloMass_[0], &seam.haloFlows_[0], &seam.haloMoved_[0]);
+}
+
+static double TotalMass(const SeamGrid& seam)
+{
+    double total = TotalMass(seam.grid_);
+    for (size_t i = 0; i < seam.haloFlows_.size(); i++)
+        total += seam.haloFlows_[i];
+    return total;
+}
+
+TEST_CASE("Fluid grids conserve the mass across a map seam", "[fluidgrid]") {
+    const int width = 24, height = 16;
+
+    // the basin is split in two maps : no wall at the seam
+    Scenario left = MakeBasin(width, height);
+    Scenario right = MakeBasin(width, height);
+    for (int y = 0; y < height-1; y++)
+    {
+        left.types_[y*width+width-1] = AIR;
+        right.types_[y*width] = AIR;
+    }
+    // a water column poured at the seam in the left map
+    for (int y = 1; y < 12; y++)
+        for (int x = width-6; x < width; x++)
+            left.masses_[y*width+x] = FLUID_MAXVALUE;
+
+    SeamGrid maps[2];
+    InitSeamGrid(maps[0], left);
+    InitSeamGrid(maps[1], right);
+    maps[0].linked_[FGH_East] = &maps[1];
+    maps[1].linked_[FGH_West] = &maps[0];
+
+    const double initial = TotalMass(maps[0]) + TotalMass(maps[1]);
+
+    // the same basin in one map
+    Scenario whole = MakeBasin(2*width, height);
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+        {
+            whole.masses_[y*2*width+x] = left.masses_[y*width+x];
+            whole.masses_[y*2*width+width+x] = right.masses_[y*width+x];
+        }
+    TestGrid reference;
+    MakeGrid(whole, reference);
+
+    // the same maps updated in the reverse order
+    SeamGrid reversed[2];
+    InitSeamGrid(reversed[0], left);
+    InitSeamGrid(reversed[1], right);
+    reversed[0].linked_[FGH_East] = &reversed[1];
+    reversed[1].linked_[FGH_West] = &reversed[0];
+
+    for (int frame = 0; frame < 600; frame++)
+    {
+        // phase 0 : pull the flows and export the borders, phase 1 : simulate
+        PullAndExport(maps[0]);
+        PullAndExport(maps[1]);
+        SimulateSeam(maps[0], false);
+        SimulateSeam(maps[1], false);
+
+        PullAndExport(reversed[1]);
+        PullAndExport(reversed[0]);
+        SimulateSeam(reversed[1], false);
+        SimulateSeam(reversed[0], false);
+
+        FluidGridStep(reference.planes_, false, true);
+    }
+
+    // the border exchange doesn't depend on the order of the maps
+    for (int i = 0; i < 2; i++)
+        REQUIRE(std::memcmp(maps[i].grid_.planes_.GetReadMass(), reversed[i].grid_.planes_.GetReadMass(), maps[i].grid_.planes_.size_ * sizeof(float)) == 0);
+
+    const double leftMass = TotalMass(maps[0]);
+    const double rightMass = TotalMass(maps[1]);
+
+    // the water has crossed the seam
+    REQUIRE(rightMass > 0.25 * initial);
+
+    // the seam loses no more liquid than the simulation in one map (the emptied drops)
+    const double lost = initial - (leftMass + rightMass);
+    const double referenceLost = initial - TotalMass(reference);
+    REQUIRE(lost >= -1e-3 * initial);
+    REQUIRE(std::fabs(lost - referenceLost) < 5e-3 * initial);
+}
+
+// a dam break fed by a source, run by a fixed step clock until the tick numticks at the given frame rate.
+// a hitch frame of hitchTime seconds is added every hitchEvery frames.
+static void SimulateFixedSteps(float frameTime, int hitchEvery, float hitchTime, unsigned numticks, TestGrid& grid)
+{
+    Scenario scenario = MakeBasin(32, 16);
+    for (int y = 4; y < 15; y++)
+        for (int x = 1; x < 6; x++)
+            scenario.masses_[y*32+x] = FLUID_MAXVALUE;
+    MakeGrid(scenario, grid);
+
+    FluidStepClock clock;
+    clock.Reset(0.075f, 4);
+
+    const int source = grid.planes_.GetIndex(20, 1);
+    int frame = 0, maxsteps = 0;
+    while (clock.ticks_ < numticks)
+    {
+        frame++;
+        const unsigned tick = clock.ticks_;
+        const int numsteps = clock.Advance(hitchEvery && frame % hitchEvery == 0 ? hitchTime : frameTime);
+        maxsteps = numsteps > maxsteps ? numsteps : maxsteps;
+
+        for (int i = 1; i <= numsteps && tick + i <= numticks; i++)
+        {
+            grid.planes_.GetReadMass()[source] += 0.2f;
+            grid.planes_.WakeCell(20, 1);
+            FluidGridStep(grid.planes_, true, true);
+        }
+    }
+
+    REQUIRE(maxsteps <= clock.maxSteps_);
+}
+
+TEST_CASE("Fluid fixed step gives the same flows at any frame rate", "[fluidgrid]") {
+    // the clock ticks at the same rate whatever the frame rate
+    const float frameTimes[3] = { 1.f/30.f, 1.f/60.f, 1.f/144.f };
+    for (int f = 0; f < 3; f++)
+    {
+        FluidStepClock clock;
+        clock.Reset(0.075f, 4);
+        const int numframes = (int)(6.f / frameTimes[f] + 0.5f);
+        for (int i = 0; i < numframes; i++)
+            clock.Advance(frameTimes[f]);
+        // the first tick is done at once
+        REQUIRE(clock.ticks_ >= 80);
+        REQUIRE(clock.ticks_ <= 81);
+        REQUIRE(clock.GetAlpha() >= 0.f);
+        REQUIRE(clock.GetAlpha() < 1.f);
+    }
+
+    // a hitch is caught up to maxSteps_ ticks
+    FluidStepClock clock;
+    clock.Reset(0.075f, 4);
+    clock.Advance(0.f);
+    REQUIRE(clock.Advance(1.f) == 4);
+    REQUIRE(clock.GetAlpha() < 1.f);
+
+    // the same scenario after the same number of ticks gives the same masses
+    const unsigned numticks = 240;
+    TestGrid reference;
+    SimulateFixedSteps(frameTimes[0], 0, 0.f, numticks, reference);
+
+    TestGrid grids[3];
+    SimulateFixedSteps(frameTimes[1], 0, 0.f, numticks, grids[0]);
+    SimulateFixedSteps(frameTimes[2], 0, 0.f, numticks, grids[1]);
+    SimulateFixedSteps(frameTimes[2], 50, 0.5f, numticks, grids[2]);
+
+    for (int g = 0; g < 3; g++)
+    {
+        REQUIRE(grids[g].planes_.read_ == reference.planes_.read_);
+        REQUIRE(memcmp(grids[g].planes_.GetReadMass(), reference.planes_.GetReadMass(), reference.planes_.size_ * sizeof(float)) == 0);
+    }
+}
@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Scene/Node.h>
+
+#include "../cpp/GameAttributes.h"
+#include "../cpp/ObjectsCore/GOABlock.h"
+
+using namespace Urho3D;
+
+// the keys of GameAttributes.cpp, not linked in the test
+const StringHash GOA::MOVESTATE         = StringHash("GOA_MoveState");
+const StringHash GOA::KEEPDIRECTION     = StringHash("GOA_KeepDirection");
+const StringHash GOA::VELOCITY          = StringHash("GOA_Velocity");
+const StringHash GOA::DIRECTION         = StringHash("GOA_Direction");
+
+TEST_CASE("GOABlock loads the node variables and flushes the dirty fields", "[goablock]") {
+    SharedPtr<Context> context(new Context());
+    SharedPtr<Node> node(new Node(context));
+    node->SetVar(GOA::MOVESTATE, 5U);
+    node->SetVar(GOA::DIRECTION, Vector2(-1.f, 0.f));
+
+    // one block by node, loaded at the first acquire
+    GOABlock* block = GOABlock::Acquire(node);
+    REQUIRE(GOABlock::Acquire(node) == block);
+    REQUIRE(GOABlock::Get(node) == block);
+    REQUIRE(block->GetMoveState() == 5U);
+    REQUIRE(block->GetDirection() == Vector2(-1.f, 0.f));
+    REQUIRE_FALSE(block->GetKeepDirection());
+
+    // the writes stay in the block until the flush
+    block->SetMoveState(6U);
+    block->SetMoveState(7U);
+    block->SetVelocity(Vector2(2.f, 3.f));
+    REQUIRE(block->GetDirtyFields() == (GOAB_MoveState | GOAB_Velocity));
+    REQUIRE(node->GetVar(GOA::MOVESTATE).GetUInt() == 5U);
+    REQUIRE(GOABlock::GetMoveState(node) == 7U);
+    REQUIRE(GOABlock::GetVelocity(node) == Vector2(2.f, 3.f));
+
+    // an unchanged value doesn't mark the field dirty
+    block->SetDirection(Vector2(-1.f, 0.f));
+    REQUIRE((block->GetDirtyFields() & GOAB_Direction) == 0);
+
+    GOABlock::FlushAll();
+    REQUIRE(block->GetDirtyFields() == 0);
+    REQUIRE(node->GetVar(GOA::MOVESTATE).GetUInt() == 7U);
+    REQUIRE(node->GetVar(GOA::VELOCITY).GetVector2() == Vector2(2.f, 3.f));
+
+    // the load keeps the dirty fields
+    block->SetKeepDirection(true);
+    node->SetVar(GOA::KEEPDIRECTION, false);
+    node->SetVar(GOA::MOVESTATE, 8U);
+    block->Load();
+    REQUIRE(block->GetKeepDirection());
+    REQUIRE(block->GetMoveState() == 8U);
+
+    // the last release flushes the block
+    GOABlock::Release(block);
+    REQUIRE(GOABlock::Get(node) == block);
+    GOABlock::Release(block);
+    REQUIRE(GOABlock::Get(node) == 0);
+    REQUIRE(node->GetVar(GOA::KEEPDIRECTION).GetBool());
+    REQUIRE(GOABlock::GetMoveState(node) == 8U);
+    REQUIRE(GOABlock::GetNumBlocks() == 0);
+    GOABlock::FlushAll();
+}
+
+TEST_CASE("GOABlock keeps the blocks of the nodes apart", "[goablock]") {
+    SharedPtr<Context> context(new Context());
+    SharedPtr<Node> node1(new Node(context));
+    SharedPtr<Node> node2(new Node(context));
+    node2->SetVar(GOA::MOVESTATE, 3U);
+
+    GOABlock* block1 = GOABlock::Acquire(node1);
+    GOABlock* block2 = GOABlock::Acquire(node2);
+    REQUIRE(block1 != block2);
+    REQUIRE(block2->GetNode() == node2.Get());
+    REQUIRE(GOABlock::GetNumBlocks() == 2);
+
+    block1->SetMoveState(1U);
+    block2->SetMoveState(4U);
+    GOABlock::Release(block1);
+    REQUIRE(node1->GetVar(GOA::MOVESTATE).GetUInt() == 1U);
+    REQUIRE(node2->GetVar(GOA::MOVESTATE).GetUInt() == 3U);
+
+    GOABlock::FlushAll();
+    REQUIRE(node2->GetVar(GOA::MOVESTATE).GetUInt() == 4U);
+
+    // a new block of a released node is loaded from the node variables
+    block1 = GOABlock::Acquire(node1);
+    REQUIRE(block1->GetMoveState() == 1U);
+    REQUIRE(block1->GetDirtyFields() == 0);
+
+    GOABlock::Release(block1);
+    GOABlock::Release(block2);
+    GOABlock::Release(0);
+    REQUIRE(GOABlock::GetNumBlocks() == 0);
+}
+
+TEST_CASE("GOABlock reload drops the dirty fields", "[goablock]") {
+    SharedPtr<Context> context(new Context());
+    SharedPtr<Node> node(new Node(context));
+    node->SetVar(GOA::MOVESTATE, 1U);
+
+    GOABlock* block = GOABlock::Acquire(node);
+    block->SetMoveState(2U);
+    block->SetKeepDirection(true);
+
+    // the node variables reset by the pool
+    GOABlock::Reload(node);
+    REQUIRE(block->GetDirtyFields() == 0);
+    REQUIRE(block->GetMoveState() == 1U);
+    REQUIRE_FALSE(block->GetKeepDirection());
+
+    GOABlock::Release(block);
+    REQUIRE(GOABlock::Get(node) == 0);
+    GOABlock::FlushAll();
+}
@@ -0,0 +1,86 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../cpp/Map/MapContactRegistry.h"
+
+using namespace Urho3D;
+
+// the registry never dereferences the shapes and the colliders
+static CollisionShape2D* FakeShape(size_t i)
+{
+    return reinterpret_cast<CollisionShape2D*>(0x1000 + i * 0x10);
+}
+static GOC_Collide2D* FakeCollider(size_t i)
+{
+    return reinterpret_cast<GOC_Collide2D*>(0x100000 + i * 0x10);
+}
+
+TEST_CASE("MapContactRegistry counts the contacts of the colliders with the shapes", "[mapcontactregistry]") {
+    MapContactRegistry registry;
+
+    registry.AddContact(FakeShape(0), FakeCollider(0));
+    registry.AddContact(FakeShape(0), FakeCollider(0));
+    registry.AddContact(FakeShape(0), FakeCollider(1));
+    registry.AddContact(FakeShape(1), FakeCollider(0));
+    REQUIRE(registry.GetNumShapes() == 2);
+    REQUIRE(registry.GetNumContacts(FakeShape(0), FakeCollider(0)) == 2);
+    REQUIRE(registry.GetNumContacts(FakeShape(0), FakeCollider(1)) == 1);
+    REQUIRE(registry.GetNumContacts(FakeShape(1), FakeCollider(1)) == 0);
+
+    PODVector<GOC_Collide2D*> colliders;
+    registry.GetColliders(FakeShape(0), colliders);
+    REQUIRE(colliders.Size() == 2);
+    colliders.Clear();
+    registry.GetColliders(FakeShape(2), colliders);
+    REQUIRE(colliders.Size() == 0);
+
+    // one contact ends : the collider stays on the shape until its last contact
+    registry.RemoveContact(FakeShape(0), FakeCollider(0));
+    REQUIRE(registry.GetNumContacts(FakeShape(0), FakeCollider(0)) == 1);
+    registry.RemoveContact(FakeShape(0), FakeCollider(0));
+    REQUIRE(registry.GetNumContacts(FakeShape(0), FakeCollider(0)) == 0);
+    registry.GetColliders(FakeShape(0), colliders);
+    REQUIRE(colliders.Size() == 1);
+    REQUIRE(colliders[0] == FakeCollider(1));
+
+    // the last collider of a shape removes the shape
+    registry.RemoveContact(FakeShape(0), FakeCollider(1), true);
+    REQUIRE(registry.GetNumShapes() == 1);
+
+    // removing an unknown contact does nothing
+    registry.RemoveContact(FakeShape(5), FakeCollider(1));
+    registry.RemoveContact(FakeShape(1), FakeCollider(5));
+    REQUIRE(registry.GetNumContacts(FakeShape(1), FakeCollider(0)) == 1);
+}
+
+TEST_CASE("MapContactRegistry removes all the contacts of a collider", "[mapcontactregistry]") {
+    MapContactRegistry registry;
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        registry.AddContact(FakeShape(i), FakeCollider(0));
+        registry.AddContact(FakeShape(i), FakeCollider(0));
+        registry.AddContact(FakeShape(i), FakeCollider(1));
+    }
+
+    registry.RemoveCollider(FakeCollider(0));
+    REQUIRE(registry.GetNumShapes() == 4);
+    for (size_t i = 0; i < 4; i++)
+    {
+        REQUIRE(registry.GetNumContacts(FakeShape(i), FakeCollider(0)) == 0);
+        REQUIRE(registry.GetNumContacts(FakeShape(i), FakeCollider(1)) == 1);
+    }
+
+    // a removed collider can be added again
+    registry.AddContact(FakeShape(0), FakeCollider(0));
+    REQUIRE(registry.GetNumContacts(FakeShape(0), FakeCollider(0)) == 1);
+
+    registry.RemoveCollider(FakeCollider(1));
+    REQUIRE(registry.GetNumShapes() == 1);
+    registry.RemoveCollider(FakeCollider(0));
+    REQUIRE(registry.GetNumShapes() == 0);
+
+    registry.AddContact(FakeShape(0), FakeCollider(0));
+    registry.Clear();
+    REQUIRE(registry.GetNumShapes() == 0);
+    registry.RemoveCollider(FakeCollider(0));
+}
@@ -0,0 +1,166 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Scene/Component.h>
+#include <Urho3D/Scene/Node.h>
+
+#include "../cpp/NodePool/NodeSnapshot.h"
+
+using namespace Urho3D;
+
+static const StringHash TEST_VAR("Test_Var");
+
+// a pooled component : file attributes restored, network attribute kept
+class TestPoolComponent : public Component
+{
+    URHO3D_OBJECT(TestPoolComponent, Component);
+
+public:
+    TestPoolComponent(Context* context) :
+        Component(context),
+        value_(0),
+        speed_(0.f),
+        netValue_(0) { }
+
+    static void RegisterObject(Context* context)
+    {
+        context->RegisterFactory<TestPoolComponent>();
+        URHO3D_ATTRIBUTE("Value", int, value_, 0, AM_DEFAULT);
+        URHO3D_ATTRIBUTE("Speed", float, speed_, 0.f, AM_DEFAULT);
+        URHO3D_ATTRIBUTE("Net Value", int, netValue_, 0, AM_NET);
+    }
+
+    int value_;
+    float speed_;
+    int netValue_;
+};
+
+static SharedPtr<Node> CreateTestNode(Context* context, int value, float speed)
+{
+    SharedPtr<Node> node(new Node(context));
+    node->SetPosition2D(Vector2(1.f, 2.f));
+    node->SetVar(TEST_VAR, value);
+    TestPoolComponent* component = node->CreateComponent<TestPoolComponent>();
+    component->value_ = value;
+    component->speed_ = speed;
+
+    Node* child = node->CreateChild("Child");
+    child->CreateComponent<TestPoolComponent>()->value_ = value * 10;
+    return node;
+}
+
+static void CopyAttributes(Serializable* source, Serializable* dest)
+{
+    // the generic copy of GameHelpers::CopyAttributes
+    const Vector<AttributeInfo>* attributes = source->GetAttributes();
+    if (!attributes)
+        return;
+
+    for (unsigned i = 0; i < attributes->Size(); i++)
+    {
+        const AttributeInfo& attr = attributes->At(i);
+        if (attr.mode_ & AM_FILE)
+            dest->SetAttribute(i, source->GetAttribute(i));
+    }
+}
+
+TEST_CASE("NodeSnapshot restores the file attributes of the template", "[nodesnapshot]") {
+    SharedPtr<Context> context(new Context());
+    Node::RegisterObject(context);
+    TestPoolComponent::RegisterObject(context);
+
+    SharedPtr<Node> templateNode = CreateTestNode(context, 3, 1.5f);
+    SharedPtr<Node> node = CreateTestNode(context, 3, 1.5f);
+
+    NodeSnapshot snapshot;
+    REQUIRE(snapshot.IsEmpty());
+    REQUIRE_FALSE(snapshot.Restore(node));
+
+    snapshot.Capture(templateNode);
+    REQUIRE_FALSE(snapshot.IsEmpty());
+    REQUIRE(snapshot.GetNumAttributes() > 0);
+
+    // a used node
+    node->SetPosition2D(Vector2(5.f, 5.f));
+    node->SetVar(TEST_VAR, 8);
+    TestPoolComponent* component = node->GetComponent<TestPoolComponent>();
+    component->value_ = 8;
+    component->speed_ = 4.f;
+    component->netValue_ = 8;
+    TestPoolComponent* childComponent = node->GetChild(0U)->GetComponent<TestPoolComponent>();
+    childComponent->value_ = 80;
+
+    REQUIRE(snapshot.Restore(node));
+    REQUIRE(node->GetPosition2D() == Vector2(1.f, 2.f));
+    REQUIRE(node->GetVar(TEST_VAR).GetInt() == 3);
+    REQUIRE(component->value_ == 3);
+    REQUIRE(component->speed_ == 1.5f);
+    REQUIRE(component->netValue_ == 8);
+    REQUIRE(childComponent->value_ == 30);
+
+    // the template doesn't change after the capture
+    templateNode->GetComponent<TestPoolComponent>()->value_ = 9;
+    component->value_ = 8;
+    REQUIRE(snapshot.Restore(node));
+    REQUIRE(component->value_ == 3);
+
+    snapshot.Clear();
+    REQUIRE(snapshot.IsEmpty());
+}
+
+TEST_CASE("NodeSnapshot doesn't restore a node with another structure", "[nodesnapshot]") {
+    SharedPtr<Context> context(new Context());
+    Node::RegisterObject(context);
+    TestPoolComponent::RegisterObject(context);
+
+    SharedPtr<Node> templateNode = CreateTestNode(context, 3, 1.5f);
+    NodeSnapshot snapshot;
+    snapshot.Capture(templateNode);
+
+    // a missing component
+    SharedPtr<Node> node = CreateTestNode(context, 4, 2.f);
+    node->GetChild(0U)->RemoveComponent<TestPoolComponent>();
+    REQUIRE_FALSE(snapshot.Restore(node));
+    REQUIRE(node->GetComponent<TestPoolComponent>()->value_ == 4);
+
+    // a missing child
+    node = CreateTestNode(context, 4, 2.f);
+    node->RemoveAllChildren();
+    REQUIRE_FALSE(snapshot.Restore(node));
+
+    // the added components are kept, the temporary components are skipped
+    node = CreateTestNode(context, 4, 2.f);
+    TestPoolComponent* temporary = node->CreateComponent<TestPoolComponent>();
+    temporary->SetTemporary(true);
+    temporary->value_ = 7;
+    REQUIRE(snapshot.Restore(node));
+    REQUIRE(node->GetComponent<TestPoolComponent>()->value_ == 3);
+    REQUIRE(temporary->value_ == 7);
+}
+
+TEST_CASE("NodeSnapshot restore cost benchmark", "[nodesnapshot][!benchmark]") {
+    SharedPtr<Context> context(new Context());
+    Node::RegisterObject(context);
+    TestPoolComponent::RegisterObject(context);
+
+    SharedPtr<Node> templateNode = CreateTestNode(context, 3, 1.5f);
+    SharedPtr<Node> node = CreateTestNode(context, 4, 2.f);
+    NodeSnapshot snapshot;
+    snapshot.Capture(templateNode);
+
+    BENCHMARK("copy attributes from the template") {
+        CopyAttributes(templateNode, node);
+        CopyAttributes(templateNode->GetComponent<TestPoolComponent>(), node->GetComponent<TestPoolComponent>());
+        Node* templateChild = templateNode->GetChild(0U);
+        Node* child = node->GetChild(0U);
+        CopyAttributes(templateChild, child);
+        CopyAttributes(templateChild->GetComponent<TestPoolComponent>(), child->GetComponent<TestPoolComponent>());
+        return node->GetComponent<TestPoolComponent>()->value_;
+    };
+
+    BENCHMARK("restore from the snapshot") {
+        snapshot.Restore(node);
+        return node->GetComponent<TestPoolComponent>()->value_;
+    };
+}
@@ -0,0 +1,262 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "../cpp/AI/PathFlowField.h"
+
+#include "PathTestWorld.h"
+
+// the center map (1,1) : the window of the field covers the 3x3 maps
+static const IntVector2 CENTER(TestWorld::MAPWIDTH + 10, -TestWorld::MAPHEIGHT + 7);
+
+TEST_CASE("PathFlowField gives the costs of the paths to the target", "[pathflowfield]") {
+    const int movetypes[] = { PMT_Flyer, PMT_Walker };
+
+    for (int m = 0; m < 2; m++)
+    {
+        const int movetype = movetypes[m];
+        TestWorld world(25, 11 + m);
+        world.SetBlocked(CENTER.x_, CENTER.y_, false);
+
+        PathFlowField<TestWorld> field(world, movetype);
+        field.SetTarget(CENTER.x_, CENTER.y_);
+        REQUIRE(!field.IsReady());
+        REQUIRE(field.Update(0));
+        REQUIRE(field.IsReady());
+        REQUIRE(field.GetTarget() == CENTER);
+        REQUIRE(field.GetDistance(CENTER.x_, CENTER.y_) == 0);
+
+        FlatNav flatnav(world, movetype, false);
+        PathSearch<FlatNav> flatsearch;
+        const unsigned goalkey = flatnav.GetKey(CENTER.x_, CENTER.y_);
+
+        unsigned numreached = 0;
+        for (int i = 0; i < 200; i++)
+        {
+            const IntVector2 tile = GetRandomTile(world, movetype);
+            const bool found = flatsearch.Search(flatnav, flatnav.GetKey(tile.x_, tile.y_), goalkey) == PSS_Found;
+            const unsigned distance = field.GetDistance(tile.x_, tile.y_);
+
+            // the optimal costs of the forward searches
+            REQUIRE(found == (distance < PATHSEARCH_NOWAY));
+            if (!found)
+                continue;
+            REQUIRE(distance == flatsearch.GetCost(goalkey));
+
+            // the next tiles go down the field to the target
+            IntVector2 a = tile, b;
+            unsigned cost = 0;
+            while (field.GetNextTile(a.x_, a.y_, b))
+            {
+                REQUIRE(Abs(a.x_ - b.x_) <= 1);
+                REQUIRE(Abs(a.y_ - b.y_) <= 1);
+                REQUIRE(field.GetDistance(b.x_, b.y_) < field.GetDistance(a.x_, a.y_));
+                cost += world.GetCost(movetype, a.x_, a.y_, b.x_, b.y_);
+                a = b;
+            }
+            REQUIRE(a == CENTER);
+            REQUIRE(cost == distance);
+            numreached++;
+        }
+
+        REQUIRE(numreached > 100);
+        // outside the window
+        REQUIRE(field.GetDistance(-1, 0) == PATHSEARCH_NOWAY);
+    }
+}
+
+TEST_CASE("PathFlowField computes the next field by steps", "[pathflowfield]") {
+    TestWorld world(20, 3);
+    const IntVector2 first(CENTER.x_, CENTER.y_);
+    const IntVector2 second(CENTER.x_ + 1, CENTER.y_);
+    world.SetBlocked(first.x_, first.y_, false);
+    world.SetBlocked(second.x_, second.y_, false);
+
+    PathFlowField<TestWorld> field(world, PMT_Walker);
+    field.SetTarget(first.x_, first.y_);
+    REQUIRE(field.Update(0));
+
+    // the target moves : the agents use the first field until the second is complete
+    field.SetTarget(second.x_, second.y_);
+    REQUIRE(field.IsComputing());
+    unsigned numsteps = 0;
+    while (!field.Update(64))
+    {
+        REQUIRE(field.GetTarget() == first);
+        REQUIRE(field.GetDistance(first.x_, first.y_) == 0);
+        numsteps++;
+    }
+    REQUIRE(numsteps > 4);
+    REQUIRE(field.GetTarget() == second);
+    REQUIRE(field.GetNumComputed() == 2);
+
+    // the same tile : no new field
+    field.SetTarget(second.x_, second.y_);
+    REQUIRE(!field.IsComputing());
+
+    // the stepped field is the field computed at once
+    PathFlowField<TestWorld> reference(world, PMT_Walker);
+    reference.SetTarget(second.x_, second.y_);
+    REQUIRE(reference.Update(0));
+    for (int y = TestWorld::MAPHEIGHT - 1; y >= -2 * TestWorld::MAPHEIGHT; y--)
+        for (int x = 0; x < TestWorld::NUMMAPS * TestWorld::MAPWIDTH; x++)
+            REQUIRE(field.GetDistance(x, y) == reference.GetDistance(x, y));
+
+    // a wall around the target
+    for (int dy = -1; dy <= 1; dy++)
+        for (int dx = -1; dx <= 1; dx++)
+            if (dx || dy)
+            {
+                world.SetBlocked(second.x_ + dx, second.y_ + dy, true);
+                field.MarkTileChanged(second.x_ + dx, second.y_ + dy);
+            }
+    REQUIRE(field.IsComputing());
+    REQUIRE(field.Update(0));
+    REQUIRE(field.GetDistance(second.x_, second.y_) == 0);
+    REQUIRE(field.GetDistance(first.x_ - 1, first.y_) == PATHSEARCH_NOWAY);
+
+    // a tile outside the window doesn't restart the field
+    field.MarkTileChanged(-5, 0);
+    REQUIRE(!field.IsComputing());
+}
+
+// Chase : the agents move one tile by step to the target, the target moves one tile every 2 steps.
+// The agents on A* search a path (limited like PathFinder2D to 5 x the heuristic) when the target changes of tile,
+// the agents on the flow field take the next tile of the shared field.
+struct ChaseResult
+{
+    unsigned numReached_;
+    unsigned numSearches_;
+    unsigned numExpanded_;
+};
+
+static ChaseResult RunChase(const TestWorld& world, bool flowfield, int numagents, int numsteps, unsigned seed)
+{
+    std::srand(seed);
+
+    IntVector2 target = CENTER;
+    std::vector<IntVector2> agents(numagents);
+    std::vector<std::vector<IntVector2> > paths(numagents);
+    std::vector<IntVector2> pathtargets(numagents, IntVector2(-1000, -1000));
+    std::vector<bool> reached(numagents, false);
+    for (int i = 0; i < numagents; i++)
+        agents[i] = GetRandomTile(world, PMT_Walker);
+
+    FlatNav nav(world, PMT_Walker, true);
+    PathSearch<FlatNav> search;
+    PathFlowField<TestWorld> field(world, PMT_Walker);
+
+    ChaseResult result = { 0, 0, 0 };
+
+    for (int step = 0; step < numsteps; step++)
+    {
+        // the target wanders in the center map
+        if (step % 2 == 1)
+        {
+            const IntVector2 next(target.x_ + std::rand() % 3 - 1, target.y_ + std::rand() % 3 - 1);
+            if (next != target && Abs(next.x_ - CENTER.x_) < 6 && Abs(next.y_ - CENTER.y_) < 4 &&
+                    world.IsPassable(PMT_Walker, next.x_, next.y_) && world.GetCost(PMT_Walker, target.x_, target.y_, next.x_, next.y_) < PATHSEARCH_NOWAY)
+                target = next;
+        }
+
+        if (flowfield)
+        {
+            if (field.IsComputing() || field.GetTarget() != target || !field.IsReady())
+                result.numSearches_++;
+            field.SetTarget(target.x_, target.y_);
+            field.Update();
+        }
+
+        for (int i = 0; i < numagents; i++)
+        {
+            if (reached[i])
+                continue;
+
+            IntVector2& agent = agents[i];
+            IntVector2 next;
+
+            if (flowfield)
+            {
+                if (!field.GetNextTile(agent.x_, agent.y_, next))
+                    continue;
+            }
+            else
+            {
+                std::vector<IntVector2>& path = paths[i];
+                if (pathtargets[i] != target || path.empty())
+                {
+                    pathtargets[i] = target;
+                    path.clear();
+                    nav.SetGoal(target.x_, target.y_);
+                    const unsigned start = nav.GetKey(agent.x_, agent.y_);
+                    const unsigned goal = nav.GetKey(target.x_, target.y_);
+                    const int status = search.Search(nav, start, goal, 5 * nav.GetHeuristic(start));
+                    result.numSearches_++;
+                    result.numExpanded_ += search.GetNumExpanded();
+                    if (status == PSS_Found)
+                    {
+                        // the path from the goal to the next tile of the agent
+                        for (unsigned key = goal; key != start; key = search.GetParent(key))
+                            path.push_back(IntVector2(nav.GetX(key), nav.GetY(key)));
+                    }
+                }
+                if (path.empty())
+                    continue;
+                next = path.back();
+                path.pop_back();
+            }
+
+            agent = next;
+            if (Abs(agent.x_ - target.x_) <= 1 && Abs(agent.y_ - target.y_) <= 1)
+            {
+                reached[i] = true;
+                result.numReached_++;
+            }
+        }
+    }
+
+    if (flowfield)
+        result.numExpanded_ = field.GetNumExpanded() * field.GetNumComputed();
+
+    return result;
+}
+
+TEST_CASE("PathFlowField swarm benchmark", "[pathflowfield][!benchmark]") {
+    TestWorld world(5, 17, true);
+    world.SetBlocked(CENTER.x_, CENTER.y_, false);
+
+    const int numagents = 200;
+    const int numsteps = 150;
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    const ChaseResult astar = RunChase(world, false, numagents, numsteps, 23);
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    const ChaseResult flow = RunChase(world, true, numagents, numsteps, 23);
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+    const double astarms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    const double flowms = std::chrono::duration<double, std::milli>(t2 - t1).count();
+    WARN("a* by agent : " + std::to_string(astarms) + " ms, " + std::to_string(astar.numSearches_) + " searches, " +
+         std::to_string(astar.numExpanded_) + " nodes expanded, " + std::to_string(astar.numReached_) + "/" + std::to_string(numagents) + " agents reached the target");
+    WARN("flow field  : " + std::to_string(flowms) + " ms, " + std::to_string(flow.numSearches_) + " field steps, " +
+         std::to_string(flow.numExpanded_) + " nodes expanded, " + std::to_string(flow.numReached_) + "/" + std::to_string(numagents) + " agents reached the target");
+
+    // the field reaches all the agents that can reach the target
+    REQUIRE(flow.numReached_ >= astar.numReached_);
+
+    BENCHMARK_ADVANCED("a* by agent x200")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            return RunChase(world, false, numagents, numsteps, 23).numReached_;
+        });
+    };
+
+    BENCHMARK_ADVANCED("flow field x200")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            return RunChase(world, true, numagents, numsteps, 23).numReached_;
+        });
+    };
+}
@@ -0,0 +1,169 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+#include "../cpp/AI/PathHierarchy.h"
+
+#include "PathTestWorld.h"
+
+// check the refined path and return its cost
+static unsigned GetRefinedCost(const TestWorld& world, int movetype, const PODVector<IntVector2>& tiles, const IntVector2& start, const IntVector2& goal)
+{
+    REQUIRE(tiles.Size() > 1);
+    REQUIRE(tiles[0] == start);
+    REQUIRE(tiles[tiles.Size()-1] == goal);
+
+    unsigned cost = 0;
+    for (unsigned i = 1; i < tiles.Size(); i++)
+    {
+        const IntVector2& a = tiles[i-1];
+        const IntVector2& b = tiles[i];
+        const bool adjacent = Abs(a.x_ - b.x_) <= 1 && Abs(a.y_ - b.y_) <= 1 && a != b;
+        const unsigned step = world.GetCost(movetype, a.x_, a.y_, b.x_, b.y_);
+        if (!adjacent || !world.IsPassable(movetype, b.x_, b.y_) || step >= PATHSEARCH_NOWAY)
+            return PATHSEARCH_NOWAY;
+        cost += step;
+    }
+    return cost;
+}
+
+TEST_CASE("PathHierarchy routes across a 3x3 block of maps", "[pathhierarchy]") {
+    const int movetypes[] = { PMT_Flyer, PMT_Walker, PMT_Swimmer };
+
+    for (int m = 0; m < 3; m++)
+    {
+        const int movetype = movetypes[m];
+        TestWorld world(movetype == PMT_Swimmer ? 10 : 22, 7 + m);
+        PathHierarchy<TestWorld> hierarchy(world);
+        PathSearch<FlatNav> flatsearch;
+        FlatNav flatnav(world, movetype);
+        PODVector<IntVector2> tiles;
+
+        unsigned numfound = 0, numflatfound = 0, numrefined = 0;
+        unsigned long long cost = 0, flatcost = 0;
+
+        for (int pair = 0; pair < 40; pair++)
+        {
+            // from a corner map to the other maps, the swimmers in the lowest maps
+            const int mx = pair % 3;
+            const int my = movetype == PMT_Swimmer ? 0 : (pair / 3) % 3;
+            const IntVector2 start = GetRandomTile(world, movetype, pair % 2 ? 0 : 2, 0);
+            const IntVector2 goal = GetRandomTile(world, movetype, mx, my);
+            if (start == goal)
+                continue;
+
+            const unsigned goalkey = flatnav.GetKey(goal.x_, goal.y_);
+            const bool flatfound = flatsearch.Search(flatnav, flatnav.GetKey(start.x_, start.y_), goalkey) == PSS_Found;
+            const bool found = hierarchy.FindPath(movetype, start, goal) == PSS_Found;
+
+            // the hierarchy can't find a path that doesn't exist
+            REQUIRE((!found || flatfound));
+
+            if (flatfound)
+                numflatfound++;
+            if (!found)
+                continue;
+
+            numfound++;
+            REQUIRE(hierarchy.GetWaypoint(0) == start);
+            REQUIRE(hierarchy.GetWaypoint(hierarchy.GetNumWaypoints()-1) == goal);
+
+            if (hierarchy.RefinePath(tiles))
+            {
+                const unsigned refinedcost = GetRefinedCost(world, movetype, tiles, start, goal);
+                REQUIRE(refinedcost < PATHSEARCH_NOWAY);
+                REQUIRE(refinedcost >= flatsearch.GetCost(goalkey));
+                cost += refinedcost;
+                flatcost += flatsearch.GetCost(goalkey);
+                numrefined++;
+            }
+        }
+
+        // the clusters are the 9 maps
+        REQUIRE(hierarchy.GetNumClusters() <= 9);
+        REQUIRE(numfound > 0);
+        REQUIRE(numfound * 10 >= numflatfound * 9);
+        REQUIRE(numrefined == numfound);
+        // near the optimal paths
+        REQUIRE(cost * 10 <= flatcost * 13);
+    }
+}
+
+TEST_CASE("PathHierarchy goes through the maps", "[pathhierarchy]") {
+    TestWorld world(0, 1);
+    PathHierarchy<TestWorld> hierarchy(world);
+    PODVector<IntVector2> tiles;
+
+    // from the map (0,0) to the map (2,2)
+    const IntVector2 start(2, 10);
+    const IntVector2 goal(57, -25);
+    REQUIRE(hierarchy.FindPath(PMT_Flyer, start, goal) == PSS_Found);
+    REQUIRE(hierarchy.GetNumClusters() >= 5);
+    REQUIRE(hierarchy.GetNumWaypoints() >= 6);
+
+    // refinement on demand : each segment ends at the next waypoint
+    tiles.Push(start);
+    for (unsigned i = 0; i + 1 < hierarchy.GetNumWaypoints(); i++)
+    {
+        REQUIRE(hierarchy.RefineSegment(i, tiles));
+        REQUIRE(tiles[tiles.Size()-1] == hierarchy.GetWaypoint(i+1));
+    }
+    // the optimal cost is 35 diagonal moves + 20 horizontal moves
+    const unsigned cost = GetRefinedCost(world, PMT_Flyer, tiles, start, goal);
+    REQUIRE(cost >= 35 * 14 + 20 * 10);
+    REQUIRE(cost <= (35 * 14 + 20 * 10) * 12 / 10);
+
+    // without the center map, the path goes around
+    world.maps_[4] = false;
+    REQUIRE(hierarchy.FindPath(PMT_Flyer, start, goal) == PSS_Found);
+    REQUIRE(hierarchy.RefinePath(tiles));
+    REQUIRE(GetRefinedCost(world, PMT_Flyer, tiles, start, goal) < PATHSEARCH_NOWAY);
+    for (unsigned i = 0; i < tiles.Size(); i++)
+        REQUIRE(world.IsInside(tiles[i].x_, tiles[i].y_));
+}
+
+TEST_CASE("PathHierarchy rebuilds only the maps of the changed tiles", "[pathhierarchy]") {
+    TestWorld world(0, 1);
+    PathHierarchy<TestWorld> hierarchy(world);
+    PODVector<IntVector2> tiles;
+
+    const IntVector2 start(5, 3);
+    const IntVector2 goal(52, -20);
+    REQUIRE(hierarchy.FindPath(PMT_Flyer, start, goal) == PSS_Found);
+
+    // build all the maps
+    for (int my = 0; my < 3; my++)
+        for (int mx = 0; mx < 3; mx++)
+            REQUIRE(hierarchy.GetClusterAt(mx * TestWorld::MAPWIDTH, -my * TestWorld::MAPHEIGHT));
+    REQUIRE(hierarchy.GetNumClusters() == 9);
+
+    // a wall in the middle maps, on the first column
+    const int wallx = TestWorld::MAPWIDTH + 1;
+    for (int y = -2 * TestWorld::MAPHEIGHT; y < TestWorld::MAPHEIGHT; y++)
+    {
+        world.SetBlocked(wallx, y, true);
+        hierarchy.MarkTileChanged(wallx, y);
+    }
+
+    unsigned numbuilds = hierarchy.GetNumBuilds();
+    REQUIRE(hierarchy.FindPath(PMT_Flyer, start, goal) == PSS_NotFound);
+    // the maps of the first two columns are rebuilt, not the last column
+    REQUIRE(hierarchy.GetNumBuilds() == numbuilds + 6);
+
+    // a hole in the wall, on the map (1,2)
+    world.SetBlocked(wallx, -20, false);
+    hierarchy.MarkTileChanged(wallx, -20);
+
+    numbuilds = hierarchy.GetNumBuilds();
+    REQUIRE(hierarchy.FindPath(PMT_Flyer, start, goal) == PSS_Found);
+    REQUIRE(hierarchy.GetNumBuilds() == numbuilds + 2);
+
+    REQUIRE(hierarchy.RefinePath(tiles));
+    REQUIRE(GetRefinedCost(world, PMT_Flyer, tiles, start, goal) < PATHSEARCH_NOWAY);
+    bool throughhole = false;
+    for (unsigned i = 0; i < tiles.Size(); i++)
+        if (tiles[i] == IntVector2(wallx, -20))
+            throughhole = true;
+    REQUIRE(throughhole);
+}
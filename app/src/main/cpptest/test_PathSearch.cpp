@@ -0,0 +1,332 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "../cpp/AI/PathSearch.h"
+
+// Test navigation : maps of width x height tiles in a row (a slot by map), moore neighbors,
+// costs like PathFinder2D (fly : octile, walker : jump/fall costs and blocked jumps).
+struct TestNav
+{
+    int width_, height_, numMaps_;
+    bool walker_;
+    int goalx_, goaly_;
+    std::vector<unsigned char> blocked_;
+    std::vector<unsigned char> jumpable_;
+
+    TestNav(int width, int height, int nummaps, bool walker, unsigned seed) :
+        width_(width), height_(height), numMaps_(nummaps), walker_(walker), goalx_(0), goaly_(0)
+    {
+        const int numtiles = width * height * nummaps;
+        blocked_.resize(numtiles);
+        jumpable_.resize(numtiles);
+        std::srand(seed);
+        for (int i = 0; i < numtiles; i++)
+        {
+            blocked_[i] = std::rand() % 100 < 28;
+            jumpable_[i] = std::rand() % 100 < 70;
+        }
+    }
+
+    unsigned GetKey(int wx, int y) const
+    {
+        return GetPathSearchKey(wx / width_, y * width_ + wx % width_);
+    }
+    int GetWorldX(unsigned key) const
+    {
+        return GetPathSearchSlot(key) * width_ + GetPathSearchTile(key) % width_;
+    }
+    int GetWorldY(unsigned key) const
+    {
+        return GetPathSearchTile(key) / width_;
+    }
+    unsigned GetIndex(unsigned key) const
+    {
+        return GetPathSearchSlot(key) * width_ * height_ + GetPathSearchTile(key);
+    }
+    bool IsFree(int wx, int y) const
+    {
+        return wx >= 0 && wx < width_ * numMaps_ && y >= 0 && y < height_ && !blocked_[GetIndex(GetKey(wx, y))];
+    }
+    void SetGoal(unsigned key)
+    {
+        goalx_ = GetWorldX(key);
+        goaly_ = GetWorldY(key);
+    }
+
+    unsigned GetNumSlots() const
+    {
+        return numMaps_;
+    }
+    unsigned GetNumTiles() const
+    {
+        return width_ * height_;
+    }
+    unsigned GetNeighbors(unsigned key, unsigned* keys) const
+    {
+        static const int offx[8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+        static const int offy[8] = { -1, -1, -1, 0, 0, 1, 1, 1 };
+        const int x = GetWorldX(key);
+        const int y = GetWorldY(key);
+        unsigned numneighbors = 0;
+        for (int i = 0; i < 8; i++)
+            if (IsFree(x + offx[i], y + offy[i]))
+                keys[numneighbors++] = GetKey(x + offx[i], y + offy[i]);
+        return numneighbors;
+    }
+    unsigned GetCost(unsigned from, unsigned to) const
+    {
+        const int dx = GetWorldX(from) - GetWorldX(to);
+        const int dy = GetWorldY(from) - GetWorldY(to);
+        if (!walker_)
+            return dx == 0 || dy == 0 ? 10 : 14;
+        // jump
+        if (dy > 0)
+            return jumpable_[GetIndex(to)] ? (dx ? 80 : 60) : PATHSEARCH_NOWAY;
+        // fall
+        if (dy < 0)
+            return dx ? 13 : 9;
+        return jumpable_[GetIndex(to)] ? 10 : 45;
+    }
+    unsigned GetHeuristic(unsigned key) const
+    {
+        const int x = GetWorldX(key);
+        const int y = GetWorldY(key);
+        const unsigned dx = x > goalx_ ? x - goalx_ : goalx_ - x;
+        if (!walker_)
+        {
+            const unsigned dy = y > goaly_ ? y - goaly_ : goaly_ - y;
+            return dx > dy ? dx * 10 + dy * 4 : dy * 10 + dx * 4;
+        }
+        const unsigned dy = y > goaly_ ? y - goaly_ : goaly_ - y;
+        const unsigned jcost = y > goaly_ ? dy * 60 : dy * 9;
+        return dx > dy ? dx * 10 + dy * 35 + jcost : dy * 45 + dx * 35 + jcost;
+    }
+    bool IsTimeOut(unsigned /*numExpanded*/) const
+    {
+        return false;
+    }
+};
+
+// Reference : A* with an open list searched linearly and a closed list (the structures of the former PathFinder2D),
+// with the same order of the open nodes and the same relaxation as PathSearch.
+struct ReferenceSearch
+{
+    struct Node
+    {
+        unsigned g_, parent_;
+        bool opened_, closed_;
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<PathSearchOpenNode> open_;
+    unsigned lastKey_, startF_, numExpanded_;
+
+    int Search(TestNav& nav, unsigned start, unsigned goal, unsigned maxcost)
+    {
+        Node empty = { PATHSEARCH_NONE, PATHSEARCH_NONE, false, false };
+        nodes_.assign(nav.GetNumSlots() * nav.GetNumTiles(), empty);
+        open_.clear();
+        numExpanded_ = 0;
+        startF_ = nav.GetHeuristic(start);
+        lastKey_ = start;
+
+        PathSearchOpenNode s = { startF_, 0, start };
+        open_.push_back(s);
+        nodes_[nav.GetIndex(start)].g_ = 0;
+        nodes_[nav.GetIndex(start)].opened_ = true;
+
+        unsigned neighbors[PATHSEARCH_MAXNEIGHBORS];
+        while (open_.size())
+        {
+            unsigned best = 0;
+            for (unsigned i = 1; i < open_.size(); i++)
+                if (IsPathSearchNodeBefore(open_[i], open_[best]))
+                    best = i;
+            const PathSearchOpenNode a = open_[best];
+            open_.erase(open_.begin() + best);
+            nodes_[nav.GetIndex(a.key_)].closed_ = true;
+            lastKey_ = a.key_;
+            numExpanded_++;
+
+            if (a.key_ == goal)
+                return PSS_Found;
+            if (maxcost && a.f_ > maxcost)
+                return PSS_Stopped;
+
+            const unsigned numneighbors = nav.GetNeighbors(a.key_, neighbors);
+            for (unsigned i = 0; i < numneighbors; i++)
+            {
+                Node& b = nodes_[nav.GetIndex(neighbors[i])];
+                if (b.closed_)
+                    continue;
+                const unsigned cost = nav.GetCost(a.key_, neighbors[i]);
+                if (cost >= PATHSEARCH_NOWAY || a.g_ + cost >= b.g_)
+                    continue;
+
+                b.g_ = a.g_ + cost;
+                b.parent_ = a.key_;
+                PathSearchOpenNode n = { b.g_ + nav.GetHeuristic(neighbors[i]), b.g_, neighbors[i] };
+                if (!b.opened_)
+                {
+                    b.opened_ = true;
+                    open_.push_back(n);
+                }
+                else
+                {
+                    for (unsigned j = 0; j < open_.size(); j++)
+                        if (open_[j].key_ == n.key_)
+                            open_[j] = n;
+                }
+            }
+        }
+        return PSS_NotFound;
+    }
+};
+
+static std::vector<unsigned> GetPath(const PathSearch<TestNav>& search, unsigned key)
+{
+    std::vector<unsigned> path;
+    for (; key != PATHSEARCH_NONE; key = search.GetParent(key))
+        path.push_back(key);
+    return path;
+}
+
+static std::vector<unsigned> GetPath(const ReferenceSearch& search, const TestNav& nav, unsigned key)
+{
+    std::vector<unsigned> path;
+    for (; key != PATHSEARCH_NONE; key = search.nodes_[nav.GetIndex(key)].parent_)
+        path.push_back(key);
+    return path;
+}
+
+static unsigned GetRandomFreeKey(const TestNav& nav)
+{
+    for (;;)
+    {
+        const int x = std::rand() % (nav.width_ * nav.numMaps_);
+        const int y = std::rand() % nav.height_;
+        if (nav.IsFree(x, y))
+            return nav.GetKey(x, y);
+    }
+}
+
+TEST_CASE("PathSearch gives the paths of the reference A*", "[pathsearch]") {
+    // the same search reuses its node states over the generations
+    PathSearch<TestNav> search;
+    ReferenceSearch reference;
+
+    for (int walker = 0; walker < 2; walker++)
+    {
+        for (int nummaps = 1; nummaps <= 3; nummaps++)
+        {
+            TestNav nav(24, 16, nummaps, walker != 0, 17 + nummaps * 3 + walker);
+
+            unsigned numfound = 0;
+            for (int pair = 0; pair < 60; pair++)
+            {
+                const unsigned start = GetRandomFreeKey(nav);
+                const unsigned goal = GetRandomFreeKey(nav);
+                nav.SetGoal(goal);
+                const unsigned maxcost = (pair % 3 == 0) ? 5 * nav.GetHeuristic(start) : 0;
+
+                const int status = search.Search(nav, start, goal, maxcost);
+                const int refstatus = reference.Search(nav, start, goal, maxcost);
+
+                REQUIRE(status == refstatus);
+                REQUIRE(search.GetNumExpanded() == reference.numExpanded_);
+                REQUIRE(search.GetLastKey() == reference.lastKey_);
+                REQUIRE(search.GetStartF() == reference.startF_);
+                REQUIRE(search.GetCost(search.GetLastKey()) == reference.nodes_[nav.GetIndex(reference.lastKey_)].g_);
+                REQUIRE(GetPath(search, search.GetLastKey()) == GetPath(reference, nav, reference.lastKey_));
+
+                if (status == PSS_Found)
+                    numfound++;
+            }
+
+            REQUIRE(numfound > 0);
+        }
+    }
+}
+
+TEST_CASE("PathSearch decreases the cost of the opened nodes", "[pathsearch]") {
+    // fly on an empty map : the diagonal moves must be found
+    TestNav nav(16, 16, 1, false, 1);
+    for (unsigned i = 0; i < nav.blocked_.size(); i++)
+        nav.blocked_[i] = 0;
+
+    const unsigned start = nav.GetKey(0, 0);
+    const unsigned goal = nav.GetKey(10, 6);
+    nav.SetGoal(goal);
+
+    PathSearch<TestNav> search;
+    REQUIRE(search.Search(nav, start, goal) == PSS_Found);
+    REQUIRE(search.GetCost(goal) == 6 * 14 + 4 * 10);
+    REQUIRE(GetPath(search, goal).size() == 11);
+    REQUIRE(search.IsReached(start));
+}
+
+TEST_CASE("PathSearch benchmark", "[pathsearch][!benchmark]") {
+    TestNav nav(64, 64, 3, true, 99);
+    std::srand(5);
+    std::vector<unsigned> starts, goals;
+    for (int i = 0; i < 16; i++)
+    {
+        starts.push_back(GetRandomFreeKey(nav));
+        goals.push_back(GetRandomFreeKey(nav));
+    }
+
+    PathSearch<TestNav> search;
+    ReferenceSearch reference;
+
+    // nodes expanded by ms
+    unsigned numexpanded = 0, refnumexpanded = 0;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < starts.size(); i++)
+    {
+        nav.SetGoal(goals[i]);
+        search.Search(nav, starts[i], goals[i]);
+        numexpanded += search.GetNumExpanded();
+    }
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < starts.size(); i++)
+    {
+        nav.SetGoal(goals[i]);
+        reference.Search(nav, starts[i], goals[i], 0);
+        refnumexpanded += reference.numExpanded_;
+    }
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+    const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    const double refms = std::chrono::duration<double, std::milli>(t2 - t1).count();
+    WARN("binary heap : " + std::to_string(ms > 0.0 ? numexpanded / ms : 0.0) + " nodes expanded/ms");
+    WARN("reference   : " + std::to_string(refms > 0.0 ? refnumexpanded / refms : 0.0) + " nodes expanded/ms");
+
+    BENCHMARK_ADVANCED("binary heap 192x64")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            unsigned n = 0;
+            for (unsigned i = 0; i < starts.size(); i++)
+            {
+                nav.SetGoal(goals[i]);
+                n += search.Search(nav, starts[i], goals[i]);
+            }
+            return n;
+        });
+    };
+
+    BENCHMARK_ADVANCED("reference 192x64")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            unsigned n = 0;
+            for (unsigned i = 0; i < starts.size(); i++)
+            {
+                nav.SetGoal(goals[i]);
+                n += reference.Search(nav, starts[i], goals[i], 0);
+            }
+            return n;
+        });
+    };
+}
@@ -0,0 +1,188 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdlib>
+
+#include "../cpp/AI/PathCosts.h"
+#include "../cpp/AI/PathWalkGraph.h"
+
+using namespace Urho3D;
+
+static void SetCells(PathWalkGraph& graph, int width, int height, unsigned char cell)
+{
+    for (int y = -1; y <= height + PATHWALK_MAXJUMP; y++)
+        for (int x = -2; x <= width + 1; x++)
+            graph.SetCell(x, y, cell);
+}
+
+static const PathWalkLink* FindLink(const PathWalkGraph& graph, int x, int y, int dx, int dy)
+{
+    const PathWalkLink* links;
+    unsigned numlinks = graph.GetLinks(x, y, links);
+    for (unsigned i = 0; i < numlinks; i++)
+    {
+        if (links[i].dx_ == dx && links[i].dy_ == dy)
+            return &links[i];
+    }
+    return 0;
+}
+
+// the nodes and the links of the map must be the same as a full build on the same cells
+static void RequireSameAsBuild(const PathWalkGraph& graph, int width, int height)
+{
+    PathWalkGraph reference;
+    reference.Set(width, height);
+    for (int y = -1; y <= height + PATHWALK_MAXJUMP; y++)
+        for (int x = -2; x <= width + 1; x++)
+            reference.SetCell(x, y, graph.GetCell(x, y));
+    reference.Build();
+
+    for (int y = -1; y <= height; y++)
+        for (int x = -1; x <= width; x++)
+        {
+            REQUIRE(graph.GetNode(x, y).props_ == reference.GetNode(x, y).props_);
+            REQUIRE(graph.GetNode(x, y).height_ == reference.GetNode(x, y).height_);
+        }
+
+    REQUIRE(graph.GetNumLinks() == reference.GetNumLinks());
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+        {
+            const PathWalkLink* links;
+            const PathWalkLink* reflinks;
+            const unsigned numlinks = graph.GetLinks(x, y, links);
+            REQUIRE(numlinks == reference.GetLinks(x, y, reflinks));
+            for (unsigned i = 0; i < numlinks; i++)
+            {
+                REQUIRE(links[i].dx_ == reflinks[i].dx_);
+                REQUIRE(links[i].dy_ == reflinks[i].dy_);
+                REQUIRE(links[i].type_ == reflinks[i].type_);
+                REQUIRE(links[i].height_ == reflinks[i].height_);
+                REQUIRE(links[i].cost_ == reflinks[i].cost_);
+            }
+        }
+}
+
+// Test map : 6x5 tiles, the tile y goes down.
+// The ground is the last row of the map, with a step at (3,3) and a wall on the column 5.
+//   y=0  . . . . . #
+//   y=1  . . . . . #
+//   y=2  . . . . . #
+//   y=3  . . . # . #
+//   y=4  # # # # # #
+TEST_CASE("PathWalkGraph links the walker moves", "[pathwalkgraph]") {
+    const int width = 6;
+    const int height = 5;
+
+    PathWalkGraph graph;
+    graph.Set(width, height);
+    SetCells(graph, width, height, PWC_Free);
+    for (int y = height - 1; y <= height + PATHWALK_MAXJUMP; y++)
+        for (int x = -2; x <= width + 1; x++)
+            graph.SetCell(x, y, PWC_Block);
+    for (int y = -1; y < height; y++)
+        graph.SetCell(5, y, PWC_Block);
+    graph.SetCell(3, 3, PWC_Block);
+    graph.Build();
+
+    // the nodes
+    REQUIRE(graph.GetNode(1, 3).props_ == (walkableFlag | jumpableFlag | flyableFlag));
+    REQUIRE(graph.GetNode(1, 3).height_ == 0);
+    REQUIRE(graph.GetNode(2, 3).props_ == (walkableFlag | jumpableFlag | flyableFlag));
+    REQUIRE(graph.GetNode(1, 1).height_ == 2);
+    REQUIRE(graph.GetNode(4, 0).props_ == (jumpableRightFlag | flyableFlag));
+    REQUIRE(graph.GetNode(4, 0).height_ == PATHWALK_NOGROUND);
+    REQUIRE(graph.GetNode(3, 3).props_ == nomoveFlag);
+
+    // walk on the ground, with the cost of the walker search
+    const PathWalkLink* link = FindLink(graph, 1, 3, 1, 0);
+    REQUIRE(link);
+    REQUIRE(link->type_ == PWL_Walk);
+    REQUIRE(link->height_ == 0);
+    REQUIRE(link->cost_ == NghbDist_walker(1, 3, 2, 3, graph.GetNode(2, 3).props_));
+
+    // jump up on the step
+    link = FindLink(graph, 2, 3, 1, -1);
+    REQUIRE(link);
+    REQUIRE(link->type_ == PWL_Jump);
+    REQUIRE(link->height_ == 0);
+    REQUIRE(link->cost_ == COST_WALK_XYUP);
+
+    // jump up in the air with the ground in the jump height
+    link = FindLink(graph, 1, 3, 0, -1);
+    REQUIRE(link);
+    REQUIRE(link->type_ == PWL_Jump);
+    REQUIRE(link->height_ == 1);
+    REQUIRE(link->cost_ == COST_WALK_YUP);
+
+    // move along the air
+    link = FindLink(graph, 1, 1, 1, 0);
+    REQUIRE(link);
+    REQUIRE(link->type_ == PWL_Jump);
+    REQUIRE(link->height_ == 2);
+    REQUIRE(link->cost_ == COST_WALK_YMID);
+
+    // fall from the step
+    link = FindLink(graph, 3, 2, 1, 1);
+    REQUIRE(link);
+    REQUIRE(link->type_ == PWL_Fall);
+    REQUIRE(link->cost_ == COST_WALK_XYDOWN);
+
+    // climb along the wall, the ground is out of the jump height
+    link = FindLink(graph, 4, 1, 0, -1);
+    REQUIRE(link);
+    REQUIRE(link->type_ == PWL_Climb);
+    REQUIRE(link->height_ == PATHWALK_NOGROUND);
+
+    // no link in the blocks, no jump without ground or wall
+    REQUIRE(!FindLink(graph, 2, 3, 0, 1));
+    REQUIRE(!FindLink(graph, 2, 3, 1, 0));
+    REQUIRE(!FindLink(graph, 1, 0, 0, -1));
+    REQUIRE(!FindLink(graph, 1, 0, 1, -1));
+    REQUIRE(!FindLink(graph, 1, 0, -1, -1));
+
+    RequireSameAsBuild(graph, width, height);
+}
+
+TEST_CASE("PathWalkGraph patches the links around an edited tile", "[pathwalkgraph]") {
+    const int width = 24;
+    const int height = 16;
+
+    PathWalkGraph graph;
+    graph.Set(width, height);
+    SetCells(graph, width, height, PWC_None);
+
+    std::srand(1234);
+    for (int y = -1; y <= height + PATHWALK_MAXJUMP; y++)
+        for (int x = -2; x <= width + 1; x++)
+            graph.SetCell(x, y, std::rand() % 100 < 35 ? PWC_Block : PWC_Free);
+    graph.Build();
+    RequireSameAsBuild(graph, width, height);
+
+    SECTION("Edits in the map") {
+        for (int i = 0; i < 300; i++)
+        {
+            const int x = std::rand() % width;
+            const int y = std::rand() % height;
+            graph.Patch(x, y, graph.GetCell(x, y) == PWC_Block ? PWC_Free : PWC_Block);
+            RequireSameAsBuild(graph, width, height);
+        }
+    }
+
+    SECTION("Edits in the band of the neighbor maps") {
+        for (int i = 0; i < 300; i++)
+        {
+            const int x = -2 + std::rand() % (width + 4);
+            const int y = -1 + std::rand() % (height + PATHWALK_MAXJUMP + 2);
+            if (x >= 0 && x < width && y >= 0 && y < height)
+                continue;
+            graph.Patch(x, y, std::rand() % 3);
+            RequireSameAsBuild(graph, width, height);
+        }
+    }
+
+    SECTION("Edits outside the captured cells are ignored") {
+        graph.Patch(-3, 0, PWC_Block);
+        graph.Patch(0, height + PATHWALK_MAXJUMP + 1, PWC_Block);
+        RequireSameAsBuild(graph, width, height);
+    }
+}